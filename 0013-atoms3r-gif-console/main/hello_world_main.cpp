@@ -225,6 +225,26 @@ extern "C" void app_main(void) {
                            gif_ctx.scale_y,
                            gif_ctx.off_x,
                            gif_ctx.off_y);
+                    printf("gif timing: open_us=%" PRIu32 " open_to_first_frame_us=%" PRIu32 "\n",
+                           echo_gif_player_open_us(),
+                           echo_gif_player_first_frame_us());
+                    EchoGifCacheStats cs = {};
+                    if (echo_gif_player_cache_stats(&cs)) {
+                        printf("gif cache: slots=%d/%d bytes=%" PRIu32 " loop_frames=%d complete=%d decoded=%" PRIu32
+                               " shown=%" PRIu32 " replayed=%" PRIu32 " misses=%" PRIu32 " evictions=%" PRIu32
+                               " wait_max_us=%" PRIu32 "\n",
+                               cs.slots,
+                               cs.max_slots,
+                               cs.bytes,
+                               cs.loop_frames,
+                               cs.complete ? 1 : 0,
+                               cs.decoded,
+                               cs.shown,
+                               cs.replayed,
+                               cs.misses,
+                               cs.evictions,
+                               cs.wait_us_max);
+                    }
                     break;
                 }
                 case CtrlType::SetBrightness: {
@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build a packed GIF image (EGPK) for the `storage` partition (see partitions.csv).
+#
+# Alternative to make_storage_fatfs.sh for firmware built with
+# CONFIG_ECHO_GIF_STORAGE_PACK=y (menuconfig → echo_gif → GIF storage format).
+# Flash the result with ./flash_storage.sh like the FATFS image.
+#
+# Does not need the ESP-IDF environment (plain python3).
+
+PROJ_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+INPUT_DIR="${1:-$PROJ_DIR/assets}"
+OUT_FILE="${2:-$PROJ_DIR/storage.bin}"
+# Default matches partitions.csv storage size (0x5F0000 bytes).
+PARTITION_SIZE_BYTES="${3:-6225920}"
+
+PACKER="$PROJ_DIR/../components/echo_gif/tools/echo_gif_pack.py"
+
+echo "make_storage_pack: input=$INPUT_DIR out=$OUT_FILE size=$PARTITION_SIZE_BYTES"
+python3 "$PACKER" "$INPUT_DIR" --output "$OUT_FILE" --partition-size "$PARTITION_SIZE_BYTES"
+
+ls -lh "$OUT_FILE"
@@ -0,0 +1,63 @@
+#include "audio_ring.h"
+
+#include <string.h>
+
+bool AudioRing::init(size_t min_samples) {
+    if (min_samples == 0 || min_samples > (1u << 30)) return false;
+    size_t cap = 1;
+    while (cap < min_samples) cap <<= 1;
+    buf_.assign(cap, 0);
+    mask_ = (uint32_t)(cap - 1);
+    reset();
+    return true;
+}
+
+void AudioRing::reset() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    dropped_samples_.store(0, std::memory_order_relaxed);
+    high_water_.store(0, std::memory_order_relaxed);
+}
+
+size_t AudioRing::push(const int16_t *samples, size_t n) {
+    if (n == 0) return 0;
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    const size_t used = (size_t)(head - tail);
+    if (n > buf_.size() - used) {
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+        dropped_samples_.fetch_add((uint32_t)n, std::memory_order_relaxed);
+        return 0;
+    }
+
+    const size_t at = head & mask_;
+    const size_t first = (n < buf_.size() - at) ? n : buf_.size() - at;
+    memcpy(&buf_[at], samples, first * sizeof(int16_t));
+    if (first < n) memcpy(&buf_[0], samples + first, (n - first) * sizeof(int16_t));
+    head_.store(head + (uint32_t)n, std::memory_order_release);
+
+    if (used + n > high_water_.load(std::memory_order_relaxed)) {
+        high_water_.store((uint32_t)(used + n), std::memory_order_relaxed);
+    }
+    return n;
+}
+
+size_t AudioRing::readable() const {
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    return (size_t)(head - tail_.load(std::memory_order_relaxed));
+}
+
+const int16_t *AudioRing::read_span(size_t *n) const {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t avail = (size_t)(head_.load(std::memory_order_acquire) - tail);
+    const size_t at = tail & mask_;
+    const size_t to_end = buf_.size() - at;
+    *n = (avail < to_end) ? avail : to_end;
+    return buf_.data() + at;
+}
+
+void AudioRing::consume(size_t n) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail + (uint32_t)n, std::memory_order_release);
+}
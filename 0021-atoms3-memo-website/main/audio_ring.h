@@ -0,0 +1,55 @@
+#pragma once
+
+/*
+ * Lock-free single-producer / single-consumer ring of 16-bit samples between the I2S capture task
+ * (producer) and the SPIFFS writer task (consumer).
+ *
+ * No ESP-IDF dependency so it builds on the host (tools/recorder_host). Indices run freely and are
+ * masked on access (capacity is a power of two); the producer publishes `head_` with release after
+ * copying samples in, the consumer publishes `tail_` with release after it is done with them.
+ *
+ * A push that does not fit is dropped whole and counted, so the writer only ever sees complete
+ * capture frames and the file is short by exactly `dropped_samples()`.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+class AudioRing {
+public:
+    // Allocates at least `min_samples` (rounded up to a power of two). Call before the tasks start.
+    bool init(size_t min_samples);
+
+    // Empties the ring and clears the counters. Only while neither side is running.
+    void reset();
+
+    size_t capacity() const { return buf_.size(); }
+
+    // Producer: copies all `n` samples in and returns n, or drops them and returns 0.
+    size_t push(const int16_t *samples, size_t n);
+
+    // Consumer: samples waiting, and the contiguous run of them starting at the read position
+    // (shorter than readable() when the data wraps). consume() releases samples after use.
+    size_t readable() const;
+    const int16_t *read_span(size_t *n) const;
+    void consume(size_t n);
+
+    // Any task.
+    uint32_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint32_t dropped_samples() const { return dropped_samples_.load(std::memory_order_relaxed); }
+    uint32_t high_water() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<int16_t> buf_;
+    uint32_t mask_ = 0;
+
+    std::atomic<uint32_t> head_{0}; // written by the producer
+    std::atomic<uint32_t> tail_{0}; // written by the consumer
+
+    std::atomic<uint32_t> overruns_{0};
+    std::atomic<uint32_t> dropped_samples_{0};
+    std::atomic<uint32_t> high_water_{0};
+};
@@ -7,7 +7,7 @@
  *   - POST /api/v1/recordings/start
  *   - POST /api/v1/recordings/stop
  *   - GET  /api/v1/recordings
- *   - GET  /api/v1/recordings/<name>
+ *   - GET  /api/v1/recordings/<name>  (IMA ADPCM recordings are sent as PCM; ?raw=1 for the file)
  *   - DELETE /api/v1/recordings/<name>
  * - Waveform endpoint:
  *   - GET /api/v1/waveform
@@ -20,6 +20,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -29,8 +30,12 @@
 #include "lwip/inet.h"
 #include "lwip/sockets.h"
 
+#include "sdkconfig.h"
+
+#include "ima_adpcm.h"
 #include "recorder.h"
 #include "storage_spiffs.h"
+#include "wav_format.h"
 
 static const char *TAG = "atoms3_memo_website_0021";
 
@@ -114,7 +119,7 @@ static esp_err_t api_v1_status_get(httpd_req_t *req) {
     log_request(req);
     const RecorderStatus st = recorder_get_status();
     std::string json;
-    json.reserve(256);
+    json.reserve(512);
     json += "{";
     json += "\"ok\":true,";
     json += "\"recording\":";
@@ -134,16 +139,94 @@ static esp_err_t api_v1_status_get(httpd_req_t *req) {
     json += ",";
     json += "\"bits_per_sample\":";
     json += std::to_string(st.bits_per_sample);
+    json += ",";
+    json += "\"format\":\"";
+    json += st.format;
+    json += "\",";
+    json += "\"samples_captured\":";
+    json += std::to_string(st.samples_captured);
+    json += ",";
+    json += "\"dropped_samples\":";
+    json += std::to_string(st.dropped_samples);
+    json += ",";
+    json += "\"ring_overruns\":";
+    json += std::to_string(st.ring_overruns);
+    json += ",";
+    json += "\"dma_overflows\":";
+    json += std::to_string(st.dma_overflows);
+    json += ",";
+    json += "\"ring_capacity\":";
+    json += std::to_string(st.ring_capacity);
+    json += ",";
+    json += "\"ring_high_water\":";
+    json += std::to_string(st.ring_high_water);
+    json += ",";
+    json += "\"max_write_us\":";
+    json += std::to_string(st.max_write_us);
     json += "}";
     httpd_resp_set_type(req, "application/json");
     return httpd_resp_send(req, json.c_str(), (ssize_t)json.size());
 }
 
+// Small JSON bodies assembled in a stack buffer and sent as HTTP chunks when it fills up.
+struct ChunkedJson {
+    httpd_req_t *req = nullptr;
+    char buf[512];
+    size_t len = 0;
+    esp_err_t err = ESP_OK;
+};
+
+static void chunked_flush(ChunkedJson *c) {
+    if (c->err == ESP_OK && c->len > 0) c->err = httpd_resp_send_chunk(c->req, c->buf, (ssize_t)c->len);
+    c->len = 0;
+}
+
+static void chunked_append(ChunkedJson *c, const char *s, size_t n) {
+    if (c->len + n > sizeof(c->buf)) chunked_flush(c);
+    memcpy(c->buf + c->len, s, n);
+    c->len += n;
+}
+
+static void chunked_append_i16_array(ChunkedJson *c, const char *key, const int16_t *v, size_t n) {
+    char tmp[48];
+    chunked_append(c, tmp, (size_t)snprintf(tmp, sizeof(tmp), ",\"%s\":[", key));
+    for (size_t i = 0; i < n; i++) {
+        chunked_append(c, tmp, (size_t)snprintf(tmp, sizeof(tmp), i ? ",%d" : "%d", (int)v[i]));
+    }
+    chunked_append(c, "]", 1);
+}
+
+// Filled per request; esp_http_server runs all handlers on one task.
+static int16_t s_wave_min[CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS];
+static int16_t s_wave_max[CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS];
+static int16_t s_wave_points[CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS];
+
 static esp_err_t api_v1_waveform_get(httpd_req_t *req) {
     log_request(req);
-    const std::string json = recorder_get_waveform_json();
+    uint32_t bucket_samples = 0;
+    const size_t n = recorder_get_waveform_peaks(s_wave_min, s_wave_max, CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS,
+                                                 &bucket_samples);
+    // points_i16 keeps the original contract: the larger-magnitude extreme of each bucket.
+    for (size_t i = 0; i < n; i++) {
+        s_wave_points[i] = (-(int)s_wave_min[i] > (int)s_wave_max[i]) ? s_wave_min[i] : s_wave_max[i];
+    }
+
     httpd_resp_set_type(req, "application/json");
-    return httpd_resp_send(req, json.c_str(), (ssize_t)json.size());
+    ChunkedJson c;
+    c.req = req;
+    char tmp[160];
+    chunked_append(&c, tmp,
+                   (size_t)snprintf(tmp, sizeof(tmp),
+                                    "{\"ok\":true,\"sample_rate_hz\":%d,\"window_ms\":%d,\"n\":%u,\"bucket_samples\":%u",
+                                    CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ, CONFIG_CLINTS_MEMO_WAVEFORM_WINDOW_MS,
+                                    (unsigned)n, (unsigned)bucket_samples));
+    chunked_append_i16_array(&c, "points_i16", s_wave_points, n);
+    chunked_append_i16_array(&c, "min_i16", s_wave_min, n);
+    chunked_append_i16_array(&c, "max_i16", s_wave_max, n);
+    chunked_append(&c, "}", 1);
+    chunked_flush(&c);
+    if (c.err != ESP_OK) return c.err;
+    return httpd_resp_send_chunk(req, nullptr, 0);
 }
 
 static esp_err_t api_v1_recordings_start_post(httpd_req_t *req) {
@@ -225,10 +308,68 @@ static bool uri_to_recording_name(httpd_req_t *req, std::string &out_name) {
     if (strncmp(req->uri, prefix, prefix_len) != 0) return false;
     const char *name = req->uri + prefix_len;
     if (!name || name[0] == '\0') return false;
-    out_name = name;
+    const char *query = strchr(name, '?');
+    out_name.assign(name, query ? (size_t)(query - name) : strlen(name));
     return is_safe_basename(out_name);
 }
 
+static bool query_flag(httpd_req_t *req, const char *key) {
+    char query[64];
+    char value[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) return false;
+    if (httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) return false;
+    return strcmp(value, "0") != 0;
+}
+
+static esp_err_t send_file_raw(httpd_req_t *req, FILE *fp) {
+    uint8_t buf[4096];
+    while (true) {
+        const size_t n = fread(buf, 1, sizeof(buf), fp);
+        if (n > 0) {
+            const esp_err_t err = httpd_resp_send_chunk(req, (const char *)buf, (ssize_t)n);
+            if (err != ESP_OK) return err;
+        }
+        if (n < sizeof(buf)) break;
+    }
+    return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+// Browsers only play PCM WAV, so IMA ADPCM recordings are decoded block by block on the way out.
+static esp_err_t send_ima_adpcm_as_pcm(httpd_req_t *req, FILE *fp, const WavImaAdpcmHeader &hdr) {
+    uint8_t block[512];
+    int16_t pcm[ima_adpcm_block_samples(sizeof(block))];
+    if (hdr.block_align > sizeof(block)) {
+        json_send_error(req, 500, "unsupported ADPCM block size");
+        return ESP_OK;
+    }
+
+    uint32_t total = hdr.sample_count;
+    if (total == 0) {
+        // Never finalized (e.g. reset while recording): count what the blocks on flash hold.
+        (void)fseek(fp, 0, SEEK_END);
+        const long size = ftell(fp);
+        const uint32_t data = (size > (long)sizeof(hdr)) ? (uint32_t)(size - (long)sizeof(hdr)) : 0;
+        const uint32_t tail = data % hdr.block_align;
+        total = (data / hdr.block_align) * hdr.samples_per_block + ((tail > 4) ? 1 + 2 * (tail - 4) : 0);
+    }
+
+    const WavPcmHeader out = wav_pcm_header(hdr.sample_rate, total * (uint32_t)sizeof(int16_t));
+    esp_err_t err = httpd_resp_send_chunk(req, (const char *)&out, (ssize_t)sizeof(out));
+    (void)fseek(fp, (long)sizeof(hdr), SEEK_SET);
+
+    uint32_t remaining = total;
+    while (err == ESP_OK && remaining > 0) {
+        const size_t n = fread(block, 1, hdr.block_align, fp);
+        const size_t want = std::min<size_t>(remaining, hdr.samples_per_block);
+        const size_t samples = (n > 0) ? ima_adpcm_decode_block(block, n, pcm, want) : 0;
+        if (samples == 0) break;
+        err = httpd_resp_send_chunk(req, (const char *)pcm, (ssize_t)(samples * sizeof(int16_t)));
+        remaining -= (uint32_t)samples;
+    }
+    if (err != ESP_OK) return err;
+    return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
 static esp_err_t api_v1_recordings_download_get(httpd_req_t *req) {
     log_request(req);
     std::string name;
@@ -248,20 +389,18 @@ static esp_err_t api_v1_recordings_download_get(httpd_req_t *req) {
     httpd_resp_set_type(req, "audio/wav");
     httpd_resp_set_hdr(req, "Cache-Control", "no-store");
 
-    uint8_t buf[4096];
-    while (true) {
-        const size_t n = fread(buf, 1, sizeof(buf), fp);
-        if (n > 0) {
-            const esp_err_t err = httpd_resp_send_chunk(req, (const char *)buf, (ssize_t)n);
-            if (err != ESP_OK) {
-                fclose(fp);
-                return err;
-            }
-        }
-        if (n < sizeof(buf)) break;
+    WavImaAdpcmHeader adpcm;
+    uint8_t head[sizeof(WavImaAdpcmHeader)];
+    const size_t head_len = fread(head, 1, sizeof(head), fp);
+    esp_err_t err = ESP_OK;
+    if (!query_flag(req, "raw") && wav_ima_adpcm_parse(head, head_len, &adpcm)) {
+        err = send_ima_adpcm_as_pcm(req, fp, adpcm);
+    } else {
+        (void)fseek(fp, 0, SEEK_SET);
+        err = send_file_raw(req, fp);
     }
     fclose(fp);
-    return httpd_resp_send_chunk(req, nullptr, 0);
+    return err;
 }
 
 static esp_err_t api_v1_recordings_delete(httpd_req_t *req) {
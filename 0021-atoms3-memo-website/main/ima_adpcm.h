@@ -0,0 +1,36 @@
+#pragma once
+
+/*
+ * IMA ADPCM (the IMA/DVI coder of WAV format tag 0x11): 4 bits per 16-bit sample.
+ *
+ * No ESP-IDF dependency so it builds on the host (tools/recorder_host).
+ *
+ * WAV block layout (mono): i16 first sample | u8 step index | u8 0, then one 4-bit code per
+ * remaining sample, low nibble first. A block of `block_align` bytes holds
+ * ima_adpcm_block_samples(block_align) samples; the last block of a file may be shorter.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct ImaAdpcmState {
+    int32_t predictor = 0;
+    int32_t index = 0;
+};
+
+// Streaming coder, one sample at a time; both sides advance *st identically.
+uint8_t ima_adpcm_encode_sample(ImaAdpcmState *st, int16_t sample);
+int16_t ima_adpcm_decode_sample(ImaAdpcmState *st, uint8_t code);
+
+static constexpr size_t ima_adpcm_block_samples(size_t block_align) {
+    return 2 * (block_align - 4) + 1;
+}
+
+// Encodes `n` samples (1 .. ima_adpcm_block_samples(block_align)) as one block into `out`
+// (block_align bytes). The step index carries over in *st. Returns the bytes used: block_align for a
+// full block, fewer for a short last block.
+size_t ima_adpcm_encode_block(ImaAdpcmState *st, const int16_t *samples, size_t n, uint8_t *out, size_t block_align);
+
+// Decodes one block of `len` bytes into at most `max_samples` samples. Returns the samples written,
+// 0 if the block header is invalid.
+size_t ima_adpcm_decode_block(const uint8_t *block, size_t len, int16_t *out, size_t max_samples);
@@ -3,12 +3,19 @@
  *
  * MVP goals:
  * - start/stop recording to SPIFFS
- * - maintain lightweight waveform ring for /api/v1/waveform
+ * - maintain lightweight waveform peaks for /api/v1/waveform
+ *
+ * Two tasks per recording, so a slow SPIFFS write (page GC can take hundreds of ms) never holds up
+ * i2s_read and overruns the I2S DMA:
+ * - memo_capture (high priority): i2s_read -> waveform peaks -> AudioRing
+ * - memo_writer: AudioRing -> optional IMA ADPCM -> fwrite in kWriteChunkBytes pieces
+ * Both sides keep counters (RecorderStatus) so losses show up in /api/v1/status.
  */
 
 #include "recorder.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
@@ -21,11 +28,13 @@
 #include <unistd.h>
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "driver/i2c.h"
 #include "driver/i2s.h"
@@ -36,31 +45,31 @@
 #include "es8311.h"
 #endif
 
+#include "audio_ring.h"
+#include "ima_adpcm.h"
 #include "storage_spiffs.h"
+#include "wav_format.h"
+#include "waveform_peaks.h"
 
 static const char *TAG = "atoms3_memo_recorder";
 
-static constexpr uint16_t kWavAudioFormatPcm = 1;
 static constexpr uint8_t kWavChannels = 1;
 static constexpr uint8_t kWavBitsPerSample = 16;
 
-struct WavHeader {
-    char riff[4] = {'R', 'I', 'F', 'F'};
-    uint32_t riff_size = 0;
-    char wave[4] = {'W', 'A', 'V', 'E'};
-    char fmt[4] = {'f', 'm', 't', ' '};
-    uint32_t fmt_size = 16;
-    uint16_t audio_format = kWavAudioFormatPcm;
-    uint16_t num_channels = kWavChannels;
-    uint32_t sample_rate = 0;
-    uint32_t byte_rate = 0;
-    uint16_t block_align = 0;
-    uint16_t bits_per_sample = kWavBitsPerSample;
-    char data[4] = {'d', 'a', 't', 'a'};
-    uint32_t data_size = 0;
-};
+#if CONFIG_CLINTS_MEMO_RECORD_IMA_ADPCM
+static constexpr bool kRecordImaAdpcm = true;
+#else
+static constexpr bool kRecordImaAdpcm = false;
+#endif
+
+// 1017 samples per block, the usual block size for 16 kHz IMA ADPCM WAV files.
+static constexpr uint16_t kAdpcmBlockAlign = 512;
 
-static_assert(sizeof(WavHeader) == 44, "WAV header size must be 44 bytes");
+// Bytes per fwrite: whole SPIFFS pages (256 bytes) and few enough calls to keep the VFS overhead low.
+static constexpr size_t kWriteChunkBytes = 4096;
+
+static constexpr UBaseType_t kCaptureTaskPriority = 10;
+static constexpr UBaseType_t kWriterTaskPriority = 4;
 
 static inline i2s_port_t i2s_port_from_config() {
 #if CONFIG_CLINTS_MEMO_I2S_PORT_0
@@ -83,9 +92,19 @@ public:
         ESP_ERROR_CHECK(init_i2s_());
 
         const int window_samples = std::max(1, (CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ * CONFIG_CLINTS_MEMO_WAVEFORM_WINDOW_MS) / 1000);
-        waveform_ring_.assign((size_t)window_samples, 0);
-        waveform_write_idx_ = 0;
-        waveform_filled_ = 0;
+        peaks_.init((size_t)CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS, (size_t)window_samples);
+
+        // Room for at least two capture frames, whatever the configured duration.
+        const size_t ring_samples =
+            std::max((size_t)CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ * CONFIG_CLINTS_MEMO_RECORD_RING_MS / 1000,
+                     (size_t)CONFIG_CLINTS_MEMO_AUDIO_FRAME_SAMPLES * 2);
+        if (!ring_.init(ring_samples)) return ESP_ERR_NO_MEM;
+        write_buf_.assign(kWriteChunkBytes, 0);
+        if (kRecordImaAdpcm) adpcm_block_.assign(ima_adpcm_block_samples(kAdpcmBlockAlign), 0);
+
+        ESP_LOGI(TAG, "recorder ready: ring=%u samples (%u ms) format=%s", (unsigned)ring_.capacity(),
+                 (unsigned)(ring_.capacity() * 1000 / CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ),
+                 kRecordImaAdpcm ? "ima_adpcm" : "pcm");
 
         initialized_ = true;
         return ESP_OK;
@@ -113,30 +132,65 @@ public:
             return err;
         }
 
+        // Neither task runs here, so the ring and the writer state can be reset without ordering.
+        ring_.reset();
+        write_len_ = 0;
+        adpcm_fill_ = 0;
+        adpcm_state_ = ImaAdpcmState{};
+
         lock_();
         current_filename_ = filename;
         bytes_written_ = 0;
+        samples_captured_ = 0;
+        samples_encoded_ = 0;
+        dma_overflows_ = 0;
+        max_write_us_ = 0;
         stop_requested_ = false;
+        peaks_.reset();
         unlock_();
 
         if (!done_sem_) {
             done_sem_ = xSemaphoreCreateBinary();
         }
         if (!done_sem_) {
+            finalize_and_close_file_();
             set_error_state_();
             return ESP_ERR_NO_MEM;
         }
 
+        capture_running_.store(true, std::memory_order_release);
         BaseType_t ok = xTaskCreatePinnedToCore(
+            &Recorder::writer_task_entry_,
+            "memo_writer",
+            6144,
+            this,
+            kWriterTaskPriority,
+            &writer_task_,
+            0);
+        if (ok != pdPASS) {
+            ESP_LOGE(TAG, "failed to start writer task");
+            capture_running_.store(false, std::memory_order_release);
+            finalize_and_close_file_();
+            set_error_state_();
+            return ESP_FAIL;
+        }
+
+        ok = xTaskCreatePinnedToCore(
             &Recorder::capture_task_entry_,
             "memo_capture",
-            8192,
+            4096,
             this,
-            5,
+            kCaptureTaskPriority,
             &capture_task_,
             1);
         if (ok != pdPASS) {
             ESP_LOGE(TAG, "failed to start capture task");
+            // The writer finalizes the (empty) file and signals done_sem_. Wake it before
+            // the flag: once it sees the stop it may exit and delete itself.
+            xTaskNotifyGive(writer_task_);
+            capture_running_.store(false, std::memory_order_release);
+            (void)xSemaphoreTake(done_sem_, pdMS_TO_TICKS(5000));
+            writer_task_ = nullptr;
             set_error_state_();
             return ESP_FAIL;
         }
@@ -156,14 +210,15 @@ public:
         out_filename = current_filename_;
         unlock_();
 
-        if (!capture_task_) {
+        if (!capture_task_ || !writer_task_) {
             set_error_state_();
             return ESP_FAIL;
         }
 
-        // Wait for the capture task to finish and signal completion.
+        // The capture task stops after its current i2s_read; the writer then drains the ring,
+        // finalizes the file and signals completion.
         if (xSemaphoreTake(done_sem_, pdMS_TO_TICKS(5000)) != pdTRUE) {
-            ESP_LOGE(TAG, "timeout waiting for capture task to stop");
+            ESP_LOGE(TAG, "timeout waiting for writer task to stop");
             set_error_state_();
             return ESP_ERR_TIMEOUT;
         }
@@ -171,8 +226,13 @@ public:
         lock_();
         state_ = State::Idle;
         capture_task_ = nullptr;
+        writer_task_ = nullptr;
         unlock_();
 
+        if (ring_.overruns() || dma_overflows_) {
+            ESP_LOGW(TAG, "%s: dropped %" PRIu32 " samples in %" PRIu32 " ring overruns, %" PRIu32 " I2S DMA overflows",
+                     out_filename.c_str(), ring_.dropped_samples(), ring_.overruns(), dma_overflows_);
+        }
         return ESP_OK;
     }
 
@@ -185,76 +245,24 @@ public:
         st.sample_rate_hz = CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ;
         st.channels = kWavChannels;
         st.bits_per_sample = kWavBitsPerSample;
+        st.samples_captured = samples_captured_;
+        st.dma_overflows = dma_overflows_;
+        st.max_write_us = max_write_us_;
         unlock_();
+        st.format = kRecordImaAdpcm ? "ima_adpcm" : "pcm";
+        st.dropped_samples = ring_.dropped_samples();
+        st.ring_overruns = ring_.overruns();
+        st.ring_capacity = (uint32_t)ring_.capacity();
+        st.ring_high_water = ring_.high_water();
         return st;
     }
 
-    std::string waveform_json() {
-        const int n = CONFIG_CLINTS_MEMO_WAVEFORM_N_POINTS;
-        std::vector<int16_t> ring_copy;
-        size_t write_idx = 0;
-        size_t filled = 0;
-
+    size_t waveform_peaks(int16_t *mins, int16_t *maxs, size_t cap, uint32_t *bucket_samples) {
         lock_();
-        ring_copy = waveform_ring_;
-        write_idx = waveform_write_idx_;
-        filled = waveform_filled_;
+        const size_t n = peaks_.copy(mins, maxs, cap);
+        if (bucket_samples) *bucket_samples = (uint32_t)peaks_.bucket_samples();
         unlock_();
-
-        std::vector<int16_t> recent(ring_copy.size(), 0);
-        if (filled == 0) {
-            // all zeros
-        } else if (filled < ring_copy.size()) {
-            // Not full yet: copy the filled prefix to the end so "latest" is right-aligned.
-            const size_t start = recent.size() - filled;
-            std::copy_n(ring_copy.begin(), filled, recent.begin() + (ptrdiff_t)start);
-        } else {
-            // Full ring: chronological order starting at write_idx (oldest).
-            for (size_t i = 0; i < recent.size(); i++) {
-                recent[i] = ring_copy[(write_idx + i) % ring_copy.size()];
-            }
-        }
-
-        std::vector<int16_t> points((size_t)n, 0);
-        if (!recent.empty()) {
-            for (int i = 0; i < n; i++) {
-                const size_t start = (size_t)((uint64_t)i * (uint64_t)recent.size() / (uint64_t)n);
-                const size_t end = (size_t)((uint64_t)(i + 1) * (uint64_t)recent.size() / (uint64_t)n);
-                int16_t best = 0;
-                int best_abs = -1;
-                for (size_t j = start; j < std::max(end, start + 1); j++) {
-                    const int16_t v = recent[std::min(j, recent.size() - 1)];
-                    const int a = std::abs((int)v);
-                    if (a > best_abs) {
-                        best_abs = a;
-                        best = v;
-                    }
-                }
-                points[(size_t)i] = best;
-            }
-        }
-
-        std::string json;
-        json.reserve(2048);
-        json += "{";
-        json += "\"ok\":true,";
-        json += "\"sample_rate_hz\":";
-        json += std::to_string(CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ);
-        json += ",";
-        json += "\"window_ms\":";
-        json += std::to_string(CONFIG_CLINTS_MEMO_WAVEFORM_WINDOW_MS);
-        json += ",";
-        json += "\"n\":";
-        json += std::to_string(n);
-        json += ",";
-        json += "\"points_i16\":[";
-        for (int i = 0; i < n; i++) {
-            if (i) json += ",";
-            json += std::to_string(points[(size_t)i]);
-        }
-        json += "]";
-        json += "}";
-        return json;
+        return n;
     }
 
 private:
@@ -304,7 +312,8 @@ private:
         cfg.use_apll = 1;
         cfg.tx_desc_auto_clear = true;
 
-        esp_err_t err = i2s_driver_install(port, &cfg, 0, nullptr);
+        // The event queue is only drained for I2S_EVENT_RX_Q_OVF (counted as dma_overflows).
+        esp_err_t err = i2s_driver_install(port, &cfg, 8, &i2s_events_);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "i2s_driver_install failed: %s", esp_err_to_name(err));
             return err;
@@ -393,15 +402,19 @@ private:
                 return ESP_FAIL;
             }
 
-            WavHeader hdr = {};
-            hdr.sample_rate = CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ;
-            hdr.byte_rate = hdr.sample_rate * hdr.num_channels * (hdr.bits_per_sample / 8);
-            hdr.block_align = hdr.num_channels * (hdr.bits_per_sample / 8);
-            hdr.data_size = 0;
-            hdr.riff_size = 36 + hdr.data_size;
-
-            const size_t wrote = fwrite(&hdr, 1, sizeof(hdr), fp);
-            if (wrote != sizeof(hdr)) {
+            // Sizes are zero until finalize_and_close_file_() rewrites the header.
+            size_t wrote = 0;
+            size_t hdr_size = 0;
+            if (kRecordImaAdpcm) {
+                const WavImaAdpcmHeader hdr = wav_ima_adpcm_header(CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ, kAdpcmBlockAlign, 0, 0);
+                hdr_size = sizeof(hdr);
+                wrote = fwrite(&hdr, 1, sizeof(hdr), fp);
+            } else {
+                const WavPcmHeader hdr = wav_pcm_header(CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ, 0);
+                hdr_size = sizeof(hdr);
+                wrote = fwrite(&hdr, 1, sizeof(hdr), fp);
+            }
+            if (wrote != hdr_size) {
                 fclose(fp);
                 unlink(path.c_str());
                 ESP_LOGE(TAG, "failed writing WAV header: %s", path.c_str());
@@ -421,32 +434,37 @@ private:
         return ESP_ERR_NO_MEM;
     }
 
-    void finalize_and_close_file_(uint32_t data_bytes) {
+    void finalize_and_close_file_() {
         FILE *fp = nullptr;
         std::string path;
+        uint32_t data_bytes = 0;
+        uint32_t samples = 0;
 
         lock_();
         fp = file_;
         path = file_path_;
+        data_bytes = bytes_written_;
+        samples = samples_encoded_;
         file_ = nullptr;
         file_path_.clear();
         unlock_();
 
         if (!fp) return;
 
-        WavHeader hdr = {};
-        hdr.sample_rate = CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ;
-        hdr.byte_rate = hdr.sample_rate * hdr.num_channels * (hdr.bits_per_sample / 8);
-        hdr.block_align = hdr.num_channels * (hdr.bits_per_sample / 8);
-        hdr.data_size = data_bytes;
-        hdr.riff_size = 36 + hdr.data_size;
-
         (void)fseek(fp, 0, SEEK_SET);
-        (void)fwrite(&hdr, 1, sizeof(hdr), fp);
+        if (kRecordImaAdpcm) {
+            const WavImaAdpcmHeader hdr =
+                wav_ima_adpcm_header(CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ, kAdpcmBlockAlign, samples, data_bytes);
+            (void)fwrite(&hdr, 1, sizeof(hdr), fp);
+        } else {
+            const WavPcmHeader hdr = wav_pcm_header(CONFIG_CLINTS_MEMO_AUDIO_SAMPLE_RATE_HZ, data_bytes);
+            (void)fwrite(&hdr, 1, sizeof(hdr), fp);
+        }
         fflush(fp);
         fclose(fp);
 
-        ESP_LOGI(TAG, "finalized wav: %s bytes=%" PRIu32, path.c_str(), data_bytes);
+        ESP_LOGI(TAG, "finalized wav: %s bytes=%" PRIu32 " max_write_us=%" PRIu32 " ring_high_water=%" PRIu32 "/%u",
+                 path.c_str(), data_bytes, max_write_us_, ring_.high_water(), (unsigned)ring_.capacity());
     }
 
     void capture_loop_() {
@@ -467,49 +485,138 @@ private:
                 ESP_LOGE(TAG, "i2s_read failed: %s", esp_err_to_name(err));
                 break;
             }
-            if (bytes_read == 0) continue;
 
-            // Feed waveform ring.
-            const size_t samples = bytes_read / sizeof(int16_t);
-            lock_();
-            for (size_t i = 0; i < samples; i++) {
-                waveform_ring_[waveform_write_idx_] = buf[i];
-                waveform_write_idx_ = (waveform_write_idx_ + 1) % waveform_ring_.size();
-                waveform_filled_ = std::min(waveform_filled_ + 1, waveform_ring_.size());
+            // The driver reports a DMA buffer it had to drop because we did not read in time.
+            uint32_t overflows = 0;
+            i2s_event_t ev;
+            while (i2s_events_ && xQueueReceive(i2s_events_, &ev, 0) == pdTRUE) {
+                if (ev.type == I2S_EVENT_RX_Q_OVF) overflows++;
             }
-            unlock_();
 
-            // Append to file.
-            FILE *fp = nullptr;
+            const size_t samples = bytes_read / sizeof(int16_t);
             lock_();
-            fp = file_;
+            dma_overflows_ += overflows;
+            samples_captured_ += (uint32_t)samples;
+            peaks_.push(buf.data(), samples);
             unlock_();
-            if (!fp) {
-                ESP_LOGE(TAG, "file closed unexpectedly");
-                break;
-            }
+            if (samples == 0) continue;
 
-            const size_t wrote = fwrite(buf.data(), 1, bytes_read, fp);
-            if (wrote != bytes_read) {
-                ESP_LOGE(TAG, "fwrite failed wrote=%u expected=%u", (unsigned)wrote, (unsigned)bytes_read);
-                break;
-            }
+            // Never blocks: if the writer is that far behind, the frame is dropped and counted.
+            (void)ring_.push(buf.data(), samples);
+            xTaskNotifyGive(writer_task_);
+        }
+    }
 
-            lock_();
-            bytes_written_ += (uint32_t)wrote;
-            unlock_();
+    // One fwrite to the open file, timed; bytes_written_ counts what actually landed.
+    bool file_write_(FILE *fp, const void *data, size_t len) {
+        const int64_t t0 = esp_timer_get_time();
+        const size_t wrote = fwrite(data, 1, len, fp);
+        const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+        lock_();
+        bytes_written_ += (uint32_t)wrote;
+        if (us > max_write_us_) max_write_us_ = us;
+        unlock_();
+
+        if (wrote != len) {
+            ESP_LOGE(TAG, "fwrite failed wrote=%u expected=%u", (unsigned)wrote, (unsigned)len);
+            return false;
+        }
+        return true;
+    }
+
+    // Encodes the pending ADPCM samples as one block into write_buf_, flushing write_buf_ first if
+    // the block does not fit.
+    bool flush_adpcm_block_(FILE *fp) {
+        if (adpcm_fill_ == 0) return true;
+        if (write_len_ + kAdpcmBlockAlign > write_buf_.size()) {
+            if (!file_write_(fp, write_buf_.data(), write_len_)) return false;
+            write_len_ = 0;
+        }
+        write_len_ += ima_adpcm_encode_block(&adpcm_state_, adpcm_block_.data(), adpcm_fill_, &write_buf_[write_len_],
+                                             kAdpcmBlockAlign);
+        lock_();
+        samples_encoded_ += (uint32_t)adpcm_fill_;
+        unlock_();
+        adpcm_fill_ = 0;
+        return true;
+    }
+
+    bool write_samples_(FILE *fp, const int16_t *samples, size_t n) {
+        if (!kRecordImaAdpcm) {
+            // Straight from the ring: no copy.
+            return file_write_(fp, samples, n * sizeof(int16_t));
         }
+        while (n > 0) {
+            const size_t take = std::min(n, adpcm_block_.size() - adpcm_fill_);
+            memcpy(&adpcm_block_[adpcm_fill_], samples, take * sizeof(int16_t));
+            adpcm_fill_ += take;
+            samples += take;
+            n -= take;
+            if (adpcm_fill_ == adpcm_block_.size() && !flush_adpcm_block_(fp)) return false;
+        }
+        return true;
+    }
 
-        uint32_t bytes = 0;
+    void writer_loop_() {
+        FILE *fp = nullptr;
         lock_();
-        bytes = bytes_written_;
+        fp = file_;
         unlock_();
-        finalize_and_close_file_(bytes);
+
+        const size_t chunk_samples = kWriteChunkBytes / sizeof(int16_t);
+        bool ok = (fp != nullptr);
+        if (!ok) ESP_LOGE(TAG, "file closed unexpectedly");
+
+        while (true) {
+            // Flag before fill level: once the capture task is seen stopped, all it pushed is visible.
+            const bool capture_done = !capture_running_.load(std::memory_order_acquire);
+            size_t avail = ring_.readable();
+            if (avail == 0 && capture_done) break;
+            if (avail < chunk_samples && !capture_done) {
+                (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+                continue;
+            }
+
+            // Whole chunks while recording; the remainder once capture has stopped.
+            while (avail >= chunk_samples || (capture_done && avail > 0)) {
+                size_t n = 0;
+                const int16_t *span = ring_.read_span(&n);
+                n = std::min(n, chunk_samples);
+                if (ok && !write_samples_(fp, span, n)) {
+                    // Keep draining (and discarding) until the capture task has seen the stop.
+                    ok = false;
+                    lock_();
+                    stop_requested_ = true;
+                    unlock_();
+                }
+                ring_.consume(n);
+                avail -= n;
+            }
+        }
+
+        if (ok && kRecordImaAdpcm) {
+            ok = flush_adpcm_block_(fp) && (write_len_ == 0 || file_write_(fp, write_buf_.data(), write_len_));
+            write_len_ = 0;
+        }
+        finalize_and_close_file_();
     }
 
     static void capture_task_entry_(void *arg) {
         auto *self = static_cast<Recorder *>(arg);
+        // stop() clears writer_task_ once the writer is done; keep our own handle.
+        TaskHandle_t writer = self->writer_task_;
         self->capture_loop_();
+        // Notify while the writer is certainly alive: after it sees the flag it may exit.
+        // A wake that lands before the store costs it at most one 100 ms poll.
+        xTaskNotifyGive(writer);
+        self->capture_running_.store(false, std::memory_order_release);
+        vTaskDelete(nullptr);
+    }
+
+    static void writer_task_entry_(void *arg) {
+        auto *self = static_cast<Recorder *>(arg);
+        self->writer_loop_();
         xSemaphoreGive(self->done_sem_);
         vTaskDelete(nullptr);
     }
@@ -520,20 +627,33 @@ private:
     State state_ = State::Idle;
 
     bool i2s_installed_ = false;
+    QueueHandle_t i2s_events_ = nullptr;
     TaskHandle_t capture_task_ = nullptr;
+    TaskHandle_t writer_task_ = nullptr;
     SemaphoreHandle_t done_sem_ = nullptr;
+    std::atomic<bool> capture_running_{false};
 
     bool stop_requested_ = false;
     uint32_t bytes_written_ = 0;
+    uint32_t samples_captured_ = 0;
+    uint32_t samples_encoded_ = 0;
+    uint32_t dma_overflows_ = 0;
+    uint32_t max_write_us_ = 0;
     uint32_t file_counter_ = 0;
     std::string current_filename_;
 
     FILE *file_ = nullptr;
     std::string file_path_;
 
-    std::vector<int16_t> waveform_ring_;
-    size_t waveform_write_idx_ = 0;
-    size_t waveform_filled_ = 0;
+    AudioRing ring_;
+    WaveformPeaks peaks_;
+
+    // Writer task only.
+    std::vector<uint8_t> write_buf_;
+    size_t write_len_ = 0;
+    std::vector<int16_t> adpcm_block_;
+    size_t adpcm_fill_ = 0;
+    ImaAdpcmState adpcm_state_;
 
 #if CONFIG_CLINTS_MEMO_CODEC_ES8311_ENABLE
     bool es8311_initialized_ = false;
@@ -562,6 +682,6 @@ RecorderStatus recorder_get_status(void) {
     return recorder_singleton().status();
 }
 
-std::string recorder_get_waveform_json(void) {
-    return recorder_singleton().waveform_json();
+size_t recorder_get_waveform_peaks(int16_t *mins, int16_t *maxs, size_t cap, uint32_t *bucket_samples) {
+    return recorder_singleton().waveform_peaks(mins, maxs, cap, bucket_samples);
 }
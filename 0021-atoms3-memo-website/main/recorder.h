@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
 
 #include "esp_err.h"
@@ -11,6 +14,17 @@ struct RecorderStatus {
     uint32_t sample_rate_hz = 0;
     uint8_t channels = 1;
     uint8_t bits_per_sample = 16;
+    const char *format = "pcm"; // file encoding: "pcm" or "ima_adpcm"
+
+    // Current / last recording. Samples the writer could not keep up with are dropped whole frames
+    // at a time (ring_overruns), so the file is short by exactly dropped_samples.
+    uint32_t samples_captured = 0;
+    uint32_t dropped_samples = 0;
+    uint32_t ring_overruns = 0;
+    uint32_t dma_overflows = 0; // I2S driver RX queue overflowed: the capture task itself was late
+    uint32_t ring_capacity = 0; // samples
+    uint32_t ring_high_water = 0;
+    uint32_t max_write_us = 0; // slowest single fwrite to SPIFFS
 };
 
 esp_err_t recorder_init(void);
@@ -23,6 +37,7 @@ esp_err_t recorder_stop(std::string &out_filename);
 
 RecorderStatus recorder_get_status(void);
 
-// Returns JSON string for GET /api/v1/waveform (per ticket contract).
-std::string recorder_get_waveform_json(void);
-
+// Copies the min/max peaks of the last CONFIG_CLINTS_MEMO_WAVEFORM_WINDOW_MS of audio for
+// GET /api/v1/waveform, oldest first (zeros until the window has filled). Returns the number of
+// points written (at most `cap`); *bucket_samples is the number of samples per point.
+size_t recorder_get_waveform_peaks(int16_t *mins, int16_t *maxs, size_t cap, uint32_t *bucket_samples);
@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * WAV headers written by the recorder (mono, little-endian like both targets):
+ * - 16-bit PCM: the classic 44-byte header.
+ * - IMA ADPCM (format tag 0x11): 60 bytes; the `fact` chunk holds the sample count, since the last
+ *   block may be short.
+ *
+ * Header-only, no ESP-IDF dependency (tools/recorder_host).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ima_adpcm.h"
+
+static constexpr uint16_t kWavFormatPcm = 1;
+static constexpr uint16_t kWavFormatImaAdpcm = 0x11;
+
+struct WavPcmHeader {
+    char riff[4] = {'R', 'I', 'F', 'F'};
+    uint32_t riff_size = 0;
+    char wave[4] = {'W', 'A', 'V', 'E'};
+    char fmt[4] = {'f', 'm', 't', ' '};
+    uint32_t fmt_size = 16;
+    uint16_t audio_format = kWavFormatPcm;
+    uint16_t num_channels = 1;
+    uint32_t sample_rate = 0;
+    uint32_t byte_rate = 0;
+    uint16_t block_align = 0;
+    uint16_t bits_per_sample = 16;
+    char data[4] = {'d', 'a', 't', 'a'};
+    uint32_t data_size = 0;
+};
+
+static_assert(sizeof(WavPcmHeader) == 44, "WAV header size must be 44 bytes");
+
+struct WavImaAdpcmHeader {
+    char riff[4] = {'R', 'I', 'F', 'F'};
+    uint32_t riff_size = 0;
+    char wave[4] = {'W', 'A', 'V', 'E'};
+    char fmt[4] = {'f', 'm', 't', ' '};
+    uint32_t fmt_size = 20;
+    uint16_t audio_format = kWavFormatImaAdpcm;
+    uint16_t num_channels = 1;
+    uint32_t sample_rate = 0;
+    uint32_t byte_rate = 0;
+    uint16_t block_align = 0;
+    uint16_t bits_per_sample = 4;
+    uint16_t extra_size = 2;
+    uint16_t samples_per_block = 0;
+    char fact[4] = {'f', 'a', 'c', 't'};
+    uint32_t fact_size = 4;
+    uint32_t sample_count = 0;
+    char data[4] = {'d', 'a', 't', 'a'};
+    uint32_t data_size = 0;
+};
+
+static_assert(sizeof(WavImaAdpcmHeader) == 60, "IMA ADPCM WAV header size must be 60 bytes");
+
+static inline WavPcmHeader wav_pcm_header(uint32_t sample_rate, uint32_t data_bytes) {
+    WavPcmHeader hdr;
+    hdr.sample_rate = sample_rate;
+    hdr.byte_rate = sample_rate * hdr.num_channels * (hdr.bits_per_sample / 8);
+    hdr.block_align = (uint16_t)(hdr.num_channels * (hdr.bits_per_sample / 8));
+    hdr.data_size = data_bytes;
+    hdr.riff_size = 36 + data_bytes;
+    return hdr;
+}
+
+static inline WavImaAdpcmHeader wav_ima_adpcm_header(uint32_t sample_rate, uint16_t block_align, uint32_t samples,
+                                                     uint32_t data_bytes) {
+    WavImaAdpcmHeader hdr;
+    hdr.sample_rate = sample_rate;
+    hdr.block_align = block_align;
+    hdr.samples_per_block = (uint16_t)ima_adpcm_block_samples(block_align);
+    hdr.byte_rate = (uint32_t)((uint64_t)sample_rate * block_align / hdr.samples_per_block);
+    hdr.sample_count = samples;
+    hdr.data_size = data_bytes;
+    hdr.riff_size = (uint32_t)(sizeof(WavImaAdpcmHeader) - 8) + data_bytes;
+    return hdr;
+}
+
+// Recognizes the IMA ADPCM layout written above (not arbitrary WAV files).
+static inline bool wav_ima_adpcm_parse(const void *p, size_t len, WavImaAdpcmHeader *out) {
+    if (len < sizeof(WavImaAdpcmHeader)) return false;
+    memcpy(out, p, sizeof(*out));
+    return memcmp(out->riff, "RIFF", 4) == 0 && memcmp(out->wave, "WAVE", 4) == 0 &&
+           memcmp(out->fmt, "fmt ", 4) == 0 && out->fmt_size == 20 && out->audio_format == kWavFormatImaAdpcm &&
+           out->num_channels == 1 && out->block_align > 4 &&
+           out->samples_per_block == ima_adpcm_block_samples(out->block_align) && memcmp(out->fact, "fact", 4) == 0 &&
+           memcmp(out->data, "data", 4) == 0;
+}
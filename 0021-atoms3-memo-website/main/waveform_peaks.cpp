@@ -0,0 +1,58 @@
+#include "waveform_peaks.h"
+
+#include <algorithm>
+
+void WaveformPeaks::init(size_t n_points, size_t window_samples) {
+    if (n_points == 0) n_points = 1;
+    mins_.assign(n_points, 0);
+    maxs_.assign(n_points, 0);
+    bucket_samples_ = (window_samples / n_points > 0) ? window_samples / n_points : 1;
+    reset();
+}
+
+void WaveformPeaks::reset() {
+    std::fill(mins_.begin(), mins_.end(), (int16_t)0);
+    std::fill(maxs_.begin(), maxs_.end(), (int16_t)0);
+    next_ = 0;
+    in_bucket_ = 0;
+    cur_min_ = 0;
+    cur_max_ = 0;
+}
+
+void WaveformPeaks::push(const int16_t *samples, size_t n) {
+    if (mins_.empty()) return;
+    while (n > 0) {
+        const size_t take = (n < bucket_samples_ - in_bucket_) ? n : bucket_samples_ - in_bucket_;
+        int16_t lo = (in_bucket_ == 0) ? samples[0] : cur_min_;
+        int16_t hi = (in_bucket_ == 0) ? samples[0] : cur_max_;
+        for (size_t i = 0; i < take; i++) {
+            const int16_t v = samples[i];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        cur_min_ = lo;
+        cur_max_ = hi;
+        in_bucket_ += take;
+        samples += take;
+        n -= take;
+
+        if (in_bucket_ == bucket_samples_) {
+            mins_[next_] = cur_min_;
+            maxs_[next_] = cur_max_;
+            next_ = (next_ + 1 == mins_.size()) ? 0 : next_ + 1;
+            in_bucket_ = 0;
+        }
+    }
+}
+
+size_t WaveformPeaks::copy(int16_t *mins, int16_t *maxs, size_t cap) const {
+    const size_t n = (cap < mins_.size()) ? cap : mins_.size();
+    // Slot `next_` is the oldest; unfilled slots are still 0, which gives the right-aligned view.
+    size_t at = (next_ + mins_.size() - n) % mins_.size();
+    for (size_t i = 0; i < n; i++) {
+        mins[i] = mins_[at];
+        maxs[i] = maxs_[at];
+        at = (at + 1 == mins_.size()) ? 0 : at + 1;
+    }
+    return n;
+}
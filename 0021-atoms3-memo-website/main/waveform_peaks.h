@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * Min/max peaks of the most recent audio window, for GET /api/v1/waveform.
+ *
+ * Updated as samples arrive, so a request only copies `points()` pairs instead of resampling the
+ * raw window. The window is split into buckets of `window_samples / n_points` samples; a bucket is
+ * published once complete, so the newest point lags the audio by at most one bucket.
+ *
+ * No ESP-IDF dependency (tools/recorder_host); not thread-safe, the recorder locks around it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+class WaveformPeaks {
+public:
+    void init(size_t n_points, size_t window_samples);
+    void reset();
+
+    void push(const int16_t *samples, size_t n);
+
+    // Copies the newest min(cap, points()) buckets, oldest first. Buckets not yet filled since the
+    // last reset read as 0. Returns the number of points written.
+    size_t copy(int16_t *mins, int16_t *maxs, size_t cap) const;
+
+    size_t points() const { return mins_.size(); }
+    size_t bucket_samples() const { return bucket_samples_; }
+
+private:
+    std::vector<int16_t> mins_;
+    std::vector<int16_t> maxs_;
+    size_t bucket_samples_ = 1;
+    size_t next_ = 0; // bucket slot written next (the oldest once the ring has wrapped)
+
+    size_t in_bucket_ = 0;
+    int16_t cur_min_ = 0;
+    int16_t cur_max_ = 0;
+};
@@ -0,0 +1,521 @@
+/*
+ * Host test and benchmark for the recorder's task-independent parts:
+ *   - AudioRing (main/audio_ring.cpp): wrap-around, all-or-nothing overruns and their counters, and
+ *     a two-thread producer / slow-consumer run where every received frame must be whole and in
+ *     order and received + dropped frames must add up;
+ *   - IMA ADPCM (main/ima_adpcm.cpp): sample codes and reconstruction against reference data from
+ *     CPython's audioop (the DVI reference coder), WAV block round trips including short last
+ *     blocks, and the WAV header (main/wav_format.h);
+ *   - WaveformPeaks (main/waveform_peaks.cpp): against a brute-force min/max over the same window.
+ * Then reports ring / codec / waveform-request costs, the latter next to the previous approach
+ * (copy the raw window, decimate, build a std::string per request).
+ *
+ * Built and run by tools/recorder_host/run_recorder_host.sh. Prints JSONL; exits non-zero on failure.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_ring.h"
+#include "ima_adpcm.h"
+#include "wav_format.h"
+#include "waveform_peaks.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                            \
+            return;                                                                  \
+        }                                                                            \
+    } while (0)
+
+static constexpr int kSampleRate = 16000;
+static constexpr size_t kFrameSamples = 640; // CONFIG_CLINTS_MEMO_AUDIO_FRAME_SAMPLES default
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t g_rng = 12345;
+
+static uint32_t rnd(void) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+// Triangle + noise, a 20-sample full-scale burst, then silence; same generator as the reference.
+static std::vector<int16_t> ref_signal(void) {
+    std::vector<int16_t> s;
+    uint32_t x = 1;
+    for (int i = 0; i < 256; i++) {
+        x = (x * 1103515245u + 12345u) & 0x7fffffffu;
+        const int noise = (int)((x >> 16) % 2001) - 1000;
+        const int tri = abs((i * 700) % 28000 - 14000) - 7000;
+        int v = tri + noise;
+        if (i >= 150 && i < 170) v = (i % 2 == 0) ? 30000 : -30000;
+        if (i >= 200) v = 0;
+        s.push_back((int16_t)std::max(-32768, std::min(32767, v)));
+    }
+    return s;
+}
+
+// Voice-like test audio: a few harmonics with a slow vibrato and envelope, plus a little noise.
+static std::vector<int16_t> voice_signal(size_t n) {
+    std::vector<int16_t> s(n);
+    double phase = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double t = (double)i / kSampleRate;
+        const double f0 = 140.0 + 20.0 * sin(2 * M_PI * 3.0 * t);
+        phase += 2 * M_PI * f0 / kSampleRate;
+        const double env = 0.55 + 0.45 * sin(2 * M_PI * 1.3 * t);
+        double v = 0.6 * sin(phase) + 0.25 * sin(2 * phase + 0.3) + 0.12 * sin(3 * phase + 1.1) + 0.05 * sin(7 * phase);
+        v = v * env * 12000.0 + (double)((int)(rnd() % 401) - 200);
+        s[i] = (int16_t)std::max(-32768.0, std::min(32767.0, v));
+    }
+    return s;
+}
+
+static double snr_db(const std::vector<int16_t> &ref, const std::vector<int16_t> &got) {
+    double sig = 0, err = 0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        sig += (double)ref[i] * ref[i];
+        const double d = (double)ref[i] - got[i];
+        err += d * d;
+    }
+    return (err == 0) ? 200.0 : 10.0 * log10(sig / err);
+}
+
+// CPython audioop.lin2adpcm / adpcm2lin (the DVI reference coder) on ref_signal(), initial state 0.
+// One hex digit per sample code, in sample order.
+static const char kRefCodes[] =
+    "77777778ca0a8e91a999c20169412192115214833cc909d08b9ac91c9ad2e382"
+    "80151085082110313f0889c98ad2c0999d98018133179384811140494b900e08"
+    "9b0d0ac0b81e81301210417f7f6f7f7f7f7f7f7f7f4880880808808180081810"
+    "01001812fa808080808080808080808080808080808080808080808080808008";
+static const int16_t kRefDecoded[256] = {
+    11, 41, 104, 240, 533, 1164, 2521, 2327, 740, -326, -132, -1013,
+    -1173, -3067, -3841, -3138, -4204, -4786, -5314, -5794, -7105, -6224, -6064, -5628,
+    -3906, -4609, -2689, -1915, -742, -103, -685, 196, 676, 1112, 2569, 3539,
+    4067, 5509, 5315, 6548, 7669, 6358, 4771, 4132, 4326, 3798, 2036, 2270,
+    2057, 699, 171, -630, -1941, -2469, -1989, -3300, -3828, -4629, -6231, -5165,
+    -7687, -5283, -5595, -4175, -4433, -4199, -3560, -1426, -574, -316, -550, 1796,
+    2108, 1824, 3115, 3818, 4457, 4651, 5884, 6364, 7383, 5396, 5680, 5422,
+    5188, 4549, 2803, 2100, 1887, 917, -1022, 269, -1843, -1559, -2333, -3036,
+    -3675, -5809, -6661, -6919, -6685, -6046, -6240, -5712, -4591, -3572, -3175, -1371,
+    -2145, -503, -716, 1030, 796, 1435, 2017, 2545, 3987, 4181, 5768, 5129,
+    6875, 5233, 4594, 4788, 4964, 2881, 3165, 2907, 2204, 712, 906, -1033,
+    -775, -1948, -3868, -3610, -5252, -5465, -4883, -7175, -7487, -6635, -4828, -4594,
+    -3955, -2985, -2457, -2297, -986, -458, 1945, -3208, 7842, -15847, 28167, -32768,
+    28668, -32768, 28668, -32768, 28668, -32768, 28668, -32768, 28668, -32768, 28668, -32768,
+    28668, -32768, 4094, -1, -3725, -340, -3417, -6215, -3672, -5984, -3882, -5793,
+    -7530, -5951, -7386, -3471, -4657, -3579, -2599, -3490, -1059, -1795, 213, 821,
+    1374, 2883, 3340, 3755, 4889, 4546, 5482, 6902, 3029, 262, -241, 216,
+    -199, 179, -164, 148, -136, 122, -112, 101, -93, 83, -77, 68,
+    -64, 56, -53, 46, -44, 38, -36, 32, -29, 27, -24, 22,
+    -20, 18, -16, 15, -13, 13, -10, 11, -8, 9, -7, 7,
+    -6, 6, -5, 5, -4, 4, -3, 3, -3, 2, -3, 1,
+    -3, 0, 3, 0,
+};
+static const ImaAdpcmState kRefEndState = {0, 12};
+
+// ---- IMA ADPCM ----
+
+static void test_adpcm_reference(void) {
+    const std::vector<int16_t> s = ref_signal();
+    CHECK(strlen(kRefCodes) == s.size());
+
+    ImaAdpcmState enc;
+    size_t code_mismatch = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        const uint8_t want = (uint8_t)strtoul(std::string(1, kRefCodes[i]).c_str(), nullptr, 16);
+        if (ima_adpcm_encode_sample(&enc, s[i]) != want) code_mismatch++;
+    }
+    ImaAdpcmState dec;
+    size_t sample_mismatch = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        const uint8_t code = (uint8_t)strtoul(std::string(1, kRefCodes[i]).c_str(), nullptr, 16);
+        if (ima_adpcm_decode_sample(&dec, code) != kRefDecoded[i]) sample_mismatch++;
+    }
+    printf("{\"test\":\"adpcm_reference\",\"samples\":%zu,\"code_mismatches\":%zu,\"sample_mismatches\":%zu}\n",
+           s.size(), code_mismatch, sample_mismatch);
+    CHECK(code_mismatch == 0);
+    CHECK(sample_mismatch == 0);
+    CHECK(enc.predictor == kRefEndState.predictor && enc.index == kRefEndState.index);
+    CHECK(dec.predictor == enc.predictor && dec.index == enc.index);
+}
+
+// Encodes `s` as WAV blocks and decodes them back; returns the encoded size.
+static size_t adpcm_blocks_roundtrip(const std::vector<int16_t> &s, size_t block_align, std::vector<int16_t> *out) {
+    const size_t spb = ima_adpcm_block_samples(block_align);
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> block(block_align);
+    ImaAdpcmState st;
+    for (size_t at = 0; at < s.size(); at += spb) {
+        const size_t n = std::min(spb, s.size() - at);
+        const size_t len = ima_adpcm_encode_block(&st, &s[at], n, block.data(), block_align);
+        data.insert(data.end(), block.begin(), block.begin() + (ptrdiff_t)len);
+    }
+    out->assign(s.size(), 0);
+    size_t got = 0;
+    for (size_t p = 0; p < data.size() && got < s.size(); p += block_align) {
+        const size_t len = std::min(block_align, data.size() - p);
+        got += ima_adpcm_decode_block(&data[p], len, &(*out)[got], std::min(spb, s.size() - got));
+    }
+    if (got != s.size()) out->clear();
+    return data.size();
+}
+
+static void test_adpcm_blocks(void) {
+    // Block headers restart the predictor at the exact sample; the rest follows the stream coder.
+    const std::vector<int16_t> s = ref_signal();
+    std::vector<int16_t> got;
+    const size_t bytes = adpcm_blocks_roundtrip(s, 16, &got); // 25 samples per block
+    CHECK(got.size() == s.size());
+    // Model: each block header is exact, the rest is the stream coder's reconstruction.
+    ImaAdpcmState model;
+    std::vector<int16_t> want(s.size());
+    for (size_t at = 0; at < s.size(); at += 25) {
+        model.predictor = s[at];
+        want[at] = s[at];
+        for (size_t i = at + 1; i < std::min(at + 25, s.size()); i++) {
+            ima_adpcm_encode_sample(&model, s[i]);
+            want[i] = (int16_t)model.predictor;
+        }
+    }
+    size_t mismatch = 0;
+    for (size_t i = 0; i < s.size(); i++) mismatch += (got[i] != want[i]);
+    printf("{\"test\":\"adpcm_blocks\",\"block_align\":16,\"samples\":%zu,\"bytes\":%zu,\"mismatches\":%zu}\n",
+           s.size(), bytes, mismatch);
+    CHECK(mismatch == 0);
+
+    // 512-byte blocks (the recorder's), with odd and even short last blocks.
+    const size_t lengths[] = {1, 2, 1017, 1018, 1019, 16000 * 3 + 7};
+    for (size_t len : lengths) {
+        const std::vector<int16_t> v = voice_signal(len);
+        const size_t enc_bytes = adpcm_blocks_roundtrip(v, 512, &got);
+        CHECK(got.size() == v.size());
+        CHECK(got[0] == v[0]);
+        const size_t full = len / 1017, tail = len % 1017;
+        CHECK(enc_bytes == full * 512 + (tail ? 4 + tail / 2 : 0));
+    }
+
+    // Bad input.
+    uint8_t block[16] = {0, 0, 89, 0};
+    int16_t out[25];
+    CHECK(ima_adpcm_decode_block(block, sizeof(block), out, 25) == 0);
+    ImaAdpcmState st2;
+    CHECK(ima_adpcm_encode_block(&st2, s.data(), 26, block, sizeof(block)) == 0);
+}
+
+static void test_adpcm_quality(void) {
+    const std::vector<int16_t> v = voice_signal((size_t)kSampleRate * 5);
+    std::vector<int16_t> got;
+    const size_t bytes = adpcm_blocks_roundtrip(v, 512, &got);
+    CHECK(got.size() == v.size());
+    const double snr = snr_db(v, got);
+    const double ratio = (double)(v.size() * 2) / (double)bytes;
+    printf("{\"test\":\"adpcm_quality\",\"seconds\":5,\"pcm_bytes\":%zu,\"adpcm_bytes\":%zu,\"ratio\":%.2f,\"snr_db\":%.1f}\n",
+           v.size() * 2, bytes, ratio, snr);
+    CHECK(ratio > 3.9);
+    CHECK(snr > 25.0);
+}
+
+static void test_wav_header(void) {
+    const WavImaAdpcmHeader h = wav_ima_adpcm_header(16000, 512, 48007, 24072);
+    CHECK(h.samples_per_block == 1017);
+    CHECK(h.byte_rate == 16000u * 512u / 1017u);
+    CHECK(h.riff_size == 52 + 24072);
+    WavImaAdpcmHeader parsed;
+    CHECK(wav_ima_adpcm_parse(&h, sizeof(h), &parsed));
+    CHECK(parsed.sample_count == 48007 && parsed.data_size == 24072 && parsed.block_align == 512);
+    CHECK(!wav_ima_adpcm_parse(&h, sizeof(h) - 1, &parsed));
+
+    const WavPcmHeader pcm = wav_pcm_header(16000, 32000);
+    CHECK(pcm.byte_rate == 32000 && pcm.block_align == 2 && pcm.riff_size == 36 + 32000);
+    CHECK(!wav_ima_adpcm_parse(&pcm, sizeof(pcm), &parsed));
+}
+
+// ---- AudioRing ----
+
+static void test_ring_basic(void) {
+    AudioRing ring;
+    CHECK(ring.init(1000));
+    CHECK(ring.capacity() == 1024);
+
+    std::vector<int16_t> frame(300);
+    int16_t next = 0;
+    int16_t expect = 0;
+    // Several laps with reads split at the wrap point.
+    for (int round = 0; round < 20; round++) {
+        for (auto &v : frame) v = next++;
+        CHECK(ring.push(frame.data(), frame.size()) == frame.size());
+        size_t left = ring.readable();
+        CHECK(left == 300);
+        while (left > 0) {
+            size_t n = 0;
+            const int16_t *p = ring.read_span(&n);
+            CHECK(n > 0 && n <= left);
+            for (size_t i = 0; i < n; i++) CHECK(p[i] == expect++);
+            ring.consume(n);
+            left -= n;
+        }
+    }
+    CHECK(ring.overruns() == 0);
+
+    // All or nothing: 3 x 300 fit, the 4th is dropped and counted.
+    for (int i = 0; i < 3; i++) CHECK(ring.push(frame.data(), frame.size()) == frame.size());
+    CHECK(ring.push(frame.data(), frame.size()) == 0);
+    CHECK(ring.overruns() == 1 && ring.dropped_samples() == 300);
+    CHECK(ring.readable() == 900 && ring.high_water() == 900);
+    CHECK(ring.push(frame.data(), 124) == 124); // exactly full
+    CHECK(ring.readable() == 1024 && ring.high_water() == 1024);
+
+    ring.reset();
+    CHECK(ring.readable() == 0 && ring.overruns() == 0 && ring.dropped_samples() == 0 && ring.high_water() == 0);
+    CHECK(!ring.init(0));
+}
+
+static void test_ring_threads(void) {
+    // Producer: 640-sample frames every ~100 us (a 16 kHz capture sped up 400x), ring of 4096
+    // samples. Consumer: up to 2048-sample "writes", with one 30 ms stall (a slow flash write) that
+    // must turn into counted, whole-frame drops.
+    AudioRing ring;
+    CHECK(ring.init(4096));
+    const uint32_t frames = 6000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        std::vector<int16_t> f(kFrameSamples);
+        for (uint32_t k = 0; k < frames; k++) {
+            f[0] = (int16_t)k;
+            for (size_t i = 1; i < f.size(); i++) f[i] = (int16_t)((k * 31 + i) & 0x7fff);
+            (void)ring.push(f.data(), f.size());
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t received = 0, bad = 0;
+    int32_t last_k = -1;
+    uint32_t cur_k = 0;
+    size_t pos = 0;
+    bool stalled = false;
+    while (true) {
+        const bool fin = done.load(std::memory_order_acquire);
+        size_t avail = ring.readable();
+        if (avail == 0) {
+            if (fin) break;
+            std::this_thread::yield();
+            continue;
+        }
+        if (!stalled && received > 500) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            stalled = true;
+        }
+        size_t n = 0;
+        const int16_t *p = ring.read_span(&n);
+        n = std::min(n, (size_t)2048);
+        for (size_t i = 0; i < n; i++) {
+            const int16_t v = p[i];
+            if (pos == 0) {
+                cur_k = (uint32_t)(uint16_t)v;
+                if ((int32_t)cur_k <= last_k) bad++;
+                last_k = (int32_t)cur_k;
+            } else if (v != (int16_t)((cur_k * 31 + pos) & 0x7fff)) {
+                bad++;
+            }
+            if (++pos == kFrameSamples) {
+                pos = 0;
+                received++;
+            }
+        }
+        ring.consume(n);
+    }
+    producer.join();
+
+    printf("{\"test\":\"ring_threads\",\"frames\":%u,\"received\":%u,\"overruns\":%u,\"dropped_samples\":%u,"
+           "\"high_water\":%u,\"corrupt\":%u}\n",
+           frames, received, ring.overruns(), ring.dropped_samples(), ring.high_water(), bad);
+    CHECK(bad == 0);
+    CHECK(pos == 0);
+    CHECK(received + ring.overruns() == frames);
+    CHECK(ring.dropped_samples() == ring.overruns() * kFrameSamples);
+    CHECK(ring.overruns() > 0);
+    CHECK(ring.high_water() <= ring.capacity());
+}
+
+// ---- WaveformPeaks ----
+
+static void test_peaks(void) {
+    const size_t n_points = 256, window = 16000;
+    WaveformPeaks peaks;
+    peaks.init(n_points, window);
+    CHECK(peaks.points() == n_points && peaks.bucket_samples() == 62);
+
+    std::vector<int16_t> all = voice_signal(40000);
+    std::vector<int16_t> mins(n_points), maxs(n_points);
+    size_t fed = 0;
+    const size_t checkpoints[] = {0, 61, 62, 100, 5000, 15872, 15873, 30000, 40000};
+    for (size_t cp : checkpoints) {
+        while (fed < cp) {
+            const size_t n = std::min((size_t)(1 + rnd() % 700), cp - fed);
+            peaks.push(&all[fed], n);
+            fed += n;
+        }
+        CHECK(peaks.copy(mins.data(), maxs.data(), n_points) == n_points);
+
+        // Brute force: complete buckets so far, newest right-aligned.
+        const size_t b = peaks.bucket_samples();
+        const size_t complete = fed / b;
+        size_t mismatch = 0;
+        for (size_t i = 0; i < n_points; i++) {
+            const ptrdiff_t bucket = (ptrdiff_t)complete - (ptrdiff_t)n_points + (ptrdiff_t)i;
+            int16_t lo = 0, hi = 0;
+            if (bucket >= 0) {
+                lo = hi = all[(size_t)bucket * b];
+                for (size_t j = (size_t)bucket * b; j < (size_t)(bucket + 1) * b; j++) {
+                    lo = std::min(lo, all[j]);
+                    hi = std::max(hi, all[j]);
+                }
+            }
+            mismatch += (mins[i] != lo) + (maxs[i] != hi);
+        }
+        if (mismatch) printf("{\"test\":\"peaks\",\"fed\":%zu,\"mismatches\":%zu}\n", fed, mismatch);
+        CHECK(mismatch == 0);
+    }
+
+    // A smaller cap returns the newest points.
+    std::vector<int16_t> mins8(8), maxs8(8);
+    CHECK(peaks.copy(mins8.data(), maxs8.data(), 8) == 8);
+    CHECK(memcmp(mins8.data(), &mins[n_points - 8], 8 * sizeof(int16_t)) == 0);
+    CHECK(memcmp(maxs8.data(), &maxs[n_points - 8], 8 * sizeof(int16_t)) == 0);
+
+    peaks.reset();
+    CHECK(peaks.copy(mins.data(), maxs.data(), n_points) == n_points);
+    CHECK(std::all_of(mins.begin(), mins.end(), [](int16_t v) { return v == 0; }));
+    printf("{\"test\":\"peaks\",\"points\":%zu,\"bucket_samples\":%zu,\"checkpoints\":%zu}\n", n_points,
+           peaks.bucket_samples(), sizeof(checkpoints) / sizeof(checkpoints[0]));
+}
+
+// ---- Benchmarks ----
+
+// The previous GET /api/v1/waveform: copy the 1 s raw ring, reorder, pick the largest |sample| per
+// point, build the JSON in a std::string.
+static std::string old_waveform_json(const std::vector<int16_t> &ring, size_t write_idx, int n) {
+    std::vector<int16_t> ring_copy = ring;
+    std::vector<int16_t> recent(ring_copy.size(), 0);
+    for (size_t i = 0; i < recent.size(); i++) recent[i] = ring_copy[(write_idx + i) % ring_copy.size()];
+    std::vector<int16_t> points((size_t)n, 0);
+    for (int i = 0; i < n; i++) {
+        const size_t start = (size_t)((uint64_t)i * recent.size() / (uint64_t)n);
+        const size_t end = (size_t)((uint64_t)(i + 1) * recent.size() / (uint64_t)n);
+        int16_t best = 0;
+        int best_abs = -1;
+        for (size_t j = start; j < std::max(end, start + 1); j++) {
+            const int16_t v = recent[std::min(j, recent.size() - 1)];
+            if (abs((int)v) > best_abs) {
+                best_abs = abs((int)v);
+                best = v;
+            }
+        }
+        points[(size_t)i] = best;
+    }
+    std::string json = "{\"ok\":true,\"sample_rate_hz\":16000,\"window_ms\":1000,\"n\":256,\"points_i16\":[";
+    for (int i = 0; i < n; i++) {
+        if (i) json += ",";
+        json += std::to_string(points[(size_t)i]);
+    }
+    json += "]}";
+    return json;
+}
+
+// The new request path: copy the peaks, print into a fixed buffer (http_server streams it in chunks).
+static size_t new_waveform_json(const WaveformPeaks &peaks, char *buf, size_t cap) {
+    int16_t mins[256], maxs[256];
+    const size_t n = peaks.copy(mins, maxs, 256);
+    size_t len = (size_t)snprintf(buf, cap, "{\"ok\":true,\"n\":%zu,\"min_i16\":[", n);
+    for (size_t i = 0; i < n; i++) len += (size_t)snprintf(buf + len, cap - len, i ? ",%d" : "%d", mins[i]);
+    len += (size_t)snprintf(buf + len, cap - len, "],\"max_i16\":[");
+    for (size_t i = 0; i < n; i++) len += (size_t)snprintf(buf + len, cap - len, i ? ",%d" : "%d", maxs[i]);
+    len += (size_t)snprintf(buf + len, cap - len, "]}");
+    return len;
+}
+
+static void bench(void) {
+    const std::vector<int16_t> audio = voice_signal((size_t)kSampleRate * 10);
+
+    // Capture-side cost per second of audio: ring push + peaks.
+    AudioRing ring;
+    ring.init(16384);
+    WaveformPeaks peaks;
+    peaks.init(256, 16000);
+    double t0 = now_s();
+    for (size_t at = 0; at + kFrameSamples <= audio.size(); at += kFrameSamples) {
+        peaks.push(&audio[at], kFrameSamples);
+        ring.push(&audio[at], kFrameSamples);
+        size_t n = 0;
+        ring.read_span(&n);
+        ring.consume(ring.readable());
+    }
+    double dt = now_s() - t0;
+    printf("{\"bench\":\"capture_path\",\"us_per_audio_s\":%.1f}\n", dt * 1e6 / 10.0);
+
+    // Writer-side ADPCM cost.
+    std::vector<uint8_t> block(512);
+    ImaAdpcmState st;
+    t0 = now_s();
+    size_t bytes = 0;
+    for (size_t at = 0; at < audio.size(); at += 1017) {
+        bytes += ima_adpcm_encode_block(&st, &audio[at], std::min((size_t)1017, audio.size() - at), block.data(), 512);
+    }
+    dt = now_s() - t0;
+    printf("{\"bench\":\"adpcm_encode\",\"us_per_audio_s\":%.1f,\"bytes_per_audio_s\":%zu,\"pcm_bytes_per_audio_s\":%d}\n",
+           dt * 1e6 / 10.0, bytes / 10, kSampleRate * 2);
+
+    // GET /api/v1/waveform.
+    std::vector<int16_t> raw(audio.begin(), audio.begin() + 16000);
+    const int reps = 200;
+    size_t old_len = 0, new_len = 0;
+    t0 = now_s();
+    for (int r = 0; r < reps; r++) old_len = old_waveform_json(raw, (size_t)r % 16000, 256).size();
+    const double old_us = (now_s() - t0) * 1e6 / reps;
+    static char buf[8192];
+    t0 = now_s();
+    for (int r = 0; r < reps; r++) new_len = new_waveform_json(peaks, buf, sizeof(buf));
+    const double new_us = (now_s() - t0) * 1e6 / reps;
+    printf("{\"bench\":\"waveform_request\",\"old_us\":%.1f,\"old_bytes\":%zu,\"old_heap_bytes\":%zu,"
+           "\"new_us\":%.1f,\"new_bytes\":%zu,\"locked_copy_bytes\":%d}\n",
+           old_us, old_len, raw.size() * 2 * 2 + old_len, new_us, new_len, 256 * 2 * 2);
+}
+
+int main(void) {
+    test_adpcm_reference();
+    test_adpcm_blocks();
+    test_adpcm_quality();
+    test_wav_header();
+    test_ring_basic();
+    test_ring_threads();
+    test_peaks();
+    if (g_failures == 0) bench();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the recorder ring / IMA ADPCM / waveform peaks host test and benchmark.
+#
+# Compiles main/audio_ring.cpp, main/ima_adpcm.cpp and main/waveform_peaks.cpp for
+# the host. ADPCM reference data (CPython audioop) is embedded in the test.
+# Prints JSONL.
+#
+# Usage:
+#   ./tools/recorder_host/run_recorder_host.sh
+#   SANITIZE=-fsanitize=thread ./tools/recorder_host/run_recorder_host.sh   # ring ordering
+#   SANITIZE= ./tools/recorder_host/run_recorder_host.sh                    # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/memo-recorder-host}"
+CXX="${CXX:-c++}"
+CXXFLAGS="${CXXFLAGS:--O2 -g -std=gnu++17 -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CXX}" ${CXXFLAGS} ${SANITIZE} -pthread -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/recorder_host_test" \
+  "${HERE}/recorder_host_test.cpp" "${MAIN_DIR}/audio_ring.cpp" "${MAIN_DIR}/ima_adpcm.cpp" \
+  "${MAIN_DIR}/waveform_peaks.cpp" -lm
+"${BUILD_DIR}/recorder_host_test"
@@ -64,6 +64,9 @@ def main() -> int:
 
     lines.append("};")
     lines.append("")
+    lines.append("// Mask form of the table above, for decode_best(KeyMask, ...).")
+    lines.append(f"static constexpr auto {args.symbol}Masks = compile_bindings({args.symbol});")
+    lines.append("")
     lines.append("} // namespace cardputer_kb")
     lines.append("")
 
@@ -60,6 +60,8 @@ extern "C" void app_main(void) {
     lv_cfg.double_buffer = true;
     lv_cfg.swap_bytes = false;
     lv_cfg.tick_ms = 2;
+    lv_cfg.async_flush = true;
+    lv_cfg.merge_areas = true;
 
     if (!lvgl_port_m5gfx_init(display, lv_cfg)) {
         ESP_LOGE(TAG, "lvgl_port_m5gfx_init failed");
@@ -105,6 +107,7 @@ extern "C" void app_main(void) {
 
         const int64_t t0 = esp_timer_get_time();
         lv_timer_handler();
+        lvgl_port_m5gfx_poll();
         const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
         g_lvgl_handler_us_last = us;
         if (g_lvgl_handler_us_avg == 0) {
@@ -132,6 +135,7 @@ extern "C" void app_main(void) {
             } else if (ev.type == CtrlType::ScreenshotPngToUsbSerialJtag) {
                 // Ensure the most recent UI changes have been rendered/flushed before capturing.
                 lv_timer_handler();
+                lvgl_port_m5gfx_flush_wait();
                 size_t len = 0;
                 const bool ok = screenshot_png_to_usb_serial_jtag_ex(display, &len);
                 const uint32_t notify = ok ? (uint32_t)len : 0U;
@@ -143,12 +147,24 @@ extern "C" void app_main(void) {
                 const size_t cap = (ev.arg > 0) ? (size_t)ev.arg : 0U;
                 // Ensure the most recent UI changes have been rendered/flushed before capturing.
                 lv_timer_handler();
+                lvgl_port_m5gfx_flush_wait();
                 size_t len = 0;
                 const bool ok = screenshot_png_save_to_sd_ex(display, out_path, cap, &len);
                 const uint32_t notify = ok ? (uint32_t)len : 0U;
                 if (ev.reply_task) {
                     (void)xTaskNotify(ev.reply_task, notify, eSetValueWithOverwrite);
                 }
+            } else if (ev.type == CtrlType::ScreenshotFastToUsbSerialJtag) {
+                // Encodes the framebuffer copy here (a few ms); a background task streams it and replies.
+                lv_timer_handler();
+                lvgl_port_m5gfx_flush_wait();
+                const auto fmt = static_cast<ScreenshotFormat>(ev.arg & 0xFF);
+                const bool keyframe = (ev.arg & 0x100) != 0;
+                const bool started = lvgl_port_m5gfx_shadow_enable() &&
+                                     screenshot_fast_to_usb_serial_jtag_start(fmt, keyframe, ev.reply_task);
+                if (!started && ev.reply_task) {
+                    (void)xTaskNotify(ev.reply_task, 0U, eSetValueWithOverwrite);
+                }
             } else if (ev.type == CtrlType::OpenSplitConsole) {
                 if (command_palette_is_open()) command_palette_close();
                 demo_manager_load(&demos, DemoId::SplitConsole);
@@ -20,12 +20,15 @@
 #include "lvgl.h"
 
 #include "action_registry.h"
+#include "lvgl_port_m5gfx.h"
+#include "screenshot_png.h"
 #include "sdcard_fatfs.h"
 
 #include "esp_console.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 
 #include "control_plane.h"
 
@@ -45,6 +48,48 @@ static int cmd_heap(int, char **) {
     return 0;
 }
 
+static void print_lvperf(void) {
+    LvglM5gfxStats st{};
+    lvgl_port_m5gfx_get_stats(&st);
+    const int64_t elapsed_us = esp_timer_get_time() - st.since_us;
+    const uint32_t div = st.frames ? st.frames : 1;
+    const uint32_t fps_x10 = (elapsed_us > 0) ? (uint32_t)(((uint64_t)st.frames * 10000000ULL) / (uint64_t)elapsed_us) : 0;
+    printf("lvperf: flush=%s merge=%s elapsed_ms=%" PRIu32 " frames=%" PRIu32 " fps=%" PRIu32 ".%" PRIu32
+           " areas=%" PRIu32 " merged=%" PRIu32 "\n",
+           st.async_flush ? "async" : "sync", st.merge_areas ? "on" : "off", (uint32_t)(elapsed_us / 1000), st.frames,
+           fps_x10 / 10, fps_x10 % 10, st.areas, st.merged);
+    printf("lvperf: per frame: refr_us=%" PRIu32 " wait_us=%" PRIu32 " flush_us=%" PRIu32 " px=%" PRIu32 "\n",
+           (uint32_t)(st.refr_us / div), (uint32_t)(st.wait_us / div), (uint32_t)(st.flush_us / div),
+           (uint32_t)(st.pixels / div));
+}
+
+// Display flush counters; "sync"/"async" and "merge on|off" switch modes for before/after comparisons.
+static int cmd_lvperf(int argc, char **argv) {
+    if (argc < 2) {
+        print_lvperf();
+        return 0;
+    }
+    if (strcmp(argv[1], "reset") == 0) {
+        lvgl_port_m5gfx_reset_stats();
+        printf("OK\n");
+        return 0;
+    }
+    if (strcmp(argv[1], "sync") == 0 || strcmp(argv[1], "async") == 0) {
+        lvgl_port_m5gfx_set_async_flush(strcmp(argv[1], "async") == 0);
+        lvgl_port_m5gfx_reset_stats();
+        printf("OK\n");
+        return 0;
+    }
+    if (strcmp(argv[1], "merge") == 0 && argc >= 3 && (strcmp(argv[2], "on") == 0 || strcmp(argv[2], "off") == 0)) {
+        lvgl_port_m5gfx_set_merge_areas(strcmp(argv[2], "on") == 0);
+        lvgl_port_m5gfx_reset_stats();
+        printf("OK\n");
+        return 0;
+    }
+    printf("usage: lvperf [reset|sync|async|merge on|off]\n");
+    return 1;
+}
+
 static int cmd_waitms(int argc, char **argv) {
     if (argc < 2 || !argv[1] || argv[1][0] == '\0') {
         printf("ERR: usage: waitms <ms>\n");
@@ -108,12 +153,25 @@ static int cmd_setmins(int argc, char **argv) {
     return 0;
 }
 
-static int cmd_screenshot(int, char **) {
+static int cmd_screenshot(int argc, char **argv) {
     if (!ensure_ctrl_queue()) return 1;
 
     CtrlEvent ev{};
     ev.type = CtrlType::ScreenshotPngToUsbSerialJtag;
     ev.reply_task = xTaskGetCurrentTaskHandle();
+    if (argc >= 2 && strcmp(argv[1], "png") != 0) {
+        // qoi / delta read the LVGL framebuffer copy instead of the panel (see screenshot_png.h).
+        ev.type = CtrlType::ScreenshotFastToUsbSerialJtag;
+        if (strcmp(argv[1], "qoi") == 0) {
+            ev.arg = (int32_t)ScreenshotFormat::Qoi;
+        } else if (strcmp(argv[1], "delta") == 0) {
+            ev.arg = (int32_t)ScreenshotFormat::Delta;
+            if (argc >= 3 && strcmp(argv[2], "key") == 0) ev.arg |= 0x100;
+        } else {
+            printf("usage: screenshot [png|qoi|delta [key]]\n");
+            return 1;
+        }
+    }
 
     if (!ctrl_send(s_ctrl_q, ev, pdMS_TO_TICKS(250))) {
         printf("ERR: screenshot busy (queue full)\n");
@@ -471,6 +529,12 @@ static void console_register_commands(void) {
     cmd.func = &cmd_heap;
     ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
 
+    cmd = {};
+    cmd.command = "lvperf";
+    cmd.help = "Display fps/render/flush counters: lvperf [reset|sync|async|merge on|off]";
+    cmd.func = &cmd_lvperf;
+    ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+
     cmd = {};
     cmd.command = "waitms";
     cmd.help = "Sleep (console task) for N milliseconds";
@@ -550,7 +614,7 @@ static void console_register_commands(void) {
 
     cmd = {};
     cmd.command = "screenshot";
-    cmd.help = "Capture current display as framed PNG over USB-Serial/JTAG";
+    cmd.help = "Capture the display over USB-Serial/JTAG: screenshot [png|qoi|delta [key]] (default png)";
     cmd.func = &cmd_screenshot;
     ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
 
@@ -592,7 +656,7 @@ void console_start(QueueHandle_t ctrl_queue) {
     }
 
     ESP_LOGI(TAG,
-             "esp_console started over USB-Serial/JTAG (commands: help, heap, menu, basics, pomodoro, console, sysmon, files, "
+             "esp_console started over USB-Serial/JTAG (commands: help, heap, lvperf, menu, basics, pomodoro, console, sysmon, files, "
              "palette, setmins, screenshot, saveshot, keys, keycodes, sdstat, sdmount, sdumount, sdls, sdcat)");
 #endif
 }
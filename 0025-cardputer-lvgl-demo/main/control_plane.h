@@ -19,6 +19,8 @@ enum class CtrlType : uint8_t {
     OpenFileBrowser = 9,
     InjectKeys = 10,
     ScreenshotPngSaveToSd = 11,
+    // arg: ScreenshotFormat | (keyframe ? 0x100 : 0); reply_task gets the length (0 on failure).
+    ScreenshotFastToUsbSerialJtag = 12,
 };
 
 struct CtrlEvent {
@@ -9,6 +9,7 @@
 #include "esp_system.h"
 
 #include "lvgl_font_util.h"
+#include "lvgl_port_m5gfx.h"
 
 extern "C" {
 extern volatile uint32_t g_ui_loop_counter;
@@ -37,6 +38,7 @@ struct SystemMonitorState {
     lv_obj_t *root = nullptr;
     lv_obj_t *header = nullptr;
     lv_obj_t *footer = nullptr;
+    lv_obj_t *perf = nullptr;
 
     lv_obj_t *chart_heap = nullptr;
     lv_obj_t *chart_dma = nullptr;
@@ -51,6 +53,7 @@ struct SystemMonitorState {
     uint32_t last_tick_ms = 0;
     uint32_t last_loop_counter = 0;
     Ema32 loop_hz_ema{};
+    LvglM5gfxStats last_stats{};
 };
 
 static SystemMonitorState *s_sysmon = nullptr;
@@ -103,6 +106,26 @@ static void sample_cb(lv_timer_t *t) {
              st->loop_hz_ema.value, lvgl_us_avg);
     lv_label_set_text(st->header, buf);
 
+    // Display frames in this sample window: fps, then per-frame refresh (render), wait and flush time.
+    LvglM5gfxStats ds{};
+    lvgl_port_m5gfx_get_stats(&ds);
+    if (ds.since_us != st->last_stats.since_us) {
+        // Counters were reset (lvperf reset): count this window from zero.
+        st->last_stats = LvglM5gfxStats{};
+        st->last_stats.since_us = ds.since_us;
+    }
+    if (st->perf) {
+        const uint32_t frames = ds.frames - st->last_stats.frames;
+        const uint32_t div = frames ? frames : 1;
+        const uint32_t refr_us = (uint32_t)((ds.refr_us - st->last_stats.refr_us) / div);
+        const uint32_t wait_us = (uint32_t)((ds.wait_us - st->last_stats.wait_us) / div);
+        const uint32_t flush_us = (uint32_t)((ds.flush_us - st->last_stats.flush_us) / div);
+        snprintf(buf, sizeof(buf), "%s fps=%" PRIu32 " r=%" PRIu32 " w=%" PRIu32 " f=%" PRIu32 "us",
+                 ds.async_flush ? "dma" : "sync", (frames * 1000U) / dt, refr_us, wait_us, flush_us);
+        lv_label_set_text(st->perf, buf);
+    }
+    st->last_stats = ds;
+
     if (st->chart_heap && st->s_heap) {
         lv_chart_set_next_value(st->chart_heap, st->s_heap, (lv_coord_t)std::min<uint32_t>(heap_kb, 512));
     }
@@ -126,6 +149,7 @@ static void root_delete_cb(lv_event_t *e) {
     st->root = nullptr;
     st->header = nullptr;
     st->footer = nullptr;
+    st->perf = nullptr;
     st->chart_heap = nullptr;
     st->chart_dma = nullptr;
     st->chart_fps = nullptr;
@@ -162,7 +186,7 @@ lv_obj_t *demo_system_monitor_create(DemoManager *mgr) {
 
     lv_obj_t *cont = lv_obj_create(st->root);
     lv_obj_remove_style_all(cont);
-    lv_obj_set_size(cont, 240 - 12, 72);
+    lv_obj_set_size(cont, 240 - 12, 66);
     lv_obj_align(cont, LV_ALIGN_TOP_MID, 0, 34);
     lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(cont, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
@@ -180,6 +204,13 @@ lv_obj_t *demo_system_monitor_create(DemoManager *mgr) {
     lv_chart_set_range(st->chart_fps, LV_CHART_AXIS_PRIMARY_Y, 0, 60);
     st->s_fps = lv_chart_add_series(st->chart_fps, lv_palette_main(LV_PALETTE_CYAN), LV_CHART_AXIS_PRIMARY_Y);
 
+    st->perf = lv_label_create(st->root);
+    lv_obj_set_style_text_font(st->perf, lvgl_font_small(), 0);
+    lv_obj_set_width(st->perf, 240 - 12);
+    lv_label_set_long_mode(st->perf, LV_LABEL_LONG_CLIP);
+    lv_label_set_text(st->perf, "fps=? r=? w=? f=?us");
+    lv_obj_align(st->perf, LV_ALIGN_TOP_LEFT, 6, 102);
+
     st->footer = lv_obj_create(st->root);
     lv_obj_remove_style_all(st->footer);
     lv_obj_set_size(st->footer, 240, 16);
@@ -197,6 +228,7 @@ lv_obj_t *demo_system_monitor_create(DemoManager *mgr) {
 
     st->last_tick_ms = lv_tick_get();
     st->last_loop_counter = g_ui_loop_counter;
+    lvgl_port_m5gfx_get_stats(&st->last_stats);
     st->timer = lv_timer_create(sample_cb, 250, st);
     sample_cb(st->timer);
 
@@ -1,6 +1,5 @@
 #include "input_keyboard.h"
 
-#include <cstring>
 #include <string_view>
 
 #include "cardputer_kb/bindings_m5cardputer_captured.h"
@@ -22,13 +21,6 @@ constexpr KeyValue kKeyMap[4][14] = {
     {{"ctrl", "ctrl"}, {"opt", "opt"}, {"alt", "alt"}, {"z", "Z"}, {"x", "X"}, {"c", "C"}, {"v", "V"}, {"b", "B"}, {"n", "N"}, {"m", "M"}, {",", "<"}, {".", ">"}, {"/", "?"}, {"space", "space"}},
 };
 
-static bool contains_keynum(const std::vector<uint8_t> &v, uint8_t keynum) {
-    for (auto x : v) {
-        if (x == keynum) return true;
-    }
-    return false;
-}
-
 static const KeyValue *key_value_for_keynum(uint8_t keynum) {
     int x = -1;
     int y = -1;
@@ -39,20 +31,6 @@ static const KeyValue *key_value_for_keynum(uint8_t keynum) {
     return &kKeyMap[y][x];
 }
 
-static bool is_modifier_keynum(uint8_t keynum) {
-    const KeyValue *kv = key_value_for_keynum(keynum);
-    if (!kv) return false;
-    return strcmp(kv->first, "shift") == 0 || strcmp(kv->first, "fn") == 0 || strcmp(kv->first, "ctrl") == 0 ||
-           strcmp(kv->first, "alt") == 0 || strcmp(kv->first, "opt") == 0;
-}
-
-static bool binding_contains_keynum(const cardputer_kb::Binding &b, uint8_t keynum) {
-    for (uint8_t i = 0; i < b.n; i++) {
-        if (b.keynums[i] == keynum) return true;
-    }
-    return false;
-}
-
 static std::string_view key_for_action(cardputer_kb::Action a) {
     switch (a) {
     case cardputer_kb::Action::NavUp: return "up";
@@ -85,23 +63,22 @@ std::vector<KeyEvent> CardputerKeyboard::poll() {
         return events;
     }
 
-    cardputer_kb::ScanSnapshot snap = scanner_.scan();
-    const std::vector<uint8_t> &down_keynums = snap.pressed_keynums;
+    const cardputer_kb::KeyEdges keys = edges_.update(scanner_.scan_mask());
 
-    static constexpr uint8_t kKeynumFn = 29;
-    static constexpr uint8_t kKeynumShift = 30;
-    static constexpr uint8_t kKeynumCtrl = 43;
-    static constexpr uint8_t kKeynumOpt = 44;
-    static constexpr uint8_t kKeynumAlt = 45;
+    static constexpr cardputer_kb::KeyMask kFn = cardputer_kb::key_bit(29);
+    static constexpr cardputer_kb::KeyMask kShift = cardputer_kb::key_bit(30);
+    static constexpr cardputer_kb::KeyMask kCtrl = cardputer_kb::key_bit(43);
+    static constexpr cardputer_kb::KeyMask kOpt = cardputer_kb::key_bit(44);
+    static constexpr cardputer_kb::KeyMask kAlt = cardputer_kb::key_bit(45);
+    static constexpr cardputer_kb::KeyMask kModifiers = kFn | kShift | kCtrl | kOpt | kAlt;
 
-    const bool shift = contains_keynum(down_keynums, kKeynumShift);
-    const bool ctrl = contains_keynum(down_keynums, kKeynumCtrl);
-    const bool alt = contains_keynum(down_keynums, kKeynumAlt) || contains_keynum(down_keynums, kKeynumOpt);
-    const bool fn = contains_keynum(down_keynums, kKeynumFn);
+    const bool shift = (keys.down & kShift) != 0;
+    const bool ctrl = (keys.down & kCtrl) != 0;
+    const bool alt = (keys.down & (kAlt | kOpt)) != 0;
+    const bool fn = (keys.down & kFn) != 0;
 
-    const cardputer_kb::Binding *active = cardputer_kb::decode_best(
-        down_keynums, cardputer_kb::kCapturedBindingsM5Cardputer,
-        sizeof(cardputer_kb::kCapturedBindingsM5Cardputer) / sizeof(cardputer_kb::kCapturedBindingsM5Cardputer[0]));
+    const cardputer_kb::MaskBinding *active =
+        cardputer_kb::decode_best(keys.down, cardputer_kb::kCapturedBindingsM5CardputerMasks);
 
     if (active) {
         if (!prev_action_valid_ || prev_action_ != active->action) {
@@ -119,18 +96,13 @@ std::vector<KeyEvent> CardputerKeyboard::poll() {
         prev_action_valid_ = false;
     }
 
-    // Emit "edge" events for raw keys (excluding any key that is part of the active binding chord).
-    for (auto keynum : down_keynums) {
-        if (contains_keynum(prev_pressed_keynums_, keynum)) {
-            continue;
-        }
-        if (is_modifier_keynum(keynum)) {
-            continue;
-        }
-        if (active && binding_contains_keynum(*active, keynum)) {
-            continue;
-        }
-
+    // Emit "edge" events for raw keys (excluding modifiers and any key that is part of the active binding chord).
+    cardputer_kb::KeyMask fresh = keys.pressed & ~kModifiers;
+    if (active) {
+        fresh &= ~active->mask;
+    }
+    for (cardputer_kb::KeyMask m = fresh; m; m &= m - 1) {
+        const uint8_t keynum = cardputer_kb::mask_first(m);
         const KeyValue *kv = key_value_for_keynum(keynum);
         if (!kv) {
             continue;
@@ -150,6 +122,5 @@ std::vector<KeyEvent> CardputerKeyboard::poll() {
         events.push_back(std::move(ev));
     }
 
-    prev_pressed_keynums_ = down_keynums;
     return events;
 }
@@ -25,7 +25,7 @@ private:
     bool inited_ = false;
 
     cardputer_kb::UnifiedScanner scanner_{};
-    std::vector<uint8_t> prev_pressed_keynums_{};
+    cardputer_kb::KeyEdgeTracker edges_{};
     bool prev_action_valid_ = false;
     cardputer_kb::Action prev_action_{};
 };
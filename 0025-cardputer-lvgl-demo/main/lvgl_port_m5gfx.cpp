@@ -6,6 +6,7 @@
 #include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
 
 static const char *TAG = "lvgl_port_m5gfx";
 
@@ -13,11 +14,71 @@ namespace {
 
 static esp_timer_handle_t s_tick_timer = nullptr;
 
+struct PortState {
+    m5gfx::M5GFX *gfx = nullptr;
+    lv_disp_drv_t *drv = nullptr;
+    lv_disp_t *disp = nullptr;
+
+    volatile bool async_flush = true;
+    volatile bool merge_areas = true;
+    int merge_slack_px = 1024;
+
+    // An async flush keeps the bus claimed (startWrite) until its DMA is seen complete;
+    // endWrite() would block on the transfer.
+    bool in_flight = false;
+    int64_t flush_start_us = 0;
+
+    LvglM5gfxStats stats{};
+
+    // Full-screen copy of everything flushed (lvgl_port_m5gfx_shadow_enable), for screenshots.
+    uint16_t *shadow = nullptr;
+    int hor_res = 0;
+    int ver_res = 0;
+};
+
+static PortState s_port;
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
 static void tick_cb(void *arg) {
     const int tick_ms = (int)(intptr_t)arg;
     lv_tick_inc((uint32_t)tick_ms);
 }
 
+static void flush_done(lv_disp_drv_t *disp) {
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - s_port.flush_start_us);
+    portENTER_CRITICAL(&s_stats_mux);
+    s_port.stats.flush_us += us;
+    portEXIT_CRITICAL(&s_stats_mux);
+    lv_disp_flush_ready(disp);
+}
+
+// Transfer-complete path for async flushes. LovyanGFX drives the SPI DMA itself and has no
+// completion callback, so completion is observed by polling dmaBusy().
+static bool async_flush_complete(bool block) {
+    if (!s_port.in_flight) return true;
+    m5gfx::M5GFX &gfx = *s_port.gfx;
+    if (block) {
+        gfx.waitDMA();
+    } else if (gfx.dmaBusy()) {
+        return false;
+    }
+    gfx.endWrite();
+    s_port.in_flight = false;
+    flush_done(s_port.drv);
+    return true;
+}
+
+// LVGL calls this while it needs a buffer that is still being flushed.
+static void wait_cb(lv_disp_drv_t *disp) {
+    (void)disp;
+    const int64_t t0 = esp_timer_get_time();
+    (void)async_flush_complete(true);
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    portENTER_CRITICAL(&s_stats_mux);
+    s_port.stats.wait_us += us;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
 static void flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
     auto *gfx_ptr = static_cast<m5gfx::M5GFX *>(disp->user_data);
     m5gfx::M5GFX &gfx = *gfx_ptr;
@@ -26,7 +87,30 @@ static void flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *col
     const int h = (area->y2 - area->y1 + 1);
     const uint32_t pixels = (uint32_t)w * (uint32_t)h;
 
+    portENTER_CRITICAL(&s_stats_mux);
+    s_port.stats.areas++;
+    s_port.stats.pixels += pixels;
+    portEXIT_CRITICAL(&s_stats_mux);
+
+    if (s_port.shadow) {
+        static_assert(sizeof(lv_color_t) == sizeof(uint16_t), "shadow copy assumes 16-bit color");
+        const lv_color_t *src_row = color_p;
+        for (int y = area->y1; y <= area->y2; y++) {
+            memcpy(s_port.shadow + (size_t)y * (size_t)s_port.hor_res + area->x1, src_row, (size_t)w * sizeof(uint16_t));
+            src_row += w;
+        }
+    }
+
+    // LVGL only calls flush_cb once the previous flush is ready, so nothing is in flight here.
+    s_port.flush_start_us = esp_timer_get_time();
     gfx.startWrite();
+
+    if (s_port.async_flush) {
+        gfx.pushImageDMA(area->x1, area->y1, w, h, reinterpret_cast<const lgfx::rgb565_t *>(color_p));
+        s_port.in_flight = true;
+        return;
+    }
+
     gfx.setAddrWindow(area->x1, area->y1, w, h);
 
     // Conservative chunking to avoid any problematic fast-copy paths.
@@ -43,7 +127,62 @@ static void flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *col
 
     gfx.endWrite();
 
-    lv_disp_flush_ready(disp);
+    flush_done(disp);
+}
+
+// Folds invalidated areas together while redrawing the union is cheaper than paying the per-area
+// overhead twice. LVGL's own join (run afterwards) only merges when the union is strictly smaller
+// than the two areas, so many small nearby widgets otherwise become many small flushes.
+static uint32_t merge_inv_areas(lv_disp_t *disp, int32_t slack_px) {
+    uint32_t merged = 0;
+    bool again = true;
+    while (again) {
+        again = false;
+        for (uint32_t i = 0; i < disp->inv_p; i++) {
+            for (uint32_t j = i + 1; j < disp->inv_p;) {
+                lv_area_t u;
+                _lv_area_join(&u, &disp->inv_areas[i], &disp->inv_areas[j]);
+                const int64_t sum = (int64_t)lv_area_get_size(&disp->inv_areas[i]) +
+                                    (int64_t)lv_area_get_size(&disp->inv_areas[j]);
+                if ((int64_t)lv_area_get_size(&u) > sum + slack_px) {
+                    j++;
+                    continue;
+                }
+                disp->inv_areas[i] = u;
+                disp->inv_p--;
+                disp->inv_areas[j] = disp->inv_areas[disp->inv_p];
+                disp->inv_area_joined[j] = disp->inv_area_joined[disp->inv_p];
+                merged++;
+                again = true;
+            }
+        }
+    }
+    return merged;
+}
+
+// Replaces the display's refresh timer callback: merges areas, then runs LVGL's refresh and times it.
+static void refr_timer_cb(lv_timer_t *t) {
+    lv_disp_t *disp = s_port.disp;
+
+    // Layout changes invalidate areas, so settle them first (the refresh repeats this as a no-op).
+    lv_obj_update_layout(disp->act_scr);
+    if (disp->prev_scr) lv_obj_update_layout(disp->prev_scr);
+    lv_obj_update_layout(disp->top_layer);
+    lv_obj_update_layout(disp->sys_layer);
+
+    const uint32_t merged = s_port.merge_areas ? merge_inv_areas(disp, s_port.merge_slack_px) : 0;
+    const uint32_t areas_before = s_port.stats.areas;
+    const int64_t t0 = esp_timer_get_time();
+    _lv_disp_refr_timer(t);
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    portENTER_CRITICAL(&s_stats_mux);
+    s_port.stats.merged += merged;
+    if (s_port.stats.areas != areas_before) {
+        s_port.stats.frames++;
+        s_port.stats.refr_us += us;
+    }
+    portEXIT_CRITICAL(&s_stats_mux);
 }
 
 static lv_color_t *alloc_draw_buf(size_t bytes) {
@@ -93,9 +232,27 @@ bool lvgl_port_m5gfx_init(m5gfx::M5GFX &display, const LvglM5gfxConfig &cfg) {
     disp_drv.hor_res = w;
     disp_drv.ver_res = h;
     disp_drv.flush_cb = flush_cb;
+    disp_drv.wait_cb = wait_cb;
     disp_drv.draw_buf = &draw_buf;
     disp_drv.user_data = &display;
-    lv_disp_drv_register(&disp_drv);
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    if (!disp) {
+        ESP_LOGE(TAG, "lv_disp_drv_register failed");
+        return false;
+    }
+
+    s_port.gfx = &display;
+    s_port.drv = &disp_drv;
+    s_port.disp = disp;
+    s_port.hor_res = w;
+    s_port.ver_res = h;
+    s_port.async_flush = cfg.async_flush;
+    s_port.merge_areas = cfg.merge_areas;
+    s_port.merge_slack_px = (cfg.merge_slack_px > 0) ? cfg.merge_slack_px : 0;
+    lvgl_port_m5gfx_reset_stats();
+    if (disp->refr_timer) {
+        lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+    }
 
     const int tick_ms = (cfg.tick_ms > 0) ? cfg.tick_ms : 2;
     const esp_timer_create_args_t args = {
@@ -116,3 +273,61 @@ bool lvgl_port_m5gfx_init(m5gfx::M5GFX &display, const LvglM5gfxConfig &cfg) {
     return true;
 }
 
+
+void lvgl_port_m5gfx_poll(void) {
+    (void)async_flush_complete(false);
+}
+
+void lvgl_port_m5gfx_flush_wait(void) {
+    (void)async_flush_complete(true);
+}
+
+void lvgl_port_m5gfx_get_stats(LvglM5gfxStats *out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_stats_mux);
+    *out = s_port.stats;
+    portEXIT_CRITICAL(&s_stats_mux);
+    out->async_flush = s_port.async_flush;
+    out->merge_areas = s_port.merge_areas;
+}
+
+void lvgl_port_m5gfx_reset_stats(void) {
+    const int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_stats_mux);
+    s_port.stats = LvglM5gfxStats{};
+    s_port.stats.since_us = now;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+void lvgl_port_m5gfx_set_async_flush(bool on) {
+    s_port.async_flush = on;
+}
+
+void lvgl_port_m5gfx_set_merge_areas(bool on) {
+    s_port.merge_areas = on;
+}
+
+bool lvgl_port_m5gfx_shadow_enable(void) {
+    if (s_port.shadow) return true;
+    if (!s_port.disp || s_port.hor_res <= 0 || s_port.ver_res <= 0) return false;
+    const size_t bytes = (size_t)s_port.hor_res * (size_t)s_port.ver_res * sizeof(uint16_t);
+    auto *shadow = static_cast<uint16_t *>(heap_caps_malloc(bytes, MALLOC_CAP_8BIT));
+    if (!shadow) {
+        ESP_LOGE(TAG, "shadow framebuffer alloc failed: bytes=%u", (unsigned)bytes);
+        return false;
+    }
+    memset(shadow, 0, bytes);
+    s_port.shadow = shadow;
+
+    // Repaint everything once so the copy starts complete.
+    lv_obj_invalidate(lv_disp_get_scr_act(s_port.disp));
+    lv_refr_now(s_port.disp);
+    lvgl_port_m5gfx_flush_wait();
+    return true;
+}
+
+const uint16_t *lvgl_port_m5gfx_shadow(int *w, int *h) {
+    if (w) *w = s_port.hor_res;
+    if (h) *h = s_port.ver_res;
+    return s_port.shadow;
+}
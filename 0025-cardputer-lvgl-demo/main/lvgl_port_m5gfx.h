@@ -14,9 +14,49 @@ struct LvglM5gfxConfig {
     bool double_buffer = true;
     bool swap_bytes = false;
     int tick_ms = 2;
+    // Start a DMA push in flush_cb and return; LVGL renders into the other buffer meanwhile.
+    bool async_flush = true;
+    // Merge invalidated areas when redrawing their bounding box costs at most `merge_slack_px`
+    // more pixels than drawing them separately (each area pays an object-tree walk + window setup).
+    bool merge_areas = true;
+    int merge_slack_px = 1024;
+};
+
+// Cumulative display counters since init / the last reset. Divide by `frames` for per-frame values.
+struct LvglM5gfxStats {
+    uint32_t frames = 0;   // refreshes that flushed at least one area
+    uint32_t areas = 0;    // flush_cb calls
+    uint32_t merged = 0;   // invalidated areas folded into another one before rendering
+    uint64_t pixels = 0;   // pixels flushed
+    uint64_t refr_us = 0;  // time inside LVGL's refresh (render + any wait for the panel)
+    uint64_t wait_us = 0;  // part of refr_us spent blocked on a transfer still in flight
+    uint64_t flush_us = 0; // flush_cb start -> transfer seen complete (async: as polled, an upper bound)
+    int64_t since_us = 0;  // esp_timer time of the reset
+    bool async_flush = false;
+    bool merge_areas = false;
 };
 
 // Initializes LVGL and registers a display driver that flushes to M5GFX.
 // Returns true on success; false if buffers cannot be allocated.
 bool lvgl_port_m5gfx_init(m5gfx::M5GFX &display, const LvglM5gfxConfig &cfg);
 
+// Completes an async flush whose transfer has finished (releases the bus, tells LVGL).
+// Call from the UI loop after lv_timer_handler(). UI thread only.
+void lvgl_port_m5gfx_poll(void);
+
+// Blocks until no flush is in flight, e.g. before reading the panel back. UI thread only.
+void lvgl_port_m5gfx_flush_wait(void);
+
+// Safe from any task; mode changes apply from the next flush / refresh.
+void lvgl_port_m5gfx_get_stats(LvglM5gfxStats *out);
+void lvgl_port_m5gfx_reset_stats(void);
+void lvgl_port_m5gfx_set_async_flush(bool on);
+void lvgl_port_m5gfx_set_merge_areas(bool on);
+
+// Starts keeping a full-screen RGB565 copy of every flushed area (allocates w * h * 2 bytes once and
+// repaints the screen to fill it), so screenshots can skip reading the panel back. UI thread only.
+bool lvgl_port_m5gfx_shadow_enable(void);
+
+// The copy (row-major, lv_color_t RGB565), or nullptr if not enabled. Read it on the UI thread, or
+// copy it there: flushes keep updating it.
+const uint16_t *lvgl_port_m5gfx_shadow(int *w, int *h);
@@ -0,0 +1,194 @@
+#include "screenshot_codec.h"
+
+#include <string.h>
+
+namespace {
+
+struct Rgb {
+    uint8_t r, g, b;
+};
+
+static inline Rgb rgb565_to_rgb(uint16_t v) {
+    const uint8_t r5 = (uint8_t)(v >> 11);
+    const uint8_t g6 = (uint8_t)((v >> 5) & 0x3F);
+    const uint8_t b5 = (uint8_t)(v & 0x1F);
+    return Rgb{(uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2))};
+}
+
+// Bounded output: counts every byte, stores only those that fit (nothing when measuring).
+struct Writer {
+    uint8_t *out;
+    size_t cap;
+    size_t n = 0;
+
+    inline void u8(uint32_t v) {
+        if (n < cap) out[n] = (uint8_t)v;
+        n++;
+    }
+    inline void u16_le(uint32_t v) {
+        u8(v);
+        u8(v >> 8);
+    }
+    inline void u32_le(uint32_t v) {
+        u16_le(v);
+        u16_le(v >> 16);
+    }
+    inline void u32_be(uint32_t v) {
+        u8(v >> 24);
+        u8(v >> 16);
+        u8(v >> 8);
+        u8(v);
+    }
+    inline void varint(uint32_t v) {
+        while (v >= 0x80) {
+            u8(v | 0x80);
+            v >>= 7;
+        }
+        u8(v);
+    }
+    inline void bytes(const char *p, size_t len) {
+        for (size_t i = 0; i < len; i++) u8((uint8_t)p[i]);
+    }
+};
+
+static constexpr uint8_t kQoiOpIndex = 0x00;
+static constexpr uint8_t kQoiOpDiff = 0x40;
+static constexpr uint8_t kQoiOpLuma = 0x80;
+static constexpr uint8_t kQoiOpRun = 0xC0;
+static constexpr uint8_t kQoiOpRgb = 0xFE;
+
+// Literal runs end at this many unchanged pixels; shorter gaps are cheaper to send as literals than
+// as a new (skip, count) pair.
+static constexpr int kDeltaMinSkip = 2;
+
+} // namespace
+
+size_t screenshot_qoi_encode_rgb565(const uint16_t *px, int w, int h, uint8_t *out, size_t cap) {
+    if (!px || w <= 0 || h <= 0) return 0;
+    const size_t n = (size_t)w * (size_t)h;
+    Writer wr{out, out ? cap : 0};
+
+    wr.bytes("qoif", 4);
+    wr.u32_be((uint32_t)w);
+    wr.u32_be((uint32_t)h);
+    wr.u8(3); // channels
+    wr.u8(0); // sRGB with linear alpha
+
+    // The index holds RGB888 values hashed as in the spec (alpha is always 255 here).
+    Rgb index[64];
+    bool index_set[64];
+    memset(index, 0, sizeof(index));
+    memset(index_set, 0, sizeof(index_set));
+
+    // Runs compare RGB565 directly; the spec's initial pixel (0, 0, 0, 255) is RGB565 0x0000.
+    uint16_t prev565 = 0;
+    Rgb prev{0, 0, 0};
+    int run = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint16_t v = px[i];
+        if (v == prev565) {
+            run++;
+            if (run == 62) {
+                wr.u8(kQoiOpRun | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            wr.u8(kQoiOpRun | (run - 1));
+            run = 0;
+        }
+
+        const Rgb c = rgb565_to_rgb(v);
+        const int hash = (c.r * 3 + c.g * 5 + c.b * 7 + 255 * 11) % 64;
+        // An unset slot is (0, 0, 0, 0), which never equals an opaque pixel.
+        if (index_set[hash] && index[hash].r == c.r && index[hash].g == c.g && index[hash].b == c.b) {
+            wr.u8(kQoiOpIndex | hash);
+        } else {
+            index[hash] = c;
+            index_set[hash] = true;
+            const int8_t vr = (int8_t)(c.r - prev.r);
+            const int8_t vg = (int8_t)(c.g - prev.g);
+            const int8_t vb = (int8_t)(c.b - prev.b);
+            const int8_t vg_r = (int8_t)(vr - vg);
+            const int8_t vg_b = (int8_t)(vb - vg);
+            if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                wr.u8(kQoiOpDiff | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+            } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                wr.u8(kQoiOpLuma | (vg + 32));
+                wr.u8(((vg_r + 8) << 4) | (vg_b + 8));
+            } else {
+                wr.u8(kQoiOpRgb);
+                wr.u8(c.r);
+                wr.u8(c.g);
+                wr.u8(c.b);
+            }
+        }
+        prev565 = v;
+        prev = c;
+    }
+    if (run > 0) {
+        wr.u8(kQoiOpRun | (run - 1));
+    }
+
+    static const char kEnd[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    wr.bytes(kEnd, sizeof(kEnd));
+    return wr.n;
+}
+
+size_t screenshot_delta_encode_rgb565(const uint16_t *cur, const uint16_t *base, int w, int h, uint32_t base_id,
+                                      uint32_t frame_id, uint8_t *out, size_t cap) {
+    if (!cur || w <= 0 || h <= 0 || w > 0xFFFF || h > 0xFFFF) return 0;
+    const size_t n = (size_t)w * (size_t)h;
+    if (!base) base_id = 0;
+    Writer wr{out, out ? cap : 0};
+
+    wr.bytes("SDLT", 4);
+    wr.u8(1); // version
+    wr.u8(0); // RGB565 LE
+    wr.u16_le((uint32_t)w);
+    wr.u16_le((uint32_t)h);
+    wr.u16_le(0);
+    wr.u32_le(base_id);
+    wr.u32_le(frame_id);
+
+    auto same = [&](size_t i) -> bool { return base ? cur[i] == base[i] : cur[i] == 0; };
+
+    size_t i = 0;
+    while (i < n) {
+        // Unchanged pixels: compare two at a time where both frames are 4-byte aligned.
+        const size_t skip_from = i;
+        if (base && ((((uintptr_t)(cur + i)) | ((uintptr_t)(base + i))) & 3) == 0) {
+            while (i + 2 <= n) {
+                uint32_t a, b;
+                memcpy(&a, cur + i, 4);
+                memcpy(&b, base + i, 4);
+                if (a != b) break;
+                i += 2;
+            }
+        }
+        while (i < n && same(i)) i++;
+        if (i >= n) break; // trailing unchanged pixels are implied
+
+        // Literal run: until kDeltaMinSkip unchanged pixels in a row (or the end).
+        const size_t lit_from = i;
+        size_t lit_end = i + 1;
+        while (lit_end < n) {
+            if (!same(lit_end)) {
+                lit_end++;
+                continue;
+            }
+            size_t k = lit_end;
+            while (k < n && k - lit_end < (size_t)kDeltaMinSkip && same(k)) k++;
+            if (k - lit_end >= (size_t)kDeltaMinSkip || k >= n) break;
+            lit_end = k;
+        }
+
+        wr.varint((uint32_t)(lit_from - skip_from));
+        wr.varint((uint32_t)(lit_end - lit_from));
+        for (size_t k = lit_from; k < lit_end; k++) wr.u16_le(cur[k]);
+        i = lit_end;
+    }
+
+    return wr.n;
+}
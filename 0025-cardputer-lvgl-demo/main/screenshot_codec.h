@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+ * Screenshot encoders for RGB565 frames (the LVGL framebuffer copy kept by lvgl_port_m5gfx).
+ *
+ * No ESP-IDF / LVGL dependency so they build on the host (tools/screenshot_host). Decoders live in
+ * tools/screenshot_decode.py.
+ *
+ * QOI: the standard "Quite OK Image" format (https://qoiformat.org), 3 channels, sRGB. RGB565 is
+ * widened to RGB888 by bit replication (r5 -> r5 << 3 | r5 >> 2), the same as screenshot_png.
+ *
+ * Delta ("SDLT"): changed pixels against the previous screenshot, RGB565 kept exact.
+ *   header (20 bytes, little-endian): "SDLT" | u8 version (1) | u8 pixel format (0 = RGB565 LE) |
+ *     u16 width | u16 height | u16 reserved (0) | u32 base_id | u32 frame_id
+ *   body: repeated (varint skip, varint count, count * u16 pixels) until the frame is covered;
+ *     skip = pixels copied from the base frame, then `count` literal pixels. Unsigned LEB128 varints.
+ *     Trailing unchanged pixels are omitted. base_id 0 is a keyframe against an all-zero frame.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr uint32_t kScreenshotDeltaHeaderBytes = 20;
+
+// Both encoders return the encoded size in bytes (0 on bad input) and write into `out` only up to
+// `cap` bytes. Call once with out = nullptr to measure, allocate exactly that much, then encode:
+// no worst-case buffer (a full QOI worst case is 4 bytes per pixel) is ever needed.
+
+// QOI image of `px` (w * h RGB565 pixels, row-major).
+size_t screenshot_qoi_encode_rgb565(const uint16_t *px, int w, int h, uint8_t *out, size_t cap);
+
+// SDLT delta of `cur` against `base`. `base` may be null (keyframe; base_id is written as 0).
+size_t screenshot_delta_encode_rgb565(const uint16_t *cur, const uint16_t *base, int w, int h, uint32_t base_id,
+                                      uint32_t frame_id, uint8_t *out, size_t cap);
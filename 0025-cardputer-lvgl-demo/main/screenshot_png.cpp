@@ -9,6 +9,8 @@
 
 #include "driver/usb_serial_jtag.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -16,9 +18,15 @@
 
 #include "lgfx/utility/lgfx_miniz.h"
 
+#include "lvgl_port_m5gfx.h"
+#include "screenshot_codec.h"
 #include "sdcard_fatfs.h"
 
+static const char *TAG = "screenshot";
+
 static constexpr size_t kTxChunkBytes = 128;
+// The fast path sends pre-encoded bytes; let the driver take as much as its TX ring holds per call.
+static constexpr size_t kFastTxChunkBytes = 4096;
 static constexpr size_t kIdatChunkBufBytes = 2048;
 
 namespace {
@@ -195,10 +203,11 @@ static bool ensure_usb_serial_jtag_driver_ready() {
     return err == ESP_OK;
 }
 
-static bool serial_write_all(const void *data, size_t len, TickType_t ticks_per_try, int max_zero_writes) {
+static bool serial_write_all(const void *data, size_t len, TickType_t ticks_per_try, int max_zero_writes,
+                             size_t chunk_bytes = kTxChunkBytes) {
     const uint8_t *p = (const uint8_t *)data;
     while (len > 0) {
-        size_t chunk = (len > kTxChunkBytes) ? kTxChunkBytes : len;
+        size_t chunk = (len > chunk_bytes) ? chunk_bytes : len;
         int n = usb_serial_jtag_write_bytes(p, chunk, ticks_per_try);
         if (n < 0) {
             return false;
@@ -421,3 +430,116 @@ bool screenshot_png_save_to_sd_ex(m5gfx::M5GFX &display, char *out_path, size_t
     if (out_len) *out_len = len_value;
     return ok_value && value == 1U;
 }
+
+namespace {
+
+struct FastShotState {
+    uint16_t *prev = nullptr; // frame of the last delta screenshot (the next delta's base)
+    uint32_t prev_id = 0;     // 0: no valid base, next delta is a keyframe
+    uint32_t next_id = 1;
+    volatile bool busy = false;
+
+    // The frame being sent; owned by fast_send_task while busy.
+    uint8_t *data = nullptr;
+    size_t len = 0;
+    ScreenshotFormat fmt = ScreenshotFormat::Qoi;
+    TaskHandle_t reply_task = nullptr;
+};
+
+static FastShotState s_fast;
+
+static void fast_send_task(void *) {
+    const char *tag = (s_fast.fmt == ScreenshotFormat::Delta) ? "DELTA" : "QOI";
+    const size_t len = s_fast.len;
+
+    bool ok = ensure_usb_serial_jtag_driver_ready();
+    char header[32];
+    const int header_n = snprintf(header, sizeof(header), "%s_BEGIN %u\n", tag, (unsigned)len);
+    if (ok) ok = header_n > 0 && serial_write_all(header, (size_t)header_n, pdMS_TO_TICKS(25), 50);
+    if (ok) ok = serial_write_all(s_fast.data, len, pdMS_TO_TICKS(25), 200, kFastTxChunkBytes);
+    char footer[32];
+    const int footer_n = snprintf(footer, sizeof(footer), "\n%s_END\n", tag);
+    if (footer_n > 0) (void)serial_write_all(footer, (size_t)footer_n, pdMS_TO_TICKS(25), 50);
+
+    // The host never got this frame, so it cannot be the base of the next delta.
+    if (!ok && s_fast.fmt == ScreenshotFormat::Delta) s_fast.prev_id = 0;
+
+    if (s_fast.reply_task) (void)xTaskNotify(s_fast.reply_task, ok ? (uint32_t)len : 0U, eSetValueWithOverwrite);
+    heap_caps_free(s_fast.data);
+    s_fast.data = nullptr;
+    s_fast.busy = false;
+    vTaskDelete(nullptr);
+}
+
+} // namespace
+
+bool screenshot_fast_to_usb_serial_jtag_start(ScreenshotFormat fmt, bool keyframe, TaskHandle_t reply_task) {
+    if (s_fast.busy) return false;
+
+    int w = 0;
+    int h = 0;
+    const uint16_t *frame = lvgl_port_m5gfx_shadow(&w, &h);
+    if (!frame || w <= 0 || h <= 0) return false;
+    const size_t pixels = (size_t)w * (size_t)h;
+    const char *name = (fmt == ScreenshotFormat::Qoi) ? "qoi" : "delta";
+
+    // Measure, then encode into an exact-size buffer: a typical frame is a few KB, while the
+    // worst case would need a contiguous block larger than the frame itself.
+    const int64_t t0 = esp_timer_get_time();
+    uint32_t base_id = 0;
+    uint32_t id = 0;
+    size_t len = 0;
+    if (fmt == ScreenshotFormat::Qoi) {
+        len = screenshot_qoi_encode_rgb565(frame, w, h, nullptr, 0);
+    } else {
+        if (!s_fast.prev) {
+            s_fast.prev = static_cast<uint16_t *>(heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_8BIT));
+            s_fast.prev_id = 0;
+            if (!s_fast.prev) {
+                ESP_LOGE(TAG, "delta: no memory for the %u-byte base frame", (unsigned)(pixels * sizeof(uint16_t)));
+                return false;
+            }
+        }
+        base_id = keyframe ? 0 : s_fast.prev_id;
+        id = s_fast.next_id;
+        len = screenshot_delta_encode_rgb565(frame, base_id ? s_fast.prev : nullptr, w, h, base_id, id, nullptr, 0);
+    }
+    if (len == 0) return false;
+
+    uint8_t *data = static_cast<uint8_t *>(heap_caps_malloc(len, MALLOC_CAP_8BIT));
+    if (!data) {
+        ESP_LOGE(TAG, "%s: no memory for %u bytes (largest free block %u)", name, (unsigned)len,
+                 (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+        return false;
+    }
+    const size_t written = (fmt == ScreenshotFormat::Qoi)
+                               ? screenshot_qoi_encode_rgb565(frame, w, h, data, len)
+                               : screenshot_delta_encode_rgb565(frame, base_id ? s_fast.prev : nullptr, w, h, base_id,
+                                                                id, data, len);
+    if (written != len) {
+        heap_caps_free(data);
+        return false;
+    }
+    if (fmt == ScreenshotFormat::Delta) {
+        memcpy(s_fast.prev, frame, pixels * sizeof(uint16_t));
+        s_fast.prev_id = id;
+        s_fast.next_id++;
+    }
+    const uint32_t encode_us = (uint32_t)(esp_timer_get_time() - t0);
+    ESP_LOGI(TAG, "%s %dx%d: %u bytes (raw %u), base=%" PRIu32 ", encode %" PRIu32 " us", name, w, h,
+             (unsigned)len, (unsigned)(pixels * sizeof(uint16_t)), base_id, encode_us);
+
+    s_fast.data = data;
+    s_fast.len = len;
+    s_fast.fmt = fmt;
+    s_fast.reply_task = reply_task;
+    s_fast.busy = true;
+    if (xTaskCreatePinnedToCore(fast_send_task, "screenshot_tx", 4096, nullptr, 2, nullptr, tskNO_AFFINITY) != pdPASS) {
+        s_fast.busy = false;
+        if (fmt == ScreenshotFormat::Delta) s_fast.prev_id = 0;
+        heap_caps_free(s_fast.data);
+        s_fast.data = nullptr;
+        return false;
+    }
+    return true;
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 #include "M5GFX.h"
 
@@ -14,3 +18,16 @@ bool screenshot_png_to_usb_serial_jtag_ex(m5gfx::M5GFX &display, size_t *out_len
 // Captures a screenshot and saves it to MicroSD (under /sd/shots/; 8.3 names).
 // Returns success/failure and optionally the PNG length + absolute path written.
 bool screenshot_png_save_to_sd_ex(m5gfx::M5GFX &display, char *out_path, size_t out_path_cap, size_t *out_len);
+
+enum class ScreenshotFormat : uint8_t {
+    Qoi = 1,
+    Delta = 2,
+};
+
+// Fast path: encodes the LVGL framebuffer copy (lvgl_port_m5gfx_shadow) instead of reading the panel,
+// on the calling UI thread (a few ms), then a background task sends it in large writes:
+//   QOI_BEGIN <len>\n<qoi bytes>\nQOI_END\n   or   DELTA_BEGIN <len>\n<SDLT bytes>\nDELTA_END\n
+// (formats in screenshot_codec.h). Delta is against the previous delta screenshot; `keyframe` forces
+// a full one. When sending finishes, reply_task is notified with the length (0 on failure).
+// Returns false if nothing was started; reply_task is then not notified.
+bool screenshot_fast_to_usb_serial_jtag_start(ScreenshotFormat fmt, bool keyframe, TaskHandle_t reply_task);
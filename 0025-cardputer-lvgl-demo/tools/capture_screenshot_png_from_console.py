@@ -1,13 +1,19 @@
 #!/usr/bin/env python3
 
 import argparse
+import os
 import re
+import sys
 import time
 
 import serial  # type: ignore
 
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import screenshot_decode  # noqa: E402
 
-HEADER_RE = re.compile(rb"^PNG_BEGIN (\d+)\n$")
+
+# PNG (panel readback) or the fast framebuffer-copy formats: `screenshot qoi`, `screenshot delta`.
+HEADER_RE = re.compile(rb"^(PNG|QOI|DELTA)_BEGIN (\d+)\n$")
 
 
 def read_exact(ser: serial.Serial, n: int) -> bytes:
@@ -43,9 +49,13 @@ def read_png_stream(ser: serial.Serial) -> bytes:
 def main() -> int:
     ap = argparse.ArgumentParser()
     ap.add_argument("port", help="Serial port (prefer /dev/serial/by-id/...)")
-    ap.add_argument("out", help="Output PNG path")
+    ap.add_argument("out", help="Output PNG path (QOI/delta captures are decoded to PNG)")
     ap.add_argument("--baud", type=int, default=115200)
-    ap.add_argument("--cmd", default="screenshot", help="Console command to send (default: screenshot)")
+    ap.add_argument("--cmd", default="screenshot",
+                    help="Console command to send (default: screenshot; also 'screenshot qoi', 'screenshot delta')")
+    ap.add_argument("--state", default=screenshot_decode.DEFAULT_STATE,
+                    help="Previous frame for delta captures (updated after each one)")
+    ap.add_argument("--raw", help="Also save the raw QOI/SDLT bytes here")
     ap.add_argument("--timeout-s", type=float, default=15.0)
     args = ap.parse_args()
 
@@ -70,7 +80,9 @@ def main() -> int:
             if not m:
                 continue
 
-            length = int(m.group(1))
+            kind = m.group(1)
+            length = int(m.group(2))
+            t0 = time.time()
             if length > 0:
                 data = read_exact(ser, length)
             else:
@@ -81,12 +93,21 @@ def main() -> int:
                 if time.time() > deadline:
                     raise TimeoutError("timed out waiting for PNG_END")
                 l2 = ser.readline()
-                if b"PNG_END" in l2:
+                if kind + b"_END" in l2:
                     break
-
-            with open(args.out, "wb") as f:
-                f.write(data)
-            print(f"wrote {args.out} ({len(data)} bytes)")
+            dt = time.time() - t0
+
+            if kind == b"PNG":
+                with open(args.out, "wb") as f:
+                    f.write(data)
+                print(f"wrote {args.out} ({len(data)} bytes, {dt:.2f}s)")
+                return 0
+
+            if args.raw:
+                with open(args.raw, "wb") as f:
+                    f.write(data)
+            what = screenshot_decode.decode_to_png(data, args.out, args.state)
+            print(f"wrote {args.out} ({what}, {len(data)} bytes, {dt:.2f}s)")
             return 0
 
 
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Decode `screenshot qoi` / `screenshot delta` captures into PNG.
+
+Formats are described in main/screenshot_codec.h. Delta frames need the previous frame, which is
+kept in a small state file (width, height, frame id, RGB565 pixels), screenshot_delta.state by default.
+
+  screenshot_decode.py shot.qoi shot.png
+  screenshot_decode.py shot.sdlt shot.png [--state screenshot_delta.state]
+  screenshot_decode.py verify <dir>    # check <name>.qoi/.sdlt against <name>.rgb565 (host test)
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+QOI_OP_INDEX = 0x00
+QOI_OP_DIFF = 0x40
+QOI_OP_LUMA = 0x80
+QOI_OP_RUN = 0xC0
+QOI_OP_RGB = 0xFE
+QOI_OP_RGBA = 0xFF
+QOI_MASK_2 = 0xC0
+
+SDLT_HEADER = struct.Struct("<4sBBHHHII")
+
+DEFAULT_STATE = "screenshot_delta.state"
+
+
+def decode_qoi(data: bytes):
+    """Returns (width, height, rgb bytes)."""
+    if len(data) < 22 or data[0:4] != b"qoif":
+        raise ValueError("not a QOI image")
+    w, h, channels, _colorspace = struct.unpack(">IIBB", data[4:14])
+    if channels not in (3, 4):
+        raise ValueError(f"bad QOI channel count {channels}")
+    n = w * h
+    out = bytearray(n * 3)
+    index = [(0, 0, 0, 0)] * 64
+    r, g, b, a = 0, 0, 0, 255
+    p = 14
+    end = len(data) - 8
+    run = 0
+    for i in range(n):
+        if run > 0:
+            run -= 1
+        elif p < end:
+            b1 = data[p]
+            p += 1
+            if b1 == QOI_OP_RGB:
+                r, g, b = data[p], data[p + 1], data[p + 2]
+                p += 3
+            elif b1 == QOI_OP_RGBA:
+                r, g, b, a = data[p], data[p + 1], data[p + 2], data[p + 3]
+                p += 4
+            elif (b1 & QOI_MASK_2) == QOI_OP_INDEX:
+                r, g, b, a = index[b1]
+            elif (b1 & QOI_MASK_2) == QOI_OP_DIFF:
+                r = (r + ((b1 >> 4) & 3) - 2) & 0xFF
+                g = (g + ((b1 >> 2) & 3) - 2) & 0xFF
+                b = (b + (b1 & 3) - 2) & 0xFF
+            elif (b1 & QOI_MASK_2) == QOI_OP_LUMA:
+                b2 = data[p]
+                p += 1
+                vg = (b1 & 0x3F) - 32
+                r = (r + vg - 8 + ((b2 >> 4) & 0x0F)) & 0xFF
+                g = (g + vg) & 0xFF
+                b = (b + vg - 8 + (b2 & 0x0F)) & 0xFF
+            elif (b1 & QOI_MASK_2) == QOI_OP_RUN:
+                run = b1 & 0x3F
+            index[(r * 3 + g * 5 + b * 7 + a * 11) % 64] = (r, g, b, a)
+        out[i * 3] = r
+        out[i * 3 + 1] = g
+        out[i * 3 + 2] = b
+    if data[-8:] != b"\x00" * 7 + b"\x01":
+        raise ValueError("missing QOI end marker")
+    return w, h, bytes(out)
+
+
+def _varint(data: bytes, p: int):
+    v = 0
+    shift = 0
+    while True:
+        if p >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[p]
+        p += 1
+        v |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return v, p
+        shift += 7
+
+
+def decode_delta(data: bytes, base):
+    """base: None or (width, height, frame_id, list of RGB565). Returns the same tuple for the new frame."""
+    if len(data) < SDLT_HEADER.size:
+        raise ValueError("not an SDLT delta")
+    magic, version, fmt, w, h, _reserved, base_id, frame_id = SDLT_HEADER.unpack_from(data, 0)
+    if magic != b"SDLT" or version != 1 or fmt != 0:
+        raise ValueError("not an SDLT v1 RGB565 delta")
+    n = w * h
+    if base_id == 0:
+        px = [0] * n
+    else:
+        if base is None or base[2] != base_id:
+            have = "none" if base is None else base[2]
+            raise ValueError(f"delta is against frame {base_id}, have {have}; capture `screenshot delta key`")
+        if (base[0], base[1]) != (w, h):
+            raise ValueError("delta size differs from its base frame")
+        px = list(base[3])
+    p = SDLT_HEADER.size
+    i = 0
+    while p < len(data):
+        skip, p = _varint(data, p)
+        count, p = _varint(data, p)
+        i += skip
+        if i + count > n or p + count * 2 > len(data):
+            raise ValueError("delta run outside the frame")
+        px[i:i + count] = struct.unpack_from(f"<{count}H", data, p)
+        p += count * 2
+        i += count
+    return w, h, frame_id, px
+
+
+def rgb565_to_rgb(px) -> bytes:
+    out = bytearray(len(px) * 3)
+    for i, v in enumerate(px):
+        r5, g6, b5 = v >> 11, (v >> 5) & 0x3F, v & 0x1F
+        out[i * 3] = (r5 << 3) | (r5 >> 2)
+        out[i * 3 + 1] = (g6 << 2) | (g6 >> 4)
+        out[i * 3 + 2] = (b5 << 3) | (b5 >> 2)
+    return bytes(out)
+
+
+def write_png(path: str, w: int, h: int, rgb: bytes) -> None:
+    def chunk(kind: bytes, body: bytes) -> bytes:
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body) & 0xFFFFFFFF)
+
+    stride = w * 3
+    raw = b"".join(b"\x00" + rgb[y * stride:(y + 1) * stride] for y in range(h))
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", w, h, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 6)))
+        f.write(chunk(b"IEND", b""))
+
+
+def load_state(path: str):
+    try:
+        with open(path, "rb") as f:
+            blob = f.read()
+    except FileNotFoundError:
+        return None
+    w, h, frame_id = struct.unpack_from("<HHI", blob, 0)
+    return w, h, frame_id, list(struct.unpack_from(f"<{w * h}H", blob, 8))
+
+
+def save_state(path: str, frame) -> None:
+    w, h, frame_id, px = frame
+    with open(path, "wb") as f:
+        f.write(struct.pack("<HHI", w, h, frame_id))
+        f.write(struct.pack(f"<{w * h}H", *px))
+
+
+def decode_to_png(data: bytes, out: str, state_path: str) -> str:
+    """Decodes a QOI or SDLT capture to `out`; returns a short description."""
+    if data[0:4] == b"qoif":
+        w, h, rgb = decode_qoi(data)
+        write_png(out, w, h, rgb)
+        return f"qoi {w}x{h}"
+    frame = decode_delta(data, load_state(state_path))
+    save_state(state_path, frame)
+    w, h, frame_id, px = frame
+    write_png(out, w, h, rgb565_to_rgb(px))
+    return f"delta {w}x{h} frame={frame_id}"
+
+
+def verify(directory: str) -> int:
+    """Host test helper: every <name>.qoi / <name>.sdlt must decode to <name>.rgb565 (u16 w, u16 h, pixels).
+
+    Delta files are decoded in name order, each against the previous delta frame."""
+    failures = 0
+    checked = 0
+    prev = None
+    for name in sorted(os.listdir(directory)):
+        stem, ext = os.path.splitext(name)
+        if ext not in (".qoi", ".sdlt"):
+            continue
+        with open(os.path.join(directory, name), "rb") as f:
+            data = f.read()
+        with open(os.path.join(directory, stem + ".rgb565"), "rb") as f:
+            ref = f.read()
+        w, h = struct.unpack_from("<HH", ref, 0)
+        want = list(struct.unpack_from(f"<{w * h}H", ref, 4))
+        try:
+            if ext == ".qoi":
+                gw, gh, rgb = decode_qoi(data)
+                ok = (gw, gh) == (w, h) and rgb == rgb565_to_rgb(want)
+            else:
+                prev = decode_delta(data, prev)
+                ok = (prev[0], prev[1]) == (w, h) and prev[3] == want
+        except ValueError as e:
+            print(f"{name}: {e}", file=sys.stderr)
+            ok = False
+        checked += 1
+        if not ok:
+            failures += 1
+            print(f"{name}: decoded image differs", file=sys.stderr)
+    print(f'{{"test":"python_decoder","files":{checked},"failures":{failures}}}')
+    return 1 if failures or checked == 0 else 0
+
+
+def main() -> int:
+    if len(sys.argv) >= 2 and sys.argv[1] == "verify":
+        if len(sys.argv) != 3:
+            print("usage: screenshot_decode.py verify <dir>", file=sys.stderr)
+            return 2
+        return verify(sys.argv[2])
+
+    ap = argparse.ArgumentParser(description="Decode a QOI or SDLT delta screenshot to PNG")
+    ap.add_argument("input", help=".qoi or .sdlt capture")
+    ap.add_argument("out", help="Output PNG path")
+    ap.add_argument("--state", default=DEFAULT_STATE, help=f"Delta base frame file (default: {DEFAULT_STATE})")
+    args = ap.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    print(f"wrote {args.out} ({decode_to_png(data, args.out, args.state)})")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
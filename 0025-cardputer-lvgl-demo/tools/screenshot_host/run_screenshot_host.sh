@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the QOI / delta screenshot encoder host test and benchmark.
+#
+# Compiles main/screenshot_codec.cpp for the host, round-trips synthetic demo
+# screens through in-test reference decoders, then checks the same files with
+# tools/screenshot_decode.py. Prints JSONL. Needs zlib (PNG size comparison).
+#
+# Usage:
+#   ./tools/screenshot_host/run_screenshot_host.sh
+#   SANITIZE= ./tools/screenshot_host/run_screenshot_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/lvgl-screenshot-host}"
+CXX="${CXX:-c++}"
+CXXFLAGS="${CXXFLAGS:--O2 -g -std=gnu++17 -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+PYTHON="${PYTHON:-python3}"
+
+mkdir -p "${BUILD_DIR}"
+rm -rf "${BUILD_DIR}/samples"
+mkdir -p "${BUILD_DIR}/samples"
+
+# shellcheck disable=SC2086
+"${CXX}" ${CXXFLAGS} ${SANITIZE} -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/screenshot_host_test" \
+  "${HERE}/screenshot_host_test.cpp" "${MAIN_DIR}/screenshot_codec.cpp" -lz
+"${BUILD_DIR}/screenshot_host_test" "${BUILD_DIR}/samples"
+"${PYTHON}" "${HERE}/../screenshot_decode.py" verify "${BUILD_DIR}/samples"
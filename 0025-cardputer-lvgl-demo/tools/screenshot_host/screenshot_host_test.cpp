@@ -0,0 +1,454 @@
+/*
+ * Host test and benchmark for the fast screenshot encoders (main/screenshot_codec.cpp).
+ *
+ * Synthetic 240x135 RGB565 frames shaped like the demo screens (text on black, charts, a selection
+ * bar, gradients) plus a noise worst case. Checks:
+ *   - QOI output decodes (reference decoder below, written from the spec) to the RGB888 widening of
+ *     the frame;
+ *   - SDLT deltas over a sequence of UI changes rebuild every frame exactly, incl. keyframes, an
+ *     unchanged frame (header only) and changes at the first / last pixel;
+ *   - an encoder given a short buffer writes nothing past it and still reports the full size;
+ * and reports bytes + encode time per mode, next to the current PNG path (zlib level 6 over
+ * filter-0 RGB888 rows, as screenshot_png does with tdefl).
+ *
+ * If given a directory, writes <name>.qoi / <name>.sdlt with <name>.rgb565 references there for
+ * tools/screenshot_decode.py verify. Built and run by tools/screenshot_host/run_screenshot_host.sh.
+ * Prints JSONL; exits non-zero on failure.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "screenshot_codec.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                            \
+            return;                                                                  \
+        }                                                                            \
+    } while (0)
+
+static constexpr int kW = 240;
+static constexpr int kH = 135;
+
+typedef std::vector<uint16_t> Frame;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint16_t rgb565(int r, int g, int b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static void widen(const Frame &f, std::vector<uint8_t> *rgb) {
+    rgb->resize(f.size() * 3);
+    for (size_t i = 0; i < f.size(); i++) {
+        const uint16_t v = f[i];
+        const int r5 = v >> 11, g6 = (v >> 5) & 0x3F, b5 = v & 0x1F;
+        (*rgb)[i * 3] = (uint8_t)((r5 << 3) | (r5 >> 2));
+        (*rgb)[i * 3 + 1] = (uint8_t)((g6 << 2) | (g6 >> 4));
+        (*rgb)[i * 3 + 2] = (uint8_t)((b5 << 3) | (b5 >> 2));
+    }
+}
+
+// ---- Synthetic screens ----
+
+static void fill_rect(Frame *f, int x, int y, int w, int h, uint16_t c) {
+    for (int yy = y; yy < y + h && yy < kH; yy++) {
+        for (int xx = x; xx < x + w && xx < kW; xx++) {
+            if (xx >= 0 && yy >= 0) (*f)[(size_t)yy * kW + xx] = c;
+        }
+    }
+}
+
+// Deterministic pseudo-glyphs: 5x7 cells with an anti-aliased edge shade, like LVGL text.
+static void draw_text(Frame *f, int x, int y, const char *s, uint16_t fg, uint16_t aa) {
+    for (int i = 0; s[i]; i++) {
+        const uint32_t seed = (uint32_t)(unsigned char)s[i] * 2654435761u;
+        for (int gy = 0; gy < 7; gy++) {
+            for (int gx = 0; gx < 5; gx++) {
+                const uint32_t bit = (seed >> ((gy * 5 + gx) % 31)) & 1u;
+                if (s[i] == ' ' || !bit) continue;
+                fill_rect(f, x + i * 7 + gx, y + gy, 1, 1, fg);
+                fill_rect(f, x + i * 7 + gx + 1, y + gy, 1, 1, aa);
+            }
+        }
+    }
+}
+
+static Frame screen_menu(int selected) {
+    Frame f((size_t)kW * kH, 0);
+    const uint16_t green = rgb565(0, 220, 80), dim = rgb565(0, 90, 30);
+    draw_text(&f, 70, 4, "LVGL DEMOS", green, dim);
+    static const char *items[] = {"BASICS", "POMODORO", "CONSOLE", "SYSTEM MONITOR", "FILES", "PALETTE"};
+    for (int i = 0; i < 6; i++) {
+        const int y = 20 + i * 16;
+        if (i == selected) fill_rect(&f, 4, y - 3, kW - 8, 14, rgb565(0, 70, 25));
+        draw_text(&f, 12, y, items[i], green, dim);
+    }
+    fill_rect(&f, 0, kH - 16, kW, 16, rgb565(16, 16, 16));
+    draw_text(&f, 4, kH - 12, "FN MENU", green, dim);
+    return f;
+}
+
+static Frame screen_sysmon(int t) {
+    Frame f((size_t)kW * kH, 0);
+    const uint16_t green = rgb565(0, 220, 80), dim = rgb565(0, 90, 30);
+    draw_text(&f, 60, 4, "SYSTEM MONITOR", green, dim);
+    char buf[48];
+    snprintf(buf, sizeof(buf), "H=%dK D=%dK L=%dHZ LV=%dUS", 180 + t % 7, 60 + t % 3, 95 + t % 11, 900 + t * 13 % 200);
+    draw_text(&f, 6, 20, buf, green, dim);
+    for (int c = 0; c < 3; c++) {
+        const int y0 = 34 + c * 22;
+        fill_rect(&f, 6, y0, kW - 12, 1, dim);
+        fill_rect(&f, 6, y0 + 19, kW - 12, 1, dim);
+        for (int x = 8; x < kW - 8; x++) {
+            const int v = (int)(((x + t * 4) * (c + 3) * 37u) % 17u);
+            fill_rect(&f, x, y0 + 2 + v, 1, 1, c == 2 ? rgb565(0, 200, 220) : green);
+        }
+    }
+    fill_rect(&f, 0, kH - 16, kW, 16, 0);
+    draw_text(&f, 4, kH - 12, "FN MENU", green, dim);
+    return f;
+}
+
+static Frame screen_gradient(void) {
+    Frame f((size_t)kW * kH, 0);
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) f[(size_t)y * kW + x] = rgb565(x * 255 / kW, y * 255 / kH, 128);
+    }
+    fill_rect(&f, 40, 40, 160, 50, rgb565(250, 250, 250));
+    draw_text(&f, 60, 60, "BUTTON", rgb565(30, 30, 30), rgb565(140, 140, 140));
+    return f;
+}
+
+static Frame screen_noise(void) {
+    Frame f((size_t)kW * kH, 0);
+    uint32_t x = 1;
+    for (auto &p : f) {
+        x = x * 1664525u + 1013904223u;
+        p = (uint16_t)(x >> 16);
+    }
+    return f;
+}
+
+// ---- Reference decoders ----
+
+static bool ref_qoi_decode(const std::vector<uint8_t> &d, int *w, int *h, std::vector<uint8_t> *rgb) {
+    if (d.size() < 22 || memcmp(d.data(), "qoif", 4) != 0) return false;
+    *w = (int)((uint32_t)d[4] << 24 | (uint32_t)d[5] << 16 | (uint32_t)d[6] << 8 | d[7]);
+    *h = (int)((uint32_t)d[8] << 24 | (uint32_t)d[9] << 16 | (uint32_t)d[10] << 8 | d[11]);
+    if (d[12] != 3) return false;
+    const size_t n = (size_t)*w * (size_t)*h;
+    rgb->assign(n * 3, 0);
+    uint8_t index[64][4];
+    memset(index, 0, sizeof(index));
+    uint8_t px[4] = {0, 0, 0, 255};
+    size_t p = 14;
+    const size_t end = d.size() - 8;
+    int run = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (run > 0) {
+            run--;
+        } else if (p < end) {
+            const uint8_t b1 = d[p++];
+            if (b1 == 0xFE) {
+                px[0] = d[p++];
+                px[1] = d[p++];
+                px[2] = d[p++];
+            } else if (b1 == 0xFF) {
+                px[0] = d[p++];
+                px[1] = d[p++];
+                px[2] = d[p++];
+                px[3] = d[p++];
+            } else if ((b1 & 0xC0) == 0x00) {
+                memcpy(px, index[b1], 4);
+            } else if ((b1 & 0xC0) == 0x40) {
+                px[0] += ((b1 >> 4) & 3) - 2;
+                px[1] += ((b1 >> 2) & 3) - 2;
+                px[2] += (b1 & 3) - 2;
+            } else if ((b1 & 0xC0) == 0x80) {
+                const uint8_t b2 = d[p++];
+                const int vg = (b1 & 0x3F) - 32;
+                px[0] += vg - 8 + ((b2 >> 4) & 0x0F);
+                px[1] += vg;
+                px[2] += vg - 8 + (b2 & 0x0F);
+            } else {
+                run = b1 & 0x3F;
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        memcpy(&(*rgb)[i * 3], px, 3);
+    }
+    static const uint8_t kEnd[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    return memcmp(&d[d.size() - 8], kEnd, 8) == 0;
+}
+
+static bool read_varint(const std::vector<uint8_t> &d, size_t *p, uint32_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*p >= d.size()) return false;
+        const uint8_t b = d[(*p)++];
+        *v |= (uint32_t)(b & 0x7F) << shift;
+        if (b < 0x80) return true;
+    }
+    return false;
+}
+
+// Applies an SDLT delta to *frame (the base; zeroed for keyframes). Returns the frame id, 0 on error.
+static uint32_t ref_delta_apply(const std::vector<uint8_t> &d, uint32_t have_id, Frame *frame) {
+    if (d.size() < kScreenshotDeltaHeaderBytes || memcmp(d.data(), "SDLT", 4) != 0 || d[4] != 1 || d[5] != 0) return 0;
+    const int w = d[6] | d[7] << 8, h = d[8] | d[9] << 8;
+    uint32_t base_id, frame_id;
+    memcpy(&base_id, &d[12], 4);
+    memcpy(&frame_id, &d[16], 4);
+    const size_t n = (size_t)w * (size_t)h;
+    if (base_id == 0) {
+        frame->assign(n, 0);
+    } else if (base_id != have_id || frame->size() != n) {
+        return 0;
+    }
+    size_t p = kScreenshotDeltaHeaderBytes;
+    size_t i = 0;
+    while (p < d.size()) {
+        uint32_t skip, count;
+        if (!read_varint(d, &p, &skip) || !read_varint(d, &p, &count)) return 0;
+        i += skip;
+        if (i + count > n || p + (size_t)count * 2 > d.size()) return 0;
+        for (uint32_t k = 0; k < count; k++, p += 2) (*frame)[i++] = (uint16_t)(d[p] | d[p + 1] << 8);
+    }
+    return frame_id;
+}
+
+// ---- Output for the python decoder ----
+
+static std::string g_out_dir;
+
+static void write_file(const std::string &name, const void *data, size_t len) {
+    if (g_out_dir.empty()) return;
+    FILE *f = fopen((g_out_dir + "/" + name).c_str(), "wb");
+    if (!f) return;
+    fwrite(data, 1, len, f);
+    fclose(f);
+}
+
+static void write_sample(const std::string &stem, const char *ext, const std::vector<uint8_t> &enc, const Frame &f) {
+    write_file(stem + ext, enc.data(), enc.size());
+    std::vector<uint8_t> ref(4 + f.size() * 2);
+    ref[0] = kW & 0xFF;
+    ref[1] = kW >> 8;
+    ref[2] = kH & 0xFF;
+    ref[3] = kH >> 8;
+    for (size_t i = 0; i < f.size(); i++) {
+        ref[4 + i * 2] = (uint8_t)f[i];
+        ref[5 + i * 2] = (uint8_t)(f[i] >> 8);
+    }
+    write_file(stem + ".rgb565", ref.data(), ref.size());
+}
+
+// ---- Tests ----
+
+struct Named {
+    const char *name;
+    Frame frame;
+};
+
+static std::vector<Named> stills(void) {
+    return {{"menu", screen_menu(1)}, {"sysmon", screen_sysmon(0)}, {"gradient", screen_gradient()},
+            {"noise", screen_noise()}};
+}
+
+// Two passes, as the device does: measure, then encode into a buffer of exactly that size.
+static bool qoi_encode(const Frame &f, std::vector<uint8_t> *out) {
+    const size_t n = screenshot_qoi_encode_rgb565(f.data(), kW, kH, nullptr, 0);
+    out->resize(n);
+    return n > 0 && screenshot_qoi_encode_rgb565(f.data(), kW, kH, out->data(), n) == n;
+}
+
+static bool delta_encode(const Frame &cur, const uint16_t *base, uint32_t base_id, uint32_t id,
+                         std::vector<uint8_t> *out) {
+    const size_t n = screenshot_delta_encode_rgb565(cur.data(), base, kW, kH, base_id, id, nullptr, 0);
+    out->resize(n);
+    return n > 0 && screenshot_delta_encode_rgb565(cur.data(), base, kW, kH, base_id, id, out->data(), n) == n;
+}
+
+static void test_qoi_roundtrip(void) {
+    for (const Named &s : stills()) {
+        std::vector<uint8_t> enc, got, want;
+        CHECK(qoi_encode(s.frame, &enc));
+        int w = 0, h = 0;
+        CHECK(ref_qoi_decode(enc, &w, &h, &got));
+        widen(s.frame, &want);
+        const bool ok = w == kW && h == kH && got == want;
+        printf("{\"test\":\"qoi_roundtrip\",\"frame\":\"%s\",\"bytes\":%zu,\"identical\":%s}\n", s.name, enc.size(),
+               ok ? "true" : "false");
+        CHECK(ok);
+        write_sample(std::string("qoi_") + s.name, ".qoi", enc, s.frame);
+    }
+
+    // Runs longer than 62 and a run that ends the image.
+    Frame flat((size_t)kW * kH, rgb565(10, 20, 30));
+    flat[0] = 0;
+    std::vector<uint8_t> enc, got, want;
+    CHECK(qoi_encode(flat, &enc));
+    int w = 0, h = 0;
+    CHECK(ref_qoi_decode(enc, &w, &h, &got));
+    widen(flat, &want);
+    CHECK(got == want);
+    CHECK(screenshot_qoi_encode_rgb565(nullptr, kW, kH, nullptr, 0) == 0);
+}
+
+static void test_delta_sequence(void) {
+    // What consecutive `screenshot delta` calls would see while using the demos.
+    std::vector<Named> seq = {
+        {"menu_sel1", screen_menu(1)},       {"menu_sel2", screen_menu(2)},     {"menu_sel2_same", screen_menu(2)},
+        {"sysmon_t0", screen_sysmon(0)},     {"sysmon_t1", screen_sysmon(1)},   {"sysmon_t2", screen_sysmon(2)},
+        {"gradient", screen_gradient()},     {"noise", screen_noise()},         {"menu_sel0", screen_menu(0)},
+    };
+    // First / last pixel changes on top of the last frame.
+    Frame edge = seq.back().frame;
+    edge.front() = 0xFFFF;
+    edge.back() = 0x1234;
+    seq.push_back({"edges", edge});
+    // Alternating changed / unchanged pixels (gaps shorter than the minimum skip).
+    Frame comb = edge;
+    for (size_t i = 1000; i < 1100; i += 2) comb[i] ^= 0x0841;
+    seq.push_back({"comb", comb});
+
+    Frame decoded;
+    const uint16_t *prev = nullptr;
+    uint32_t prev_id = 0;
+    for (size_t k = 0; k < seq.size(); k++) {
+        const Frame &cur = seq[k].frame;
+        std::vector<uint8_t> enc;
+        const uint32_t id = (uint32_t)k + 1;
+        CHECK(delta_encode(cur, prev, prev_id, id, &enc));
+        const uint32_t got_id = ref_delta_apply(enc, prev_id, &decoded);
+        const bool ok = got_id == id && decoded == cur;
+        printf("{\"test\":\"delta_roundtrip\",\"frame\":\"%s\",\"base\":%u,\"bytes\":%zu,\"identical\":%s}\n",
+               seq[k].name, (unsigned)prev_id, enc.size(), ok ? "true" : "false");
+        CHECK(ok);
+        if (strcmp(seq[k].name, "menu_sel2_same") == 0) CHECK(enc.size() == kScreenshotDeltaHeaderBytes);
+        char stem[48];
+        snprintf(stem, sizeof(stem), "delta_%02zu_%s", k, seq[k].name);
+        write_sample(stem, ".sdlt", enc, cur);
+        prev = cur.data();
+        prev_id = id;
+    }
+
+    // A keyframe (no base) of a mostly black screen stays small; a stale base id is rejected.
+    std::vector<uint8_t> key;
+    CHECK(delta_encode(seq[0].frame, nullptr, 7, 100, &key));
+    Frame kf;
+    CHECK(ref_delta_apply(key, 0, &kf) == 100 && kf == seq[0].frame);
+    std::vector<uint8_t> stale;
+    CHECK(delta_encode(seq[1].frame, seq[0].frame.data(), 5, 6, &stale));
+    CHECK(ref_delta_apply(stale, 4, &kf) == 0);
+}
+
+// A short buffer gets a prefix of the encoding and nothing past `cap`; the full size is still returned.
+static void test_bounded_output(void) {
+    const Frame menu = screen_menu(1), next = screen_menu(2);
+    std::vector<uint8_t> full;
+    CHECK(qoi_encode(menu, &full));
+    const size_t cap = full.size() / 2;
+    std::vector<uint8_t> buf(cap + 16, 0xA5);
+    CHECK(screenshot_qoi_encode_rgb565(menu.data(), kW, kH, buf.data(), cap) == full.size());
+    CHECK(memcmp(buf.data(), full.data(), cap) == 0);
+    for (size_t i = cap; i < buf.size(); i++) CHECK(buf[i] == 0xA5);
+
+    CHECK(delta_encode(next, menu.data(), 1, 2, &full));
+    std::fill(buf.begin(), buf.end(), 0xA5);
+    CHECK(screenshot_delta_encode_rgb565(next.data(), menu.data(), kW, kH, 1, 2, buf.data(), 3) == full.size());
+    CHECK(memcmp(buf.data(), full.data(), 3) == 0);
+    for (size_t i = 3; i < buf.size(); i++) CHECK(buf[i] == 0xA5);
+    printf("{\"test\":\"bounded_output\",\"ok\":true}\n");
+}
+
+static void bench_mode(const char *frame, const char *mode, size_t bytes, double encode_s, int reps) {
+    printf("{\"bench\":\"encode\",\"frame\":\"%s\",\"mode\":\"%s\",\"bytes\":%zu,\"ratio\":%.3f,\"encode_us\":%.1f}\n",
+           frame, mode, bytes, (double)bytes / ((double)kW * kH * 2), encode_s * 1e6 / reps);
+}
+
+// Bytes and host encode time per mode (both passes for QOI / SDLT, as on the device). Device encode times scale with the same ratios; the USB
+// transfer (a few hundred KB/s through the console) is what bytes buy back.
+static void bench(void) {
+    const int reps = 20;
+    std::vector<Named> frames = stills();
+    Frame menu_next = screen_menu(2), sysmon_next = screen_sysmon(1);
+    for (const Named &s : frames) {
+        std::vector<uint8_t> rgb, png;
+        widen(s.frame, &rgb);
+        double t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            // Filter-0 rows + zlib level 6, the shape of the current PNG path.
+            std::vector<uint8_t> raw;
+            raw.reserve((size_t)kH * (kW * 3 + 1));
+            for (int y = 0; y < kH; y++) {
+                raw.push_back(0);
+                raw.insert(raw.end(), rgb.begin() + (size_t)y * kW * 3, rgb.begin() + (size_t)(y + 1) * kW * 3);
+            }
+            uLongf len = compressBound((uLong)raw.size());
+            png.resize(len);
+            compress2(png.data(), &len, raw.data(), (uLong)raw.size(), 6);
+            png.resize(len);
+        }
+        bench_mode(s.name, "png_deflate", png.size(), now_s() - t0, reps);
+
+        std::vector<uint8_t> enc;
+        t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            qoi_encode(s.frame, &enc);
+        }
+        bench_mode(s.name, "qoi", enc.size(), now_s() - t0, reps);
+
+        t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            delta_encode(s.frame, nullptr, 0, 1, &enc);
+        }
+        bench_mode(s.name, "delta_key", enc.size(), now_s() - t0, reps);
+    }
+
+    struct Pair {
+        const char *name;
+        const Frame *base, *cur;
+    } pairs[] = {{"menu_select_move", &frames[0].frame, &menu_next}, {"sysmon_tick", &frames[1].frame, &sysmon_next}};
+    for (const Pair &pr : pairs) {
+        std::vector<uint8_t> enc;
+        const double t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            delta_encode(*pr.cur, pr.base->data(), 1, 2, &enc);
+        }
+        bench_mode(pr.name, "delta", enc.size(), now_s() - t0, reps);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2) g_out_dir = argv[1];
+    test_qoi_roundtrip();
+    test_delta_sequence();
+    test_bounded_output();
+    if (g_failures == 0) bench();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -9,24 +9,37 @@
 #include "freertos/task.h"
 
 #include "esp_err.h"
+#include "esp_log.h"
 
 #include "hub_bus.h"
 #include "hub_http.h"
 #include "hub_pb.h"
 #include "hub_registry.h"
+#include "hub_reply.h"
+#include "hub_scene.h"
 #include "hub_sim.h"
 #include "hub_stream.h"
+#include "hub_telemetry.h"
 #include "wifi_console.h"
 #include "wifi_sta.h"
 
+static const char *TAG = "hub_main_0029";
+
 void app_main(void) {
     ESP_ERROR_CHECK(hub_wifi_start());
     wifi_console_start();
     ESP_ERROR_CHECK(hub_registry_init());
+    ESP_ERROR_CHECK(hub_reply_init());
     ESP_ERROR_CHECK(hub_bus_start());
+    ESP_ERROR_CHECK(hub_scene_init());
     ESP_ERROR_CHECK(hub_pb_register(hub_bus_get_loop()));
     ESP_ERROR_CHECK(hub_http_start());
     ESP_ERROR_CHECK(hub_stream_start(hub_bus_get_loop()));
+    // Telemetry history is optional: without memory for it the hub still serves devices and scenes.
+    const esp_err_t err = hub_telemetry_start(hub_bus_get_loop());
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "telemetry disabled: %s", esp_err_to_name(err));
+    }
     ESP_ERROR_CHECK(hub_sim_start());
 
     while (true) {
@@ -5,18 +5,20 @@
 #include "hub_bus.h"
 
 #include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "sdkconfig.h"
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 
 #include "hub_registry.h"
+#include "hub_reply.h"
+#include "hub_scene.h"
 #include "hub_types.h"
 
 static const char *TAG = "hub_bus_0029";
@@ -30,24 +32,27 @@ esp_event_loop_handle_t hub_bus_get_loop(void) {
 }
 
 static void reply_status(const hub_cmd_hdr_t *hdr, esp_err_t status) {
-    if (!hdr || !hdr->reply_q) {
+    if (!hdr) {
         return;
     }
-    hub_reply_status_t r = {.status = status};
-    (void)xQueueSend(hdr->reply_q, &r, 0);
+    hub_reply_complete(hdr->req_id, status, NULL);
 }
 
 static void reply_device(const hub_cmd_hdr_t *hdr, esp_err_t status, const hub_device_t *device) {
-    if (!hdr || !hdr->reply_q) {
+    if (!hdr) {
         return;
     }
-    hub_reply_device_t r = {.status = status, .device_id = device ? device->id : 0};
-    if (device) {
-        r.device = *device;
-    } else {
-        memset(&r.device, 0, sizeof(r.device));
-    }
-    (void)xQueueSend(hdr->reply_q, &r, 0);
+    hub_reply_complete(hdr->req_id, status, device);
+}
+
+static void post_state(const hub_device_t *d) {
+    hub_evt_device_state_t ev = {
+        .ts_us = esp_timer_get_time(),
+        .device_id = d->id,
+        .on = d->on,
+        .level = d->level,
+    };
+    (void)esp_event_post_to(s_loop, HUB_EVT, HUB_EVT_DEVICE_STATE, &ev, sizeof(ev), 0);
 }
 
 static void on_cmd_device_add(void *arg, esp_event_base_t base, int32_t id, void *data) {
@@ -69,6 +74,7 @@ static void on_cmd_device_add(void *arg, esp_event_base_t base, int32_t id, void
     d.level = 0;
     d.power_w = 0.0f;
     d.temperature_c = 22.0f;
+    d.color_mireds = (d.caps & HUB_CAP_COLOR_TEMP) ? 370 : 0; // warm white
 
     hub_device_t created = {0};
     esp_err_t err = hub_registry_add(&d, &created);
@@ -116,17 +122,14 @@ static void on_cmd_device_set(void *arg, esp_event_base_t base, int32_t id, void
             changed = true;
         }
     }
+    if (cmd->has_color && (d.caps & HUB_CAP_COLOR_TEMP) && d.color_mireds != cmd->color_mireds) {
+        d.color_mireds = cmd->color_mireds;
+        changed = true;
+    }
 
     if (changed) {
         (void)hub_registry_update(d.id, &d);
-
-        hub_evt_device_state_t ev = {
-            .ts_us = esp_timer_get_time(),
-            .device_id = d.id,
-            .on = d.on,
-            .level = d.level,
-        };
-        (void)esp_event_post_to(s_loop, HUB_EVT, HUB_EVT_DEVICE_STATE, &ev, sizeof(ev), 0);
+        post_state(&d);
     }
 
     reply_status(&cmd->hdr, ESP_OK);
@@ -154,7 +157,8 @@ static void on_cmd_device_interview(void *arg, esp_event_base_t base, int32_t id
             d.caps |= HUB_CAP_ONOFF | HUB_CAP_POWER;
             break;
         case HUB_DEVICE_BULB:
-            d.caps |= HUB_CAP_ONOFF | HUB_CAP_LEVEL;
+            d.caps |= HUB_CAP_ONOFF | HUB_CAP_LEVEL | HUB_CAP_COLOR_TEMP;
+            if (d.color_mireds == 0) d.color_mireds = 370;
             break;
         case HUB_DEVICE_TEMP_SENSOR:
             d.caps |= HUB_CAP_TEMPERATURE;
@@ -168,26 +172,51 @@ static void on_cmd_device_interview(void *arg, esp_event_base_t base, int32_t id
     reply_status(&cmd->hdr, ESP_OK);
 }
 
-static void scene_all_onoff(bool on) {
-    hub_device_t snap[32];
-    size_t n = 0;
-    if (hub_registry_snapshot(snap, sizeof(snap) / sizeof(snap[0]), &n) != ESP_OK) {
+static void group_apply(const hub_cmd_group_set_t *cmd, hub_device_t *d) {
+    if (hub_scene_apply_to_device(d, cmd->flags, cmd->on, cmd->level, cmd->color_mireds)) {
+        (void)hub_registry_update(d->id, d);
+        post_state(d);
+    }
+}
+
+static void on_cmd_group_set(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    (void)arg;
+    (void)base;
+    (void)id;
+    const hub_cmd_group_set_t *cmd = (const hub_cmd_group_set_t *)data;
+    if (!cmd) {
+        return;
+    }
+
+    // A group frame reaches every member at once; each applies what it supports.
+    if (cmd->group_id == HUB_SCENE_GROUP_ALL) {
+        const size_t cap = hub_registry_capacity();
+        hub_device_t *snap = calloc(cap, sizeof(*snap));
+        if (!snap) {
+            reply_status(&cmd->hdr, ESP_ERR_NO_MEM);
+            return;
+        }
+        size_t n = 0;
+        esp_err_t err = hub_registry_snapshot(snap, cap, &n);
+        for (size_t i = 0; err == ESP_OK && i < n; i++) {
+            if (snap[i].caps & HUB_CAP_ONOFF) {
+                group_apply(cmd, &snap[i]);
+            }
+        }
+        free(snap);
+        reply_status(&cmd->hdr, err);
         return;
     }
+
+    uint32_t ids[HUB_SCENE_MAX_ENTRIES];
+    const size_t n = hub_scene_group_members(cmd->group_id, ids, HUB_SCENE_MAX_ENTRIES);
     for (size_t i = 0; i < n; i++) {
-        if ((snap[i].caps & HUB_CAP_ONOFF) == 0) {
-            continue;
+        hub_device_t d = {0};
+        if (hub_registry_get(ids[i], &d) == ESP_OK) {
+            group_apply(cmd, &d);
         }
-        hub_cmd_device_set_t cmd = {
-            .hdr = {.req_id = 0, .reply_q = NULL},
-            .device_id = snap[i].id,
-            .has_on = true,
-            .on = on,
-            .has_level = false,
-            .level = 0,
-        };
-        on_cmd_device_set(NULL, HUB_EVT, HUB_CMD_DEVICE_SET, &cmd);
     }
+    reply_status(&cmd->hdr, n > 0 ? ESP_OK : ESP_ERR_NOT_FOUND);
 }
 
 static void on_cmd_scene_trigger(void *arg, esp_event_base_t base, int32_t id, void *data) {
@@ -199,20 +228,11 @@ static void on_cmd_scene_trigger(void *arg, esp_event_base_t base, int32_t id, v
         return;
     }
 
-    // Two built-in scenes:
-    // - id=1: all_on
-    // - id=2: all_off
-    if (cmd->scene_id == 1) {
-        scene_all_onoff(true);
-        reply_status(&cmd->hdr, ESP_OK);
-        return;
-    }
-    if (cmd->scene_id == 2) {
-        scene_all_onoff(false);
-        reply_status(&cmd->hdr, ESP_OK);
-        return;
-    }
-    reply_status(&cmd->hdr, ESP_ERR_NOT_FOUND);
+    // Scenes are applied by the scene task (it paces its commands through this
+    // loop); the reply only says the scene was accepted.
+    const esp_err_t err = (cmd->scene_id == 0 || cmd->scene_id > UINT16_MAX) ? ESP_ERR_NOT_FOUND
+                                                                             : hub_scene_trigger((uint16_t)cmd->scene_id);
+    reply_status(&cmd->hdr, err);
 }
 
 esp_err_t hub_bus_start(void) {
@@ -240,6 +260,7 @@ esp_err_t hub_bus_start(void) {
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, HUB_EVT, HUB_CMD_DEVICE_SET, &on_cmd_device_set, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, HUB_EVT, HUB_CMD_DEVICE_INTERVIEW, &on_cmd_device_interview, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, HUB_EVT, HUB_CMD_SCENE_TRIGGER, &on_cmd_scene_trigger, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, HUB_EVT, HUB_CMD_GROUP_SET, &on_cmd_group_set, NULL));
 
     return ESP_OK;
 }
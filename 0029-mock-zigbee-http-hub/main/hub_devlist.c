@@ -0,0 +1,152 @@
+/*
+ * Chunked hub.v1.DeviceList writer + ETag helpers for tutorial 0029.
+ *
+ * Plain C (no nanopb, no httpd), so the byte stream can be checked on the host
+ * against protoc (tools/devlist_host).
+ */
+
+#include "hub_devlist.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Protobuf wire types / field numbers (hub_events.proto).
+#define WT_VARINT 0
+#define WT_LEN 2
+#define WT_I32 5
+
+#define DEVICELIST_DEVICES 1
+#define DEVICE_ID 1
+#define DEVICE_TYPE 2
+#define DEVICE_CAPS 3
+#define DEVICE_NAME 4
+#define DEVICE_ON 10
+#define DEVICE_LEVEL 11
+#define DEVICE_POWER_W 12
+#define DEVICE_TEMPERATURE_C 13
+#define DEVICE_COLOR_TEMP_MIREDS 14
+
+#define DEVICE_NAME_MAX 31 // (nanopb).max_length
+
+typedef struct {
+    uint8_t *p;
+    uint8_t *end;
+} out_t;
+
+static bool put_varint(out_t *o, uint32_t v) {
+    do {
+        if (o->p >= o->end) return false;
+        uint8_t b = (uint8_t)(v & 0x7f);
+        v >>= 7;
+        *o->p++ = v ? (uint8_t)(b | 0x80) : b;
+    } while (v);
+    return true;
+}
+
+static bool put_tag(out_t *o, uint32_t field, uint32_t wt) {
+    return put_varint(o, (field << 3) | wt);
+}
+
+static bool put_u32_field(out_t *o, uint32_t field, uint32_t v) {
+    if (v == 0) return true;
+    return put_tag(o, field, WT_VARINT) && put_varint(o, v);
+}
+
+static bool put_float_field(out_t *o, uint32_t field, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    // proto3 default is all-zero bits; -0.0f is sent, like nanopb does.
+    if (bits == 0) return true;
+    if (!put_tag(o, field, WT_I32) || o->end - o->p < 4) return false;
+    for (int i = 0; i < 4; i++) {
+        *o->p++ = (uint8_t)(bits >> (8 * i));
+    }
+    return true;
+}
+
+bool hub_devlist_encode_device(const hub_device_t *d, uint8_t *out, size_t cap, size_t *out_len) {
+    out_t o = {.p = out, .end = out + cap};
+    const size_t name_len = strnlen(d->name, DEVICE_NAME_MAX);
+
+    bool ok = put_u32_field(&o, DEVICE_ID, d->id) &&
+              put_u32_field(&o, DEVICE_TYPE, (uint32_t)d->type) &&
+              put_u32_field(&o, DEVICE_CAPS, d->caps);
+    if (ok && name_len > 0) {
+        ok = put_tag(&o, DEVICE_NAME, WT_LEN) && put_varint(&o, (uint32_t)name_len) &&
+             (size_t)(o.end - o.p) >= name_len;
+        if (ok) {
+            memcpy(o.p, d->name, name_len);
+            o.p += name_len;
+        }
+    }
+    ok = ok && put_u32_field(&o, DEVICE_ON, d->on ? 1u : 0u) &&
+         put_u32_field(&o, DEVICE_LEVEL, d->level) &&
+         put_float_field(&o, DEVICE_POWER_W, d->power_w) &&
+         put_float_field(&o, DEVICE_TEMPERATURE_C, d->temperature_c) &&
+         put_u32_field(&o, DEVICE_COLOR_TEMP_MIREDS, d->color_mireds);
+    if (ok) *out_len = (size_t)(o.p - out);
+    return ok;
+}
+
+void hub_devlist_writer_init(hub_devlist_writer_t *w, uint8_t *buf, size_t cap, hub_devlist_sink_fn sink, void *ctx) {
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = cap;
+    w->sink = sink;
+    w->ctx = ctx;
+    w->err = (cap < HUB_DEVLIST_ENTRY_MAX) ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+static esp_err_t writer_flush(hub_devlist_writer_t *w) {
+    if (w->err != ESP_OK || w->len == 0) return w->err;
+    w->err = w->sink(w->ctx, w->buf, w->len);
+    if (w->err == ESP_OK) w->total += w->len;
+    w->len = 0;
+    return w->err;
+}
+
+esp_err_t hub_devlist_write_device(hub_devlist_writer_t *w, const hub_device_t *d) {
+    if (w->err != ESP_OK) return w->err;
+    if (w->cap - w->len < HUB_DEVLIST_ENTRY_MAX && writer_flush(w) != ESP_OK) return w->err;
+
+    // Body first, two bytes in, then the tag + length in front of it.
+    uint8_t *entry = w->buf + w->len;
+    size_t body = 0;
+    if (!hub_devlist_encode_device(d, entry + 2, HUB_DEVLIST_ENTRY_MAX - 2, &body) || body > 0x7f) {
+        w->err = ESP_ERR_INVALID_SIZE;
+        return w->err;
+    }
+    entry[0] = (uint8_t)((DEVICELIST_DEVICES << 3) | WT_LEN);
+    entry[1] = (uint8_t)body;
+    w->len += 2 + body;
+    return ESP_OK;
+}
+
+esp_err_t hub_devlist_writer_finish(hub_devlist_writer_t *w) {
+    return writer_flush(w);
+}
+
+void hub_devlist_etag(uint32_t boot, uint32_t generation, char *out, size_t cap) {
+    snprintf(out, cap, "\"%08x-%08x\"", (unsigned)boot, (unsigned)generation);
+}
+
+bool hub_devlist_etag_match(const char *if_none_match, const char *etag) {
+    if (!if_none_match || !etag) return false;
+    const size_t etag_len = strlen(etag);
+
+    const char *p = if_none_match;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        if (*p == '\0') break;
+        const char *start = p;
+        while (*p && *p != ',') p++;
+        const char *end = p;
+        while (end > start && (end[-1] == ' ' || end[-1] == '\t')) end--;
+
+        if (end - start == 1 && *start == '*') return true;
+        // If-None-Match uses weak comparison: a W/ prefix doesn't matter.
+        if (end - start > 2 && start[0] == 'W' && start[1] == '/') start += 2;
+        if ((size_t)(end - start) == etag_len && memcmp(start, etag, etag_len) == 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "hub_types.h"
+
+// Streaming writer for GET /v1/devices (hub.v1.DeviceList).
+//
+// A repeated field on the wire is just its entries back to back, so the list is
+// written one hub.v1.Device entry at a time into a small buffer that is handed
+// to `sink` (httpd_resp_send_chunk) whenever it fills. The response size is not
+// bounded by a buffer or by DeviceList's nanopb max_count. Entries are encoded
+// the way nanopb encodes proto3: fields in number order, zero values omitted.
+
+typedef esp_err_t (*hub_devlist_sink_fn)(void *ctx, const uint8_t *data, size_t len);
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    size_t total; // bytes handed to the sink so far
+    hub_devlist_sink_fn sink;
+    void *ctx;
+    esp_err_t err; // first sink/encode error; later writes are no-ops
+} hub_devlist_writer_t;
+
+// buf must hold at least HUB_DEVLIST_ENTRY_MAX bytes.
+#define HUB_DEVLIST_ENTRY_MAX 96
+
+void hub_devlist_writer_init(hub_devlist_writer_t *w, uint8_t *buf, size_t cap, hub_devlist_sink_fn sink, void *ctx);
+
+// Appends one DeviceList.devices entry.
+esp_err_t hub_devlist_write_device(hub_devlist_writer_t *w, const hub_device_t *d);
+
+// Hands the buffered tail to the sink. Does not terminate the HTTP response.
+esp_err_t hub_devlist_writer_finish(hub_devlist_writer_t *w);
+
+// Encodes the hub.v1.Device message body for d. False if cap is too small.
+bool hub_devlist_encode_device(const hub_device_t *d, uint8_t *out, size_t cap, size_t *out_len);
+
+// Strong ETag for a registry generation: "<boot>-<generation>" in hex, quoted.
+// `boot` tells generations of different boots apart.
+void hub_devlist_etag(uint32_t boot, uint32_t generation, char *out, size_t cap);
+
+// True when an If-None-Match header value lists etag (or is "*").
+bool hub_devlist_etag_match(const char *if_none_match, const char *etag);
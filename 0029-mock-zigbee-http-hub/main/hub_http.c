@@ -21,23 +21,32 @@
 #include "esp_event.h"
 #include "esp_http_server.h"
 #include "esp_log.h"
+#include "esp_random.h"
 #include "esp_timer.h"
 
 #include "pb_decode.h"
 #include "pb_encode.h"
 
 #include "hub_bus.h"
+#include "hub_devlist.h"
 #include "hub_pb.h"
 #include "hub_registry.h"
+#include "hub_reply.h"
+#include "hub_scene.h"
+#include "hub_stream.h"
+#include "hub_telemetry.h"
 #include "hub_types.h"
 
 static const char *TAG = "hub_http_0029";
 
 static httpd_handle_t s_server = NULL;
+// Mixed into device list ETags so a reboot (generation restarts) can't match an old one.
+static uint32_t s_etag_boot = 0;
 
 static esp_err_t device_set_post(httpd_req_t *req);
 static esp_err_t device_interview_post(httpd_req_t *req);
 static esp_err_t scene_trigger_post(httpd_req_t *req);
+static esp_err_t scene_save_post(httpd_req_t *req);
 
 #if CONFIG_HTTPD_WS_SUPPORT
 extern const uint8_t index_html_start[] asm("_binary_index_html_start");
@@ -49,21 +58,27 @@ extern const uint8_t app_js_end[] asm("_binary_app_js_end");
 #if CONFIG_TUTORIAL_0029_ENABLE_WS_PB
 static SemaphoreHandle_t s_ws_mu = NULL;
 static int s_ws_clients[8];
+static uint32_t s_ws_serials[8]; // per connection, so a reused fd reads as a new client
+static uint32_t s_ws_serial_next = 0;
 static size_t s_ws_clients_n = 0;
 static volatile size_t s_ws_clients_n_cached = 0;
 #endif
 
 #if CONFIG_TUTORIAL_0029_ENABLE_WS_PB
-static void ws_client_add(int fd) {
+// handshake: fd just completed a WebSocket upgrade, so it is a new connection even if
+// the old one on the same fd was never removed.
+static void ws_client_add(int fd, bool handshake) {
     if (!s_ws_mu) return;
     xSemaphoreTake(s_ws_mu, portMAX_DELAY);
     for (size_t i = 0; i < s_ws_clients_n; i++) {
         if (s_ws_clients[i] == fd) {
+            if (handshake) s_ws_serials[i] = ++s_ws_serial_next;
             xSemaphoreGive(s_ws_mu);
             return;
         }
     }
     if (s_ws_clients_n < (sizeof(s_ws_clients) / sizeof(s_ws_clients[0]))) {
+        s_ws_serials[s_ws_clients_n] = ++s_ws_serial_next;
         s_ws_clients[s_ws_clients_n++] = fd;
     }
     s_ws_clients_n_cached = s_ws_clients_n;
@@ -76,6 +91,7 @@ static void ws_client_remove(int fd) {
     for (size_t i = 0; i < s_ws_clients_n; i++) {
         if (s_ws_clients[i] == fd) {
             s_ws_clients[i] = s_ws_clients[s_ws_clients_n - 1];
+            s_ws_serials[i] = s_ws_serials[s_ws_clients_n - 1];
             s_ws_clients_n--;
             break;
         }
@@ -84,12 +100,14 @@ static void ws_client_remove(int fd) {
     xSemaphoreGive(s_ws_mu);
 }
 
-static size_t ws_clients_snapshot(int *out, size_t max_out) {
+// out_serials may be NULL.
+static size_t ws_clients_snapshot(int *out, uint32_t *out_serials, size_t max_out) {
     if (!out || max_out == 0 || !s_ws_mu) return 0;
     xSemaphoreTake(s_ws_mu, portMAX_DELAY);
     const size_t n = (s_ws_clients_n < max_out) ? s_ws_clients_n : max_out;
     for (size_t i = 0; i < n; i++) {
         out[i] = s_ws_clients[i];
+        if (out_serials) out_serials[i] = s_ws_serials[i];
     }
     xSemaphoreGive(s_ws_mu);
     return n;
@@ -112,6 +130,34 @@ static void ws_send_free_cb(esp_err_t err, int fd, void *arg) {
         free(b);
     }
 }
+
+// Queues one binary frame of `b` to `fd` and consumes one reference of `b`.
+static esp_err_t ws_send_shared(int fd, ws_shared_buf_t *b) {
+    const httpd_ws_client_info_t info = httpd_ws_get_fd_info(s_server, fd);
+    if (info == HTTPD_WS_CLIENT_INVALID) {
+        ws_client_remove(fd);
+        if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (info != HTTPD_WS_CLIENT_WEBSOCKET) {
+        // Connection exists but isn't upgraded yet (HTTP). Keep it around; it'll become
+        // a WebSocket after the handshake completes. The frame was not delivered, though.
+        if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    httpd_ws_frame_t frame = {0};
+    frame.type = HTTPD_WS_TYPE_BINARY;
+    frame.payload = (uint8_t *)b->data;
+    frame.len = b->len;
+
+    esp_err_t err = httpd_ws_send_data_async(s_server, fd, &frame, ws_send_free_cb, b);
+    if (err != ESP_OK) {
+        ws_client_remove(fd);
+        if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
+    }
+    return err;
+}
 #endif
 
 size_t hub_http_events_client_count(void) {
@@ -135,7 +181,7 @@ esp_err_t hub_http_events_broadcast_pb(const uint8_t *data, size_t len) {
     if (hub_http_events_client_count() == 0) return ESP_OK;
 
     int fds[8];
-    const size_t n = ws_clients_snapshot(fds, sizeof(fds) / sizeof(fds[0]));
+    const size_t n = ws_clients_snapshot(fds, NULL, sizeof(fds) / sizeof(fds[0]));
     if (n == 0) return ESP_OK;
 
     ws_shared_buf_t *b = (ws_shared_buf_t *)malloc(sizeof(*b) + len);
@@ -145,36 +191,42 @@ esp_err_t hub_http_events_broadcast_pb(const uint8_t *data, size_t len) {
     atomic_init(&b->refcnt, (int)n);
 
     for (size_t i = 0; i < n; i++) {
-        const int fd = fds[i];
-        const httpd_ws_client_info_t info = httpd_ws_get_fd_info(s_server, fd);
-        if (info == HTTPD_WS_CLIENT_INVALID) {
-            ws_client_remove(fd);
-            if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
-            continue;
-        }
-        if (info != HTTPD_WS_CLIENT_WEBSOCKET) {
-            // Connection exists but isn't upgraded yet (HTTP). Keep it around; it'll become
-            // a WebSocket after the handshake completes.
-            if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
-            continue;
-        }
-
-        httpd_ws_frame_t frame = {0};
-        frame.type = HTTPD_WS_TYPE_BINARY;
-        frame.payload = (uint8_t *)b->data;
-        frame.len = len;
-
-        esp_err_t err = httpd_ws_send_data_async(s_server, fd, &frame, ws_send_free_cb, b);
-        if (err != ESP_OK) {
-            ws_client_remove(fd);
-            if (atomic_fetch_sub(&b->refcnt, 1) == 1) free(b);
-        }
+        ws_send_shared(fds[i], b);
     }
 
     return ESP_OK;
 #endif
 }
 
+esp_err_t hub_http_events_send_pb(int fd, const uint8_t *data, size_t len) {
+    if (!s_server) return ESP_ERR_INVALID_STATE;
+    if (!data || len == 0) return ESP_OK;
+
+#if !CONFIG_TUTORIAL_0029_ENABLE_WS_PB
+    (void)fd;
+    return ESP_OK; // WS stream disabled
+#else
+    ws_shared_buf_t *b = (ws_shared_buf_t *)malloc(sizeof(*b) + len);
+    if (!b) return ESP_ERR_NO_MEM;
+    memcpy(b->data, data, len);
+    b->len = len;
+    atomic_init(&b->refcnt, 1);
+    return ws_send_shared(fd, b);
+#endif
+}
+
+size_t hub_http_events_clients(int *out_fds, uint32_t *out_serials, size_t max_out) {
+    if (!s_server) return 0;
+#if !CONFIG_TUTORIAL_0029_ENABLE_WS_PB
+    (void)out_fds;
+    (void)out_serials;
+    (void)max_out;
+    return 0;
+#else
+    return ws_clients_snapshot(out_fds, out_serials, max_out);
+#endif
+}
+
 static esp_err_t read_body_raw(httpd_req_t *req, uint8_t *buf, size_t cap, size_t *out_len) {
     if (out_len) *out_len = 0;
     if (!req || !buf || cap == 0 || !out_len) return ESP_ERR_INVALID_ARG;
@@ -255,6 +307,15 @@ static esp_err_t app_js_get(httpd_req_t *req) {
 #endif
 }
 
+// Every reply slot is busy (hub_reply_acquire timed out). That clears as soon as a
+// command completes, so tell the client to retry rather than report a server error.
+static void send_no_reply_slot(httpd_req_t *req) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    httpd_resp_set_type(req, "text/plain");
+    httpd_resp_sendstr(req, "no reply slot");
+}
+
 static esp_err_t debug_seed_post(httpd_req_t *req) {
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     if (!loop) {
@@ -273,13 +334,13 @@ static esp_err_t debug_seed_post(httpd_req_t *req) {
     };
 
     for (size_t i = 0; i < sizeof(seeds) / sizeof(seeds[0]); i++) {
-        QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_device_t));
-        if (!q) {
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+        uint32_t req_id = 0;
+        if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+            send_no_reply_slot(req);
             return ESP_OK;
         }
         hub_cmd_device_add_t cmd = {
-            .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+            .hdr = {.req_id = req_id},
             .type = seeds[i].type,
             .caps = seeds[i].caps,
         };
@@ -287,41 +348,38 @@ static esp_err_t debug_seed_post(httpd_req_t *req) {
 
         esp_err_t err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_ADD, &cmd, sizeof(cmd), pdMS_TO_TICKS(200));
         if (err != ESP_OK) {
-            vQueueDelete(q);
+            hub_reply_release(req_id);
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
             return ESP_OK;
         }
         hub_reply_device_t rep = {0};
-        if (xQueueReceive(q, &rep, pdMS_TO_TICKS(500)) != pdTRUE) {
-            vQueueDelete(q);
+        if (hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep) != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "no reply");
             return ESP_OK;
         }
-        vQueueDelete(q);
         if (rep.status != ESP_OK) {
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "seed failed");
             return ESP_OK;
         }
 
         // Interview each seeded device for more traffic/cap state normalization.
-        QueueHandle_t qi = xQueueCreate(1, sizeof(hub_reply_status_t));
-        if (!qi) {
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+        uint32_t ireq_id = 0;
+        if (hub_reply_acquire(pdMS_TO_TICKS(100), &ireq_id) != ESP_OK) {
+            send_no_reply_slot(req);
             return ESP_OK;
         }
         hub_cmd_device_interview_t icmd = {
-            .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = qi},
+            .hdr = {.req_id = ireq_id},
             .device_id = rep.device_id,
         };
         err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_INTERVIEW, &icmd, sizeof(icmd), pdMS_TO_TICKS(200));
         if (err != ESP_OK) {
-            vQueueDelete(qi);
+            hub_reply_release(ireq_id);
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
             return ESP_OK;
         }
-        hub_reply_status_t irep = {0};
-        (void)xQueueReceive(qi, &irep, pdMS_TO_TICKS(500));
-        vQueueDelete(qi);
+        hub_reply_device_t irep = {0};
+        (void)hub_reply_wait(ireq_id, pdMS_TO_TICKS(500), &irep);
     }
 
     httpd_resp_set_type(req, "text/plain");
@@ -329,27 +387,51 @@ static esp_err_t debug_seed_post(httpd_req_t *req) {
     return ESP_OK;
 }
 
-static esp_err_t devices_list_get(httpd_req_t *req) {
-    hub_device_t snap[32];
-    size_t n = 0;
-    (void)hub_registry_snapshot(snap, sizeof(snap) / sizeof(snap[0]), &n);
-
-    hub_v1_DeviceList list = hub_v1_DeviceList_init_zero;
-    list.devices_count = 0;
-    for (size_t i = 0; i < n && list.devices_count < (sizeof(list.devices) / sizeof(list.devices[0])); i++) {
-        hub_pb_fill_device(&list.devices[list.devices_count], &snap[i]);
-        list.devices_count++;
-    }
+static esp_err_t devlist_send_chunk(void *ctx, const uint8_t *data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, (const char *)data, (ssize_t)len);
+}
 
-    uint8_t buf[1024];
-    pb_ostream_t s = pb_ostream_from_buffer(buf, sizeof(buf));
-    if (!pb_encode(&s, hub_v1_DeviceList_fields, &list)) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "encode failed");
+static esp_err_t devices_list_get(httpd_req_t *req) {
+    // Unchanged registry: answer from the generation alone, no snapshot.
+    char etag[24];
+    hub_devlist_etag(s_etag_boot, hub_registry_generation(), etag, sizeof(etag));
+    char inm[96];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        hub_devlist_etag_match(inm, etag)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_set_hdr(req, "ETag", etag);
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    const size_t cap = hub_registry_capacity();
+    hub_device_t *snap = calloc(cap, sizeof(*snap));
+    if (!snap) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
         return ESP_OK;
     }
+    size_t n = 0;
+    uint32_t gen = 0;
+    (void)hub_registry_snapshot_gen(snap, cap, &n, &gen);
+    // The ETag names the generation the snapshot belongs to, not the one checked above.
+    hub_devlist_etag(s_etag_boot, gen, etag, sizeof(etag));
 
     httpd_resp_set_type(req, "application/x-protobuf");
-    return httpd_resp_send(req, (const char *)buf, (ssize_t)s.bytes_written);
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    uint8_t chunk[512];
+    hub_devlist_writer_t w;
+    hub_devlist_writer_init(&w, chunk, sizeof(chunk), devlist_send_chunk, req);
+    for (size_t i = 0; i < n && w.err == ESP_OK; i++) {
+        (void)hub_devlist_write_device(&w, &snap[i]);
+    }
+    esp_err_t err = hub_devlist_writer_finish(&w);
+    free(snap);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "device list aborted after %u bytes: %s", (unsigned)w.total, esp_err_to_name(err));
+        return err;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
 static esp_err_t devices_get(httpd_req_t *req) {
@@ -429,14 +511,14 @@ static esp_err_t devices_post(httpd_req_t *req) {
         return ESP_OK;
     }
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_device_t));
-    if (!q) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+    uint32_t req_id = 0;
+    if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+        send_no_reply_slot(req);
         return ESP_OK;
     }
 
     hub_cmd_device_add_t cmd = {
-        .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+        .hdr = {.req_id = req_id},
         .type = (hub_device_type_t)in.type,
         .caps = in.caps,
     };
@@ -445,18 +527,16 @@ static esp_err_t devices_post(httpd_req_t *req) {
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_ADD, &cmd, sizeof(cmd), pdMS_TO_TICKS(200));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
         return ESP_OK;
     }
 
     hub_reply_device_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(500)) != pdTRUE) {
-        vQueueDelete(q);
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "no reply");
         return ESP_OK;
     }
-    vQueueDelete(q);
     if (rep.status != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "add failed");
         return ESP_OK;
@@ -499,41 +579,45 @@ static esp_err_t device_set_post(httpd_req_t *req) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad protobuf");
         return ESP_OK;
     }
-    if (!in.has_on && !in.has_level) {
+    if (!in.has_on && !in.has_level && !in.has_color_temp) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "no fields set");
         return ESP_OK;
     }
+    if (in.color_temp_mireds > UINT16_MAX || in.transition_ds > UINT16_MAX) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "value out of range");
+        return ESP_OK;
+    }
 
     hub_cmd_device_set_t cmd = {0};
-    cmd.hdr.req_id = (uint32_t)esp_timer_get_time();
     cmd.device_id = id;
     cmd.has_on = in.has_on;
     cmd.on = in.on;
     cmd.has_level = in.has_level;
     cmd.level = (uint8_t)in.level;
+    cmd.has_color = in.has_color_temp;
+    cmd.color_mireds = (uint16_t)in.color_temp_mireds;
+    cmd.transition_ds = (uint16_t)in.transition_ds;
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_status_t));
-    if (!q) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+    uint32_t req_id = 0;
+    if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+        send_no_reply_slot(req);
         return ESP_OK;
     }
-    cmd.hdr.reply_q = q;
+    cmd.hdr.req_id = req_id;
 
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_SET, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
         return ESP_OK;
     }
 
-    hub_reply_status_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(250)) != pdTRUE) {
-        vQueueDelete(q);
+    hub_reply_device_t rep = {0};
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(250), &rep) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "no reply");
         return ESP_OK;
     }
-    vQueueDelete(q);
 
     if (rep.status == ESP_ERR_NOT_FOUND) {
         httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "not found");
@@ -564,32 +648,30 @@ static esp_err_t device_interview_post(httpd_req_t *req) {
         return ESP_OK;
     }
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_status_t));
-    if (!q) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+    uint32_t req_id = 0;
+    if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+        send_no_reply_slot(req);
         return ESP_OK;
     }
 
     hub_cmd_device_interview_t cmd = {
-        .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+        .hdr = {.req_id = req_id},
         .device_id = id,
     };
 
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     esp_err_t err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_INTERVIEW, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
         return ESP_OK;
     }
 
-    hub_reply_status_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(250)) != pdTRUE) {
-        vQueueDelete(q);
+    hub_reply_device_t rep = {0};
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(250), &rep) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "no reply");
         return ESP_OK;
     }
-    vQueueDelete(q);
 
     if (rep.status == ESP_ERR_NOT_FOUND) {
         httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "not found");
@@ -625,9 +707,7 @@ static esp_err_t scenes_post_subroute(httpd_req_t *req) {
     if (ulen >= sfx && strcmp(uri + (ulen - sfx), suffix) == 0) {
         return scene_trigger_post(req);
     }
-
-    httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Nothing matches the given URI");
-    return ESP_OK;
+    return scene_save_post(req);
 }
 
 static esp_err_t scene_trigger_post(httpd_req_t *req) {
@@ -637,32 +717,30 @@ static esp_err_t scene_trigger_post(httpd_req_t *req) {
         return ESP_OK;
     }
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_status_t));
-    if (!q) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no mem");
+    uint32_t req_id = 0;
+    if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+        send_no_reply_slot(req);
         return ESP_OK;
     }
 
     hub_cmd_scene_trigger_t cmd = {
-        .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+        .hdr = {.req_id = req_id},
         .scene_id = id,
     };
 
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     esp_err_t err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_SCENE_TRIGGER, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "bus busy");
         return ESP_OK;
     }
 
-    hub_reply_status_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(500)) != pdTRUE) {
-        vQueueDelete(q);
+    hub_reply_device_t rep = {0};
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep) != ESP_OK) {
         httpd_resp_send_err(req, HTTPD_408_REQ_TIMEOUT, "no reply");
         return ESP_OK;
     }
-    vQueueDelete(q);
 
     if (rep.status == ESP_ERR_NOT_FOUND) {
         httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "unknown scene");
@@ -685,19 +763,303 @@ static esp_err_t scene_trigger_post(httpd_req_t *req) {
     return httpd_resp_send(req, (const char *)outbuf, (ssize_t)os.bytes_written);
 }
 
+static esp_err_t send_reply_ok(httpd_req_t *req) {
+    hub_v1_ReplyStatus out = hub_v1_ReplyStatus_init_zero;
+    out.ok = true;
+    out.status = 0;
+    uint8_t outbuf[32];
+    pb_ostream_t os = pb_ostream_from_buffer(outbuf, sizeof(outbuf));
+    if (!pb_encode(&os, hub_v1_ReplyStatus_fields, &out)) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "encode failed");
+        return ESP_OK;
+    }
+    httpd_resp_set_type(req, "application/x-protobuf");
+    return httpd_resp_send(req, (const char *)outbuf, (ssize_t)os.bytes_written);
+}
+
+static bool parse_scene_id(httpd_req_t *req, uint16_t *out_id) {
+    uint32_t id = 0;
+    if (!parse_u32_path_param(req->uri, "/v1/scenes/", "", &id) || id == 0 || id > HUB_SCENE_ID_MAX) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad scene id");
+        return false;
+    }
+    *out_id = (uint16_t)id;
+    return true;
+}
+
+// hub.v1.Scene -> hub_scene_t. False (with a reason) for an entry it can't store.
+static bool scene_from_pb(const hub_v1_Scene *in, uint16_t id, hub_scene_t *out, const char **why) {
+    memset(out, 0, sizeof(*out));
+    out->id = id;
+    strlcpy(out->name, in->name, sizeof(out->name));
+    if (in->transition_ds > UINT16_MAX) {
+        *why = "transition out of range";
+        return false;
+    }
+    out->transition_ds = (uint16_t)in->transition_ds;
+
+    for (pb_size_t i = 0; i < in->entries_count; i++) {
+        const hub_v1_SceneEntry *e = &in->entries[i];
+        hub_scene_entry_t *o = &out->entries[i];
+        if (e->device_id == 0 || (!e->has_on && !e->has_level && !e->has_color_temp_mireds)) {
+            *why = "entry needs device_id and a target";
+            return false;
+        }
+        if (e->level > 100 || e->color_temp_mireds > UINT16_MAX) {
+            *why = "entry value out of range";
+            return false;
+        }
+        o->device_id = e->device_id;
+        o->flags = (uint8_t)((e->has_on ? HUB_SCENE_F_ON : 0) | (e->has_level ? HUB_SCENE_F_LEVEL : 0) |
+                             (e->has_color_temp_mireds ? HUB_SCENE_F_COLOR_TEMP : 0));
+        o->on = e->on;
+        o->level = (uint8_t)e->level;
+        o->color_mireds = (uint16_t)e->color_temp_mireds;
+    }
+    out->n_entries = (uint8_t)in->entries_count;
+    return true;
+}
+
+static esp_err_t scene_save_post(httpd_req_t *req) {
+    uint16_t id = 0;
+    if (!parse_scene_id(req, &id)) return ESP_OK;
+
+    uint8_t body[1024];
+    size_t n = 0;
+    if (read_body_raw(req, body, sizeof(body), &n) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "body too large");
+        return ESP_OK;
+    }
+
+    hub_v1_Scene *in = calloc(1, sizeof(*in));
+    hub_scene_t *scene = calloc(1, sizeof(*scene));
+    if (!in || !scene) {
+        free(in);
+        free(scene);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no memory");
+        return ESP_OK;
+    }
+
+    const char *why = NULL;
+    esp_err_t err = ESP_FAIL;
+    pb_istream_t s = pb_istream_from_buffer(body, n);
+    if (!pb_decode(&s, hub_v1_Scene_fields, in)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad protobuf");
+    } else if (!scene_from_pb(in, id, scene, &why)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, why);
+    } else {
+        err = hub_scene_save(scene);
+        if (err == ESP_ERR_NO_MEM) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "scene table full");
+        } else if (err != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "save failed");
+        }
+    }
+    free(in);
+    free(scene);
+    return err == ESP_OK ? send_reply_ok(req) : ESP_OK;
+}
+
+static esp_err_t scene_get(httpd_req_t *req) {
+    uint16_t id = 0;
+    if (!parse_scene_id(req, &id)) return ESP_OK;
+
+    hub_scene_t *scene = calloc(1, sizeof(*scene));
+    hub_v1_Scene *out = calloc(1, sizeof(*out));
+    uint8_t *buf = malloc(hub_v1_Scene_size);
+    hub_scene_stats_t st = {0};
+    esp_err_t err = (scene && out && buf) ? hub_scene_get(id, scene, &st) : ESP_ERR_NO_MEM;
+    if (err != ESP_OK) {
+        free(scene);
+        free(out);
+        free(buf);
+        if (err == ESP_ERR_NOT_FOUND) {
+            httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "unknown scene");
+        } else {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "no memory");
+        }
+        return ESP_OK;
+    }
+
+    out->id = scene->id;
+    strlcpy(out->name, scene->name, sizeof(out->name));
+    out->transition_ds = scene->transition_ds;
+    out->entries_count = scene->n_entries;
+    for (size_t i = 0; i < scene->n_entries; i++) {
+        const hub_scene_entry_t *e = &scene->entries[i];
+        hub_v1_SceneEntry *o = &out->entries[i];
+        o->device_id = e->device_id;
+        o->has_on = (e->flags & HUB_SCENE_F_ON) != 0;
+        o->on = e->on;
+        o->has_level = (e->flags & HUB_SCENE_F_LEVEL) != 0;
+        o->level = e->level;
+        o->has_color_temp_mireds = (e->flags & HUB_SCENE_F_COLOR_TEMP) != 0;
+        o->color_temp_mireds = e->color_mireds;
+    }
+    out->groups = scene->n_groups;
+    out->last_ops = st.last_ops;
+    out->last_apply_ms = st.last_apply_ms;
+    out->predicted_ms = st.predicted_ms;
+    out->applied_count = st.applied_count;
+
+    pb_ostream_t os = pb_ostream_from_buffer(buf, hub_v1_Scene_size);
+    const bool ok = pb_encode(&os, hub_v1_Scene_fields, out);
+    esp_err_t ret = ESP_OK;
+    if (!ok) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "encode failed");
+    } else {
+        httpd_resp_set_type(req, "application/x-protobuf");
+        ret = httpd_resp_send(req, (const char *)buf, (ssize_t)os.bytes_written);
+    }
+    free(scene);
+    free(out);
+    free(buf);
+    return ret;
+}
+
+static esp_err_t scene_delete(httpd_req_t *req) {
+    uint16_t id = 0;
+    if (!parse_scene_id(req, &id)) return ESP_OK;
+
+    const esp_err_t err = hub_scene_delete(id);
+    if (err == ESP_ERR_NOT_FOUND) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "unknown scene");
+        return ESP_OK;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "delete failed");
+        return ESP_OK;
+    }
+    return send_reply_ok(req);
+}
+
+static uint8_t telemetry_attr_from_name(const char *s) {
+    if (strcmp(s, "on") == 0) return HUB_TS_ATTR_ON;
+    if (strcmp(s, "level") == 0) return HUB_TS_ATTR_LEVEL;
+    if (strcmp(s, "power_w") == 0) return HUB_TS_ATTR_POWER_W;
+    if (strcmp(s, "temperature_c") == 0) return HUB_TS_ATTR_TEMPERATURE_C;
+    if (strcmp(s, "color_temp") == 0) return HUB_TS_ATTR_COLOR_TEMP;
+    return 0;
+}
+
+// Optional unsigned query parameter: false only if present and malformed.
+static bool query_u32(const char *query, const char *key, uint32_t *out) {
+    char val[16];
+    const esp_err_t err = httpd_query_key_value(query, key, val, sizeof(val));
+    if (err == ESP_ERR_NOT_FOUND) return true;
+    if (err != ESP_OK) return false;
+    char *end = NULL;
+    errno = 0;
+    const unsigned long v = strtoul(val, &end, 10);
+    if (end == val || *end != '\0' || errno != 0 || v > UINT32_MAX) return false;
+    *out = (uint32_t)v;
+    return true;
+}
+
+// GET /v1/telemetry/{device_id}?attr=<name>[&tier=1s|1m|1h][&from=t][&to=t][&last=seconds]
+// Streams a hub.v1.TelemetrySeries: header fields, then points as they are read.
+static esp_err_t telemetry_get(httpd_req_t *req) {
+    char path[48];
+    const size_t plen = strcspn(req->uri, "?");
+    uint32_t id = 0;
+    if (plen < sizeof(path)) {
+        memcpy(path, req->uri, plen);
+        path[plen] = '\0';
+    }
+    if (plen >= sizeof(path) || !parse_u32_path_param(path, "/v1/telemetry/", "", &id) || id == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad id");
+        return ESP_OK;
+    }
+
+    char query[128] = {0};
+    (void)httpd_req_get_url_query_str(req, query, sizeof(query));
+    char val[16];
+    uint8_t attr = 0;
+    if (httpd_query_key_value(query, "attr", val, sizeof(val)) == ESP_OK) attr = telemetry_attr_from_name(val);
+    if (attr == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "attr must be on|level|power_w|temperature_c|color_temp");
+        return ESP_OK;
+    }
+    hub_tsdb_tier_t tier = HUB_TSDB_TIER_1M;
+    if (httpd_query_key_value(query, "tier", val, sizeof(val)) == ESP_OK) {
+        if (strcmp(val, "1s") == 0) {
+            tier = HUB_TSDB_TIER_1S;
+        } else if (strcmp(val, "1m") == 0) {
+            tier = HUB_TSDB_TIER_1M;
+        } else if (strcmp(val, "1h") == 0) {
+            tier = HUB_TSDB_TIER_1H;
+        } else {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "tier must be 1s|1m|1h");
+            return ESP_OK;
+        }
+    }
+
+    const uint32_t now = hub_telemetry_now();
+    uint32_t from = 0, to = UINT32_MAX, last = 0;
+    if (!query_u32(query, "from", &from) || !query_u32(query, "to", &to) || !query_u32(query, "last", &last)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "from/to/last must be unsigned integers");
+        return ESP_OK;
+    }
+    if (last) from = (now > last) ? now - last : 0;
+    if (from > to) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "from > to");
+        return ESP_OK;
+    }
+    if (hub_telemetry_has_series(id, attr) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "no telemetry");
+        return ESP_OK;
+    }
+
+    httpd_resp_set_type(req, "application/x-protobuf");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    uint8_t chunk[512];
+    size_t used = 0;
+    if (!hub_tsdb_encode_series_header(id, attr, hub_tsdb_period_s(tier), now, chunk, sizeof(chunk), &used)) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "encode failed");
+        return ESP_OK;
+    }
+
+    // The store lock is held per read of 32 points, never across a send.
+    hub_tsdb_point_t pts[32];
+    uint32_t cursor = from;
+    size_t n;
+    esp_err_t err = ESP_OK;
+    while (err == ESP_OK && (n = hub_telemetry_read(id, attr, tier, &cursor, to, pts, 32)) > 0) {
+        for (size_t i = 0; i < n && err == ESP_OK; i++) {
+            if (sizeof(chunk) - used < HUB_TSDB_POINT_ENTRY_MAX) {
+                err = httpd_resp_send_chunk(req, (const char *)chunk, (ssize_t)used);
+                used = 0;
+            }
+            size_t len = 0;
+            if (err == ESP_OK && hub_tsdb_encode_point_entry(&pts[i], chunk + used, sizeof(chunk) - used, &len)) {
+                used += len;
+            }
+        }
+    }
+    if (err == ESP_OK && used) err = httpd_resp_send_chunk(req, (const char *)chunk, (ssize_t)used);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "telemetry response aborted: %s", esp_err_to_name(err));
+        return err;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
 #if CONFIG_TUTORIAL_0029_ENABLE_WS_PB
 static esp_err_t events_ws_handler(httpd_req_t *req) {
     const int fd = httpd_req_to_sockfd(req);
     if (req->method == HTTP_GET) {
-        ws_client_add(fd);
+        ws_client_add(fd, true);
         ESP_LOGI(TAG, "ws connected fd=%d", fd);
+        // Send the current state now rather than on the next bus event.
+        hub_stream_kick();
         return ESP_OK;
     }
 
     // Called for websocket DATA frames (and optionally control frames, depending on registration flags).
     // We keep this endpoint read-only, but we still drain incoming frames so well-behaved clients
     // (that send pings or other frames) don't back up the socket receive buffer.
-    ws_client_add(fd);
+    ws_client_add(fd, false);
 
     httpd_ws_frame_t frame = {0};
     esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
@@ -752,6 +1114,8 @@ esp_err_t hub_http_start(void) {
     s_ws_clients_n_cached = 0;
 #endif
 
+    s_etag_boot = esp_random();
+
     httpd_config_t cfg = HTTPD_DEFAULT_CONFIG();
     cfg.uri_match_fn = httpd_uri_match_wildcard;
     cfg.max_uri_handlers = 16;
@@ -792,6 +1156,15 @@ esp_err_t hub_http_start(void) {
     httpd_uri_t scene_u = {.uri = "/v1/scenes/*", .method = HTTP_POST, .handler = scenes_post_subroute, .user_ctx = NULL};
     httpd_register_uri_handler(s_server, &scene_u);
 
+    httpd_uri_t scene_get_u = {.uri = "/v1/scenes/*", .method = HTTP_GET, .handler = scene_get, .user_ctx = NULL};
+    httpd_register_uri_handler(s_server, &scene_get_u);
+
+    httpd_uri_t scene_del_u = {.uri = "/v1/scenes/*", .method = HTTP_DELETE, .handler = scene_delete, .user_ctx = NULL};
+    httpd_register_uri_handler(s_server, &scene_del_u);
+
+    httpd_uri_t telemetry_u = {.uri = "/v1/telemetry/*", .method = HTTP_GET, .handler = telemetry_get, .user_ctx = NULL};
+    httpd_register_uri_handler(s_server, &telemetry_u);
+
 #if CONFIG_TUTORIAL_0029_ENABLE_WS_PB
     httpd_uri_t ws = {
         .uri = "/v1/events/ws",
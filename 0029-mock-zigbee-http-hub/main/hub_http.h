@@ -11,5 +11,12 @@ void hub_http_stop(void);
 // Broadcast a protobuf message to any connected event-stream clients (binary WS frames).
 esp_err_t hub_http_events_broadcast_pb(const uint8_t *data, size_t len);
 
+// Send a protobuf message to one event-stream client (binary WS frame).
+esp_err_t hub_http_events_send_pb(int fd, const uint8_t *data, size_t len);
+
+// Copies the socket fds of connected event-stream clients and their connection serials
+// (out_serials may be NULL; a serial changes when an fd is reused); returns the count.
+size_t hub_http_events_clients(int *out_fds, uint32_t *out_serials, size_t max_out);
+
 // Best-effort client count (for gating work upstream).
 size_t hub_http_events_client_count(void);
@@ -20,6 +20,7 @@
 #include "pb_encode.h"
 
 #include "hub_events.pb.h"
+#include "hub_scene_plan.h"
 #include "hub_types.h"
 
 static const char *TAG = "hub_pb_0029";
@@ -56,6 +57,7 @@ void hub_pb_fill_device(hub_v1_Device *out, const hub_device_t *d) {
     out->level = (uint32_t)d->level;
     out->power_w = d->power_w;
     out->temperature_c = d->temperature_c;
+    out->color_temp_mireds = d->color_mireds;
 }
 
 bool hub_pb_build_event(int32_t id, const void *data, hub_v1_HubEvent *out) {
@@ -109,6 +111,9 @@ bool hub_pb_build_event(int32_t id, const void *data, hub_v1_HubEvent *out) {
         ev.payload.cmd_device_set.on = cmd->on;
         ev.payload.cmd_device_set.has_level = cmd->has_level;
         ev.payload.cmd_device_set.level = (uint32_t)cmd->level;
+        ev.payload.cmd_device_set.has_color_temp = cmd->has_color;
+        ev.payload.cmd_device_set.color_temp_mireds = cmd->color_mireds;
+        ev.payload.cmd_device_set.transition_ds = cmd->transition_ds;
     } else if (id == HUB_CMD_DEVICE_INTERVIEW) {
         const hub_cmd_device_interview_t *cmd = (const hub_cmd_device_interview_t *)data;
         if (!cmd) return false;
@@ -121,6 +126,19 @@ bool hub_pb_build_event(int32_t id, const void *data, hub_v1_HubEvent *out) {
         ev.which_payload = hub_v1_HubEvent_cmd_scene_trigger_tag;
         ev.payload.cmd_scene_trigger.req_id = (uint64_t)cmd->hdr.req_id;
         ev.payload.cmd_scene_trigger.scene_id = cmd->scene_id;
+    } else if (id == HUB_CMD_GROUP_SET) {
+        const hub_cmd_group_set_t *cmd = (const hub_cmd_group_set_t *)data;
+        if (!cmd) return false;
+        ev.which_payload = hub_v1_HubEvent_cmd_group_set_tag;
+        ev.payload.cmd_group_set.req_id = (uint64_t)cmd->hdr.req_id;
+        ev.payload.cmd_group_set.group_id = cmd->group_id;
+        ev.payload.cmd_group_set.has_on = (cmd->flags & HUB_SCENE_F_ON) != 0;
+        ev.payload.cmd_group_set.on = cmd->on;
+        ev.payload.cmd_group_set.has_level = (cmd->flags & HUB_SCENE_F_LEVEL) != 0;
+        ev.payload.cmd_group_set.level = (uint32_t)cmd->level;
+        ev.payload.cmd_group_set.has_color_temp_mireds = (cmd->flags & HUB_SCENE_F_COLOR_TEMP) != 0;
+        ev.payload.cmd_group_set.color_temp_mireds = cmd->color_mireds;
+        ev.payload.cmd_group_set.transition_ds = cmd->transition_ds;
     } else {
         return false;
     }
@@ -1,7 +1,11 @@
 /*
  * In-memory device registry for tutorial 0029.
  *
- * Keeps the demo simple: a bounded list protected by a mutex.
+ * Devices live in a dense heap array (CONFIG_TUTORIAL_0029_REGISTRY_MAX_DEVICES
+ * entries, optionally in PSRAM) protected by a mutex. An open-addressing hash
+ * index maps device id -> array position, so get/update/remove are O(1)
+ * expected instead of a linear scan. A generation counter changes on every
+ * mutation, so readers can tell whether an earlier snapshot is still current.
  * Persistence (NVS snapshot) is intentionally deferred for a later step.
  */
 
@@ -13,15 +17,36 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 
+#include "sdkconfig.h"
+
+#define HUB_REGISTRY_MAX_DEVICES CONFIG_TUTORIAL_0029_REGISTRY_MAX_DEVICES
+
 static const char *TAG = "hub_registry_0029";
 
 static SemaphoreHandle_t s_mu = NULL;
 
-static hub_device_t s_devices[32];
+static hub_device_t *s_devices = NULL;
 static size_t s_n = 0;
 static uint32_t s_next_id = 1;
+static uint32_t s_generation = 0;
+
+// Index entry = position in s_devices + 1, 0 = empty. Linear probing, at most half full.
+static uint16_t *s_index = NULL;
+static size_t s_index_mask = 0;
+
+static void *alloc_table(size_t bytes) {
+    void *p = NULL;
+#if CONFIG_TUTORIAL_0029_REGISTRY_IN_PSRAM
+    p = heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!p) {
+        p = heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+    }
+    return p;
+}
 
 esp_err_t hub_registry_init(void) {
     if (!s_mu) {
@@ -30,25 +55,75 @@ esp_err_t hub_registry_init(void) {
     if (!s_mu) {
         return ESP_ERR_NO_MEM;
     }
+    if (s_devices) {
+        return ESP_OK;
+    }
+
+    size_t index_size = 1;
+    while (index_size < 2 * (size_t)HUB_REGISTRY_MAX_DEVICES) {
+        index_size <<= 1;
+    }
+    hub_device_t *devices = alloc_table(HUB_REGISTRY_MAX_DEVICES * sizeof(*devices));
+    uint16_t *index = alloc_table(index_size * sizeof(*index));
+    if (!devices || !index) {
+        heap_caps_free(devices);
+        heap_caps_free(index);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    s_devices = devices;
+    s_index = index;
+    s_index_mask = index_size - 1;
+    xSemaphoreGive(s_mu);
+
+    ESP_LOGI(TAG, "registry ready (max_devices=%d)", HUB_REGISTRY_MAX_DEVICES);
     return ESP_OK;
 }
 
+static inline size_t id_hash(uint32_t id) {
+    return (size_t)(id * 0x9E3779B1u) & s_index_mask;
+}
+
+// Index slot of `id`, or of the empty slot where it would go.
+static size_t index_slot(uint32_t id) {
+    size_t i = id_hash(id);
+    while (s_index[i] != 0 && s_devices[s_index[i] - 1].id != id) {
+        i = (i + 1) & s_index_mask;
+    }
+    return i;
+}
+
 static int find_idx_by_id(uint32_t id) {
-    for (size_t i = 0; i < s_n; i++) {
-        if (s_devices[i].id == id) {
-            return (int)i;
+    const uint16_t v = s_index[index_slot(id)];
+    return v ? (int)v - 1 : -1;
+}
+
+// Backward-shift deletion keeps probe chains short under add/remove churn (no tombstones).
+static void index_erase_slot(size_t hole) {
+    size_t j = hole;
+    for (;;) {
+        j = (j + 1) & s_index_mask;
+        if (s_index[j] == 0) {
+            break;
+        }
+        const size_t home = id_hash(s_devices[s_index[j] - 1].id);
+        const bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!stays) {
+            s_index[hole] = s_index[j];
+            hole = j;
         }
     }
-    return -1;
+    s_index[hole] = 0;
 }
 
 esp_err_t hub_registry_add(const hub_device_t *in, hub_device_t *out_created) {
-    if (!s_mu || !in || !out_created) {
+    if (!s_mu || !s_devices || !in || !out_created) {
         return ESP_ERR_INVALID_STATE;
     }
 
     xSemaphoreTake(s_mu, portMAX_DELAY);
-    if (s_n >= (sizeof(s_devices) / sizeof(s_devices[0]))) {
+    if (s_n >= HUB_REGISTRY_MAX_DEVICES) {
         xSemaphoreGive(s_mu);
         return ESP_ERR_NO_MEM;
     }
@@ -59,7 +134,10 @@ esp_err_t hub_registry_add(const hub_device_t *in, hub_device_t *out_created) {
     // Ensure name is always NUL-terminated.
     d.name[sizeof(d.name) - 1] = '\0';
 
-    s_devices[s_n++] = d;
+    s_devices[s_n] = d;
+    s_index[index_slot(d.id)] = (uint16_t)(s_n + 1);
+    s_n++;
+    s_generation++;
     *out_created = d;
     xSemaphoreGive(s_mu);
 
@@ -69,7 +147,7 @@ esp_err_t hub_registry_add(const hub_device_t *in, hub_device_t *out_created) {
 }
 
 esp_err_t hub_registry_get(uint32_t id, hub_device_t *out) {
-    if (!s_mu || !out) {
+    if (!s_mu || !s_devices || !out) {
         return ESP_ERR_INVALID_STATE;
     }
     xSemaphoreTake(s_mu, portMAX_DELAY);
@@ -84,7 +162,7 @@ esp_err_t hub_registry_get(uint32_t id, hub_device_t *out) {
 }
 
 esp_err_t hub_registry_update(uint32_t id, const hub_device_t *in) {
-    if (!s_mu || !in) {
+    if (!s_mu || !s_devices || !in) {
         return ESP_ERR_INVALID_STATE;
     }
     xSemaphoreTake(s_mu, portMAX_DELAY);
@@ -98,30 +176,57 @@ esp_err_t hub_registry_update(uint32_t id, const hub_device_t *in) {
     d.id = id;
     d.name[sizeof(d.name) - 1] = '\0';
     s_devices[(size_t)idx] = d;
+    s_generation++;
 
     xSemaphoreGive(s_mu);
     return ESP_OK;
 }
 
 esp_err_t hub_registry_remove(uint32_t id) {
-    if (!s_mu) {
+    if (!s_mu || !s_devices) {
         return ESP_ERR_INVALID_STATE;
     }
     xSemaphoreTake(s_mu, portMAX_DELAY);
-    int idx = find_idx_by_id(id);
-    if (idx < 0) {
+    const size_t slot = index_slot(id);
+    if (s_index[slot] == 0) {
         xSemaphoreGive(s_mu);
         return ESP_ERR_NOT_FOUND;
     }
-    const size_t i = (size_t)idx;
-    s_devices[i] = s_devices[s_n - 1];
+    const size_t i = (size_t)s_index[slot] - 1;
+    index_erase_slot(slot);
+
+    // Move the last device into the hole and repoint its index entry.
+    const size_t last = s_n - 1;
+    if (i != last) {
+        s_index[index_slot(s_devices[last].id)] = (uint16_t)(i + 1);
+        s_devices[i] = s_devices[last];
+    }
     s_n--;
+    s_generation++;
     xSemaphoreGive(s_mu);
     return ESP_OK;
 }
 
+uint32_t hub_registry_generation(void) {
+    if (!s_mu) {
+        return 0;
+    }
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    const uint32_t gen = s_generation;
+    xSemaphoreGive(s_mu);
+    return gen;
+}
+
+size_t hub_registry_capacity(void) {
+    return HUB_REGISTRY_MAX_DEVICES;
+}
+
 esp_err_t hub_registry_snapshot(hub_device_t *out, size_t max_out, size_t *out_n) {
-    if (!s_mu || !out_n) {
+    return hub_registry_snapshot_gen(out, max_out, out_n, NULL);
+}
+
+esp_err_t hub_registry_snapshot_gen(hub_device_t *out, size_t max_out, size_t *out_n, uint32_t *out_generation) {
+    if (!s_mu || !s_devices || !out_n) {
         return ESP_ERR_INVALID_STATE;
     }
     if (max_out > 0 && !out) {
@@ -130,10 +235,13 @@ esp_err_t hub_registry_snapshot(hub_device_t *out, size_t max_out, size_t *out_n
 
     xSemaphoreTake(s_mu, portMAX_DELAY);
     const size_t n = (s_n < max_out) ? s_n : max_out;
-    for (size_t i = 0; i < n; i++) {
-        out[i] = s_devices[i];
+    if (n > 0) {
+        memcpy(out, s_devices, n * sizeof(*out));
     }
     *out_n = n;
+    if (out_generation) {
+        *out_generation = s_generation;
+    }
     xSemaphoreGive(s_mu);
     return ESP_OK;
 }
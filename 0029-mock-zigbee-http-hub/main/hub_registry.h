@@ -13,6 +13,12 @@ esp_err_t hub_registry_get(uint32_t id, hub_device_t *out);
 esp_err_t hub_registry_update(uint32_t id, const hub_device_t *in);
 esp_err_t hub_registry_remove(uint32_t id);
 
-// Snapshot API for HTTP responses.
-esp_err_t hub_registry_snapshot(hub_device_t *out, size_t max_out, size_t *out_n);
+// Changes on every add/update/remove; equal generations mean equal contents.
+uint32_t hub_registry_generation(void);
+size_t hub_registry_capacity(void);
 
+// Snapshot API for HTTP responses. The copy is taken under the lock; callers
+// serialize it afterwards without holding anything.
+esp_err_t hub_registry_snapshot(hub_device_t *out, size_t max_out, size_t *out_n);
+// Same, also returning the generation the copy belongs to (out_generation may be NULL).
+esp_err_t hub_registry_snapshot_gen(hub_device_t *out, size_t max_out, size_t *out_n, uint32_t *out_generation);
@@ -0,0 +1,191 @@
+/*
+ * Reply slots for hub bus commands (tutorial 0029).
+ *
+ * Every slot owns a binary semaphore created once at init, so a request costs
+ * no heap allocation. Slot state is guarded by one mutex; the bus handler only
+ * gives a slot's semaphore while holding it and only if the request id still
+ * matches, and the waiter clears the id (and any pending give) under the same
+ * mutex when it frees the slot. A reply racing a timeout is therefore either
+ * delivered or counted as late, never written into the next request's slot.
+ */
+
+#include "hub_reply.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+
+#include "sdkconfig.h"
+
+#define HUB_REPLY_SLOTS CONFIG_TUTORIAL_0029_REPLY_SLOTS
+
+// req_id = generation << 8 | slot index; generation starts at 1 so ids are never 0.
+#define REQ_SLOT_BITS 8
+#define REQ_SLOT_MASK ((1u << REQ_SLOT_BITS) - 1u)
+
+_Static_assert(HUB_REPLY_SLOTS <= REQ_SLOT_MASK, "reply slot index must fit the request id");
+
+static const char *TAG = "hub_reply_0029";
+
+typedef struct {
+    uint32_t req_id; // 0 = free
+    uint32_t gen;
+    bool ready;
+    SemaphoreHandle_t done;
+    hub_reply_device_t result;
+} reply_slot_t;
+
+static SemaphoreHandle_t s_mu = NULL;
+static SemaphoreHandle_t s_free = NULL; // counts free slots
+static reply_slot_t s_slots[HUB_REPLY_SLOTS];
+static hub_reply_stats_t s_stats = {0};
+
+esp_err_t hub_reply_init(void) {
+    if (s_mu) return ESP_OK;
+
+    for (size_t i = 0; i < HUB_REPLY_SLOTS; i++) {
+        if (!s_slots[i].done) {
+            s_slots[i].done = xSemaphoreCreateBinary();
+        }
+        if (!s_slots[i].done) return ESP_ERR_NO_MEM;
+    }
+    if (!s_free) {
+        s_free = xSemaphoreCreateCounting(HUB_REPLY_SLOTS, HUB_REPLY_SLOTS);
+    }
+    if (!s_free) return ESP_ERR_NO_MEM;
+
+    SemaphoreHandle_t mu = xSemaphoreCreateMutex();
+    if (!mu) return ESP_ERR_NO_MEM;
+    s_stats.slots = HUB_REPLY_SLOTS;
+    s_mu = mu;
+
+    ESP_LOGI(TAG, "reply slots: %d", HUB_REPLY_SLOTS);
+    return ESP_OK;
+}
+
+static reply_slot_t *slot_for(uint32_t req_id) {
+    const uint32_t idx = req_id & REQ_SLOT_MASK;
+    if (req_id == 0 || idx >= HUB_REPLY_SLOTS) return NULL;
+    return &s_slots[idx];
+}
+
+// Caller holds s_mu and owns the slot.
+static void free_slot_locked(reply_slot_t *s) {
+    s->req_id = 0;
+    s->ready = false;
+    // Drop a give that raced the timeout so the next request starts clean.
+    (void)xSemaphoreTake(s->done, 0);
+    s_stats.in_use--;
+}
+
+esp_err_t hub_reply_acquire(TickType_t timeout, uint32_t *out_req_id) {
+    if (!out_req_id) return ESP_ERR_INVALID_ARG;
+    *out_req_id = 0;
+    if (!s_mu) return ESP_ERR_INVALID_STATE;
+
+    if (xSemaphoreTake(s_free, timeout) != pdTRUE) {
+        xSemaphoreTake(s_mu, portMAX_DELAY);
+        s_stats.busy++;
+        xSemaphoreGive(s_mu);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    for (uint32_t i = 0; i < HUB_REPLY_SLOTS; i++) {
+        reply_slot_t *s = &s_slots[i];
+        if (s->req_id != 0) continue;
+
+        s->gen = (s->gen + 1u) & (UINT32_MAX >> REQ_SLOT_BITS);
+        if (s->gen == 0) s->gen = 1;
+        s->req_id = (s->gen << REQ_SLOT_BITS) | i;
+        s->ready = false;
+        memset(&s->result, 0, sizeof(s->result));
+        s_stats.acquired++;
+        s_stats.in_use++;
+        if (s_stats.in_use > s_stats.in_use_max) s_stats.in_use_max = s_stats.in_use;
+        *out_req_id = s->req_id;
+        break;
+    }
+    xSemaphoreGive(s_mu);
+
+    // s_free guarantees a free slot; anything else is a bookkeeping bug.
+    if (*out_req_id == 0) {
+        xSemaphoreGive(s_free);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t hub_reply_wait(uint32_t req_id, TickType_t timeout, hub_reply_device_t *out) {
+    reply_slot_t *s = slot_for(req_id);
+    if (!s || !s_mu) return ESP_ERR_INVALID_ARG;
+
+    (void)xSemaphoreTake(s->done, timeout);
+
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    if (s->req_id != req_id) {
+        xSemaphoreGive(s_mu);
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Checked under the lock: a reply that landed just after the take timed out still counts.
+    if (s->ready) {
+        if (out) *out = s->result;
+    } else {
+        s_stats.timeouts++;
+        err = ESP_ERR_TIMEOUT;
+    }
+    free_slot_locked(s);
+    xSemaphoreGive(s_mu);
+
+    xSemaphoreGive(s_free);
+    return err;
+}
+
+void hub_reply_release(uint32_t req_id) {
+    reply_slot_t *s = slot_for(req_id);
+    if (!s || !s_mu) return;
+
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    const bool owned = s->req_id == req_id;
+    if (owned) free_slot_locked(s);
+    xSemaphoreGive(s_mu);
+
+    if (owned) xSemaphoreGive(s_free);
+}
+
+void hub_reply_complete(uint32_t req_id, esp_err_t status, const hub_device_t *device) {
+    reply_slot_t *s = slot_for(req_id);
+    if (!s || !s_mu) return;
+
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    if (s->req_id != req_id || s->ready) {
+        s_stats.late_replies++;
+        xSemaphoreGive(s_mu);
+        return;
+    }
+    s->result.status = status;
+    s->result.device_id = device ? device->id : 0;
+    if (device) {
+        s->result.device = *device;
+    } else {
+        memset(&s->result.device, 0, sizeof(s->result.device));
+    }
+    s->ready = true;
+    xSemaphoreGive(s->done);
+    xSemaphoreGive(s_mu);
+}
+
+void hub_reply_get_stats(hub_reply_stats_t *out) {
+    if (!out) return;
+    if (!s_mu) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    *out = s_stats;
+    xSemaphoreGive(s_mu);
+}
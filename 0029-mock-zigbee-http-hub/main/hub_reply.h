@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_err.h"
+
+#include "hub_types.h"
+
+// Request/response plumbing for commands posted to the hub bus (HTTP, console).
+//
+// A fixed pool of reply slots (CONFIG_TUTORIAL_0029_REPLY_SLOTS) replaces a
+// queue per request. hub_reply_acquire() hands out a slot as a request id to put
+// in hub_cmd_hdr_t.req_id; the bus handler completes it with hub_reply_complete()
+// and the caller collects the result with hub_reply_wait(), which always frees
+// the slot. The id carries a per-slot generation, so a reply arriving after its
+// waiter timed out is recognised and dropped instead of landing in a reused slot.
+
+esp_err_t hub_reply_init(void);
+
+// Reserves a slot, waiting up to timeout for one to free up.
+// ESP_ERR_TIMEOUT: all slots busy. ESP_ERR_INVALID_STATE: not initialised.
+esp_err_t hub_reply_acquire(TickType_t timeout, uint32_t *out_req_id);
+
+// Waits for the reply to req_id, copies it to out and frees the slot.
+// ESP_ERR_TIMEOUT: no reply in time (the slot is freed; a late reply is dropped).
+esp_err_t hub_reply_wait(uint32_t req_id, TickType_t timeout, hub_reply_device_t *out);
+
+// Frees a slot without waiting (e.g. the command could not be posted).
+void hub_reply_release(uint32_t req_id);
+
+// Called by bus handlers. req_id 0 (no reply wanted) and stale ids are ignored.
+// device may be NULL.
+void hub_reply_complete(uint32_t req_id, esp_err_t status, const hub_device_t *device);
+
+typedef struct {
+    uint32_t acquired;
+    uint32_t busy;          // acquire timed out: all slots in use
+    uint32_t timeouts;      // waits that gave up before the reply
+    uint32_t late_replies;  // replies for an id that was already freed
+    uint32_t in_use;
+    uint32_t in_use_max;
+    uint32_t slots;
+} hub_reply_stats_t;
+
+void hub_reply_get_stats(hub_reply_stats_t *out);
@@ -0,0 +1,411 @@
+/*
+ * Scene engine for tutorial 0029: NVS-backed scene table + apply task.
+ *
+ * Expansion and pacing live in hub_scene_plan.c (host-tested); this file owns
+ * storage, the group table the HUB_CMD_GROUP_SET handler resolves members
+ * from, and the task that sends a scene's commands on schedule. The task runs
+ * outside the hub event loop so pacing delays never stall the bus.
+ */
+
+#include "hub_scene.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+#include "hub_bus.h"
+#include "hub_registry.h"
+#include "hub_reply.h"
+#include "hub_types.h"
+
+static const char *TAG = "hub_scene_0029";
+
+#define SCENE_NVS_NS "hub_scene"
+#define SCENE_QUEUE_LEN 4
+#define SCENE_MAX CONFIG_TUTORIAL_0029_SCENE_MAX
+
+#define SCENE_ALL_ON 1
+#define SCENE_ALL_OFF 2
+
+typedef struct {
+    bool used;
+    hub_scene_t scene;
+    hub_scene_stats_t stats;
+} scene_slot_t;
+
+typedef struct {
+    uint16_t id;
+    int64_t t0_us;
+} scene_trigger_t;
+
+static SemaphoreHandle_t s_mu = NULL;
+static scene_slot_t *s_slots = NULL;
+static hub_scene_stats_t s_builtin_stats[2];
+static QueueHandle_t s_q = NULL;
+static TaskHandle_t s_task = NULL;
+
+// Scene task only.
+static hub_scene_t s_work;
+static hub_scene_op_t s_ops[HUB_SCENE_MAX_OPS];
+
+static void lock(void) {
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+}
+
+static void unlock(void) {
+    xSemaphoreGive(s_mu);
+}
+
+static scene_slot_t *find_slot(uint16_t id) {
+    for (size_t i = 0; i < SCENE_MAX; i++) {
+        if (s_slots[i].used && s_slots[i].scene.id == id) return &s_slots[i];
+    }
+    return NULL;
+}
+
+static bool is_builtin(uint16_t id) {
+    return id == SCENE_ALL_ON || id == SCENE_ALL_OFF;
+}
+
+// Caller holds s_mu. NULL if id is neither a user scene nor a built-in.
+static hub_scene_stats_t *stats_for(uint16_t id) {
+    scene_slot_t *slot = find_slot(id);
+    if (slot) return &slot->stats;
+    if (is_builtin(id)) return &s_builtin_stats[id - SCENE_ALL_ON];
+    return NULL;
+}
+
+static void scene_key(uint16_t id, char *out, size_t cap) {
+    snprintf(out, cap, "s%u", (unsigned)id);
+}
+
+static void load_from_nvs(void) {
+    nvs_handle_t h = 0;
+    if (nvs_open(SCENE_NVS_NS, NVS_READONLY, &h) != ESP_OK) {
+        return; // namespace not created yet: no scenes saved
+    }
+
+    uint8_t blob[HUB_SCENE_BLOB_MAX];
+    size_t loaded = 0;
+    nvs_iterator_t it = NULL;
+    esp_err_t res = nvs_entry_find(NVS_DEFAULT_PART_NAME, SCENE_NVS_NS, NVS_TYPE_BLOB, &it);
+    while (res == ESP_OK && loaded < SCENE_MAX) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+
+        char *end = NULL;
+        const unsigned long id = strtoul(info.key + 1, &end, 10);
+        size_t len = sizeof(blob);
+        hub_scene_t *s = &s_slots[loaded].scene;
+        if (info.key[0] == 's' && end && *end == '\0' && id > 0 && id <= UINT16_MAX &&
+            nvs_get_blob(h, info.key, blob, &len) == ESP_OK && hub_scene_unpack((uint16_t)id, blob, len, s)) {
+            hub_scene_assign_groups(s, CONFIG_TUTORIAL_0029_SCENE_MIN_GROUP);
+            s_slots[loaded].used = true;
+            loaded++;
+        } else {
+            ESP_LOGW(TAG, "ignoring NVS entry %s", info.key);
+        }
+        res = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    nvs_close(h);
+    ESP_LOGI(TAG, "loaded %u scene(s) from NVS", (unsigned)loaded);
+}
+
+static esp_err_t nvs_store(const hub_scene_t *s) {
+    uint8_t blob[HUB_SCENE_BLOB_MAX];
+    const size_t len = hub_scene_pack(s, blob, sizeof(blob));
+    if (len == 0) return ESP_ERR_INVALID_SIZE;
+
+    nvs_handle_t h = 0;
+    esp_err_t err = nvs_open(SCENE_NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    char key[8];
+    scene_key(s->id, key, sizeof(key));
+    err = nvs_set_blob(h, key, blob, len);
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
+
+static esp_err_t nvs_erase(uint16_t id) {
+    nvs_handle_t h = 0;
+    esp_err_t err = nvs_open(SCENE_NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    char key[8];
+    scene_key(id, key, sizeof(key));
+    err = nvs_erase_key(h, key);
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
+
+esp_err_t hub_scene_save(const hub_scene_t *in) {
+    if (!in || in->id == 0 || in->id > HUB_SCENE_ID_MAX || in->n_entries > HUB_SCENE_MAX_ENTRIES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_mu) return ESP_ERR_INVALID_STATE;
+
+    hub_scene_t *s = malloc(sizeof(*s));
+    if (!s) return ESP_ERR_NO_MEM;
+    *s = *in;
+    s->name[sizeof(s->name) - 1] = '\0';
+    hub_scene_assign_groups(s, CONFIG_TUTORIAL_0029_SCENE_MIN_GROUP);
+
+    lock();
+    scene_slot_t *slot = find_slot(s->id);
+    for (size_t i = 0; !slot && i < SCENE_MAX; i++) {
+        if (!s_slots[i].used) slot = &s_slots[i];
+    }
+    esp_err_t err = slot ? nvs_store(s) : ESP_ERR_NO_MEM;
+    if (err == ESP_OK) {
+        slot->used = true;
+        slot->scene = *s;
+        memset(&slot->stats, 0, sizeof(slot->stats));
+    }
+    unlock();
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "saved scene %u \"%s\": %u entries, %u groups", (unsigned)s->id, s->name,
+                 (unsigned)s->n_entries, (unsigned)s->n_groups);
+    }
+    free(s);
+    return err;
+}
+
+esp_err_t hub_scene_delete(uint16_t id) {
+    if (!s_mu) return ESP_ERR_INVALID_STATE;
+    lock();
+    scene_slot_t *slot = find_slot(id);
+    esp_err_t err = slot ? nvs_erase(id) : ESP_ERR_NOT_FOUND;
+    if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+        memset(slot, 0, sizeof(*slot));
+        err = ESP_OK;
+    }
+    unlock();
+    return err;
+}
+
+esp_err_t hub_scene_get(uint16_t id, hub_scene_t *out, hub_scene_stats_t *stats) {
+    if (!s_mu) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = ESP_OK;
+    lock();
+    scene_slot_t *slot = find_slot(id);
+    if (slot) {
+        if (out) *out = slot->scene;
+        if (stats) *stats = slot->stats;
+    } else if (is_builtin(id)) {
+        if (out) {
+            memset(out, 0, sizeof(*out));
+            out->id = id;
+            strlcpy(out->name, id == SCENE_ALL_ON ? "all_on" : "all_off", sizeof(out->name));
+        }
+        if (stats) *stats = s_builtin_stats[id - SCENE_ALL_ON];
+    } else {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    unlock();
+    return err;
+}
+
+size_t hub_scene_list(hub_scene_info_t *out, size_t max_out) {
+    if (!s_mu || !out) return 0;
+    size_t n = 0;
+    lock();
+    for (size_t i = 0; i < SCENE_MAX && n < max_out; i++) {
+        if (!s_slots[i].used) continue;
+        const hub_scene_t *s = &s_slots[i].scene;
+        hub_scene_info_t *info = &out[n++];
+        info->id = s->id;
+        strlcpy(info->name, s->name, sizeof(info->name));
+        info->n_entries = s->n_entries;
+        info->n_groups = s->n_groups;
+        info->stats = s_slots[i].stats;
+    }
+    unlock();
+    return n;
+}
+
+size_t hub_scene_group_members(uint16_t group_id, uint32_t *out_ids, size_t max_out) {
+    if (!s_mu || !out_ids) return 0;
+    size_t n = 0;
+    lock();
+    for (size_t i = 0; i < SCENE_MAX && n == 0; i++) {
+        if (!s_slots[i].used) continue;
+        const hub_scene_t *s = &s_slots[i].scene;
+        for (size_t g = 0; g < s->n_groups; g++) {
+            if (s->groups[g].group_id != group_id) continue;
+            for (size_t k = 0; k < s->n_entries && n < max_out; k++) {
+                if (s->groups[g].members & (1u << k)) out_ids[n++] = s->entries[k].device_id;
+            }
+            break;
+        }
+    }
+    unlock();
+    return n;
+}
+
+esp_err_t hub_scene_trigger(uint16_t id) {
+    if (!s_q) return ESP_ERR_INVALID_STATE;
+    lock();
+    const bool known = stats_for(id) != NULL;
+    unlock();
+    if (!known) return ESP_ERR_NOT_FOUND;
+
+    const scene_trigger_t t = {.id = id, .t0_us = esp_timer_get_time()};
+    return xQueueSend(s_q, &t, 0) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+// Builds s_ops for the scene. Returns 0 if it was deleted since the trigger.
+static size_t build_plan(uint16_t id, hub_scene_plan_stats_t *st) {
+    lock();
+    scene_slot_t *slot = find_slot(id);
+    if (slot) s_work = slot->scene;
+    unlock();
+
+    if (!slot) {
+        if (!is_builtin(id)) return 0;
+        return hub_scene_plan_all(id == SCENE_ALL_ON, s_ops, HUB_SCENE_MAX_OPS, st);
+    }
+
+    const size_t cap = hub_registry_capacity();
+    hub_device_t *snap = calloc(cap, sizeof(*snap));
+    if (!snap) return 0;
+    size_t n_devs = 0;
+    size_t n = 0;
+    if (hub_registry_snapshot(snap, cap, &n_devs) == ESP_OK) {
+        const hub_scene_plan_cfg_t cfg = {
+            .burst = CONFIG_TUTORIAL_0029_SCENE_UNICAST_BURST,
+            .interval_ms = CONFIG_TUTORIAL_0029_SCENE_UNICAST_INTERVAL_MS,
+            .min_group = CONFIG_TUTORIAL_0029_SCENE_MIN_GROUP,
+        };
+        n = hub_scene_plan(&s_work, snap, n_devs, &cfg, s_ops, HUB_SCENE_MAX_OPS, st);
+    }
+    free(snap);
+    return n;
+}
+
+static esp_err_t post_op(const hub_scene_op_t *op, uint32_t req_id) {
+    esp_event_loop_handle_t loop = hub_bus_get_loop();
+    if (op->kind == HUB_SCENE_OP_GROUP) {
+        hub_cmd_group_set_t cmd = {
+            .hdr = {.req_id = req_id},
+            .group_id = op->group_id,
+            .flags = op->flags,
+            .on = op->on,
+            .level = op->level,
+            .color_mireds = op->color_mireds,
+            .transition_ds = op->transition_ds,
+        };
+        return esp_event_post_to(loop, HUB_EVT, HUB_CMD_GROUP_SET, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
+    }
+    hub_cmd_device_set_t cmd = {
+        .hdr = {.req_id = req_id},
+        .device_id = op->device_id,
+        .has_on = (op->flags & HUB_SCENE_F_ON) != 0,
+        .on = op->on,
+        .has_level = (op->flags & HUB_SCENE_F_LEVEL) != 0,
+        .level = op->level,
+        .has_color = (op->flags & HUB_SCENE_F_COLOR_TEMP) != 0,
+        .color_mireds = op->color_mireds,
+        .transition_ds = op->transition_ds,
+    };
+    return esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_SET, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
+}
+
+static void apply_scene(const scene_trigger_t *t) {
+    hub_scene_plan_stats_t st = {0};
+    const size_t n = build_plan(t->id, &st);
+
+    uint16_t failed = 0;
+    const TickType_t start = xTaskGetTickCount();
+    for (size_t i = 0; i < n; i++) {
+        const TickType_t due = start + pdMS_TO_TICKS(s_ops[i].at_ms);
+        const TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(due - now) > 0) vTaskDelay(due - now);
+
+        // The bus handles commands in order, so the reply to the last one marks
+        // the whole scene as applied.
+        uint32_t req_id = 0;
+        const bool last = (i + 1 == n);
+        if (last && hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) req_id = 0;
+        if (post_op(&s_ops[i], req_id) != ESP_OK) {
+            failed++;
+            if (req_id) hub_reply_release(req_id);
+            req_id = 0;
+        }
+        if (req_id) {
+            hub_reply_device_t rep = {0};
+            (void)hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep);
+        }
+    }
+    const uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - t->t0_us) / 1000);
+
+    lock();
+    hub_scene_stats_t *stats = stats_for(t->id);
+    if (!stats) {
+        unlock(); // deleted after the trigger
+        return;
+    }
+    stats->applied_count++;
+    stats->last_apply_ms = elapsed_ms;
+    stats->predicted_ms = st.predicted_ms;
+    stats->last_ops = st.ops;
+    stats->last_group_ops = st.group_ops;
+    stats->last_skipped = st.skipped;
+    stats->last_failed = failed;
+    unlock();
+
+    ESP_LOGI(TAG, "scene %u applied in %" PRIu32 " ms (ops=%u group=%u unicast=%u skipped=%u failed=%u predicted=%" PRIu32
+                  " ms)",
+             (unsigned)t->id, elapsed_ms, (unsigned)st.ops, (unsigned)st.group_ops, (unsigned)st.unicast_ops,
+             (unsigned)st.skipped, (unsigned)failed, st.predicted_ms);
+}
+
+static void scene_task(void *arg) {
+    (void)arg;
+    scene_trigger_t t;
+    while (true) {
+        if (xQueueReceive(s_q, &t, portMAX_DELAY) == pdTRUE) {
+            apply_scene(&t);
+        }
+    }
+}
+
+esp_err_t hub_scene_init(void) {
+    if (s_task) return ESP_OK;
+
+    if (!s_mu) {
+        s_mu = xSemaphoreCreateMutex();
+        if (!s_mu) return ESP_ERR_NO_MEM;
+    }
+    if (!s_slots) {
+        s_slots = calloc(SCENE_MAX, sizeof(*s_slots));
+        if (!s_slots) return ESP_ERR_NO_MEM;
+        load_from_nvs();
+    }
+    if (!s_q) {
+        s_q = xQueueCreate(SCENE_QUEUE_LEN, sizeof(scene_trigger_t));
+        if (!s_q) return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t ok = xTaskCreate(scene_task, "hub_scene", 4096, NULL, 5, &s_task);
+    if (ok != pdPASS) {
+        s_task = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#include "hub_scene_plan.h"
+
+// Scene engine: user-defined scenes kept in RAM and persisted to NVS (one blob
+// per scene, see hub_scene_pack()), applied by a dedicated task.
+//
+// Saving a scene programs its groups (entries that share a target). Applying it
+// sends one HUB_CMD_GROUP_SET per usable group and paced HUB_CMD_DEVICE_SET
+// commands for the rest (CONFIG_TUTORIAL_0029_SCENE_UNICAST_*), then measures
+// trigger -> last command handled by the bus. Scene ids 1 and 2 are the built-in
+// all-on/all-off scenes unless a user scene with that id is saved.
+
+esp_err_t hub_scene_init(void);
+
+// Scene ids are 1..HUB_SCENE_ID_MAX (group ids are derived from them).
+#define HUB_SCENE_ID_MAX 0x0fffu
+
+// Stores s (replacing a scene with the same id). groups are recomputed.
+// ESP_ERR_INVALID_ARG: bad id or too many entries. ESP_ERR_NO_MEM: table full.
+esp_err_t hub_scene_save(const hub_scene_t *s);
+
+esp_err_t hub_scene_delete(uint16_t id);
+
+typedef struct {
+    uint32_t applied_count;
+    uint32_t last_apply_ms;  // trigger -> last command handled by the hub bus
+    uint32_t predicted_ms;   // from pacing alone (hub_scene_plan_stats_t)
+    uint16_t last_ops;
+    uint16_t last_group_ops;
+    uint16_t last_skipped;
+    uint16_t last_failed;    // commands that could not be posted to the bus
+} hub_scene_stats_t;
+
+// out/stats may be NULL. Built-in scenes have no entries.
+esp_err_t hub_scene_get(uint16_t id, hub_scene_t *out, hub_scene_stats_t *stats);
+
+typedef struct {
+    uint16_t id;
+    char name[HUB_SCENE_NAME_LEN];
+    uint8_t n_entries;
+    uint8_t n_groups;
+    hub_scene_stats_t stats;
+} hub_scene_info_t;
+
+// Lists user scenes (not the built-ins). Returns the number written.
+size_t hub_scene_list(hub_scene_info_t *out, size_t max_out);
+
+// Queues the scene for the scene task; does not wait for it to be applied.
+// ESP_ERR_NOT_FOUND: unknown scene. ESP_ERR_TIMEOUT: queue full.
+esp_err_t hub_scene_trigger(uint16_t id);
+
+// Device ids in a scene group (called by the HUB_CMD_GROUP_SET handler).
+// Returns the number written, 0 for an unknown group.
+size_t hub_scene_group_members(uint16_t group_id, uint32_t *out_ids, size_t max_out);
@@ -0,0 +1,234 @@
+/*
+ * Scene expansion and scheduling for tutorial 0029.
+ *
+ * A scene is a list of per-device targets. Entries that share a target are
+ * grouped when the scene is saved (the way a Zigbee hub programs group
+ * membership once), so applying the scene costs one group command per shared
+ * target plus one unicast command per remaining device. Commands are paced in
+ * bursts so a large scene doesn't flood the network.
+ */
+
+#include "hub_scene_plan.h"
+
+#include <string.h>
+
+#define BLOB_VERSION 1
+#define BLOB_HEADER 6
+#define BLOB_ENTRY 8
+#define BLOB_ENTRY_ON 0x80u
+
+static bool same_target(const hub_scene_entry_t *a, const hub_scene_entry_t *b) {
+    if (a->flags != b->flags) return false;
+    if ((a->flags & HUB_SCENE_F_ON) && a->on != b->on) return false;
+    if ((a->flags & HUB_SCENE_F_LEVEL) && a->level != b->level) return false;
+    if ((a->flags & HUB_SCENE_F_COLOR_TEMP) && a->color_mireds != b->color_mireds) return false;
+    return true;
+}
+
+static size_t entry_count(const hub_scene_t *s) {
+    return s->n_entries > HUB_SCENE_MAX_ENTRIES ? HUB_SCENE_MAX_ENTRIES : s->n_entries;
+}
+
+void hub_scene_assign_groups(hub_scene_t *s, size_t min_members) {
+    s->n_groups = 0;
+    memset(s->groups, 0, sizeof(s->groups));
+    if (min_members < 2) min_members = 2;
+
+    const size_t n_entries = entry_count(s);
+    uint32_t seen = 0;
+    for (size_t i = 0; i < n_entries && s->n_groups < HUB_SCENE_MAX_GROUPS; i++) {
+        if (seen & (1u << i)) continue;
+        uint32_t members = 1u << i;
+        for (size_t k = i + 1; k < n_entries; k++) {
+            if (!(seen & (1u << k)) && same_target(&s->entries[i], &s->entries[k])) members |= 1u << k;
+        }
+        seen |= members;
+        if ((size_t)__builtin_popcount(members) < min_members) continue;
+
+        hub_scene_group_t *g = &s->groups[s->n_groups];
+        g->group_id = (uint16_t)(((s->id & 0x0fffu) << 4) | s->n_groups);
+        g->members = members;
+        s->n_groups++;
+    }
+}
+
+static uint8_t supported_flags(uint32_t caps) {
+    uint8_t f = 0;
+    if (caps & HUB_CAP_ONOFF) f |= HUB_SCENE_F_ON;
+    if (caps & HUB_CAP_LEVEL) f |= HUB_SCENE_F_LEVEL;
+    if (caps & HUB_CAP_COLOR_TEMP) f |= HUB_SCENE_F_COLOR_TEMP;
+    return f;
+}
+
+static const hub_device_t *find_device(const hub_device_t *devs, size_t n, uint32_t id) {
+    for (size_t i = 0; i < n; i++) {
+        if (devs[i].id == id) return &devs[i];
+    }
+    return NULL;
+}
+
+static void schedule(const hub_scene_plan_cfg_t *cfg, hub_scene_op_t *op, size_t index) {
+    const size_t burst = cfg->burst ? cfg->burst : 1;
+    op->at_ms = (uint32_t)((index / burst) * cfg->interval_ms);
+}
+
+size_t hub_scene_plan(const hub_scene_t *s, const hub_device_t *devs, size_t n_devs, const hub_scene_plan_cfg_t *cfg,
+                      hub_scene_op_t *out, size_t max_out, hub_scene_plan_stats_t *stats) {
+    hub_scene_plan_stats_t st = {0};
+    uint8_t masked[HUB_SCENE_MAX_ENTRIES] = {0};
+    uint32_t present = 0;
+    const size_t n_entries = entry_count(s);
+
+    for (size_t i = 0; i < n_entries; i++) {
+        const hub_device_t *d = find_device(devs, n_devs, s->entries[i].device_id);
+        masked[i] = d ? (uint8_t)(s->entries[i].flags & supported_flags(d->caps)) : 0;
+        if (masked[i]) {
+            present |= 1u << i;
+            st.devices++;
+        } else {
+            st.skipped++;
+        }
+    }
+
+    size_t n = 0;
+    uint32_t covered = 0;
+    for (size_t gi = 0; gi < s->n_groups && n < max_out; gi++) {
+        const hub_scene_group_t *g = &s->groups[gi];
+        const uint32_t members = g->members & present;
+        if ((size_t)__builtin_popcount(members) < (cfg->min_group ? cfg->min_group : 2)) continue;
+
+        // Members share the target; devices ignore the parts they don't support.
+        const hub_scene_entry_t *e = &s->entries[__builtin_ctz(members)];
+        hub_scene_op_t *op = &out[n];
+        memset(op, 0, sizeof(*op));
+        op->kind = HUB_SCENE_OP_GROUP;
+        op->group_id = g->group_id;
+        op->flags = e->flags;
+        op->on = e->on;
+        op->level = e->level;
+        op->color_mireds = e->color_mireds;
+        op->transition_ds = s->transition_ds;
+        schedule(cfg, op, n);
+        n++;
+        st.group_ops++;
+        covered |= members;
+    }
+
+    for (size_t i = 0; i < n_entries && n < max_out; i++) {
+        if (!(present & (1u << i)) || (covered & (1u << i))) continue;
+        const hub_scene_entry_t *e = &s->entries[i];
+        hub_scene_op_t *op = &out[n];
+        memset(op, 0, sizeof(*op));
+        op->kind = HUB_SCENE_OP_UNICAST;
+        op->device_id = e->device_id;
+        op->flags = masked[i];
+        op->on = e->on;
+        op->level = e->level;
+        op->color_mireds = e->color_mireds;
+        op->transition_ds = s->transition_ds;
+        schedule(cfg, op, n);
+        n++;
+        st.unicast_ops++;
+    }
+
+    st.ops = (uint16_t)n;
+    st.predicted_ms = n ? out[n - 1].at_ms : 0;
+    if (stats) *stats = st;
+    return n;
+}
+
+size_t hub_scene_plan_all(bool on, hub_scene_op_t *out, size_t max_out, hub_scene_plan_stats_t *stats) {
+    if (stats) memset(stats, 0, sizeof(*stats));
+    if (max_out == 0) return 0;
+    memset(&out[0], 0, sizeof(out[0]));
+    out[0].kind = HUB_SCENE_OP_GROUP;
+    out[0].group_id = HUB_SCENE_GROUP_ALL;
+    out[0].flags = HUB_SCENE_F_ON;
+    out[0].on = on;
+    if (stats) {
+        stats->ops = 1;
+        stats->group_ops = 1;
+    }
+    return 1;
+}
+
+bool hub_scene_apply_to_device(hub_device_t *d, uint8_t flags, bool on, uint8_t level, uint16_t color_mireds) {
+    flags &= supported_flags(d->caps);
+    bool changed = false;
+    if ((flags & HUB_SCENE_F_ON) && d->on != on) {
+        d->on = on;
+        if (!on && (d->caps & HUB_CAP_POWER)) d->power_w = 0.0f;
+        changed = true;
+    }
+    if (flags & HUB_SCENE_F_LEVEL) {
+        const uint8_t lvl = (level > 100) ? 100 : level;
+        if (d->level != lvl) {
+            d->level = lvl;
+            changed = true;
+        }
+    }
+    if ((flags & HUB_SCENE_F_COLOR_TEMP) && d->color_mireds != color_mireds) {
+        d->color_mireds = color_mireds;
+        changed = true;
+    }
+    return changed;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+size_t hub_scene_pack(const hub_scene_t *s, uint8_t *out, size_t cap) {
+    const size_t name_len = strnlen(s->name, HUB_SCENE_NAME_LEN - 1);
+    const size_t n = entry_count(s);
+    const size_t len = BLOB_HEADER + name_len + n * BLOB_ENTRY;
+    if (len > cap) return 0;
+
+    out[0] = BLOB_VERSION;
+    out[1] = (uint8_t)n;
+    put_u16(&out[2], s->transition_ds);
+    out[4] = (uint8_t)name_len;
+    out[5] = 0;
+    memcpy(&out[BLOB_HEADER], s->name, name_len);
+
+    uint8_t *p = out + BLOB_HEADER + name_len;
+    for (size_t i = 0; i < n; i++, p += BLOB_ENTRY) {
+        const hub_scene_entry_t *e = &s->entries[i];
+        put_u16(&p[0], (uint16_t)e->device_id);
+        put_u16(&p[2], (uint16_t)(e->device_id >> 16));
+        p[4] = (uint8_t)((e->flags & 0x7fu) | (e->on ? BLOB_ENTRY_ON : 0));
+        p[5] = e->level;
+        put_u16(&p[6], e->color_mireds);
+    }
+    return len;
+}
+
+bool hub_scene_unpack(uint16_t id, const uint8_t *in, size_t len, hub_scene_t *out) {
+    if (len < BLOB_HEADER || in[0] != BLOB_VERSION) return false;
+    const size_t n = in[1];
+    const size_t name_len = in[4];
+    if (n > HUB_SCENE_MAX_ENTRIES || name_len >= HUB_SCENE_NAME_LEN) return false;
+    if (len != BLOB_HEADER + name_len + n * BLOB_ENTRY) return false;
+
+    memset(out, 0, sizeof(*out));
+    out->id = id;
+    out->transition_ds = get_u16(&in[2]);
+    memcpy(out->name, &in[BLOB_HEADER], name_len);
+    out->n_entries = (uint8_t)n;
+
+    const uint8_t *p = in + BLOB_HEADER + name_len;
+    for (size_t i = 0; i < n; i++, p += BLOB_ENTRY) {
+        hub_scene_entry_t *e = &out->entries[i];
+        e->device_id = (uint32_t)get_u16(&p[0]) | ((uint32_t)get_u16(&p[2]) << 16);
+        e->flags = p[4] & 0x7fu;
+        e->on = (p[4] & BLOB_ENTRY_ON) != 0;
+        e->level = p[5];
+        e->color_mireds = get_u16(&p[6]);
+    }
+    return true;
+}
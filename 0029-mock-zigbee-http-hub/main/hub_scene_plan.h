@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hub_types.h"
+
+// Scene model, NVS blob format and apply planning for the scene engine (hub_scene.c).
+// Plain C with no FreeRTOS/NVS dependencies, so it can be tested on the host.
+
+#define HUB_SCENE_MAX_ENTRIES 32 // hub.v1.Scene.entries max_count
+#define HUB_SCENE_MAX_GROUPS 8
+#define HUB_SCENE_NAME_LEN 16
+
+// Group id addressing every on/off device (built-in all-on/all-off scenes).
+#define HUB_SCENE_GROUP_ALL 0xffffu
+
+enum {
+    HUB_SCENE_F_ON = 1u << 0,
+    HUB_SCENE_F_LEVEL = 1u << 1,
+    HUB_SCENE_F_COLOR_TEMP = 1u << 2,
+};
+
+// Target state of one device. Fields not in `flags` are left alone.
+typedef struct {
+    uint32_t device_id;
+    uint8_t flags; // HUB_SCENE_F_*
+    bool on;
+    uint8_t level;          // 0..100
+    uint16_t color_mireds;  // color temperature
+} hub_scene_entry_t;
+
+// A group of scene entries that share one target, addressed with one group command.
+typedef struct {
+    uint16_t group_id;
+    uint32_t members; // bit i = entries[i]
+} hub_scene_group_t;
+
+typedef struct {
+    uint16_t id;
+    char name[HUB_SCENE_NAME_LEN];
+    uint16_t transition_ds; // deciseconds, as in the ZCL "with transition" commands
+    uint8_t n_entries;
+    uint8_t n_groups;
+    hub_scene_entry_t entries[HUB_SCENE_MAX_ENTRIES];
+    hub_scene_group_t groups[HUB_SCENE_MAX_GROUPS];
+} hub_scene_t;
+
+typedef enum {
+    HUB_SCENE_OP_GROUP = 1,
+    HUB_SCENE_OP_UNICAST = 2,
+} hub_scene_op_kind_t;
+
+// One command to send, at_ms after the scene starts.
+typedef struct {
+    uint8_t kind; // hub_scene_op_kind_t
+    uint16_t group_id;  // HUB_SCENE_OP_GROUP
+    uint32_t device_id; // HUB_SCENE_OP_UNICAST
+    uint8_t flags;
+    bool on;
+    uint8_t level;
+    uint16_t color_mireds;
+    uint16_t transition_ds;
+    uint32_t at_ms;
+} hub_scene_op_t;
+
+typedef struct {
+    uint8_t burst;         // commands per pacing window
+    uint16_t interval_ms;  // pacing window length
+    uint8_t min_group;     // present members needed to use a group command
+} hub_scene_plan_cfg_t;
+
+typedef struct {
+    uint16_t ops;
+    uint16_t group_ops;
+    uint16_t unicast_ops;
+    uint16_t devices;   // entries that will be applied
+    uint16_t skipped;   // entries for unknown devices or with nothing the device supports
+    uint32_t predicted_ms; // send time of the last command
+} hub_scene_plan_stats_t;
+
+// Upper bound on hub_scene_plan() output.
+#define HUB_SCENE_MAX_OPS (HUB_SCENE_MAX_ENTRIES + HUB_SCENE_MAX_GROUPS)
+
+// Clusters entries with identical targets; clusters of at least min_members get a
+// group (ids derived from the scene id). Replaces s->groups.
+void hub_scene_assign_groups(hub_scene_t *s, size_t min_members);
+
+// Expands s against the current device set (need not be sorted) into commands:
+// group commands first, then unicast for entries no usable group covers, paced
+// cfg->burst per cfg->interval_ms. Returns the number of ops written.
+size_t hub_scene_plan(const hub_scene_t *s, const hub_device_t *devs, size_t n_devs, const hub_scene_plan_cfg_t *cfg,
+                      hub_scene_op_t *out, size_t max_out, hub_scene_plan_stats_t *stats);
+
+// Plan for the built-in all-on/all-off scenes: one HUB_SCENE_GROUP_ALL command.
+size_t hub_scene_plan_all(bool on, hub_scene_op_t *out, size_t max_out, hub_scene_plan_stats_t *stats);
+
+// Applies what an op sets to a device, masked by the device's caps (what a
+// device does with a command it receives). Returns true if anything changed.
+bool hub_scene_apply_to_device(hub_device_t *d, uint8_t flags, bool on, uint8_t level, uint16_t color_mireds);
+
+// NVS blob: 6-byte header + name + 8 bytes per entry. Groups are not stored;
+// they are re-derived on load.
+#define HUB_SCENE_BLOB_MAX (6 + HUB_SCENE_NAME_LEN + 8 * HUB_SCENE_MAX_ENTRIES)
+
+size_t hub_scene_pack(const hub_scene_t *s, uint8_t *out, size_t cap);
+bool hub_scene_unpack(uint16_t id, const uint8_t *in, size_t len, hub_scene_t *out);
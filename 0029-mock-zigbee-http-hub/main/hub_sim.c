@@ -7,6 +7,7 @@
 #include "hub_sim.h"
 
 #include <math.h>
+#include <stdlib.h>
 
 #include "sdkconfig.h"
 
@@ -41,11 +42,18 @@ static float rand_walk(float cur, float step, float min_v, float max_v) {
 
 static void sim_task(void *arg) {
     (void)arg;
-    hub_device_t snap[32];
+    const size_t cap = hub_registry_capacity();
+    hub_device_t *snap = calloc(cap, sizeof(*snap));
+    if (!snap) {
+        ESP_LOGE(TAG, "snapshot alloc failed (%u devices)", (unsigned)cap);
+        s_task = NULL;
+        vTaskDelete(NULL);
+        return;
+    }
 
     while (true) {
         size_t n = 0;
-        (void)hub_registry_snapshot(snap, sizeof(snap) / sizeof(snap[0]), &n);
+        (void)hub_registry_snapshot(snap, cap, &n);
 
         for (size_t i = 0; i < n; i++) {
             hub_device_t d = snap[i];
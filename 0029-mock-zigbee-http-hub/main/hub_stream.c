@@ -3,10 +3,16 @@
  *
  * Goal: publish hub bus traffic over WebSocket as protobuf binary frames without
  * doing heavy work (encode/malloc/send) inside the hub event loop task.
+ *
+ * Events are batched per flush window into one hub.v1.HubEventBatch frame per
+ * client. State/report events don't queue at all: they are folded into a table of
+ * latest values per device (hub_stream_delta.c), and each client gets only the
+ * fields that changed since its previous frame. Everything else is sent in order.
  */
 
 #include "hub_stream.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "sdkconfig.h"
@@ -23,16 +29,21 @@
 
 #include "hub_http.h"
 #include "hub_pb.h"
+#include "hub_stream_delta.h"
 #include "hub_types.h"
 
 static const char *TAG = "hub_stream_0029";
 
+#define STREAM_QUEUE_LEN 64
+#define STREAM_MAX_DEVICES CONFIG_TUTORIAL_0029_STREAM_MAX_DEVICES
+
 typedef union {
     hub_device_t device;
     hub_cmd_device_add_t cmd_add;
     hub_cmd_device_set_t cmd_set;
     hub_cmd_device_interview_t cmd_interview;
     hub_cmd_scene_trigger_t cmd_scene;
+    hub_cmd_group_set_t cmd_group;
     hub_evt_device_state_t st;
     hub_evt_device_report_t rep;
 } hub_stream_payload_u;
@@ -45,9 +56,20 @@ typedef struct {
 static QueueHandle_t s_q = NULL;
 static TaskHandle_t s_task = NULL;
 
-static uint32_t s_drops = 0;
-static uint32_t s_enc_fail = 0;
-static uint32_t s_send_fail = 0;
+// Latest state/report values, shared with the hub event loop.
+static portMUX_TYPE s_attr_mu = portMUX_INITIALIZER_UNLOCKED;
+static hub_stream_attrs_t s_attrs;
+
+// Stream task only.
+static hub_stream_clients_t s_clients;
+static hub_stream_dirty_t *s_dirty = NULL;
+static hub_stream_item_t s_items[STREAM_QUEUE_LEN];
+static uint32_t s_seq[HUB_STREAM_MAX_CLIENTS];
+static uint16_t s_seq_epoch[HUB_STREAM_MAX_CLIENTS];
+static hub_v1_HubEventBatch s_batch;
+static uint8_t s_buf[hub_v1_HubEventBatch_size];
+
+static hub_stream_stats_t s_stats = {0};
 
 static size_t payload_size_for_id(int32_t id) {
     switch (id) {
@@ -59,6 +81,8 @@ static size_t payload_size_for_id(int32_t id) {
             return sizeof(hub_cmd_device_interview_t);
         case HUB_CMD_SCENE_TRIGGER:
             return sizeof(hub_cmd_scene_trigger_t);
+        case HUB_CMD_GROUP_SET:
+            return sizeof(hub_cmd_group_set_t);
         case HUB_EVT_DEVICE_ADDED:
         case HUB_EVT_DEVICE_INTERVIEWED:
             return sizeof(hub_device_t);
@@ -81,51 +105,148 @@ static void on_any_event_enqueue(void *arg, esp_event_base_t base, int32_t id, v
     const size_t sz = payload_size_for_id(id);
     if (sz == 0) return;
     if (!data) return;
+    s_stats.events_in++;
+
+    if (id == HUB_EVT_DEVICE_STATE || id == HUB_EVT_DEVICE_REPORT) {
+        bool folded = false;
+        portENTER_CRITICAL(&s_attr_mu);
+        if (id == HUB_EVT_DEVICE_STATE) {
+            folded = hub_stream_attrs_fold_state(&s_attrs, (const hub_evt_device_state_t *)data);
+        } else {
+            folded = hub_stream_attrs_fold_report(&s_attrs, (const hub_evt_device_report_t *)data);
+        }
+        portEXIT_CRITICAL(&s_attr_mu);
+        if (folded) {
+            xTaskNotifyGive(s_task);
+            return;
+        }
+        s_stats.fold_overflow++;
+    }
 
     hub_stream_item_t it = {.id = id};
     memset(&it.payload, 0, sizeof(it.payload));
     memcpy(&it.payload, data, sz);
 
     if (xQueueSend(s_q, &it, 0) != pdTRUE) {
-        s_drops++;
+        s_stats.enqueue_drops++;
+        return;
     }
+    xTaskNotifyGive(s_task);
 }
 
-static void stream_task(void *arg) {
-    (void)arg;
+static void fill_pb_delta(hub_v1_DeviceDelta *out, const hub_stream_delta_t *d) {
+    memset(out, 0, sizeof(*out));
+    out->device_id = d->device_id;
+    out->ts_us = d->ts_us;
+    out->has_on = (d->fields & HUB_STREAM_F_ON) != 0;
+    out->on = d->on;
+    out->has_level = (d->fields & HUB_STREAM_F_LEVEL) != 0;
+    out->level = (uint32_t)d->level;
+    out->has_power_w = (d->fields & HUB_STREAM_F_POWER) != 0;
+    out->power_w = d->power_w;
+    out->has_temperature_c = (d->fields & HUB_STREAM_F_TEMPERATURE) != 0;
+    out->temperature_c = d->temperature_c;
+}
 
-    hub_stream_item_t it = {0};
-    uint8_t buf[512];
+// Returns false when the frame did not reach the client.
+static bool send_batch(size_t ci) {
+    if (s_seq_epoch[ci] != s_clients.epoch[ci]) {
+        s_seq_epoch[ci] = s_clients.epoch[ci];
+        s_seq[ci] = 0;
+    }
+    s_batch.schema_version = 2;
+    s_batch.seq = ++s_seq[ci];
 
-    while (true) {
-        if (xQueueReceive(s_q, &it, portMAX_DELAY) != pdTRUE) continue;
-        if (hub_http_events_client_count() == 0) continue;
+    pb_ostream_t s = pb_ostream_from_buffer(s_buf, sizeof(s_buf));
+    if (!pb_encode(&s, hub_v1_HubEventBatch_fields, &s_batch)) {
+        s_stats.encode_failures++;
+        return false;
+    }
+    s_stats.frames++;
+    if (hub_http_events_send_pb(s_clients.fd[ci], s_buf, (size_t)s.bytes_written) != ESP_OK) {
+        s_stats.send_failures++;
+        return false;
+    }
+    return true;
+}
 
-        hub_v1_HubEvent ev = hub_v1_HubEvent_init_zero;
-        if (!hub_pb_build_event(it.id, &it.payload, &ev)) {
-            continue;
-        }
+static void stream_flush(void) {
+    int fds[HUB_STREAM_MAX_CLIENTS];
+    uint32_t serials[HUB_STREAM_MAX_CLIENTS];
+    const size_t n_fds = hub_http_events_clients(fds, serials, HUB_STREAM_MAX_CLIENTS);
+    if (hub_stream_clients_sync(&s_clients, fds, serials, n_fds)) {
+        // Bring the new client up to date; the others only get what they lack.
+        portENTER_CRITICAL(&s_attr_mu);
+        hub_stream_attrs_mark_all_dirty(&s_attrs);
+        portEXIT_CRITICAL(&s_attr_mu);
+    }
 
-        size_t need = 0;
-        if (!pb_get_encoded_size(&need, hub_v1_HubEvent_fields, &ev)) {
-            s_enc_fail++;
-            continue;
+    size_t n_items = 0;
+    while (n_items < STREAM_QUEUE_LEN && xQueueReceive(s_q, &s_items[n_items], 0) == pdTRUE) {
+        n_items++;
+    }
+
+    portENTER_CRITICAL(&s_attr_mu);
+    const size_t n_dirty = hub_stream_attrs_take_dirty(&s_attrs, s_dirty, STREAM_MAX_DEVICES);
+    const uint32_t coalesced = s_attrs.coalesced;
+    portEXIT_CRITICAL(&s_attr_mu);
+
+    if (n_fds == 0 || (n_items == 0 && n_dirty == 0)) return;
+    s_stats.batches++;
+
+    const size_t max_events = sizeof(s_batch.events) / sizeof(s_batch.events[0]);
+    const size_t max_deltas = sizeof(s_batch.deltas) / sizeof(s_batch.deltas[0]);
+    size_t ev_off = 0;
+    size_t dirty_off = 0;
+    bool resync = false;
+    while (ev_off < n_items || dirty_off < n_dirty) {
+        // Events are the same for every client; deltas are per client.
+        memset(&s_batch, 0, sizeof(s_batch));
+        for (size_t i = ev_off; i < n_items && s_batch.events_count < max_events; i++) {
+            if (hub_pb_build_event(s_items[i].id, &s_items[i].payload, &s_batch.events[s_batch.events_count])) {
+                s_batch.events_count++;
+            }
         }
-        if (need > sizeof(buf)) {
-            s_enc_fail++;
-            continue;
+        ev_off = (n_items - ev_off > max_events) ? ev_off + max_events : n_items;
+        const size_t dirty_end = (n_dirty - dirty_off > max_deltas) ? dirty_off + max_deltas : n_dirty;
+        s_batch.coalesced_total = coalesced;
+        s_batch.dropped_total = s_stats.enqueue_drops;
+
+        for (size_t ci = 0; ci < HUB_STREAM_MAX_CLIENTS; ci++) {
+            if (s_clients.fd[ci] < 0) continue;
+            s_batch.deltas_count = 0;
+            for (size_t k = dirty_off; k < dirty_end; k++) {
+                hub_stream_delta_t d;
+                if (hub_stream_delta_for_client(&s_clients, ci, &s_dirty[k], &d)) {
+                    fill_pb_delta(&s_batch.deltas[s_batch.deltas_count++], &d);
+                }
+            }
+            if (s_batch.events_count == 0 && s_batch.deltas_count == 0) continue;
+            if (!send_batch(ci)) {
+                // The deltas were recorded as sent; drop that so the client gets full state.
+                hub_stream_clients_forget(&s_clients, ci);
+                resync = true;
+            }
         }
+        dirty_off = dirty_end;
+    }
 
-        pb_ostream_t s = pb_ostream_from_buffer(buf, sizeof(buf));
-        if (!pb_encode(&s, hub_v1_HubEvent_fields, &ev)) {
-            s_enc_fail++;
-            continue;
-        }
+    if (resync) {
+        portENTER_CRITICAL(&s_attr_mu);
+        hub_stream_attrs_mark_all_dirty(&s_attrs);
+        portEXIT_CRITICAL(&s_attr_mu);
+        xTaskNotifyGive(s_task);
+    }
+}
 
-        esp_err_t err = hub_http_events_broadcast_pb(buf, (size_t)s.bytes_written);
-        if (err != ESP_OK) {
-            s_send_fail++;
-        }
+static void stream_task(void *arg) {
+    (void)arg;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Let the window fill: whatever the bus posts meanwhile goes out in the same frames.
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_TUTORIAL_0029_STREAM_FLUSH_MS));
+        stream_flush();
     }
 }
 
@@ -133,8 +254,23 @@ esp_err_t hub_stream_start(esp_event_loop_handle_t loop) {
     if (!loop) return ESP_ERR_INVALID_ARG;
     if (s_task) return ESP_OK;
 
+    if (!s_dirty) {
+        hub_stream_attr_t *slots = calloc(STREAM_MAX_DEVICES, sizeof(*slots));
+        hub_stream_sent_t *sent = calloc((size_t)STREAM_MAX_DEVICES * HUB_STREAM_MAX_CLIENTS, sizeof(*sent));
+        hub_stream_dirty_t *dirty = calloc(STREAM_MAX_DEVICES, sizeof(*dirty));
+        if (!slots || !sent || !dirty) {
+            free(slots);
+            free(sent);
+            free(dirty);
+            return ESP_ERR_NO_MEM;
+        }
+        hub_stream_attrs_init(&s_attrs, slots, STREAM_MAX_DEVICES);
+        hub_stream_clients_init(&s_clients, sent, STREAM_MAX_DEVICES);
+        s_dirty = dirty;
+    }
+
     if (!s_q) {
-        s_q = xQueueCreate(64, sizeof(hub_stream_item_t));
+        s_q = xQueueCreate(STREAM_QUEUE_LEN, sizeof(hub_stream_item_t));
         if (!s_q) return ESP_ERR_NO_MEM;
     }
 
@@ -150,14 +286,21 @@ esp_err_t hub_stream_start(esp_event_loop_handle_t loop) {
         return err;
     }
 
-    ESP_LOGI(TAG, "protobuf WS stream bridge started");
+    ESP_LOGI(TAG, "protobuf WS stream bridge started (flush=%dms devices=%d)",
+             CONFIG_TUTORIAL_0029_STREAM_FLUSH_MS, STREAM_MAX_DEVICES);
     return ESP_OK;
 }
 
-void hub_stream_get_stats(uint32_t *out_enqueue_drops, uint32_t *out_encode_failures, uint32_t *out_send_failures) {
-    if (out_enqueue_drops) *out_enqueue_drops = s_drops;
-    if (out_encode_failures) *out_encode_failures = s_enc_fail;
-    if (out_send_failures) *out_send_failures = s_send_fail;
+void hub_stream_kick(void) {
+    if (s_task) xTaskNotifyGive(s_task);
+}
+
+void hub_stream_get_stats(hub_stream_stats_t *out) {
+    if (!out) return;
+    *out = s_stats;
+    portENTER_CRITICAL(&s_attr_mu);
+    out->coalesced = s_attrs.coalesced;
+    portEXIT_CRITICAL(&s_attr_mu);
 }
 
 #else
@@ -168,10 +311,11 @@ esp_err_t hub_stream_start(esp_event_loop_handle_t loop) {
     return ESP_OK;
 }
 
-void hub_stream_get_stats(uint32_t *out_enqueue_drops, uint32_t *out_encode_failures, uint32_t *out_send_failures) {
-    if (out_enqueue_drops) *out_enqueue_drops = 0;
-    if (out_encode_failures) *out_encode_failures = 0;
-    if (out_send_failures) *out_send_failures = 0;
+void hub_stream_kick(void) {
+}
+
+void hub_stream_get_stats(hub_stream_stats_t *out) {
+    if (out) memset(out, 0, sizeof(*out));
 }
 
 #endif
@@ -7,8 +7,25 @@
 
 // Starts the hub event stream bridge (protobuf over WebSocket).
 // Safe to call even when the feature is disabled by Kconfig; it becomes a no-op.
+//
+// Frames are hub.v1.HubEventBatch: one per flush window and client, carrying the
+// window's events in order plus per-device deltas of the latest state/report values.
 esp_err_t hub_stream_start(esp_event_loop_handle_t loop);
 
-// Basic telemetry about the stream bridge.
-void hub_stream_get_stats(uint32_t *out_enqueue_drops, uint32_t *out_encode_failures, uint32_t *out_send_failures);
+// Wakes the bridge for a flush without a bus event, e.g. when a WebSocket client
+// connects and needs the current state.
+void hub_stream_kick(void);
+
+typedef struct {
+    uint32_t enqueue_drops;   // events dropped on a full stream queue
+    uint32_t coalesced;       // state/report events folded into a newer value before sending
+    uint32_t fold_overflow;   // state/report events sent as plain events (attribute table full)
+    uint32_t events_in;       // events accepted from the bus
+    uint32_t batches;         // flush windows that produced frames
+    uint32_t frames;          // frames queued, summed over clients
+    uint32_t encode_failures;
+    uint32_t send_failures;
+} hub_stream_stats_t;
 
+// Basic telemetry about the stream bridge.
+void hub_stream_get_stats(hub_stream_stats_t *out);
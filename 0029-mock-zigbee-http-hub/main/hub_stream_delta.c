@@ -0,0 +1,197 @@
+/*
+ * Report coalescing and per-client deltas for the tutorial 0029 event stream.
+ *
+ * State/report events are folded into a small table of latest attribute values
+ * per device; each flush window the stream task takes the dirty entries and, per
+ * WebSocket client, sends only the fields whose values differ from what that
+ * client was last sent.
+ */
+
+#include "hub_stream_delta.h"
+
+#include <string.h>
+
+void hub_stream_attrs_init(hub_stream_attrs_t *a, hub_stream_attr_t *slots, size_t cap) {
+    memset(a, 0, sizeof(*a));
+    memset(slots, 0, cap * sizeof(*slots));
+    a->slots = slots;
+    a->cap = cap;
+}
+
+static hub_stream_attr_t *attr_slot(hub_stream_attrs_t *a, uint32_t device_id) {
+    if (device_id == 0) return NULL;
+
+    hub_stream_attr_t *free_slot = NULL;
+    for (size_t i = 0; i < a->cap; i++) {
+        hub_stream_attr_t *s = &a->slots[i];
+        if (s->device_id == device_id) return s;
+        if (!free_slot && s->device_id == 0) free_slot = s;
+    }
+
+    if (!free_slot) {
+        // Evict a device with nothing pending, round-robin so one hot device
+        // can't pin the same victim.
+        for (size_t k = 0; k < a->cap; k++) {
+            const size_t i = (a->next_evict + k) % a->cap;
+            if (a->slots[i].dirty == 0) {
+                free_slot = &a->slots[i];
+                a->next_evict = (i + 1) % a->cap;
+                break;
+            }
+        }
+    }
+    if (!free_slot) return NULL;
+
+    const uint16_t gen = (uint16_t)(free_slot->gen + 1);
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->device_id = device_id;
+    free_slot->gen = gen;
+    return free_slot;
+}
+
+static void note_fold(hub_stream_attrs_t *a, hub_stream_attr_t *s, uint8_t fields, int64_t ts_us) {
+    if (s->dirty & fields) a->coalesced++;
+    s->dirty |= fields;
+    s->known |= fields;
+    if (ts_us > s->ts_us) s->ts_us = ts_us;
+}
+
+bool hub_stream_attrs_fold_state(hub_stream_attrs_t *a, const hub_evt_device_state_t *st) {
+    hub_stream_attr_t *s = attr_slot(a, st->device_id);
+    if (!s) return false;
+    s->on = st->on;
+    s->level = st->level;
+    note_fold(a, s, HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL, st->ts_us);
+    return true;
+}
+
+bool hub_stream_attrs_fold_report(hub_stream_attrs_t *a, const hub_evt_device_report_t *rep) {
+    uint8_t fields = 0;
+    if (rep->has_power) fields |= HUB_STREAM_F_POWER;
+    if (rep->has_temperature) fields |= HUB_STREAM_F_TEMPERATURE;
+    if (fields == 0) return true;
+
+    hub_stream_attr_t *s = attr_slot(a, rep->device_id);
+    if (!s) return false;
+    if (rep->has_power) s->power_w = rep->power_w;
+    if (rep->has_temperature) s->temperature_c = rep->temperature_c;
+    note_fold(a, s, fields, rep->ts_us);
+    return true;
+}
+
+void hub_stream_attrs_mark_all_dirty(hub_stream_attrs_t *a) {
+    for (size_t i = 0; i < a->cap; i++) {
+        a->slots[i].dirty |= a->slots[i].known;
+    }
+}
+
+size_t hub_stream_attrs_take_dirty(hub_stream_attrs_t *a, hub_stream_dirty_t *out, size_t max) {
+    size_t n = 0;
+    for (size_t i = 0; i < a->cap && n < max; i++) {
+        hub_stream_attr_t *s = &a->slots[i];
+        if (s->device_id == 0 || s->dirty == 0) continue;
+        out[n].slot = (uint16_t)i;
+        out[n].attr = *s;
+        n++;
+        s->dirty = 0;
+    }
+    return n;
+}
+
+void hub_stream_clients_init(hub_stream_clients_t *c, hub_stream_sent_t *sent, size_t cap) {
+    memset(c, 0, sizeof(*c));
+    for (size_t i = 0; i < HUB_STREAM_MAX_CLIENTS; i++) {
+        c->fd[i] = -1;
+    }
+    memset(sent, 0, cap * HUB_STREAM_MAX_CLIENTS * sizeof(*sent));
+    c->sent = sent;
+    c->cap = cap;
+}
+
+int hub_stream_clients_index(const hub_stream_clients_t *c, int fd) {
+    for (size_t i = 0; i < HUB_STREAM_MAX_CLIENTS; i++) {
+        if (c->fd[i] == fd) return (int)i;
+    }
+    return -1;
+}
+
+bool hub_stream_clients_sync(hub_stream_clients_t *c, const int *fds, const uint32_t *serials, size_t n) {
+    if (n > HUB_STREAM_MAX_CLIENTS) n = HUB_STREAM_MAX_CLIENTS;
+
+    // Forget clients that went away, including an fd now reused by another connection.
+    for (size_t i = 0; i < HUB_STREAM_MAX_CLIENTS; i++) {
+        if (c->fd[i] < 0) continue;
+        bool present = false;
+        for (size_t k = 0; k < n; k++) {
+            if (fds[k] == c->fd[i] && serials[k] == c->serial[i]) {
+                present = true;
+                break;
+            }
+        }
+        if (!present) c->fd[i] = -1;
+    }
+
+    // A new epoch invalidates whatever an earlier client in the same index was sent.
+    bool added = false;
+    for (size_t k = 0; k < n; k++) {
+        if (fds[k] < 0 || hub_stream_clients_index(c, fds[k]) >= 0) continue;
+        const int i = hub_stream_clients_index(c, -1);
+        if (i < 0) break;
+        c->fd[i] = fds[k];
+        c->serial[i] = serials[k];
+        c->epoch[i]++;
+        added = true;
+    }
+    return added;
+}
+
+bool hub_stream_delta_for_client(hub_stream_clients_t *c, size_t ci, const hub_stream_dirty_t *d, hub_stream_delta_t *out) {
+    hub_stream_sent_t *b = &c->sent[(size_t)d->slot * HUB_STREAM_MAX_CLIENTS + ci];
+    const hub_stream_attr_t *s = &d->attr;
+
+    if (b->gen != s->gen || b->epoch != c->epoch[ci]) {
+        memset(b, 0, sizeof(*b));
+        b->gen = s->gen;
+        b->epoch = c->epoch[ci];
+    }
+
+    uint8_t fields = 0;
+    if ((s->known & HUB_STREAM_F_ON) && (!(b->has & HUB_STREAM_F_ON) || b->on != s->on)) {
+        fields |= HUB_STREAM_F_ON;
+    }
+    if ((s->known & HUB_STREAM_F_LEVEL) && (!(b->has & HUB_STREAM_F_LEVEL) || b->level != s->level)) {
+        fields |= HUB_STREAM_F_LEVEL;
+    }
+    // Compared bit for bit: any new reading counts as a change.
+    if ((s->known & HUB_STREAM_F_POWER) &&
+        (!(b->has & HUB_STREAM_F_POWER) || memcmp(&b->power_w, &s->power_w, sizeof(float)) != 0)) {
+        fields |= HUB_STREAM_F_POWER;
+    }
+    if ((s->known & HUB_STREAM_F_TEMPERATURE) &&
+        (!(b->has & HUB_STREAM_F_TEMPERATURE) || memcmp(&b->temperature_c, &s->temperature_c, sizeof(float)) != 0)) {
+        fields |= HUB_STREAM_F_TEMPERATURE;
+    }
+    if (fields == 0) return false;
+
+    b->has |= fields;
+    b->on = s->on;
+    b->level = s->level;
+    b->power_w = s->power_w;
+    b->temperature_c = s->temperature_c;
+
+    memset(out, 0, sizeof(*out));
+    out->device_id = s->device_id;
+    out->fields = fields;
+    out->ts_us = s->ts_us;
+    out->on = s->on;
+    out->level = s->level;
+    out->power_w = s->power_w;
+    out->temperature_c = s->temperature_c;
+    return true;
+}
+
+void hub_stream_clients_forget(hub_stream_clients_t *c, size_t ci) {
+    for (size_t slot = 0; slot < c->cap; slot++) {
+        c->sent[slot * HUB_STREAM_MAX_CLIENTS + ci].has = 0;
+    }
+}
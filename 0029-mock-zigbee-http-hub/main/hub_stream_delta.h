@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hub_types.h"
+
+// Coalescing + per-client delta state for the WebSocket event stream (hub_stream.c).
+// Plain C with no locking: the caller serializes access (the attribute table is
+// shared with the hub event loop, the client baselines are stream-task only).
+
+#define HUB_STREAM_MAX_CLIENTS 8
+
+enum {
+    HUB_STREAM_F_ON = 1u << 0,
+    HUB_STREAM_F_LEVEL = 1u << 1,
+    HUB_STREAM_F_POWER = 1u << 2,
+    HUB_STREAM_F_TEMPERATURE = 1u << 3,
+};
+
+// Latest attribute values of one device, folded from state/report events.
+typedef struct {
+    uint32_t device_id; // 0 = free slot
+    uint16_t gen;       // bumped when the slot is reused for another device
+    uint8_t known;      // HUB_STREAM_F_* ever reported
+    uint8_t dirty;      // HUB_STREAM_F_* reported since the last take
+    int64_t ts_us;
+    bool on;
+    uint8_t level;
+    float power_w;
+    float temperature_c;
+} hub_stream_attr_t;
+
+typedef struct {
+    hub_stream_attr_t *slots;
+    size_t cap;
+    size_t next_evict;
+    uint32_t coalesced; // events folded over a value that was not sent yet
+} hub_stream_attrs_t;
+
+// A dirty slot handed from the attribute table to the stream task.
+typedef struct {
+    uint16_t slot;
+    hub_stream_attr_t attr;
+} hub_stream_dirty_t;
+
+// What one client gets for one device.
+typedef struct {
+    uint32_t device_id;
+    uint8_t fields; // HUB_STREAM_F_* present
+    int64_t ts_us;
+    bool on;
+    uint8_t level;
+    float power_w;
+    float temperature_c;
+} hub_stream_delta_t;
+
+// Last values sent to one client for one attribute slot.
+typedef struct {
+    uint16_t gen;   // slot generation the values belong to
+    uint16_t epoch; // client epoch the values belong to
+    uint8_t has;    // HUB_STREAM_F_* this client has
+    bool on;
+    uint8_t level;
+    float power_w;
+    float temperature_c;
+} hub_stream_sent_t;
+
+typedef struct {
+    int fd[HUB_STREAM_MAX_CLIENTS]; // -1 = unused
+    uint32_t serial[HUB_STREAM_MAX_CLIENTS]; // connection serial: a reused fd is a new client
+    uint16_t epoch[HUB_STREAM_MAX_CLIENTS];
+    hub_stream_sent_t *sent; // cap * HUB_STREAM_MAX_CLIENTS, slot-major
+    size_t cap;
+} hub_stream_clients_t;
+
+void hub_stream_attrs_init(hub_stream_attrs_t *a, hub_stream_attr_t *slots, size_t cap);
+
+// Fold an event into the table. Returns false when every slot holds unsent
+// changes of other devices; the caller should then send the event as-is.
+bool hub_stream_attrs_fold_state(hub_stream_attrs_t *a, const hub_evt_device_state_t *st);
+bool hub_stream_attrs_fold_report(hub_stream_attrs_t *a, const hub_evt_device_report_t *rep);
+
+// Marks every known attribute dirty so the next flush can bring a new client up to date.
+void hub_stream_attrs_mark_all_dirty(hub_stream_attrs_t *a);
+
+// Moves up to max dirty slots to out and marks them clean. Returns the count.
+size_t hub_stream_attrs_take_dirty(hub_stream_attrs_t *a, hub_stream_dirty_t *out, size_t max);
+
+// sent must hold cap * HUB_STREAM_MAX_CLIENTS entries (cap = the attribute table's).
+void hub_stream_clients_init(hub_stream_clients_t *c, hub_stream_sent_t *sent, size_t cap);
+
+// Makes the client set match the (fds[i], serials[i]) connections (extra ones past
+// HUB_STREAM_MAX_CLIENTS are ignored). Returns true if a client was added; its baseline
+// starts empty. A known fd with a different serial is a reconnect and counts as added.
+bool hub_stream_clients_sync(hub_stream_clients_t *c, const int *fds, const uint32_t *serials, size_t n);
+
+// Index of fd in the client set, or -1.
+int hub_stream_clients_index(const hub_stream_clients_t *c, int fd);
+
+// Fields of d that client ci has not seen with these values. Records them as
+// sent and returns true, or returns false when the client is already current.
+bool hub_stream_delta_for_client(hub_stream_clients_t *c, size_t ci, const hub_stream_dirty_t *d, hub_stream_delta_t *out);
+
+// Drops everything recorded as sent to client ci, e.g. after a frame to it failed, so
+// the next delta for each slot carries every known field again.
+void hub_stream_clients_forget(hub_stream_clients_t *c, size_t ci);
@@ -0,0 +1,344 @@
+/*
+ * Telemetry history for tutorial 0029: hub bus -> hub_tsdb -> flash.
+ *
+ * The store (hub_tsdb.c, host-tested) lives in one allocation, in PSRAM when
+ * available, behind a mutex. The bus handler never waits for that mutex: it
+ * queues samples in a small pending ring and folds them in only if the lock is
+ * free, so a snapshot being written to flash cannot stall the event loop. The
+ * "tsdb" partition holds two snapshot copies; each save erases and writes the
+ * older one, and boot restores whichever valid copy has the higher seq.
+ */
+
+#include "hub_telemetry.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+
+#include "hub_bus.h"
+#include "hub_registry.h"
+#include "hub_types.h"
+
+static const char *TAG = "hub_tsdb_0029";
+
+#define TSDB_SERIES CONFIG_TUTORIAL_0029_TSDB_SERIES
+#define TSDB_MIN_SERIES 4
+#define TSDB_PARTITION_LABEL "tsdb"
+#define TSDB_PARTITION_SUBTYPE 0x40
+#define PENDING_LEN 64
+#define DRAIN_BATCH 16
+
+typedef struct {
+    uint32_t device_id;
+    uint32_t t;
+    float v;
+    uint8_t attr;
+} pending_t;
+
+typedef struct {
+    const esp_partition_t *part;
+    size_t base;
+} region_t;
+
+static SemaphoreHandle_t s_mu = NULL;
+static hub_tsdb_t s_db;
+static bool s_ready = false;
+static TaskHandle_t s_task = NULL;
+
+static portMUX_TYPE s_pending_mu = portMUX_INITIALIZER_UNLOCKED;
+static pending_t s_pending[PENDING_LEN];
+static size_t s_pending_head;
+static size_t s_pending_n;
+static uint32_t s_pending_drops;
+
+static uint32_t s_t_base; // hub clock at boot
+static const esp_partition_t *s_part = NULL;
+static size_t s_region_size;
+static int s_active = -1; // region holding the newest snapshot
+
+static hub_telemetry_stats_t s_stats;
+
+uint32_t hub_telemetry_now(void) {
+    return s_t_base + (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+static uint32_t to_hub_time(int64_t ts_us) {
+    return s_t_base + (uint32_t)(ts_us / 1000000);
+}
+
+// Allocates the store for up to TSDB_SERIES series, halving the series count until it fits
+// (PSRAM first, then at most half of the largest internal block so WiFi and httpd keep room).
+// Returns NULL only if TSDB_MIN_SERIES does not fit either.
+static void *alloc_store(const hub_tsdb_cfg_t *cfg, size_t *cap, size_t *bytes) {
+    for (size_t n = TSDB_SERIES; n >= TSDB_MIN_SERIES; n /= 2) {
+        const size_t want = hub_tsdb_mem_size(cfg, n);
+        void *p = heap_caps_calloc(1, want, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!p && want <= heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) / 2) {
+            p = heap_caps_calloc(1, want, MALLOC_CAP_8BIT);
+        }
+        if (p) {
+            *cap = n;
+            *bytes = want;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static void pending_push(uint32_t device_id, uint8_t attr, uint32_t t, float v) {
+    portENTER_CRITICAL(&s_pending_mu);
+    if (s_pending_n == PENDING_LEN) {
+        s_pending_drops++;
+    } else {
+        s_pending[(s_pending_head + s_pending_n) % PENDING_LEN] = (pending_t){
+            .device_id = device_id,
+            .t = t,
+            .v = v,
+            .attr = attr,
+        };
+        s_pending_n++;
+    }
+    portEXIT_CRITICAL(&s_pending_mu);
+}
+
+// Caller holds s_mu.
+static void pending_drain_locked(void) {
+    pending_t batch[DRAIN_BATCH];
+    for (;;) {
+        size_t n = 0;
+        portENTER_CRITICAL(&s_pending_mu);
+        while (n < DRAIN_BATCH && s_pending_n > 0) {
+            batch[n++] = s_pending[s_pending_head];
+            s_pending_head = (s_pending_head + 1) % PENDING_LEN;
+            s_pending_n--;
+        }
+        portEXIT_CRITICAL(&s_pending_mu);
+        if (n == 0) return;
+        for (size_t i = 0; i < n; i++) {
+            hub_tsdb_insert(&s_db, batch[i].device_id, batch[i].attr, batch[i].t, batch[i].v);
+        }
+    }
+}
+
+static void on_device_event(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    (void)arg;
+    (void)base;
+    if (!data) return;
+
+    if (id == HUB_EVT_DEVICE_STATE) {
+        const hub_evt_device_state_t *ev = (const hub_evt_device_state_t *)data;
+        const uint32_t t = to_hub_time(ev->ts_us);
+        hub_device_t d;
+        const bool known = hub_registry_get(ev->device_id, &d) == ESP_OK;
+        pending_push(ev->device_id, HUB_TS_ATTR_ON, t, ev->on ? 1.0f : 0.0f);
+        if (!known || (d.caps & HUB_CAP_LEVEL)) {
+            pending_push(ev->device_id, HUB_TS_ATTR_LEVEL, t, (float)ev->level);
+        }
+        if (known && (d.caps & HUB_CAP_COLOR_TEMP)) {
+            pending_push(ev->device_id, HUB_TS_ATTR_COLOR_TEMP, t, (float)d.color_mireds);
+        }
+    } else if (id == HUB_EVT_DEVICE_REPORT) {
+        const hub_evt_device_report_t *ev = (const hub_evt_device_report_t *)data;
+        const uint32_t t = to_hub_time(ev->ts_us);
+        if (ev->has_power) pending_push(ev->device_id, HUB_TS_ATTR_POWER_W, t, ev->power_w);
+        if (ev->has_temperature) pending_push(ev->device_id, HUB_TS_ATTR_TEMPERATURE_C, t, ev->temperature_c);
+    } else {
+        return;
+    }
+
+    // Busy (snapshot or HTTP read): the samples wait for the next event or the lock holder.
+    if (xSemaphoreTake(s_mu, 0) == pdTRUE) {
+        pending_drain_locked();
+        xSemaphoreGive(s_mu);
+    }
+}
+
+// --- flash ------------------------------------------------------------------
+
+static esp_err_t region_write(void *ctx, size_t off, const void *data, size_t len) {
+    const region_t *r = (const region_t *)ctx;
+    return esp_partition_write(r->part, r->base + off, data, len);
+}
+
+static esp_err_t region_read(void *ctx, size_t off, void *data, size_t len) {
+    const region_t *r = (const region_t *)ctx;
+    return esp_partition_read(r->part, r->base + off, data, len);
+}
+
+static void restore_newest(void) {
+    hub_tsdb_file_info_t info[2];
+    esp_err_t err[2];
+    for (int i = 0; i < 2; i++) {
+        region_t r = {.part = s_part, .base = (size_t)i * s_region_size};
+        err[i] = hub_tsdb_check(s_region_size, region_read, &r, &info[i]);
+        if (err[i] != ESP_OK && err[i] != ESP_ERR_NOT_FOUND) {
+            ESP_LOGW(TAG, "snapshot %d unusable: %s", i, esp_err_to_name(err[i]));
+        }
+    }
+
+    int pick = -1;
+    if (err[0] == ESP_OK) pick = 0;
+    if (err[1] == ESP_OK && (pick < 0 || (int32_t)(info[1].seq - info[0].seq) > 0)) pick = 1;
+    if (pick < 0) {
+        ESP_LOGI(TAG, "no telemetry snapshot");
+        return;
+    }
+
+    // Even if the load fails, keep the clock ahead of everything saved.
+    s_t_base = info[pick].saved_t + 1;
+    s_stats.seq = info[pick].seq;
+    region_t r = {.part = s_part, .base = (size_t)pick * s_region_size};
+    const esp_err_t e = hub_tsdb_load(&s_db, s_region_size, region_read, &r, &info[pick]);
+    if (e != ESP_OK) {
+        ESP_LOGW(TAG, "snapshot %d load failed: %s", pick, esp_err_to_name(e));
+        return;
+    }
+    s_active = pick;
+    ESP_LOGI(TAG, "restored snapshot seq=%" PRIu32 " (%u series, %" PRIu32 " bytes), clock resumes at %" PRIu32,
+             info[pick].seq, (unsigned)s_db.n, info[pick].body_len, s_t_base);
+}
+
+static void save_snapshot(void) {
+    const int next = (s_active == 0) ? 1 : 0;
+    region_t r = {.part = s_part, .base = (size_t)next * s_region_size};
+
+    // Erase without the lock: it takes the longest and touches no RAM state.
+    esp_err_t err = esp_partition_erase_range(s_part, r.base, s_region_size);
+    size_t len = 0;
+    const int64_t t0 = esp_timer_get_time();
+    if (err == ESP_OK) {
+        xSemaphoreTake(s_mu, portMAX_DELAY);
+        pending_drain_locked();
+        err = hub_tsdb_save(&s_db, s_stats.seq + 1, hub_telemetry_now(), s_region_size, region_write, &r, &len);
+        pending_drain_locked();
+        xSemaphoreGive(s_mu);
+    }
+
+    const uint32_t ms = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    if (err == ESP_OK) {
+        s_active = next;
+        s_stats.seq++;
+        s_stats.saves++;
+        s_stats.last_save_bytes = (uint32_t)len;
+        s_stats.last_save_ms = ms;
+    } else {
+        s_stats.save_failures++;
+    }
+    xSemaphoreGive(s_mu);
+    if (err != ESP_OK) ESP_LOGW(TAG, "snapshot save failed: %s", esp_err_to_name(err));
+}
+
+static void save_task(void *arg) {
+    (void)arg;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS((uint32_t)CONFIG_TUTORIAL_0029_TSDB_SAVE_INTERVAL_S * 1000));
+        save_snapshot();
+    }
+}
+
+// --- API --------------------------------------------------------------------
+
+esp_err_t hub_telemetry_start(esp_event_loop_handle_t loop) {
+    if (!loop) return ESP_ERR_INVALID_ARG;
+    if (s_ready) return ESP_OK;
+
+    if (!s_mu) {
+        s_mu = xSemaphoreCreateMutex();
+        if (!s_mu) return ESP_ERR_NO_MEM;
+    }
+
+    const hub_tsdb_cfg_t cfg = {
+        .points = {CONFIG_TUTORIAL_0029_TSDB_POINTS_1S, CONFIG_TUTORIAL_0029_TSDB_POINTS_1M,
+                   CONFIG_TUTORIAL_0029_TSDB_POINTS_1H},
+    };
+    size_t cap = 0;
+    size_t bytes = 0;
+    void *mem = alloc_store(&cfg, &cap, &bytes);
+    if (!mem) {
+        ESP_LOGE(TAG, "no memory for %d telemetry series (%u bytes, largest free block %u)", TSDB_MIN_SERIES,
+                 (unsigned)hub_tsdb_mem_size(&cfg, TSDB_MIN_SERIES),
+                 (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+        return ESP_ERR_NO_MEM;
+    }
+    if (cap < TSDB_SERIES) {
+        ESP_LOGW(TAG, "low memory: keeping %u of %d telemetry series", (unsigned)cap, TSDB_SERIES);
+    }
+    ESP_ERROR_CHECK(hub_tsdb_init(&s_db, &cfg, cap, mem));
+    s_stats.ram_bytes = (uint32_t)bytes;
+    s_stats.series_cap = (uint32_t)cap;
+
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, TSDB_PARTITION_SUBTYPE, TSDB_PARTITION_LABEL);
+    if (s_part) {
+        s_region_size = (s_part->size / 2) & ~(size_t)(SPI_FLASH_SEC_SIZE - 1);
+        s_stats.region_bytes = (uint32_t)s_region_size;
+        restore_newest();
+    } else {
+        ESP_LOGW(TAG, "no \"%s\" partition: telemetry is not persisted", TSDB_PARTITION_LABEL);
+    }
+    s_ready = true;
+
+    esp_err_t err = esp_event_handler_register_with(loop, HUB_EVT, HUB_EVT_DEVICE_STATE, &on_device_event, NULL);
+    if (err == ESP_OK) {
+        err = esp_event_handler_register_with(loop, HUB_EVT, HUB_EVT_DEVICE_REPORT, &on_device_event, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_event_handler_register_with failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    if (s_part && xTaskCreate(save_task, "hub_tsdb", 4096, NULL, 3, &s_task) != pdPASS) {
+        s_task = NULL;
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "telemetry ready (series=%u ram=%u bytes, snapshot every %ds)", (unsigned)cap, (unsigned)bytes,
+             CONFIG_TUTORIAL_0029_TSDB_SAVE_INTERVAL_S);
+    return ESP_OK;
+}
+
+esp_err_t hub_telemetry_has_series(uint32_t device_id, uint8_t attr) {
+    if (!s_ready) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    const bool found = hub_tsdb_find(&s_db, device_id, attr) != NULL;
+    xSemaphoreGive(s_mu);
+    return found ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+size_t hub_telemetry_read(uint32_t device_id, uint8_t attr, hub_tsdb_tier_t tier, uint32_t *cursor, uint32_t to,
+                          hub_tsdb_point_t *out, size_t max_out) {
+    if (!s_ready) return 0;
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    pending_drain_locked();
+    const size_t n = hub_tsdb_read(&s_db, device_id, attr, tier, cursor, to, out, max_out);
+    xSemaphoreGive(s_mu);
+    return n;
+}
+
+void hub_telemetry_get_stats(hub_telemetry_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!s_ready) return;
+
+    xSemaphoreTake(s_mu, portMAX_DELAY);
+    *out = s_stats;
+    out->series = (uint32_t)s_db.n;
+    out->inserts = s_db.stats.inserts;
+    out->series_full = s_db.stats.series_full;
+    out->late = s_db.stats.late;
+    xSemaphoreGive(s_mu);
+
+    portENTER_CRITICAL(&s_pending_mu);
+    out->pending_drops = s_pending_drops;
+    portEXIT_CRITICAL(&s_pending_mu);
+}
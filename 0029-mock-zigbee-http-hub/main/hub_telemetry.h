@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_event.h"
+
+#include "hub_tsdb.h"
+
+// Telemetry history: records device state/report events from the hub bus into
+// a hub_tsdb store and snapshots its 1 min / 1 h tiers to the "tsdb" flash
+// partition every CONFIG_TUTORIAL_0029_TSDB_SAVE_INTERVAL_S.
+//
+// Times are on the hub clock (seconds): uptime plus the save time of the
+// snapshot restored at boot, so it keeps increasing across reboots. There is
+// no wall clock on this hub.
+
+esp_err_t hub_telemetry_start(esp_event_loop_handle_t loop);
+
+uint32_t hub_telemetry_now(void);
+
+// Locked hub_tsdb_find(): ESP_ERR_NOT_FOUND if the series has no samples.
+esp_err_t hub_telemetry_has_series(uint32_t device_id, uint8_t attr);
+
+// Locked hub_tsdb_read(); see there for the cursor.
+size_t hub_telemetry_read(uint32_t device_id, uint8_t attr, hub_tsdb_tier_t tier, uint32_t *cursor, uint32_t to,
+                          hub_tsdb_point_t *out, size_t max_out);
+
+typedef struct {
+    uint32_t series;
+    uint32_t series_cap;
+    uint32_t inserts;
+    uint32_t series_full;
+    uint32_t late;
+    uint32_t pending_drops; // samples lost while the store was busy (snapshot)
+    uint32_t saves;
+    uint32_t save_failures;
+    uint32_t last_save_bytes;
+    uint32_t last_save_ms;
+    uint32_t seq;           // of the newest snapshot
+    uint32_t ram_bytes;
+    uint32_t region_bytes;  // per snapshot copy; 0 without a tsdb partition
+} hub_telemetry_stats_t;
+
+void hub_telemetry_get_stats(hub_telemetry_stats_t *out);
@@ -0,0 +1,574 @@
+/*
+ * Telemetry time-series store for tutorial 0029: downsampling rings, flash
+ * snapshot format and hub.v1.TelemetrySeries encoding.
+ *
+ * Plain C (no FreeRTOS, no flash API), so it can be tested and benchmarked on
+ * the host (tools/tsdb_host).
+ */
+
+#include "hub_tsdb.h"
+
+#include <math.h>
+#include <string.h>
+
+#define FILE_MAGIC 0x31535448u // "HTS1"
+#define FILE_VERSION 1
+#define IO_CHUNK 256
+
+static const uint32_t k_period_s[HUB_TSDB_TIERS] = {1, 60, 3600};
+
+// Persisted values are quantised to 10^-exp of the attribute's unit.
+static uint8_t attr_scale_exp(uint8_t attr) {
+    switch (attr) {
+        case HUB_TS_ATTR_ON:
+        case HUB_TS_ATTR_LEVEL:
+        case HUB_TS_ATTR_COLOR_TEMP:
+            return 0;
+        case HUB_TS_ATTR_POWER_W:
+        case HUB_TS_ATTR_TEMPERATURE_C:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+uint32_t hub_tsdb_period_s(hub_tsdb_tier_t tier) {
+    return ((unsigned)tier < HUB_TSDB_TIERS) ? k_period_s[tier] : 0;
+}
+
+static size_t index_len(size_t cap) {
+    size_t n = 4;
+    while (n < 2 * cap) n <<= 1;
+    return n;
+}
+
+static size_t points_per_series(const hub_tsdb_cfg_t *cfg) {
+    return (size_t)cfg->points[0] + cfg->points[1] + cfg->points[2];
+}
+
+size_t hub_tsdb_mem_size(const hub_tsdb_cfg_t *cfg, size_t cap) {
+    return cap * sizeof(hub_tsdb_series_t) + index_len(cap) * sizeof(uint16_t) +
+           cap * points_per_series(cfg) * sizeof(hub_tsdb_point_t);
+}
+
+esp_err_t hub_tsdb_init(hub_tsdb_t *db, const hub_tsdb_cfg_t *cfg, size_t cap, void *mem) {
+    if (!db || !cfg || !mem || cap == 0 || cap > 32767) return ESP_ERR_INVALID_ARG;
+    for (size_t k = 0; k < HUB_TSDB_TIERS; k++) {
+        if (cfg->points[k] == 0) return ESP_ERR_INVALID_ARG;
+    }
+    memset(db, 0, sizeof(*db));
+    db->cfg = *cfg;
+    db->cap = cap;
+    db->per_series = points_per_series(cfg);
+
+    uint8_t *p = mem;
+    db->series = (hub_tsdb_series_t *)p;
+    p += cap * sizeof(hub_tsdb_series_t);
+    db->index = (uint16_t *)p;
+    db->index_mask = index_len(cap) - 1;
+    p += index_len(cap) * sizeof(uint16_t);
+    db->points = (hub_tsdb_point_t *)p;
+    return ESP_OK;
+}
+
+static inline size_t key_hash(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr) {
+    return (size_t)((device_id * HUB_TSDB_MAX_ATTRS + attr) * 0x9E3779B1u) & db->index_mask;
+}
+
+// Index slot of the series, or of the empty slot where it would go.
+static size_t index_slot(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr) {
+    size_t i = key_hash(db, device_id, attr);
+    while (db->index[i] != 0) {
+        const hub_tsdb_series_t *s = &db->series[db->index[i] - 1];
+        if (s->device_id == device_id && s->attr == attr) break;
+        i = (i + 1) & db->index_mask;
+    }
+    return i;
+}
+
+static int series_get(hub_tsdb_t *db, uint32_t device_id, uint8_t attr, bool create) {
+    const size_t slot = index_slot(db, device_id, attr);
+    if (db->index[slot]) return db->index[slot] - 1;
+    if (!create || db->n >= db->cap) return -1;
+
+    const size_t idx = db->n++;
+    hub_tsdb_series_t *s = &db->series[idx];
+    s->device_id = device_id;
+    s->attr = attr;
+    s->last_t = 0;
+    db->index[slot] = (uint16_t)(idx + 1);
+    return (int)idx;
+}
+
+static hub_tsdb_point_t *ring(const hub_tsdb_t *db, size_t idx, size_t tier) {
+    size_t off = idx * db->per_series;
+    for (size_t k = 0; k < tier; k++) off += db->cfg.points[k];
+    return &db->points[off];
+}
+
+const hub_tsdb_series_t *hub_tsdb_find(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr) {
+    if (!db || device_id == 0) return NULL;
+    const size_t slot = index_slot(db, device_id, attr);
+    return db->index[slot] ? &db->series[db->index[slot] - 1] : NULL;
+}
+
+static void fold(hub_tsdb_t *db, hub_tsdb_point_t *r, uint16_t len, uint32_t period, uint32_t t, float v) {
+    const uint32_t bt = t - t % period;
+    hub_tsdb_point_t *p = &r[(t / period) % len];
+    if (p->count == 0 || p->t < bt) {
+        p->t = bt;
+        p->min = v;
+        p->max = v;
+        p->sum = v;
+        p->count = 1;
+        return;
+    }
+    if (p->t > bt) {
+        db->stats.late++;
+        return;
+    }
+    if (v < p->min) p->min = v;
+    if (v > p->max) p->max = v;
+    p->sum += v;
+    p->count++;
+}
+
+bool hub_tsdb_insert(hub_tsdb_t *db, uint32_t device_id, uint8_t attr, uint32_t t, float v) {
+    if (device_id == 0 || attr >= HUB_TSDB_MAX_ATTRS || isnan(v)) return false;
+    const int idx = series_get(db, device_id, attr, true);
+    if (idx < 0) {
+        db->stats.series_full++;
+        return false;
+    }
+    hub_tsdb_series_t *s = &db->series[idx];
+    if (t > s->last_t) s->last_t = t;
+    for (size_t k = 0; k < HUB_TSDB_TIERS; k++) {
+        fold(db, ring(db, (size_t)idx, k), db->cfg.points[k], k_period_s[k], t, v);
+    }
+    db->stats.inserts++;
+    return true;
+}
+
+size_t hub_tsdb_read(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr, hub_tsdb_tier_t tier, uint32_t *cursor,
+                     uint32_t to, hub_tsdb_point_t *out, size_t max_out) {
+    if (!db || !cursor || !out || max_out == 0 || (unsigned)tier >= HUB_TSDB_TIERS) return 0;
+    const hub_tsdb_series_t *s = hub_tsdb_find(db, device_id, attr);
+    if (!s) return 0;
+
+    const uint32_t end = (to < s->last_t) ? to : s->last_t;
+    if (*cursor > end) return 0;
+
+    const uint32_t period = k_period_s[tier];
+    const uint16_t len = db->cfg.points[tier];
+    const hub_tsdb_point_t *r = ring(db, (size_t)(s - db->series), tier);
+    const uint32_t last_b = end / period;
+    const uint32_t oldest = (last_b >= len) ? last_b - len + 1 : 0;
+    uint32_t b = *cursor / period;
+    if (b < oldest) b = oldest;
+
+    size_t n = 0;
+    for (; b <= last_b && n < max_out; b++) {
+        const hub_tsdb_point_t *p = &r[b % len];
+        if (p->count && p->t == b * period) out[n++] = *p;
+    }
+    // Next call starts at the following bucket; past `end` once the range is done.
+    *cursor = (b > last_b) ? ((end == UINT32_MAX) ? end : end + 1) : b * period;
+    return n;
+}
+
+// --- flash snapshot -------------------------------------------------------
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t len) {
+    static const uint32_t k_tab[16] = {
+        0x00000000u, 0x1db71064u, 0x3b6e20c8u, 0x26d930acu, 0x76dc4190u, 0x6b6b51f4u, 0x4db26158u, 0x5005713cu,
+        0xedb88320u, 0xf00f9344u, 0xd6d6a3e8u, 0xcb61b38cu, 0x9b64c2b0u, 0x86d3d2d4u, 0xa00ae278u, 0xbdbdf21cu,
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = (crc >> 4) ^ k_tab[(crc ^ p[i]) & 0x0f];
+        crc = (crc >> 4) ^ k_tab[(crc ^ (p[i] >> 4)) & 0x0f];
+    }
+    return ~crc;
+}
+
+typedef struct {
+    hub_tsdb_write_fn write;
+    void *ctx;
+    size_t off;
+    size_t cap;
+    uint32_t crc;
+    esp_err_t err;
+    size_t len;
+    uint8_t buf[IO_CHUNK];
+} fwriter_t;
+
+static void fw_flush(fwriter_t *w) {
+    if (w->err != ESP_OK || w->len == 0) return;
+    if (w->off + w->len > w->cap) {
+        w->err = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+    w->err = w->write(w->ctx, w->off, w->buf, w->len);
+    w->crc = crc32_update(w->crc, w->buf, w->len);
+    w->off += w->len;
+    w->len = 0;
+}
+
+static void fw_byte(fwriter_t *w, uint8_t b) {
+    if (w->len == sizeof(w->buf)) fw_flush(w);
+    w->buf[w->len++] = b;
+}
+
+static void fw_varint(fwriter_t *w, uint64_t v) {
+    do {
+        const uint8_t b = (uint8_t)(v & 0x7f);
+        v >>= 7;
+        fw_byte(w, v ? (uint8_t)(b | 0x80) : b);
+    } while (v);
+}
+
+static int32_t quantise(float v, uint8_t exp) {
+    double q = (double)v;
+    for (uint8_t i = 0; i < exp; i++) q *= 10.0;
+    q = round(q);
+    if (q > INT32_MAX) return INT32_MAX;
+    if (q < INT32_MIN) return INT32_MIN;
+    return (int32_t)q;
+}
+
+static float dequantise(int64_t q, uint8_t exp) {
+    double v = (double)q;
+    for (uint8_t i = 0; i < exp; i++) v /= 10.0;
+    return (float)v;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Persisted tiers: the 1 s ring only covers the last minutes and is rebuilt quickly.
+static const size_t k_saved_tiers[] = {HUB_TSDB_TIER_1M, HUB_TSDB_TIER_1H};
+
+// Valid buckets of a ring in time order: first bucket number and count.
+static size_t ring_span(const hub_tsdb_t *db, size_t idx, size_t tier, uint32_t *out_first_b) {
+    const hub_tsdb_series_t *s = &db->series[idx];
+    const uint16_t len = db->cfg.points[tier];
+    const uint32_t period = k_period_s[tier];
+    const hub_tsdb_point_t *r = ring(db, idx, tier);
+    const uint32_t last_b = s->last_t / period;
+    const uint32_t oldest = (last_b >= len) ? last_b - len + 1 : 0;
+    size_t n = 0;
+    for (uint32_t b = oldest; b <= last_b; b++) {
+        const hub_tsdb_point_t *p = &r[b % len];
+        if (p->count && p->t == b * period) {
+            if (n == 0) *out_first_b = b;
+            n++;
+        }
+    }
+    return n;
+}
+
+static void write_tier(fwriter_t *w, const hub_tsdb_t *db, size_t idx, size_t tier, uint8_t exp) {
+    uint32_t b = 0;
+    const size_t n = ring_span(db, idx, tier, &b);
+    fw_varint(w, n);
+    if (n == 0) return;
+    fw_varint(w, b);
+
+    const uint16_t len = db->cfg.points[tier];
+    const uint32_t period = k_period_s[tier];
+    const hub_tsdb_point_t *r = ring(db, idx, tier);
+    uint32_t prev_b = b;
+    int64_t prev_q = 0;
+    for (size_t written = 0; written < n; b++) {
+        const hub_tsdb_point_t *p = &r[b % len];
+        if (!p->count || p->t != b * period) continue;
+        if (written > 0) fw_varint(w, b - prev_b);
+        const int32_t q_avg = quantise(p->sum / (float)p->count, exp);
+        const int32_t q_min = quantise(p->min, exp);
+        const int32_t q_max = quantise(p->max, exp);
+        fw_varint(w, p->count);
+        fw_varint(w, zigzag((int64_t)q_avg - prev_q));
+        fw_varint(w, (uint64_t)((int64_t)q_avg - q_min));
+        fw_varint(w, (uint64_t)((int64_t)q_max - q_avg));
+        prev_b = b;
+        prev_q = q_avg;
+        written++;
+    }
+}
+
+static void put_u16le(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32le(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+esp_err_t hub_tsdb_save(const hub_tsdb_t *db, uint32_t seq, uint32_t now, size_t cap, hub_tsdb_write_fn write,
+                        void *ctx, size_t *out_len) {
+    if (!db || !write || cap < HUB_TSDB_FILE_HEADER) return ESP_ERR_INVALID_ARG;
+
+    fwriter_t w = {.write = write, .ctx = ctx, .off = HUB_TSDB_FILE_HEADER, .cap = cap, .err = ESP_OK};
+    size_t n_saved = 0;
+    for (size_t i = 0; i < db->n; i++) {
+        uint32_t b;
+        if (ring_span(db, i, HUB_TSDB_TIER_1M, &b) || ring_span(db, i, HUB_TSDB_TIER_1H, &b)) n_saved++;
+    }
+    fw_varint(&w, n_saved);
+    for (size_t i = 0; i < db->n && w.err == ESP_OK; i++) {
+        uint32_t b;
+        if (!ring_span(db, i, HUB_TSDB_TIER_1M, &b) && !ring_span(db, i, HUB_TSDB_TIER_1H, &b)) continue;
+        const hub_tsdb_series_t *s = &db->series[i];
+        const uint8_t exp = attr_scale_exp(s->attr);
+        fw_varint(&w, s->device_id);
+        fw_byte(&w, s->attr);
+        fw_byte(&w, exp);
+        fw_varint(&w, s->last_t);
+        for (size_t k = 0; k < sizeof(k_saved_tiers) / sizeof(k_saved_tiers[0]); k++) {
+            write_tier(&w, db, i, k_saved_tiers[k], exp);
+        }
+    }
+    fw_flush(&w);
+    if (w.err != ESP_OK) return w.err;
+
+    uint8_t hdr[HUB_TSDB_FILE_HEADER];
+    const uint32_t body_len = (uint32_t)(w.off - HUB_TSDB_FILE_HEADER);
+    put_u32le(&hdr[0], FILE_MAGIC);
+    put_u16le(&hdr[4], FILE_VERSION);
+    put_u16le(&hdr[6], 0);
+    put_u32le(&hdr[8], seq);
+    put_u32le(&hdr[12], now);
+    put_u32le(&hdr[16], body_len);
+    put_u32le(&hdr[20], w.crc);
+    esp_err_t err = write(ctx, 0, hdr, sizeof(hdr));
+    if (err == ESP_OK && out_len) *out_len = w.off;
+    return err;
+}
+
+esp_err_t hub_tsdb_check(size_t cap, hub_tsdb_read_fn read, void *ctx, hub_tsdb_file_info_t *out) {
+    if (!read || cap < HUB_TSDB_FILE_HEADER) return ESP_ERR_INVALID_ARG;
+    uint8_t hdr[HUB_TSDB_FILE_HEADER];
+    esp_err_t err = read(ctx, 0, hdr, sizeof(hdr));
+    if (err != ESP_OK) return err;
+    if (get_u32le(&hdr[0]) != FILE_MAGIC) return ESP_ERR_NOT_FOUND;
+    if ((hdr[4] | (hdr[5] << 8)) != FILE_VERSION) return ESP_ERR_INVALID_VERSION;
+
+    const uint32_t body_len = get_u32le(&hdr[16]);
+    if (body_len > cap - HUB_TSDB_FILE_HEADER) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t buf[IO_CHUNK];
+    uint32_t crc = 0;
+    for (size_t off = 0; off < body_len;) {
+        const size_t n = (body_len - off < sizeof(buf)) ? body_len - off : sizeof(buf);
+        err = read(ctx, HUB_TSDB_FILE_HEADER + off, buf, n);
+        if (err != ESP_OK) return err;
+        crc = crc32_update(crc, buf, n);
+        off += n;
+    }
+    if (crc != get_u32le(&hdr[20])) return ESP_ERR_INVALID_CRC;
+
+    if (out) {
+        out->seq = get_u32le(&hdr[8]);
+        out->saved_t = get_u32le(&hdr[12]);
+        out->body_len = body_len;
+    }
+    return ESP_OK;
+}
+
+typedef struct {
+    hub_tsdb_read_fn read;
+    void *ctx;
+    size_t off; // next file offset to fetch
+    size_t end;
+    size_t pos;
+    size_t len;
+    bool ok;
+    uint8_t buf[IO_CHUNK];
+} freader_t;
+
+static bool fr_byte(freader_t *r, uint8_t *out) {
+    if (r->pos == r->len) {
+        const size_t n = (r->end - r->off < sizeof(r->buf)) ? r->end - r->off : sizeof(r->buf);
+        if (n == 0 || r->read(r->ctx, r->off, r->buf, n) != ESP_OK) {
+            r->ok = false;
+            return false;
+        }
+        r->off += n;
+        r->pos = 0;
+        r->len = n;
+    }
+    *out = r->buf[r->pos++];
+    return true;
+}
+
+static uint64_t fr_varint(freader_t *r) {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        uint8_t b = 0;
+        if (!fr_byte(r, &b)) return 0;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    r->ok = false;
+    return 0;
+}
+
+static void read_tier(freader_t *r, hub_tsdb_t *db, int idx, size_t tier, uint8_t exp) {
+    const uint64_t n = fr_varint(r);
+    if (!r->ok || n == 0) return;
+    const uint16_t len = db->cfg.points[tier];
+    const uint32_t period = k_period_s[tier];
+    hub_tsdb_point_t *ring_p = (idx >= 0) ? ring(db, (size_t)idx, tier) : NULL;
+
+    uint64_t b = fr_varint(r);
+    int64_t q_avg = 0;
+    for (uint64_t i = 0; i < n && r->ok; i++) {
+        if (i > 0) {
+            const uint64_t gap = fr_varint(r);
+            if (gap == 0) r->ok = false;
+            b += gap;
+        }
+        const uint64_t count = fr_varint(r);
+        q_avg += unzigzag(fr_varint(r));
+        const int64_t q_min = q_avg - (int64_t)fr_varint(r);
+        const int64_t q_max = q_avg + (int64_t)fr_varint(r);
+        if (!r->ok || count == 0 || count > UINT32_MAX || b * period > UINT32_MAX) {
+            r->ok = false;
+            return;
+        }
+        if (!ring_p) continue; // series table full: skip its points
+
+        // Later buckets overwrite older ones when the ring is now shorter.
+        hub_tsdb_point_t *p = &ring_p[b % len];
+        const uint32_t bt = (uint32_t)(b * period);
+        if (p->count && p->t > bt) continue;
+        p->t = bt;
+        p->count = (uint32_t)count;
+        p->min = dequantise(q_min, exp);
+        p->max = dequantise(q_max, exp);
+        p->sum = dequantise(q_avg, exp) * (float)count;
+    }
+}
+
+esp_err_t hub_tsdb_load(hub_tsdb_t *db, size_t cap, hub_tsdb_read_fn read, void *ctx, hub_tsdb_file_info_t *out) {
+    if (!db) return ESP_ERR_INVALID_ARG;
+    hub_tsdb_file_info_t info;
+    esp_err_t err = hub_tsdb_check(cap, read, ctx, &info);
+    if (err != ESP_OK) return err;
+
+    freader_t *r = &(freader_t){
+        .read = read,
+        .ctx = ctx,
+        .off = HUB_TSDB_FILE_HEADER,
+        .end = HUB_TSDB_FILE_HEADER + info.body_len,
+        .ok = true,
+    };
+    const uint64_t n_series = fr_varint(r);
+    for (uint64_t i = 0; i < n_series && r->ok; i++) {
+        const uint64_t device_id = fr_varint(r);
+        uint8_t attr = 0, exp = 0;
+        (void)fr_byte(r, &attr);
+        (void)fr_byte(r, &exp);
+        const uint64_t last_t = fr_varint(r);
+        if (!r->ok || device_id == 0 || device_id > UINT32_MAX || attr >= HUB_TSDB_MAX_ATTRS || exp > 9 ||
+            last_t > UINT32_MAX) {
+            r->ok = false;
+            break;
+        }
+        const int idx = series_get(db, (uint32_t)device_id, attr, true);
+        if (idx < 0) {
+            db->stats.series_full++;
+        } else if (last_t > db->series[idx].last_t) {
+            db->series[idx].last_t = (uint32_t)last_t;
+        }
+        for (size_t k = 0; k < sizeof(k_saved_tiers) / sizeof(k_saved_tiers[0]) && r->ok; k++) {
+            read_tier(r, db, idx, k_saved_tiers[k], exp);
+        }
+    }
+    if (!r->ok) return ESP_FAIL;
+    if (out) *out = info;
+    return ESP_OK;
+}
+
+// --- wire encoding ----------------------------------------------------------
+
+// Protobuf wire types / field numbers (hub_events.proto).
+#define WT_VARINT 0
+#define WT_LEN 2
+#define WT_I32 5
+
+#define SERIES_DEVICE_ID 1
+#define SERIES_ATTR 2
+#define SERIES_PERIOD_S 3
+#define SERIES_NOW 4
+#define SERIES_POINTS 5
+#define POINT_T 1
+#define POINT_MIN 2
+#define POINT_MAX 3
+#define POINT_AVG 4
+#define POINT_COUNT 5
+
+typedef struct {
+    uint8_t *p;
+    uint8_t *end;
+} out_t;
+
+static bool put_varint(out_t *o, uint32_t v) {
+    do {
+        if (o->p >= o->end) return false;
+        uint8_t b = (uint8_t)(v & 0x7f);
+        v >>= 7;
+        *o->p++ = v ? (uint8_t)(b | 0x80) : b;
+    } while (v);
+    return true;
+}
+
+static bool put_u32_field(out_t *o, uint32_t field, uint32_t v) {
+    if (v == 0) return true;
+    return put_varint(o, (field << 3) | WT_VARINT) && put_varint(o, v);
+}
+
+static bool put_float_field(out_t *o, uint32_t field, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (bits == 0) return true;
+    if (!put_varint(o, (field << 3) | WT_I32) || o->end - o->p < 4) return false;
+    for (int i = 0; i < 4; i++) {
+        *o->p++ = (uint8_t)(bits >> (8 * i));
+    }
+    return true;
+}
+
+bool hub_tsdb_encode_series_header(uint32_t device_id, uint8_t attr, uint32_t period_s, uint32_t now, uint8_t *out,
+                                   size_t cap, size_t *out_len) {
+    out_t o = {.p = out, .end = out + cap};
+    const bool ok = put_u32_field(&o, SERIES_DEVICE_ID, device_id) && put_u32_field(&o, SERIES_ATTR, attr) &&
+                    put_u32_field(&o, SERIES_PERIOD_S, period_s) && put_u32_field(&o, SERIES_NOW, now);
+    if (ok) *out_len = (size_t)(o.p - out);
+    return ok;
+}
+
+bool hub_tsdb_encode_point_entry(const hub_tsdb_point_t *p, uint8_t *out, size_t cap, size_t *out_len) {
+    if (cap < 2) return false;
+    // Body two bytes in (it is always < 128 bytes), then tag + length in front.
+    out_t o = {.p = out + 2, .end = out + cap};
+    const float avg = p->count ? p->sum / (float)p->count : 0.0f;
+    const bool ok = put_u32_field(&o, POINT_T, p->t) && put_float_field(&o, POINT_MIN, p->min) &&
+                    put_float_field(&o, POINT_MAX, p->max) && put_float_field(&o, POINT_AVG, avg) &&
+                    put_u32_field(&o, POINT_COUNT, p->count);
+    if (!ok) return false;
+    out[0] = (uint8_t)((SERIES_POINTS << 3) | WT_LEN);
+    out[1] = (uint8_t)(o.p - out - 2);
+    *out_len = (size_t)(o.p - out);
+    return true;
+}
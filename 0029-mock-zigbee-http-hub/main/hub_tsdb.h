@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Fixed-memory time-series store for device telemetry (hub_telemetry.c).
+//
+// One series per (device, attribute). Each series keeps three rings of
+// downsampled buckets - 1 s, 1 min and 1 h - holding min/max/avg/count. An
+// insert folds the sample into the current bucket of every tier, so all tiers
+// are always up to date and nothing is recomputed on read. Rings overwrite
+// their oldest bucket; memory is sized once by hub_tsdb_mem_size().
+//
+// Snapshots of the 1 min and 1 h tiers go to flash in a compact format:
+// per series a start bucket, then per bucket a varint gap, count and zigzag
+// delta of the quantised average, with min/max stored as distances from it.
+//
+// Plain C with no locking: the caller serializes access.
+
+#define HUB_TSDB_TIERS 3
+#define HUB_TSDB_MAX_ATTRS 8
+
+// Values match hub.v1.TelemetryAttr.
+typedef enum {
+    HUB_TS_ATTR_ON = 1,
+    HUB_TS_ATTR_LEVEL = 2,
+    HUB_TS_ATTR_POWER_W = 3,
+    HUB_TS_ATTR_TEMPERATURE_C = 4,
+    HUB_TS_ATTR_COLOR_TEMP = 5,
+} hub_ts_attr_t;
+
+typedef enum {
+    HUB_TSDB_TIER_1S = 0,
+    HUB_TSDB_TIER_1M = 1,
+    HUB_TSDB_TIER_1H = 2,
+} hub_tsdb_tier_t;
+
+// One downsampled bucket. count == 0: empty.
+typedef struct {
+    uint32_t t; // bucket start, seconds on the hub clock
+    float min;
+    float max;
+    float sum;
+    uint32_t count;
+} hub_tsdb_point_t;
+
+typedef struct {
+    uint32_t device_id; // 0 = free
+    uint8_t attr;
+    uint32_t last_t; // newest sample
+} hub_tsdb_series_t;
+
+typedef struct {
+    uint16_t points[HUB_TSDB_TIERS]; // ring length per tier
+} hub_tsdb_cfg_t;
+
+typedef struct {
+    uint32_t inserts;
+    uint32_t series_full; // samples dropped: no free series
+    uint32_t late;        // tier updates dropped: bucket already overwritten by newer data
+} hub_tsdb_stats_t;
+
+typedef struct {
+    hub_tsdb_cfg_t cfg;
+    size_t cap;
+    size_t n;
+    size_t per_series; // points per series, all tiers
+    hub_tsdb_series_t *series;
+    uint16_t *index; // series position + 1, 0 = empty; linear probing
+    size_t index_mask;
+    hub_tsdb_point_t *points;
+    hub_tsdb_stats_t stats;
+} hub_tsdb_t;
+
+// Bucket length of a tier in seconds.
+uint32_t hub_tsdb_period_s(hub_tsdb_tier_t tier);
+
+// Bytes of zeroed memory hub_tsdb_init() needs for cap series (cap <= 32767).
+size_t hub_tsdb_mem_size(const hub_tsdb_cfg_t *cfg, size_t cap);
+
+// mem: hub_tsdb_mem_size() bytes, zeroed, 4-byte aligned.
+esp_err_t hub_tsdb_init(hub_tsdb_t *db, const hub_tsdb_cfg_t *cfg, size_t cap, void *mem);
+
+// Folds one sample at time t (seconds) into every tier. False if dropped.
+bool hub_tsdb_insert(hub_tsdb_t *db, uint32_t device_id, uint8_t attr, uint32_t t, float v);
+
+const hub_tsdb_series_t *hub_tsdb_find(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr);
+
+// Range read in time order. *cursor is the first bucket time to return
+// (start with the range's "from"); it advances past what was returned, so
+// calling again continues. Returns the number of points written, 0 when the
+// range [*cursor, to] holds nothing more.
+size_t hub_tsdb_read(const hub_tsdb_t *db, uint32_t device_id, uint8_t attr, hub_tsdb_tier_t tier, uint32_t *cursor,
+                     uint32_t to, hub_tsdb_point_t *out, size_t max_out);
+
+// --- flash snapshot -------------------------------------------------------
+
+#define HUB_TSDB_FILE_HEADER 24
+
+typedef esp_err_t (*hub_tsdb_write_fn)(void *ctx, size_t off, const void *data, size_t len);
+typedef esp_err_t (*hub_tsdb_read_fn)(void *ctx, size_t off, void *data, size_t len);
+
+typedef struct {
+    uint32_t seq;
+    uint32_t saved_t; // hub clock at save time
+    uint32_t body_len;
+} hub_tsdb_file_info_t;
+
+// Writes a snapshot into a region of cap bytes (already erased): body first,
+// header at offset 0 last, so a torn write never has a valid header.
+// ESP_ERR_INVALID_SIZE: the region is too small.
+esp_err_t hub_tsdb_save(const hub_tsdb_t *db, uint32_t seq, uint32_t now, size_t cap, hub_tsdb_write_fn write,
+                        void *ctx, size_t *out_len);
+
+// Validates header and CRC. ESP_ERR_NOT_FOUND: no snapshot. ESP_ERR_INVALID_CRC: damaged.
+esp_err_t hub_tsdb_check(size_t cap, hub_tsdb_read_fn read, void *ctx, hub_tsdb_file_info_t *out);
+
+// Restores the 1 min / 1 h tiers from a checked snapshot into an empty db.
+esp_err_t hub_tsdb_load(hub_tsdb_t *db, size_t cap, hub_tsdb_read_fn read, void *ctx, hub_tsdb_file_info_t *out);
+
+// --- wire encoding (hub.v1.TelemetrySeries) --------------------------------
+
+// Upper bound of one encoded points entry (tag + length + TelemetryPoint).
+#define HUB_TSDB_POINT_ENTRY_MAX 32
+
+// TelemetrySeries fields other than points; false if cap is too small.
+bool hub_tsdb_encode_series_header(uint32_t device_id, uint8_t attr, uint32_t period_s, uint32_t now, uint8_t *out,
+                                   size_t cap, size_t *out_len);
+
+// One TelemetrySeries.points entry.
+bool hub_tsdb_encode_point_entry(const hub_tsdb_point_t *p, uint8_t *out, size_t cap, size_t *out_len);
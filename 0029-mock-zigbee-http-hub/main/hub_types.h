@@ -3,9 +3,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
-
 #include "esp_err.h"
 #include "esp_event.h"
 
@@ -26,6 +23,9 @@ typedef enum {
     HUB_EVT_DEVICE_INTERVIEWED,
     HUB_EVT_DEVICE_STATE,
     HUB_EVT_DEVICE_REPORT,
+
+    // Appended to keep the values above stable (they are on the wire as hub.v1.EventId).
+    HUB_CMD_GROUP_SET,
 } hub_event_id_t;
 
 typedef enum {
@@ -39,6 +39,7 @@ enum {
     HUB_CAP_LEVEL = 1u << 1,
     HUB_CAP_POWER = 1u << 2,
     HUB_CAP_TEMPERATURE = 1u << 3,
+    HUB_CAP_COLOR_TEMP = 1u << 4,
 };
 
 typedef struct {
@@ -51,11 +52,11 @@ typedef struct {
     uint8_t level; // 0..100
     float power_w;
     float temperature_c;
+    uint16_t color_mireds; // color temperature, HUB_CAP_COLOR_TEMP only
 } hub_device_t;
 
 typedef struct {
-    uint32_t req_id;
-    QueueHandle_t reply_q; // optional; used for HTTP request/response.
+    uint32_t req_id; // hub_reply slot to complete; 0 = no reply wanted.
 } hub_cmd_hdr_t;
 
 typedef struct {
@@ -64,10 +65,6 @@ typedef struct {
     hub_device_t device; // meaningful when status==ESP_OK
 } hub_reply_device_t;
 
-typedef struct {
-    esp_err_t status;
-} hub_reply_status_t;
-
 typedef struct {
     hub_cmd_hdr_t hdr;
     hub_device_type_t type;
@@ -82,8 +79,23 @@ typedef struct {
     bool on;
     bool has_level;
     uint8_t level;
+    bool has_color;
+    uint16_t color_mireds;
+    uint16_t transition_ds; // ZCL transition time; the mock applies targets immediately
 } hub_cmd_device_set_t;
 
+// One command for every member of a scene group (hub_scene.c), like a Zigbee
+// group-addressed frame. Members ignore the parts they don't support.
+typedef struct {
+    hub_cmd_hdr_t hdr;
+    uint16_t group_id;
+    uint8_t flags; // HUB_SCENE_F_* (hub_scene_plan.h)
+    bool on;
+    uint8_t level;
+    uint16_t color_mireds;
+    uint16_t transition_ds;
+} hub_cmd_group_set_t;
+
 typedef struct {
     hub_cmd_hdr_t hdr;
     uint32_t device_id;
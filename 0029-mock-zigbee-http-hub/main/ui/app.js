@@ -1,4 +1,4 @@
-/* Minimal browser-side protobuf decoder for hub.v1.HubEvent (no external deps). */
+/* Minimal browser-side protobuf decoder for hub.v1.HubEventBatch frames (no external deps). */
 
 const WS_PATH = "/v1/events/ws";
 const MAX_EVENTS = 250;
@@ -15,6 +15,7 @@ const EventId = {
   8: "HUB_EVT_DEVICE_INTERVIEWED",
   9: "HUB_EVT_DEVICE_STATE",
   10: "HUB_EVT_DEVICE_REPORT",
+  11: "HUB_CMD_GROUP_SET",
 };
 
 const DeviceType = {
@@ -129,6 +130,9 @@ function decodeDevice(r) {
       case 13:
         out.temperatureC = r.float32();
         break;
+      case 14:
+        out.colorTempMireds = Number(r.varint());
+        break;
       default:
         r.skip(wt);
     }
@@ -294,6 +298,38 @@ function decodeCmdSceneTrigger(r) {
   return out;
 }
 
+function decodeCmdGroupSet(r) {
+  const out = {};
+  while (!r.eof()) {
+    const key = Number(r.varint());
+    const field = key >>> 3;
+    const wt = key & 7;
+    switch (field) {
+      case 1:
+        out.reqId = r.varint();
+        break;
+      case 2:
+        out.groupId = Number(r.varint());
+        break;
+      case 3:
+        out.on = Number(r.varint()) !== 0;
+        break;
+      case 4:
+        out.level = Number(r.varint());
+        break;
+      case 5:
+        out.colorTempMireds = Number(r.varint());
+        break;
+      case 6:
+        out.transitionDs = Number(r.varint());
+        break;
+      default:
+        r.skip(wt);
+    }
+  }
+  return out;
+}
+
 function decodeHubEvent(buf) {
   const r = new PbReader(new Uint8Array(buf));
   const out = { recvIso: nowIso() };
@@ -357,6 +393,88 @@ function decodeHubEvent(buf) {
         out.cmdSceneTrigger = decodeCmdSceneTrigger(new PbReader(r.bytes(n)));
         break;
       }
+      case 24: {
+        const n = Number(r.varint());
+        out.payloadType = "cmd_group_set";
+        out.cmdGroupSet = decodeCmdGroupSet(new PbReader(r.bytes(n)));
+        break;
+      }
+      default:
+        r.skip(wt);
+    }
+  }
+
+  return out;
+}
+
+function decodeDeviceDelta(r) {
+  const out = {};
+  while (!r.eof()) {
+    const key = Number(r.varint());
+    const field = key >>> 3;
+    const wt = key & 7;
+    switch (field) {
+      case 1:
+        out.deviceId = Number(r.varint());
+        break;
+      case 2:
+        out.tsUs = r.varint();
+        break;
+      case 3:
+        out.on = Number(r.varint()) !== 0;
+        break;
+      case 4:
+        out.level = Number(r.varint());
+        break;
+      case 5:
+        out.powerW = r.float32();
+        break;
+      case 6:
+        out.temperatureC = r.float32();
+        break;
+      default:
+        r.skip(wt);
+    }
+  }
+  return out;
+}
+
+// One WS frame: the flush window's events in order, then per-device deltas
+// (only the fields that changed since this client's previous frame).
+function decodeHubEventBatch(buf) {
+  const r = new PbReader(new Uint8Array(buf));
+  const out = { events: [], deltas: [] };
+
+  while (!r.eof()) {
+    const key = Number(r.varint());
+    const field = key >>> 3;
+    const wt = key & 7;
+    switch (field) {
+      case 1:
+        out.schemaVersion = Number(r.varint());
+        break;
+      case 2:
+        out.seq = Number(r.varint());
+        break;
+      case 3: {
+        const n = Number(r.varint());
+        const b = r.bytes(n);
+        const e = decodeHubEvent(b);
+        e._rawLen = n;
+        out.events.push(e);
+        break;
+      }
+      case 4: {
+        const n = Number(r.varint());
+        out.deltas.push(decodeDeviceDelta(new PbReader(r.bytes(n))));
+        break;
+      }
+      case 5:
+        out.coalescedTotal = Number(r.varint());
+        break;
+      case 6:
+        out.droppedTotal = Number(r.varint());
+        break;
       default:
         r.skip(wt);
     }
@@ -377,6 +495,7 @@ function safeJson(x) {
 }
 
 let ws = null;
+let lastSeq = null;
 let events = [];
 let selected = -1;
 
@@ -434,6 +553,7 @@ function connect() {
   ws.binaryType = "arraybuffer";
 
   ws.onopen = () => {
+    lastSeq = null;
     setStatus(true, `Connected (${WS_PATH})`);
     connectBtn.disabled = true;
     disconnectBtn.disabled = false;
@@ -441,16 +561,33 @@ function connect() {
 
   ws.onmessage = (ev) => {
     if (!(ev.data instanceof ArrayBuffer)) return;
-    let decoded = null;
+    const decoded = [];
     try {
-      decoded = decodeHubEvent(ev.data);
-      decoded._rawLen = ev.data.byteLength;
+      const batch = decodeHubEventBatch(ev.data);
+      if (lastSeq !== null && batch.seq !== lastSeq + 1) {
+        decoded.push({ recvIso: nowIso(), eventId: "STREAM_GAP", expected: lastSeq + 1, got: batch.seq, _rawLen: 0 });
+      }
+      lastSeq = batch.seq;
+      decoded.push(...batch.events);
+      for (const d of batch.deltas) {
+        decoded.push({
+          recvIso: nowIso(),
+          eventId: "DEVICE_DELTA",
+          payloadType: "device_delta",
+          deviceDelta: d,
+          coalescedTotal: batch.coalescedTotal ?? 0,
+          droppedTotal: batch.droppedTotal ?? 0,
+          _rawLen: ev.data.byteLength,
+        });
+      }
     } catch (err) {
-      decoded = { recvIso: nowIso(), decodeError: String(err), _rawLen: ev.data.byteLength };
+      decoded.push({ recvIso: nowIso(), decodeError: String(err), _rawLen: ev.data.byteLength });
+    }
+    for (const e of decoded) {
+      events.unshift(e);
+      if (events.length > MAX_EVENTS) events.pop();
     }
-    events.unshift(decoded);
-    if (events.length > MAX_EVENTS) events.pop();
-    if (selected === -1) selected = 0;
+    if (selected === -1 && events.length) selected = 0;
     renderList();
   };
 
@@ -12,18 +12,23 @@
 
 #include "sdkconfig.h"
 
+#include "freertos/FreeRTOS.h"
+
 #include "esp_console.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_netif_ip_addr.h"
-#include "esp_timer.h"
+#include "esp_system.h"
 #include "esp_wifi.h"
 #include "lwip/inet.h"
 
 #include "hub_bus.h"
 #include "hub_http.h"
 #include "hub_pb.h"
+#include "hub_reply.h"
+#include "hub_scene.h"
 #include "hub_stream.h"
+#include "hub_telemetry.h"
 #include "hub_types.h"
 
 #include "wifi_sta.h"
@@ -80,6 +85,10 @@ static void hub_print_usage(void) {
     printf("usage:\n");
     printf("  hub seed\n");
     printf("  hub stream status\n");
+    printf("  hub reply status\n");
+    printf("  hub scene list\n");
+    printf("  hub scene trigger <id>\n");
+    printf("  hub ts status\n");
     printf("  hub pb status\n");
     printf("  hub pb on\n");
     printf("  hub pb off\n");
@@ -91,28 +100,27 @@ static esp_err_t hub_post_add(const char *name, hub_device_type_t type, uint32_t
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     if (!loop) return ESP_ERR_INVALID_STATE;
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_device_t));
-    if (!q) return ESP_ERR_NO_MEM;
+    uint32_t req_id = 0;
+    esp_err_t err = hub_reply_acquire(pdMS_TO_TICKS(100), &req_id);
+    if (err != ESP_OK) return err;
 
     hub_cmd_device_add_t cmd = {
-        .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+        .hdr = {.req_id = req_id},
         .type = type,
         .caps = caps,
     };
     strlcpy(cmd.name, name ? name : "", sizeof(cmd.name));
 
-    esp_err_t err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_ADD, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
+    err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_ADD, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         return err;
     }
 
     hub_reply_device_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(500)) != pdTRUE) {
-        vQueueDelete(q);
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep) != ESP_OK) {
         return ESP_ERR_TIMEOUT;
     }
-    vQueueDelete(q);
 
     if (rep.status != ESP_OK) return rep.status;
     if (out_id) *out_id = rep.device_id;
@@ -123,26 +131,25 @@ static esp_err_t hub_post_interview(uint32_t device_id) {
     esp_event_loop_handle_t loop = hub_bus_get_loop();
     if (!loop) return ESP_ERR_INVALID_STATE;
 
-    QueueHandle_t q = xQueueCreate(1, sizeof(hub_reply_status_t));
-    if (!q) return ESP_ERR_NO_MEM;
+    uint32_t req_id = 0;
+    esp_err_t err = hub_reply_acquire(pdMS_TO_TICKS(100), &req_id);
+    if (err != ESP_OK) return err;
 
     hub_cmd_device_interview_t cmd = {
-        .hdr = {.req_id = (uint32_t)esp_timer_get_time(), .reply_q = q},
+        .hdr = {.req_id = req_id},
         .device_id = device_id,
     };
 
-    esp_err_t err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_INTERVIEW, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
+    err = esp_event_post_to(loop, HUB_EVT, HUB_CMD_DEVICE_INTERVIEW, &cmd, sizeof(cmd), pdMS_TO_TICKS(100));
     if (err != ESP_OK) {
-        vQueueDelete(q);
+        hub_reply_release(req_id);
         return err;
     }
 
-    hub_reply_status_t rep = {0};
-    if (xQueueReceive(q, &rep, pdMS_TO_TICKS(500)) != pdTRUE) {
-        vQueueDelete(q);
+    hub_reply_device_t rep = {0};
+    if (hub_reply_wait(req_id, pdMS_TO_TICKS(500), &rep) != ESP_OK) {
         return ESP_ERR_TIMEOUT;
     }
-    vQueueDelete(q);
     return rep.status;
 }
 
@@ -176,16 +183,99 @@ static int cmd_hub(int argc, char **argv) {
 
     if (strcmp(argv[1], "stream") == 0) {
         if (argc >= 3 && strcmp(argv[2], "status") == 0) {
-            uint32_t drops = 0;
-            uint32_t enc_fail = 0;
-            uint32_t send_fail = 0;
-            hub_stream_get_stats(&drops, &enc_fail, &send_fail);
+            hub_stream_stats_t st = {0};
+            hub_stream_get_stats(&st);
             const uint32_t clients = (uint32_t)hub_http_events_client_count();
-            printf("clients=%" PRIu32 " drops=%" PRIu32 " enc_fail=%" PRIu32 " send_fail=%" PRIu32 "\n",
+            printf("clients=%" PRIu32 " events=%" PRIu32 " batches=%" PRIu32 " frames=%" PRIu32 " coalesced=%" PRIu32
+                   " fold_overflow=%" PRIu32 " drops=%" PRIu32 " enc_fail=%" PRIu32 " send_fail=%" PRIu32 "\n",
                    clients,
-                   drops,
-                   enc_fail,
-                   send_fail);
+                   st.events_in,
+                   st.batches,
+                   st.frames,
+                   st.coalesced,
+                   st.fold_overflow,
+                   st.enqueue_drops,
+                   st.encode_failures,
+                   st.send_failures);
+            return 0;
+        }
+        hub_print_usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "reply") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "status") == 0) {
+            hub_reply_stats_t st = {0};
+            hub_reply_get_stats(&st);
+            printf("slots=%" PRIu32 " in_use=%" PRIu32 " in_use_max=%" PRIu32 " acquired=%" PRIu32 " busy=%" PRIu32
+                   " timeouts=%" PRIu32 " late=%" PRIu32 " heap_free=%" PRIu32 " heap_min_free=%" PRIu32 "\n",
+                   st.slots,
+                   st.in_use,
+                   st.in_use_max,
+                   st.acquired,
+                   st.busy,
+                   st.timeouts,
+                   st.late_replies,
+                   esp_get_free_heap_size(),
+                   esp_get_minimum_free_heap_size());
+            return 0;
+        }
+        hub_print_usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "scene") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "list") == 0) {
+            static hub_scene_info_t infos[CONFIG_TUTORIAL_0029_SCENE_MAX];
+            const size_t n = hub_scene_list(infos, CONFIG_TUTORIAL_0029_SCENE_MAX);
+            bool user_defined[2] = {false, false};
+            for (size_t i = 0; i < n; i++) {
+                const hub_scene_info_t *s = &infos[i];
+                if (s->id == 1 || s->id == 2) user_defined[s->id - 1] = true;
+                printf("scene %u \"%s\": entries=%u groups=%u applied=%" PRIu32 " last_ms=%" PRIu32
+                       " predicted_ms=%" PRIu32 " ops=%u group_ops=%u skipped=%u failed=%u\n",
+                       (unsigned)s->id, s->name, (unsigned)s->n_entries, (unsigned)s->n_groups, s->stats.applied_count,
+                       s->stats.last_apply_ms, s->stats.predicted_ms, (unsigned)s->stats.last_ops,
+                       (unsigned)s->stats.last_group_ops, (unsigned)s->stats.last_skipped,
+                       (unsigned)s->stats.last_failed);
+            }
+            for (uint16_t id = 1; id <= 2; id++) {
+                hub_scene_stats_t st = {0};
+                if (user_defined[id - 1] || hub_scene_get(id, NULL, &st) != ESP_OK) continue;
+                printf("scene %u (built-in %s): applied=%" PRIu32 " last_ms=%" PRIu32 "\n", (unsigned)id,
+                       id == 1 ? "all_on" : "all_off", st.applied_count, st.last_apply_ms);
+            }
+            return 0;
+        }
+        if (argc >= 4 && strcmp(argv[2], "trigger") == 0) {
+            int id = 0;
+            if (!try_parse_int(argv[3], &id) || id <= 0 || id > (int)HUB_SCENE_ID_MAX) {
+                printf("bad scene id\n");
+                return 1;
+            }
+            const esp_err_t err = hub_scene_trigger((uint16_t)id);
+            if (err != ESP_OK) {
+                printf("trigger failed: %s\n", esp_err_to_name(err));
+                return 1;
+            }
+            printf("OK (see hub scene list for time-to-apply)\n");
+            return 0;
+        }
+        hub_print_usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "ts") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "status") == 0) {
+            hub_telemetry_stats_t st = {0};
+            hub_telemetry_get_stats(&st);
+            printf("now=%" PRIu32 " series=%" PRIu32 "/%" PRIu32 " inserts=%" PRIu32 " series_full=%" PRIu32
+                   " late=%" PRIu32 " pending_drops=%" PRIu32 " ram=%" PRIu32 "\n",
+                   hub_telemetry_now(), st.series, st.series_cap, st.inserts, st.series_full, st.late,
+                   st.pending_drops, st.ram_bytes);
+            printf("snapshots: seq=%" PRIu32 " saves=%" PRIu32 " failures=%" PRIu32 " last_bytes=%" PRIu32
+                   " last_ms=%" PRIu32 " region=%" PRIu32 "\n",
+                   st.seq, st.saves, st.save_failures, st.last_save_bytes, st.last_save_ms, st.region_bytes);
             return 0;
         }
         hub_print_usage();
@@ -411,7 +501,7 @@ static void register_commands(void) {
 
     esp_console_cmd_t hub_cmd = {0};
     hub_cmd.command = "hub";
-    hub_cmd.help = "Hub debug: hub seed, hub stream status, hub pb on|off|status|last";
+    hub_cmd.help = "Hub debug: hub seed, hub stream status, hub scene list|trigger, hub ts status, hub pb on|off|status|last";
     hub_cmd.func = &cmd_hub;
     ESP_ERROR_CHECK(esp_console_cmd_register(&hub_cmd));
 }
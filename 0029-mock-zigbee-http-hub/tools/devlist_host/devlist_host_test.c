@@ -0,0 +1,213 @@
+/*
+ * Host test for the streamed GET /v1/devices body (main/hub_devlist.c).
+ *
+ * Fills the registry (main/hub_registry.c) with 256 devices, takes a snapshot
+ * and streams it through the chunk writer the way devices_list_get() does,
+ * with several chunk sizes. Writes the bytes and the same list as protobuf
+ * text format; run_devlist_host.sh encodes the text with protoc (the reference
+ * serializer) and byte-compares. Also covers sink errors and ETag matching.
+ *
+ * Usage: devlist_host_test <out.bin> <out.textproto>. Exits non-zero on failure.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hub_devlist.h"
+#include "hub_registry.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define N_DEVICES 256
+
+typedef struct {
+    uint8_t data[64 * 1024];
+    size_t len;
+    size_t calls;
+    size_t max_chunk;
+    size_t fail_at_call; // 0 = never
+} capture_t;
+
+static esp_err_t capture_sink(void *ctx, const uint8_t *data, size_t len) {
+    capture_t *c = ctx;
+    c->calls++;
+    if (c->fail_at_call && c->calls == c->fail_at_call) return ESP_FAIL;
+    if (c->len + len > sizeof(c->data)) return ESP_ERR_NO_MEM;
+    memcpy(c->data + c->len, data, len);
+    c->len += len;
+    if (len > c->max_chunk) c->max_chunk = len;
+    return ESP_OK;
+}
+
+static hub_device_t s_snap[N_DEVICES];
+static size_t s_snap_n;
+static uint32_t s_snap_gen;
+
+static void fill_registry(void) {
+    static const char *words[] = {"desk", "lamp", "hall", "kitchen", "porch", "garage", "t", NULL};
+    for (uint32_t i = 0; i < N_DEVICES; i++) {
+        hub_device_t d = {0};
+        d.type = (hub_device_type_t)(i % 4); // includes 0: omitted on the wire
+        d.caps = (i * 37u) % 32u;
+        if (i % 17 == 5) {
+            // Longest name the registry keeps.
+            memset(d.name, 'x', sizeof(d.name) - 1);
+        } else if (i % 8 != 7) { // else: no name, omitted on the wire
+            snprintf(d.name, sizeof(d.name), "%s_%u", words[i % 8], i);
+        }
+        d.on = (i % 3) == 0;
+        d.level = (uint8_t)((i * 7u) % 101u);
+        d.power_w = (i % 5 == 0) ? 0.0f : (float)i * 1.37f;
+        d.temperature_c = (i % 6 == 0) ? 0.0f : -12.5f + (float)i * 0.173f;
+        if (d.caps & HUB_CAP_COLOR_TEMP) d.color_mireds = (uint16_t)(153u + (i * 29u) % 348u);
+        hub_device_t created;
+        if (hub_registry_add(&d, &created) != ESP_OK) return;
+        // Re-apply runtime state the way the simulator does.
+        (void)hub_registry_update(created.id, &d);
+    }
+}
+
+static size_t stream_snapshot(size_t chunk_cap, capture_t *cap) {
+    uint8_t *chunk = malloc(chunk_cap);
+    hub_devlist_writer_t w;
+    hub_devlist_writer_init(&w, chunk, chunk_cap, capture_sink, cap);
+    for (size_t i = 0; i < s_snap_n && w.err == ESP_OK; i++) {
+        (void)hub_devlist_write_device(&w, &s_snap[i]);
+    }
+    const esp_err_t err = hub_devlist_writer_finish(&w);
+    free(chunk);
+    return err == ESP_OK ? w.total : 0;
+}
+
+static void write_textproto(FILE *f) {
+    for (size_t i = 0; i < s_snap_n; i++) {
+        const hub_device_t *d = &s_snap[i];
+        fprintf(f, "devices {\n  id: %u\n  type: %d\n  caps: %u\n  name: \"%s\"\n  on: %s\n  level: %u\n",
+                d->id, (int)d->type, d->caps, d->name, d->on ? "true" : "false", d->level);
+        fprintf(f, "  power_w: %.9g\n  temperature_c: %.9g\n  color_temp_mireds: %u\n}\n", (double)d->power_w,
+                (double)d->temperature_c, (unsigned)d->color_mireds);
+    }
+}
+
+static void test_stream(const char *bin_path, const char *txt_path) {
+    fill_registry();
+    CHECK(hub_registry_snapshot_gen(s_snap, N_DEVICES, &s_snap_n, &s_snap_gen) == ESP_OK);
+    CHECK(s_snap_n == N_DEVICES);
+
+    static capture_t ref;
+    memset(&ref, 0, sizeof(ref));
+    CHECK(stream_snapshot(512, &ref) == ref.len);
+    CHECK(ref.len > 1024); // the old fixed buffer would have truncated this
+    CHECK(ref.max_chunk <= 512);
+
+    // The chunk size changes the chunking, never the bytes.
+    const size_t caps[] = {HUB_DEVLIST_ENTRY_MAX, 97, 128, 1000, 4096};
+    for (size_t k = 0; k < sizeof(caps) / sizeof(caps[0]); k++) {
+        static capture_t c;
+        memset(&c, 0, sizeof(c));
+        CHECK(stream_snapshot(caps[k], &c) == ref.len);
+        CHECK(c.len == ref.len && memcmp(c.data, ref.data, ref.len) == 0);
+        CHECK(c.max_chunk <= caps[k]);
+        printf("{\"test\":\"chunking\",\"chunk_cap\":%zu,\"chunks\":%zu,\"bytes\":%zu}\n", caps[k], c.calls, c.len);
+    }
+    printf("{\"test\":\"stream\",\"devices\":%zu,\"generation\":%u,\"bytes\":%zu,\"chunks_512\":%zu}\n", s_snap_n,
+           s_snap_gen, ref.len, ref.calls);
+
+    FILE *f = fopen(bin_path, "wb");
+    CHECK(f != NULL);
+    fwrite(ref.data, 1, ref.len, f);
+    fclose(f);
+    f = fopen(txt_path, "w");
+    CHECK(f != NULL);
+    write_textproto(f);
+    fclose(f);
+}
+
+static void test_sink_error_stops_stream(void) {
+    static capture_t c;
+    memset(&c, 0, sizeof(c));
+    c.fail_at_call = 3;
+    CHECK(stream_snapshot(128, &c) == 0);
+    CHECK(c.calls == 3);
+
+    uint8_t small[HUB_DEVLIST_ENTRY_MAX - 1];
+    hub_devlist_writer_t w;
+    hub_devlist_writer_init(&w, small, sizeof(small), capture_sink, &c);
+    CHECK(hub_devlist_write_device(&w, &s_snap[0]) == ESP_ERR_INVALID_SIZE);
+}
+
+static void test_encode_bounds(void) {
+    hub_device_t d = {.id = 0xffffffffu, .type = HUB_DEVICE_TEMP_SENSOR, .caps = 0xffffffffu, .on = true, .level = 255,
+                      .power_w = 1.0f, .temperature_c = -0.0f, .color_mireds = 0xffff};
+    memset(d.name, 'n', sizeof(d.name) - 1);
+    uint8_t buf[HUB_DEVLIST_ENTRY_MAX];
+    size_t n = 0;
+    CHECK(hub_devlist_encode_device(&d, buf, sizeof(buf), &n));
+    CHECK(n + 2 <= HUB_DEVLIST_ENTRY_MAX);
+    // Any shorter buffer must fail cleanly rather than truncate.
+    for (size_t cap = 0; cap < n; cap++) {
+        size_t m = 0;
+        CHECK(!hub_devlist_encode_device(&d, buf, cap, &m));
+    }
+    // All defaults: an empty message.
+    const hub_device_t zero = {0};
+    CHECK(hub_devlist_encode_device(&zero, buf, 0, &n) && n == 0);
+}
+
+static void test_etag(void) {
+    char a[24], b[24], c[24];
+    hub_devlist_etag(0x1234abcd, 7, a, sizeof(a));
+    hub_devlist_etag(0x1234abcd, 8, b, sizeof(b));
+    hub_devlist_etag(0x0badf00d, 7, c, sizeof(c));
+    CHECK(strcmp(a, "\"1234abcd-00000007\"") == 0);
+    CHECK(strcmp(a, b) != 0 && strcmp(a, c) != 0);
+
+    CHECK(hub_devlist_etag_match(a, a));
+    CHECK(!hub_devlist_etag_match(b, a));
+    CHECK(hub_devlist_etag_match("*", a));
+    CHECK(hub_devlist_etag_match("W/\"1234abcd-00000007\"", a));
+    CHECK(hub_devlist_etag_match("\"x\", \"1234abcd-00000007\" ,\"y\"", a));
+    CHECK(!hub_devlist_etag_match("\"1234abcd-0000000\"", a));
+    CHECK(!hub_devlist_etag_match("", a));
+    CHECK(!hub_devlist_etag_match(NULL, a));
+
+    // Unchanged registry -> same ETag (304); any mutation -> new ETag.
+    const uint32_t g0 = hub_registry_generation();
+    CHECK(g0 == s_snap_gen);
+    hub_device_t d;
+    CHECK(hub_registry_get(s_snap[0].id, &d) == ESP_OK);
+    d.on = !d.on;
+    CHECK(hub_registry_update(d.id, &d) == ESP_OK);
+    CHECK(hub_registry_generation() != g0);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <out.bin> <out.textproto>\n", argv[0]);
+        return 2;
+    }
+    if (hub_registry_init() != ESP_OK) {
+        fprintf(stderr, "hub_registry_init failed\n");
+        return 1;
+    }
+    test_stream(argv[1], argv[2]);
+    test_sink_error_stops_stream();
+    test_encode_bounds();
+    test_etag();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the streamed device list host test.
+#
+# main/hub_devlist.c and main/hub_registry.c are built against the stand-in
+# headers of tools/host. The test streams 256 devices and writes
+# the bytes plus the same list in protobuf text format; protoc then encodes the
+# text with hub_events.proto and the two must be byte-identical.
+#
+# Usage:
+#   ./tools/devlist_host/run_devlist_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+PROTO_DIR="${HERE}/../../components/hub_proto/defs"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/hub-devlist-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+PROTOC="${PROTOC:-protoc}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -pthread -I"${HERE}/../host" -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/devlist_host_test" \
+  "${HERE}/devlist_host_test.c" "${MAIN_DIR}/hub_devlist.c" "${MAIN_DIR}/hub_registry.c" "${HERE}/../host/host_heap.c"
+"${BUILD_DIR}/devlist_host_test" "${BUILD_DIR}/devices.bin" "${BUILD_DIR}/devices.textproto"
+
+if ! command -v "${PROTOC}" >/dev/null 2>&1; then
+  echo '{"test":"protoc_compare","skipped":"protoc not found"}'
+  exit 0
+fi
+
+# hub_events.proto imports nanopb.proto for field options only; a stub declaring
+# the two options it uses is enough for protoc.
+cat >"${BUILD_DIR}/nanopb.proto" <<'PROTO'
+syntax = "proto2";
+import "google/protobuf/descriptor.proto";
+message NanoPBOptions {
+  optional int32 max_count = 2;
+  optional int32 max_length = 14;
+}
+extend google.protobuf.FieldOptions {
+  optional NanoPBOptions nanopb = 1010;
+}
+PROTO
+
+PROTOC_INCLUDE="$(cd "$(dirname "$(command -v "${PROTOC}")")/../include" 2>/dev/null && pwd || true)"
+"${PROTOC}" -I"${BUILD_DIR}" -I"${PROTO_DIR}" ${PROTOC_INCLUDE:+-I"${PROTOC_INCLUDE}"} \
+  --encode=hub.v1.DeviceList hub_events.proto \
+  <"${BUILD_DIR}/devices.textproto" >"${BUILD_DIR}/devices.protoc.bin"
+
+if cmp -s "${BUILD_DIR}/devices.bin" "${BUILD_DIR}/devices.protoc.bin"; then
+  echo "{\"test\":\"protoc_compare\",\"bytes\":$(wc -c <"${BUILD_DIR}/devices.bin"),\"identical\":true}"
+else
+  echo "{\"test\":\"protoc_compare\",\"identical\":false}"
+  cmp "${BUILD_DIR}/devices.bin" "${BUILD_DIR}/devices.protoc.bin" || true
+  exit 1
+fi
@@ -0,0 +1,5 @@
+/* Host stand-in: only what hub_types.h declares. */
+#pragma once
+
+typedef const char *esp_event_base_t;
+#define ESP_EVENT_DECLARE_BASE(id) extern esp_event_base_t const id
@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the FreeRTOS pieces the hub host tests use, on top of
+ * pthreads. One tick is one millisecond.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define portMAX_DELAY   ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
@@ -0,0 +1,4 @@
+/* Host stand-in: hub_types.h only names the handle type. */
+#pragma once
+
+typedef struct QueueDefinition *QueueHandle_t;
@@ -0,0 +1,100 @@
+/*
+ * Host stand-in: mutex, binary and counting semaphores as a counter guarded by
+ * a pthread mutex + condvar, with timed takes. Handles are allocated through
+ * host_heap so the test can see every allocation the code under test makes.
+ */
+#pragma once
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "host_heap.h"
+
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+    unsigned count;
+    unsigned max;
+} host_sem_t;
+
+typedef host_sem_t *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t host_sem_create(unsigned max, unsigned initial)
+{
+    SemaphoreHandle_t s = host_heap_calloc(1, sizeof(*s));
+    if (s) {
+        pthread_mutex_init(&s->mu, NULL);
+        pthread_condattr_t ca;
+        pthread_condattr_init(&ca);
+        pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+        pthread_cond_init(&s->cv, &ca);
+        pthread_condattr_destroy(&ca);
+        s->count = initial;
+        s->max = max;
+    }
+    return s;
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return host_sem_create(1, 1);
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return host_sem_create(1, 0);
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateCounting(unsigned max, unsigned initial)
+{
+    return host_sem_create(max, initial);
+}
+
+static inline void vSemaphoreDelete(SemaphoreHandle_t s)
+{
+    pthread_cond_destroy(&s->cv);
+    pthread_mutex_destroy(&s->mu);
+    host_heap_free(s, sizeof(*s));
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t timeout)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout != portMAX_DELAY) {
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&s->mu);
+    while (s->count == 0) {
+        if (timeout == 0) break;
+        if (timeout == portMAX_DELAY) {
+            pthread_cond_wait(&s->cv, &s->mu);
+        } else if (pthread_cond_timedwait(&s->cv, &s->mu, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    const BaseType_t ok = s->count > 0 ? pdTRUE : pdFALSE;
+    if (ok) s->count--;
+    pthread_mutex_unlock(&s->mu);
+    return ok;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    pthread_mutex_lock(&s->mu);
+    const BaseType_t ok = s->count < s->max ? pdTRUE : pdFALSE;
+    if (ok) {
+        s->count++;
+        pthread_cond_signal(&s->cv);
+    }
+    pthread_mutex_unlock(&s->mu);
+    return ok;
+}
@@ -0,0 +1,3 @@
+#include "host_heap.h"
+
+host_heap_t g_host_heap;
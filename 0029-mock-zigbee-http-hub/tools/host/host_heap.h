@@ -0,0 +1,34 @@
+/* Host stand-in: counting allocator, so the test can report heap use and allocation churn. */
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef struct {
+    atomic_size_t bytes;
+    atomic_size_t peak;
+    atomic_uint allocs;
+} host_heap_t;
+
+extern host_heap_t g_host_heap;
+
+static inline void *host_heap_calloc(size_t n, size_t size)
+{
+    void *p = calloc(n, size);
+    if (p) {
+        const size_t now = atomic_fetch_add(&g_host_heap.bytes, n * size) + n * size;
+        size_t peak = atomic_load(&g_host_heap.peak);
+        while (now > peak && !atomic_compare_exchange_weak(&g_host_heap.peak, &peak, now)) {
+        }
+        atomic_fetch_add(&g_host_heap.allocs, 1);
+    }
+    return p;
+}
+
+static inline void host_heap_free(void *p, size_t size)
+{
+    if (!p) return;
+    atomic_fetch_sub(&g_host_heap.bytes, size);
+    free(p);
+}
@@ -0,0 +1,11 @@
+/* Host build configuration for the hub host tests. */
+#pragma once
+
+#ifndef CONFIG_TUTORIAL_0029_REGISTRY_MAX_DEVICES
+#define CONFIG_TUTORIAL_0029_REGISTRY_MAX_DEVICES 1024
+#endif
+#define CONFIG_TUTORIAL_0029_REGISTRY_IN_PSRAM 1
+
+#ifndef CONFIG_TUTORIAL_0029_REPLY_SLOTS
+#define CONFIG_TUTORIAL_0029_REPLY_SLOTS 8
+#endif
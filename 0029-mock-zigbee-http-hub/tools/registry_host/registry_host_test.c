@@ -0,0 +1,222 @@
+/*
+ * Host test and benchmark for the hub device registry (main/hub_registry.c).
+ *
+ * Churns add/remove/update events against a plain array reference and
+ * checks that every id resolves to the same device, that the generation
+ * moves on every mutation, that a full registry refuses adds, and times
+ * id lookups against a linear scan.
+ *
+ * Built and run by tools/registry_host/run_registry_host.sh. Exits non-zero on failure.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sdkconfig.h"
+#include "hub_registry.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define CAP CONFIG_TUTORIAL_0029_REGISTRY_MAX_DEVICES
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static hub_device_t s_ref[CAP];
+static size_t s_ref_n;
+
+static int ref_find(uint32_t id)
+{
+    for (size_t i = 0; i < s_ref_n; i++) {
+        if (s_ref[i].id == id) return (int)i;
+    }
+    return -1;
+}
+
+static void clear_all(void)
+{
+    hub_device_t *snap = calloc(CAP, sizeof(*snap));
+    size_t n = 0;
+    (void)hub_registry_snapshot(snap, CAP, &n);
+    for (size_t i = 0; i < n; i++) {
+        (void)hub_registry_remove(snap[i].id);
+    }
+    free(snap);
+    s_ref_n = 0;
+}
+
+static void add_one(uint32_t tag)
+{
+    hub_device_t in = {.type = HUB_DEVICE_PLUG, .caps = HUB_CAP_ONOFF, .level = (uint8_t)(tag % 101)};
+    snprintf(in.name, sizeof(in.name), "dev-%u", (unsigned)tag);
+    hub_device_t created;
+    const esp_err_t err = hub_registry_add(&in, &created);
+    if (s_ref_n < CAP) {
+        CHECK(err == ESP_OK);
+        s_ref[s_ref_n++] = created;
+    } else {
+        CHECK(err == ESP_ERR_NO_MEM);
+    }
+}
+
+static void check_matches_ref(void)
+{
+    for (size_t i = 0; i < s_ref_n; i++) {
+        hub_device_t d;
+        CHECK(hub_registry_get(s_ref[i].id, &d) == ESP_OK);
+        CHECK(d.level == s_ref[i].level && d.on == s_ref[i].on);
+        CHECK(strcmp(d.name, s_ref[i].name) == 0);
+    }
+    size_t n = 0;
+    CHECK(hub_registry_snapshot(NULL, 0, &n) == ESP_OK);
+    hub_device_t *snap = calloc(CAP, sizeof(*snap));
+    (void)hub_registry_snapshot(snap, CAP, &n);
+    free(snap);
+    CHECK(n == s_ref_n);
+}
+
+static void test_churn_matches_reference(void)
+{
+    clear_all();
+
+    const uint32_t events = 200000;
+    for (uint32_t e = 0; e < events; e++) {
+        const uint32_t r = rnd() % 100;
+        const uint32_t gen0 = hub_registry_generation();
+        if (r < 40 || s_ref_n == 0) {
+            add_one(e);
+            if (g_failures) return;
+        } else if (r < 75) {
+            const size_t i = rnd() % s_ref_n;
+            CHECK(hub_registry_remove(s_ref[i].id) == ESP_OK);
+            CHECK(hub_registry_remove(s_ref[i].id) == ESP_ERR_NOT_FOUND);
+            s_ref[i] = s_ref[--s_ref_n];
+        } else {
+            const size_t i = rnd() % s_ref_n;
+            s_ref[i].on = !s_ref[i].on;
+            s_ref[i].level = (uint8_t)(rnd() % 101);
+            CHECK(hub_registry_update(s_ref[i].id, &s_ref[i]) == ESP_OK);
+        }
+        if (s_ref_n < CAP || r >= 40) {
+            CHECK(hub_registry_generation() != gen0);
+        }
+        if ((e % 97) == 0) {
+            check_matches_ref();
+            if (g_failures) return;
+        }
+    }
+
+    /* ids are never reused, so an old id must miss */
+    hub_device_t d;
+    CHECK(hub_registry_get(0, &d) == ESP_ERR_NOT_FOUND);
+    printf("{\"test\":\"churn\",\"events\":%u,\"devices\":%zu,\"generation\":%u}\n",
+           events, s_ref_n, hub_registry_generation());
+}
+
+static void test_full_registry(void)
+{
+    clear_all();
+    for (uint32_t i = 0; i < CAP + 5; i++) {
+        add_one(i);
+        if (g_failures) return;
+    }
+    check_matches_ref();
+
+    /* a freed slot is usable again */
+    CHECK(hub_registry_remove(s_ref[0].id) == ESP_OK);
+    s_ref[0] = s_ref[--s_ref_n];
+    add_one(99999);
+    check_matches_ref();
+}
+
+static void test_snapshot_generation(void)
+{
+    clear_all();
+    add_one(1);
+    hub_device_t snap[4];
+    size_t n = 0;
+    uint32_t g1 = 0, g2 = 0;
+    CHECK(hub_registry_snapshot_gen(snap, 4, &n, &g1) == ESP_OK && n == 1);
+    CHECK(hub_registry_snapshot_gen(snap, 4, &n, &g2) == ESP_OK && g1 == g2);
+    CHECK(hub_registry_update(snap[0].id, &snap[0]) == ESP_OK);
+    CHECK(hub_registry_generation() != g1);
+}
+
+static void bench(size_t devices)
+{
+    clear_all();
+    for (size_t i = 0; i < devices; i++) {
+        add_one((uint32_t)i);
+    }
+
+    const uint32_t ops = 2000000;
+    uint32_t hits = 0;
+    hub_device_t d;
+    double t0 = now_s();
+    for (uint32_t i = 0; i < ops; i++) {
+        hits += hub_registry_get(s_ref[rnd() % devices].id, &d) == ESP_OK;
+    }
+    const double t_index = now_s() - t0;
+
+    t0 = now_s();
+    for (uint32_t i = 0; i < ops; i++) {
+        const int k = ref_find(s_ref[rnd() % devices].id);
+        if (k >= 0) {
+            d = s_ref[k];
+            hits++;
+        }
+    }
+    const double t_scan = now_s() - t0;
+
+    printf("{\"bench\":\"get\",\"devices\":%zu,\"ops\":%u,\"index_ns\":%.1f,\"scan_ns\":%.1f,\"hits\":%u}\n",
+           devices, ops, t_index * 1e9 / ops, t_scan * 1e9 / ops, hits);
+}
+
+int main(void)
+{
+    if (hub_registry_init() != ESP_OK) {
+        fprintf(stderr, "hub_registry_init failed\n");
+        return 1;
+    }
+
+    test_snapshot_generation();
+    test_churn_matches_reference();
+    test_full_registry();
+
+    if (g_failures == 0) {
+        bench(32);
+        bench(CAP);
+    }
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
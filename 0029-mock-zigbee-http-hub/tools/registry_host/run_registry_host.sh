@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the hub device registry host test and benchmark.
+#
+# main/hub_registry.c is compiled against the stand-in headers in tools/host/
+# (pthread mutex for the FreeRTOS mutex, calloc for heap_caps). The test prints
+# JSONL: one line per test, then id lookup timings indexed vs. linear scan.
+#
+# Usage:
+#   ./tools/registry_host/run_registry_host.sh
+#   SANITIZE= ./tools/registry_host/run_registry_host.sh   # timings without ASan/UBSan
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/hub-registry-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -I"${HERE}/../host" -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/registry_host_test" \
+  "${HERE}/registry_host_test.c" "${MAIN_DIR}/hub_registry.c" "${HERE}/../host/host_heap.c" -lpthread
+"${BUILD_DIR}/registry_host_test"
@@ -0,0 +1,294 @@
+/*
+ * Host stress test for the hub bus reply slots (main/hub_reply.c).
+ *
+ * A "bus" thread stands in for the hub event loop: it completes requests in
+ * order after a short service time, and now and then stalls past the waiters'
+ * timeout so replies arrive late. Requester threads stand in for HTTP handlers:
+ * acquire a slot, post, wait. Every reply must reach the request it was meant
+ * for, late replies must be dropped, and no slot may leak. Prints latency
+ * percentiles, slot usage and heap use as JSONL.
+ *
+ * Built and run by tools/reply_host/run_reply_host.sh. Exits non-zero on failure.
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hub_reply.h"
+#include "host_heap.h"
+#include "sdkconfig.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define N_THREADS 8
+#define N_PER_THREAD 1500
+#define WAIT_MS 10
+#define SLOW_EVERY 500   // one request in SLOW_EVERY stalls the bus
+#define SLOW_US 15000
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleep_us(unsigned us) {
+    struct timespec ts = {.tv_sec = us / 1000000u, .tv_nsec = (long)(us % 1000000u) * 1000L};
+    nanosleep(&ts, NULL);
+}
+
+// --- bus stand-in -----------------------------------------------------------
+
+typedef struct {
+    uint32_t req_id;
+    uint32_t value;
+    unsigned service_us;
+} bus_msg_t;
+
+#define BUS_LEN 64
+static bus_msg_t s_bus[BUS_LEN];
+static size_t s_bus_head;
+static size_t s_bus_n;
+static bool s_bus_stop;
+static pthread_mutex_t s_bus_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_bus_cv = PTHREAD_COND_INITIALIZER;
+
+static void bus_post(const bus_msg_t *m) {
+    pthread_mutex_lock(&s_bus_mu);
+    while (s_bus_n == BUS_LEN) {
+        pthread_cond_wait(&s_bus_cv, &s_bus_mu);
+    }
+    s_bus[(s_bus_head + s_bus_n) % BUS_LEN] = *m;
+    s_bus_n++;
+    pthread_cond_broadcast(&s_bus_cv);
+    pthread_mutex_unlock(&s_bus_mu);
+}
+
+static void *bus_thread(void *arg) {
+    (void)arg;
+    while (true) {
+        pthread_mutex_lock(&s_bus_mu);
+        while (s_bus_n == 0 && !s_bus_stop) {
+            pthread_cond_wait(&s_bus_cv, &s_bus_mu);
+        }
+        if (s_bus_n == 0) {
+            pthread_mutex_unlock(&s_bus_mu);
+            return NULL;
+        }
+        const bus_msg_t m = s_bus[s_bus_head];
+        s_bus_head = (s_bus_head + 1) % BUS_LEN;
+        s_bus_n--;
+        pthread_cond_broadcast(&s_bus_cv);
+        pthread_mutex_unlock(&s_bus_mu);
+
+        sleep_us(m.service_us);
+        const hub_device_t dev = {.id = m.value};
+        hub_reply_complete(m.req_id, ESP_OK, &dev);
+    }
+}
+
+// --- requesters -------------------------------------------------------------
+
+typedef struct {
+    unsigned idx;
+    int64_t lat_ns[N_PER_THREAD];
+    uint32_t ok;
+    uint32_t timeouts;
+    uint32_t busy;
+    uint32_t mismatches;
+} requester_t;
+
+static void *requester_thread(void *arg) {
+    requester_t *r = arg;
+    uint32_t rng = 0x9e3779b9u * (r->idx + 1);
+
+    for (unsigned i = 0; i < N_PER_THREAD; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        const uint32_t value = (r->idx << 16) | i;
+        const int64_t t0 = now_ns();
+
+        uint32_t req_id = 0;
+        if (hub_reply_acquire(pdMS_TO_TICKS(100), &req_id) != ESP_OK) {
+            r->busy++;
+            r->lat_ns[i] = now_ns() - t0;
+            continue;
+        }
+        const bus_msg_t m = {
+            .req_id = req_id,
+            .value = value,
+            .service_us = (rng >> 8) % SLOW_EVERY == 0 ? SLOW_US : 20 + (rng >> 20) % 200,
+        };
+        bus_post(&m);
+
+        hub_reply_device_t rep = {0};
+        const esp_err_t err = hub_reply_wait(req_id, pdMS_TO_TICKS(WAIT_MS), &rep);
+        r->lat_ns[i] = now_ns() - t0;
+        if (err == ESP_OK) {
+            r->ok++;
+            if (rep.status != ESP_OK || rep.device_id != value) r->mismatches++;
+        } else {
+            r->timeouts++;
+        }
+    }
+    return NULL;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    const int64_t x = *(const int64_t *)a;
+    const int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void test_late_reply_does_not_leak_into_reused_slot(void) {
+    uint32_t first = 0;
+    CHECK(hub_reply_acquire(0, &first) == ESP_OK);
+    hub_reply_device_t rep = {0};
+    CHECK(hub_reply_wait(first, pdMS_TO_TICKS(1), &rep) == ESP_ERR_TIMEOUT);
+
+    // The lowest free slot is reused, under a new id.
+    uint32_t second = 0;
+    CHECK(hub_reply_acquire(0, &second) == ESP_OK);
+    CHECK(second != first);
+    CHECK((second & 0xffu) == (first & 0xffu));
+
+    hub_reply_stats_t st0;
+    hub_reply_get_stats(&st0);
+    const hub_device_t stale = {.id = 111};
+    hub_reply_complete(first, ESP_OK, &stale);
+    hub_reply_stats_t st1;
+    hub_reply_get_stats(&st1);
+    CHECK(st1.late_replies == st0.late_replies + 1);
+
+    // The stale reply neither woke nor filled the new request.
+    CHECK(hub_reply_wait(second, 0, &rep) == ESP_ERR_TIMEOUT);
+
+    uint32_t third = 0;
+    CHECK(hub_reply_acquire(0, &third) == ESP_OK);
+    const hub_device_t fresh = {.id = 222};
+    hub_reply_complete(third, ESP_ERR_NOT_FOUND, &fresh);
+    hub_reply_complete(third, ESP_OK, NULL); // duplicate: dropped
+    CHECK(hub_reply_wait(third, 0, &rep) == ESP_OK);
+    CHECK(rep.status == ESP_ERR_NOT_FOUND && rep.device_id == 222);
+
+    // A freed id can't be waited on or released twice.
+    CHECK(hub_reply_wait(third, 0, &rep) == ESP_ERR_INVALID_ARG);
+    hub_reply_release(third);
+    hub_reply_complete(0, ESP_OK, NULL); // "no reply wanted"
+
+    hub_reply_get_stats(&st1);
+    CHECK(st1.in_use == 0);
+}
+
+static void test_exhaustion(void) {
+    uint32_t ids[CONFIG_TUTORIAL_0029_REPLY_SLOTS];
+    for (size_t i = 0; i < CONFIG_TUTORIAL_0029_REPLY_SLOTS; i++) {
+        CHECK(hub_reply_acquire(0, &ids[i]) == ESP_OK);
+    }
+    uint32_t extra = 0;
+    CHECK(hub_reply_acquire(pdMS_TO_TICKS(5), &extra) == ESP_ERR_TIMEOUT);
+    CHECK(extra == 0);
+
+    hub_reply_release(ids[3]);
+    CHECK(hub_reply_acquire(0, &extra) == ESP_OK);
+    CHECK((extra & 0xffu) == 3u);
+    ids[3] = extra;
+    for (size_t i = 0; i < CONFIG_TUTORIAL_0029_REPLY_SLOTS; i++) {
+        hub_reply_release(ids[i]);
+    }
+
+    hub_reply_stats_t st;
+    hub_reply_get_stats(&st);
+    CHECK(st.in_use == 0);
+    CHECK(st.busy >= 1);
+    CHECK(st.in_use_max == CONFIG_TUTORIAL_0029_REPLY_SLOTS);
+}
+
+static void test_stress(void) {
+    const unsigned allocs_before = atomic_load(&g_host_heap.allocs);
+
+    pthread_t bus;
+    pthread_create(&bus, NULL, bus_thread, NULL);
+
+    static requester_t req[N_THREADS];
+    pthread_t th[N_THREADS];
+    const int64_t t0 = now_ns();
+    for (unsigned i = 0; i < N_THREADS; i++) {
+        memset(&req[i], 0, sizeof(req[i]));
+        req[i].idx = i;
+        pthread_create(&th[i], NULL, requester_thread, &req[i]);
+    }
+    for (unsigned i = 0; i < N_THREADS; i++) {
+        pthread_join(th[i], NULL);
+    }
+    const int64_t elapsed_ns = now_ns() - t0;
+
+    // Let the bus finish whatever timed-out requests it still holds.
+    pthread_mutex_lock(&s_bus_mu);
+    s_bus_stop = true;
+    pthread_cond_broadcast(&s_bus_cv);
+    pthread_mutex_unlock(&s_bus_mu);
+    pthread_join(bus, NULL);
+
+    static int64_t all[N_THREADS * N_PER_THREAD];
+    size_t n = 0;
+    uint32_t ok = 0, timeouts = 0, busy = 0, mismatches = 0;
+    for (unsigned i = 0; i < N_THREADS; i++) {
+        memcpy(&all[n], req[i].lat_ns, sizeof(req[i].lat_ns));
+        n += N_PER_THREAD;
+        ok += req[i].ok;
+        timeouts += req[i].timeouts;
+        busy += req[i].busy;
+        mismatches += req[i].mismatches;
+    }
+    qsort(all, n, sizeof(all[0]), cmp_i64);
+
+    hub_reply_stats_t st;
+    hub_reply_get_stats(&st);
+    const unsigned allocs_during = atomic_load(&g_host_heap.allocs) - allocs_before;
+
+    printf("{\"test\":\"stress\",\"threads\":%d,\"requests\":%zu,\"ok\":%u,\"timeouts\":%u,\"busy\":%u,"
+           "\"late\":%u,\"p50_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f,\"req_per_s\":%.0f,"
+           "\"slots\":%u,\"in_use_max\":%u,\"heap_peak_bytes\":%zu,\"allocs_during_run\":%u}\n",
+           N_THREADS, n, ok, timeouts, busy, st.late_replies, all[n / 2] / 1e3, all[(n * 99) / 100] / 1e3,
+           all[n - 1] / 1e3, (double)n * 1e9 / (double)elapsed_ns, st.slots, st.in_use_max,
+           atomic_load(&g_host_heap.peak), allocs_during);
+
+    CHECK(mismatches == 0);
+    CHECK(ok + timeouts + busy == n);
+    CHECK(ok > n / 2);
+    // Every timed-out request's reply eventually showed up and was dropped
+    // (the two from the single-threaded tests included).
+    CHECK(st.late_replies >= timeouts);
+    CHECK(st.in_use == 0);
+    // Slots and their semaphores are created once at init.
+    CHECK(allocs_during == 0);
+}
+
+int main(void) {
+    if (hub_reply_init() != ESP_OK) {
+        fprintf(stderr, "hub_reply_init failed\n");
+        return 1;
+    }
+    test_late_reply_does_not_leak_into_reused_slot();
+    test_exhaustion();
+    test_stress();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the reply-slot stress test.
+#
+# main/hub_reply.c is compiled against the shared stand-in headers in tools/host
+# (pthread-backed FreeRTOS semaphores, counting heap). Prints JSONL: p50/p99 latency, timeouts, late replies,
+# slot high-water mark and heap use.
+#
+# Usage:
+#   ./tools/reply_host/run_reply_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/hub-reply-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=thread}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -pthread \
+  -I"${HERE}/../host" -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/reply_host_test" \
+  "${HERE}/reply_host_test.c" "${MAIN_DIR}/hub_reply.c" "${HERE}/../host/host_heap.c"
+"${BUILD_DIR}/reply_host_test"
@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the scene expansion/scheduling host test.
+#
+# main/hub_scene_plan.c is plain C; it only needs hub_types.h, which builds
+# against the stand-in headers of tools/host. Prints JSONL: per
+# scene, the grouped plan next to a unicast-only plan (ops, predicted ms).
+#
+# Usage:
+#   ./tools/scene_host/run_scene_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/hub-scene-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -I"${HERE}/../host" -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/scene_host_test" \
+  "${HERE}/scene_host_test.c" "${MAIN_DIR}/hub_scene_plan.c"
+"${BUILD_DIR}/scene_host_test"
@@ -0,0 +1,403 @@
+/*
+ * Host test for scene expansion and scheduling (main/hub_scene_plan.c).
+ *
+ * Builds a device set the way the hub ends up with one after `hub seed` plus
+ * interviews (plugs, color bulbs, older level-only bulbs, temperature sensors),
+ * saves scenes the way hub_scene_save() does (assign groups), plans them and
+ * executes the ops against device models: group ops reach every programmed
+ * member (as the HUB_CMD_GROUP_SET handler in hub_bus.c does), unicast ops one
+ * device. Every device must end in the scene target masked by its caps, and the
+ * pacing must never exceed the burst per window. Also covers the NVS blob
+ * format. Prints JSONL comparing grouped plans with unicast-only plans.
+ *
+ * Exits non-zero on failure.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hub_scene_plan.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define MIN_GROUP 3
+#define BURST 4
+#define INTERVAL_MS 25
+
+#define N_PLUGS 12
+#define N_COLOR_BULBS 20
+#define N_WHITE_BULBS 6
+#define N_SENSORS 8
+#define N_DEVICES (N_PLUGS + N_COLOR_BULBS + N_WHITE_BULBS + N_SENSORS)
+
+static hub_device_t s_devs[N_DEVICES];
+static size_t s_n_devs;
+
+static const hub_scene_plan_cfg_t s_cfg = {.burst = BURST, .interval_ms = INTERVAL_MS, .min_group = MIN_GROUP};
+
+static void add_device(hub_device_type_t type, uint32_t caps, const char *prefix, size_t i) {
+    hub_device_t *d = &s_devs[s_n_devs];
+    memset(d, 0, sizeof(*d));
+    d->id = (uint32_t)(s_n_devs + 1);
+    d->type = type;
+    d->caps = caps;
+    snprintf(d->name, sizeof(d->name), "%s%zu", prefix, i);
+    d->temperature_c = 22.0f;
+    // on_cmd_device_add / interview defaults.
+    d->color_mireds = (caps & HUB_CAP_COLOR_TEMP) ? 370 : 0;
+    // Some runtime state, as the simulator would have left it.
+    d->on = (i % 2) == 0;
+    d->level = (caps & HUB_CAP_LEVEL) ? (uint8_t)(10 + i * 3) : 0;
+    d->power_w = (d->on && (caps & HUB_CAP_POWER)) ? 4.5f + (float)i : 0.0f;
+    s_n_devs++;
+}
+
+static void build_devices(void) {
+    s_n_devs = 0;
+    for (size_t i = 0; i < N_PLUGS; i++) add_device(HUB_DEVICE_PLUG, HUB_CAP_ONOFF | HUB_CAP_POWER, "plug", i);
+    for (size_t i = 0; i < N_COLOR_BULBS; i++) {
+        add_device(HUB_DEVICE_BULB, HUB_CAP_ONOFF | HUB_CAP_LEVEL | HUB_CAP_COLOR_TEMP, "bulb", i);
+    }
+    // Added with explicit caps and never interviewed: no color temperature.
+    for (size_t i = 0; i < N_WHITE_BULBS; i++) add_device(HUB_DEVICE_BULB, HUB_CAP_ONOFF | HUB_CAP_LEVEL, "white", i);
+    for (size_t i = 0; i < N_SENSORS; i++) add_device(HUB_DEVICE_TEMP_SENSOR, HUB_CAP_TEMPERATURE, "t", i);
+}
+
+static uint32_t plug_id(size_t i) { return (uint32_t)(1 + i); }
+static uint32_t bulb_id(size_t i) { return (uint32_t)(1 + N_PLUGS + i); }
+static uint32_t white_id(size_t i) { return (uint32_t)(1 + N_PLUGS + N_COLOR_BULBS + i); }
+static uint32_t sensor_id(size_t i) { return (uint32_t)(1 + N_PLUGS + N_COLOR_BULBS + N_WHITE_BULBS + i); }
+
+static hub_device_t *find_dev(hub_device_t *devs, size_t n, uint32_t id) {
+    for (size_t i = 0; i < n; i++) {
+        if (devs[i].id == id) return &devs[i];
+    }
+    return NULL;
+}
+
+static void add_entry(hub_scene_t *s, uint32_t id, uint8_t flags, bool on, uint8_t level, uint16_t mireds) {
+    if (s->n_entries >= HUB_SCENE_MAX_ENTRIES) abort();
+    hub_scene_entry_t *e = &s->entries[s->n_entries++];
+    e->device_id = id;
+    e->flags = flags;
+    e->on = on;
+    e->level = level;
+    e->color_mireds = mireds;
+}
+
+static void init_scene(hub_scene_t *s, uint16_t id, const char *name) {
+    memset(s, 0, sizeof(*s));
+    s->id = id;
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->transition_ds = 10;
+}
+
+static uint8_t caps_flags(uint32_t caps) {
+    return (uint8_t)(((caps & HUB_CAP_ONOFF) ? HUB_SCENE_F_ON : 0) | ((caps & HUB_CAP_LEVEL) ? HUB_SCENE_F_LEVEL : 0) |
+                     ((caps & HUB_CAP_COLOR_TEMP) ? HUB_SCENE_F_COLOR_TEMP : 0));
+}
+
+static bool check_pacing(const hub_scene_op_t *ops, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && ops[i].at_ms < ops[i - 1].at_ms) return false;
+        size_t in_window = 0;
+        for (size_t k = i; k < n && ops[k].at_ms < ops[i].at_ms + INTERVAL_MS; k++) in_window++;
+        if (in_window > BURST) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    size_t ops;
+    size_t group_ops;
+    size_t frames_per_device_max; // commands any one device received
+} exec_result_t;
+
+// Runs the ops against a copy of the device set and checks the end state.
+static bool execute_and_verify(const hub_scene_t *s, const hub_device_t *devs_in, size_t n_devs,
+                               const hub_scene_op_t *ops, size_t n_ops, exec_result_t *res) {
+    hub_device_t devs[N_DEVICES];
+    uint8_t frames[N_DEVICES] = {0};
+    memcpy(devs, devs_in, n_devs * sizeof(devs[0]));
+    memset(res, 0, sizeof(*res));
+
+    for (size_t i = 0; i < n_ops; i++) {
+        const hub_scene_op_t *op = &ops[i];
+        res->ops++;
+        if (op->kind == HUB_SCENE_OP_GROUP) {
+            res->group_ops++;
+            const hub_scene_group_t *g = NULL;
+            for (size_t k = 0; k < s->n_groups; k++) {
+                if (s->groups[k].group_id == op->group_id) g = &s->groups[k];
+            }
+            if (!g) return false;
+            for (size_t k = 0; k < s->n_entries; k++) {
+                if (!(g->members & (1u << k))) continue;
+                hub_device_t *d = find_dev(devs, n_devs, s->entries[k].device_id);
+                if (!d) continue; // member not on the network
+                (void)hub_scene_apply_to_device(d, op->flags, op->on, op->level, op->color_mireds);
+                frames[d - devs]++;
+            }
+        } else if (op->kind == HUB_SCENE_OP_UNICAST) {
+            hub_device_t *d = find_dev(devs, n_devs, op->device_id);
+            if (!d) return false; // planner must not address unknown devices
+            (void)hub_scene_apply_to_device(d, op->flags, op->on, op->level, op->color_mireds);
+            frames[d - devs]++;
+        } else {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < n_devs; i++) {
+        if (frames[i] > res->frames_per_device_max) res->frames_per_device_max = frames[i];
+        const hub_scene_entry_t *e = NULL;
+        for (size_t k = 0; k < s->n_entries; k++) {
+            if (s->entries[k].device_id == devs[i].id) e = &s->entries[k];
+        }
+        hub_device_t want = devs_in[i];
+        if (e) (void)hub_scene_apply_to_device(&want, e->flags, e->on, e->level, e->color_mireds);
+        if (want.on != devs[i].on || want.level != devs[i].level || want.color_mireds != devs[i].color_mireds ||
+            want.power_w != devs[i].power_w) {
+            fprintf(stderr, "device %u (%s) ends in the wrong state\n", devs[i].id, devs[i].name);
+            return false;
+        }
+        // Devices only get the scene's commands once.
+        if (frames[i] > 1) return false;
+        if (!e && frames[i] != 0) return false;
+    }
+    return true;
+}
+
+static void run_scene(const char *label, hub_scene_t *s, const hub_device_t *devs, size_t n_devs,
+                      hub_scene_plan_stats_t *out_st) {
+    hub_scene_assign_groups(s, MIN_GROUP);
+
+    hub_scene_op_t ops[HUB_SCENE_MAX_OPS];
+    hub_scene_plan_stats_t st;
+    const size_t n = hub_scene_plan(s, devs, n_devs, &s_cfg, ops, HUB_SCENE_MAX_OPS, &st);
+    CHECK(n == st.ops && st.ops == st.group_ops + st.unicast_ops);
+    CHECK(st.devices + st.skipped == s->n_entries);
+    CHECK(check_pacing(ops, n));
+    CHECK(st.predicted_ms == (n ? ops[n - 1].at_ms : 0));
+    exec_result_t res;
+    CHECK(execute_and_verify(s, devs, n_devs, ops, n, &res));
+
+    // The same scene with no groups programmed: one paced unicast per device.
+    hub_scene_t flat = *s;
+    flat.n_groups = 0;
+    hub_scene_op_t flat_ops[HUB_SCENE_MAX_OPS];
+    hub_scene_plan_stats_t flat_st;
+    const size_t flat_n = hub_scene_plan(&flat, devs, n_devs, &s_cfg, flat_ops, HUB_SCENE_MAX_OPS, &flat_st);
+    CHECK(flat_n == flat_st.devices && flat_st.group_ops == 0);
+    CHECK(check_pacing(flat_ops, flat_n));
+    CHECK(execute_and_verify(&flat, devs, n_devs, flat_ops, flat_n, &res));
+    CHECK(st.ops <= flat_st.ops && st.predicted_ms <= flat_st.predicted_ms);
+
+    printf("{\"test\":\"plan\",\"scene\":\"%s\",\"entries\":%u,\"groups\":%u,\"devices\":%u,\"skipped\":%u,"
+           "\"ops\":%u,\"group_ops\":%u,\"unicast_ops\":%u,\"predicted_ms\":%u,"
+           "\"unicast_only_ops\":%u,\"unicast_only_ms\":%u}\n",
+           label, s->n_entries, s->n_groups, st.devices, st.skipped, st.ops, st.group_ops, st.unicast_ops,
+           st.predicted_ms, flat_st.ops, flat_st.predicted_ms);
+    if (out_st) *out_st = st;
+}
+
+// Whole-house scene: shared targets collapse into a few group commands.
+static void test_evening(void) {
+    static hub_scene_t s;
+    init_scene(&s, 10, "evening");
+    for (size_t i = 0; i < 14; i++) {
+        add_entry(&s, bulb_id(i), HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL | HUB_SCENE_F_COLOR_TEMP, true, 30, 370);
+    }
+    // Same target as the color bulbs: white bulbs join the group and ignore the color.
+    for (size_t i = 0; i < N_WHITE_BULBS; i++) {
+        add_entry(&s, white_id(i), HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL | HUB_SCENE_F_COLOR_TEMP, true, 30, 370);
+    }
+    for (size_t i = 0; i < 6; i++) add_entry(&s, plug_id(i), HUB_SCENE_F_ON, false, 0, 0);
+    add_entry(&s, sensor_id(0), HUB_SCENE_F_ON, true, 0, 0); // nothing it supports: skipped
+    add_entry(&s, 9999, HUB_SCENE_F_ON, true, 0, 0);         // not on the network: skipped
+
+    hub_scene_plan_stats_t st;
+    run_scene("evening", &s, s_devs, s_n_devs, &st);
+    CHECK(s.n_groups == 2);
+    CHECK(st.group_ops == 2 && st.unicast_ops == 0 && st.skipped == 2);
+    CHECK(st.predicted_ms == 0);
+}
+
+// Every device gets a different level: nothing to group, paced unicast.
+static void test_gradient(void) {
+    static hub_scene_t s;
+    init_scene(&s, 11, "gradient");
+    for (size_t i = 0; i < N_COLOR_BULBS; i++) {
+        add_entry(&s, bulb_id(i), HUB_SCENE_F_LEVEL | HUB_SCENE_F_COLOR_TEMP, false, (uint8_t)(5 * i),
+                  (uint16_t)(153 + 17 * i));
+    }
+    hub_scene_plan_stats_t st;
+    run_scene("gradient", &s, s_devs, s_n_devs, &st);
+    CHECK(s.n_groups == 0 && st.unicast_ops == N_COLOR_BULBS);
+    CHECK(st.predicted_ms == ((N_COLOR_BULBS - 1) / BURST) * INTERVAL_MS);
+}
+
+// A mix of one shared target and per-device tweaks.
+static void test_mixed(void) {
+    static hub_scene_t s;
+    init_scene(&s, 12, "movie");
+    for (size_t i = 0; i < 8; i++) add_entry(&s, bulb_id(i), HUB_SCENE_F_ON, false, 0, 0);
+    for (size_t i = 8; i < 14; i++) {
+        add_entry(&s, bulb_id(i), HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL, true, (uint8_t)(i * 4), 0);
+    }
+    // Two entries share a target but are below MIN_GROUP: unicast.
+    add_entry(&s, plug_id(0), HUB_SCENE_F_ON, true, 0, 0);
+    add_entry(&s, plug_id(1), HUB_SCENE_F_ON, true, 0, 0);
+    hub_scene_plan_stats_t st;
+    run_scene("movie", &s, s_devs, s_n_devs, &st);
+    CHECK(s.n_groups == 1 && st.group_ops == 1 && st.unicast_ops == 8);
+}
+
+// Group members that left the network: with too few left, fall back to unicast.
+static void test_missing_members(void) {
+    static hub_scene_t s;
+    init_scene(&s, 13, "porch");
+    for (size_t i = 0; i < 4; i++) add_entry(&s, plug_id(i), HUB_SCENE_F_ON, true, 0, 0);
+    hub_scene_assign_groups(&s, MIN_GROUP);
+    CHECK(s.n_groups == 1);
+
+    // Drop plugs 0 and 1 from the network.
+    static hub_device_t devs[N_DEVICES];
+    size_t n = 0;
+    for (size_t i = 0; i < s_n_devs; i++) {
+        if (s_devs[i].id != plug_id(0) && s_devs[i].id != plug_id(1)) devs[n++] = s_devs[i];
+    }
+    hub_scene_plan_stats_t st;
+    run_scene("porch_2_missing", &s, devs, n, &st);
+    CHECK(st.group_ops == 0 && st.unicast_ops == 2 && st.skipped == 2);
+
+    // One missing: the group still has MIN_GROUP members and is used.
+    n = 0;
+    for (size_t i = 0; i < s_n_devs; i++) {
+        if (s_devs[i].id != plug_id(0)) devs[n++] = s_devs[i];
+    }
+    run_scene("porch_1_missing", &s, devs, n, &st);
+    CHECK(st.group_ops == 1 && st.unicast_ops == 0 && st.skipped == 1);
+}
+
+// More distinct shared targets than group slots: the rest go unicast.
+static void test_group_limit(void) {
+    static hub_scene_t s;
+    init_scene(&s, 14, "stripes");
+    for (size_t i = 0; i < 30; i++) {
+        const uint32_t id = i < N_COLOR_BULBS ? bulb_id(i) : plug_id(i - N_COLOR_BULBS);
+        add_entry(&s, id, HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL, true, (uint8_t)(10 * (i / 3)), 0);
+    }
+    hub_scene_plan_stats_t st;
+    run_scene("stripes", &s, s_devs, s_n_devs, &st);
+    CHECK(s.n_groups == HUB_SCENE_MAX_GROUPS);
+    CHECK(st.group_ops == HUB_SCENE_MAX_GROUPS && st.unicast_ops == 30 - 3 * HUB_SCENE_MAX_GROUPS);
+
+    // Group ids are unique, derived from the scene id, members disjoint.
+    uint32_t seen = 0;
+    for (size_t g = 0; g < s.n_groups; g++) {
+        CHECK((s.groups[g].group_id >> 4) == s.id);
+        CHECK((seen & s.groups[g].members) == 0);
+        seen |= s.groups[g].members;
+        for (size_t k = g + 1; k < s.n_groups; k++) CHECK(s.groups[g].group_id != s.groups[k].group_id);
+    }
+}
+
+static void test_caps_masking(void) {
+    hub_device_t plug = s_devs[0];
+    plug.on = true;
+    plug.power_w = 12.0f;
+    CHECK(hub_scene_apply_to_device(&plug, HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL, false, 80, 0));
+    CHECK(!plug.on && plug.level == 0 && plug.power_w == 0.0f);
+    CHECK(!hub_scene_apply_to_device(&plug, HUB_SCENE_F_COLOR_TEMP, false, 0, 250));
+
+    hub_device_t bulb = s_devs[N_PLUGS];
+    CHECK(hub_scene_apply_to_device(&bulb, HUB_SCENE_F_LEVEL, false, 250, 0));
+    CHECK(bulb.level == 100);
+    CHECK(caps_flags(bulb.caps) == (HUB_SCENE_F_ON | HUB_SCENE_F_LEVEL | HUB_SCENE_F_COLOR_TEMP));
+}
+
+static void test_builtin(void) {
+    hub_scene_op_t ops[2];
+    hub_scene_plan_stats_t st;
+    CHECK(hub_scene_plan_all(true, ops, 2, &st) == 1);
+    CHECK(ops[0].kind == HUB_SCENE_OP_GROUP && ops[0].group_id == HUB_SCENE_GROUP_ALL && ops[0].on);
+    CHECK(st.ops == 1 && st.group_ops == 1 && st.predicted_ms == 0);
+}
+
+static bool same_scene(const hub_scene_t *a, const hub_scene_t *b) {
+    if (a->id != b->id || a->transition_ds != b->transition_ds || a->n_entries != b->n_entries) return false;
+    if (strcmp(a->name, b->name) != 0) return false;
+    for (size_t i = 0; i < a->n_entries; i++) {
+        const hub_scene_entry_t *x = &a->entries[i];
+        const hub_scene_entry_t *y = &b->entries[i];
+        if (x->device_id != y->device_id || x->flags != y->flags || x->on != y->on || x->level != y->level ||
+            x->color_mireds != y->color_mireds) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_blob(void) {
+    static hub_scene_t s, back;
+    init_scene(&s, 4095, "a_long_name_xyz");
+    s.transition_ds = 600;
+    for (size_t i = 0; i < HUB_SCENE_MAX_ENTRIES; i++) {
+        add_entry(&s, 0x01020304u * (uint32_t)(i + 1), (uint8_t)(i % 8), (i % 3) == 0, (uint8_t)i, (uint16_t)(153 + i * 11));
+    }
+
+    uint8_t blob[HUB_SCENE_BLOB_MAX];
+    const size_t len = hub_scene_pack(&s, blob, sizeof(blob));
+    CHECK(len == 6 + strlen(s.name) + 8 * HUB_SCENE_MAX_ENTRIES);
+    CHECK(len <= HUB_SCENE_BLOB_MAX);
+    CHECK(hub_scene_pack(&s, blob, len - 1) == 0);
+    CHECK(hub_scene_unpack(s.id, blob, len, &back));
+    CHECK(same_scene(&s, &back));
+    printf("{\"test\":\"blob\",\"entries\":%u,\"bytes\":%zu,\"struct_bytes\":%zu}\n", s.n_entries, len,
+           sizeof(hub_scene_t));
+
+    // Corrupt or truncated blobs are rejected, never half-loaded.
+    CHECK(!hub_scene_unpack(s.id, blob, len - 1, &back));
+    CHECK(!hub_scene_unpack(s.id, blob, 5, &back));
+    blob[0] = 2;
+    CHECK(!hub_scene_unpack(s.id, blob, len, &back));
+    blob[0] = 1;
+    blob[4] = HUB_SCENE_NAME_LEN;
+    CHECK(!hub_scene_unpack(s.id, blob, len, &back));
+
+    // Empty scene.
+    static hub_scene_t empty;
+    init_scene(&empty, 3, "");
+    const size_t elen = hub_scene_pack(&empty, blob, sizeof(blob));
+    CHECK(elen == 6);
+    CHECK(hub_scene_unpack(3, blob, elen, &back) && same_scene(&empty, &back));
+}
+
+int main(void) {
+    build_devices();
+    test_evening();
+    test_gradient();
+    test_mixed();
+    test_missing_members();
+    test_group_limit();
+    test_caps_masking();
+    test_builtin();
+    test_blob();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the event stream coalescing/delta host test.
+#
+# main/hub_stream_delta.c has no FreeRTOS dependencies of its own; hub_types.h
+# is satisfied by the stand-in headers of tools/host. The test
+# replays burst_0029.csv and prints JSONL per client: frames, deltas and fields
+# sent versus events replayed.
+#
+# Usage:
+#   ./tools/stream_host/run_stream_host.sh [burst.csv]
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/hub-stream-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -I"${HERE}/../host" -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/stream_host_test" \
+  "${HERE}/stream_host_test.c" "${MAIN_DIR}/hub_stream_delta.c"
+"${BUILD_DIR}/stream_host_test" "${1:-${HERE}/burst_0029.csv}"
@@ -0,0 +1,333 @@
+/*
+ * Host test for the event stream coalescing/delta logic (main/hub_stream_delta.c).
+ *
+ * Replays a recorded burst of state/report events (burst_0029.csv) through the
+ * same fold -> flush -> per-client delta steps hub_stream.c runs, with a client
+ * joining mid-burst and one leaving, and applies what each client receives to a
+ * model of its view. Every connected client must end with the burst's final
+ * state while receiving far fewer frames than there were events. Repeated
+ * with an attribute table smaller than the device count, where overflowing
+ * events are sent as plain events instead.
+ *
+ * Built and run by tools/stream_host/run_stream_host.sh. Exits non-zero on failure.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hub_stream_delta.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define MAX_EVENTS 4096
+#define MAX_DEVICE_ID 32
+#define MAX_DELTAS_PER_FRAME 32 // hub.v1.HubEventBatch.deltas max_count
+
+typedef struct {
+    int64_t ts_us;
+    char kind; // 'S' state, 'R' report
+    hub_evt_device_state_t st;
+    hub_evt_device_report_t rep;
+} burst_event_t;
+
+static burst_event_t s_burst[MAX_EVENTS];
+static size_t s_burst_n;
+
+// What a client (or the ground truth) believes about each device.
+typedef struct {
+    uint8_t has;
+    bool on;
+    uint8_t level;
+    float power_w;
+    float temperature_c;
+} view_t;
+
+static view_t s_truth[MAX_DEVICE_ID + 1];
+
+static bool load_burst(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) && s_burst_n < MAX_EVENTS) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char *fld[7] = {0};
+        char *p = line;
+        for (int i = 0; i < 7; i++) {
+            fld[i] = p;
+            p = strchr(p, ',');
+            if (!p) break;
+            *p++ = '\0';
+        }
+        if (!fld[6]) continue;
+        fld[6][strcspn(fld[6], "\r\n")] = '\0';
+
+        burst_event_t *e = &s_burst[s_burst_n++];
+        memset(e, 0, sizeof(*e));
+        e->ts_us = strtoll(fld[0], NULL, 10);
+        e->kind = fld[1][0];
+        const uint32_t id = (uint32_t)strtoul(fld[2], NULL, 10);
+        if (e->kind == 'S') {
+            e->st = (hub_evt_device_state_t){.ts_us = e->ts_us, .device_id = id, .on = atoi(fld[3]) != 0,
+                                             .level = (uint8_t)atoi(fld[4])};
+        } else {
+            e->rep.ts_us = e->ts_us;
+            e->rep.device_id = id;
+            e->rep.has_power = fld[5][0] != '\0';
+            e->rep.power_w = e->rep.has_power ? strtof(fld[5], NULL) : 0.0f;
+            e->rep.has_temperature = fld[6][0] != '\0';
+            e->rep.temperature_c = e->rep.has_temperature ? strtof(fld[6], NULL) : 0.0f;
+        }
+    }
+    fclose(f);
+    return s_burst_n > 0;
+}
+
+static void apply_state(view_t *v, const hub_evt_device_state_t *st) {
+    v[st->device_id].on = st->on;
+    v[st->device_id].level = st->level;
+    v[st->device_id].has |= HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL;
+}
+
+static void apply_report(view_t *v, const hub_evt_device_report_t *rep) {
+    if (rep->has_power) {
+        v[rep->device_id].power_w = rep->power_w;
+        v[rep->device_id].has |= HUB_STREAM_F_POWER;
+    }
+    if (rep->has_temperature) {
+        v[rep->device_id].temperature_c = rep->temperature_c;
+        v[rep->device_id].has |= HUB_STREAM_F_TEMPERATURE;
+    }
+}
+
+static void apply_delta(view_t *v, const hub_stream_delta_t *d) {
+    view_t *x = &v[d->device_id];
+    if (d->fields & HUB_STREAM_F_ON) x->on = d->on;
+    if (d->fields & HUB_STREAM_F_LEVEL) x->level = d->level;
+    if (d->fields & HUB_STREAM_F_POWER) x->power_w = d->power_w;
+    if (d->fields & HUB_STREAM_F_TEMPERATURE) x->temperature_c = d->temperature_c;
+    x->has |= d->fields;
+}
+
+static bool views_equal(const view_t *a, const view_t *b) {
+    for (uint32_t id = 1; id <= MAX_DEVICE_ID; id++) {
+        if (a[id].has != b[id].has) return false;
+        if ((a[id].has & HUB_STREAM_F_ON) && a[id].on != b[id].on) return false;
+        if ((a[id].has & HUB_STREAM_F_LEVEL) && a[id].level != b[id].level) return false;
+        if ((a[id].has & HUB_STREAM_F_POWER) && a[id].power_w != b[id].power_w) return false;
+        if ((a[id].has & HUB_STREAM_F_TEMPERATURE) && a[id].temperature_c != b[id].temperature_c) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    int fd;
+    int64_t join_us;  // connects at this time
+    int64_t leave_us; // disconnects at this time (0 = stays)
+    view_t view[MAX_DEVICE_ID + 1];
+    uint32_t frames;
+    uint32_t deltas;
+    uint32_t fields;
+} client_t;
+
+static void replay(size_t table_cap, int64_t window_us, const char *label) {
+    hub_stream_attr_t *slots = calloc(table_cap, sizeof(*slots));
+    hub_stream_sent_t *sent = calloc(table_cap * HUB_STREAM_MAX_CLIENTS, sizeof(*sent));
+    hub_stream_dirty_t *dirty = calloc(table_cap, sizeof(*dirty));
+    hub_stream_attrs_t attrs;
+    hub_stream_clients_t cl;
+    hub_stream_attrs_init(&attrs, slots, table_cap);
+    hub_stream_clients_init(&cl, sent, table_cap);
+
+    const int64_t end_us = s_burst[s_burst_n - 1].ts_us;
+    client_t clients[3] = {
+        {.fd = 50, .join_us = 0},
+        {.fd = 51, .join_us = end_us / 2},
+        {.fd = 52, .join_us = end_us / 4, .leave_us = end_us / 3},
+    };
+    const size_t n_clients = sizeof(clients) / sizeof(clients[0]);
+
+    // Plain events of the current window (fold overflow), sent before the deltas.
+    static burst_event_t plain[MAX_EVENTS];
+    size_t n_plain = 0;
+    uint32_t plain_total = 0;
+    uint32_t windows = 0;
+
+    size_t next = 0;
+    for (int64_t win_end = window_us; next < s_burst_n || win_end - window_us <= end_us; win_end += window_us) {
+        // Events arriving during the window.
+        for (; next < s_burst_n && s_burst[next].ts_us < win_end; next++) {
+            const burst_event_t *e = &s_burst[next];
+            const bool folded = (e->kind == 'S') ? hub_stream_attrs_fold_state(&attrs, &e->st)
+                                                 : hub_stream_attrs_fold_report(&attrs, &e->rep);
+            if (!folded) plain[n_plain++] = *e;
+        }
+
+        // Flush, as stream_flush() does.
+        int fds[HUB_STREAM_MAX_CLIENTS];
+        uint32_t serials[HUB_STREAM_MAX_CLIENTS];
+        size_t n_fds = 0;
+        for (size_t c = 0; c < n_clients; c++) {
+            const bool connected = clients[c].join_us < win_end && (clients[c].leave_us == 0 || clients[c].leave_us >= win_end);
+            if (connected) {
+                serials[n_fds] = (uint32_t)c + 1;
+                fds[n_fds++] = clients[c].fd;
+            }
+        }
+        if (hub_stream_clients_sync(&cl, fds, serials, n_fds)) hub_stream_attrs_mark_all_dirty(&attrs);
+        const size_t n_dirty = hub_stream_attrs_take_dirty(&attrs, dirty, table_cap);
+        if (n_plain == 0 && n_dirty == 0) continue;
+        windows++;
+        plain_total += (uint32_t)n_plain;
+
+        for (size_t c = 0; c < n_clients; c++) {
+            client_t *cli = &clients[c];
+            const int ci = hub_stream_clients_index(&cl, cli->fd);
+            if (ci < 0) continue;
+
+            for (size_t i = 0; i < n_plain; i++) {
+                if (plain[i].kind == 'S') {
+                    apply_state(cli->view, &plain[i].st);
+                } else {
+                    apply_report(cli->view, &plain[i].rep);
+                }
+            }
+            size_t frame_deltas = 0;
+            for (size_t k = 0; k < n_dirty; k++) {
+                hub_stream_delta_t d;
+                if (!hub_stream_delta_for_client(&cl, (size_t)ci, &dirty[k], &d)) continue;
+                apply_delta(cli->view, &d);
+                cli->deltas++;
+                cli->fields += (uint32_t)__builtin_popcount(d.fields);
+                frame_deltas++;
+            }
+            // Frames hub_stream.c would send for this window.
+            const size_t frames = (frame_deltas + MAX_DELTAS_PER_FRAME - 1) / MAX_DELTAS_PER_FRAME;
+            const size_t ev_frames = (n_plain + 15) / 16;
+            cli->frames += (uint32_t)(frames > ev_frames ? frames : ev_frames);
+        }
+        n_plain = 0;
+    }
+
+    for (size_t c = 0; c < n_clients; c++) {
+        printf("{\"test\":\"%s\",\"client\":%d,\"events\":%zu,\"windows\":%u,\"frames\":%u,\"deltas\":%u,"
+               "\"fields\":%u,\"plain\":%u,\"coalesced\":%u}\n",
+               label, clients[c].fd, s_burst_n, windows, clients[c].frames, clients[c].deltas, clients[c].fields,
+               plain_total, attrs.coalesced);
+    }
+
+    // Clients connected at the end hold the burst's final state.
+    CHECK(views_equal(clients[0].view, s_truth));
+    CHECK(views_equal(clients[1].view, s_truth));
+    // The late joiner got everything in far fewer frames than events.
+    CHECK(clients[0].frames < s_burst_n / 4);
+    CHECK(clients[1].frames < clients[0].frames);
+    // The client that left stopped receiving.
+    CHECK(clients[2].frames > 0 && clients[2].frames < clients[0].frames);
+
+    free(slots);
+    free(sent);
+    free(dirty);
+}
+
+static void test_repeated_values_not_resent(void) {
+    hub_stream_attr_t slots[4];
+    hub_stream_sent_t sent[4 * HUB_STREAM_MAX_CLIENTS];
+    hub_stream_dirty_t dirty[4];
+    hub_stream_attrs_t attrs;
+    hub_stream_clients_t cl;
+    hub_stream_attrs_init(&attrs, slots, 4);
+    hub_stream_clients_init(&cl, sent, 4);
+
+    const int fds[] = {7};
+    const uint32_t serials[] = {1};
+    CHECK(hub_stream_clients_sync(&cl, fds, serials, 1));
+    CHECK(!hub_stream_clients_sync(&cl, fds, serials, 1));
+
+    hub_evt_device_report_t rep = {.device_id = 3, .has_temperature = true, .temperature_c = 21.5f};
+    CHECK(hub_stream_attrs_fold_report(&attrs, &rep));
+    CHECK(hub_stream_attrs_fold_report(&attrs, &rep));
+    CHECK(attrs.coalesced == 1);
+
+    hub_stream_delta_t d;
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+    CHECK(d.fields == HUB_STREAM_F_TEMPERATURE && d.temperature_c == 21.5f);
+
+    // Same reading again: dirty, but nothing new for the client.
+    CHECK(hub_stream_attrs_fold_report(&attrs, &rep));
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(!hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+
+    // A state change sends on/level only.
+    hub_evt_device_state_t st = {.device_id = 3, .on = true, .level = 40};
+    CHECK(hub_stream_attrs_fold_state(&attrs, &st));
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+    CHECK(d.fields == (HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL));
+
+    // A reconnect on a reused fd index starts from scratch.
+    CHECK(!hub_stream_clients_sync(&cl, NULL, NULL, 0));
+    CHECK(hub_stream_clients_sync(&cl, fds, serials, 1));
+    hub_stream_attrs_mark_all_dirty(&attrs);
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+    CHECK(d.fields == (HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL | HUB_STREAM_F_TEMPERATURE));
+
+    // So does a new connection on the same fd that was never seen disconnecting.
+    const uint32_t serials_next[] = {2};
+    CHECK(hub_stream_clients_sync(&cl, fds, serials_next, 1));
+    CHECK(hub_stream_clients_index(&cl, 7) == 0);
+    hub_stream_attrs_mark_all_dirty(&attrs);
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+    CHECK(d.fields == (HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL | HUB_STREAM_F_TEMPERATURE));
+
+    // A frame that failed to send is forgotten, so the retry carries the same fields.
+    hub_stream_clients_forget(&cl, 0);
+    hub_stream_attrs_mark_all_dirty(&attrs);
+    CHECK(hub_stream_attrs_take_dirty(&attrs, dirty, 4) == 1);
+    CHECK(hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+    CHECK(d.fields == (HUB_STREAM_F_ON | HUB_STREAM_F_LEVEL | HUB_STREAM_F_TEMPERATURE));
+    CHECK(!hub_stream_delta_for_client(&cl, 0, &dirty[0], &d));
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : "burst_0029.csv";
+    if (!load_burst(path)) {
+        fprintf(stderr, "no events in %s\n", path);
+        return 1;
+    }
+    for (size_t i = 0; i < s_burst_n; i++) {
+        if (s_burst[i].kind == 'S') {
+            apply_state(s_truth, &s_burst[i].st);
+        } else {
+            apply_report(s_truth, &s_burst[i].rep);
+        }
+    }
+
+    test_repeated_values_not_resent();
+    replay(64, 100000, "burst_100ms");
+    replay(64, 20000, "burst_20ms");
+    // Fewer slots than devices: overflow goes out as plain events, nothing is lost.
+    replay(4, 100000, "burst_small_table");
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,486 @@
+/*
+ * Host test and benchmark for the telemetry store (main/hub_tsdb.c).
+ *
+ * Feeds irregular samples into a series and checks every tier against a
+ * brute-force reference (min/max/sum/count per bucket, ring window), then
+ * covers late samples, cursor continuation, a full series table, the flash
+ * snapshot round trip (within the quantisation step) and rejection of torn or
+ * damaged snapshots, using a RAM buffer as the flash region. Writes one
+ * TelemetrySeries response and the same series in protobuf text format, which
+ * run_tsdb_host.sh encodes with protoc for comparison. Finally times inserts
+ * and range queries for 100 devices x 8 attributes and prints JSONL.
+ *
+ * Usage: tsdb_host_test <out.bin> <out.textproto>. Exits non-zero on failure.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hub_tsdb.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+// Same ring lengths as the Kconfig defaults.
+static const hub_tsdb_cfg_t s_cfg = {.points = {60, 120, 48}};
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void *s_mem;
+
+static bool db_new(hub_tsdb_t *db, size_t cap) {
+    free(s_mem);
+    s_mem = calloc(1, hub_tsdb_mem_size(&s_cfg, cap));
+    return s_mem && hub_tsdb_init(db, &s_cfg, cap, s_mem) == ESP_OK;
+}
+
+// --- RAM flash ----------------------------------------------------------------
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+} ram_flash_t;
+
+static esp_err_t ram_write(void *ctx, size_t off, const void *data, size_t len) {
+    ram_flash_t *f = ctx;
+    if (off + len > f->size) return ESP_ERR_INVALID_SIZE;
+    // NOR flash semantics: bits only go from 1 to 0.
+    const uint8_t *src = data;
+    for (size_t i = 0; i < len; i++) f->data[off + i] &= src[i];
+    return ESP_OK;
+}
+
+static esp_err_t ram_read(void *ctx, size_t off, void *data, size_t len) {
+    ram_flash_t *f = ctx;
+    if (off + len > f->size) return ESP_ERR_INVALID_SIZE;
+    memcpy(data, f->data + off, len);
+    return ESP_OK;
+}
+
+static void ram_erase(ram_flash_t *f) {
+    memset(f->data, 0xff, f->size);
+}
+
+// --- reference ----------------------------------------------------------------
+
+typedef struct {
+    uint32_t t;
+    float v;
+} sample_t;
+
+// Reference bucket b of a tier from all samples (same fold order as the store).
+static hub_tsdb_point_t ref_bucket(const sample_t *s, size_t n, uint32_t period, uint32_t b) {
+    hub_tsdb_point_t p = {.t = b * period};
+    for (size_t i = 0; i < n; i++) {
+        if (s[i].t / period != b) continue;
+        if (p.count == 0) {
+            p.min = p.max = p.sum = s[i].v;
+        } else {
+            if (s[i].v < p.min) p.min = s[i].v;
+            if (s[i].v > p.max) p.max = s[i].v;
+            p.sum += s[i].v;
+        }
+        p.count++;
+    }
+    return p;
+}
+
+static bool same_point(const hub_tsdb_point_t *a, const hub_tsdb_point_t *b) {
+    return a->t == b->t && a->count == b->count && a->min == b->min && a->max == b->max && a->sum == b->sum;
+}
+
+#define N_SAMPLES 30000
+
+static sample_t s_samples[N_SAMPLES];
+
+static void test_tiers_match_reference(void) {
+    hub_tsdb_t db;
+    CHECK(db_new(&db, 4));
+
+    // ~2 days of irregular samples with gaps of up to 20 min.
+    uint32_t t = 1000;
+    size_t n = 0;
+    for (; n < N_SAMPLES; n++) {
+        const uint32_t r = rnd();
+        t += (r % 64 == 0) ? 60 + r % 1200 : r % 8;
+        s_samples[n].t = t;
+        s_samples[n].v = 20.0f + (float)(rnd() % 2000) / 100.0f;
+        CHECK(hub_tsdb_insert(&db, 7, HUB_TS_ATTR_TEMPERATURE_C, t, s_samples[n].v));
+    }
+    CHECK(db.stats.inserts == N_SAMPLES && db.stats.late == 0);
+    CHECK(hub_tsdb_find(&db, 7, HUB_TS_ATTR_TEMPERATURE_C)->last_t == t);
+
+    for (size_t k = 0; k < HUB_TSDB_TIERS; k++) {
+        const uint32_t period = hub_tsdb_period_s((hub_tsdb_tier_t)k);
+        const uint32_t last_b = t / period;
+        const uint32_t oldest = last_b + 1 - s_cfg.points[k];
+
+        // Expected: non-empty buckets inside the ring window.
+        static hub_tsdb_point_t want[120];
+        size_t n_want = 0;
+        for (uint32_t b = oldest; b <= last_b; b++) {
+            const hub_tsdb_point_t p = ref_bucket(s_samples, n, period, b);
+            if (p.count) want[n_want++] = p;
+        }
+        CHECK(n_want > 0);
+
+        // Small batches exercise cursor continuation.
+        uint32_t cursor = 0;
+        size_t got = 0;
+        hub_tsdb_point_t out[7];
+        size_t m;
+        while ((m = hub_tsdb_read(&db, 7, HUB_TS_ATTR_TEMPERATURE_C, (hub_tsdb_tier_t)k, &cursor, UINT32_MAX, out,
+                                  7)) > 0) {
+            for (size_t i = 0; i < m; i++) {
+                CHECK(got < n_want && same_point(&out[i], &want[got]));
+                got++;
+            }
+        }
+        CHECK(got == n_want);
+
+        // A sub-range starting mid-bucket includes that bucket.
+        const uint32_t from = want[n_want / 2].t + period / 2;
+        const uint32_t to = want[n_want - 1].t - 1;
+        cursor = from;
+        m = hub_tsdb_read(&db, 7, HUB_TS_ATTR_TEMPERATURE_C, (hub_tsdb_tier_t)k, &cursor, to, out, 1);
+        CHECK(m == 1 && out[0].t == want[n_want / 2].t);
+        printf("{\"test\":\"tier\",\"period_s\":%u,\"ring\":%u,\"buckets\":%zu}\n", period, s_cfg.points[k], n_want);
+    }
+
+    // Unknown series, wrong tier, empty range.
+    uint32_t cursor = 0;
+    hub_tsdb_point_t out[4];
+    CHECK(hub_tsdb_read(&db, 8, HUB_TS_ATTR_TEMPERATURE_C, HUB_TSDB_TIER_1S, &cursor, UINT32_MAX, out, 4) == 0);
+    CHECK(hub_tsdb_read(&db, 7, HUB_TS_ATTR_TEMPERATURE_C, (hub_tsdb_tier_t)3, &cursor, UINT32_MAX, out, 4) == 0);
+    cursor = t + 1;
+    CHECK(hub_tsdb_read(&db, 7, HUB_TS_ATTR_TEMPERATURE_C, HUB_TSDB_TIER_1S, &cursor, UINT32_MAX, out, 4) == 0);
+}
+
+static void test_late_samples(void) {
+    hub_tsdb_t db;
+    CHECK(db_new(&db, 4));
+
+    CHECK(hub_tsdb_insert(&db, 1, HUB_TS_ATTR_POWER_W, 5000, 10.0f));
+    // Slightly out of order: same minute, its own second.
+    CHECK(hub_tsdb_insert(&db, 1, HUB_TS_ATTR_POWER_W, 4999, 20.0f));
+    CHECK(db.stats.late == 0);
+    // 60 s back: the 1 s slot now holds t=5000, so only that tier drops it.
+    CHECK(hub_tsdb_insert(&db, 1, HUB_TS_ATTR_POWER_W, 4940, 30.0f));
+    CHECK(db.stats.late == 1);
+    CHECK(hub_tsdb_find(&db, 1, HUB_TS_ATTR_POWER_W)->last_t == 5000);
+
+    uint32_t cursor = 0;
+    hub_tsdb_point_t out[4];
+    CHECK(hub_tsdb_read(&db, 1, HUB_TS_ATTR_POWER_W, HUB_TSDB_TIER_1M, &cursor, UINT32_MAX, out, 4) == 2);
+    CHECK(out[0].t == 4920 && out[0].count == 1 && out[0].sum == 30.0f);
+    CHECK(out[1].t == 4980 && out[1].count == 2 && out[1].min == 10.0f && out[1].max == 20.0f);
+    cursor = 0;
+    CHECK(hub_tsdb_read(&db, 1, HUB_TS_ATTR_POWER_W, HUB_TSDB_TIER_1H, &cursor, UINT32_MAX, out, 4) == 1);
+    CHECK(out[0].t == 3600 && out[0].count == 3 && out[0].sum == 60.0f);
+
+    // NaN and out-of-range attributes are refused.
+    CHECK(!hub_tsdb_insert(&db, 1, HUB_TS_ATTR_POWER_W, 5001, NAN));
+    CHECK(!hub_tsdb_insert(&db, 1, HUB_TSDB_MAX_ATTRS, 5001, 1.0f));
+    CHECK(!hub_tsdb_insert(&db, 0, HUB_TS_ATTR_POWER_W, 5001, 1.0f));
+}
+
+static void test_full_table(void) {
+    hub_tsdb_t db;
+    CHECK(db_new(&db, 4));
+    for (uint32_t id = 1; id <= 4; id++) CHECK(hub_tsdb_insert(&db, id, HUB_TS_ATTR_ON, 10, 1.0f));
+    CHECK(!hub_tsdb_insert(&db, 5, HUB_TS_ATTR_ON, 10, 1.0f));
+    CHECK(db.stats.series_full == 1);
+    // Existing series still take samples.
+    CHECK(hub_tsdb_insert(&db, 4, HUB_TS_ATTR_ON, 11, 0.0f));
+    CHECK(hub_tsdb_find(&db, 5, HUB_TS_ATTR_ON) == NULL);
+    CHECK(hub_tsdb_find(&db, 4, HUB_TS_ATTR_ON)->last_t == 11);
+}
+
+// --- snapshot ---------------------------------------------------------------
+
+#define FLASH_SIZE (64 * 1024)
+
+static const uint8_t k_attrs[] = {HUB_TS_ATTR_ON, HUB_TS_ATTR_LEVEL, HUB_TS_ATTR_POWER_W, HUB_TS_ATTR_TEMPERATURE_C};
+
+static void fill_hub_like(hub_tsdb_t *db, uint32_t devices, uint32_t seconds) {
+    for (uint32_t t = 100; t < 100 + seconds; t += 5) {
+        for (uint32_t id = 1; id <= devices; id++) {
+            const uint8_t attr = k_attrs[id % 4];
+            // Sensors report rarely; leave gaps.
+            if (attr == HUB_TS_ATTR_TEMPERATURE_C && (t / 5) % 12 != 0) continue;
+            float v;
+            switch (attr) {
+                case HUB_TS_ATTR_ON: v = (float)(rnd() % 2); break;
+                case HUB_TS_ATTR_LEVEL: v = (float)(rnd() % 255); break;
+                case HUB_TS_ATTR_POWER_W: v = (float)(rnd() % 6000) / 100.0f; break;
+                default: v = -5.0f + (float)(rnd() % 3000) / 100.0f; break;
+            }
+            hub_tsdb_insert(db, id, attr, t, v);
+        }
+    }
+}
+
+static bool close_to(float a, float b, float step) {
+    return fabsf(a - b) <= step * 0.5f + fabsf(b) * 1e-6f;
+}
+
+static void test_snapshot_round_trip(void) {
+    hub_tsdb_t db;
+    CHECK(db_new(&db, 32));
+    fill_hub_like(&db, 24, 3 * 3600 + 123);
+    // Keep db's memory: db_new frees the previous one.
+    void *mem_a = s_mem;
+    s_mem = NULL;
+
+    ram_flash_t flash = {.data = malloc(FLASH_SIZE), .size = FLASH_SIZE};
+    CHECK(flash.data);
+    ram_erase(&flash);
+
+    hub_tsdb_file_info_t info;
+    CHECK(hub_tsdb_check(flash.size, ram_read, &flash, &info) == ESP_ERR_NOT_FOUND);
+
+    size_t len = 0;
+    const double t0 = now_s();
+    CHECK(hub_tsdb_save(&db, 42, 11000, flash.size, ram_write, &flash, &len) == ESP_OK);
+    const double t_save = now_s() - t0;
+    CHECK(hub_tsdb_check(flash.size, ram_read, &flash, &info) == ESP_OK);
+    CHECK(info.seq == 42 && info.saved_t == 11000 && info.body_len + HUB_TSDB_FILE_HEADER == len);
+
+    hub_tsdb_t db2;
+    CHECK(db_new(&db2, 32));
+    CHECK(hub_tsdb_load(&db2, flash.size, ram_read, &flash, &info) == ESP_OK);
+    CHECK(db2.n == db.n);
+
+    size_t points = 0;
+    for (size_t i = 0; i < db.n; i++) {
+        const hub_tsdb_series_t *s = &db.series[i];
+        const hub_tsdb_series_t *s2 = hub_tsdb_find(&db2, s->device_id, s->attr);
+        CHECK(s2 && s2->last_t == s->last_t);
+        const float step = (s->attr == HUB_TS_ATTR_POWER_W || s->attr == HUB_TS_ATTR_TEMPERATURE_C) ? 0.01f : 1.0f;
+
+        for (size_t k = HUB_TSDB_TIER_1M; k < HUB_TSDB_TIERS; k++) {
+            hub_tsdb_point_t a[120], b[120];
+            uint32_t ca = 0, cb = 0;
+            const size_t na = hub_tsdb_read(&db, s->device_id, s->attr, (hub_tsdb_tier_t)k, &ca, UINT32_MAX, a, 120);
+            const size_t nb = hub_tsdb_read(&db2, s->device_id, s->attr, (hub_tsdb_tier_t)k, &cb, UINT32_MAX, b, 120);
+            CHECK(na == nb && na > 0);
+            for (size_t j = 0; j < na; j++) {
+                CHECK(a[j].t == b[j].t && a[j].count == b[j].count);
+                CHECK(close_to(b[j].min, a[j].min, step) && close_to(b[j].max, a[j].max, step));
+                CHECK(close_to(b[j].sum / (float)b[j].count, a[j].sum / (float)a[j].count, step));
+            }
+            points += na;
+        }
+        // The 1 s tier is not persisted.
+        hub_tsdb_point_t p;
+        uint32_t c = 0;
+        CHECK(hub_tsdb_read(&db2, s->device_id, s->attr, HUB_TSDB_TIER_1S, &c, UINT32_MAX, &p, 1) == 0);
+    }
+    printf("{\"test\":\"snapshot\",\"series\":%zu,\"points\":%zu,\"bytes\":%zu,\"bytes_per_point\":%.2f,"
+           "\"ram_point_bytes\":%zu,\"save_ms\":%.3f}\n",
+           db.n, points, len, (double)len / (double)points, sizeof(hub_tsdb_point_t), t_save * 1e3);
+
+    // Region too small.
+    ram_erase(&flash);
+    CHECK(hub_tsdb_save(&db, 43, 11000, len - 1, ram_write, &flash, NULL) == ESP_ERR_INVALID_SIZE);
+    // Torn write: body written, header never reached.
+    CHECK(hub_tsdb_check(flash.size, ram_read, &flash, &info) == ESP_ERR_NOT_FOUND);
+
+    // One flipped bit in the body.
+    ram_erase(&flash);
+    CHECK(hub_tsdb_save(&db, 44, 11000, flash.size, ram_write, &flash, &len) == ESP_OK);
+    flash.data[HUB_TSDB_FILE_HEADER + len / 2] ^= 0x10;
+    CHECK(hub_tsdb_check(flash.size, ram_read, &flash, &info) == ESP_ERR_INVALID_CRC);
+    hub_tsdb_t db3;
+    CHECK(db_new(&db3, 32));
+    CHECK(hub_tsdb_load(&db3, flash.size, ram_read, &flash, &info) == ESP_ERR_INVALID_CRC && db3.n == 0);
+
+    // A smaller table keeps what fits and counts the rest.
+    ram_erase(&flash);
+    CHECK(hub_tsdb_save(&db, 45, 11000, flash.size, ram_write, &flash, &len) == ESP_OK);
+    CHECK(db_new(&db3, 8));
+    CHECK(hub_tsdb_load(&db3, flash.size, ram_read, &flash, &info) == ESP_OK);
+    CHECK(db3.n == 8 && db3.stats.series_full == db.n - 8);
+
+    free(flash.data);
+    free(mem_a);
+}
+
+// --- wire encoding -----------------------------------------------------------
+
+static const char *attr_name(uint8_t attr) {
+    switch (attr) {
+        case HUB_TS_ATTR_ON: return "TELEMETRY_ATTR_ON";
+        case HUB_TS_ATTR_LEVEL: return "TELEMETRY_ATTR_LEVEL";
+        case HUB_TS_ATTR_POWER_W: return "TELEMETRY_ATTR_POWER_W";
+        case HUB_TS_ATTR_TEMPERATURE_C: return "TELEMETRY_ATTR_TEMPERATURE_C";
+        case HUB_TS_ATTR_COLOR_TEMP: return "TELEMETRY_ATTR_COLOR_TEMP";
+        default: return "TELEMETRY_ATTR_UNSPECIFIED";
+    }
+}
+
+// Streams a series the way the HTTP handler does; mirrors it as text format.
+static void test_wire(const char *bin_path, const char *txt_path) {
+    hub_tsdb_t db;
+    CHECK(db_new(&db, 4));
+    for (uint32_t t = 0; t < 900; t += 3) {
+        // Includes zero and negative values (omitted / sign handling).
+        CHECK(hub_tsdb_insert(&db, 3, HUB_TS_ATTR_TEMPERATURE_C, t, (float)((int)(t % 41) - 20) / 4.0f));
+    }
+
+    FILE *fb = fopen(bin_path, "wb");
+    FILE *ft = fopen(txt_path, "w");
+    CHECK(fb && ft);
+
+    uint8_t buf[HUB_TSDB_POINT_ENTRY_MAX];
+    size_t len;
+    CHECK(hub_tsdb_encode_series_header(3, HUB_TS_ATTR_TEMPERATURE_C, 60, 899, buf, sizeof(buf), &len));
+    fwrite(buf, 1, len, fb);
+    fprintf(ft, "device_id: 3\nattr: %s\nperiod_s: 60\nnow: 899\n", attr_name(HUB_TS_ATTR_TEMPERATURE_C));
+
+    uint32_t cursor = 0;
+    hub_tsdb_point_t pts[4];
+    size_t n, total = 0;
+    while ((n = hub_tsdb_read(&db, 3, HUB_TS_ATTR_TEMPERATURE_C, HUB_TSDB_TIER_1M, &cursor, UINT32_MAX, pts, 4)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            CHECK(hub_tsdb_encode_point_entry(&pts[i], buf, sizeof(buf), &len));
+            // Every cap below the encoded size must fail cleanly.
+            size_t m;
+            for (size_t cap = 0; cap < len; cap++) CHECK(!hub_tsdb_encode_point_entry(&pts[i], buf, cap, &m));
+            CHECK(hub_tsdb_encode_point_entry(&pts[i], buf, len, &m) && m == len);
+            fwrite(buf, 1, len, fb);
+            fprintf(ft, "points { t: %u min: %.9g max: %.9g avg: %.9g count: %u }\n", pts[i].t, pts[i].min,
+                    pts[i].max, pts[i].sum / (float)pts[i].count, pts[i].count);
+            total++;
+        }
+    }
+    fclose(fb);
+    fclose(ft);
+    CHECK(total == 15);
+
+    // Worst case fits HUB_TSDB_POINT_ENTRY_MAX.
+    const hub_tsdb_point_t worst = {.t = UINT32_MAX, .min = -1e30f, .max = 1e30f, .sum = 3.3f, .count = UINT32_MAX};
+    CHECK(hub_tsdb_encode_point_entry(&worst, buf, sizeof(buf), &len));
+    printf("{\"test\":\"wire\",\"points\":%zu,\"max_entry_bytes\":%zu}\n", total, len);
+}
+
+// --- benchmark ---------------------------------------------------------------
+
+#define BENCH_DEVICES 100
+#define BENCH_ATTRS 8
+#define BENCH_SECONDS 7200
+
+static void bench(void) {
+    hub_tsdb_t db;
+    const size_t cap = BENCH_DEVICES * BENCH_ATTRS;
+    if (!db_new(&db, cap)) {
+        g_failures++;
+        return;
+    }
+
+    // One sample per series per second, values drifting like real readings.
+    float v[BENCH_DEVICES * BENCH_ATTRS];
+    for (size_t i = 0; i < cap; i++) v[i] = (float)(rnd() % 1000);
+    double t0 = now_s();
+    for (uint32_t t = 1; t <= BENCH_SECONDS; t++) {
+        for (uint32_t d = 0; d < BENCH_DEVICES; d++) {
+            for (uint8_t a = 0; a < BENCH_ATTRS; a++) {
+                float *x = &v[d * BENCH_ATTRS + a];
+                *x += (float)((int)(rnd() % 201) - 100) / 100.0f;
+                hub_tsdb_insert(&db, d + 1, a, t, *x);
+            }
+        }
+    }
+    const double t_insert = now_s() - t0;
+    const uint32_t inserts = (uint32_t)cap * BENCH_SECONDS;
+    if (db.stats.inserts != inserts || db.n != cap) {
+        fprintf(stderr, "bench: %u inserts, %zu series\n", db.stats.inserts, db.n);
+        g_failures++;
+    }
+    printf("{\"bench\":\"insert\",\"devices\":%d,\"attrs\":%d,\"series\":%zu,\"inserts\":%u,\"inserts_per_s\":%.0f,"
+           "\"ram_bytes\":%zu}\n",
+           BENCH_DEVICES, BENCH_ATTRS, db.n, inserts, inserts / t_insert, hub_tsdb_mem_size(&s_cfg, cap));
+
+    // Full-range query of every series per tier, 32 points per call as the HTTP handler does.
+    for (size_t k = 0; k < HUB_TSDB_TIERS; k++) {
+        uint32_t queries = 0, points = 0;
+        hub_tsdb_point_t out[32];
+        t0 = now_s();
+        for (int rep = 0; rep < 20; rep++) {
+            for (uint32_t d = 0; d < BENCH_DEVICES; d++) {
+                for (uint8_t a = 0; a < BENCH_ATTRS; a++) {
+                    uint32_t cursor = 0;
+                    size_t n;
+                    while ((n = hub_tsdb_read(&db, d + 1, a, (hub_tsdb_tier_t)k, &cursor, UINT32_MAX, out, 32)) > 0) {
+                        points += (uint32_t)n;
+                    }
+                    queries++;
+                }
+            }
+        }
+        const double dt = now_s() - t0;
+        printf("{\"bench\":\"query\",\"period_s\":%u,\"queries\":%u,\"queries_per_s\":%.0f,\"points_per_s\":%.0f,"
+               "\"points_per_query\":%.1f}\n",
+               hub_tsdb_period_s((hub_tsdb_tier_t)k), queries, queries / dt, points / dt, (double)points / queries);
+    }
+
+    ram_flash_t flash = {.data = malloc(4u << 20), .size = 4u << 20};
+    if (!flash.data) {
+        g_failures++;
+        return;
+    }
+    ram_erase(&flash);
+    size_t len = 0;
+    t0 = now_s();
+    const esp_err_t err = hub_tsdb_save(&db, 1, BENCH_SECONDS, flash.size, ram_write, &flash, &len);
+    const double t_save = now_s() - t0;
+    if (err != ESP_OK) g_failures++;
+    printf("{\"bench\":\"snapshot\",\"series\":%zu,\"bytes\":%zu,\"save_ms\":%.2f}\n", db.n, len, t_save * 1e3);
+    free(flash.data);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <out.bin> <out.textproto>\n", argv[0]);
+        return 2;
+    }
+
+    test_tiers_match_reference();
+    test_late_samples();
+    test_full_table();
+    test_snapshot_round_trip();
+    test_wire(argv[1], argv[2]);
+
+    if (g_failures == 0) bench();
+    free(s_mem);
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -14,6 +14,32 @@ extern "C" {
 // but the 0031 orchestrator needs to invoke specific host protocol requests.
 esp_err_t esp_host_zb_output(uint16_t id, const void *buffer, uint16_t len, void *output, uint16_t *outlen);
 
+// Pipelined requests: `send` returns once the frame is queued to the NCP, and
+// `wait` blocks for that request's response only. Responses are matched by
+// sequence number, so several requests (from one or many tasks) may be in
+// flight at once and complete in any order. `wait` must be called exactly
+// once per successful `send`; it releases the request, also on timeout.
+typedef struct esp_host_zb_req esp_host_zb_req_t;
+
+esp_err_t esp_host_zb_request_send(uint16_t id,
+                                   const void *buffer,
+                                   uint16_t len,
+                                   void *output,
+                                   uint16_t *outlen,
+                                   esp_host_zb_req_t **req);
+esp_err_t esp_host_zb_request_wait(esp_host_zb_req_t *req, uint32_t timeout_ms);
+
+typedef struct {
+    uint32_t sent;          // requests sent
+    uint32_t completed;     // responses matched to a waiting request
+    uint32_t timeouts;      // requests that gave up waiting
+    uint32_t unmatched;     // responses with no waiting request (late/duplicate)
+    uint32_t inflight;      // requests currently outstanding
+    uint32_t inflight_max;
+} esp_host_zb_pending_stats_t;
+
+void esp_host_zb_get_pending_stats(esp_host_zb_pending_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
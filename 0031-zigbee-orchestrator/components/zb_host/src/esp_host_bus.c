@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <inttypes.h>
 #include <string.h>
 #include <sys/fcntl.h>
 #include <sys/errno.h>
@@ -60,65 +61,80 @@ static esp_err_t host_bus_init_hdl(uint8_t transport)
     uart_set_pin(CONFIG_HOST_BUS_UART_NUM, CONFIG_HOST_BUS_UART_TX_PIN, CONFIG_HOST_BUS_UART_RX_PIN, CONFIG_HOST_BUS_UART_RTS_PIN, CONFIG_HOST_BUS_UART_CTS_PIN);
     uart_flush_input(CONFIG_HOST_BUS_UART_NUM);
 
-    // Configure a SLIP framing detector so we only forward complete frames.
-    esp_err_t err = uart_enable_pattern_det_baud_intr(CONFIG_HOST_BUS_UART_NUM, SLIP_END, 1, 1, 0, 0);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "uart_enable_pattern_det_baud_intr failed");
-        return err;
-    }
-    uart_pattern_queue_reset(CONFIG_HOST_BUS_UART_NUM, 20);
-
     return ESP_OK;
 }
 
+/* Forward one decoded ZNSP frame to the host main task. */
+static void host_bus_deliver(esp_host_bus_t *bus, const uint8_t *frame, size_t len)
+{
+    esp_host_ctx_t host_event = {
+        .event = HOST_EVENT_INPUT,
+        .size = len,
+    };
+
+    if (xStreamBufferSend(bus->input_buf, frame, len, 0) != len) {
+        ESP_LOGW(TAG, "input_buf full, dropping %u byte frame", (unsigned)len);
+        return;
+    }
+    esp_host_send_event(&host_event);
+}
+
 static void esp_host_bus_task(void *pvParameter)
 {
     uart_event_t event;
     uint8_t *dtmp = (uint8_t*)malloc(HOST_BUS_BUF_SIZE);
+    uint8_t *frame = (uint8_t*)malloc(HOST_BUS_BUF_SIZE);
+    slip_decoder_t slip;
 
     esp_host_bus_t *bus = (esp_host_bus_t *)pvParameter;
     bus->state = BUS_INIT_START;
-    esp_host_ctx_t host_event = {
-        .event = HOST_EVENT_INPUT,
-    };
+
+    // RX chunks are SLIP-decoded as they arrive; only complete frames are forwarded.
+    slip_decoder_init(&slip, frame, HOST_BUS_BUF_SIZE);
 
     while (bus->state == BUS_INIT_START) {
         if (xQueueReceive(uart0_queue, (void *)&event, (TickType_t)portMAX_DELAY)) {
-            bzero(dtmp, HOST_BUS_BUF_SIZE);
             switch(event.type) {
-                case UART_DATA:
-                    // Pass, handled by the pattern detector.
+                case UART_DATA: {
+                    size_t pending = event.size;
+                    while (pending > 0) {
+                        const size_t want = pending < HOST_BUS_BUF_SIZE ? pending : HOST_BUS_BUF_SIZE;
+                        const int got = uart_read_bytes(CONFIG_HOST_BUS_UART_NUM, dtmp, want, 0);
+                        if (got <= 0) {
+                            break;
+                        }
+                        pending -= got;
+
+                        const uint8_t *p = dtmp;
+                        size_t left = (size_t)got;
+                        while (left > 0) {
+                            size_t frame_len = 0;
+                            const size_t used = slip_decoder_feed(&slip, p, left, &frame_len);
+                            p += used;
+                            left -= used;
+                            if (frame_len) {
+                                host_bus_deliver(bus, frame, frame_len);
+                            }
+                        }
+                    }
+                    if (slip.dropped) {
+                        ESP_LOGW(TAG, "frame too large, dropped %" PRIu32, slip.dropped);
+                        slip.dropped = 0;
+                    }
                     break;
+                }
                 case UART_FIFO_OVF:
                     ESP_LOGI(TAG, "hw fifo overflow");
                     uart_flush_input(CONFIG_HOST_BUS_UART_NUM);
                     xQueueReset(uart0_queue);
+                    slip_decoder_reset(&slip);
                     break;
                 case UART_BUFFER_FULL:
                     ESP_LOGI(TAG, "ring buffer full");
                     uart_flush_input(CONFIG_HOST_BUS_UART_NUM);
                     xQueueReset(uart0_queue);
+                    slip_decoder_reset(&slip);
                     break;
-                case UART_PATTERN_DET: {
-                    int pos;
-                    do {
-                        pos = uart_pattern_pop_pos(CONFIG_HOST_BUS_UART_NUM);
-                        if (pos > 0) {
-                            if (pos + 1 > HOST_BUS_BUF_SIZE) {
-                                ESP_LOGW(TAG, "frame too large: %d", pos + 1);
-                                uart_flush_input(CONFIG_HOST_BUS_UART_NUM);
-                                xQueueReset(uart0_queue);
-                                break;
-                            }
-
-                            host_event.size = uart_read_bytes(CONFIG_HOST_BUS_UART_NUM, dtmp, pos + 1, portMAX_DELAY);
-                            xStreamBufferSend(bus->input_buf, dtmp, host_event.size, 0);
-                            esp_host_send_event(&host_event);
-                            break; // one frame at a time
-                        }
-                    } while (pos >= 0);
-                    break;
-                }
                 default:
                     ESP_LOGI(TAG, "uart event type: %d", event.type);
                     break;
@@ -126,6 +142,8 @@ static void esp_host_bus_task(void *pvParameter)
         }
     }
 
+    free(frame);
+    frame = NULL;
     free(dtmp);
     dtmp = NULL;
     vTaskDelete(NULL);
@@ -171,6 +189,22 @@ esp_err_t esp_host_bus_output(const void *buffer, uint16_t len)
     }
 }
 
+uint8_t *esp_host_bus_frame_acquire(void)
+{
+    esp_host_bus_t *bus = s_host_bus;
+
+    if (!bus || !bus->frame_buf) {
+        return NULL;
+    }
+    xSemaphoreTake(bus->frame_sem, portMAX_DELAY);
+    return bus->frame_buf;
+}
+
+void esp_host_bus_frame_release(void)
+{
+    xSemaphoreGive(s_host_bus->frame_sem);
+}
+
 esp_err_t esp_host_bus_input(const void *buffer, uint16_t len)
 {
     return esp_host_frame_input(buffer, len);
@@ -205,6 +239,14 @@ esp_err_t esp_host_bus_init(esp_host_bus_t **bus)
         return ESP_ERR_NO_MEM;
     }
 
+    bus_handle->frame_buf = malloc(SLIP_ENCODED_MAX(HOST_BUS_FRAME_MAX_LEN));
+    bus_handle->frame_sem = xSemaphoreCreateMutex();
+    if (bus_handle->frame_buf == NULL || bus_handle->frame_sem == NULL) {
+        ESP_LOGE(TAG, "Frame buffer create error");
+        esp_host_bus_deinit(bus_handle);
+        return ESP_ERR_NO_MEM;
+    }
+
     bus_handle->init = host_bus_init_hdl;
     bus_handle->deinit = host_bus_deinit_hdl;
     bus_handle->read = host_bus_read_hdl;
@@ -271,6 +313,13 @@ esp_err_t esp_host_bus_deinit(esp_host_bus_t *bus)
         bus->input_sem = NULL;
     }
 
+    if (bus->frame_sem) {
+        vSemaphoreDelete(bus->frame_sem);
+        bus->frame_sem = NULL;
+    }
+    free(bus->frame_buf);
+    bus->frame_buf = NULL;
+
     free(bus);
     s_host_bus = NULL;
 
@@ -21,8 +21,8 @@ static const char* TAG = "ESP_ZNSP_FRAME";
 esp_err_t esp_host_frame_input(const void *buffer, uint16_t len)
 {
     esp_err_t ret = ESP_ERR_INVALID_ARG;
-    uint8_t *output = NULL;
-    uint16_t outlen = 0;
+    const uint8_t *output = (const uint8_t *)buffer;
+    uint16_t outlen = len;
 
     do {
         if (!buffer) {
@@ -30,14 +30,6 @@ esp_err_t esp_host_frame_input(const void *buffer, uint16_t len)
             break;
         }
 
-        /* SLIP */
-        slip_decode(buffer, len, &output, &outlen);
-        if (!output) {
-            ESP_LOGE(TAG, "SLIP characters must include");
-            ESP_LOG_BUFFER_HEX_LEVEL(TAG, buffer, len, ESP_LOG_ERROR);
-            break;
-        }
-
         /* Packet Length */
         uint16_t data_head_len = sizeof(esp_host_header_t);
         if (outlen < data_head_len) {
@@ -47,89 +39,91 @@ esp_err_t esp_host_frame_input(const void *buffer, uint16_t len)
             break;
         }
 
-        uint8_t offerset = 0;
+        uint16_t offerset = 0;
         while (offerset != outlen) {
             /* Packet Header */
-            esp_host_header_t *host_header = (esp_host_header_t *)(output + offerset);
+            esp_host_header_t host_header;
             uint8_t *payload = NULL;
 
-            if (host_header->len + data_head_len > outlen) {
-                ESP_LOGE(TAG, "Invalid packet len %d, expect %d", outlen, host_header->len + data_head_len);
+            if (outlen - offerset < data_head_len) {
+                ESP_LOGE(TAG, "Invalid packet len %d at offset %d", outlen, offerset);
+                ret = ESP_ERR_INVALID_SIZE;
+                break;
+            }
+            memcpy(&host_header, output + offerset, data_head_len);
+
+            if (offerset + data_head_len + host_header.len + sizeof(uint16_t) > outlen) {
+                ESP_LOGE(TAG, "Invalid packet len %d, expect %d", outlen, host_header.len + data_head_len);
                 ESP_LOG_BUFFER_HEX_LEVEL(TAG, output, outlen, ESP_LOG_ERROR);
                 ret = ESP_ERR_INVALID_SIZE;
                 break;
             }
 
             /* CheckSum */
-            uint16_t *checksum = (uint16_t *)(output + offerset + data_head_len + host_header->len);
-            uint16_t crc_val = esp_crc16_le(UINT16_MAX, output + offerset, data_head_len + host_header->len);
-            if (crc_val != (*checksum)) {
-                ESP_LOGE(TAG, "Invalid multiple checksum %02x, expect %02x", *checksum, crc_val);
-                ESP_LOG_BUFFER_HEX_LEVEL(TAG, output + offerset, (data_head_len + host_header->len + sizeof(uint16_t)), ESP_LOG_ERROR);
+            uint16_t checksum;
+            memcpy(&checksum, output + offerset + data_head_len + host_header.len, sizeof(checksum));
+            uint16_t crc_val = esp_crc16_le(UINT16_MAX, output + offerset, data_head_len + host_header.len);
+            if (crc_val != checksum) {
+                ESP_LOGE(TAG, "Invalid multiple checksum %02x, expect %02x", checksum, crc_val);
+                ESP_LOG_BUFFER_HEX_LEVEL(TAG, output + offerset, (data_head_len + host_header.len + sizeof(uint16_t)), ESP_LOG_ERROR);
                 ret = ESP_ERR_INVALID_CRC;
                 break;
             }
 
-            if (host_header->len != 0) {
+            if (host_header.len != 0) {
                 payload = (uint8_t *)output + offerset + data_head_len;
             }
 
-            ESP_LOG_BUFFER_HEX_LEVEL(TAG, output + offerset, (data_head_len + host_header->len + sizeof(uint16_t)), ESP_LOG_INFO);
+            ESP_LOG_BUFFER_HEX_LEVEL(TAG, output + offerset, (data_head_len + host_header.len + sizeof(uint16_t)), ESP_LOG_INFO);
 
             /* Packet Payload */
-            ret = esp_host_zb_input(host_header, payload, host_header->len);
+            ret = esp_host_zb_input(&host_header, payload, host_header.len);
 
-            offerset += (data_head_len + host_header->len + sizeof(uint16_t));
+            offerset += (data_head_len + host_header.len + sizeof(uint16_t));
         }
     } while(0);
 
-    if (output) {
-        free(output);
-        output = NULL;
-    }
-
     return ret;
 }
 
 esp_err_t esp_host_frame_output(esp_host_header_t *data_header, const void *buffer, uint16_t len)
 {
-    uint8_t *output = NULL;
-    uint16_t outlen = 0;
-
     uint16_t data_head_len = sizeof(esp_host_header_t);
-    uint16_t size = data_head_len + len + sizeof(uint16_t);
+    size_t size = data_head_len + (size_t)len + sizeof(uint16_t);
     esp_err_t ret = ESP_OK;
 
-    /* Alloc Data Buffer */
-    uint8_t *data = calloc(1, size);
-    if (data == NULL) {
-        ESP_LOGE(TAG, "Malloc data fail!");
-        return ESP_FAIL;
+    if (size > HOST_BUS_FRAME_MAX_LEN) {
+        ESP_LOGE(TAG, "Frame too long: id=%u size=%u max=%u", data_header->id, (unsigned)size, HOST_BUS_FRAME_MAX_LEN);
+        return ESP_ERR_INVALID_SIZE;
     }
 
-    /* Packet Header */
-    memcpy(data, data_header, data_head_len);
-
-    /* Packet Payload */
-    if (buffer && len) {
-        memcpy(data + data_head_len, buffer, len);
+    /* The bus's frame buffer: header, payload and checksum are escaped straight into it */
+    uint8_t *output = esp_host_bus_frame_acquire();
+    if (output == NULL) {
+        ESP_LOGE(TAG, "Bus not initialized");
+        return ESP_ERR_INVALID_STATE;
     }
 
     /* CheckSum */
-    uint16_t crc_val = esp_crc16_le(UINT16_MAX, data, data_head_len + len);
-    memcpy(data + data_head_len + len, &crc_val, sizeof(uint16_t));
+    uint16_t crc_val = esp_crc16_le(UINT16_MAX, (const uint8_t *)data_header, data_head_len);
+    if (buffer && len) {
+        crc_val = esp_crc16_le(crc_val, buffer, len);
+    }
 
     /* SLIP */
-    slip_encode(data, size, &output, &outlen);
-    free(data);
+    size_t outlen = 0;
+    output[outlen++] = SLIP_END;
+    outlen += slip_encode_chunk((const uint8_t *)data_header, data_head_len, output + outlen);
+    if (buffer && len) {
+        outlen += slip_encode_chunk(buffer, len, output + outlen);
+    }
+    outlen += slip_encode_chunk((const uint8_t *)&crc_val, sizeof(crc_val), output + outlen);
+    output[outlen++] = SLIP_END;
 
     /* Response */
-    ESP_LOGI(TAG, "TX id=%u sn=%u size=%u slip=%u", data_header->id, data_header->sn, size, outlen);
-    ret = esp_host_bus_output(output, outlen);
-    if (output) {
-        free(output);
-        output = NULL;
-    }
+    ESP_LOGI(TAG, "TX id=%u sn=%u size=%u slip=%u", data_header->id, data_header->sn, (unsigned)size, (unsigned)outlen);
+    ret = esp_host_bus_output(output, (uint16_t)outlen);
+    esp_host_bus_frame_release();
 
     return ret;
 }
@@ -12,15 +12,19 @@
 #include "esp_log.h"
 #include "esp_check.h"
 #include "esp_system.h"
-#include "esp_random.h"
 
 #include "esp_host_main.h"
 #include "esp_host_zb.h"
+#include "esp_host_zb_pending.h"
 
 #include "zb_config_platform.h"
 #include "esp_zigbee_core.h"
 #include "esp_zigbee_zcl_command.h"
 
+#define ESP_HOST_ZB_RESPONSE_TIMEOUT_MS     2000
+
+static const char* TAG = "ESP_ZNSP_ZB";
+
 typedef struct {
     esp_zb_ieee_addr_t  extendedPanId;                      /*!< The network's extended PAN identifier */
     uint16_t            panId;                              /*!< The network's PAN identifier */
@@ -38,9 +42,7 @@ typedef struct {
 } esp_host_zb_ctx_t;
 
 static esp_host_zb_network_t        s_host_zb_network;
-static QueueHandle_t                output_queue;           /*!< The queue handler for wait response */
 static QueueHandle_t                notify_queue;           /*!< The queue handler for wait notification */
-static SemaphoreHandle_t            lock_semaphore;
 
 static esp_err_t esp_host_zb_form_network_fn(const uint8_t *input, uint16_t inlen)
 {
@@ -184,7 +186,16 @@ static const esp_host_zb_func_t host_zb_func_table[] = {
 
 esp_err_t esp_host_zb_input(esp_host_header_t *host_header, const void *buffer, uint16_t len)
 {
-    QueueHandle_t queue = (host_header->flags.type == ESP_ZNSP_TYPE_NOTIFY) ? notify_queue : output_queue;
+    if (host_header->flags.type != ESP_ZNSP_TYPE_NOTIFY) {
+        /* Responses go straight to the request waiting on their sn. A miss is
+         * a reply that arrived after its request timed out; drop it.
+         */
+        if (esp_host_zb_pending_complete(host_header->sn, host_header->id, buffer, len) != ESP_OK) {
+            ESP_LOGW(TAG, "Unmatched response id=0x%04x sn=%u", host_header->id, host_header->sn);
+        }
+        return ESP_OK;
+    }
+
     BaseType_t ret = 0;
     esp_host_zb_ctx_t host_ctx = {
         .id = host_header->id,
@@ -197,18 +208,24 @@ esp_err_t esp_host_zb_input(esp_host_header_t *host_header, const void *buffer,
     }
 
     if (xPortInIsrContext() == pdTRUE) {
-        ret = xQueueSendFromISR(queue, &host_ctx, NULL);
+        ret = xQueueSendFromISR(notify_queue, &host_ctx, NULL);
     } else {
-        ret = xQueueSend(queue, &host_ctx, 0);
+        ret = xQueueSend(notify_queue, &host_ctx, 0);
     }
     return (ret == pdTRUE) ? ESP_OK : ESP_FAIL ;
 }
 
-esp_err_t esp_host_zb_output(uint16_t id, const void *buffer, uint16_t len, void *output, uint16_t *outlen)
+esp_err_t esp_host_zb_request_send(uint16_t id, const void *buffer, uint16_t len, void *output, uint16_t *outlen, esp_host_zb_req_t **req)
 {
+    esp_host_zb_req_t *pending = NULL;
+    esp_err_t ret = esp_host_zb_pending_begin(id, output, outlen, pdMS_TO_TICKS(ESP_HOST_ZB_RESPONSE_TIMEOUT_MS), &pending);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
     esp_host_header_t data_header = {
         .id = id,
-        .sn = esp_random() % 0xFF,
+        .sn = esp_host_zb_pending_sn(pending),
         .len = len,
         .flags = {
             .version = 0,
@@ -216,34 +233,40 @@ esp_err_t esp_host_zb_output(uint16_t id, const void *buffer, uint16_t len, void
     };
     data_header.flags.type = ESP_ZNSP_TYPE_REQUEST;
 
-    xSemaphoreTakeRecursive(lock_semaphore, portMAX_DELAY);
-    esp_host_frame_output(&data_header, buffer, len);
-
-    esp_err_t ret = ESP_OK;
-    esp_host_zb_ctx_t host_ctx = {0};
-    if (xQueueReceive(output_queue, &host_ctx, pdMS_TO_TICKS(2000)) != pdTRUE) {
-        xSemaphoreGiveRecursive(lock_semaphore);
-        return ESP_ERR_TIMEOUT;
+    /* The slot is registered before the frame goes out, so even an
+     * immediate response finds it.
+     */
+    ret = esp_host_frame_output(&data_header, buffer, len);
+    if (ret != ESP_OK) {
+        (void)esp_host_zb_pending_wait(pending, 0);
+        return ret;
     }
-    if (host_ctx.data) {
-        if ((host_ctx.id == id)) {
-            if (output) {
-                memcpy(output, host_ctx.data, host_ctx.size);
-            }
 
-            if (outlen) {
-                *outlen = host_ctx.size;
-            }
-        } else {
-            ret = ESP_FAIL;
-        }
+    *req = pending;
+    return ESP_OK;
+}
 
-        free(host_ctx.data);
-        host_ctx.data = NULL;
+esp_err_t esp_host_zb_request_wait(esp_host_zb_req_t *req, uint32_t timeout_ms)
+{
+    if (!req) {
+        return ESP_ERR_INVALID_ARG;
     }
-    xSemaphoreGiveRecursive(lock_semaphore);
+    return esp_host_zb_pending_wait(req, pdMS_TO_TICKS(timeout_ms));
+}
 
-    return ret;
+esp_err_t esp_host_zb_output(uint16_t id, const void *buffer, uint16_t len, void *output, uint16_t *outlen)
+{
+    esp_host_zb_req_t *req = NULL;
+    esp_err_t ret = esp_host_zb_request_send(id, buffer, len, output, outlen, &req);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return esp_host_zb_request_wait(req, ESP_HOST_ZB_RESPONSE_TIMEOUT_MS);
+}
+
+void esp_host_zb_get_pending_stats(esp_host_zb_pending_stats_t *out)
+{
+    esp_host_zb_pending_get_stats(out);
 }
 
 void *esp_zb_app_signal_get_params(uint32_t *signal_p)
@@ -290,12 +313,11 @@ esp_err_t esp_zb_device_register(esp_zb_ep_list_t *ep_list)
 
 esp_err_t esp_zb_platform_config(esp_zb_platform_config_t *config)
 {
+    ESP_ERROR_CHECK(esp_host_zb_pending_init());
     ESP_ERROR_CHECK(esp_host_init(config->host_config.host_mode));
     ESP_ERROR_CHECK(esp_host_start());
 
-    output_queue = xQueueCreate(HOST_EVENT_QUEUE_LEN, sizeof(esp_host_zb_ctx_t));
     notify_queue = xQueueCreate(HOST_EVENT_QUEUE_LEN, sizeof(esp_host_zb_ctx_t));
-    lock_semaphore = xSemaphoreCreateRecursiveMutex();
 
     return ESP_OK;
 }
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_host_zb_pending.h"
+
+typedef enum {
+    REQ_FREE = 0,
+    REQ_WAITING,                                            /*!< Sent, no response yet */
+    REQ_COMPLETING,                                         /*!< Response is being copied to the caller */
+    REQ_DONE,                                               /*!< Response copied, `done` given */
+    REQ_ABANDONED,                                          /*!< Waiter timed out */
+} req_state_t;
+
+struct esp_host_zb_req {
+    req_state_t         state;
+    uint8_t             sn;
+    uint16_t            id;
+    void                *output;
+    uint16_t            *outlen;
+    esp_err_t           status;
+    SemaphoreHandle_t   done;
+    StaticSemaphore_t   done_buf;
+};
+
+static struct esp_host_zb_req   s_reqs[ESP_HOST_ZB_PENDING_MAX];
+static portMUX_TYPE             s_lock = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t        s_slots;                    /*!< Counts free entries of s_reqs */
+static StaticSemaphore_t        s_slots_buf;
+static uint8_t                  s_next_sn;
+static esp_host_zb_pending_stats_t s_stats;
+
+esp_err_t esp_host_zb_pending_init(void)
+{
+    if (s_slots) {
+        return ESP_OK;
+    }
+
+    for (size_t i = 0; i < ESP_HOST_ZB_PENDING_MAX; i++) {
+        s_reqs[i].done = xSemaphoreCreateBinaryStatic(&s_reqs[i].done_buf);
+    }
+    s_slots = xSemaphoreCreateCountingStatic(ESP_HOST_ZB_PENDING_MAX, ESP_HOST_ZB_PENDING_MAX, &s_slots_buf);
+
+    return s_slots ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/* Caller holds s_lock. */
+static bool sn_in_use(uint8_t sn)
+{
+    for (size_t i = 0; i < ESP_HOST_ZB_PENDING_MAX; i++) {
+        if (s_reqs[i].state != REQ_FREE && s_reqs[i].sn == sn) {
+            return true;
+        }
+    }
+    return false;
+}
+
+esp_err_t esp_host_zb_pending_begin(uint16_t id, void *output, uint16_t *outlen, TickType_t timeout, esp_host_zb_req_t **req)
+{
+    if (!s_slots || !req) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(s_slots, timeout) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_host_zb_req_t *r = NULL;
+    taskENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < ESP_HOST_ZB_PENDING_MAX; i++) {
+        if (s_reqs[i].state == REQ_FREE) {
+            r = &s_reqs[i];
+            break;
+        }
+    }
+    /* the counting semaphore guarantees a free slot; sn wraps at 8 bits, so
+     * skip any value still held by a slow request
+     */
+    do {
+        r->sn = s_next_sn++;
+    } while (sn_in_use(r->sn));
+    r->state = REQ_WAITING;
+    r->id = id;
+    r->output = output;
+    r->outlen = outlen;
+    r->status = ESP_ERR_TIMEOUT;
+    s_stats.sent++;
+    s_stats.inflight++;
+    if (s_stats.inflight > s_stats.inflight_max) {
+        s_stats.inflight_max = s_stats.inflight;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    *req = r;
+    return ESP_OK;
+}
+
+uint8_t esp_host_zb_pending_sn(const esp_host_zb_req_t *req)
+{
+    return req->sn;
+}
+
+esp_err_t esp_host_zb_pending_wait(esp_host_zb_req_t *req, TickType_t timeout)
+{
+    if (xSemaphoreTake(req->done, timeout) != pdTRUE) {
+        bool completing;
+
+        taskENTER_CRITICAL(&s_lock);
+        completing = (req->state != REQ_WAITING);
+        if (!completing) {
+            req->state = REQ_ABANDONED;
+            s_stats.timeouts++;
+        }
+        taskEXIT_CRITICAL(&s_lock);
+
+        /* a response raced the timeout and is being copied into our
+         * buffer: it is about to give `done`, so wait for it
+         */
+        if (completing) {
+            xSemaphoreTake(req->done, portMAX_DELAY);
+        }
+    }
+
+    const esp_err_t ret = req->status;
+
+    taskENTER_CRITICAL(&s_lock);
+    req->state = REQ_FREE;
+    s_stats.inflight--;
+    taskEXIT_CRITICAL(&s_lock);
+    xSemaphoreGive(s_slots);
+
+    return ret;
+}
+
+esp_err_t esp_host_zb_pending_complete(uint8_t sn, uint16_t id, const void *data, uint16_t len)
+{
+    esp_host_zb_req_t *r = NULL;
+
+    taskENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < ESP_HOST_ZB_PENDING_MAX; i++) {
+        if (s_reqs[i].state == REQ_WAITING && s_reqs[i].sn == sn) {
+            r = &s_reqs[i];
+            r->state = REQ_COMPLETING;
+            break;
+        }
+    }
+    if (!r) {
+        s_stats.unmatched++;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    if (!r) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (r->id != id) {
+        r->status = ESP_FAIL;
+    } else {
+        if (data) {
+            if (r->output) {
+                memcpy(r->output, data, len);
+            }
+            if (r->outlen) {
+                *r->outlen = len;
+            }
+        }
+        r->status = ESP_OK;
+    }
+
+    taskENTER_CRITICAL(&s_lock);
+    r->state = REQ_DONE;
+    s_stats.completed++;
+    taskEXIT_CRITICAL(&s_lock);
+    xSemaphoreGive(r->done);
+
+    return ESP_OK;
+}
+
+void esp_host_zb_pending_get_stats(esp_host_zb_pending_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    taskEXIT_CRITICAL(&s_lock);
+}
@@ -32,6 +32,7 @@ typedef enum {
 #define HOST_BUS_TASK_STACK              4096
 #define HOST_BUS_TASK_PRIORITY           18
 #define HOST_BUS_BUF_SIZE                1024
+#define HOST_BUS_FRAME_MAX_LEN           HOST_BUS_BUF_SIZE  /* largest decoded frame (header, payload, CRC), as on RX */
 
 /**
  * @brief A function for bus initialize.
@@ -89,6 +90,8 @@ typedef struct {
     void *input_buf;                    /*!< The pointer to storage the data from HOST */
     void *output_buf;                   /*!< The pointer to storage the data to HOST */
     SemaphoreHandle_t input_sem;        /*!< A semaphore handle for process the data from HOST */
+    uint8_t *frame_buf;                 /*!< SLIP encoding of one outgoing frame, reused for every frame */
+    SemaphoreHandle_t frame_sem;        /*!< A semaphore handle guarding frame_buf */
 } esp_host_bus_t;
 
 /** 
@@ -115,6 +118,20 @@ esp_err_t esp_host_bus_input(const void *buffer, uint16_t len);
  */
 esp_err_t esp_host_bus_output(const void *buffer, uint16_t len);
 
+/**
+ * @brief  Take the outgoing frame buffer; release it with @ref esp_host_bus_frame_release.
+ *
+ * The buffer holds SLIP_ENCODED_MAX(HOST_BUS_FRAME_MAX_LEN) bytes.
+ *
+ * @return The buffer, or NULL if the bus is not initialized
+ */
+uint8_t *esp_host_bus_frame_acquire(void);
+
+/**
+ * @brief  Give back the buffer taken with @ref esp_host_bus_frame_acquire.
+ */
+void esp_host_bus_frame_release(void);
+
 /** 
  * @brief  Initialize HOST bus.
  * 
@@ -28,10 +28,10 @@ typedef struct {
 } __attribute__((packed)) esp_host_header_t;
 
 /** 
- * @brief  Output to host.
+ * @brief  Process frames received from the NCP.
  * 
- * @param[in] buffer The output buffer pointer
- * @param[in] len    The output buffer length
+ * @param[in] buffer The SLIP-decoded frame pointer (the bus task strips SLIP framing)
+ * @param[in] len    The decoded frame length
  * 
  * @return
  *    - ESP_OK: succeed
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#include "esp_host_zb_api.h"
+
+/**
+ * Pending ZNSP request table.
+ *
+ * Every request gets a slot and a sequence number (`sn`) unique among the
+ * requests in flight; the NCP echoes `sn` in its response, which is matched
+ * back to the slot and copied straight into the caller's output buffer.
+ * Up to ESP_HOST_ZB_PENDING_MAX requests may be outstanding at once, from any
+ * number of tasks; each completes or times out on its own.
+ */
+#define ESP_HOST_ZB_PENDING_MAX     8
+
+/**
+ * @brief   Create the table's synchronization objects. Safe to call twice.
+ *
+ * @return
+ *    - ESP_OK: succeed
+ *    - others: refer to esp_err.h
+ */
+esp_err_t esp_host_zb_pending_init(void);
+
+/**
+ * @brief   Reserve a slot for a request and assign its sequence number.
+ *
+ * @param[in]  id      The frame ID of the request (the response must match it)
+ * @param[out] output  Where the response payload is copied, may be NULL
+ * @param[out] outlen  Where the response payload length is stored, may be NULL
+ * @param[in]  timeout How long to wait for a free slot
+ * @param[out] req     The reserved request
+ *
+ * @return
+ *    - ESP_OK: succeed
+ *    - ESP_ERR_TIMEOUT: all slots stayed busy for @p timeout
+ */
+esp_err_t esp_host_zb_pending_begin(uint16_t id, void *output, uint16_t *outlen, TickType_t timeout, esp_host_zb_req_t **req);
+
+/**
+ * @brief   The sequence number to put in the request header.
+ */
+uint8_t esp_host_zb_pending_sn(const esp_host_zb_req_t *req);
+
+/**
+ * @brief   Wait for the response and release the slot.
+ *
+ * Always releases @p req, also on timeout; a response that arrives later is
+ * dropped as unmatched.
+ *
+ * @return
+ *    - ESP_OK: the response was copied to the request's output
+ *    - ESP_ERR_TIMEOUT: no response within @p timeout
+ *    - ESP_FAIL: a response with this sn carried a different frame ID
+ */
+esp_err_t esp_host_zb_pending_wait(esp_host_zb_req_t *req, TickType_t timeout);
+
+/**
+ * @brief   Deliver a response from the NCP to the request waiting on @p sn.
+ *
+ * @return
+ *    - ESP_OK: a waiting request took the response
+ *    - ESP_ERR_NOT_FOUND: no request is waiting on @p sn (late or duplicate response)
+ */
+esp_err_t esp_host_zb_pending_complete(uint8_t sn, uint16_t id, const void *data, uint16_t len);
+
+/**
+ * @brief   Snapshot of the table counters.
+ */
+void esp_host_zb_pending_get_stats(esp_host_zb_pending_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
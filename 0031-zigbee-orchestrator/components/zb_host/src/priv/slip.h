@@ -5,45 +5,123 @@
  */
 
 #pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /** Definition SLIP special character codes
- * 
+ *
  */
 #define SLIP_END                0xC0 /* 0300: start and end of every packet */
 #define SLIP_ESC                0xDB /* 0333: escape start (one byte escaped data follows) */
 #define SLIP_ESC_END            0xDC /* 0334: following escape: original byte is 0xC0 (END) */
 #define SLIP_ESC_ESC            0xDD /* 0335: following escape: original byte is 0xDB (ESC) */
 
+/** Worst-case encoded size of a packet of @p len bytes: every byte escaped, plus leading and trailing END. */
+#define SLIP_ENCODED_MAX(len)   (2 * (size_t)(len) + 2)
+
+/**
+ * @brief Incremental SLIP decoder state.
+ *
+ * Decodes into a caller-provided buffer; bytes may arrive in arbitrary chunks
+ * (an escape sequence may straddle two chunks). Empty packets (back-to-back END
+ * bytes used as line-noise flushes) are ignored. A packet longer than the buffer
+ * is discarded up to the next END and counted in @c dropped.
+ */
+typedef struct {
+    uint8_t *buf;       /*!< Output buffer for the packet being decoded */
+    size_t   cap;       /*!< Capacity of @c buf */
+    size_t   len;       /*!< Bytes of the current packet decoded so far */
+    bool     esc;       /*!< Previous byte was SLIP_ESC */
+    bool     overflow;  /*!< Current packet exceeded @c cap, skipping to END */
+    uint32_t dropped;   /*!< Packets discarded because of overflow */
+} slip_decoder_t;
+
+/**
+ * @brief   Initialize a decoder over a caller-provided buffer.
+ *
+ * @param[out] dec  The decoder state
+ * @param[in]  buf  The buffer decoded packets are written to
+ * @param[in]  cap  The capacity of @p buf (largest accepted packet)
+ */
+void slip_decoder_init(slip_decoder_t *dec, uint8_t *buf, size_t cap);
+
+/**
+ * @brief   Discard any partially decoded packet (e.g. after a UART overflow).
+ *
+ * @param[in] dec  The decoder state
+ */
+void slip_decoder_reset(slip_decoder_t *dec);
+
+/**
+ * @brief   Feed encoded bytes to the decoder, stopping after the first complete packet.
+ *
+ * When a packet completes, @p pkt_len is set to its length and the packet is in
+ * @c dec->buf until the next call. Call again with the remaining bytes to
+ * continue.
+ *
+ * @param[in]  dec      The decoder state
+ * @param[in]  inbuf    The encoded bytes
+ * @param[in]  inlen    The number of encoded bytes
+ * @param[out] pkt_len  The completed packet length, or 0 if no packet completed
+ *
+ * @return The number of bytes of @p inbuf consumed
+ */
+size_t slip_decoder_feed(slip_decoder_t *dec, const uint8_t *inbuf, size_t inlen, size_t *pkt_len);
+
 /**
- * @brief   Encode a packet into the buffer located at "inbuf".
+ * @brief   Encode a packet into the buffer located at "outbuf".
+ *
+ * The output is framed with a leading and a trailing SLIP_END.
  *
  * @param[in]   inbuf  The pointer to store a packet data
  * @param[in]   inlen  The length of a packet data
- * @param[out]  outbuf The pointer to store an encode packet data
+ * @param[out]  outbuf The buffer the encoded packet is written to
+ * @param[in]   outcap The capacity of @p outbuf; SLIP_ENCODED_MAX(inlen) always fits
  * @param[out]  outlen The length of an encode packet data
  *
  * @return
  *    - ESP_OK: succeed
- *    - others: refer to esp_err.h
+ *    - ESP_ERR_INVALID_SIZE: @p outbuf is too small
+ */
+esp_err_t slip_encode(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf, size_t outcap, size_t *outlen);
+
+/**
+ * @brief   Escape a piece of a packet without framing it.
+ *
+ * Used to encode a packet from several buffers; the caller writes the
+ * surrounding SLIP_END bytes.
+ *
+ * @param[in]   inbuf  The bytes to escape
+ * @param[in]   inlen  The number of bytes to escape
+ * @param[out]  outbuf The output, at least 2 * @p inlen bytes
+ *
+ * @return The number of bytes written to @p outbuf
  */
-esp_err_t slip_encode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen);
+size_t slip_encode_chunk(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf);
 
 /**
- * @brief   Decode a packet into the buffer located at "inbuf".
+ * @brief   Decode the first packet of "inbuf" into "outbuf".
  *
  * @param[in]   inbuf  The pointer to store an encode packet data
  * @param[in]   inlen  The length of an encode packet data
- * @param[out]  outbuf The pointer to store a decode packet data
+ * @param[out]  outbuf The buffer the decoded packet is written to
+ * @param[in]   outcap The capacity of @p outbuf; @p inlen always fits
  * @param[out]  outlen The length of a decode packet data
  *
  * @return
  *    - ESP_OK: succeed
- *    - others: refer to esp_err.h
+ *    - ESP_ERR_NOT_FOUND: no complete packet in @p inbuf
+ *    - ESP_ERR_INVALID_SIZE: the packet does not fit in @p outbuf
  */
-esp_err_t slip_decode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen);
+esp_err_t slip_decode(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf, size_t outcap, size_t *outlen);
 
 #ifdef __cplusplus
 }
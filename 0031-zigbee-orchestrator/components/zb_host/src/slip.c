@@ -5,157 +5,191 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include <esp_err.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "freertos/task.h"
-#include "freertos/stream_buffer.h"
 
 #include "slip.h"
 
+static inline bool slip_is_special(uint8_t c)
+{
+    return c == SLIP_END || c == SLIP_ESC;
+}
+
+size_t slip_encode_chunk(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf)
+{
+    uint8_t *out = outbuf;
+    size_t i = 0;
+
+    while (i < inlen) {
+        /* copy the run of ordinary bytes in one go
+         */
+        size_t run = i;
+        while (run < inlen && !slip_is_special(inbuf[run])) {
+            run++;
+        }
+        if (run > i) {
+            memcpy(out, inbuf + i, run - i);
+            out += run - i;
+            i = run;
+            if (i == inlen) {
+                break;
+            }
+        }
+
+        /* END and ESC are sent as a two character code so the
+         * receiver doesn't mistake them for framing
+         */
+        *out++ = SLIP_ESC;
+        *out++ = (inbuf[i] == SLIP_END) ? SLIP_ESC_END : SLIP_ESC_ESC;
+        i++;
+    }
+
+    return (size_t)(out - outbuf);
+}
+
 /* Encode: encode a packet of length "inlen", starting at location "inbuf".
  */
-esp_err_t slip_encode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen)
+esp_err_t slip_encode(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf, size_t outcap, size_t *outlen)
 {
+    size_t need = inlen + 2;
+
+    if (outcap < SLIP_ENCODED_MAX(inlen)) {
+        /* only pay for the exact size check when the caller didn't size
+         * for the worst case
+         */
+        for (size_t i = 0; i < inlen; i++) {
+            need += slip_is_special(inbuf[i]);
+        }
+        if (outcap < need) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
     /* send an initial END character to flush out any data that may
      * have accumulated in the receiver due to line noise
      */
-    char c = SLIP_END;
-    size_t buffer_size = (size_t)inlen * 2;
-    if (buffer_size == 0) {
-        buffer_size = 1;
+    outbuf[0] = SLIP_END;
+    size_t n = 1 + slip_encode_chunk(inbuf, inlen, outbuf + 1);
+    outbuf[n++] = SLIP_END;
+    *outlen = n;
+
+    return ESP_OK;
+}
+
+void slip_decoder_init(slip_decoder_t *dec, uint8_t *buf, size_t cap)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->buf = buf;
+    dec->cap = cap;
+}
+
+void slip_decoder_reset(slip_decoder_t *dec)
+{
+    dec->len = 0;
+    dec->esc = false;
+    dec->overflow = false;
+}
+
+static inline void slip_decoder_put(slip_decoder_t *dec, uint8_t c)
+{
+    if (dec->overflow) {
+        return;
+    }
+    if (dec->len < dec->cap) {
+        dec->buf[dec->len++] = c;
+    } else {
+        dec->overflow = true;
     }
-    const size_t trigger_level = buffer_size < 8 ? buffer_size : 8;
-    StreamBufferHandle_t stream_buffer = xStreamBufferCreate(buffer_size, trigger_level);
-    xStreamBufferSend(stream_buffer, &c, 1, 0);
-
-	/* for each byte in the packet, send the appropriate character
-	 * sequence
-	 */
-	while (inlen --) {
-		switch (*inbuf) {
-            /* if it's the same code as an END character, we send a
-             * special two character code so as not to make the
-             * receiver think we sent an END
+}
+
+size_t slip_decoder_feed(slip_decoder_t *dec, const uint8_t *inbuf, size_t inlen, size_t *pkt_len)
+{
+    size_t i = 0;
+
+    *pkt_len = 0;
+    while (i < inlen) {
+        uint8_t c = inbuf[i];
+
+        if (dec->esc) {
+            /* if "c" is not one of these two, then we have a protocol
+             * violation. The best bet seems to be to leave the byte
+             * alone and just stuff it into the packet
              */
-            case SLIP_END:
+            dec->esc = false;
+            if (c == SLIP_ESC_END) {
+                c = SLIP_END;
+            } else if (c == SLIP_ESC_ESC) {
                 c = SLIP_ESC;
-                xStreamBufferSend(stream_buffer, &c, 1, 0);
-                c = SLIP_ESC_END;
-                xStreamBufferSend(stream_buffer, &c, 1, 0);
-                break;
+            }
+            slip_decoder_put(dec, c);
+            i++;
+            continue;
+        }
 
-			/* if it's the same code as an ESC character,
-			 * we send a special two character code so as not
-			 * to make the receiver think we sent an ESC
-			 */
-            case SLIP_ESC:
-                c = SLIP_ESC;
-                xStreamBufferSend(stream_buffer, &c, 1, 0);
-                c = SLIP_ESC_ESC;
-                xStreamBufferSend(stream_buffer, &c, 1, 0);
-                break;
-                
-            /* otherwise, we just send the character
+        if (c == SLIP_END) {
+            i++;
+            if (dec->overflow) {
+                dec->dropped++;
+                slip_decoder_reset(dec);
+                continue;
+            }
+            /* empty packets come from the duplicate END characters
+             * sent to flush line noise; ignore them
              */
-            default:
-                xStreamBufferSend(stream_buffer, inbuf, 1, 0);
-                break;
-		}
-		inbuf ++;
-	}
+            if (dec->len) {
+                *pkt_len = dec->len;
+                dec->len = 0;
+                return i;
+            }
+            continue;
+        }
 
-    /* tell the receiver that we're done sending the packet
-     */
-    c = SLIP_END;
-    xStreamBufferSend(stream_buffer, &c, 1, 0);
+        if (c == SLIP_ESC) {
+            dec->esc = true;
+            i++;
+            continue;
+        }
 
-    *outlen = xStreamBufferBytesAvailable(stream_buffer);
-    if (*outlen) {
-        *outbuf = calloc(1, *outlen + 1);
-        xStreamBufferReceive(stream_buffer, *outbuf, *outlen, 100 / portTICK_PERIOD_MS);
+        /* copy the run of ordinary bytes in one go
+         */
+        size_t run = i + 1;
+        while (run < inlen && !slip_is_special(inbuf[run])) {
+            run++;
+        }
+        size_t n = run - i;
+        if (!dec->overflow) {
+            if (n > dec->cap - dec->len) {
+                dec->overflow = true;
+            } else {
+                memcpy(dec->buf + dec->len, inbuf + i, n);
+                dec->len += n;
+            }
+        }
+        i = run;
     }
 
-    vStreamBufferDelete(stream_buffer);
-
-    return ESP_OK;
+    return i;
 }
 
-/* Decode: decode a packet into the buffer located at "inbuf".
- * If more than inlen bytes are received, the packet will be truncated.
- * Returns the number of bytes stored in the buffer.
+/* Decode: decode the first packet of "inbuf" into "outbuf".
  */
-esp_err_t slip_decode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen)
+esp_err_t slip_decode(const uint8_t *inbuf, size_t inlen, uint8_t *outbuf, size_t outcap, size_t *outlen)
 {
-    char c = SLIP_END;
-    uint16_t received = 0;
-    uint8_t *output = calloc(1, inlen * 2);
-
-    const size_t buffer_size = inlen ? inlen : 1;
-    const size_t trigger_level = buffer_size < 8 ? buffer_size : 8;
-    StreamBufferHandle_t stream_buffer = xStreamBufferCreate(buffer_size, trigger_level);
-    xStreamBufferSend(stream_buffer, inbuf, inlen, 0);
-
-    while (1) {
-        xStreamBufferReceive(stream_buffer, &c, 1, 100 / portTICK_PERIOD_MS);
-        switch(c) {
-            /* if it's an END character then we're done with
-            * the packet
-            */
-            case SLIP_END:
-                /* a minor optimization: if there is no
-                * data in the packet, ignore it. This is
-                * meant to avoid bothering IP with all
-                * the empty packets generated by the
-                * duplicate END characters which are in
-                * turn sent to try to detect line noise.
-                */
-                if (!xStreamBufferBytesAvailable(stream_buffer)) {
-                    goto slip_finish;
-                }
-                break;
-
-            /* if it's the same code as an ESC character, wait
-            * and get another character and then figure out
-            * what to store in the packet based on that.
-            */
-            case SLIP_ESC:
-                xStreamBufferReceive(stream_buffer, &c, 1, 100 / portTICK_PERIOD_MS);
-
-                /* if "c" is not one of these two, then we
-                * have a protocol violation.  The best bet
-                * seems to be to leave the byte alone and
-                * just stuff it into the packet
-                */
-                switch(c) {
-                    case SLIP_ESC_END:
-                        c = SLIP_END;
-                        break;
-                    case SLIP_ESC_ESC:
-                        c = SLIP_ESC;
-                        break;
-                    default:
-                        break;
-                }
-                output[received ++] = c;
-                break;
-            /* here we fall into the default handler and let
-            * it store the character for us
-            */
-            default:
-                if (!xStreamBufferBytesAvailable(stream_buffer)) {
-                    goto slip_finish;
-                }
-                output[received ++] = c;
-                break;
+    slip_decoder_t dec;
+    size_t pkt_len = 0;
+
+    slip_decoder_init(&dec, outbuf, outcap);
+    while (inlen) {
+        size_t used = slip_decoder_feed(&dec, inbuf, inlen, &pkt_len);
+        inbuf += used;
+        inlen -= used;
+        if (pkt_len) {
+            *outlen = pkt_len;
+            return ESP_OK;
         }
     }
 
-slip_finish:
-    vStreamBufferDelete(stream_buffer);
-    *outbuf = output;
-    *outlen = received;
-
-    return ESP_OK;
+    *outlen = 0;
+    return (dec.dropped || dec.overflow) ? ESP_ERR_INVALID_SIZE : ESP_ERR_NOT_FOUND;
 }
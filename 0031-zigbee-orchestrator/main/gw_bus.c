@@ -61,6 +61,11 @@ static void on_cmd_onoff(void *arg, esp_event_base_t base, int32_t id, void *dat
         return;
     }
 
+    // The registry only knows devices announced since boot, so an unknown address is still tried.
+    if (!gw_registry_get_by_short(cmd->short_addr, NULL)) {
+        ESP_LOGW(TAG, "onoff: short=0x%04x not in registry req_id=%" PRIu64, (unsigned)cmd->short_addr, cmd->req_id);
+    }
+
     const esp_err_t err = gw_zb_request_onoff(cmd->short_addr, cmd->dst_ep, cmd->cmd_id, cmd->req_id, 0);
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "onoff enqueue failed: %s req_id=%" PRIu64, esp_err_to_name(err), cmd->req_id);
@@ -79,6 +84,15 @@ static void on_evt_zb_device_annce(void *arg, esp_event_base_t base, int32_t id,
     gw_registry_on_device_announce(ev);
 }
 
+static void on_evt_zb_device_leave(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    (void)arg;
+    (void)base;
+    (void)id;
+    const gw_evt_zb_device_leave_t *ev = (const gw_evt_zb_device_leave_t *)data;
+    if (!ev) return;
+    gw_registry_on_device_leave(ev);
+}
+
 static void on_any_event_monitor(void *arg, esp_event_base_t base, int32_t id, void *data) {
     (void)arg;
     (void)base;
@@ -144,6 +158,21 @@ static void on_any_event_monitor(void *arg, esp_event_base_t base, int32_t id, v
                ev->ieee_addr[1],
                ev->ieee_addr[0],
                (unsigned)ev->capability);
+    } else if (id == GW_EVT_ZB_DEVICE_LEAVE && data) {
+        const gw_evt_zb_device_leave_t *ev = (const gw_evt_zb_device_leave_t *)data;
+        printf("[gw] %s (%" PRIi32 ") short=0x%04x ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x rejoin=%u\n",
+               name,
+               id,
+               (unsigned)ev->short_addr,
+               ev->ieee_addr[7],
+               ev->ieee_addr[6],
+               ev->ieee_addr[5],
+               ev->ieee_addr[4],
+               ev->ieee_addr[3],
+               ev->ieee_addr[2],
+               ev->ieee_addr[1],
+               ev->ieee_addr[0],
+               (unsigned)ev->rejoin);
     } else {
         printf("[gw] %s (%" PRIi32 ")\n", name, id);
     }
@@ -160,7 +189,10 @@ esp_err_t gw_bus_start(void) {
         .task_core_id = 0,
     };
 
-    esp_err_t err = esp_event_loop_create(&args, &s_loop);
+    esp_err_t err = gw_registry_init();
+    if (err != ESP_OK) return err;
+
+    err = esp_event_loop_create(&args, &s_loop);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "esp_event_loop_create failed: %s", esp_err_to_name(err));
         return err;
@@ -169,6 +201,7 @@ esp_err_t gw_bus_start(void) {
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, GW_EVT, GW_CMD_PERMIT_JOIN, &on_cmd_permit_join, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, GW_EVT, GW_CMD_ONOFF, &on_cmd_onoff, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, GW_EVT, GW_EVT_ZB_DEVICE_ANNCE, &on_evt_zb_device_annce, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, GW_EVT, GW_EVT_ZB_DEVICE_LEAVE, &on_evt_zb_device_leave, NULL));
     ESP_ERROR_CHECK(esp_event_handler_register_with(s_loop, GW_EVT, ESP_EVENT_ANY_ID, &on_any_event_monitor, NULL));
 
     ESP_LOGI(TAG, "gw bus started (queue=%d)", CONFIG_GW_EVENT_QUEUE_SIZE);
@@ -225,6 +258,8 @@ const char *gw_event_id_to_str(int32_t id) {
             return "GW_EVT_ZB_PERMIT_JOIN_STATUS";
         case GW_EVT_ZB_DEVICE_ANNCE:
             return "GW_EVT_ZB_DEVICE_ANNCE";
+        case GW_EVT_ZB_DEVICE_LEAVE:
+            return "GW_EVT_ZB_DEVICE_LEAVE";
         default:
             return "GW_EVT_UNKNOWN";
     }
@@ -7,6 +7,7 @@
 #include "esp_console.h"
 #include "esp_err.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -21,6 +22,7 @@ static void print_usage_gw(void) {
     printf("gw commands:\n");
     printf("  gw status\n");
     printf("  gw devices\n");
+    printf("  gw device <short_addr|ieee>   (ieee as printed by gw devices, aa:bb:...)\n");
     printf("  gw post permit_join <seconds> [req_id]   (seconds=0 closes)\n");
     printf("  gw post onoff <short_addr> <ep> <on|off|toggle> [req_id]\n");
     printf("  gw demo start|stop\n");
@@ -71,6 +73,32 @@ static bool parse_u8_hex(const char *s, uint8_t *out) {
     return true;
 }
 
+// IEEE address as printed (most significant byte first) into the little-endian wire order.
+static bool parse_ieee(const char *s, uint8_t out[8]) {
+    unsigned b[8];
+    char tail = 0;
+    const int n = sscanf(s, "%2x:%2x:%2x:%2x:%2x:%2x:%2x:%2x%c", &b[7], &b[6], &b[5], &b[4], &b[3], &b[2], &b[1], &b[0], &tail);
+    if (n != 8) return false;
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)b[i];
+    return true;
+}
+
+static void print_registry_device(const gw_registry_device_t *d, int64_t now_us) {
+    printf("  short=0x%04x ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x cap=0x%02x seen=%u last=%" PRIi64 "s ago\n",
+           (unsigned)d->short_addr,
+           d->ieee_addr[7],
+           d->ieee_addr[6],
+           d->ieee_addr[5],
+           d->ieee_addr[4],
+           d->ieee_addr[3],
+           d->ieee_addr[2],
+           d->ieee_addr[1],
+           d->ieee_addr[0],
+           (unsigned)d->capability,
+           (unsigned)d->seen_count,
+           (now_us - d->last_seen_us) / 1000000);
+}
+
 static esp_err_t znsp_status_to_err(uint8_t status) {
     switch (status) {
         case 0x00:
@@ -395,24 +423,51 @@ static int cmd_gw(int argc, char **argv) {
     }
 
     if (strcmp(argv[1], "devices") == 0) {
-        gw_registry_device_t snap[32];
-        const size_t n = gw_registry_snapshot(snap, sizeof(snap) / sizeof(snap[0]));
-        printf("devices: %u\n", (unsigned)n);
-        for (size_t i = 0; i < n; i++) {
-            const gw_registry_device_t *d = &snap[i];
-            printf("  short=0x%04x ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x cap=0x%02x seen=%u\n",
-                   (unsigned)d->short_addr,
-                   d->ieee_addr[7],
-                   d->ieee_addr[6],
-                   d->ieee_addr[5],
-                   d->ieee_addr[4],
-                   d->ieee_addr[3],
-                   d->ieee_addr[2],
-                   d->ieee_addr[1],
-                   d->ieee_addr[0],
-                   (unsigned)d->capability,
-                   (unsigned)d->seen_count);
+        const size_t cap = gw_registry_capacity();
+        gw_registry_device_t *snap = calloc(cap, sizeof(*snap));
+        if (!snap) {
+            printf("devices: out of memory\n");
+            return 1;
+        }
+        uint32_t gen = 0;
+        const size_t n = gw_registry_snapshot(snap, cap, &gen);
+        gw_registry_stats_t st = {0};
+        gw_registry_get_stats(&st);
+        printf("devices: %u (capacity=%u generation=%" PRIu32 " full_drops=%" PRIu32 ")\n",
+               (unsigned)n,
+               (unsigned)cap,
+               gen,
+               st.full_drops);
+        const int64_t now_us = esp_timer_get_time();
+        for (size_t i = 0; i < n; i++) print_registry_device(&snap[i], now_us);
+        free(snap);
+        return 0;
+    }
+
+    if (strcmp(argv[1], "device") == 0) {
+        if (argc < 3) {
+            print_usage_gw();
+            return 1;
+        }
+        gw_registry_device_t d;
+        uint8_t ieee[8];
+        bool found = false;
+        if (parse_ieee(argv[2], ieee)) {
+            found = gw_registry_get_by_ieee(ieee, &d);
+        } else {
+            char *end = NULL;
+            const unsigned long short_ul = strtoul(argv[2], &end, 0);
+            if (!end || *end != '\0' || short_ul > 0xFFFF) {
+                printf("invalid address: %s\n", argv[2]);
+                return 1;
+            }
+            found = gw_registry_get_by_short((uint16_t)short_ul, &d);
+        }
+        if (!found) {
+            printf("device: %s not in registry\n", argv[2]);
+            return 1;
         }
+        print_registry_device(&d, esp_timer_get_time());
         return 0;
     }
 
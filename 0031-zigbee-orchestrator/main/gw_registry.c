@@ -5,67 +5,225 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
 
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 
-// Fixed-size, in-memory registry intended for bring-up and debugging.
+#include "sdkconfig.h"
+
+// In-memory registry intended for bring-up and debugging.
 // Not persisted; future work can back this with NVS and richer ZCL interview state.
-#define GW_REGISTRY_MAX_DEVICES 32
+//
+// Devices are kept dense in s_devs[0..s_count); leaving devices are replaced by the
+// last entry. Two open-addressing (linear probe) tables map short address and IEEE
+// address to a position in s_devs, so announce/leave/lookup are O(1) expected.
+#define GW_REGISTRY_MAX_DEVICES CONFIG_GW_REGISTRY_MAX_DEVICES
+
+// Snapshot copies this many entries per critical section.
+#define GW_REGISTRY_SNAPSHOT_CHUNK 16
+// After this many retries (writers kept bumping the generation), copy in one go.
+#define GW_REGISTRY_SNAPSHOT_RETRIES 3
 
 static const char *TAG = "gw_reg_0031";
 
-static gw_registry_device_t s_devs[GW_REGISTRY_MAX_DEVICES] = {0};
+typedef enum {
+    IDX_SHORT = 0,
+    IDX_IEEE,
+} idx_kind_t;
+
+static gw_registry_device_t *s_devs = NULL;
+static uint16_t *s_idx[2] = {NULL, NULL}; // entry = position in s_devs + 1, 0 = empty
+static size_t s_idx_mask = 0;
+static size_t s_count = 0;
+static uint32_t s_generation = 0;
+static uint32_t s_full_drops = 0;
 static portMUX_TYPE s_mu = portMUX_INITIALIZER_UNLOCKED;
 
+static inline size_t hash_short(uint16_t short_addr) {
+    return (size_t)((short_addr * 0x9E3779B1u) >> 16);
+}
+
+static inline size_t hash_ieee(const uint8_t ieee_addr[8]) {
+    uint64_t x;
+    memcpy(&x, ieee_addr, sizeof(x));
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+static inline size_t dev_hash(idx_kind_t k, const gw_registry_device_t *d) {
+    return (k == IDX_SHORT) ? hash_short(d->short_addr) : hash_ieee(d->ieee_addr);
+}
+
 static int find_by_short(uint16_t short_addr) {
-    for (int i = 0; i < GW_REGISTRY_MAX_DEVICES; i++) {
-        if (s_devs[i].in_use && s_devs[i].short_addr == short_addr) return i;
+    const uint16_t *tab = s_idx[IDX_SHORT];
+    for (size_t i = hash_short(short_addr) & s_idx_mask;; i = (i + 1) & s_idx_mask) {
+        const uint16_t v = tab[i];
+        if (v == 0) return -1;
+        if (s_devs[v - 1].short_addr == short_addr) return v - 1;
     }
-    return -1;
 }
 
 static int find_by_ieee(const uint8_t ieee_addr[8]) {
-    for (int i = 0; i < GW_REGISTRY_MAX_DEVICES; i++) {
-        if (!s_devs[i].in_use) continue;
-        if (memcmp(s_devs[i].ieee_addr, ieee_addr, 8) == 0) return i;
+    const uint16_t *tab = s_idx[IDX_IEEE];
+    for (size_t i = hash_ieee(ieee_addr) & s_idx_mask;; i = (i + 1) & s_idx_mask) {
+        const uint16_t v = tab[i];
+        if (v == 0) return -1;
+        if (memcmp(s_devs[v - 1].ieee_addr, ieee_addr, 8) == 0) return v - 1;
     }
-    return -1;
 }
 
-static int alloc_slot(void) {
-    for (int i = 0; i < GW_REGISTRY_MAX_DEVICES; i++) {
-        if (!s_devs[i].in_use) return i;
+static void idx_insert(idx_kind_t k, int pos) {
+    uint16_t *tab = s_idx[k];
+    size_t i = dev_hash(k, &s_devs[pos]) & s_idx_mask;
+    while (tab[i] != 0) i = (i + 1) & s_idx_mask;
+    tab[i] = (uint16_t)(pos + 1);
+}
+
+// Table slot holding s_devs[pos]; s_devs[pos] must be indexed under its current key.
+static size_t idx_slot_of(idx_kind_t k, int pos) {
+    const uint16_t *tab = s_idx[k];
+    size_t i = dev_hash(k, &s_devs[pos]) & s_idx_mask;
+    while (tab[i] != (uint16_t)(pos + 1)) i = (i + 1) & s_idx_mask;
+    return i;
+}
+
+// Backward-shift deletion: no tombstones, so probe chains stay short under churn.
+static void idx_erase_slot(idx_kind_t k, size_t hole) {
+    uint16_t *tab = s_idx[k];
+    size_t j = hole;
+    for (;;) {
+        j = (j + 1) & s_idx_mask;
+        if (tab[j] == 0) break;
+        const size_t home = dev_hash(k, &s_devs[tab[j] - 1]) & s_idx_mask;
+        // Entry at j may fill the hole unless its home lies cyclically in (hole, j].
+        const bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!stays) {
+            tab[hole] = tab[j];
+            hole = j;
+        }
     }
-    return -1;
+    tab[hole] = 0;
+}
+
+static void idx_erase(idx_kind_t k, int pos) {
+    idx_erase_slot(k, idx_slot_of(k, pos));
+}
+
+static void remove_at(int pos) {
+    idx_erase(IDX_SHORT, pos);
+    idx_erase(IDX_IEEE, pos);
+
+    const int last = (int)s_count - 1;
+    if (pos != last) {
+        // Move the last device into the hole and repoint its index entries.
+        s_idx[IDX_SHORT][idx_slot_of(IDX_SHORT, last)] = (uint16_t)(pos + 1);
+        s_idx[IDX_IEEE][idx_slot_of(IDX_IEEE, last)] = (uint16_t)(pos + 1);
+        s_devs[pos] = s_devs[last];
+    }
+    memset(&s_devs[last], 0, sizeof(s_devs[last]));
+    s_count--;
+}
+
+static void *alloc_table(size_t bytes) {
+    void *p = NULL;
+#if CONFIG_GW_REGISTRY_IN_PSRAM
+    p = heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!p) p = heap_caps_calloc(1, bytes, MALLOC_CAP_8BIT);
+    return p;
+}
+
+esp_err_t gw_registry_init(void) {
+    if (s_devs) return ESP_OK;
+
+    // Keep the index at most half full.
+    size_t idx_size = 1;
+    while (idx_size < 2 * (size_t)GW_REGISTRY_MAX_DEVICES) idx_size <<= 1;
+
+    gw_registry_device_t *devs = alloc_table(GW_REGISTRY_MAX_DEVICES * sizeof(*devs));
+    uint16_t *by_short = alloc_table(idx_size * sizeof(*by_short));
+    uint16_t *by_ieee = alloc_table(idx_size * sizeof(*by_ieee));
+    if (!devs || !by_short || !by_ieee) {
+        heap_caps_free(devs);
+        heap_caps_free(by_short);
+        heap_caps_free(by_ieee);
+        ESP_LOGE(TAG, "registry alloc failed (max_devices=%d)", GW_REGISTRY_MAX_DEVICES);
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&s_mu);
+    s_idx[IDX_SHORT] = by_short;
+    s_idx[IDX_IEEE] = by_ieee;
+    s_idx_mask = idx_size - 1;
+    s_count = 0;
+    s_devs = devs;
+    portEXIT_CRITICAL(&s_mu);
+
+    ESP_LOGI(TAG, "registry ready (max_devices=%d index=%u)", GW_REGISTRY_MAX_DEVICES, (unsigned)idx_size);
+    return ESP_OK;
 }
 
 void gw_registry_on_device_announce(const gw_evt_zb_device_annce_t *ev) {
-    if (!ev) return;
+    if (!ev || !s_devs) return;
 
     const int64_t now_us = esp_timer_get_time();
     bool short_changed = false;
+    bool full = false;
     uint16_t prev_short = 0;
     uint16_t new_short = ev->short_addr;
     uint8_t ieee_copy[8];
     memcpy(ieee_copy, ev->ieee_addr, sizeof(ieee_copy));
 
     portENTER_CRITICAL(&s_mu);
-    int idx = find_by_short(ev->short_addr);
-    if (idx < 0) idx = find_by_ieee(ev->ieee_addr);
-    if (idx < 0) idx = alloc_slot();
+    int idx = find_by_ieee(ev->ieee_addr);
+    const int by_short = find_by_short(ev->short_addr);
     if (idx >= 0) {
+        // Known device. Another entry still holding this short address is stale
+        // (the device it belonged to left without us seeing it).
+        if (by_short >= 0 && by_short != idx) {
+            const int last = (int)s_count - 1;
+            remove_at(by_short);
+            if (idx == last) idx = by_short;
+        }
         prev_short = s_devs[idx].short_addr;
-        const bool had_prev = s_devs[idx].in_use;
+        if (prev_short != ev->short_addr) {
+            idx_erase(IDX_SHORT, idx);
+            s_devs[idx].short_addr = ev->short_addr;
+            idx_insert(IDX_SHORT, idx);
+            short_changed = true;
+        }
+    } else if (by_short >= 0) {
+        // Short address reassigned to a different device.
+        idx = by_short;
+        idx_erase(IDX_IEEE, idx);
+        memcpy(s_devs[idx].ieee_addr, ev->ieee_addr, 8);
+        idx_insert(IDX_IEEE, idx);
+        s_devs[idx].seen_count = 0;
+    } else if (s_count < GW_REGISTRY_MAX_DEVICES) {
+        idx = (int)s_count++;
         s_devs[idx].in_use = true;
         s_devs[idx].short_addr = ev->short_addr;
         memcpy(s_devs[idx].ieee_addr, ev->ieee_addr, 8);
+        s_devs[idx].seen_count = 0;
+        idx_insert(IDX_SHORT, idx);
+        idx_insert(IDX_IEEE, idx);
+    } else {
+        s_full_drops++;
+        full = true;
+    }
+    if (idx >= 0) {
         s_devs[idx].capability = ev->capability;
         s_devs[idx].seen_count++;
         s_devs[idx].last_seen_us = now_us;
-        short_changed = had_prev && (prev_short != ev->short_addr);
+        s_generation++;
     }
     portEXIT_CRITICAL(&s_mu);
 
+    if (full) {
+        ESP_LOGW(TAG, "registry full (%d): ignoring short=0x%04x", GW_REGISTRY_MAX_DEVICES, (unsigned)new_short);
+    }
     if (short_changed) {
         ESP_LOGI(TAG,
                  "device short changed: ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x 0x%04x -> 0x%04x",
@@ -82,15 +240,94 @@ void gw_registry_on_device_announce(const gw_evt_zb_device_annce_t *ev) {
     }
 }
 
-size_t gw_registry_snapshot(gw_registry_device_t *out, size_t max_out) {
-    if (!out || max_out == 0) return 0;
+void gw_registry_on_device_leave(const gw_evt_zb_device_leave_t *ev) {
+    if (!ev || !s_devs || ev->rejoin) return;
 
-    size_t n = 0;
     portENTER_CRITICAL(&s_mu);
-    for (int i = 0; i < GW_REGISTRY_MAX_DEVICES && n < max_out; i++) {
-        if (!s_devs[i].in_use) continue;
-        out[n++] = s_devs[i];
+    int idx = find_by_ieee(ev->ieee_addr);
+    if (idx < 0) idx = find_by_short(ev->short_addr);
+    if (idx >= 0) {
+        remove_at(idx);
+        s_generation++;
+    }
+    portEXIT_CRITICAL(&s_mu);
+}
+
+bool gw_registry_touch(uint16_t short_addr) {
+    if (!s_devs) return false;
+
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_mu);
+    const int idx = find_by_short(short_addr);
+    if (idx >= 0) {
+        s_devs[idx].seen_count++;
+        s_devs[idx].last_seen_us = now_us;
     }
     portEXIT_CRITICAL(&s_mu);
+    return idx >= 0;
+}
+
+bool gw_registry_get_by_short(uint16_t short_addr, gw_registry_device_t *out) {
+    if (!s_devs) return false;
+
+    portENTER_CRITICAL(&s_mu);
+    const int idx = find_by_short(short_addr);
+    if (idx >= 0 && out) *out = s_devs[idx];
+    portEXIT_CRITICAL(&s_mu);
+    return idx >= 0;
+}
+
+bool gw_registry_get_by_ieee(const uint8_t ieee_addr[8], gw_registry_device_t *out) {
+    if (!s_devs || !ieee_addr) return false;
+
+    portENTER_CRITICAL(&s_mu);
+    const int idx = find_by_ieee(ieee_addr);
+    if (idx >= 0 && out) *out = s_devs[idx];
+    portEXIT_CRITICAL(&s_mu);
+    return idx >= 0;
+}
+
+size_t gw_registry_capacity(void) {
+    return GW_REGISTRY_MAX_DEVICES;
+}
+
+void gw_registry_get_stats(gw_registry_stats_t *out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_mu);
+    out->devices = (uint32_t)s_count;
+    out->capacity = GW_REGISTRY_MAX_DEVICES;
+    out->generation = s_generation;
+    out->full_drops = s_full_drops;
+    portEXIT_CRITICAL(&s_mu);
+}
+
+size_t gw_registry_snapshot(gw_registry_device_t *out, size_t max_out, uint32_t *out_generation) {
+    if (!out || max_out == 0 || !s_devs) return 0;
+
+    size_t n = 0;
+    uint32_t gen = 0;
+    for (int attempt = 0;; attempt++) {
+        const bool one_go = attempt >= GW_REGISTRY_SNAPSHOT_RETRIES;
+        bool torn = false;
+
+        portENTER_CRITICAL(&s_mu);
+        gen = s_generation;
+        n = s_count < max_out ? s_count : max_out;
+        size_t done = one_go ? n : (n < GW_REGISTRY_SNAPSHOT_CHUNK ? n : GW_REGISTRY_SNAPSHOT_CHUNK);
+        memcpy(out, s_devs, done * sizeof(*out));
+        portEXIT_CRITICAL(&s_mu);
+
+        while (done < n && !torn) {
+            const size_t chunk = (n - done) < GW_REGISTRY_SNAPSHOT_CHUNK ? (n - done) : GW_REGISTRY_SNAPSHOT_CHUNK;
+            portENTER_CRITICAL(&s_mu);
+            torn = (s_generation != gen);
+            if (!torn) memcpy(&out[done], &s_devs[done], chunk * sizeof(*out));
+            portEXIT_CRITICAL(&s_mu);
+            done += chunk;
+        }
+        if (!torn) break;
+    }
+
+    if (out_generation) *out_generation = gen;
     return n;
 }
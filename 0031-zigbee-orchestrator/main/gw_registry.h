@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "esp_err.h"
+
 #include "gw_types.h"
 
 #ifdef __cplusplus
@@ -19,8 +21,33 @@ typedef struct {
     int64_t last_seen_us;
 } gw_registry_device_t;
 
+typedef struct {
+    uint32_t devices;
+    uint32_t capacity;
+    uint32_t generation; // bumped on every join, leave and address change (not on touch)
+    uint32_t full_drops; // announces ignored because the registry was full
+} gw_registry_stats_t;
+
+// Allocates the device table (CONFIG_GW_REGISTRY_MAX_DEVICES entries, PSRAM when
+// enabled and available). Safe to call twice; must run before any event reaches it.
+esp_err_t gw_registry_init(void);
+
 void gw_registry_on_device_announce(const gw_evt_zb_device_annce_t *ev);
-size_t gw_registry_snapshot(gw_registry_device_t *out, size_t max_out);
+void gw_registry_on_device_leave(const gw_evt_zb_device_leave_t *ev);
+
+// Marks a known device as heard from (e.g. an attribute report). Returns false for unknown short addresses.
+bool gw_registry_touch(uint16_t short_addr);
+
+bool gw_registry_get_by_short(uint16_t short_addr, gw_registry_device_t *out);
+bool gw_registry_get_by_ieee(const uint8_t ieee_addr[8], gw_registry_device_t *out);
+
+size_t gw_registry_capacity(void);
+void gw_registry_get_stats(gw_registry_stats_t *out);
+
+// Copies up to max_out devices; the lock is only held per chunk, and the copy is
+// retried if a writer got in between, so the result is always one generation.
+// out_generation (optional) receives that generation.
+size_t gw_registry_snapshot(gw_registry_device_t *out, size_t max_out, uint32_t *out_generation);
 
 #ifdef __cplusplus
 }
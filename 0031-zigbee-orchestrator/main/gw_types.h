@@ -19,6 +19,7 @@ typedef enum {
     // Zigbee notifications (from host+NCP stack)
     GW_EVT_ZB_PERMIT_JOIN_STATUS = 200,
     GW_EVT_ZB_DEVICE_ANNCE = 201,
+    GW_EVT_ZB_DEVICE_LEAVE = 202,
 } gw_event_id_t;
 
 typedef struct {
@@ -47,3 +48,9 @@ typedef struct {
     uint8_t ieee_addr[8];
     uint8_t capability;
 } gw_evt_zb_device_annce_t;
+
+typedef struct {
+    uint16_t short_addr;
+    uint8_t ieee_addr[8];
+    bool rejoin; // device will rejoin; keep its registry entry
+} gw_evt_zb_device_leave_t;
@@ -4,7 +4,6 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
-#include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include "nvs_flash.h"
@@ -62,7 +61,6 @@ static QueueHandle_t s_cmd_q = NULL;
 static TaskHandle_t s_stack_task = NULL;
 static TaskHandle_t s_cmd_task = NULL;
 static bool s_started = false;
-static SemaphoreHandle_t s_znsp_mu = NULL;
 static uint32_t s_primary_channel_mask = 0;
 
 static const char *NVS_NS = "gw_zb";
@@ -169,101 +167,149 @@ esp_err_t gw_zb_znsp_request(uint16_t id,
                              void *output,
                              uint16_t *outlen,
                              TickType_t timeout) {
-    if (!s_started || !s_znsp_mu) return ESP_ERR_INVALID_STATE;
+    if (!s_started) return ESP_ERR_INVALID_STATE;
     if (!output || !outlen) return ESP_ERR_INVALID_ARG;
 
-    if (xSemaphoreTake(s_znsp_mu, timeout) != pdTRUE) return ESP_ERR_TIMEOUT;
-    const esp_err_t err = esp_host_zb_output(id, buffer, len, output, outlen);
-    xSemaphoreGive(s_znsp_mu);
-    return err;
+    // No gateway-wide lock: zb_host matches responses by sequence number, so
+    // concurrent callers each wait only for their own reply.
+    esp_host_zb_req_t *req = NULL;
+    const esp_err_t err = esp_host_zb_request_send(id, buffer, len, output, outlen, &req);
+    if (err != ESP_OK) return err;
+    return esp_host_zb_request_wait(req, pdTICKS_TO_MS(timeout));
+}
+
+typedef struct __attribute__((packed)) {
+    esp_zb_zcl_basic_cmd_t zcl_basic_cmd;
+    uint8_t address_mode;
+    uint16_t profile_id;
+    uint16_t cluster_id;
+    uint16_t custom_cmd_id;
+    uint8_t direction;
+    uint8_t type;
+    uint16_t size;
+} gw_ncp_zcl_write_t;
+
+// On/off commands drained from the queue in one go and sent back to back; the
+// replies are collected afterwards so N devices cost ~one NCP round trip.
+#define GW_ZB_ONOFF_BATCH 8
+
+typedef struct {
+    gw_zb_cmd_t cmd;
+    gw_ncp_zcl_write_t payload;
+    esp_host_zb_req_t *req;
+    esp_err_t txerr;
+    uint8_t out;
+    uint16_t outlen;
+} gw_zb_onoff_slot_t;
+
+static void gw_zb_handle_permit_join(const gw_zb_cmd_t *cmd) {
+    const uint16_t requested = cmd->seconds;
+    const uint8_t sec8 = (requested > 255) ? 255 : (uint8_t)requested;
+    uint8_t out = 0xFF;
+    uint16_t outlen = sizeof(out);
+
+    if (requested != (uint16_t)sec8) {
+        ESP_LOGW(TAG,
+                 "permit_join seconds clamped: requested=%u -> sending=%u req_id=%" PRIu64,
+                 (unsigned)requested,
+                 (unsigned)sec8,
+                 cmd->req_id);
+    }
+    ESP_LOGI(TAG, "permit_join request seconds=%u req_id=%" PRIu64, (unsigned)sec8, cmd->req_id);
+    const esp_err_t txerr = gw_zb_znsp_request(ZNSP_NETWORK_PERMIT_JOINING,
+                                              &sec8,
+                                              sizeof(sec8),
+                                              &out,
+                                              &outlen,
+                                              pdMS_TO_TICKS(3000));
+
+    const esp_err_t status = (txerr == ESP_OK) ? map_znsp_status_to_err(out) : txerr;
+    ESP_LOGI(TAG, "permit_join response status=0x%02x (%s) req_id=%" PRIu64,
+             (unsigned)out,
+             esp_err_to_name(status),
+             cmd->req_id);
+    (void)gw_zb_post_cmd_result(cmd->req_id, status);
+}
+
+static void gw_zb_handle_onoff_batch(gw_zb_onoff_slot_t *slots, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        gw_zb_onoff_slot_t *s = &slots[i];
+        const gw_zb_cmd_t *cmd = &s->cmd;
+
+        s->payload = (gw_ncp_zcl_write_t){
+            .zcl_basic_cmd =
+                {
+                    .dst_addr_u = {.addr_short = cmd->short_addr},
+                    .dst_endpoint = cmd->dst_ep,
+                    .src_endpoint = 1,
+                },
+            .address_mode = 0x02, // ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT
+            .profile_id = 0x0104, // HA profile
+            .cluster_id = 0x0006, // OnOff
+            .custom_cmd_id = cmd->cmd_id,
+            .direction = 0x00, // ESP_ZB_ZCL_CMD_DIRECTION_TO_SRV
+            .type = 0x00,      // ESP_ZB_ZCL_ATTR_TYPE_NULL
+            .size = 0,
+        };
+        s->out = 0xFF;
+        s->outlen = sizeof(s->out);
+        s->req = NULL;
+
+        ESP_LOGI(TAG,
+                 "onoff request short=0x%04x ep=%u cmd=%u req_id=%" PRIu64,
+                 (unsigned)cmd->short_addr,
+                 (unsigned)cmd->dst_ep,
+                 (unsigned)cmd->cmd_id,
+                 cmd->req_id);
+        s->txerr = esp_host_zb_request_send(ZNSP_ZCL_WRITE, &s->payload, sizeof(s->payload), &s->out, &s->outlen, &s->req);
+    }
+
+    // All requests share one deadline rather than 3 s each.
+    const TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(3000);
+    for (size_t i = 0; i < n; i++) {
+        gw_zb_onoff_slot_t *s = &slots[i];
+        if (s->txerr == ESP_OK) {
+            const TickType_t now = xTaskGetTickCount();
+            const TickType_t left = ((int32_t)(deadline - now) > 0) ? deadline - now : 0;
+            s->txerr = esp_host_zb_request_wait(s->req, pdTICKS_TO_MS(left));
+        }
+        const esp_err_t status = (s->txerr == ESP_OK) ? map_znsp_status_to_err(s->out) : s->txerr;
+        ESP_LOGI(TAG,
+                 "onoff response status=0x%02x (%s) req_id=%" PRIu64,
+                 (unsigned)s->out,
+                 esp_err_to_name(status),
+                 s->cmd.req_id);
+        (void)gw_zb_post_cmd_result(s->cmd.req_id, status);
+    }
 }
 
 static void gw_zb_cmd_task_main(void *arg) {
     (void)arg;
+    static gw_zb_onoff_slot_t batch[GW_ZB_ONOFF_BATCH];
+    gw_zb_cmd_t cmd = {0};
+    bool have_cmd = false;
+
     while (true) {
-        gw_zb_cmd_t cmd = {0};
-        if (xQueueReceive(s_cmd_q, &cmd, portMAX_DELAY) != pdTRUE) continue;
+        if (!have_cmd && xQueueReceive(s_cmd_q, &cmd, portMAX_DELAY) != pdTRUE) continue;
+        have_cmd = false;
 
         switch (cmd.kind) {
-            case GW_ZB_CMD_PERMIT_JOIN: {
-                const uint16_t requested = cmd.seconds;
-                const uint8_t sec8 = (requested > 255) ? 255 : (uint8_t)requested;
-                uint8_t out = 0xFF;
-                uint16_t outlen = sizeof(out);
-
-                if (requested != (uint16_t)sec8) {
-                    ESP_LOGW(TAG,
-                             "permit_join seconds clamped: requested=%u -> sending=%u req_id=%" PRIu64,
-                             (unsigned)requested,
-                             (unsigned)sec8,
-                             cmd.req_id);
-                }
-                ESP_LOGI(TAG, "permit_join request seconds=%u req_id=%" PRIu64, (unsigned)sec8, cmd.req_id);
-                const esp_err_t txerr = gw_zb_znsp_request(ZNSP_NETWORK_PERMIT_JOINING,
-                                                          &sec8,
-                                                          sizeof(sec8),
-                                                          &out,
-                                                          &outlen,
-                                                          pdMS_TO_TICKS(3000));
-
-                const esp_err_t status = (txerr == ESP_OK) ? map_znsp_status_to_err(out) : txerr;
-                ESP_LOGI(TAG, "permit_join response status=0x%02x (%s) req_id=%" PRIu64,
-                         (unsigned)out,
-                         esp_err_to_name(status),
-                         cmd.req_id);
-                (void)gw_zb_post_cmd_result(cmd.req_id, status);
+            case GW_ZB_CMD_PERMIT_JOIN:
+                gw_zb_handle_permit_join(&cmd);
                 break;
-            }
             case GW_ZB_CMD_ONOFF: {
-                uint8_t out = 0xFF;
-                uint16_t outlen = sizeof(out);
-
-                typedef struct __attribute__((packed)) {
-                    esp_zb_zcl_basic_cmd_t zcl_basic_cmd;
-                    uint8_t address_mode;
-                    uint16_t profile_id;
-                    uint16_t cluster_id;
-                    uint16_t custom_cmd_id;
-                    uint8_t direction;
-                    uint8_t type;
-                    uint16_t size;
-                } gw_ncp_zcl_write_t;
-
-                const gw_ncp_zcl_write_t payload = {
-                    .zcl_basic_cmd =
-                        {
-                            .dst_addr_u = {.addr_short = cmd.short_addr},
-                            .dst_endpoint = cmd.dst_ep,
-                            .src_endpoint = 1,
-                        },
-                    .address_mode = 0x02, // ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT
-                    .profile_id = 0x0104, // HA profile
-                    .cluster_id = 0x0006, // OnOff
-                    .custom_cmd_id = cmd.cmd_id,
-                    .direction = 0x00, // ESP_ZB_ZCL_CMD_DIRECTION_TO_SRV
-                    .type = 0x00,      // ESP_ZB_ZCL_ATTR_TYPE_NULL
-                    .size = 0,
-                };
-
-                ESP_LOGI(TAG,
-                         "onoff request short=0x%04x ep=%u cmd=%u req_id=%" PRIu64,
-                         (unsigned)cmd.short_addr,
-                         (unsigned)cmd.dst_ep,
-                         (unsigned)cmd.cmd_id,
-                         cmd.req_id);
-                const esp_err_t txerr = gw_zb_znsp_request(ZNSP_ZCL_WRITE,
-                                                          &payload,
-                                                          sizeof(payload),
-                                                          &out,
-                                                          &outlen,
-                                                          pdMS_TO_TICKS(3000));
-                const esp_err_t status = (txerr == ESP_OK) ? map_znsp_status_to_err(out) : txerr;
-                ESP_LOGI(TAG,
-                         "onoff response status=0x%02x (%s) req_id=%" PRIu64,
-                         (unsigned)out,
-                         esp_err_to_name(status),
-                         cmd.req_id);
-                (void)gw_zb_post_cmd_result(cmd.req_id, status);
+                size_t n = 0;
+                batch[n++].cmd = cmd;
+                // Pull whatever else is already queued; stop at the first
+                // non-onoff command and run it next, keeping queue order.
+                while (n < GW_ZB_ONOFF_BATCH && xQueueReceive(s_cmd_q, &cmd, 0) == pdTRUE) {
+                    if (cmd.kind != GW_ZB_CMD_ONOFF) {
+                        have_cmd = true;
+                        break;
+                    }
+                    batch[n++].cmd = cmd;
+                }
+                gw_zb_handle_onoff_batch(batch, n);
                 break;
             }
             default:
@@ -321,10 +367,7 @@ esp_err_t gw_zb_start(void) {
 
     ESP_RETURN_ON_ERROR(ensure_nvs_ready(), TAG, "nvs not ready");
 
-    s_znsp_mu = xSemaphoreCreateMutex();
-    if (!s_znsp_mu) return ESP_ERR_NO_MEM;
-
-    s_cmd_q = xQueueCreate(8, sizeof(gw_zb_cmd_t));
+    s_cmd_q = xQueueCreate(16, sizeof(gw_zb_cmd_t));
     if (!s_cmd_q) return ESP_ERR_NO_MEM;
 
     if (xTaskCreate(gw_zb_cmd_task_main, "gw_zb_cmd", 4096, NULL, 9, &s_cmd_task) != pdTRUE) {
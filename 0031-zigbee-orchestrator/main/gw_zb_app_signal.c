@@ -4,6 +4,7 @@
 #include "zdo/esp_zigbee_zdo_common.h"
 
 #include "gw_bus.h"
+#include "gw_registry.h"
 #include "gw_types.h"
 
 static const char *TAG = "gw_zb_sig_0031";
@@ -48,6 +49,16 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct) {
             const esp_zb_zdo_signal_leave_indication_params_t *params =
                 (const esp_zb_zdo_signal_leave_indication_params_t *)esp_zb_app_signal_get_params((uint32_t *)p);
             if (!params) break;
+
+            gw_evt_zb_device_leave_t ev = {0};
+            ev.short_addr = params->short_addr;
+            ev.rejoin = params->rejoin != 0;
+            for (int i = 0; i < 8; i++) ev.ieee_addr[i] = params->device_addr[i];
+
+            esp_event_loop_handle_t loop = gw_bus_get_loop();
+            if (loop) {
+                (void)esp_event_post_to(loop, GW_EVT, GW_EVT_ZB_DEVICE_LEAVE, &ev, sizeof(ev), 0);
+            }
             ESP_LOGI(TAG, "ZB leave indication: short=0x%04x rejoin=%u ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
                      (unsigned)params->short_addr,
                      (unsigned)params->rejoin,
@@ -66,6 +77,7 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct) {
             const esp_zb_zdo_signal_device_update_params_t *u =
                 (const esp_zb_zdo_signal_device_update_params_t *)esp_zb_app_signal_get_params((uint32_t *)p);
             if (!u) break;
+            if (u->status != 0x02) (void)gw_registry_touch(u->short_addr); // 0x02: device left
             ESP_LOGI(TAG, "ZB device update: status=0x%02x short=0x%04x ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
                      (unsigned)u->status,
                      (unsigned)u->short_addr,
@@ -84,6 +96,7 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct) {
             const esp_zb_zdo_signal_device_authorized_params_t *a =
                 (const esp_zb_zdo_signal_device_authorized_params_t *)esp_zb_app_signal_get_params((uint32_t *)p);
             if (!a) break;
+            (void)gw_registry_touch(a->short_addr);
             ESP_LOGI(TAG,
                      "ZB device authorized: type=0x%02x status=0x%02x short=0x%04x ieee=%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
                      (unsigned)a->authorization_type,
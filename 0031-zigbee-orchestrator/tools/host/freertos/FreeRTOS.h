@@ -0,0 +1,27 @@
+/*
+ * Host stand-in for the FreeRTOS pieces the host tests use (gw_registry.c,
+ * esp_host_zb_pending.c), on top of pthreads. One tick is one millisecond;
+ * a portMUX is a plain mutex.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define portMAX_DELAY           ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define pdTICKS_TO_MS(t)        ((uint32_t)(t))
+
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_MUTEX_INITIALIZER
+#define portENTER_CRITICAL(mux) pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL(mux)  pthread_mutex_unlock(mux)
+#define taskENTER_CRITICAL(mux) pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL(mux)  pthread_mutex_unlock(mux)
+
+TickType_t xTaskGetTickCount(void);
@@ -0,0 +1,3 @@
+#pragma once
+/* portMUX lives in FreeRTOS.h on the host. */
+#include "freertos/FreeRTOS.h"
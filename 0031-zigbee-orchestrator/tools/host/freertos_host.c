@@ -0,0 +1,77 @@
+#include <errno.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (TickType_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static SemaphoreHandle_t sem_init(StaticSemaphore_t *buf, uint32_t max, uint32_t initial)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&buf->mu, NULL);
+    pthread_cond_init(&buf->cv, &attr);
+    pthread_condattr_destroy(&attr);
+    buf->count = initial;
+    buf->max = max;
+    return buf;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf)
+{
+    return sem_init(buf, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(uint32_t max, uint32_t initial, StaticSemaphore_t *buf)
+{
+    return sem_init(buf, max, initial);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += ticks / 1000;
+    deadline.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&sem->mu);
+    while (sem->count == 0) {
+        if (ticks == 0) {
+            break;
+        }
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&sem->cv, &sem->mu);
+        } else if (pthread_cond_timedwait(&sem->cv, &sem->mu, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    const BaseType_t ok = sem->count > 0;
+    if (ok) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->mu);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->mu);
+    const BaseType_t ok = sem->count < sem->max;
+    if (ok) {
+        sem->count++;
+        pthread_cond_signal(&sem->cv);
+    }
+    pthread_mutex_unlock(&sem->mu);
+    return ok ? pdTRUE : pdFALSE;
+}
@@ -0,0 +1,7 @@
+/* Host build configuration (gw_registry.c). */
+#pragma once
+
+#ifndef CONFIG_GW_REGISTRY_MAX_DEVICES
+#define CONFIG_GW_REGISTRY_MAX_DEVICES 1024
+#endif
+#define CONFIG_GW_REGISTRY_IN_PSRAM 1
@@ -0,0 +1,429 @@
+/*
+ * Host test and benchmark for the gateway device registry (main/gw_registry.c).
+ *
+ * Churns join/leave/report events against a linear-scan reference model with
+ * the same semantics and checks that both agree along the way, that a full
+ * registry drops new devices cleanly, that a
+ * snapshot taken while another thread churns never mixes generations, and
+ * times lookups against the reference at a few registry sizes.
+ *
+ * Built and run by tools/registry_host/run_registry_host.sh. Exits non-zero on failure.
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "gw_registry.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define CAP CONFIG_GW_REGISTRY_MAX_DEVICES
+
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t rnd(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void make_ieee(uint32_t n, uint8_t out[8])
+{
+    const uint64_t v = 0x00124b0000000000ull | n;
+    memcpy(out, &v, 8);
+}
+
+/* ---- reference model: the registry semantics as a plain linear scan ---- */
+
+typedef struct {
+    uint16_t short_addr;
+    uint8_t ieee_addr[8];
+    uint8_t capability;
+    uint32_t seen_count;
+} ref_dev_t;
+
+static ref_dev_t s_ref[CAP];
+static size_t s_ref_n;
+
+static int ref_find_short(uint16_t short_addr)
+{
+    for (size_t i = 0; i < s_ref_n; i++) {
+        if (s_ref[i].short_addr == short_addr) return (int)i;
+    }
+    return -1;
+}
+
+static int ref_find_ieee(const uint8_t ieee[8])
+{
+    for (size_t i = 0; i < s_ref_n; i++) {
+        if (memcmp(s_ref[i].ieee_addr, ieee, 8) == 0) return (int)i;
+    }
+    return -1;
+}
+
+static void ref_remove(int i)
+{
+    s_ref[i] = s_ref[--s_ref_n];
+}
+
+static void ref_announce(const gw_evt_zb_device_annce_t *ev)
+{
+    int i = ref_find_ieee(ev->ieee_addr);
+    const int s = ref_find_short(ev->short_addr);
+    if (i >= 0) {
+        if (s >= 0 && s != i) {
+            const int last = (int)s_ref_n - 1;
+            ref_remove(s);
+            if (i == last) i = s;
+        }
+        s_ref[i].short_addr = ev->short_addr;
+    } else if (s >= 0) {
+        i = s;
+        memcpy(s_ref[i].ieee_addr, ev->ieee_addr, 8);
+        s_ref[i].seen_count = 0;
+    } else if (s_ref_n < CAP) {
+        i = (int)s_ref_n++;
+        s_ref[i].short_addr = ev->short_addr;
+        memcpy(s_ref[i].ieee_addr, ev->ieee_addr, 8);
+        s_ref[i].seen_count = 0;
+    }
+    if (i >= 0) {
+        s_ref[i].capability = ev->capability;
+        s_ref[i].seen_count++;
+    }
+}
+
+static void ref_leave(const gw_evt_zb_device_leave_t *ev)
+{
+    if (ev->rejoin) return;
+    int i = ref_find_ieee(ev->ieee_addr);
+    if (i < 0) i = ref_find_short(ev->short_addr);
+    if (i >= 0) ref_remove(i);
+}
+
+static bool ref_touch(uint16_t short_addr)
+{
+    const int i = ref_find_short(short_addr);
+    if (i >= 0) s_ref[i].seen_count++;
+    return i >= 0;
+}
+
+static void clear_all(void)
+{
+    gw_registry_device_t *snap = calloc(CAP, sizeof(*snap));
+    const size_t n = gw_registry_snapshot(snap, CAP, NULL);
+    for (size_t i = 0; i < n; i++) {
+        gw_evt_zb_device_leave_t ev = {.short_addr = snap[i].short_addr};
+        memcpy(ev.ieee_addr, snap[i].ieee_addr, 8);
+        gw_registry_on_device_leave(&ev);
+    }
+    free(snap);
+    s_ref_n = 0;
+}
+
+/* ---- tests ---------------------------------------------------------- */
+
+static void random_event(uint32_t ieee_pool, uint32_t short_pool, bool *touched_ok)
+{
+    const uint32_t r = rnd() % 100;
+    uint8_t ieee[8];
+    make_ieee(rnd() % ieee_pool, ieee);
+    const uint16_t short_addr = (uint16_t)(rnd() % short_pool);
+
+    if (r < 45) {
+        gw_evt_zb_device_annce_t ev = {.short_addr = short_addr, .capability = (uint8_t)r};
+        memcpy(ev.ieee_addr, ieee, 8);
+        gw_registry_on_device_announce(&ev);
+        ref_announce(&ev);
+    } else if (r < 70) {
+        gw_evt_zb_device_leave_t ev = {.short_addr = short_addr, .rejoin = (r % 5) == 0};
+        memcpy(ev.ieee_addr, ieee, 8);
+        gw_registry_on_device_leave(&ev);
+        ref_leave(&ev);
+    } else {
+        *touched_ok = gw_registry_touch(short_addr) == ref_touch(short_addr);
+    }
+}
+
+static void check_matches_ref(void)
+{
+    gw_registry_stats_t st;
+    gw_registry_get_stats(&st);
+    CHECK(st.devices == s_ref_n);
+
+    for (size_t i = 0; i < s_ref_n; i++) {
+        gw_registry_device_t d;
+        CHECK(gw_registry_get_by_ieee(s_ref[i].ieee_addr, &d));
+        CHECK(d.short_addr == s_ref[i].short_addr);
+        CHECK(d.capability == s_ref[i].capability);
+        CHECK(d.seen_count == s_ref[i].seen_count);
+        CHECK(gw_registry_get_by_short(s_ref[i].short_addr, &d));
+        CHECK(memcmp(d.ieee_addr, s_ref[i].ieee_addr, 8) == 0);
+    }
+}
+
+static void test_churn_matches_reference(void)
+{
+    clear_all();
+
+    /* More IEEEs than short addresses forces address reuse and
+     * reassignment of a short to a different device.
+     */
+    const uint32_t events = 200000;
+    const uint32_t ieee_pool = CAP + CAP / 2;
+    const uint32_t short_pool = CAP + CAP / 4;
+    for (uint32_t e = 0; e < events; e++) {
+        bool touched_ok = true;
+        random_event(ieee_pool, short_pool, &touched_ok);
+        CHECK(touched_ok);
+        /* a full comparison is O(n); do it often enough to localize bugs */
+        if ((e % 97) == 0 || e == events - 1) {
+            check_matches_ref();
+            if (g_failures) return;
+        }
+    }
+
+    gw_registry_stats_t st;
+    gw_registry_get_stats(&st);
+    printf("{\"test\":\"churn\",\"events\":%u,\"devices\":%u,\"full_drops\":%u,\"generation\":%u}\n",
+           events, st.devices, st.full_drops, st.generation);
+}
+
+static uint32_t generation(void)
+{
+    gw_registry_stats_t st;
+    gw_registry_get_stats(&st);
+    return st.generation;
+}
+
+static void test_lookup_misses_and_generation(void)
+{
+    clear_all();
+
+    uint8_t ieee[8];
+    make_ieee(7, ieee);
+    CHECK(!gw_registry_get_by_short(0x1234, NULL));
+    CHECK(!gw_registry_get_by_ieee(ieee, NULL));
+    CHECK(!gw_registry_touch(0x1234));
+
+    const uint32_t g0 = generation();
+    gw_evt_zb_device_annce_t ann = {.short_addr = 0x1234, .capability = 0x8e};
+    memcpy(ann.ieee_addr, ieee, 8);
+    gw_registry_on_device_announce(&ann);
+    const uint32_t g1 = generation();
+    CHECK(g1 != g0);
+
+    /* reports are not membership changes */
+    CHECK(gw_registry_touch(0x1234));
+    CHECK(generation() == g1);
+
+    /* a leave with rejoin keeps the device */
+    gw_evt_zb_device_leave_t lv = {.short_addr = 0x1234, .rejoin = true};
+    memcpy(lv.ieee_addr, ieee, 8);
+    gw_registry_on_device_leave(&lv);
+    CHECK(gw_registry_get_by_short(0x1234, NULL));
+    CHECK(generation() == g1);
+
+    /* rejoining with a new short moves the short index */
+    ann.short_addr = 0x4321;
+    gw_registry_on_device_announce(&ann);
+    CHECK(!gw_registry_get_by_short(0x1234, NULL));
+    gw_registry_device_t d;
+    CHECK(gw_registry_get_by_short(0x4321, &d));
+    CHECK(d.seen_count == 3);
+
+    lv.rejoin = false;
+    gw_registry_on_device_leave(&lv);
+    CHECK(!gw_registry_get_by_ieee(ieee, NULL));
+    CHECK(!gw_registry_get_by_short(0x4321, NULL));
+}
+
+static void test_full_registry(void)
+{
+    clear_all();
+
+    gw_registry_stats_t st0;
+    gw_registry_get_stats(&st0);
+    for (uint32_t i = 0; i < CAP + 10; i++) {
+        gw_evt_zb_device_annce_t ev = {.short_addr = (uint16_t)i};
+        make_ieee(i, ev.ieee_addr);
+        gw_registry_on_device_announce(&ev);
+    }
+
+    gw_registry_stats_t st;
+    gw_registry_get_stats(&st);
+    CHECK(st.devices == CAP);
+    CHECK(st.full_drops == st0.full_drops + 10);
+    CHECK(gw_registry_get_by_short(CAP - 1, NULL));
+    CHECK(!gw_registry_get_by_short(CAP, NULL));
+
+    /* known devices still update when full */
+    gw_evt_zb_device_annce_t ev = {.short_addr = 0xfff0};
+    make_ieee(0, ev.ieee_addr);
+    gw_registry_on_device_announce(&ev);
+    CHECK(gw_registry_get_by_short(0xfff0, NULL));
+    CHECK(!gw_registry_get_by_short(0, NULL));
+}
+
+static volatile bool s_writer_stop;
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    uint32_t x = 1;
+    while (!s_writer_stop) {
+        x = x * 1103515245u + 12345u;
+        uint8_t ieee[8];
+        make_ieee((x >> 8) % (CAP / 2), ieee);
+        const uint16_t short_addr = (uint16_t)((x >> 4) % (CAP / 2));
+        if ((x >> 20) & 1) {
+            gw_evt_zb_device_annce_t ev = {.short_addr = short_addr};
+            memcpy(ev.ieee_addr, ieee, 8);
+            gw_registry_on_device_announce(&ev);
+        } else {
+            gw_evt_zb_device_leave_t ev = {.short_addr = short_addr};
+            memcpy(ev.ieee_addr, ieee, 8);
+            gw_registry_on_device_leave(&ev);
+        }
+    }
+    return NULL;
+}
+
+static int cmp_u16(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static void test_snapshot_under_churn(void)
+{
+    clear_all();
+
+    pthread_t writer;
+    s_writer_stop = false;
+    pthread_create(&writer, NULL, writer_main, NULL);
+
+    gw_registry_device_t *snap = calloc(CAP, sizeof(*snap));
+    uint16_t *shorts = calloc(CAP, sizeof(*shorts));
+    uint32_t snapshots = 0;
+    bool ok = true;
+    for (int i = 0; i < 2000 && ok; i++) {
+        uint32_t gen = 0;
+        const size_t n = gw_registry_snapshot(snap, CAP, &gen);
+        /* a torn copy would show the same short address twice */
+        for (size_t k = 0; k < n; k++) shorts[k] = snap[k].short_addr;
+        qsort(shorts, n, sizeof(*shorts), cmp_u16);
+        for (size_t k = 1; k < n; k++) {
+            if (shorts[k] == shorts[k - 1]) ok = false;
+        }
+        snapshots++;
+    }
+
+    s_writer_stop = true;
+    pthread_join(writer, NULL);
+    free(shorts);
+    free(snap);
+    CHECK(ok);
+    printf("{\"test\":\"snapshot_under_churn\",\"snapshots\":%u}\n", snapshots);
+}
+
+/* ---- benchmark ------------------------------------------------------ */
+
+static void bench(size_t devices)
+{
+    clear_all();
+    for (size_t i = 0; i < devices; i++) {
+        gw_evt_zb_device_annce_t ev = {.short_addr = (uint16_t)(0x1000 + i * 7)};
+        make_ieee((uint32_t)i, ev.ieee_addr);
+        gw_registry_on_device_announce(&ev);
+        ref_announce(&ev);
+    }
+
+    const uint32_t ops = 2000000;
+    uint32_t found = 0;
+    double t0 = now_s();
+    for (uint32_t i = 0; i < ops; i++) {
+        found += gw_registry_touch((uint16_t)(0x1000 + (rnd() % devices) * 7));
+    }
+    const double t_index = now_s() - t0;
+
+    /* same lock and clock read as the registry, so only the search differs */
+    static pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+    volatile int64_t sink = 0;
+    t0 = now_s();
+    for (uint32_t i = 0; i < ops; i++) {
+        sink = esp_timer_get_time();
+        pthread_mutex_lock(&mu);
+        found += ref_touch((uint16_t)(0x1000 + (rnd() % devices) * 7));
+        pthread_mutex_unlock(&mu);
+    }
+    (void)sink;
+    const double t_scan = now_s() - t0;
+
+    /* join/leave churn at this size */
+    const uint32_t churn = 200000;
+    t0 = now_s();
+    for (uint32_t i = 0; i < churn; i++) {
+        const uint32_t k = rnd() % devices;
+        gw_evt_zb_device_leave_t lv = {.short_addr = (uint16_t)(0x1000 + k * 7)};
+        make_ieee(k, lv.ieee_addr);
+        gw_registry_on_device_leave(&lv);
+        gw_evt_zb_device_annce_t ev = {.short_addr = lv.short_addr};
+        memcpy(ev.ieee_addr, lv.ieee_addr, 8);
+        gw_registry_on_device_announce(&ev);
+    }
+    const double t_churn = now_s() - t0;
+
+    printf("{\"bench\":\"lookup\",\"devices\":%zu,\"ops\":%u,\"index_ns\":%.1f,\"scan_ns\":%.1f,"
+           "\"speedup\":%.1f,\"churn_ns\":%.1f,\"found\":%u}\n",
+           devices, ops, t_index * 1e9 / ops, t_scan * 1e9 / ops, t_scan / t_index,
+           t_churn * 1e9 / (2.0 * churn), found);
+}
+
+int main(void)
+{
+    if (gw_registry_init() != 0) {
+        fprintf(stderr, "gw_registry_init failed\n");
+        return 1;
+    }
+
+    test_lookup_misses_and_generation();
+    test_churn_matches_reference();
+    test_full_registry();
+    test_snapshot_under_churn();
+
+    if (g_failures == 0) {
+        bench(32);
+        bench(256);
+        bench(CAP);
+    }
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the zb_host SLIP codec host test and throughput benchmark.
+#
+# The codec (components/zb_host/src/slip.c) only needs esp_err.h, which
+# tools/host/ stands in for. The benchmark also links slip_legacy.c, the previous
+# StreamBuffer-based codec, for comparison.
+#
+# Usage:
+#   ./tools/slip_host/run_slip_host.sh               # test + bench
+#   ./tools/slip_host/run_slip_host.sh -t 1000 -s 20 # bench args: time per case, % END/ESC bytes
+#   TEST_ONLY=1 ./tools/slip_host/run_slip_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SRC_DIR="${HERE}/../../components/zb_host/src"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/zb-slip-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -Wall -Wextra}"
+
+mkdir -p "${BUILD_DIR}"
+INCS=(-I"${HERE}/../host" -I"${SRC_DIR}/priv" -I"${HERE}")
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} -fsanitize=address,undefined "${INCS[@]}" -o "${BUILD_DIR}/slip_host_test" \
+  "${HERE}/slip_host_test.c" "${SRC_DIR}/slip.c"
+"${BUILD_DIR}/slip_host_test"
+
+if [[ -n "${TEST_ONLY:-}" ]]; then
+  exit 0
+fi
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} "${INCS[@]}" -o "${BUILD_DIR}/slip_bench" \
+  "${HERE}/slip_bench.c" "${HERE}/slip_legacy.c" "${SRC_DIR}/slip.c"
+"${BUILD_DIR}/slip_bench" "$@"
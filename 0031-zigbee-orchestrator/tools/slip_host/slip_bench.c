@@ -0,0 +1,162 @@
+/*
+ * SLIP throughput: the streaming codec (components/zb_host/src/slip.c)
+ * against the StreamBuffer-based one it replaced (slip_legacy.c).
+ *
+ * Frames are random with END/ESC bytes at a configurable rate so escaping is
+ * exercised. Output is one JSON object per line (JSONL) on stdout.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "slip.h"
+#include "slip_legacy.h"
+
+#define MAX_FRAME 1024
+
+static uint32_t g_rng = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Keeps results observable so the loops are not optimized out. */
+static volatile uint32_t g_sink;
+
+static void report(const char *codec, const char *op, size_t frame_len, uint64_t frames, uint64_t bytes, int64_t us)
+{
+    printf("{\"codec\":\"%s\",\"op\":\"%s\",\"frame_len\":%zu,\"frames\":%" PRIu64 ","
+           "\"elapsed_us\":%" PRId64 ",\"frames_per_sec\":%.0f,\"mb_per_sec\":%.2f}\n",
+           codec, op, frame_len, frames, us, (double)frames * 1e6 / (double)us,
+           (double)bytes / (double)us);
+    fflush(stdout);
+}
+
+static void bench_len(size_t frame_len, int special_pct, int min_ms)
+{
+    enum { N = 64 };
+    static uint8_t frames[N][MAX_FRAME];
+    static uint8_t encoded[N][SLIP_ENCODED_MAX(MAX_FRAME)];
+    static size_t encoded_len[N];
+    static uint8_t out[SLIP_ENCODED_MAX(MAX_FRAME)];
+    uint64_t iters;
+    int64_t t0, t1;
+
+    for (int f = 0; f < N; f++) {
+        for (size_t i = 0; i < frame_len; i++) {
+            const uint32_t r = rng_next();
+            if ((int)(r % 100) < special_pct) {
+                frames[f][i] = (r & 0x100) ? SLIP_END : SLIP_ESC;
+            } else {
+                frames[f][i] = (uint8_t)(r >> 16);
+            }
+        }
+        slip_encode(frames[f], frame_len, encoded[f], sizeof(encoded[f]), &encoded_len[f]);
+    }
+
+    /* encode */
+    iters = 0;
+    t0 = now_us();
+    do {
+        for (int f = 0; f < N; f++) {
+            size_t n = 0;
+            slip_encode(frames[f], frame_len, out, sizeof(out), &n);
+            g_sink += (uint32_t)n + out[n / 2];
+        }
+        iters += N;
+        t1 = now_us();
+    } while (t1 - t0 < (int64_t)min_ms * 1000);
+    report("stream", "encode", frame_len, iters, iters * frame_len, t1 - t0);
+
+    iters = 0;
+    t0 = now_us();
+    do {
+        for (int f = 0; f < N; f++) {
+            uint8_t *o = NULL;
+            uint16_t n = 0;
+            legacy_slip_encode(frames[f], (uint16_t)frame_len, &o, &n);
+            g_sink += n + (o ? o[n / 2] : 0);
+            free(o);
+        }
+        iters += N;
+        t1 = now_us();
+    } while (t1 - t0 < (int64_t)min_ms * 1000);
+    report("legacy", "encode", frame_len, iters, iters * frame_len, t1 - t0);
+
+    /* decode: the streaming decoder is fed in 64-byte chunks like UART RX */
+    slip_decoder_t dec;
+    slip_decoder_init(&dec, out, sizeof(out));
+    iters = 0;
+    t0 = now_us();
+    do {
+        for (int f = 0; f < N; f++) {
+            const uint8_t *p = encoded[f];
+            size_t left = encoded_len[f];
+            while (left) {
+                size_t chunk = left < 64 ? left : 64;
+                while (chunk) {
+                    size_t pkt = 0;
+                    const size_t used = slip_decoder_feed(&dec, p, chunk, &pkt);
+                    p += used;
+                    left -= used;
+                    chunk -= used;
+                    g_sink += (uint32_t)pkt;
+                }
+            }
+        }
+        iters += N;
+        t1 = now_us();
+    } while (t1 - t0 < (int64_t)min_ms * 1000);
+    report("stream", "decode", frame_len, iters, iters * frame_len, t1 - t0);
+
+    iters = 0;
+    t0 = now_us();
+    do {
+        for (int f = 0; f < N; f++) {
+            uint8_t *o = NULL;
+            uint16_t n = 0;
+            legacy_slip_decode(encoded[f], (uint16_t)encoded_len[f], &o, &n);
+            g_sink += n + o[0];
+            free(o);
+        }
+        iters += N;
+        t1 = now_us();
+    } while (t1 - t0 < (int64_t)min_ms * 1000);
+    report("legacy", "decode", frame_len, iters, iters * frame_len, t1 - t0);
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t lens[] = {16, 64, 256, 1024};
+    int min_ms = 300;
+    int special_pct = 5;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-t")) {
+            min_ms = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-s")) {
+            special_pct = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: slip_bench [-t ms] [-s special_byte_percent]\n");
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        bench_len(lens[i], special_pct, min_ms);
+    }
+    return 0;
+}
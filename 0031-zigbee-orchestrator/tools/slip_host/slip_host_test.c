@@ -0,0 +1,211 @@
+/*
+ * Host unit test for the zb_host SLIP codec (components/zb_host/src/slip.c).
+ *
+ * Built and run by tools/slip_host/run_slip_host.sh. Exits non-zero on the
+ * first failure.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "slip.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+static uint32_t g_rng = 0x12345678u;
+
+static uint32_t rng_next(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+/* Random bytes with END/ESC much more frequent than 2/256. */
+static void fill_frame(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        const uint32_t r = rng_next();
+        switch (r & 7) {
+            case 0: buf[i] = SLIP_END; break;
+            case 1: buf[i] = SLIP_ESC; break;
+            default: buf[i] = (uint8_t)(r >> 8); break;
+        }
+    }
+}
+
+static void test_encode_known(void)
+{
+    const uint8_t in[] = {0x01, SLIP_END, 0x02, SLIP_ESC, 0x03};
+    const uint8_t want[] = {SLIP_END, 0x01, SLIP_ESC, SLIP_ESC_END, 0x02, SLIP_ESC, SLIP_ESC_ESC, 0x03, SLIP_END};
+    uint8_t out[32];
+    size_t n = 0;
+
+    CHECK(slip_encode(in, sizeof(in), out, sizeof(out), &n) == ESP_OK);
+    CHECK(n == sizeof(want));
+    CHECK(memcmp(out, want, n) == 0);
+
+    /* exact fit without worst-case headroom */
+    CHECK(slip_encode(in, sizeof(in), out, sizeof(want), &n) == ESP_OK);
+    CHECK(slip_encode(in, sizeof(in), out, sizeof(want) - 1, &n) == ESP_ERR_INVALID_SIZE);
+}
+
+static void test_roundtrip_random(void)
+{
+    uint8_t in[600];
+    uint8_t enc[SLIP_ENCODED_MAX(600)];
+    uint8_t dec[600];
+
+    for (int iter = 0; iter < 2000; iter++) {
+        const size_t len = 1 + rng_next() % sizeof(in);
+        size_t n = 0, m = 0;
+        fill_frame(in, len);
+        CHECK(slip_encode(in, len, enc, sizeof(enc), &n) == ESP_OK);
+        for (size_t i = 1; i + 1 < n; i++) {
+            CHECK(enc[i] != SLIP_END);
+        }
+        CHECK(slip_decode(enc, n, dec, sizeof(dec), &m) == ESP_OK);
+        CHECK(m == len);
+        CHECK(memcmp(in, dec, len) == 0);
+    }
+}
+
+/* A stream of frames split into random chunk sizes, as UART RX delivers it. */
+static void test_stream_chunked(void)
+{
+    enum { FRAMES = 300, MAX_LEN = 256 };
+    static uint8_t frames[FRAMES][MAX_LEN];
+    static size_t lens[FRAMES];
+    static uint8_t stream[FRAMES * (SLIP_ENCODED_MAX(MAX_LEN) + 1)];
+    uint8_t buf[MAX_LEN];
+    size_t stream_len = 0;
+
+    for (int f = 0; f < FRAMES; f++) {
+        size_t n = 0;
+        lens[f] = 1 + rng_next() % MAX_LEN;
+        fill_frame(frames[f], lens[f]);
+        CHECK(slip_encode(frames[f], lens[f], stream + stream_len, sizeof(stream) - stream_len, &n) == ESP_OK);
+        stream_len += n;
+        if (rng_next() & 1) {
+            stream[stream_len++] = SLIP_END; /* extra line-noise flush */
+        }
+    }
+
+    slip_decoder_t dec;
+    slip_decoder_init(&dec, buf, sizeof(buf));
+    int got = 0;
+    size_t pos = 0;
+    while (pos < stream_len) {
+        size_t chunk = 1 + rng_next() % 64;
+        if (chunk > stream_len - pos) {
+            chunk = stream_len - pos;
+        }
+        const uint8_t *p = stream + pos;
+        size_t left = chunk;
+        while (left) {
+            size_t pkt = 0;
+            const size_t used = slip_decoder_feed(&dec, p, left, &pkt);
+            CHECK(used > 0 && used <= left);
+            p += used;
+            left -= used;
+            if (pkt) {
+                CHECK(got < FRAMES);
+                CHECK(pkt == lens[got]);
+                CHECK(memcmp(buf, frames[got], pkt) == 0);
+                got++;
+            }
+        }
+        pos += chunk;
+    }
+    CHECK(got == FRAMES);
+    CHECK(dec.dropped == 0);
+}
+
+static void test_overflow_resync(void)
+{
+    uint8_t big[64], small[8] = {1, 2, SLIP_END, 4, 5, 6, 7, 8};
+    uint8_t stream[2 * (SLIP_ENCODED_MAX(64))];
+    uint8_t buf[16];
+    size_t n = 0, m = 0, pkt = 0;
+
+    memset(big, 0x55, sizeof(big));
+    CHECK(slip_encode(big, sizeof(big), stream, sizeof(stream), &n) == ESP_OK);
+    CHECK(slip_encode(small, sizeof(small), stream + n, sizeof(stream) - n, &m) == ESP_OK);
+
+    slip_decoder_t dec;
+    slip_decoder_init(&dec, buf, sizeof(buf));
+    const size_t used = slip_decoder_feed(&dec, stream, n + m, &pkt);
+    CHECK(pkt == sizeof(small));
+    CHECK(used == n + m);
+    CHECK(memcmp(buf, small, sizeof(small)) == 0);
+    CHECK(dec.dropped == 1);
+
+    CHECK(slip_decode(stream, n, buf, sizeof(buf), &m) == ESP_ERR_INVALID_SIZE);
+}
+
+static void test_edge_cases(void)
+{
+    uint8_t buf[8];
+    size_t n = 0;
+
+    /* only END bytes: no packet */
+    const uint8_t ends[] = {SLIP_END, SLIP_END, SLIP_END};
+    CHECK(slip_decode(ends, sizeof(ends), buf, sizeof(buf), &n) == ESP_ERR_NOT_FOUND);
+
+    /* unterminated packet stays pending */
+    const uint8_t open[] = {SLIP_END, 0x01, 0x02};
+    CHECK(slip_decode(open, sizeof(open), buf, sizeof(buf), &n) == ESP_ERR_NOT_FOUND);
+
+    /* protocol violation: ESC + other byte keeps the byte */
+    const uint8_t bad[] = {SLIP_ESC, 0x41, SLIP_END};
+    CHECK(slip_decode(bad, sizeof(bad), buf, sizeof(buf), &n) == ESP_OK);
+    CHECK(n == 1 && buf[0] == 0x41);
+
+    /* escape split across two feeds */
+    slip_decoder_t dec;
+    size_t pkt = 0;
+    const uint8_t a[] = {0x10, SLIP_ESC};
+    const uint8_t b[] = {SLIP_ESC_END, SLIP_END};
+    slip_decoder_init(&dec, buf, sizeof(buf));
+    CHECK(slip_decoder_feed(&dec, a, sizeof(a), &pkt) == sizeof(a) && pkt == 0);
+    CHECK(slip_decoder_feed(&dec, b, sizeof(b), &pkt) == sizeof(b) && pkt == 2);
+    CHECK(buf[0] == 0x10 && buf[1] == SLIP_END);
+
+    /* chunked encode matches one-shot encode */
+    const uint8_t in[] = {SLIP_END, 0x01, SLIP_ESC, 0x02};
+    uint8_t one[16], two[16];
+    size_t one_n = 0;
+    CHECK(slip_encode(in, sizeof(in), one, sizeof(one), &one_n) == ESP_OK);
+    size_t two_n = 0;
+    two[two_n++] = SLIP_END;
+    two_n += slip_encode_chunk(in, 2, two + two_n);
+    two_n += slip_encode_chunk(in + 2, 2, two + two_n);
+    two[two_n++] = SLIP_END;
+    CHECK(one_n == two_n && memcmp(one, two, one_n) == 0);
+}
+
+int main(void)
+{
+    test_encode_known();
+    test_roundtrip_random();
+    test_stream_chunked();
+    test_overflow_resync();
+    test_edge_cases();
+
+    if (g_failures) {
+        fprintf(stderr, "slip_host_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("slip_host_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * The StreamBuffer-based SLIP codec zb_host used before the streaming
+ * rewrite, kept for the throughput comparison in slip_bench.c.
+ *
+ * The encode/decode bodies are the original ones; the FreeRTOS StreamBuffer
+ * calls go to a minimal host ring below. The real StreamBuffer also enters a
+ * critical section per call, so on the device the legacy numbers are worse
+ * than what this host build shows.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_err.h"
+#include "slip_legacy.h"
+
+#define SLIP_END                0xC0
+#define SLIP_ESC                0xDB
+#define SLIP_ESC_END            0xDC
+#define SLIP_ESC_ESC            0xDD
+
+#define portTICK_PERIOD_MS 1
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t head;
+    size_t tail;
+    size_t used;
+} host_stream_t;
+
+typedef host_stream_t *StreamBufferHandle_t;
+
+static StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger)
+{
+    (void)trigger;
+    host_stream_t *s = calloc(1, sizeof(*s));
+    s->buf = malloc(size + 1);
+    s->cap = size + 1;
+    return s;
+}
+
+static void vStreamBufferDelete(StreamBufferHandle_t s)
+{
+    free(s->buf);
+    free(s);
+}
+
+static size_t xStreamBufferSend(StreamBufferHandle_t s, const void *data, size_t len, uint32_t ticks)
+{
+    (void)ticks;
+    const uint8_t *p = data;
+    size_t n = 0;
+    while (n < len && s->used < s->cap - 1) {
+        s->buf[s->head] = p[n++];
+        s->head = (s->head + 1) % s->cap;
+        s->used++;
+    }
+    return n;
+}
+
+static size_t xStreamBufferReceive(StreamBufferHandle_t s, void *data, size_t len, uint32_t ticks)
+{
+    (void)ticks;
+    uint8_t *p = data;
+    size_t n = 0;
+    while (n < len && s->used) {
+        p[n++] = s->buf[s->tail];
+        s->tail = (s->tail + 1) % s->cap;
+        s->used--;
+    }
+    return n;
+}
+
+static size_t xStreamBufferBytesAvailable(StreamBufferHandle_t s)
+{
+    return s->used;
+}
+
+esp_err_t legacy_slip_encode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen)
+{
+    char c = SLIP_END;
+    size_t buffer_size = (size_t)inlen * 2;
+    if (buffer_size == 0) {
+        buffer_size = 1;
+    }
+    const size_t trigger_level = buffer_size < 8 ? buffer_size : 8;
+    StreamBufferHandle_t stream_buffer = xStreamBufferCreate(buffer_size, trigger_level);
+    xStreamBufferSend(stream_buffer, &c, 1, 0);
+
+    while (inlen --) {
+        switch (*inbuf) {
+            case SLIP_END:
+                c = SLIP_ESC;
+                xStreamBufferSend(stream_buffer, &c, 1, 0);
+                c = SLIP_ESC_END;
+                xStreamBufferSend(stream_buffer, &c, 1, 0);
+                break;
+            case SLIP_ESC:
+                c = SLIP_ESC;
+                xStreamBufferSend(stream_buffer, &c, 1, 0);
+                c = SLIP_ESC_ESC;
+                xStreamBufferSend(stream_buffer, &c, 1, 0);
+                break;
+            default:
+                xStreamBufferSend(stream_buffer, inbuf, 1, 0);
+                break;
+        }
+        inbuf ++;
+    }
+
+    c = SLIP_END;
+    xStreamBufferSend(stream_buffer, &c, 1, 0);
+
+    *outlen = xStreamBufferBytesAvailable(stream_buffer);
+    if (*outlen) {
+        *outbuf = calloc(1, *outlen + 1);
+        xStreamBufferReceive(stream_buffer, *outbuf, *outlen, 100 / portTICK_PERIOD_MS);
+    }
+
+    vStreamBufferDelete(stream_buffer);
+
+    return ESP_OK;
+}
+
+esp_err_t legacy_slip_decode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen)
+{
+    char c = SLIP_END;
+    uint16_t received = 0;
+    uint8_t *output = calloc(1, inlen * 2);
+
+    const size_t buffer_size = inlen ? inlen : 1;
+    const size_t trigger_level = buffer_size < 8 ? buffer_size : 8;
+    StreamBufferHandle_t stream_buffer = xStreamBufferCreate(buffer_size, trigger_level);
+    xStreamBufferSend(stream_buffer, inbuf, inlen, 0);
+
+    while (1) {
+        xStreamBufferReceive(stream_buffer, &c, 1, 100 / portTICK_PERIOD_MS);
+        switch((uint8_t)c) {
+            case SLIP_END:
+                if (!xStreamBufferBytesAvailable(stream_buffer)) {
+                    goto slip_finish;
+                }
+                break;
+            case SLIP_ESC:
+                xStreamBufferReceive(stream_buffer, &c, 1, 100 / portTICK_PERIOD_MS);
+                switch((uint8_t)c) {
+                    case SLIP_ESC_END:
+                        c = SLIP_END;
+                        break;
+                    case SLIP_ESC_ESC:
+                        c = SLIP_ESC;
+                        break;
+                    default:
+                        break;
+                }
+                output[received ++] = c;
+                break;
+            default:
+                if (!xStreamBufferBytesAvailable(stream_buffer)) {
+                    goto slip_finish;
+                }
+                output[received ++] = c;
+                break;
+        }
+    }
+
+slip_finish:
+    vStreamBufferDelete(stream_buffer);
+    *outbuf = output;
+    *outlen = received;
+
+    return ESP_OK;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+esp_err_t legacy_slip_encode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen);
+esp_err_t legacy_slip_decode(const uint8_t *inbuf, uint16_t inlen, uint8_t **outbuf, uint16_t *outlen);
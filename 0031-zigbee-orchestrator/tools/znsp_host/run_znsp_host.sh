@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the zb_host pending-request (ZNSP pipelining) host test.
+#
+# esp_host_zb_pending.c is compiled against the pthread FreeRTOS stand-in in
+# tools/host/. The test prints JSONL timings for a serial vs pipelined fan-out.
+#
+# Usage:
+#   ./tools/znsp_host/run_znsp_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+COMP_DIR="${HERE}/../../components/zb_host"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/zb-znsp-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -Wall -Wextra}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} -fsanitize=thread -I"${HERE}/../host" -I"${COMP_DIR}/src/priv" -I"${COMP_DIR}/include" \
+  -o "${BUILD_DIR}/znsp_pending_test" \
+  "${HERE}/znsp_pending_test.c" "${HERE}/../host/freertos_host.c" "${COMP_DIR}/src/esp_host_zb_pending.c" -lpthread
+"${BUILD_DIR}/znsp_pending_test"
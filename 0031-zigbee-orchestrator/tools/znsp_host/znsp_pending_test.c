@@ -0,0 +1,303 @@
+/*
+ * Host test for the zb_host pending-request table
+ * (components/zb_host/src/esp_host_zb_pending.c).
+ *
+ * A fake NCP thread answers each request after a random delay, so replies
+ * come back out of order. The test checks that every caller gets its own
+ * reply, that late replies after a timeout are dropped, and compares an
+ * on/off-style fan-out sent one request at a time (what the old recursive
+ * lock forced) against the same fan-out pipelined.
+ *
+ * Built and run by tools/znsp_host/run_znsp_host.sh. Exits non-zero on failure.
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_host_zb_pending.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+/* ---- fake NCP ------------------------------------------------------- */
+
+#define NCP_QUEUE_MAX 64
+
+typedef struct {
+    uint8_t sn;
+    uint16_t id;
+    uint16_t reply_id;
+    uint32_t tag;
+    TickType_t due;
+} ncp_job_t;
+
+static pthread_mutex_t s_ncp_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_ncp_cv = PTHREAD_COND_INITIALIZER;
+static ncp_job_t s_ncp_jobs[NCP_QUEUE_MAX];
+static size_t s_ncp_n;
+static bool s_ncp_stop;
+static uint32_t s_rng = 0x9E3779B9u;
+
+static uint32_t ncp_delay_ms(uint32_t lo, uint32_t hi)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return lo + s_rng % (hi - lo + 1);
+}
+
+/* "UART TX": hand the request to the NCP, which answers after delay_ms. */
+static void ncp_send(esp_host_zb_req_t *req, uint16_t id, uint16_t reply_id, uint32_t tag, uint32_t delay_ms)
+{
+    pthread_mutex_lock(&s_ncp_mu);
+    s_ncp_jobs[s_ncp_n++] = (ncp_job_t){
+        .sn = esp_host_zb_pending_sn(req),
+        .id = id,
+        .reply_id = reply_id,
+        .tag = tag,
+        .due = xTaskGetTickCount() + delay_ms,
+    };
+    pthread_cond_signal(&s_ncp_cv);
+    pthread_mutex_unlock(&s_ncp_mu);
+}
+
+static void *ncp_thread(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&s_ncp_mu);
+    while (!s_ncp_stop) {
+        if (s_ncp_n == 0) {
+            pthread_cond_wait(&s_ncp_cv, &s_ncp_mu);
+            continue;
+        }
+        size_t next = 0;
+        for (size_t i = 1; i < s_ncp_n; i++) {
+            if ((int32_t)(s_ncp_jobs[i].due - s_ncp_jobs[next].due) < 0) {
+                next = i;
+            }
+        }
+        const TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(s_ncp_jobs[next].due - now) > 0) {
+            pthread_mutex_unlock(&s_ncp_mu);
+            usleep(500);
+            pthread_mutex_lock(&s_ncp_mu);
+            continue;
+        }
+        const ncp_job_t job = s_ncp_jobs[next];
+        s_ncp_jobs[next] = s_ncp_jobs[--s_ncp_n];
+        pthread_mutex_unlock(&s_ncp_mu);
+
+        /* "UART RX": the response carries the request's sn */
+        (void)esp_host_zb_pending_complete(job.sn, job.reply_id, &job.tag, sizeof(job.tag));
+
+        pthread_mutex_lock(&s_ncp_mu);
+    }
+    pthread_mutex_unlock(&s_ncp_mu);
+    return NULL;
+}
+
+/* ---- tests ---------------------------------------------------------- */
+
+#define FANOUT 8
+
+static uint32_t s_delays[FANOUT];
+
+/* One request at a time, as with the old lock around the round trip. */
+static void fanout_serial(uint32_t *elapsed_ms)
+{
+    const TickType_t t0 = xTaskGetTickCount();
+    for (uint32_t i = 0; i < FANOUT; i++) {
+        esp_host_zb_req_t *req = NULL;
+        uint32_t out = 0;
+        uint16_t outlen = 0;
+        CHECK(esp_host_zb_pending_begin(0x0107, &out, &outlen, portMAX_DELAY, &req) == ESP_OK);
+        ncp_send(req, 0x0107, 0x0107, 1000 + i, s_delays[i]);
+        CHECK(esp_host_zb_pending_wait(req, pdMS_TO_TICKS(3000)) == ESP_OK);
+        CHECK(out == 1000 + i && outlen == sizeof(out));
+    }
+    *elapsed_ms = xTaskGetTickCount() - t0;
+}
+
+static void fanout_pipelined(uint32_t *elapsed_ms)
+{
+    esp_host_zb_req_t *reqs[FANOUT];
+    uint32_t out[FANOUT] = {0};
+    uint16_t outlen[FANOUT] = {0};
+
+    const TickType_t t0 = xTaskGetTickCount();
+    for (uint32_t i = 0; i < FANOUT; i++) {
+        CHECK(esp_host_zb_pending_begin(0x0107, &out[i], &outlen[i], portMAX_DELAY, &reqs[i]) == ESP_OK);
+        ncp_send(reqs[i], 0x0107, 0x0107, 2000 + i, s_delays[i]);
+    }
+    for (uint32_t i = 0; i < FANOUT; i++) {
+        CHECK(esp_host_zb_pending_wait(reqs[i], pdMS_TO_TICKS(3000)) == ESP_OK);
+        CHECK(out[i] == 2000 + i && outlen[i] == sizeof(out[i]));
+    }
+    *elapsed_ms = xTaskGetTickCount() - t0;
+}
+
+static void test_fanout_speedup(void)
+{
+    uint32_t serial_ms = 0, pipelined_ms = 0, sum = 0;
+
+    for (int i = 0; i < FANOUT; i++) {
+        s_delays[i] = ncp_delay_ms(20, 60);
+        sum += s_delays[i];
+    }
+    fanout_serial(&serial_ms);
+    fanout_pipelined(&pipelined_ms);
+
+    printf("{\"test\":\"fanout\",\"requests\":%d,\"ncp_delay_sum_ms\":%u,\"serial_ms\":%u,\"pipelined_ms\":%u,\"speedup\":%.1f}\n",
+           FANOUT, (unsigned)sum, (unsigned)serial_ms, (unsigned)pipelined_ms,
+           pipelined_ms ? (double)serial_ms / (double)pipelined_ms : 0.0);
+    CHECK(serial_ms >= sum);
+    CHECK(pipelined_ms * 3 < serial_ms);
+}
+
+typedef struct {
+    uint32_t base;
+    int failures;
+} worker_arg_t;
+
+/* Several tasks sharing the table, each with its own pipelined batch. */
+static void *worker(void *p)
+{
+    worker_arg_t *w = (worker_arg_t *)p;
+    for (int round = 0; round < 20; round++) {
+        esp_host_zb_req_t *reqs[2];
+        uint32_t out[2] = {0};
+        uint16_t outlen[2] = {0};
+        for (int i = 0; i < 2; i++) {
+            if (esp_host_zb_pending_begin(0x0102, &out[i], &outlen[i], portMAX_DELAY, &reqs[i]) != ESP_OK) {
+                w->failures++;
+                return NULL;
+            }
+            ncp_send(reqs[i], 0x0102, 0x0102, w->base + round * 2 + i, 1 + (round * 3 + i * 5) % 8);
+        }
+        for (int i = 0; i < 2; i++) {
+            if (esp_host_zb_pending_wait(reqs[i], pdMS_TO_TICKS(3000)) != ESP_OK ||
+                out[i] != w->base + round * 2 + (uint32_t)i) {
+                w->failures++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_tasks(void)
+{
+    pthread_t th[4];
+    worker_arg_t args[4];
+    for (int i = 0; i < 4; i++) {
+        args[i] = (worker_arg_t){.base = 100000u * (i + 1)};
+        pthread_create(&th[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(th[i], NULL);
+        CHECK(args[i].failures == 0);
+    }
+}
+
+static void test_timeout_and_late_reply(void)
+{
+    esp_host_zb_pending_stats_t st0, st1;
+    esp_host_zb_req_t *req = NULL;
+    uint32_t out = 0;
+    uint16_t outlen = 0;
+
+    esp_host_zb_pending_get_stats(&st0);
+    CHECK(esp_host_zb_pending_begin(0x0005, &out, &outlen, portMAX_DELAY, &req) == ESP_OK);
+    ncp_send(req, 0x0005, 0x0005, 0xdead, 80);
+    CHECK(esp_host_zb_pending_wait(req, pdMS_TO_TICKS(10)) == ESP_ERR_TIMEOUT);
+
+    /* the next request must not receive the late reply */
+    uint32_t out2 = 0;
+    uint16_t outlen2 = 0;
+    CHECK(esp_host_zb_pending_begin(0x0005, &out2, &outlen2, portMAX_DELAY, &req) == ESP_OK);
+    ncp_send(req, 0x0005, 0x0005, 0xbeef, 150);
+    CHECK(esp_host_zb_pending_wait(req, pdMS_TO_TICKS(3000)) == ESP_OK);
+    CHECK(out2 == 0xbeef);
+    CHECK(out == 0);
+
+    esp_host_zb_pending_get_stats(&st1);
+    CHECK(st1.timeouts == st0.timeouts + 1);
+    CHECK(st1.unmatched == st0.unmatched + 1);
+}
+
+static void test_id_mismatch(void)
+{
+    esp_host_zb_req_t *req = NULL;
+    uint32_t out = 0;
+    uint16_t outlen = 0;
+
+    CHECK(esp_host_zb_pending_begin(0x0010, &out, &outlen, portMAX_DELAY, &req) == ESP_OK);
+    ncp_send(req, 0x0010, 0x0011, 7, 1);
+    CHECK(esp_host_zb_pending_wait(req, pdMS_TO_TICKS(3000)) == ESP_FAIL);
+    CHECK(out == 0);
+}
+
+static void test_sn_wraps_without_collision(void)
+{
+    /* hold one request across a full wrap of the 8-bit sn */
+    esp_host_zb_req_t *held = NULL;
+    CHECK(esp_host_zb_pending_begin(0x0001, NULL, NULL, portMAX_DELAY, &held) == ESP_OK);
+    const uint8_t held_sn = esp_host_zb_pending_sn(held);
+    for (int i = 0; i < 300; i++) {
+        esp_host_zb_req_t *req = NULL;
+        CHECK(esp_host_zb_pending_begin(0x0001, NULL, NULL, portMAX_DELAY, &req) == ESP_OK);
+        CHECK(esp_host_zb_pending_sn(req) != held_sn);
+        CHECK(esp_host_zb_pending_wait(req, 0) == ESP_ERR_TIMEOUT);
+    }
+    CHECK(esp_host_zb_pending_wait(held, 0) == ESP_ERR_TIMEOUT);
+}
+
+int main(void)
+{
+    pthread_t ncp;
+
+    if (esp_host_zb_pending_init() != ESP_OK) {
+        fprintf(stderr, "pending init failed\n");
+        return 1;
+    }
+    pthread_create(&ncp, NULL, ncp_thread, NULL);
+
+    test_fanout_speedup();
+    test_concurrent_tasks();
+    test_timeout_and_late_reply();
+    test_id_mismatch();
+    test_sn_wraps_without_collision();
+
+    esp_host_zb_pending_stats_t st;
+    esp_host_zb_pending_get_stats(&st);
+    printf("{\"test\":\"stats\",\"sent\":%u,\"completed\":%u,\"timeouts\":%u,\"unmatched\":%u,\"inflight\":%u,\"inflight_max\":%u}\n",
+           (unsigned)st.sent, (unsigned)st.completed, (unsigned)st.timeouts, (unsigned)st.unmatched,
+           (unsigned)st.inflight, (unsigned)st.inflight_max);
+    if (st.inflight != 0) {
+        g_failures++;
+    }
+
+    pthread_mutex_lock(&s_ncp_mu);
+    s_ncp_stop = true;
+    pthread_cond_signal(&s_ncp_cv);
+    pthread_mutex_unlock(&s_ncp_mu);
+    pthread_join(ncp, NULL);
+
+    if (g_failures) {
+        fprintf(stderr, "znsp_pending_test: %d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("znsp_pending_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "font5x7.h"
+
+static char font5x7_upper(char c) {
+    if (c >= 'a' && c <= 'z') return (char)(c - ('a' - 'A'));
+    return c;
+}
+
+static const uint8_t s_font5x7[59][5] = {
+    [' ' - 32] = {0x00, 0x00, 0x00, 0x00, 0x00},
+
+    ['0' - 32] = {0x3E, 0x51, 0x49, 0x45, 0x3E},
+    ['1' - 32] = {0x00, 0x42, 0x7F, 0x40, 0x00},
+    ['2' - 32] = {0x42, 0x61, 0x51, 0x49, 0x46},
+    ['3' - 32] = {0x21, 0x41, 0x45, 0x4B, 0x31},
+    ['4' - 32] = {0x18, 0x14, 0x12, 0x7F, 0x10},
+    ['5' - 32] = {0x27, 0x45, 0x45, 0x45, 0x39},
+    ['6' - 32] = {0x3C, 0x4A, 0x49, 0x49, 0x30},
+    ['7' - 32] = {0x01, 0x71, 0x09, 0x05, 0x03},
+    ['8' - 32] = {0x36, 0x49, 0x49, 0x49, 0x36},
+    ['9' - 32] = {0x06, 0x49, 0x49, 0x29, 0x1E},
+
+    ['A' - 32] = {0x7C, 0x12, 0x11, 0x12, 0x7C},
+    ['B' - 32] = {0x7F, 0x49, 0x49, 0x49, 0x36},
+    ['C' - 32] = {0x3E, 0x41, 0x41, 0x41, 0x22},
+    ['D' - 32] = {0x7F, 0x41, 0x41, 0x22, 0x1C},
+    ['E' - 32] = {0x7F, 0x49, 0x49, 0x49, 0x41},
+    ['F' - 32] = {0x7F, 0x09, 0x09, 0x09, 0x01},
+    ['G' - 32] = {0x3E, 0x41, 0x49, 0x49, 0x7A},
+    ['H' - 32] = {0x7F, 0x08, 0x08, 0x08, 0x7F},
+    ['I' - 32] = {0x00, 0x41, 0x7F, 0x41, 0x00},
+    ['J' - 32] = {0x20, 0x40, 0x41, 0x3F, 0x01},
+    ['K' - 32] = {0x7F, 0x08, 0x14, 0x22, 0x41},
+    ['L' - 32] = {0x7F, 0x40, 0x40, 0x40, 0x40},
+    ['M' - 32] = {0x7F, 0x02, 0x0C, 0x02, 0x7F},
+    ['N' - 32] = {0x7F, 0x04, 0x08, 0x10, 0x7F},
+    ['O' - 32] = {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    ['P' - 32] = {0x7F, 0x09, 0x09, 0x09, 0x06},
+    ['Q' - 32] = {0x3E, 0x41, 0x51, 0x21, 0x5E},
+    ['R' - 32] = {0x7F, 0x09, 0x19, 0x29, 0x46},
+    ['S' - 32] = {0x46, 0x49, 0x49, 0x49, 0x31},
+    ['T' - 32] = {0x01, 0x01, 0x7F, 0x01, 0x01},
+    ['U' - 32] = {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    ['V' - 32] = {0x1F, 0x20, 0x40, 0x20, 0x1F},
+    ['W' - 32] = {0x3F, 0x40, 0x38, 0x40, 0x3F},
+    ['X' - 32] = {0x63, 0x14, 0x08, 0x14, 0x63},
+    ['Y' - 32] = {0x07, 0x08, 0x70, 0x08, 0x07},
+    ['Z' - 32] = {0x61, 0x51, 0x49, 0x45, 0x43},
+};
+
+bool font5x7_supported(char c) {
+    c = font5x7_upper(c);
+    if (c == ' ') return true;
+    if (c >= '0' && c <= '9') return true;
+    if (c >= 'A' && c <= 'Z') return true;
+    return false;
+}
+
+const uint8_t *font5x7_get_cols(char c) {
+    c = font5x7_upper(c);
+    if (c < 32 || c > 90) c = ' ';
+    return s_font5x7[c - 32];
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 5x7 font, column-major: 5 bytes per glyph, LSB = top row. Glyphs: space, 0-9, A-Z (lowercase is
+// folded to uppercase). Text renderers lay glyphs out in 6-column cells (5 columns + 1 blank).
+#define FONT5X7_COLS 5
+#define FONT5X7_CELL 6
+
+// True for the characters that have a glyph (after uppercasing). Renderers draw anything else as a space.
+bool font5x7_supported(char c);
+
+// Glyph columns for c; characters outside ' '..'Z' return the blank glyph.
+const uint8_t *font5x7_get_cols(char c);
@@ -9,6 +9,8 @@
 #include "esp_console.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_vfs_fat.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
@@ -18,7 +20,9 @@
 #include "driver/gpio.h"
 #include "driver/i2c_master.h"
 
+#include "font5x7.h"
 #include "max7219.h"
+#include "scroll_gen.h"
 #include "tca8418.h"
 
 static const char *TAG = "matrix_console";
@@ -33,7 +37,24 @@ static int s_chain_len_cfg = MAX7219_DEFAULT_CHAIN_LEN;
 
 static uint8_t s_fb[8][MAX7219_MAX_CHAIN_LEN] = {0};
 
+// What the chain currently shows, in physical row/module order (after flipv/reverse). fb_flush_all()
+// only sends rows that differ from it; cleared to "unknown" when a write fails.
+static uint8_t s_fb_shown[8][MAX7219_MAX_CHAIN_LEN] = {0};
+static bool s_fb_shown_valid = false;
+
+typedef struct {
+    uint32_t flushes;      // frames flushed, including ones with nothing to send
+    uint32_t rows_sent;
+    uint32_t rows_skipped; // unchanged rows not sent
+    uint32_t last_us;      // last flush that sent rows
+    uint32_t max_us;
+    uint64_t sum_us;
+} fb_flush_stats_t;
+
+static fb_flush_stats_t s_fb_stats;
+
 static esp_err_t fb_flush_all(void);
+static void fb_shown_reset(void);
 static void stop_animations(void);
 static void try_autoinit(void);
 static int x_to_module(int x);
@@ -97,8 +118,8 @@ static bool s_scroll_enabled = false;
 static bool s_scroll_wave = false;
 static uint32_t s_scroll_fps = 15;
 static uint32_t s_scroll_pause_ms = 250;
-static uint8_t *s_scroll_text_cols;
-static int s_scroll_text_w = 0;
+static scroll_gen_t s_scroll_gen; // pre-rendered text (or file stream); guarded by s_scroll_mu
+static bool s_scroll_have_text = false;
 static bool s_scroll_restart = false;
 static uint8_t s_scroll_saved_fb[8][MAX7219_MAX_CHAIN_LEN] = {0};
 static bool s_scroll_have_saved_fb = false;
@@ -300,6 +321,9 @@ static void kbd_ensure_task(void) {
     xTaskCreate(&kbd_task, "kbd", 4096, NULL, 3, &s_kbd_task);
 }
 
+#define SCROLL_STORAGE_PARTITION "storage"
+#define SCROLL_STORAGE_MOUNT "/storage"
+
 static void print_matrix_help(void) {
     printf("matrix commands:\n");
     printf("  matrix init\n");
@@ -310,6 +334,7 @@ static void print_matrix_help(void) {
     printf("  matrix chain [n]                              (get/set chained modules, max %d)\n", MAX7219_MAX_CHAIN_LEN);
     printf("  matrix text <TEXT>                            (renders 1 char per module)\n");
     printf("  matrix scroll on <TEXT> [fps] [pause_ms]      (smooth 1px scroll; A-Z 0-9 space)\n");
+    printf("  matrix scroll on @<FILE> [fps] [pause_ms]     (stream a text file from %s; also: wave)\n", SCROLL_STORAGE_MOUNT);
 	printf("  matrix scroll wave <TEXT> [fps] [pause_ms]    (scroll + wave)\n");
 	printf("  matrix scroll off\n");
 	printf("  matrix scroll status\n");
@@ -321,7 +346,9 @@ static void print_matrix_help(void) {
 	printf("  matrix anim off\n");
     printf("  matrix anim status\n");
     printf("  matrix intensity <0..15>\n");
-    printf("  matrix spi [hz]                               (get/set SPI clock; default is compile-time)\n");
+    printf("  matrix spi [hz]                               (get/set SPI clock, up to %d; default is Kconfig)\n", MAX7219_SPI_HZ_MAX);
+    printf("  matrix stats [reset]                          (flush counters: rows sent vs unchanged rows skipped)\n");
+    printf("  matrix bench [frames]                         (max fps with all 8 / 1 row(s) changing per frame)\n");
     printf("  matrix reverse on|off\n");
     printf("  matrix flipv on|off                           (flip vertically; fixes upside-down glyphs)\n");
     printf("  matrix row <0..7> <0x00..0xff>                 (sets this row on all modules)\n");
@@ -341,17 +368,18 @@ static void fb_clear(void) {
     memset(s_fb, 0, sizeof(s_fb));
 }
 
-static void fb_from_cols(const uint8_t *cols, int width) {
+// Column-major strip (bit y of cols[x] = pixel (x,y)) -> row-major framebuffer `out`.
+static void fb_render_cols(uint8_t out[8][MAX7219_MAX_CHAIN_LEN], const uint8_t *cols, int width) {
+    memset(out, 0, 8 * MAX7219_MAX_CHAIN_LEN);
     if (!cols) return;
     if (width <= 0) return;
     if (width > (8 * MAX7219_MAX_CHAIN_LEN)) width = 8 * MAX7219_MAX_CHAIN_LEN;
-    fb_clear();
     for (int x = 0; x < width; x++) {
         const int module = x_to_module(x);
         const uint8_t mask = x_to_bit(x);
         const uint8_t col = cols[x];
         for (int y = 0; y < 8; y++) {
-            if (col & (uint8_t)(1u << y)) s_fb[y][module] |= mask;
+            if (col & (uint8_t)(1u << y)) out[y][module] |= mask;
         }
     }
 }
@@ -370,70 +398,6 @@ static char ascii_upper(char c) {
     return c;
 }
 
-static const int8_t s_wave16[16] = {0, 1, 2, 1, 0, -1, -2, -1, 0, 1, 2, 1, 0, -1, -2, -1};
-
-static uint8_t col_shift_y(uint8_t bits, int8_t y_offset) {
-    if (y_offset > 0) {
-        if (y_offset > 7) y_offset = 7;
-        return (uint8_t)(bits << y_offset);
-    }
-    if (y_offset < 0) {
-        int s = -y_offset;
-        if (s > 7) s = 7;
-        return (uint8_t)(bits >> s);
-    }
-    return bits;
-}
-
-// 5x7 font, column-major: 5 bytes per glyph, LSB = top row.
-static const uint8_t s_font5x7[59][5] = {
-    [' ' - 32] = {0x00, 0x00, 0x00, 0x00, 0x00},
-
-    ['0' - 32] = {0x3E, 0x51, 0x49, 0x45, 0x3E},
-    ['1' - 32] = {0x00, 0x42, 0x7F, 0x40, 0x00},
-    ['2' - 32] = {0x42, 0x61, 0x51, 0x49, 0x46},
-    ['3' - 32] = {0x21, 0x41, 0x45, 0x4B, 0x31},
-    ['4' - 32] = {0x18, 0x14, 0x12, 0x7F, 0x10},
-    ['5' - 32] = {0x27, 0x45, 0x45, 0x45, 0x39},
-    ['6' - 32] = {0x3C, 0x4A, 0x49, 0x49, 0x30},
-    ['7' - 32] = {0x01, 0x71, 0x09, 0x05, 0x03},
-    ['8' - 32] = {0x36, 0x49, 0x49, 0x49, 0x36},
-    ['9' - 32] = {0x06, 0x49, 0x49, 0x29, 0x1E},
-
-    ['A' - 32] = {0x7C, 0x12, 0x11, 0x12, 0x7C},
-    ['B' - 32] = {0x7F, 0x49, 0x49, 0x49, 0x36},
-    ['C' - 32] = {0x3E, 0x41, 0x41, 0x41, 0x22},
-    ['D' - 32] = {0x7F, 0x41, 0x41, 0x22, 0x1C},
-    ['E' - 32] = {0x7F, 0x49, 0x49, 0x49, 0x41},
-    ['F' - 32] = {0x7F, 0x09, 0x09, 0x09, 0x01},
-    ['G' - 32] = {0x3E, 0x41, 0x49, 0x49, 0x7A},
-    ['H' - 32] = {0x7F, 0x08, 0x08, 0x08, 0x7F},
-    ['I' - 32] = {0x00, 0x41, 0x7F, 0x41, 0x00},
-    ['J' - 32] = {0x20, 0x40, 0x41, 0x3F, 0x01},
-    ['K' - 32] = {0x7F, 0x08, 0x14, 0x22, 0x41},
-    ['L' - 32] = {0x7F, 0x40, 0x40, 0x40, 0x40},
-    ['M' - 32] = {0x7F, 0x02, 0x0C, 0x02, 0x7F},
-    ['N' - 32] = {0x7F, 0x04, 0x08, 0x10, 0x7F},
-    ['O' - 32] = {0x3E, 0x41, 0x41, 0x41, 0x3E},
-    ['P' - 32] = {0x7F, 0x09, 0x09, 0x09, 0x06},
-    ['Q' - 32] = {0x3E, 0x41, 0x51, 0x21, 0x5E},
-    ['R' - 32] = {0x7F, 0x09, 0x19, 0x29, 0x46},
-    ['S' - 32] = {0x46, 0x49, 0x49, 0x49, 0x31},
-    ['T' - 32] = {0x01, 0x01, 0x7F, 0x01, 0x01},
-    ['U' - 32] = {0x3F, 0x40, 0x40, 0x40, 0x3F},
-    ['V' - 32] = {0x1F, 0x20, 0x40, 0x20, 0x1F},
-    ['W' - 32] = {0x3F, 0x40, 0x38, 0x40, 0x3F},
-    ['X' - 32] = {0x63, 0x14, 0x08, 0x14, 0x63},
-    ['Y' - 32] = {0x07, 0x08, 0x70, 0x08, 0x07},
-    ['Z' - 32] = {0x61, 0x51, 0x49, 0x45, 0x43},
-};
-
-static const uint8_t *font5x7_get_cols(char c) {
-    c = ascii_upper(c);
-    if (c < 32 || c > 90) c = ' ';
-    return s_font5x7[c - 32];
-}
-
 static void render_char_8x8_rows(char c, uint8_t out_rows[8]) {
     memset(out_rows, 0, 8);
     const uint8_t *cols = font5x7_get_cols(c);
@@ -646,30 +610,78 @@ static uint8_t x_to_bit(int x) {
     return (uint8_t)(1u << (x % 8));
 }
 
-static esp_err_t fb_flush_row(int y) {
-    if (y < 0 || y >= 8) return ESP_ERR_INVALID_ARG;
+// The chain was just cleared (max7219_init/max7219_clear): every row is known to be zero.
+static void fb_shown_reset(void) {
+    matrix_lock();
+    memset(s_fb_shown, 0, sizeof(s_fb_shown));
+    s_fb_shown_valid = true;
+    matrix_unlock();
+}
 
-    const int phy_row = s_flip_vertical ? (7 - y) : y;
+// Caller holds the matrix lock. Maps s_fb to physical rows, then queues only the rows that differ
+// from s_fb_shown in one max7219_set_rows_chain() call.
+static esp_err_t fb_flush_locked(void) {
+    if (!s_matrix_ready) return ESP_ERR_INVALID_STATE;
 
-    matrix_lock();
     const int n = chain_len_active();
-    uint8_t phy[MAX7219_MAX_CHAIN_LEN] = {0};
-    for (int m = 0; m < n && m < MAX7219_MAX_CHAIN_LEN; m++) {
-        const int src = s_reverse_modules ? ((n - 1) - m) : m;
-        phy[m] = s_fb[y][src];
+    uint8_t phy[8][MAX7219_MAX_CHAIN_LEN] = {{0}};
+    uint8_t dirty = 0;
+    for (int y = 0; y < 8; y++) {
+        const int phy_row = s_flip_vertical ? (7 - y) : y;
+        for (int m = 0; m < n && m < MAX7219_MAX_CHAIN_LEN; m++) {
+            const int src = s_reverse_modules ? ((n - 1) - m) : m;
+            phy[phy_row][m] = s_fb[y][src];
+        }
+        if (!s_fb_shown_valid || memcmp(phy[phy_row], s_fb_shown[phy_row], (size_t)n) != 0) {
+            dirty |= (uint8_t)(1u << phy_row);
+        }
     }
 
-    esp_err_t err = max7219_set_row_chain(&s_matrix, (uint8_t)phy_row, phy);
+    const int sent = __builtin_popcount(dirty);
+    s_fb_stats.flushes++;
+    s_fb_stats.rows_sent += (uint32_t)sent;
+    s_fb_stats.rows_skipped += (uint32_t)(8 - sent);
+    if (!dirty) return ESP_OK;
+
+    const int64_t t0 = esp_timer_get_time();
+    esp_err_t err = max7219_set_rows_chain(&s_matrix, phy, dirty);
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    s_fb_stats.last_us = us;
+    s_fb_stats.sum_us += us;
+    if (us > s_fb_stats.max_us) s_fb_stats.max_us = us;
+
+    if (err != ESP_OK) {
+        s_fb_shown_valid = false;
+        return err;
+    }
+    for (int r = 0; r < 8; r++) {
+        if (dirty & (1u << r)) memcpy(s_fb_shown[r], phy[r], sizeof(s_fb_shown[r]));
+    }
+    s_fb_shown_valid = true;
+    return ESP_OK;
+}
+
+static esp_err_t fb_flush_all(void) {
+    matrix_lock();
+    esp_err_t err = fb_flush_locked();
     matrix_unlock();
     return err;
 }
 
-static esp_err_t fb_flush_all(void) {
-    for (int y = 0; y < 8; y++) {
-        esp_err_t err = fb_flush_row(y);
-        if (err != ESP_OK) return err;
-    }
-    return ESP_OK;
+// Publishes a frame rendered off-lock by an animation task: copy + flush happen under one lock hold,
+// so console writers and other tasks never see (or send) a half-updated frame.
+static esp_err_t fb_present(const uint8_t back[8][MAX7219_MAX_CHAIN_LEN]) {
+    matrix_lock();
+    memcpy(s_fb, back, sizeof(s_fb));
+    esp_err_t err = fb_flush_locked();
+    matrix_unlock();
+    return err;
+}
+
+static esp_err_t fb_present_cols(const uint8_t *cols, int width) {
+    uint8_t back[8][MAX7219_MAX_CHAIN_LEN];
+    fb_render_cols(back, cols, width);
+    return fb_present(back);
 }
 
 static void blink_task(void *arg) {
@@ -692,18 +704,12 @@ static void blink_task(void *arg) {
             }
         }
 
-        matrix_lock();
-        memcpy(s_fb, ones, sizeof(s_fb));
-        matrix_unlock();
-        (void)fb_flush_all();
+        (void)fb_present(ones);
         vTaskDelay(pdMS_TO_TICKS(s_blink_on_ms));
 
         if (!s_blink_enabled) continue;
 
-        matrix_lock();
-        memcpy(s_fb, zeros, sizeof(s_fb));
-        matrix_unlock();
-        (void)fb_flush_all();
+        (void)fb_present(zeros);
         vTaskDelay(pdMS_TO_TICKS(s_blink_off_ms));
     }
 }
@@ -734,10 +740,7 @@ static void blink_on(uint32_t on_ms, uint32_t off_ms) {
 static void blink_off(void) {
     s_blink_enabled = false;
     if (s_blink_have_saved_fb) {
-        matrix_lock();
-        memcpy(s_fb, s_blink_saved_fb, sizeof(s_fb));
-        matrix_unlock();
-        (void)fb_flush_all();
+        (void)fb_present(s_blink_saved_fb);
         s_blink_have_saved_fb = false;
     }
     if (s_blink_task) {
@@ -764,7 +767,7 @@ static void scroll_task(void *arg) {
 
         const uint32_t frame_ms = 1000u / fps;
         const int width = fb_width();
-        int pos = width;
+        int64_t pos = width;
         for (;;) {
             if (!s_scroll_enabled) break;
 
@@ -779,36 +782,20 @@ static void scroll_task(void *arg) {
                 }
             }
 
-            uint8_t cols[8 * MAX7219_MAX_CHAIN_LEN] = {0};
-            int text_w_snapshot = 0;
+            uint8_t back[8][MAX7219_MAX_CHAIN_LEN] = {{0}};
             scroll_lock();
-            const uint8_t *text_cols = s_scroll_text_cols;
-            const int text_w = s_scroll_text_w;
-            const bool wave = s_scroll_wave;
-            text_w_snapshot = text_w;
-            for (int x = 0; x < width; x++) {
-                const int t = x - pos;
-                if (t >= 0 && t < text_w && text_cols) {
-                    uint8_t bits = text_cols[t];
-                    if (wave) {
-                        const int char_idx = t / 6;
-                        const int8_t yoff = s_wave16[(int)((frame + (uint32_t)(char_idx * 2)) & 0x0F)];
-                        bits = col_shift_y(bits, yoff);
-                    }
-                    cols[x] = bits;
-                }
-            }
+            // -1 while a file stream hasn't hit its end yet: keep scrolling.
+            const int64_t text_w = s_scroll_have_text ? scroll_gen_width(&s_scroll_gen) : 0;
+            scroll_gen_frame(s_scroll_have_text ? &s_scroll_gen : NULL, pos, width, s_scroll_wave, frame, &back[0][0],
+                             sizeof(back[0]));
             scroll_unlock();
 
-            matrix_lock();
-            fb_from_cols(cols, width);
-            matrix_unlock();
-            (void)fb_flush_all();
+            (void)fb_present(back);
 
             vTaskDelay(pdMS_TO_TICKS(frame_ms));
             pos--;
             frame++;
-            if (pos < -text_w_snapshot) {
+            if (text_w >= 0 && pos < -text_w) {
                 pos = width;
                 pause_ms = s_scroll_pause_ms;
                 if (pause_ms) vTaskDelay(pdMS_TO_TICKS(pause_ms));
@@ -823,9 +810,8 @@ static void scroll_ensure_task(void) {
 }
 
 static void scroll_free_text_locked(void) {
-    if (s_scroll_text_cols) free(s_scroll_text_cols);
-    s_scroll_text_cols = NULL;
-    s_scroll_text_w = 0;
+    if (s_scroll_have_text) scroll_gen_free(&s_scroll_gen);
+    s_scroll_have_text = false;
 }
 
 static void scroll_free_text(void) {
@@ -834,14 +820,6 @@ static void scroll_free_text(void) {
     scroll_unlock();
 }
 
-static bool char_supported_for_scroll(char c) {
-    c = ascii_upper(c);
-    if (c == ' ') return true;
-    if (c >= '0' && c <= '9') return true;
-    if (c >= 'A' && c <= 'Z') return true;
-    return false;
-}
-
 static void render_text_centered_cols(uint8_t *out_cols,
                                      int width,
                                      const char *text,
@@ -861,7 +839,7 @@ static void render_text_centered_cols(uint8_t *out_cols,
 
     for (int i = 0; i < text_len; i++) {
         char c = ascii_upper(text[i]);
-        if (!char_supported_for_scroll(c)) c = ' ';
+        if (!font5x7_supported(c)) c = ' ';
         const uint8_t *g = font5x7_get_cols(c);
         const int8_t yoff = y_offsets ? y_offsets[i] : 0;
         const int base_x = start_x + i * cell;
@@ -1009,7 +987,7 @@ static void render_text_centered_cols_scaled_x(uint8_t *out_cols,
 
     for (int i = 0; i < text_len; i++) {
         char c = ascii_upper(text[i]);
-        if (!char_supported_for_scroll(c)) c = ' ';
+        if (!font5x7_supported(c)) c = ' ';
         const uint8_t *g = font5x7_get_cols(c);
 
         uint16_t sx = 256;
@@ -1042,7 +1020,7 @@ static int flipboard_set_texts(const char *spec) {
     for (size_t i = 0; i < n; i++) {
         if (s_flipboard_buf[i] == '|') continue;
         char c = ascii_upper(s_flipboard_buf[i]);
-        if (!char_supported_for_scroll(c)) c = ' ';
+        if (!font5x7_supported(c)) c = ' ';
         s_flipboard_buf[i] = c;
     }
 
@@ -1066,6 +1044,36 @@ static int flipboard_set_texts(const char *spec) {
     return s_flipboard_count;
 }
 
+static bool s_storage_mounted = false;
+
+// The storage partition holds a prebuilt FATFS image (fatfsgen.py), so mount it read-only without
+// wear levelling.
+static esp_err_t scroll_storage_mount(void) {
+    if (s_storage_mounted) return ESP_OK;
+    const esp_vfs_fat_mount_config_t mount_config = {
+        .format_if_mount_failed = false,
+        .max_files = 2,
+        .allocation_unit_size = 0,
+        .disk_status_check_enable = false,
+        .use_one_fat = false,
+    };
+    esp_err_t err = esp_vfs_fat_spiflash_mount_ro(SCROLL_STORAGE_MOUNT, SCROLL_STORAGE_PARTITION, &mount_config);
+    if (err != ESP_OK) return err;
+    s_storage_mounted = true;
+    return ESP_OK;
+}
+
+// Takes ownership of *gen and restarts the scroll with it.
+static void scroll_install_gen(scroll_gen_t *gen) {
+    scroll_lock();
+    scroll_free_text_locked();
+    s_scroll_gen = *gen;
+    s_scroll_have_text = true;
+    s_scroll_restart = true;
+    scroll_unlock();
+    if (s_scroll_task) xTaskNotifyGive(s_scroll_task);
+}
+
 static void scroll_set_text(const char *text) {
     if (!text) {
         scroll_lock();
@@ -1081,29 +1089,38 @@ static void scroll_set_text(const char *text) {
         scroll_unlock();
         return;
     }
-    if (len > 128) len = 128;
 
-    const int cell = 6; // 5 cols + 1 spacing
-    const int w = (int)(len * (size_t)cell);
-    uint8_t *cols = (uint8_t *)calloc((size_t)w, 1);
-    if (!cols) return;
+    scroll_gen_t gen;
+    if (!scroll_gen_init_text(&gen, text, len)) return;
+    scroll_install_gen(&gen);
+}
 
-    int x = 0;
-    for (size_t i = 0; i < len; i++) {
-        char c = ascii_upper(text[i]);
-        if (!char_supported_for_scroll(c)) c = ' ';
-        const uint8_t *g = font5x7_get_cols(c);
-        for (int col = 0; col < 5; col++) cols[x++] = g[col];
-        cols[x++] = 0x00;
+// Streams a text file (e.g. on the storage partition) instead of holding it in RAM, so its length
+// is unbounded. Relative paths are looked up under SCROLL_STORAGE_MOUNT.
+static bool scroll_set_file(const char *path) {
+    if (!path || path[0] == '\0') return false;
+    esp_err_t err = scroll_storage_mount();
+    if (err != ESP_OK) {
+        printf("scroll: storage mount failed: %s\n", esp_err_to_name(err));
+        return false;
     }
 
-    scroll_lock();
-    scroll_free_text_locked();
-    s_scroll_text_cols = cols;
-    s_scroll_text_w = w;
-    s_scroll_restart = true;
-    scroll_unlock();
-    if (s_scroll_task) xTaskNotifyGive(s_scroll_task);
+    char full[128];
+    if (path[0] == '/') {
+        snprintf(full, sizeof(full), "%s", path);
+    } else {
+        snprintf(full, sizeof(full), "%s/%s", SCROLL_STORAGE_MOUNT, path);
+    }
+    FILE *f = fopen(full, "rb");
+    if (!f) {
+        printf("scroll: cannot open %s\n", full);
+        return false;
+    }
+
+    scroll_gen_t gen;
+    if (!scroll_gen_init_stream(&gen, scroll_gen_file_source(f))) return false; // closes f
+    scroll_install_gen(&gen);
+    return true;
 }
 
 static void scroll_on(const char *text, uint32_t fps, uint32_t pause_ms, bool wave) {
@@ -1111,8 +1128,15 @@ static void scroll_on(const char *text, uint32_t fps, uint32_t pause_ms, bool wa
         printf("matrix not initialized (run: matrix init)\n");
         return;
     }
-    scroll_set_text(text);
-    if (!s_scroll_text_cols || s_scroll_text_w <= 0) {
+    if (text && text[0] == '@') {
+        if (!scroll_set_file(text + 1)) {
+            scroll_free_text();
+            return;
+        }
+    } else {
+        scroll_set_text(text);
+    }
+    if (!s_scroll_have_text || scroll_gen_width(&s_scroll_gen) == 0) {
         printf("scroll: empty/unsupported text\n");
         scroll_free_text();
         return;
@@ -1140,10 +1164,7 @@ static void scroll_off(void) {
     s_scroll_enabled = false;
     s_scroll_wave = false;
     if (s_scroll_have_saved_fb) {
-        matrix_lock();
-        memcpy(s_fb, s_scroll_saved_fb, sizeof(s_fb));
-        matrix_unlock();
-        (void)fb_flush_all();
+        (void)fb_present(s_scroll_saved_fb);
         s_scroll_have_saved_fb = false;
     }
     scroll_free_text();
@@ -1155,8 +1176,6 @@ static void text_anim_task(void *arg) {
 
 	static const float k_pi = 3.14159265358979323846f;
 
-	static const int8_t wave16[16] = {0, 1, 2, 1, 0, -1, -2, -1, 0, 1, 2, 1, 0, -1, -2, -1};
-
     const int spin_duration = 20;
     const int spin_hold_frames = 40;
     const int spin_out_duration = 15;
@@ -1193,24 +1212,29 @@ static void text_anim_task(void *arg) {
         }
 
         if (s_text_anim_mode == TEXT_ANIM_WAVE) {
+            // Same picture as render_text_centered_cols with per-character wave offsets, generated
+            // from precomputed row planes (see scroll_gen.h).
+            scroll_gen_t gen;
+            bool have_gen = false;
+            uint8_t back[8][MAX7219_MAX_CHAIN_LEN];
             for (;;) {
                 if (!s_text_anim_enabled || s_text_anim_mode != TEXT_ANIM_WAVE) break;
-                if (ulTaskNotifyTake(pdTRUE, 0) > 0 || s_text_anim_restart) {
+                const bool restart = ulTaskNotifyTake(pdTRUE, 0) > 0 || s_text_anim_restart;
+                if (restart) {
                     frame = 0;
                     s_text_anim_restart = false;
                 }
-                for (int i = 0; i < s_text_anim_len && i < (int)(sizeof(yoffs) / sizeof(yoffs[0])); i++) {
-                    const int idx = (int)((frame + (uint32_t)(i * 2)) & 0x0F);
-                    yoffs[i] = wave16[idx];
+                if (restart || !have_gen) {
+                    if (have_gen) scroll_gen_free(&gen);
+                    have_gen = scroll_gen_init_text(&gen, s_text_anim_text, (size_t)s_text_anim_len);
                 }
-                render_text_centered_cols(cols, width, s_text_anim_text, s_text_anim_len, yoffs);
-                matrix_lock();
-                fb_from_cols(cols, width);
-                matrix_unlock();
-                (void)fb_flush_all();
+                const int64_t start_x = (width - s_text_anim_len * FONT5X7_CELL) / 2;
+                scroll_gen_frame(have_gen ? &gen : NULL, start_x, width, true, frame, &back[0][0], sizeof(back[0]));
+                (void)fb_present(back);
                 frame++;
                 vTaskDelay(pdMS_TO_TICKS(frame_ms));
             }
+            if (have_gen) scroll_gen_free(&gen);
             continue;
         }
 
@@ -1252,10 +1276,7 @@ static void text_anim_task(void *arg) {
 	                    render_text_centered_cols(cols, width, s_text_anim_text, s_text_anim_len, yoffs);
 	                }
 
-	                matrix_lock();
-	                fb_from_cols(cols, width);
-	                matrix_unlock();
-	                (void)fb_flush_all();
+	                (void)fb_present_cols(cols, width);
 
 	                frame++;
 	                vTaskDelay(pdMS_TO_TICKS(frame_ms));
@@ -1317,10 +1338,7 @@ static void text_anim_task(void *arg) {
                 }
 
                 render_text_centered_cols_scaled_x(cols, width, s_text_anim_text, s_text_anim_len, scales);
-                matrix_lock();
-                fb_from_cols(cols, width);
-                matrix_unlock();
-                (void)fb_flush_all();
+                (void)fb_present_cols(cols, width);
 
                 frame++;
                 vTaskDelay(pdMS_TO_TICKS(frame_ms));
@@ -1370,10 +1388,7 @@ static void text_anim_task(void *arg) {
                 render_text_centered_cols(cols, width, display, len, NULL);
                 for (int x = 0; x < width; x++) cols[x] = col_scale_y(cols[x], scale_q8);
 
-                matrix_lock();
-                fb_from_cols(cols, width);
-                matrix_unlock();
-                (void)fb_flush_all();
+                (void)fb_present_cols(cols, width);
 
                 frame++;
                 vTaskDelay(pdMS_TO_TICKS(frame_ms));
@@ -1396,7 +1411,7 @@ static void text_anim_set_text(const char *text) {
     if (len > 64) len = 64;
     for (size_t i = 0; i < len; i++) {
         char c = ascii_upper(text[i]);
-        if (!char_supported_for_scroll(c)) c = ' ';
+        if (!font5x7_supported(c)) c = ' ';
         s_text_anim_text[i] = c;
     }
     s_text_anim_len = (int)len;
@@ -1467,15 +1482,54 @@ static void text_anim_off(void) {
     s_text_anim_mode = TEXT_ANIM_NONE;
     s_flipboard_count = 0;
     if (s_text_anim_have_saved_fb) {
-        matrix_lock();
-        memcpy(s_fb, s_text_anim_saved_fb, sizeof(s_fb));
-        matrix_unlock();
-        (void)fb_flush_all();
+        (void)fb_present(s_text_anim_saved_fb);
         s_text_anim_have_saved_fb = false;
     }
     if (s_text_anim_task) xTaskNotifyGive(s_text_anim_task);
 }
 
+// Sends `frames` frames as fast as the bus allows; `rows` rows change per frame (1..8). Returns elapsed us.
+static int64_t fb_bench_run(int frames, int rows) {
+    const int n = chain_len_active();
+    uint8_t back[8][MAX7219_MAX_CHAIN_LEN];
+    const int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < frames; i++) {
+        memset(back, 0, sizeof(back));
+        for (int y = 0; y < rows; y++) {
+            for (int m = 0; m < n; m++) {
+                back[y][m] = ((i + y) & 1) ? 0xAA : 0x55;
+            }
+        }
+        (void)fb_present(back);
+    }
+    return esp_timer_get_time() - t0;
+}
+
+static void fb_bench(int frames) {
+    uint8_t saved[8][MAX7219_MAX_CHAIN_LEN];
+    matrix_lock();
+    memcpy(saved, s_fb, sizeof(saved));
+    matrix_unlock();
+
+    const int n = chain_len_active();
+    const int hz = s_matrix.clock_hz;
+    // One row = 16 bits per module; the MAX7219 needs all of them shifted before CS rises.
+    const uint32_t wire_us_row = (uint32_t)(((uint64_t)16u * (uint64_t)n * 1000000u) / (uint64_t)(hz > 0 ? hz : 1));
+    printf("bench: chain=%d spi_hz=%d frames=%d wire_us/row=%u\n", n, hz, frames, (unsigned)wire_us_row);
+
+    static const int k_rows[] = {8, 1};
+    for (size_t i = 0; i < sizeof(k_rows) / sizeof(k_rows[0]); i++) {
+        const int64_t us = fb_bench_run(frames, k_rows[i]);
+        const uint32_t us_frame = (uint32_t)(us / frames);
+        printf("bench: rows_changed=%d us/frame=%u fps=%u\n",
+               k_rows[i],
+               (unsigned)us_frame,
+               (unsigned)(us_frame ? (1000000u / us_frame) : 0));
+    }
+
+    (void)fb_present(saved);
+}
+
 static void stop_animations(void) {
     blink_off();
     scroll_off();
@@ -1501,6 +1555,7 @@ static void try_autoinit(void) {
         ESP_LOGW(TAG, "MAX7219 auto-init failed: %s (use `matrix init` to retry)", esp_err_to_name(err));
         return;
     }
+    fb_shown_reset();
 
     s_matrix_ready = true;
     if (!s_matrix_mu) s_matrix_mu = xSemaphoreCreateMutex();
@@ -1618,6 +1673,7 @@ static int cmd_matrix(int argc, char **argv) {
             printf("init failed: %s\n", esp_err_to_name(err));
             return 1;
         }
+        fb_shown_reset();
         s_matrix_ready = true;
         fb_clear();
         fb_set_ids_pattern();
@@ -1671,6 +1727,7 @@ static int cmd_matrix(int argc, char **argv) {
                 printf("chain failed: %s\n", esp_err_to_name(err));
                 return 1;
             }
+            fb_shown_reset();
             fb_clear();
             fb_set_ids_pattern();
             (void)fb_flush_all();
@@ -1695,8 +1752,8 @@ static int cmd_matrix(int argc, char **argv) {
         }
         char *end = NULL;
         long v = strtol(argv[2], &end, 0);
-        if (!end || *end != '\0' || v < 1000 || v > 10000000) {
-            printf("invalid hz: %s (expected 1000..10000000)\n", argv[2]);
+        if (!end || *end != '\0' || v < 1000 || v > MAX7219_SPI_HZ_MAX) {
+            printf("invalid hz: %s (expected 1000..%d)\n", argv[2], MAX7219_SPI_HZ_MAX);
             return 1;
         }
         matrix_lock();
@@ -1710,6 +1767,44 @@ static int cmd_matrix(int argc, char **argv) {
         return 0;
     }
 
+    if (strcmp(argv[1], "stats") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            matrix_lock();
+            memset(&s_fb_stats, 0, sizeof(s_fb_stats));
+            matrix_unlock();
+            printf("ok\n");
+            return 0;
+        }
+        matrix_lock();
+        const fb_flush_stats_t st = s_fb_stats;
+        matrix_unlock();
+        printf("ok: flushes=%u rows_sent=%u rows_skipped=%u last_us=%u max_us=%u avg_us_per_row=%u\n",
+               (unsigned)st.flushes,
+               (unsigned)st.rows_sent,
+               (unsigned)st.rows_skipped,
+               (unsigned)st.last_us,
+               (unsigned)st.max_us,
+               (unsigned)(st.rows_sent ? (st.sum_us / st.rows_sent) : 0));
+        return 0;
+    }
+
+    if (strcmp(argv[1], "bench") == 0) {
+        stop_animations();
+        int frames = 200;
+        if (argc >= 3) {
+            char *end = NULL;
+            long v = strtol(argv[2], &end, 0);
+            if (!end || *end != '\0' || v < 1 || v > 100000) {
+                printf("invalid frames: %s (expected 1..100000)\n", argv[2]);
+                return 1;
+            }
+            frames = (int)v;
+        }
+        fb_bench(frames);
+        printf("ok\n");
+        return 0;
+    }
+
     if (strcmp(argv[1], "blink") == 0) {
         if (argc < 3) {
             printf("usage: matrix blink on [on_ms] [off_ms] | matrix blink off | matrix blink status\n");
@@ -1970,6 +2065,7 @@ static int cmd_matrix(int argc, char **argv) {
             printf("clear failed: %s\n", esp_err_to_name(err));
             return 1;
         }
+        fb_shown_reset();
         printf("ok\n");
         return 0;
     }
@@ -2137,7 +2233,7 @@ static int cmd_matrix(int argc, char **argv) {
         for (int m = 0; m < n; m++) {
             s_fb[row][m] = (uint8_t)val;
         }
-        esp_err_t err = fb_flush_row((int)row);
+        esp_err_t err = fb_flush_all();
         if (err != ESP_OK) {
             printf("row failed: %s\n", esp_err_to_name(err));
             return 1;
@@ -2168,7 +2264,7 @@ static int cmd_matrix(int argc, char **argv) {
             }
             s_fb[row][m] = (uint8_t)v;
         }
-        esp_err_t err = fb_flush_row((int)row);
+        esp_err_t err = fb_flush_all();
         if (err != ESP_OK) {
             printf("rowm failed: %s\n", esp_err_to_name(err));
             return 1;
@@ -2200,7 +2296,7 @@ static int cmd_matrix(int argc, char **argv) {
             s_fb[row][i] = (uint8_t)v;
         }
 
-        esp_err_t err = fb_flush_row((int)row);
+        esp_err_t err = fb_flush_all();
         if (err != ESP_OK) {
             printf("row4 failed: %s\n", esp_err_to_name(err));
             return 1;
@@ -2242,7 +2338,7 @@ static int cmd_matrix(int argc, char **argv) {
             s_fb[y][module] &= (uint8_t)~mask;
         }
 
-        esp_err_t err = fb_flush_row((int)y);
+        esp_err_t err = fb_flush_all();
         if (err != ESP_OK) {
             printf("px failed: %s\n", esp_err_to_name(err));
             return 1;
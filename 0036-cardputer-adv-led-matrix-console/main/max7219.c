@@ -1,13 +1,38 @@
 #include "max7219.h"
 
+#include <string.h>
+
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
 
 static int clamp_spi_hz(int hz) {
     if (hz < 1000) return 1000;
-    if (hz > 10000000) return 10000000;
+    if (hz > MAX7219_SPI_HZ_MAX) return MAX7219_SPI_HZ_MAX;
     return hz;
 }
 
+static esp_err_t max7219_add_device(spi_host_device_t host, int pin_cs, int clock_hz, spi_device_handle_t *out) {
+    spi_device_interface_config_t devcfg = {
+        .clock_speed_hz = clock_hz,
+        .mode = 0,
+        .spics_io_num = pin_cs,
+        .queue_size = 8, // one frame of row transactions (max7219_set_rows_chain)
+    };
+    return spi_bus_add_device(host, &devcfg, out);
+}
+
+static void max7219_fill_row_tx(uint8_t *tx, int n, uint8_t row, const uint8_t *bytes) {
+    const uint8_t reg = (uint8_t)(MAX7219_REG_DIGIT0 + row);
+
+    // Daisy-chain order: first shifted bits land in the furthest module.
+    // Treat `bytes[0]` as the module closest to the MCU (CS), so reverse when sending.
+    for (int i = 0; i < n; i++) {
+        const int src = (n - 1) - i;
+        tx[2 * i + 0] = reg;
+        tx[2 * i + 1] = bytes[src];
+    }
+}
+
 static esp_err_t max7219_write_u16(max7219_t *dev, uint8_t reg, uint8_t data) {
     if (!dev || !dev->spi) return ESP_ERR_INVALID_STATE;
     uint8_t tx[2] = {reg, data};
@@ -63,22 +88,16 @@ esp_err_t max7219_open(max7219_t *dev,
         return err;
     }
 
-    spi_device_interface_config_t devcfg = {
-        .clock_speed_hz = MAX7219_DEFAULT_SPI_HZ,
-        .mode = 0,
-        .spics_io_num = pin_cs,
-        .queue_size = 1,
-    };
-
+    const int hz = clamp_spi_hz(MAX7219_DEFAULT_SPI_HZ);
     spi_device_handle_t handle = NULL;
-    err = spi_bus_add_device(host, &devcfg, &handle);
+    err = max7219_add_device(host, pin_cs, hz, &handle);
     if (err != ESP_OK) return err;
 
     dev->spi = handle;
     dev->host = host;
     dev->pin_cs = pin_cs;
     dev->chain_len = chain_len;
-    dev->clock_hz = devcfg.clock_speed_hz;
+    dev->clock_hz = hz;
     return ESP_OK;
 }
 
@@ -106,12 +125,8 @@ esp_err_t max7219_init(max7219_t *dev) {
 esp_err_t max7219_clear(max7219_t *dev) {
     if (!dev || !dev->spi || dev->chain_len <= 0) return ESP_ERR_INVALID_STATE;
 
-    uint8_t zeros[MAX7219_MAX_CHAIN_LEN] = {0};
-    for (int row = 0; row < 8; row++) {
-        esp_err_t err = max7219_set_row_chain(dev, (uint8_t)row, zeros);
-        if (err != ESP_OK) return err;
-    }
-    return ESP_OK;
+    static const uint8_t zeros[8][MAX7219_MAX_CHAIN_LEN] = {{0}};
+    return max7219_set_rows_chain(dev, zeros, 0xFF);
 }
 
 esp_err_t max7219_set_intensity(max7219_t *dev, uint8_t intensity) {
@@ -134,15 +149,8 @@ esp_err_t max7219_set_spi_clock_hz(max7219_t *dev, int clock_hz) {
     if (err != ESP_OK) return err;
     dev->spi = NULL;
 
-    spi_device_interface_config_t devcfg = {
-        .clock_speed_hz = hz,
-        .mode = 0,
-        .spics_io_num = dev->pin_cs,
-        .queue_size = 1,
-    };
-
     spi_device_handle_t handle = NULL;
-    err = spi_bus_add_device(dev->host, &devcfg, &handle);
+    err = max7219_add_device(dev->host, dev->pin_cs, hz, &handle);
     if (err != ESP_OK) return err;
 
     dev->spi = handle;
@@ -175,15 +183,7 @@ esp_err_t max7219_set_row_chain(max7219_t *dev, uint8_t row, const uint8_t *byte
     if (n > MAX7219_MAX_CHAIN_LEN) return ESP_ERR_INVALID_ARG;
 
     uint8_t tx[2 * MAX7219_MAX_CHAIN_LEN] = {0};
-    const uint8_t reg = (uint8_t)(MAX7219_REG_DIGIT0 + row);
-
-    // Daisy-chain order: first shifted bits land in the furthest module.
-    // Treat `bytes[0]` as the module closest to the MCU (CS), so reverse when sending.
-    for (int i = 0; i < n; i++) {
-        const int src = (n - 1) - i;
-        tx[2 * i + 0] = reg;
-        tx[2 * i + 1] = bytes[src];
-    }
+    max7219_fill_row_tx(tx, n, row, bytes);
 
     spi_transaction_t t = {
         .length = 16 * n,
@@ -191,3 +191,39 @@ esp_err_t max7219_set_row_chain(max7219_t *dev, uint8_t row, const uint8_t *byte
     };
     return spi_device_transmit(dev->spi, &t);
 }
+
+esp_err_t max7219_set_rows_chain(max7219_t *dev, const uint8_t rows[8][MAX7219_MAX_CHAIN_LEN], uint8_t row_mask) {
+    if (!dev || !dev->spi || dev->chain_len <= 0) return ESP_ERR_INVALID_STATE;
+    if (!rows) return ESP_ERR_INVALID_ARG;
+
+    const int n = dev->chain_len;
+    if (n > MAX7219_MAX_CHAIN_LEN) return ESP_ERR_INVALID_ARG;
+    if (row_mask == 0) return ESP_OK;
+
+    esp_err_t err = spi_device_acquire_bus(dev->spi, portMAX_DELAY);
+    if (err != ESP_OK) return err;
+
+    int queued = 0;
+    for (int row = 0; row < 8; row++) {
+        if (!(row_mask & (1u << row))) continue;
+
+        max7219_fill_row_tx(dev->row_tx[row], n, (uint8_t)row, rows[row]);
+        spi_transaction_t *t = &dev->row_trans[row];
+        memset(t, 0, sizeof(*t));
+        t->length = 16 * n;
+        t->tx_buffer = dev->row_tx[row];
+        err = spi_device_queue_trans(dev->spi, t, portMAX_DELAY);
+        if (err != ESP_OK) break;
+        queued++;
+    }
+
+    // Always collect what was queued, even after a queue error, so the buffers are free again.
+    for (int i = 0; i < queued; i++) {
+        spi_transaction_t *done = NULL;
+        const esp_err_t res = spi_device_get_trans_result(dev->spi, &done, portMAX_DELAY);
+        if (res != ESP_OK && err == ESP_OK) err = res;
+    }
+
+    spi_device_release_bus(dev->spi);
+    return err;
+}
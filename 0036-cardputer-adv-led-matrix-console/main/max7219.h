@@ -3,6 +3,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "sdkconfig.h"
+
 #include "esp_err.h"
 #include "driver/spi_master.h"
 #include "hal/spi_types.h"
@@ -13,7 +15,12 @@
 #define MAX7219_DEFAULT_PIN_CS   5
 #define MAX7219_MAX_CHAIN_LEN 16
 #define MAX7219_DEFAULT_CHAIN_LEN 12
+#define MAX7219_SPI_HZ_MAX (10 * 1000 * 1000) // datasheet fSCLK limit
+#ifdef CONFIG_TUTORIAL_0036_MAX7219_SPI_HZ
+#define MAX7219_DEFAULT_SPI_HZ CONFIG_TUTORIAL_0036_MAX7219_SPI_HZ
+#else
 #define MAX7219_DEFAULT_SPI_HZ (100 * 1000)
+#endif
 
 #define MAX7219_REG_DIGIT0       0x01
 #define MAX7219_REG_DECODE_MODE  0x09
@@ -28,6 +35,11 @@ typedef struct {
     int pin_cs;
     int chain_len;
     int clock_hz;
+
+    // max7219_set_rows_chain: one queued DMA transaction per row. These live in the struct so they stay
+    // valid until the transfer completes; keep max7219_t in internal (DMA-capable) RAM.
+    spi_transaction_t row_trans[8];
+    uint8_t row_tx[8][2 * MAX7219_MAX_CHAIN_LEN] __attribute__((aligned(4)));
 } max7219_t;
 
 esp_err_t max7219_open(max7219_t *dev,
@@ -48,3 +60,9 @@ esp_err_t max7219_set_rows_raw(max7219_t *dev, const uint8_t rows[8]);
 // Write one row across a daisy-chained set of MAX7219 devices.
 // `bytes` must contain `dev->chain_len` bytes, one per module.
 esp_err_t max7219_set_row_chain(max7219_t *dev, uint8_t row, const uint8_t *bytes);
+
+// Write the rows whose bit is set in `row_mask` (bit r = digit row r) across the chain.
+// `rows[r]` holds `dev->chain_len` bytes for row r, ordered as in max7219_set_row_chain.
+// Each row is its own CS-latched transaction (the MAX7219 latches one register per module per CS
+// edge); all of them are queued back-to-back under one bus acquisition, then waited for.
+esp_err_t max7219_set_rows_chain(max7219_t *dev, const uint8_t rows[8][MAX7219_MAX_CHAIN_LEN], uint8_t row_mask);
@@ -0,0 +1,242 @@
+#include "scroll_gen.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "font5x7.h"
+
+// Vertical offset per wave phase (same curve the anim/scroll wave always used).
+static const int8_t k_wave16[16] = {0, 1, 2, 1, 0, -1, -2, -1, 0, 1, 2, 1, 0, -1, -2, -1};
+
+// Character i is offset by k_wave16[(frame + 2 * i) & 15]. The table repeats every 8 entries, so
+// characters 4 apart always move together: there are 4 classes (i & 3), repeating every 24 columns.
+// k_class0_mask[r] has bit j set if text column r + j belongs to class 0; class c is the same pattern
+// 6 * c columns later.
+static const uint32_t k_class0_mask[24] = {
+    0x3F00003F, 0x1F80001F, 0x0FC0000F, 0x07E00007, 0x03F00003, 0x01F80001,
+    0x00FC0000, 0x007E0000, 0x003F0000, 0x001F8000, 0x000FC000, 0x0007E000,
+    0x0003F000, 0x0001F800, 0x0000FC00, 0x00007E00, 0x00003F00, 0x80001F80,
+    0xC0000FC0, 0xE00007E0, 0xF00003F0, 0xF80001F8, 0xFC0000FC, 0x7E00007E,
+};
+
+static uint32_t *plane(const scroll_gen_t *g, int y) {
+    return g->planes + (size_t)y * (size_t)g->cap_words;
+}
+
+// 32 plane bits starting at bit `bit` (relative to base_col); bits outside the window read as 0.
+static uint32_t plane_bits(const uint32_t *p, int cap_words, int64_t bit) {
+    const int64_t w = bit >> 5; // floor, also for negative bits
+    const int s = (int)(bit & 31);
+    const uint32_t lo = (w >= 0 && w < cap_words) ? p[w] : 0;
+    if (s == 0) return lo;
+    const uint32_t hi = (w + 1 >= 0 && w + 1 < cap_words) ? p[w + 1] : 0;
+    return (lo >> s) | (hi << (32 - s));
+}
+
+// Appends one character cell at end_col; the caller checks there is room.
+static void put_char(scroll_gen_t *g, char c) {
+    const uint8_t *cols = font5x7_get_cols(font5x7_supported(c) ? c : ' ');
+    const int64_t rel = g->end_col - g->base_col;
+    const int w = (int)(rel >> 5);
+    const int s = (int)(rel & 31);
+    for (int y = 0; y < 8; y++) {
+        uint32_t r = 0;
+        for (int col = 0; col < FONT5X7_COLS; col++) {
+            if (cols[col] & (uint8_t)(1u << y)) r |= 1u << col;
+        }
+        if (!r) continue;
+        uint32_t *p = plane(g, y);
+        p[w] |= r << s;
+        if (s > 32 - FONT5X7_COLS) p[w + 1] |= r >> (32 - s);
+    }
+    g->end_col += FONT5X7_CELL;
+}
+
+static bool has_room(const scroll_gen_t *g) {
+    return g->end_col - g->base_col + FONT5X7_CELL <= (int64_t)g->cap_words * 32;
+}
+
+// Next character from the source, or -1 at the end.
+static int next_char(scroll_gen_t *g) {
+    for (;;) {
+        if (g->pend_i >= g->pend_n) {
+            const int n = g->src.read(g->src.ctx, g->pend, (int)sizeof(g->pend));
+            if (n <= 0) return -1;
+            g->pend_n = n;
+            g->pend_i = 0;
+        }
+        const char c = g->pend[g->pend_i++];
+        if (c != '\r') return (unsigned char)c;
+    }
+}
+
+static void stream_fill(scroll_gen_t *g) {
+    while (!g->eof && has_room(g)) {
+        const int c = next_char(g);
+        if (c < 0) {
+            g->eof = true;
+            return;
+        }
+        put_char(g, (char)c);
+    }
+}
+
+static bool stream_restart(scroll_gen_t *g) {
+    if (!g->src.rewind || !g->src.rewind(g->src.ctx)) return false;
+    memset(g->planes, 0, (size_t)8 * (size_t)g->cap_words * sizeof(uint32_t));
+    g->base_col = 0;
+    g->end_col = 0;
+    g->eof = false;
+    g->pend_n = 0;
+    g->pend_i = 0;
+    return true;
+}
+
+// Makes columns [t0, t0 + width) resident if the text has them.
+static void stream_window(scroll_gen_t *g, int64_t t0, int width) {
+    if (!g->src.read) return;
+    if (t0 < g->base_col && g->base_col > 0) {
+        if (!stream_restart(g)) return;
+    }
+    if (g->eof || t0 + width <= g->end_col) return;
+
+    // Characters that are entirely left of the frame are consumed without rendering.
+    while (!g->eof && g->end_col + FONT5X7_CELL <= t0) {
+        if (next_char(g) < 0) {
+            g->eof = true;
+            break;
+        }
+        g->end_col += FONT5X7_CELL;
+    }
+
+    // Drop whole words left of the frame (never past end_col, so put_char stays in the window).
+    const int64_t keep = (t0 < g->end_col) ? t0 : g->end_col;
+    const int64_t new_base = keep & ~(int64_t)31;
+    if (new_base > g->base_col) {
+        int64_t d = (new_base - g->base_col) >> 5;
+        if (d > g->cap_words) d = g->cap_words;
+        const int keep_words = g->cap_words - (int)d;
+        for (int y = 0; y < 8; y++) {
+            uint32_t *p = plane(g, y);
+            memmove(p, p + d, (size_t)keep_words * sizeof(uint32_t));
+            memset(p + keep_words, 0, (size_t)d * sizeof(uint32_t));
+        }
+        g->base_col = new_base;
+    }
+    stream_fill(g);
+}
+
+static bool alloc_planes(scroll_gen_t *g, int cap_words) {
+    g->planes = (uint32_t *)calloc((size_t)8 * (size_t)cap_words, sizeof(uint32_t));
+    if (!g->planes) return false;
+    g->cap_words = cap_words;
+    return true;
+}
+
+bool scroll_gen_init_text(scroll_gen_t *g, const char *text, size_t len) {
+    if (!g) return false;
+    memset(g, 0, sizeof(*g));
+    if (!text) len = 0;
+
+    // +1: put_char may spill into the word after the last full one.
+    const int64_t cols = (int64_t)len * FONT5X7_CELL;
+    if (!alloc_planes(g, (int)((cols + 31) / 32) + 1)) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '\r') continue;
+        put_char(g, text[i]);
+    }
+    g->eof = true;
+    return true;
+}
+
+bool scroll_gen_init_stream(scroll_gen_t *g, scroll_gen_source_t src) {
+    if (!g) return false;
+    memset(g, 0, sizeof(*g));
+    g->src = src;
+    if (!src.read || !alloc_planes(g, SCROLL_GEN_STREAM_WORDS)) {
+        scroll_gen_free(g);
+        return false;
+    }
+    stream_fill(g);
+    return true;
+}
+
+void scroll_gen_free(scroll_gen_t *g) {
+    if (!g) return;
+    free(g->planes);
+    if (g->src.close) g->src.close(g->src.ctx);
+    memset(g, 0, sizeof(*g));
+}
+
+int64_t scroll_gen_width(const scroll_gen_t *g) {
+    if (!g || !g->planes) return 0;
+    return g->eof ? g->end_col : -1;
+}
+
+void scroll_gen_frame(scroll_gen_t *g, int64_t pos, int width, bool wave, uint32_t frame, uint8_t *rows,
+                      size_t stride) {
+    if (!rows || width <= 0) return;
+    if (width > SCROLL_GEN_MAX_WIDTH) width = SCROLL_GEN_MAX_WIDTH;
+    const int nbytes = (width + 7) / 8;
+    if (!g || !g->planes) {
+        for (int y = 0; y < 8; y++) memset(rows + (size_t)y * stride, 0, (size_t)nbytes);
+        return;
+    }
+
+    const int64_t t0 = -pos; // text column at strip x = 0
+    stream_window(g, t0, width);
+
+    int8_t yoff[4] = {0, 0, 0, 0};
+    if (wave) {
+        for (int c = 0; c < 4; c++) yoff[c] = k_wave16[(frame + 2u * (uint32_t)c) & 0x0F];
+    }
+
+    const int nwords = (width + 31) / 32;
+    for (int y = 0; y < 8; y++) {
+        uint8_t *out = rows + (size_t)y * stride;
+        for (int k = 0; k < nwords; k++) {
+            const int64_t a = t0 + 32 * k;
+            const int64_t rel = a - g->base_col;
+            uint32_t word = 0;
+            if (!wave) {
+                word = plane_bits(plane(g, y), g->cap_words, rel);
+            } else {
+                const int r = (int)(((a % 24) + 24) % 24);
+                for (int c = 0; c < 4; c++) {
+                    const int sy = y - yoff[c];
+                    if (sy < 0 || sy > 7) continue;
+                    word |= plane_bits(plane(g, sy), g->cap_words, rel) & k_class0_mask[(r + 24 - 6 * c) % 24];
+                }
+            }
+            for (int b = 0; b < 4 && 4 * k + b < nbytes; b++) {
+                out[4 * k + b] = (uint8_t)(word >> (8 * b));
+            }
+        }
+        if (width & 7) out[nbytes - 1] &= (uint8_t)((1u << (width & 7)) - 1u);
+    }
+}
+
+static int file_read(void *ctx, char *buf, int max) {
+    const size_t n = fread(buf, 1, (size_t)max, (FILE *)ctx);
+    if (n == 0 && ferror((FILE *)ctx)) return -1;
+    return (int)n;
+}
+
+static bool file_rewind(void *ctx) {
+    clearerr((FILE *)ctx);
+    return fseek((FILE *)ctx, 0, SEEK_SET) == 0;
+}
+
+static void file_close(void *ctx) {
+    fclose((FILE *)ctx);
+}
+
+scroll_gen_source_t scroll_gen_file_source(FILE *f) {
+    scroll_gen_source_t src = {
+        .read = f ? file_read : NULL,
+        .rewind = file_rewind,
+        .close = f ? file_close : NULL,
+        .ctx = f,
+    };
+    return src;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+ * Column-stream generator for 8-pixel-high text on the MAX7219 strip (scroll + wave).
+ *
+ * Text is rendered once into 8 bit-packed row planes: bit t of plane y is pixel (t, y) of the text
+ * strip, 6 columns (FONT5X7_CELL) per character. A frame is then, per row, a handful of 32-bit funnel
+ * shifts of that plane, written straight into framebuffer bytes (bit x%8 of byte x/8 = pixel x, the
+ * s_fb layout). The wave moves characters vertically, which in row-plane form is "take row y - offset";
+ * offsets come from a fixed 16-entry table and characters are grouped by a precomputed column mask.
+ *
+ * Text either lives fully in memory (scroll_gen_init_text) or is pulled from a source through a
+ * sliding window of SCROLL_GEN_STREAM_WORDS words per plane (scroll_gen_init_stream), so its length is
+ * unbounded. Frames must move forward (pos decreasing) for streams; going back rewinds the source.
+ *
+ * Plain C with no ESP-IDF dependency so it builds on the host (tools/scroll_host).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SCROLL_GEN_MAX_WIDTH 128   // 16 modules
+#define SCROLL_GEN_STREAM_WORDS 16 // per plane: 512 columns (~85 characters) buffered
+
+typedef struct {
+    // Up to max characters into buf; returns the count, 0 at end of text, <0 on error (treated as end).
+    int (*read)(void *ctx, char *buf, int max);
+    // Back to the first character; false if the source can't.
+    bool (*rewind)(void *ctx);
+    // Called from scroll_gen_free; may be NULL.
+    void (*close)(void *ctx);
+    void *ctx;
+} scroll_gen_source_t;
+
+typedef struct {
+    uint32_t *planes;  // 8 * cap_words; plane y starts at planes + y * cap_words
+    int cap_words;
+    int64_t base_col;  // text column of plane bit 0 (multiple of 32)
+    int64_t end_col;   // text column after the last loaded character
+    bool eof;          // whole text loaded once; end_col is its width
+    scroll_gen_source_t src; // src.read == NULL: in-memory text
+    char pend[64];     // characters read from src but not rendered yet
+    int pend_n;
+    int pend_i;
+} scroll_gen_t;
+
+// Renders len characters of text into a new generator. Returns false on allocation failure (g is
+// left empty and safe to free). '\r' is dropped, unsupported characters are drawn as spaces.
+bool scroll_gen_init_text(scroll_gen_t *g, const char *text, size_t len);
+
+// Streams text from src (src.close is called on failure too).
+bool scroll_gen_init_stream(scroll_gen_t *g, scroll_gen_source_t src);
+
+void scroll_gen_free(scroll_gen_t *g);
+
+// Text width in columns, or -1 while a stream hasn't reached its end yet.
+int64_t scroll_gen_width(const scroll_gen_t *g);
+
+// One frame of `width` (<= SCROLL_GEN_MAX_WIDTH) columns with text column 0 at strip x = pos, as in
+// the scroll task (pos counts down from width to -text_width). `wave` applies the per-character
+// offset for `frame`. Writes 8 rows of (width + 7) / 8 bytes, `stride` bytes apart.
+void scroll_gen_frame(scroll_gen_t *g, int64_t pos, int width, bool wave, uint32_t frame, uint8_t *rows,
+                      size_t stride);
+
+// Source over an open stdio stream; the generator fclose()s it.
+scroll_gen_source_t scroll_gen_file_source(FILE *f);
@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the scroll/wave frame generator host test and benchmark.
+#
+# Compiles main/scroll_gen.c and main/font5x7.c for the host and compares every
+# frame with the previous per-column scroll renderer (copied into the test).
+# Prints JSONL.
+#
+# Usage:
+#   ./tools/scroll_host/run_scroll_host.sh
+#   SANITIZE= ./tools/scroll_host/run_scroll_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+MAIN_DIR="${HERE}/../../main"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/matrix-scroll-host}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -g -std=gnu17 -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -I"${MAIN_DIR}" \
+  -o "${BUILD_DIR}/scroll_host_test" \
+  "${HERE}/scroll_host_test.c" "${MAIN_DIR}/scroll_gen.c" "${MAIN_DIR}/font5x7.c"
+"${BUILD_DIR}/scroll_host_test"
@@ -0,0 +1,403 @@
+/*
+ * Host test and benchmark for the scroll/wave frame generator (main/scroll_gen.c).
+ *
+ * The reference is what matrix_console.c did before: render the whole text into a byte-per-column
+ * array once, then per frame copy/shift one column at a time (col_shift_y for the wave) and scatter
+ * the columns into framebuffer rows (fb_render_cols). Both are copied below. Checks:
+ *   - scroll on / wave frames are identical over two full scroll cycles for several strip widths
+ *     (8..128 columns) and texts, including odd widths and the old 128-character maximum;
+ *   - `matrix anim wave` (centred text, possibly wider than the strip) is identical for all phases;
+ *   - a ~5000-character text streamed from a FILE (and from a source returning 1 character per read)
+ *     gives the same frames as the in-memory text across a rewind, and reports its width at EOF.
+ * Prints JSONL, including ns/frame for old vs new at 128 columns.
+ *
+ * Built and run by tools/scroll_host/run_scroll_host.sh. Exits non-zero on failure.
+ */
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "font5x7.h"
+#include "scroll_gen.h"
+
+#define MAX_CHAIN_LEN 16 // MAX7219_MAX_CHAIN_LEN
+#define MAX_COLS (8 * MAX_CHAIN_LEN)
+
+static int g_failures;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                            \
+            return;                                                                  \
+        }                                                                            \
+    } while (0)
+
+// ---- Reference: matrix_console.c before scroll_gen ----
+
+static const int8_t s_wave16[16] = {0, 1, 2, 1, 0, -1, -2, -1, 0, 1, 2, 1, 0, -1, -2, -1};
+
+static char ascii_upper(char c) {
+    if (c >= 'a' && c <= 'z') return (char)(c - ('a' - 'A'));
+    return c;
+}
+
+static uint8_t col_shift_y(uint8_t bits, int8_t y_offset) {
+    if (y_offset > 0) {
+        if (y_offset > 7) y_offset = 7;
+        return (uint8_t)(bits << y_offset);
+    }
+    if (y_offset < 0) {
+        int s = -y_offset;
+        if (s > 7) s = 7;
+        return (uint8_t)(bits >> s);
+    }
+    return bits;
+}
+
+static void fb_render_cols(uint8_t out[8][MAX_CHAIN_LEN], const uint8_t *cols, int width) {
+    memset(out, 0, 8 * MAX_CHAIN_LEN);
+    if (!cols) return;
+    if (width <= 0) return;
+    if (width > MAX_COLS) width = MAX_COLS;
+    for (int x = 0; x < width; x++) {
+        const int module = x / 8;
+        const uint8_t mask = (uint8_t)(1u << (x % 8));
+        const uint8_t col = cols[x];
+        for (int y = 0; y < 8; y++) {
+            if (col & (uint8_t)(1u << y)) out[y][module] |= mask;
+        }
+    }
+}
+
+// scroll_set_text, without the 128-character clamp.
+static uint8_t *ref_text_cols(const char *text, int *out_w) {
+    const size_t len = strlen(text);
+    const int cell = 6; // 5 cols + 1 spacing
+    const int w = (int)(len * (size_t)cell);
+    uint8_t *cols = (uint8_t *)calloc((size_t)w + 1, 1);
+    int x = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = ascii_upper(text[i]);
+        if (!font5x7_supported(c)) c = ' ';
+        const uint8_t *g = font5x7_get_cols(c);
+        for (int col = 0; col < 5; col++) cols[x++] = g[col];
+        cols[x++] = 0x00;
+    }
+    *out_w = w;
+    return cols;
+}
+
+// One frame of the scroll_task column loop.
+static void ref_scroll_frame(const uint8_t *text_cols, int text_w, int width, int pos, uint32_t frame, int wave,
+                             uint8_t out[8][MAX_CHAIN_LEN]) {
+    uint8_t cols[MAX_COLS] = {0};
+    for (int x = 0; x < width; x++) {
+        const int t = x - pos;
+        if (t >= 0 && t < text_w && text_cols) {
+            uint8_t bits = text_cols[t];
+            if (wave) {
+                const int char_idx = t / 6;
+                const int8_t yoff = s_wave16[(int)((frame + (uint32_t)(char_idx * 2)) & 0x0F)];
+                bits = col_shift_y(bits, yoff);
+            }
+            cols[x] = bits;
+        }
+    }
+    fb_render_cols(out, cols, width);
+}
+
+// render_text_centered_cols with the TEXT_ANIM_WAVE offsets.
+static void ref_anim_wave_frame(const char *text, int text_len, int width, uint32_t frame,
+                                uint8_t out[8][MAX_CHAIN_LEN]) {
+    uint8_t cols[MAX_COLS] = {0};
+    const int cell = 6;
+    const int start_x = (width - text_len * cell) / 2;
+    for (int i = 0; i < text_len; i++) {
+        char c = ascii_upper(text[i]);
+        if (!font5x7_supported(c)) c = ' ';
+        const uint8_t *g = font5x7_get_cols(c);
+        const int8_t yoff = s_wave16[(int)((frame + (uint32_t)(i * 2)) & 0x0F)];
+        const int base_x = start_x + i * cell;
+        for (int col = 0; col < 5; col++) {
+            const int x = base_x + col;
+            if (x < 0 || x >= width) continue;
+            cols[x] |= col_shift_y(g[col], yoff);
+        }
+    }
+    fb_render_cols(out, cols, width);
+}
+
+// ---- Helpers ----
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void gen_frame(scroll_gen_t *g, int64_t pos, int width, int wave, uint32_t frame,
+                      uint8_t out[8][MAX_CHAIN_LEN]) {
+    memset(out, 0, 8 * MAX_CHAIN_LEN);
+    scroll_gen_frame(g, pos, width, wave != 0, frame, &out[0][0], sizeof(out[0]));
+}
+
+static char *make_long_text(size_t len) {
+    static const char k_words[] = "the quick brown fox jumps over 13 lazy dogs; ";
+    char *s = (char *)malloc(len + 1);
+    uint32_t x = 12345;
+    for (size_t i = 0; i < len; i++) {
+        x = x * 1103515245u + 12345u;
+        s[i] = ((x >> 16) % 7 == 0) ? (char)('0' + (x >> 8) % 10) : k_words[i % (sizeof(k_words) - 1)];
+    }
+    s[len] = '\0';
+    return s;
+}
+
+// Runs `cycles` scroll cycles like scroll_task (pos from width down to -text_w, frame counting on)
+// and compares every frame. Returns the number of frames, or -1 on the first mismatch.
+static long compare_scroll(scroll_gen_t *g, const uint8_t *ref_cols, int text_w, int width, int wave, int cycles) {
+    uint8_t want[8][MAX_CHAIN_LEN];
+    uint8_t got[8][MAX_CHAIN_LEN];
+    uint32_t frame = 0;
+    long frames = 0;
+    for (int c = 0; c < cycles; c++) {
+        for (int pos = width; pos >= -text_w; pos--) {
+            ref_scroll_frame(ref_cols, text_w, width, pos, frame, wave, want);
+            gen_frame(g, pos, width, wave, frame, got);
+            if (memcmp(want, got, sizeof(want)) != 0) {
+                fprintf(stderr, "mismatch: width=%d wave=%d pos=%d frame=%u\n", width, wave, pos, (unsigned)frame);
+                return -1;
+            }
+            frame++;
+            frames++;
+        }
+    }
+    return frames;
+}
+
+// ---- Tests ----
+
+static void test_scroll_identical(void) {
+    static const int k_widths[] = {8, 16, 24, 40, 64, 100, 128};
+    char *long128 = make_long_text(128);
+    const char *texts[] = {"HELLO WORLD", "a", "The quick brown fox 0123456789!?", long128};
+    for (size_t ti = 0; ti < sizeof(texts) / sizeof(texts[0]); ti++) {
+        int text_w = 0;
+        uint8_t *ref_cols = ref_text_cols(texts[ti], &text_w);
+        scroll_gen_t g;
+        if (!scroll_gen_init_text(&g, texts[ti], strlen(texts[ti]))) {
+            free(ref_cols);
+            free(long128);
+            CHECK(0);
+        }
+        const int64_t gw = scroll_gen_width(&g);
+        for (size_t wi = 0; wi < sizeof(k_widths) / sizeof(k_widths[0]); wi++) {
+            for (int wave = 0; wave <= 1; wave++) {
+                const long frames = compare_scroll(&g, ref_cols, text_w, k_widths[wi], wave, 2);
+                printf("{\"test\":\"scroll_identical\",\"chars\":%zu,\"width\":%d,\"wave\":%s,\"frames\":%ld,"
+                       "\"identical\":%s}\n",
+                       strlen(texts[ti]), k_widths[wi], wave ? "true" : "false", frames,
+                       frames > 0 ? "true" : "false");
+                if (frames <= 0) g_failures++;
+            }
+        }
+        scroll_gen_free(&g);
+        free(ref_cols);
+        CHECK(gw == text_w);
+    }
+    free(long128);
+}
+
+static void test_anim_wave_identical(void) {
+    static const int k_widths[] = {8, 32, 64, 128};
+    const char *texts[] = {"HI", "WAVE 123", "Centred text that is wider than the strip", "x"};
+    uint8_t want[8][MAX_CHAIN_LEN];
+    uint8_t got[8][MAX_CHAIN_LEN];
+    for (size_t ti = 0; ti < sizeof(texts) / sizeof(texts[0]); ti++) {
+        const int len = (int)strlen(texts[ti]);
+        scroll_gen_t g;
+        CHECK(scroll_gen_init_text(&g, texts[ti], (size_t)len));
+        int ok = 1;
+        for (size_t wi = 0; wi < sizeof(k_widths) / sizeof(k_widths[0]) && ok; wi++) {
+            const int width = k_widths[wi];
+            const int64_t start_x = (width - len * FONT5X7_CELL) / 2;
+            for (uint32_t frame = 0; frame < 40 && ok; frame++) {
+                ref_anim_wave_frame(texts[ti], len, width, frame, want);
+                gen_frame(&g, start_x, width, 1, frame, got);
+                ok = memcmp(want, got, sizeof(want)) == 0;
+            }
+        }
+        scroll_gen_free(&g);
+        printf("{\"test\":\"anim_wave_identical\",\"chars\":%d,\"identical\":%s}\n", len, ok ? "true" : "false");
+        CHECK(ok);
+    }
+}
+
+// Source that hands out one character per read from a string.
+typedef struct {
+    const char *s;
+    size_t len;
+    size_t i;
+    int rewinds;
+} trickle_t;
+
+static int trickle_read(void *ctx, char *buf, int max) {
+    trickle_t *t = (trickle_t *)ctx;
+    if (max <= 0 || t->i >= t->len) return 0;
+    buf[0] = t->s[t->i++];
+    return 1;
+}
+
+static bool trickle_rewind(void *ctx) {
+    trickle_t *t = (trickle_t *)ctx;
+    t->i = 0;
+    t->rewinds++;
+    return true;
+}
+
+static void test_stream(void) {
+    const size_t len = 5000;
+    char *text = make_long_text(len);
+    int text_w = 0;
+    uint8_t *ref_cols = ref_text_cols(text, &text_w);
+    const int width = MAX_COLS;
+    uint8_t want[8][MAX_CHAIN_LEN];
+    uint8_t got[8][MAX_CHAIN_LEN];
+
+    // FILE source, with CRLF line endings that the generator drops.
+    char *crlf = (char *)malloc(len + len / 50 + 1);
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (i % 50 == 49) crlf[n++] = '\r';
+        crlf[n++] = text[i];
+    }
+    FILE *f = fmemopen(crlf, n, "rb");
+    scroll_gen_t g;
+    int ok = f && scroll_gen_init_stream(&g, scroll_gen_file_source(f));
+    if (ok) {
+        ok = scroll_gen_width(&g) == -1; // 5000 characters do not fit in the window
+        uint32_t frame = 0;
+        for (int c = 0; c < 2 && ok; c++) {
+            for (int pos = width; pos >= -text_w && ok; pos--) {
+                for (int wave = 0; wave <= 1 && ok; wave++) {
+                    ref_scroll_frame(ref_cols, text_w, width, pos, frame, wave, want);
+                    gen_frame(&g, pos, width, wave, frame, got);
+                    ok = memcmp(want, got, sizeof(want)) == 0;
+                    if (!ok) fprintf(stderr, "stream mismatch: cycle=%d pos=%d wave=%d\n", c, pos, wave);
+                }
+                frame++;
+            }
+            if (c == 0 && ok) ok = scroll_gen_width(&g) == text_w;
+        }
+        scroll_gen_free(&g); // fclose
+    }
+    printf("{\"test\":\"stream_file\",\"chars\":%zu,\"width\":%d,\"identical\":%s}\n", len, width,
+           ok ? "true" : "false");
+    free(crlf);
+    if (!ok) {
+        free(ref_cols);
+        free(text);
+        CHECK(ok);
+    }
+
+    // One character per read, narrow strip; also jumps straight to the middle of the text.
+    trickle_t t = {text, len, 0, 0};
+    const scroll_gen_source_t src = {trickle_read, trickle_rewind, NULL, &t};
+    ok = scroll_gen_init_stream(&g, src);
+    if (ok) {
+        const long frames = compare_scroll(&g, ref_cols, text_w, 40, 1, 2);
+        ok = frames > 0 && t.rewinds == 1;
+        const int mid = -text_w / 2;
+        ref_scroll_frame(ref_cols, text_w, 40, mid, 7, 1, want);
+        gen_frame(&g, mid, 40, 1, 7, got);
+        ok = ok && memcmp(want, got, sizeof(want)) == 0;
+        scroll_gen_free(&g);
+    }
+    printf("{\"test\":\"stream_trickle\",\"chars\":%zu,\"width\":40,\"rewinds\":%d,\"identical\":%s}\n", len,
+           t.rewinds, ok ? "true" : "false");
+    free(ref_cols);
+    free(text);
+    CHECK(ok);
+}
+
+static void test_empty(void) {
+    scroll_gen_t g;
+    CHECK(scroll_gen_init_text(&g, "", 0));
+    CHECK(scroll_gen_width(&g) == 0);
+    uint8_t got[8][MAX_CHAIN_LEN];
+    memset(got, 0xAA, sizeof(got));
+    scroll_gen_frame(&g, 0, 12, true, 3, &got[0][0], sizeof(got[0]));
+    for (int y = 0; y < 8; y++) CHECK(got[y][0] == 0 && got[y][1] == 0 && got[y][2] == 0xAA);
+    scroll_gen_free(&g);
+    scroll_gen_frame(NULL, 0, 128, false, 0, &got[0][0], sizeof(got[0]));
+    for (int y = 0; y < 8; y++) CHECK(got[y][15] == 0);
+    printf("{\"test\":\"empty\",\"ok\":true}\n");
+}
+
+static void bench(void) {
+    char *text = make_long_text(128);
+    int text_w = 0;
+    uint8_t *ref_cols = ref_text_cols(text, &text_w);
+    scroll_gen_t g;
+    if (!scroll_gen_init_text(&g, text, strlen(text))) {
+        free(ref_cols);
+        free(text);
+        CHECK(0);
+    }
+    const int width = MAX_COLS;
+    uint8_t out[8][MAX_CHAIN_LEN];
+    volatile uint8_t sink = 0;
+    for (int wave = 0; wave <= 1; wave++) {
+        const int reps = 20;
+        const long frames = (long)reps * (width + text_w + 1);
+
+        double t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            uint32_t frame = 0;
+            for (int pos = width; pos >= -text_w; pos--) {
+                ref_scroll_frame(ref_cols, text_w, width, pos, frame++, wave, out);
+                sink ^= out[3][5];
+            }
+        }
+        const double t_old = now_s() - t0;
+
+        t0 = now_s();
+        for (int r = 0; r < reps; r++) {
+            uint32_t frame = 0;
+            for (int pos = width; pos >= -text_w; pos--) {
+                scroll_gen_frame(&g, pos, width, wave != 0, frame++, &out[0][0], sizeof(out[0]));
+                sink ^= out[3][5];
+            }
+        }
+        const double t_new = now_s() - t0;
+
+        printf("{\"bench\":\"scroll_frame\",\"width\":%d,\"wave\":%s,\"frames\":%ld,\"old_ns\":%.1f,\"new_ns\":%.1f,"
+               "\"speedup\":%.2f}\n",
+               width, wave ? "true" : "false", frames, t_old * 1e9 / frames, t_new * 1e9 / frames,
+               t_new > 0 ? t_old / t_new : 0.0);
+    }
+    (void)sink;
+    scroll_gen_free(&g);
+    free(ref_cols);
+    free(text);
+}
+
+int main(void) {
+    test_scroll_identical();
+    test_anim_wave_identical();
+    test_stream();
+    test_empty();
+    bench();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
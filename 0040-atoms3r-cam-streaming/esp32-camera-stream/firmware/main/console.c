@@ -266,6 +266,22 @@ static int cmd_stream(int argc, char **argv) {
                target.has_runtime ? "yes" : "no",
                stream_client_is_running() ? "on" : "off",
                stream_client_is_connected() ? "up" : "down");
+        frame_pipeline_stats_t st;
+        if (stream_client_get_pipeline_stats(&st)) {
+            static const char *const stage_names[FRAME_STAGE_COUNT] = {"capture", "encode", "send"};
+            for (int i = 0; i < FRAME_STAGE_COUNT; i++) {
+                const frame_stage_stats_t *s = &st.stage[i];
+                printf("  %-7s frames=%" PRIu32 " fail=%" PRIu32 " drop=%" PRIu32 " avg_ms=%.2f max_ms=%.2f\n",
+                       stage_names[i], s->frames, s->failures, s->dropped,
+                       s->frames ? (double)s->busy_us / s->frames / 1000.0 : 0.0, s->max_us / 1000.0);
+            }
+            printf("  sent_bytes=%" PRIu64 " latency_avg_ms=%.1f latency_max_ms=%.1f send_q_max=%" PRIu32 "\n",
+                   st.bytes_sent,
+                   st.stage[FRAME_STAGE_SEND].frames
+                       ? (double)st.latency_us / st.stage[FRAME_STAGE_SEND].frames / 1000.0
+                       : 0.0,
+                   st.latency_max_us / 1000.0, st.send_q_max);
+        }
         return 0;
     }
 
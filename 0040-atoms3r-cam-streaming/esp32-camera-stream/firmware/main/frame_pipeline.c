@@ -0,0 +1,332 @@
+#include "frame_pipeline.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+// Queue waits are bounded so the tasks notice frame_pipeline_stop().
+#define STAGE_POLL_MS 100
+
+static const char *TAG = "cam_pipeline";
+
+typedef struct {
+    void *raw;
+    uint32_t seq;
+    int64_t t_capture_us;
+} raw_item_t;
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    uint32_t seq;
+    int64_t t_capture_us;
+} frame_buf_t;
+
+struct frame_pipeline {
+    frame_pipeline_cfg_t cfg;
+    size_t n_bufs;
+    frame_buf_t *bufs;
+    QueueHandle_t raw_q;  // raw_item_t, depth 1: the encoder always gets the newest frame
+    QueueHandle_t free_q; // frame_buf_t *
+    QueueHandle_t send_q; // frame_buf_t *
+    volatile bool running;
+    int live_tasks;
+
+    portMUX_TYPE mux;
+    frame_pipeline_stats_t total;
+    frame_pipeline_stats_t window;
+};
+
+static void stats_lock(frame_pipeline_t *p) {
+    portENTER_CRITICAL(&p->mux);
+}
+
+static void stats_unlock(frame_pipeline_t *p) {
+    portEXIT_CRITICAL(&p->mux);
+}
+
+static void stage_add(frame_stage_stats_t *s, int64_t busy_us, int64_t wait_us, bool ok) {
+    if (ok) {
+        s->frames++;
+    } else {
+        s->failures++;
+    }
+    s->busy_us += (uint64_t)busy_us;
+    s->wait_us += (uint64_t)wait_us;
+    if ((uint32_t)busy_us > s->max_us) s->max_us = (uint32_t)busy_us;
+}
+
+static void account(frame_pipeline_t *p, frame_stage_t stage, int64_t busy_us, int64_t wait_us, bool ok) {
+    stats_lock(p);
+    stage_add(&p->total.stage[stage], busy_us, wait_us, ok);
+    stage_add(&p->window.stage[stage], busy_us, wait_us, ok);
+    stats_unlock(p);
+}
+
+static void account_drop(frame_pipeline_t *p, frame_stage_t stage) {
+    stats_lock(p);
+    p->total.stage[stage].dropped++;
+    p->window.stage[stage].dropped++;
+    stats_unlock(p);
+}
+
+static void task_exit(frame_pipeline_t *p) {
+    stats_lock(p);
+    p->live_tasks--;
+    stats_unlock(p);
+    vTaskDelete(NULL);
+}
+
+static void capture_task(void *arg) {
+    frame_pipeline_t *p = (frame_pipeline_t *)arg;
+    uint32_t seq = 0;
+    while (p->running) {
+        const int64_t t0 = esp_timer_get_time();
+        void *raw = p->cfg.capture(p->cfg.ctx);
+        if (!raw) continue;
+        account(p, FRAME_STAGE_CAPTURE, esp_timer_get_time() - t0, 0, true);
+
+        const raw_item_t item = {.raw = raw, .seq = seq++, .t_capture_us = t0};
+        if (xQueueSend(p->raw_q, &item, 0) == pdTRUE) continue;
+
+        // The encoder hasn't taken the previous frame yet: replace it.
+        raw_item_t old;
+        if (xQueueReceive(p->raw_q, &old, 0) == pdTRUE) {
+            p->cfg.release_raw(p->cfg.ctx, old.raw);
+            account_drop(p, FRAME_STAGE_CAPTURE);
+        }
+        if (xQueueSend(p->raw_q, &item, 0) != pdTRUE) {
+            p->cfg.release_raw(p->cfg.ctx, raw);
+            account_drop(p, FRAME_STAGE_CAPTURE);
+        }
+    }
+    task_exit(p);
+}
+
+static void encode_task(void *arg) {
+    frame_pipeline_t *p = (frame_pipeline_t *)arg;
+    while (p->running) {
+        raw_item_t item;
+        const int64_t t_wait = esp_timer_get_time();
+        if (xQueueReceive(p->raw_q, &item, pdMS_TO_TICKS(STAGE_POLL_MS)) != pdTRUE) continue;
+
+        // Never empty: send_q holds at most n_bufs - 2 and the sender one more.
+        frame_buf_t *buf = NULL;
+        if (xQueueReceive(p->free_q, &buf, pdMS_TO_TICKS(STAGE_POLL_MS)) != pdTRUE) {
+            p->cfg.release_raw(p->cfg.ctx, item.raw);
+            account(p, FRAME_STAGE_ENCODE, 0, esp_timer_get_time() - t_wait, false);
+            continue;
+        }
+
+        const int64_t t0 = esp_timer_get_time();
+        const size_t len = p->cfg.encode(p->cfg.ctx, item.raw, buf->data, p->cfg.buf_size);
+        const int64_t t1 = esp_timer_get_time();
+        p->cfg.release_raw(p->cfg.ctx, item.raw);
+        account(p, FRAME_STAGE_ENCODE, t1 - t0, t0 - t_wait, len > 0);
+        if (len == 0) {
+            xQueueSend(p->free_q, &buf, 0);
+            continue;
+        }
+        buf->len = len;
+        buf->seq = item.seq;
+        buf->t_capture_us = item.t_capture_us;
+
+        // Network stalled: drop the oldest encoded frame rather than wait for it.
+        while (xQueueSend(p->send_q, &buf, 0) != pdTRUE) {
+            frame_buf_t *old = NULL;
+            if (xQueueReceive(p->send_q, &old, 0) == pdTRUE) {
+                xQueueSend(p->free_q, &old, 0);
+                account_drop(p, FRAME_STAGE_ENCODE);
+            }
+        }
+        const uint32_t depth = (uint32_t)uxQueueMessagesWaiting(p->send_q);
+        stats_lock(p);
+        if (depth > p->total.send_q_max) p->total.send_q_max = depth;
+        if (depth > p->window.send_q_max) p->window.send_q_max = depth;
+        stats_unlock(p);
+    }
+    task_exit(p);
+}
+
+static void report_maybe(frame_pipeline_t *p, int64_t *last_us) {
+    if (!p->cfg.report || p->cfg.stats_interval_us <= 0) return;
+    const int64_t now = esp_timer_get_time();
+    if (*last_us == 0) {
+        *last_us = now;
+        return;
+    }
+    if (now - *last_us < p->cfg.stats_interval_us) return;
+
+    frame_pipeline_stats_t window;
+    stats_lock(p);
+    window = p->window;
+    memset(&p->window, 0, sizeof(p->window));
+    stats_unlock(p);
+    p->cfg.report(p->cfg.ctx, &window, now - *last_us);
+    *last_us = now;
+}
+
+static void send_task(void *arg) {
+    frame_pipeline_t *p = (frame_pipeline_t *)arg;
+    int64_t last_report_us = 0;
+    while (p->running) {
+        frame_buf_t *buf = NULL;
+        const int64_t t_wait = esp_timer_get_time();
+        if (xQueueReceive(p->send_q, &buf, pdMS_TO_TICKS(STAGE_POLL_MS)) == pdTRUE) {
+            const int64_t t0 = esp_timer_get_time();
+            const bool ok = p->cfg.send(p->cfg.ctx, buf->data, buf->len);
+            const int64_t t1 = esp_timer_get_time();
+            account(p, FRAME_STAGE_SEND, t1 - t0, t0 - t_wait, ok);
+            if (ok) {
+                const int64_t latency = t1 - buf->t_capture_us;
+                stats_lock(p);
+                p->total.bytes_sent += buf->len;
+                p->window.bytes_sent += buf->len;
+                p->total.latency_us += (uint64_t)latency;
+                p->window.latency_us += (uint64_t)latency;
+                if ((uint32_t)latency > p->total.latency_max_us) p->total.latency_max_us = (uint32_t)latency;
+                if ((uint32_t)latency > p->window.latency_max_us) p->window.latency_max_us = (uint32_t)latency;
+                stats_unlock(p);
+            }
+            xQueueSend(p->free_q, &buf, 0);
+        }
+        report_maybe(p, &last_report_us);
+    }
+    task_exit(p);
+}
+
+static void *alloc_buf(size_t bytes) {
+    void *ptr = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ptr) {
+        ptr = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    return ptr;
+}
+
+static void destroy(frame_pipeline_t *p) {
+    if (p->raw_q) {
+        raw_item_t item;
+        while (xQueueReceive(p->raw_q, &item, 0) == pdTRUE) {
+            p->cfg.release_raw(p->cfg.ctx, item.raw);
+        }
+        vQueueDelete(p->raw_q);
+    }
+    if (p->free_q) vQueueDelete(p->free_q);
+    if (p->send_q) vQueueDelete(p->send_q);
+    if (p->bufs) {
+        for (size_t i = 0; i < p->n_bufs; i++) {
+            heap_caps_free(p->bufs[i].data);
+        }
+        free(p->bufs);
+    }
+    free(p);
+}
+
+esp_err_t frame_pipeline_start(const frame_pipeline_cfg_t *cfg, frame_pipeline_t **out) {
+    if (!cfg || !out || !cfg->capture || !cfg->release_raw || !cfg->encode || !cfg->send || cfg->buf_size == 0 ||
+        cfg->send_depth == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = NULL;
+
+    frame_pipeline_t *p = calloc(1, sizeof(*p));
+    if (!p) return ESP_ERR_NO_MEM;
+    p->cfg = *cfg;
+    portMUX_INITIALIZE(&p->mux);
+    p->n_bufs = cfg->send_depth + 2;
+    p->bufs = calloc(p->n_bufs, sizeof(*p->bufs));
+    p->raw_q = xQueueCreate(1, sizeof(raw_item_t));
+    p->free_q = xQueueCreate(p->n_bufs, sizeof(frame_buf_t *));
+    p->send_q = xQueueCreate(cfg->send_depth, sizeof(frame_buf_t *));
+    if (!p->bufs || !p->raw_q || !p->free_q || !p->send_q) {
+        destroy(p);
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < p->n_bufs; i++) {
+        p->bufs[i].data = alloc_buf(cfg->buf_size);
+        if (!p->bufs[i].data) {
+            destroy(p);
+            return ESP_ERR_NO_MEM;
+        }
+        frame_buf_t *b = &p->bufs[i];
+        xQueueSend(p->free_q, &b, 0);
+    }
+
+    static const char *const names[FRAME_STAGE_COUNT] = {"cam_capture", "cam_encode", "cam_send"};
+    static void (*const fns[FRAME_STAGE_COUNT])(void *) = {capture_task, encode_task, send_task};
+    p->running = true;
+    for (int i = 0; i < FRAME_STAGE_COUNT; i++) {
+        stats_lock(p);
+        p->live_tasks++;
+        stats_unlock(p);
+        if (xTaskCreatePinnedToCore(fns[i], names[i], cfg->stack[i], p, cfg->priority[i], NULL, cfg->core[i]) !=
+            pdPASS) {
+            stats_lock(p);
+            p->live_tasks--;
+            stats_unlock(p);
+            frame_pipeline_stop(p);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    ESP_LOGI(TAG, "pipeline started: bufs=%u x %u bytes send_depth=%u cores=%d/%d/%d", (unsigned)p->n_bufs,
+             (unsigned)cfg->buf_size, (unsigned)cfg->send_depth, cfg->core[FRAME_STAGE_CAPTURE],
+             cfg->core[FRAME_STAGE_ENCODE], cfg->core[FRAME_STAGE_SEND]);
+    *out = p;
+    return ESP_OK;
+}
+
+void frame_pipeline_stop(frame_pipeline_t *p) {
+    if (!p) return;
+    p->running = false;
+    for (;;) {
+        stats_lock(p);
+        const int live = p->live_tasks;
+        stats_unlock(p);
+        if (live == 0) break;
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    destroy(p);
+}
+
+void frame_pipeline_get_stats(frame_pipeline_t *p, frame_pipeline_stats_t *out) {
+    if (!out) return;
+    if (!p) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    stats_lock(p);
+    *out = p->total;
+    stats_unlock(p);
+}
+
+int frame_pipeline_format_stats(const frame_pipeline_stats_t *st, int64_t elapsed_us, char *out, size_t cap) {
+    static const char *const names[FRAME_STAGE_COUNT] = {"capture", "encode", "send"};
+    const frame_stage_stats_t *sent = &st->stage[FRAME_STAGE_SEND];
+    const double seconds = elapsed_us > 0 ? (double)elapsed_us / 1e6 : 0.0;
+
+    int n = snprintf(out, cap, "{\"type\":\"stats\",\"elapsed_ms\":%" PRId64 ",\"fps\":%.1f,\"bytes\":%" PRIu64
+                     ",\"latency_avg_ms\":%.1f,\"latency_max_ms\":%.1f,\"send_q_max\":%" PRIu32,
+                     elapsed_us / 1000, seconds > 0 ? (double)sent->frames / seconds : 0.0, st->bytes_sent,
+                     sent->frames ? (double)st->latency_us / (double)sent->frames / 1000.0 : 0.0,
+                     (double)st->latency_max_us / 1000.0, st->send_q_max);
+    for (int i = 0; i < FRAME_STAGE_COUNT && n >= 0 && (size_t)n < cap; i++) {
+        const frame_stage_stats_t *s = &st->stage[i];
+        const uint32_t done = s->frames + s->failures;
+        n += snprintf(out + n, cap - (size_t)n, ",\"%s\":{\"frames\":%" PRIu32 ",\"fail\":%" PRIu32
+                      ",\"drop\":%" PRIu32 ",\"avg_ms\":%.2f,\"max_ms\":%.2f,\"wait_ms\":%.2f}",
+                      names[i], s->frames, s->failures, s->dropped,
+                      done ? (double)s->busy_us / done / 1000.0 : 0.0, (double)s->max_us / 1000.0,
+                      done ? (double)s->wait_us / done / 1000.0 : 0.0);
+    }
+    if (n >= 0 && (size_t)n < cap) n += snprintf(out + n, cap - (size_t)n, "}");
+    return n;
+}
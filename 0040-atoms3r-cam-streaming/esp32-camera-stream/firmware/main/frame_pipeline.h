@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Three-stage frame pipeline: capture -> encode -> send, one task per stage,
+// connected by bounded queues.
+//
+// Encoded frames live in a fixed pool of buffers (send_depth + 2: one being
+// encoded, one being sent). Both queues drop their oldest entry when full:
+// a newer raw frame replaces one the encoder hasn't picked up yet, and when
+// the network stalls the encoder evicts the oldest encoded frame instead of
+// waiting, so the sender always resumes with recent frames. Throughput is
+// bounded by the slowest stage instead of the sum of all three.
+//
+// The stages are callbacks, so the queueing can run on the host with
+// synthetic frames (tools/pipeline_host).
+
+typedef enum {
+    FRAME_STAGE_CAPTURE = 0,
+    FRAME_STAGE_ENCODE,
+    FRAME_STAGE_SEND,
+    FRAME_STAGE_COUNT,
+} frame_stage_t;
+
+typedef struct {
+    uint32_t frames;   // items the stage completed
+    uint32_t failures; // encode/send callbacks that failed
+    uint32_t dropped;  // entries evicted from the stage's output queue
+    uint32_t max_us;
+    uint64_t busy_us;  // time inside the callback
+    uint64_t wait_us;  // time blocked on the input queue
+} frame_stage_stats_t;
+
+typedef struct {
+    frame_stage_stats_t stage[FRAME_STAGE_COUNT];
+    uint64_t bytes_sent;
+    uint64_t latency_us; // capture start -> send done, summed over sent frames
+    uint32_t latency_max_us;
+    uint32_t send_q_max; // queue high-water mark
+} frame_pipeline_stats_t;
+
+typedef struct {
+    // Returns a raw frame, or NULL (not ready / failed; the callback does its own waiting).
+    void *(*capture)(void *ctx);
+    void (*release_raw)(void *ctx, void *raw);
+    // Encodes raw into out (cap bytes). Returns the length, 0 on failure.
+    size_t (*encode)(void *ctx, void *raw, uint8_t *out, size_t cap);
+    bool (*send)(void *ctx, const uint8_t *data, size_t len);
+    // Optional, called from the send task every stats_interval_us with the
+    // stats of that window (see frame_pipeline_format_stats()).
+    void (*report)(void *ctx, const frame_pipeline_stats_t *window, int64_t elapsed_us);
+    void *ctx;
+
+    size_t buf_size;   // bytes per encoded frame buffer
+    size_t send_depth; // encoded frames waiting for the network
+    int64_t stats_interval_us;
+    int core[FRAME_STAGE_COUNT];
+    int priority[FRAME_STAGE_COUNT];
+    uint32_t stack[FRAME_STAGE_COUNT];
+} frame_pipeline_cfg_t;
+
+typedef struct frame_pipeline frame_pipeline_t;
+
+// Allocates the buffer pool (PSRAM when available) and starts the three tasks.
+esp_err_t frame_pipeline_start(const frame_pipeline_cfg_t *cfg, frame_pipeline_t **out);
+
+// Stops the tasks, releases queued raw frames and frees the pool.
+void frame_pipeline_stop(frame_pipeline_t *p);
+
+// Totals since start.
+void frame_pipeline_get_stats(frame_pipeline_t *p, frame_pipeline_stats_t *out);
+
+// One-line JSON stats message; returns the length (as snprintf).
+int frame_pipeline_format_stats(const frame_pipeline_stats_t *st, int64_t elapsed_us, char *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -24,6 +24,7 @@
 #include "nvs.h"
 #include "nvs_flash.h"
 
+#include "frame_pipeline.h"
 #include "wifi_sta.h"
 
 #define STREAM_HOST_MAX 63
@@ -51,27 +52,12 @@ static volatile bool s_ws_connected = false;
 static volatile bool s_ws_start_pending = false;
 
 static esp_websocket_client_handle_t s_ws = NULL;
-static TaskHandle_t s_stream_task = NULL;
 static bool s_camera_ready = false;
 static int s_camera_power_level = 0;
 static bool s_logged_frame_info = false;
 static bool s_logged_jpeg_info = false;
 
-typedef struct {
-    uint64_t frames;
-    uint64_t capture_fail;
-    uint64_t convert_ok;
-    uint64_t convert_fail;
-    uint64_t ws_send_ok;
-    uint64_t ws_send_fail;
-    uint64_t ws_send_bytes;
-    uint64_t capture_us;
-    uint64_t convert_us;
-    uint64_t send_us;
-    int64_t last_log_us;
-} stream_stats_t;
-
-static stream_stats_t s_stats = {0};
+static frame_pipeline_t *s_pipeline = NULL;
 static int64_t s_last_state_log_us = 0;
 
 #define STREAM_STATS_INTERVAL_US (5 * 1000 * 1000)
@@ -102,32 +88,6 @@ static void log_stream_state(const char *reason) {
     }
 }
 
-static void stats_log_maybe(void) {
-    int64_t now = esp_timer_get_time();
-    if (s_stats.last_log_us == 0) {
-        s_stats.last_log_us = now;
-        return;
-    }
-    int64_t elapsed = now - s_stats.last_log_us;
-    if (elapsed < STREAM_STATS_INTERVAL_US) return;
-
-    double seconds = (double)elapsed / 1000000.0;
-    uint64_t frames = s_stats.frames;
-    double fps = frames ? ((double)frames / seconds) : 0.0;
-    double avg_bytes = frames ? ((double)s_stats.ws_send_bytes / (double)frames) : 0.0;
-    double cap_ms = frames ? ((double)s_stats.capture_us / (double)frames / 1000.0) : 0.0;
-    double conv_ms = s_stats.convert_ok ? ((double)s_stats.convert_us / (double)s_stats.convert_ok / 1000.0) : 0.0;
-    double send_ms = s_stats.ws_send_ok ? ((double)s_stats.send_us / (double)s_stats.ws_send_ok / 1000.0) : 0.0;
-
-    ESP_LOGI(TAG,
-             "stream stats: frames=%" PRIu64 " fps=%.1f bytes=%" PRIu64 " avg=%.0f cap_ms=%.2f conv_ms=%.2f send_ms=%.2f cap_fail=%" PRIu64 " conv_fail=%" PRIu64 " ws_fail=%" PRIu64,
-             frames, fps, s_stats.ws_send_bytes, avg_bytes, cap_ms, conv_ms, send_ms,
-             s_stats.capture_fail, s_stats.convert_fail, s_stats.ws_send_fail);
-
-    memset(&s_stats, 0, sizeof(s_stats));
-    s_stats.last_log_us = now;
-}
-
 static bool psram_ready(void) {
 #if CONFIG_SPIRAM
     bool ready = esp_psram_is_initialized();
@@ -473,7 +433,9 @@ static esp_err_t camera_init_once(void) {
         .frame_size = FRAMESIZE_QVGA,
 
         .jpeg_quality = CONFIG_ATOMS3R_SENSOR_JPEG_QUALITY,
-        .fb_count = 2,
+        // One frame with the encoder, one being filled, one spare so capture
+        // never waits for the encoder to return its buffer.
+        .fb_count = 3,
         .grab_mode = CAMERA_GRAB_LATEST,
         .fb_location = CAMERA_FB_IN_PSRAM,
     };
@@ -515,118 +477,145 @@ static esp_err_t camera_init_once(void) {
     return ESP_OK;
 }
 
-static void stream_task(void *arg) {
-    (void)arg;
-    while (true) {
-        if (!s_stream_enabled) {
-            vTaskDelay(pdMS_TO_TICKS(200));
-            continue;
-        }
+// Pipeline stages (see frame_pipeline.h). Capture also does the gating: it
+// returns NULL, after a short wait, until the target, Wi-Fi, camera and
+// WebSocket are all up.
+static void *stream_capture(void *ctx) {
+    (void)ctx;
+    if (!s_stream_enabled) {
+        vTaskDelay(pdMS_TO_TICKS(200));
+        return NULL;
+    }
 
-        if (!s_has_runtime) {
-            log_stream_state("target not set");
-            vTaskDelay(pdMS_TO_TICKS(500));
-            continue;
-        }
+    if (!s_has_runtime) {
+        log_stream_state("target not set");
+        vTaskDelay(pdMS_TO_TICKS(500));
+        return NULL;
+    }
 
-        if (!cam_wifi_is_connected()) {
-            log_stream_state("wifi not connected");
-            vTaskDelay(pdMS_TO_TICKS(200));
-            continue;
-        }
+    if (!cam_wifi_is_connected()) {
+        log_stream_state("wifi not connected");
+        vTaskDelay(pdMS_TO_TICKS(200));
+        return NULL;
+    }
 
-        if (!s_camera_ready) {
-            if (camera_init_once() != ESP_OK) {
-                log_stream_state("camera init failed");
-                vTaskDelay(pdMS_TO_TICKS(1000));
-                continue;
-            }
+    if (!s_camera_ready) {
+        if (camera_init_once() != ESP_OK) {
+            log_stream_state("camera init failed");
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            return NULL;
         }
+    }
 
-        ensure_ws_client();
-        if (!s_ws || !esp_websocket_client_is_connected(s_ws)) {
-            log_stream_state("websocket not connected");
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
+    ensure_ws_client();
+    if (!s_ws || !esp_websocket_client_is_connected(s_ws)) {
+        log_stream_state("websocket not connected");
+        vTaskDelay(pdMS_TO_TICKS(100));
+        return NULL;
+    }
 
-        int64_t capture_start = esp_timer_get_time();
-        camera_fb_t *fb = esp_camera_fb_get();
-        int64_t capture_end = esp_timer_get_time();
-        if (!fb) {
-            s_stats.capture_fail++;
-            s_stats.capture_us += (uint64_t)(capture_end - capture_start);
-            ESP_LOGW(TAG, "camera capture failed");
-            vTaskDelay(pdMS_TO_TICKS(10));
-            continue;
-        }
-        s_stats.frames++;
-        s_stats.capture_us += (uint64_t)(capture_end - capture_start);
+    camera_fb_t *fb = esp_camera_fb_get();
+    if (!fb) {
+        ESP_LOGW(TAG, "camera capture failed");
+        vTaskDelay(pdMS_TO_TICKS(10));
+        return NULL;
+    }
 
-        if (!s_logged_frame_info) {
-            ESP_LOGV(TAG, "input frame: %ux%u fmt=%d len=%u",
-                     (unsigned)fb->width,
-                     (unsigned)fb->height,
-                     fb->format,
-                     (unsigned)fb->len);
-            s_logged_frame_info = true;
-        }
+    if (!s_logged_frame_info) {
+        ESP_LOGV(TAG, "input frame: %ux%u fmt=%d len=%u",
+                 (unsigned)fb->width,
+                 (unsigned)fb->height,
+                 fb->format,
+                 (unsigned)fb->len);
+        s_logged_frame_info = true;
+    }
+    return fb;
+}
 
-        uint8_t *jpeg_buf = fb->buf;
-        size_t jpeg_len = fb->len;
-        bool needs_free = false;
-
-        if (fb->format != PIXFORMAT_JPEG) {
-            int64_t convert_start = esp_timer_get_time();
-            bool ok = frame2jpg(fb, CONFIG_ATOMS3R_CONVERT_JPEG_QUALITY, &jpeg_buf, &jpeg_len);
-            int64_t convert_end = esp_timer_get_time();
-            if (!ok) {
-                s_stats.convert_fail++;
-                ESP_LOGW(TAG, "frame2jpg failed");
-                esp_camera_fb_return(fb);
-                vTaskDelay(pdMS_TO_TICKS(10));
-                continue;
-            }
-            s_stats.convert_ok++;
-            s_stats.convert_us += (uint64_t)(convert_end - convert_start);
-            needs_free = true;
-            if (!s_logged_jpeg_info) {
-                ESP_LOGV(TAG, "jpeg convert: quality=%u in=%ux%u out_len=%u",
-                         (unsigned)CONFIG_ATOMS3R_CONVERT_JPEG_QUALITY,
-                         (unsigned)fb->width,
-                         (unsigned)fb->height,
-                         (unsigned)jpeg_len);
-                s_logged_jpeg_info = true;
-            }
-        } else if (!s_logged_jpeg_info) {
+static void stream_release(void *ctx, void *raw) {
+    (void)ctx;
+    esp_camera_fb_return((camera_fb_t *)raw);
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} jpeg_sink_t;
+
+static size_t jpeg_sink_write(void *arg, size_t index, const void *data, size_t len) {
+    jpeg_sink_t *sink = (jpeg_sink_t *)arg;
+    if (!data || len == 0) return 0;
+    if (index + len > sink->cap) {
+        sink->overflow = true;
+        return 0;
+    }
+    memcpy(sink->buf + index, data, len);
+    if (index + len > sink->len) sink->len = index + len;
+    return len;
+}
+
+// Encodes straight into the pipeline's pool buffer (frame2jpg_cb) instead of
+// letting frame2jpg malloc a new output buffer per frame.
+static size_t stream_encode(void *ctx, void *raw, uint8_t *out, size_t cap) {
+    (void)ctx;
+    camera_fb_t *fb = (camera_fb_t *)raw;
+
+    if (fb->format == PIXFORMAT_JPEG) {
+        if (fb->len > cap) {
+            ESP_LOGW(TAG, "jpeg frame too large (%u > %u)", (unsigned)fb->len, (unsigned)cap);
+            return 0;
+        }
+        memcpy(out, fb->buf, fb->len);
+        if (!s_logged_jpeg_info) {
             ESP_LOGV(TAG, "jpeg passthrough: quality=%u in=%ux%u len=%u",
                      (unsigned)CONFIG_ATOMS3R_SENSOR_JPEG_QUALITY,
                      (unsigned)fb->width,
                      (unsigned)fb->height,
-                     (unsigned)jpeg_len);
+                     (unsigned)fb->len);
             s_logged_jpeg_info = true;
         }
+        return fb->len;
+    }
 
-        int64_t send_start = esp_timer_get_time();
-        TickType_t ws_timeout = pdMS_TO_TICKS(1000);
-        int sent = esp_websocket_client_send_bin(s_ws, (const char *)jpeg_buf, (int)jpeg_len, ws_timeout);
-        int64_t send_end = esp_timer_get_time();
-        if (sent < 0) {
-            s_stats.ws_send_fail++;
-            ESP_LOGW(TAG, "websocket send failed (%d)", sent);
-        } else {
-            s_stats.ws_send_ok++;
-            s_stats.ws_send_bytes += (uint64_t)sent;
-            s_stats.send_us += (uint64_t)(send_end - send_start);
-        }
-
-        if (needs_free) {
-            free(jpeg_buf);
-        }
-        esp_camera_fb_return(fb);
+    jpeg_sink_t sink = {.buf = out, .cap = cap};
+    bool ok = frame2jpg_cb(fb, CONFIG_ATOMS3R_CONVERT_JPEG_QUALITY, jpeg_sink_write, &sink);
+    if (!ok || sink.overflow) {
+        ESP_LOGW(TAG, "frame2jpg failed%s", sink.overflow ? " (buffer too small)" : "");
+        return 0;
+    }
+    if (!s_logged_jpeg_info) {
+        ESP_LOGV(TAG, "jpeg convert: quality=%u in=%ux%u out_len=%u",
+                 (unsigned)CONFIG_ATOMS3R_CONVERT_JPEG_QUALITY,
+                 (unsigned)fb->width,
+                 (unsigned)fb->height,
+                 (unsigned)sink.len);
+        s_logged_jpeg_info = true;
+    }
+    return sink.len;
+}
 
-        stats_log_maybe();
-        taskYIELD();
+static bool stream_send(void *ctx, const uint8_t *data, size_t len) {
+    (void)ctx;
+    if (!s_ws || !esp_websocket_client_is_connected(s_ws)) return false;
+    int sent = esp_websocket_client_send_bin(s_ws, (const char *)data, (int)len, pdMS_TO_TICKS(1000));
+    if (sent < 0) {
+        ESP_LOGW(TAG, "websocket send failed (%d)", sent);
+        return false;
+    }
+    return true;
+}
+
+// Runs on the send task, so the text frame never interleaves with a binary one.
+static void stream_report(void *ctx, const frame_pipeline_stats_t *window, int64_t elapsed_us) {
+    (void)ctx;
+    char msg[640];
+    int n = frame_pipeline_format_stats(window, elapsed_us, msg, sizeof(msg));
+    if (n <= 0 || (size_t)n >= sizeof(msg)) return;
+    ESP_LOGI(TAG, "stream stats: %s", msg);
+    if (s_ws && esp_websocket_client_is_connected(s_ws)) {
+        (void)esp_websocket_client_send_text(s_ws, msg, n, pdMS_TO_TICKS(200));
     }
 }
 
@@ -647,8 +636,27 @@ esp_err_t stream_client_init(void) {
         ESP_LOGI(TAG, "using stream target from Kconfig (%s:%u)", s_host, (unsigned)s_port);
     }
 
-    if (!s_stream_task) {
-        xTaskCreate(stream_task, "cam_stream", 6144, NULL, 5, &s_stream_task);
+    if (!s_pipeline) {
+        // Capture and send share core 0 with the camera driver and lwIP; the
+        // JPEG encoder, the most expensive stage, gets core 1 to itself.
+        const frame_pipeline_cfg_t cfg = {
+            .capture = stream_capture,
+            .release_raw = stream_release,
+            .encode = stream_encode,
+            .send = stream_send,
+            .report = stream_report,
+            .buf_size = CONFIG_ATOMS3R_PIPELINE_JPEG_BUF_SIZE,
+            .send_depth = CONFIG_ATOMS3R_PIPELINE_SEND_DEPTH,
+            .stats_interval_us = STREAM_STATS_INTERVAL_US,
+            .core = {0, 1, 0},
+            .priority = {6, 5, 5},
+            .stack = {4096, 6144, 4096},
+        };
+        esp_err_t err = frame_pipeline_start(&cfg, &s_pipeline);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "frame pipeline start failed: %s", esp_err_to_name(err));
+            return err;
+        }
     }
 
     return ESP_OK;
@@ -711,6 +719,12 @@ bool stream_client_is_connected(void) {
     return s_ws_connected;
 }
 
+bool stream_client_get_pipeline_stats(frame_pipeline_stats_t *out) {
+    if (!out || !s_pipeline) return false;
+    frame_pipeline_get_stats(s_pipeline, out);
+    return true;
+}
+
 void stream_camera_power_set(int level) {
     s_camera_power_level = level ? 1 : 0;
     camera_power_configure(s_camera_power_level);
@@ -5,6 +5,8 @@
 
 #include "esp_err.h"
 
+#include "frame_pipeline.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,6 +26,8 @@ void stream_client_start(void);
 void stream_client_stop(void);
 bool stream_client_is_running(void);
 bool stream_client_is_connected(void);
+// Pipeline totals since boot; false before stream_client_init().
+bool stream_client_get_pipeline_stats(frame_pipeline_stats_t *out);
 void stream_camera_power_set(int level);
 void stream_camera_power_dump(void);
 
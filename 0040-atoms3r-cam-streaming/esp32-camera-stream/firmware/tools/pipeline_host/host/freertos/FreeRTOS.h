@@ -0,0 +1,21 @@
+/* Host stand-in for the FreeRTOS types frame_pipeline uses (1 tick = 1 ms). */
+#pragma once
+
+#include <pthread.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Critical sections become a mutex: same mutual exclusion, no interrupt masking.
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZE(m) pthread_mutex_init((m), NULL)
+#define portENTER_CRITICAL(m) pthread_mutex_lock(m)
+#define portEXIT_CRITICAL(m) pthread_mutex_unlock(m)
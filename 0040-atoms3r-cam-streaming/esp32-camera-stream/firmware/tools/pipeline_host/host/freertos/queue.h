@@ -0,0 +1,115 @@
+/* Host stand-in: fixed-size copy queue on a pthread mutex + condition variables. */
+#pragma once
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct {
+    pthread_mutex_t mu;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    size_t len;
+    size_t item_size;
+    size_t head;
+    size_t count;
+    unsigned char *items;
+} host_queue_t;
+
+typedef host_queue_t *QueueHandle_t;
+
+static inline QueueHandle_t xQueueCreate(size_t len, size_t item_size)
+{
+    host_queue_t *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->items = calloc(len, item_size);
+    if (!q->items) {
+        free(q);
+        return NULL;
+    }
+    pthread_mutex_init(&q->mu, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    q->len = len;
+    q->item_size = item_size;
+    return q;
+}
+
+static inline void vQueueDelete(QueueHandle_t q)
+{
+    pthread_mutex_destroy(&q->mu);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    free(q->items);
+    free(q);
+}
+
+static inline bool host_queue_ready(const host_queue_t *q, bool for_send)
+{
+    return for_send ? q->count < q->len : q->count > 0;
+}
+
+// Called with q->mu held. Waits until the queue has room (for_send) or an item, or ticks elapse.
+static inline bool host_queue_wait(host_queue_t *q, bool for_send, TickType_t ticks)
+{
+    pthread_cond_t *cond = for_send ? &q->not_full : &q->not_empty;
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ticks / 1000;
+    deadline.tv_nsec += (long)(ticks % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    int rc = 0;
+    while (!host_queue_ready(q, for_send) && ticks != 0 && rc != ETIMEDOUT) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(cond, &q->mu);
+        } else {
+            rc = pthread_cond_timedwait(cond, &q->mu, &deadline);
+        }
+    }
+    return host_queue_ready(q, for_send);
+}
+
+static inline BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&q->mu);
+    if (!host_queue_wait(q, true, ticks)) {
+        pthread_mutex_unlock(&q->mu);
+        return pdFALSE;
+    }
+    memcpy(q->items + ((q->head + q->count) % q->len) * q->item_size, item, q->item_size);
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->mu);
+    return pdTRUE;
+}
+
+static inline BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&q->mu);
+    if (!host_queue_wait(q, false, ticks)) {
+        pthread_mutex_unlock(&q->mu);
+        return pdFALSE;
+    }
+    memcpy(item, q->items + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->mu);
+    return pdTRUE;
+}
+
+static inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    pthread_mutex_lock(&q->mu);
+    const UBaseType_t n = (UBaseType_t)q->count;
+    pthread_mutex_unlock(&q->mu);
+    return n;
+}
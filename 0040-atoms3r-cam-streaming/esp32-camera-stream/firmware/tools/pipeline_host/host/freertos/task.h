@@ -0,0 +1,56 @@
+/* Host stand-in: tasks are detached pthreads; core and priority are ignored. */
+#pragma once
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+
+typedef pthread_t TaskHandle_t;
+
+typedef struct {
+    void (*fn)(void *);
+    void *arg;
+} host_task_start_t;
+
+static inline void *host_task_trampoline(void *p)
+{
+    host_task_start_t start = *(host_task_start_t *)p;
+    free(p);
+    start.fn(start.arg);
+    return NULL;
+}
+
+static inline BaseType_t xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, uint32_t stack, void *arg,
+                                                 UBaseType_t prio, TaskHandle_t *out, BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+    (void)prio;
+    (void)core;
+    host_task_start_t *start = malloc(sizeof(*start));
+    if (!start) return pdFALSE;
+    start->fn = fn;
+    start->arg = arg;
+    pthread_t t;
+    if (pthread_create(&t, NULL, host_task_trampoline, start) != 0) {
+        free(start);
+        return pdFALSE;
+    }
+    pthread_detach(t);
+    if (out) *out = t;
+    return pdPASS;
+}
+
+static inline void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = {.tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static inline void vTaskDelete(void *task)
+{
+    (void)task;
+    pthread_exit(NULL);
+}
@@ -0,0 +1,299 @@
+/*
+ * Host test for the capture/encode/send pipeline (main/frame_pipeline.c).
+ *
+ * Runs the pipeline on pthreads (stand-in FreeRTOS headers in host/) with
+ * synthetic stages: capture, encode and send sleep for fixed times, the
+ * "encoder" writes a pattern derived from the frame's sequence number and the
+ * sink checks it, so a buffer reused while still being sent is caught. Checks:
+ * throughput against the same stages run serially, drop-oldest behaviour while
+ * the sink stalls (frames stay in order, the send queue stays bounded, latency
+ * recovers right after the stall), encode failures, periodic stats reports,
+ * and that every raw frame is released. Prints JSONL.
+ *
+ * Built and run by tools/pipeline_host/run_pipeline_host.sh. Exits non-zero on failure.
+ */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "frame_pipeline.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+#define FRAME_BYTES 2048
+#define BUF_SIZE 4096
+#define SEND_DEPTH 2
+#define RUN_MS 1500
+
+typedef struct {
+    uint32_t seq;
+    int64_t t_us;
+} raw_frame_t;
+
+typedef struct {
+    int capture_ms;
+    int encode_ms;
+    int send_ms;
+    int fail_every; // encode fails for seq % fail_every == 0
+    int64_t stall_from_us;
+    int64_t stall_to_us;
+    int stall_ms;
+
+    uint32_t seq;
+    atomic_uint captured;
+    atomic_uint released;
+    atomic_uint sent;
+    atomic_uint reports;
+    atomic_bool bad_content;
+    atomic_bool out_of_order;
+    atomic_uint last_seq;
+    atomic_uint max_latency_after_stall_us;
+} sim_t;
+
+static void sleep_ms(int ms) {
+    if (ms > 0) vTaskDelay(pdMS_TO_TICKS((uint32_t)ms));
+}
+
+static void *sim_capture(void *ctx) {
+    sim_t *s = ctx;
+    sleep_ms(s->capture_ms);
+    raw_frame_t *f = malloc(sizeof(*f));
+    if (!f) return NULL;
+    f->seq = ++s->seq; // capture task only
+    f->t_us = esp_timer_get_time();
+    atomic_fetch_add(&s->captured, 1);
+    return f;
+}
+
+static void sim_release(void *ctx, void *raw) {
+    sim_t *s = ctx;
+    free(raw);
+    atomic_fetch_add(&s->released, 1);
+}
+
+static uint8_t pattern(uint32_t seq, size_t i) {
+    return (uint8_t)(seq * 31u + i * 7u);
+}
+
+static size_t sim_encode(void *ctx, void *raw, uint8_t *out, size_t cap) {
+    sim_t *s = ctx;
+    const raw_frame_t *f = raw;
+    sleep_ms(s->encode_ms);
+    if (s->fail_every && f->seq % (uint32_t)s->fail_every == 0) return 0;
+    if (cap < FRAME_BYTES) return 0;
+    memcpy(out, f, sizeof(*f));
+    for (size_t i = sizeof(*f); i < FRAME_BYTES; i++) out[i] = pattern(f->seq, i);
+    return FRAME_BYTES;
+}
+
+static bool sim_send(void *ctx, const uint8_t *data, size_t len) {
+    sim_t *s = ctx;
+    raw_frame_t f;
+    memcpy(&f, data, sizeof(f));
+
+    const int64_t now = esp_timer_get_time();
+    const bool stalled = now >= s->stall_from_us && now < s->stall_to_us;
+    sleep_ms(stalled ? s->stall_ms : s->send_ms);
+
+    // Content must still be intact after the (slow) send.
+    bool ok = len == FRAME_BYTES;
+    for (size_t i = sizeof(f); ok && i < len; i++) ok = data[i] == pattern(f.seq, i);
+    raw_frame_t again;
+    memcpy(&again, data, sizeof(again));
+    if (!ok || again.seq != f.seq) atomic_store(&s->bad_content, true);
+
+    if (f.seq <= atomic_load(&s->last_seq)) atomic_store(&s->out_of_order, true);
+    atomic_store(&s->last_seq, f.seq);
+    atomic_fetch_add(&s->sent, 1);
+
+    // Frames captured well after the stall ended must arrive promptly.
+    if (s->stall_to_us && f.t_us > s->stall_to_us + 100000) {
+        const unsigned lat = (unsigned)(esp_timer_get_time() - f.t_us);
+        if (lat > atomic_load(&s->max_latency_after_stall_us)) atomic_store(&s->max_latency_after_stall_us, lat);
+    }
+    return true;
+}
+
+static void sim_report(void *ctx, const frame_pipeline_stats_t *window, int64_t elapsed_us) {
+    sim_t *s = ctx;
+    char line[512];
+    const int n = frame_pipeline_format_stats(window, elapsed_us, line, sizeof(line));
+    if (n <= 0 || (size_t)n >= sizeof(line) || strncmp(line, "{\"type\":\"stats\"", 15) != 0 || line[n - 1] != '}') {
+        atomic_store(&s->bad_content, true);
+    }
+    atomic_fetch_add(&s->reports, 1);
+}
+
+static void sim_init(sim_t *s, int capture_ms, int encode_ms, int send_ms) {
+    memset(s, 0, sizeof(*s));
+    s->capture_ms = capture_ms;
+    s->encode_ms = encode_ms;
+    s->send_ms = send_ms;
+}
+
+static frame_pipeline_cfg_t make_cfg(sim_t *s) {
+    return (frame_pipeline_cfg_t){
+        .capture = sim_capture,
+        .release_raw = sim_release,
+        .encode = sim_encode,
+        .send = sim_send,
+        .report = sim_report,
+        .ctx = s,
+        .buf_size = BUF_SIZE,
+        .send_depth = SEND_DEPTH,
+        .stats_interval_us = 250000,
+        .core = {0, 1, 0},
+        .priority = {5, 5, 5},
+        .stack = {4096, 4096, 4096},
+    };
+}
+
+// Same stages back to back in one thread, like the original stream task.
+static double run_serial(sim_t *s, int ms) {
+    uint8_t *buf = malloc(BUF_SIZE);
+    const int64_t t0 = esp_timer_get_time();
+    while (esp_timer_get_time() - t0 < (int64_t)ms * 1000) {
+        void *raw = sim_capture(s);
+        const size_t len = sim_encode(s, raw, buf, BUF_SIZE);
+        sim_release(s, raw);
+        if (len) sim_send(s, buf, len);
+    }
+    free(buf);
+    return (double)atomic_load(&s->sent) * 1e6 / (double)(esp_timer_get_time() - t0);
+}
+
+static bool run_pipeline(sim_t *s, int ms, frame_pipeline_stats_t *st, double *fps) {
+    frame_pipeline_cfg_t cfg = make_cfg(s);
+    frame_pipeline_t *p = NULL;
+    if (frame_pipeline_start(&cfg, &p) != ESP_OK) return false;
+    const int64_t t0 = esp_timer_get_time();
+    sleep_ms(ms);
+    frame_pipeline_get_stats(p, st);
+    *fps = (double)st->stage[FRAME_STAGE_SEND].frames * 1e6 / (double)(esp_timer_get_time() - t0);
+    frame_pipeline_stop(p);
+    return true;
+}
+
+static void print_run(const char *name, const frame_pipeline_stats_t *st, double fps) {
+    printf("{\"test\":\"%s\",\"fps\":%.1f,\"captured\":%u,\"capture_drop\":%u,\"encoded\":%u,\"encode_fail\":%u,"
+           "\"send_drop\":%u,\"sent\":%u,\"send_q_max\":%u,\"latency_avg_ms\":%.1f,\"latency_max_ms\":%.1f}\n",
+           name, fps, st->stage[FRAME_STAGE_CAPTURE].frames, st->stage[FRAME_STAGE_CAPTURE].dropped,
+           st->stage[FRAME_STAGE_ENCODE].frames, st->stage[FRAME_STAGE_ENCODE].failures,
+           st->stage[FRAME_STAGE_ENCODE].dropped, st->stage[FRAME_STAGE_SEND].frames, st->send_q_max,
+           st->stage[FRAME_STAGE_SEND].frames
+               ? (double)st->latency_us / st->stage[FRAME_STAGE_SEND].frames / 1000.0
+               : 0.0,
+           st->latency_max_us / 1000.0);
+}
+
+static void test_throughput(void) {
+    static sim_t serial, piped;
+    sim_init(&serial, 10, 25, 20);
+    const double fps_serial = run_serial(&serial, RUN_MS);
+
+    sim_init(&piped, 10, 25, 20);
+    frame_pipeline_stats_t st;
+    double fps = 0;
+    CHECK(run_pipeline(&piped, RUN_MS, &st, &fps));
+    print_run("steady", &st, fps);
+    printf("{\"test\":\"throughput\",\"serial_fps\":%.1f,\"pipeline_fps\":%.1f,\"speedup\":%.2f}\n", fps_serial, fps,
+           fps / fps_serial);
+
+    // Bounded by the slowest stage (25 ms) instead of the sum (55 ms).
+    CHECK(fps > fps_serial * 1.6);
+    CHECK(!atomic_load(&piped.bad_content) && !atomic_load(&piped.out_of_order));
+    CHECK(atomic_load(&piped.captured) == atomic_load(&piped.released));
+    CHECK(st.send_q_max <= SEND_DEPTH);
+    // Capture outpaces the encoder: older raw frames are replaced, not queued.
+    CHECK(st.stage[FRAME_STAGE_CAPTURE].dropped > 0);
+    CHECK(atomic_load(&piped.reports) >= 3);
+}
+
+static void test_stall_drops_oldest(void) {
+    static sim_t s;
+    sim_init(&s, 5, 10, 10);
+    const int64_t now = esp_timer_get_time();
+    s.stall_from_us = now + 300000;
+    s.stall_to_us = now + 900000;
+    s.stall_ms = 250;
+
+    frame_pipeline_stats_t st;
+    double fps = 0;
+    CHECK(run_pipeline(&s, RUN_MS, &st, &fps));
+    print_run("stall", &st, fps);
+
+    CHECK(st.stage[FRAME_STAGE_ENCODE].dropped > 0);
+    CHECK(st.send_q_max <= SEND_DEPTH);
+    CHECK(!atomic_load(&s.bad_content) && !atomic_load(&s.out_of_order));
+    CHECK(atomic_load(&s.captured) == atomic_load(&s.released));
+    // No backlog left over from the stall: the last stalled send may still
+    // delay the first fresh frame, but not a queue's worth of old frames.
+    const unsigned lat = atomic_load(&s.max_latency_after_stall_us);
+    printf("{\"test\":\"stall_recovery\",\"max_latency_after_ms\":%.1f}\n", lat / 1000.0);
+    CHECK(lat > 0 && lat < 300000);
+}
+
+static void test_encode_failures(void) {
+    static sim_t s;
+    sim_init(&s, 2, 5, 5);
+    s.fail_every = 5;
+
+    frame_pipeline_stats_t st;
+    double fps = 0;
+    CHECK(run_pipeline(&s, 500, &st, &fps));
+    print_run("encode_fail", &st, fps);
+
+    CHECK(st.stage[FRAME_STAGE_ENCODE].failures > 0);
+    CHECK(st.stage[FRAME_STAGE_SEND].frames > 0);
+    CHECK(!atomic_load(&s.bad_content) && !atomic_load(&s.out_of_order));
+    CHECK(atomic_load(&s.captured) == atomic_load(&s.released));
+}
+
+static void test_format_stats(void) {
+    frame_pipeline_stats_t st;
+    memset(&st, 0, sizeof(st));
+    st.stage[FRAME_STAGE_SEND].frames = 30;
+    st.stage[FRAME_STAGE_SEND].busy_us = 600000;
+    st.latency_us = 30 * 45000;
+    char buf[512];
+    const int n = frame_pipeline_format_stats(&st, 2000000, buf, sizeof(buf));
+    CHECK(n > 0 && (size_t)n < sizeof(buf));
+    CHECK(strstr(buf, "\"fps\":15.0") && strstr(buf, "\"latency_avg_ms\":45.0"));
+    CHECK(strstr(buf, "\"send\":{\"frames\":30,\"fail\":0,\"drop\":0,\"avg_ms\":20.00"));
+
+    // Truncation is reported like snprintf and never overruns.
+    char small[40];
+    memset(small, 'x', sizeof(small));
+    CHECK(frame_pipeline_format_stats(&st, 2000000, small, 32) >= 32 && small[31] == '\0' && small[32] == 'x');
+
+    CHECK(frame_pipeline_start(NULL, NULL) == ESP_ERR_INVALID_ARG);
+}
+
+int main(void) {
+    test_format_stats();
+    test_throughput();
+    test_stall_drops_oldest();
+    test_encode_failures();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
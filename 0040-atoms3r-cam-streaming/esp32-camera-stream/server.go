@@ -149,6 +149,8 @@ func (s *StreamServer) handleCameraWebSocket(w http.ResponseWriter, r *http.Requ
 			if err := s.processJPEGFrame(message); err != nil {
 				log.Printf("Error processing JPEG frame: %v", err)
 			}
+		} else if messageType == websocket.TextMessage {
+			log.Printf("Camera: %s", message)
 		} else {
 			log.Printf("Camera message type %d (%d bytes)", messageType, len(message))
 		}
@@ -512,13 +512,15 @@ namespace jpge {
         }
     }
 
-    void jpeg_encoder::load_mcu(const void *pSrc)
+    void jpeg_encoder::load_mcu(const void *pSrc, scanline_converter convert)
     {
         const uint8* Psrc = reinterpret_cast<const uint8*>(pSrc);
 
         uint8* pDst = m_mcu_lines[m_mcu_y_ofs]; // OK to write up to m_image_bpl_xlt bytes to pDst
 
-        if (m_num_components == 1) {
+        if (convert) {
+            convert(pDst, Psrc, m_image_x);
+        } else if (m_num_components == 1) {
             if (m_image_bpp == 3)
                 RGB_to_Y(pDst, Psrc, m_image_x);
             else
@@ -709,6 +711,11 @@ namespace jpge {
     }
 
     bool jpeg_encoder::process_scanline(const void* pScanline)
+    {
+        return process_scanline(pScanline, NULL);
+    }
+
+    bool jpeg_encoder::process_scanline(const void* pScanline, scanline_converter convert)
     {
         if ((m_pass_num < 1) || (m_pass_num > 2)) {
             return false;
@@ -719,7 +726,7 @@ namespace jpge {
                     return false;
                 }
             } else {
-                load_mcu(pScanline);
+                load_mcu(pScanline, convert);
             }
         }
         return m_all_stream_writes_succeeded;
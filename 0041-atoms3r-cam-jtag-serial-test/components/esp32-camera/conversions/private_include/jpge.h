@@ -70,6 +70,14 @@ namespace jpge
             // Returns false on out of memory or if a stream write fails.
             bool process_scanline(const void* pScanline);
 
+            // Converts num_pixels source pixels straight into the encoder's MCU line:
+            // YCbCr triplets for color images, Y bytes for Y_ONLY.
+            typedef void (*scanline_converter)(uint8 *pDst, const uint8 *pSrc, int num_pixels);
+
+            // As above, but the scanline is in the caller's pixel format and convert()
+            // replaces the built-in RGB/Y to YCbCr step (no intermediate RGB line).
+            bool process_scanline(const void* pScanline, scanline_converter convert);
+
             // Deinitializes the compressor, freeing any allocated memory. May be called at any time.
             void deinit();
 
@@ -132,7 +140,7 @@ namespace jpge
 
             void process_mcu_row();
             bool process_end_of_image();
-            void load_mcu(const void* src);
+            void load_mcu(const void* src, scanline_converter convert);
             void clear();
             void init();
     };
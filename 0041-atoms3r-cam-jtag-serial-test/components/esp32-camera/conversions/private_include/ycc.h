@@ -0,0 +1,28 @@
+// Scanline converters from camera pixel formats to the YCbCr triplets the JPEG
+// encoder works on (see jpge::jpeg_encoder::scanline_converter).
+#ifndef _CONVERSIONS_YCC_H_
+#define _CONVERSIONS_YCC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// RGB565, big-endian as delivered by the camera. Bit-exact with expanding to
+// RGB888 and running jpge's RGB_to_YCC.
+void rgb565_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels);
+
+// RGB888 in camera byte order (B, G, R). Bit-exact with jpge's RGB_to_YCC.
+void rgb888_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels);
+
+// YUYV with studio-range (16-235) Y, rescaled to the full-range YCbCr JPEG
+// expects. Not bit-exact with the old YUV -> RGB -> YCbCr round trip through
+// yuv2rgb(), whose table has the U and V green terms swapped.
+void yuv422_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CONVERSIONS_YCC_H_ */
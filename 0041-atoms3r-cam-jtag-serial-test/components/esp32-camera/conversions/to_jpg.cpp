@@ -19,7 +19,7 @@
 #include "esp_camera.h"
 #include "img_converters.h"
 #include "jpge.h"
-#include "yuv.h"
+#include "ycc.h"
 
 #if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_ARDUHAL_ESP_LOG)
 #include "esp32-hal-log.h"
@@ -43,59 +43,34 @@ static void *_malloc(size_t size)
     return NULL;
 }
 
-static IRAM_ATTR void convert_line_format(uint8_t * src, pixformat_t format, uint8_t * dst, size_t width, size_t in_channels, size_t line)
-{
-    int i=0, o=0, l=0;
-    if(format == PIXFORMAT_GRAYSCALE) {
-        memcpy(dst, src + line * width, width);
-    } else if(format == PIXFORMAT_RGB888) {
-        l = width * 3;
-        src += l * line;
-        for(i=0; i<l; i+=3) {
-            dst[o++] = src[i+2];
-            dst[o++] = src[i+1];
-            dst[o++] = src[i];
-        }
-    } else if(format == PIXFORMAT_RGB565) {
-        l = width * 2;
-        src += l * line;
-        for(i=0; i<l; i+=2) {
-            dst[o++] = src[i] & 0xF8;
-            dst[o++] = (src[i] & 0x07) << 5 | (src[i+1] & 0xE0) >> 3;
-            dst[o++] = (src[i+1] & 0x1F) << 3;
-        }
-    } else if(format == PIXFORMAT_YUV422) {
-        uint8_t y0, y1, u, v;
-        uint8_t r, g, b;
-        l = width * 2;
-        src += l * line;
-        for(i=0; i<l; i+=4) {
-            y0 = src[i];
-            u = src[i+1];
-            y1 = src[i+2];
-            v = src[i+3];
-
-            yuv2rgb(y0, u, v, &r, &g, &b);
-            dst[o++] = r;
-            dst[o++] = g;
-            dst[o++] = b;
-
-            yuv2rgb(y1, u, v, &r, &g, &b);
-            dst[o++] = r;
-            dst[o++] = g;
-            dst[o++] = b;
-        }
-    }
-}
-
 bool convert_image(uint8_t *src, uint16_t width, uint16_t height, pixformat_t format, uint8_t quality, jpge::output_stream *dst_stream)
 {
     int num_channels = 3;
     jpge::subsampling_t subsampling = jpge::H2V2;
+    jpge::jpeg_encoder::scanline_converter convert = NULL;
+    size_t src_bpl = width * 2;
 
-    if(format == PIXFORMAT_GRAYSCALE) {
+    // Color formats are converted straight into the encoder's MCU lines;
+    // grayscale lines are already what a Y_ONLY encoder consumes.
+    switch(format) {
+    case PIXFORMAT_GRAYSCALE:
         num_channels = 1;
         subsampling = jpge::Y_ONLY;
+        src_bpl = width;
+        break;
+    case PIXFORMAT_RGB888:
+        convert = rgb888_to_ycc;
+        src_bpl = width * 3;
+        break;
+    case PIXFORMAT_RGB565:
+        convert = rgb565_to_ycc;
+        break;
+    case PIXFORMAT_YUV422:
+        convert = yuv422_to_ycc;
+        break;
+    default:
+        ESP_LOGE(TAG, "Unsupported format for JPG: %d", format);
+        return false;
     }
 
     if(!quality) {
@@ -115,21 +90,12 @@ bool convert_image(uint8_t *src, uint16_t width, uint16_t height, pixformat_t fo
         return false;
     }
 
-    uint8_t* line = (uint8_t*)_malloc(width * num_channels);
-    if(!line) {
-        ESP_LOGE(TAG, "Scan line malloc failed");
-        return false;
-    }
-
     for (int i = 0; i < height; i++) {
-        convert_line_format(src, format, line, width, num_channels, i);
-        if (!dst_image.process_scanline(line)) {
+        if (!dst_image.process_scanline(src + i * src_bpl, convert)) {
             ESP_LOGE(TAG, "JPG process line %u failed", i);
-            free(line);
             return false;
         }
     }
-    free(line);
 
     if (!dst_image.process_scanline(NULL)) {
         ESP_LOGE(TAG, "JPG image finish failed");
@@ -153,7 +119,7 @@ public:
         index += ocb(oarg, index, data, len);
         return true;
     }
-    virtual size_t get_size() const
+    virtual jpge::uint get_size() const
     {
         return index;
     }
@@ -199,7 +165,7 @@ public:
         return true;
     }
 
-    virtual size_t get_size() const
+    virtual jpge::uint get_size() const
     {
         return index;
     }
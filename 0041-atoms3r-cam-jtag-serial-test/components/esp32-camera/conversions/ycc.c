@@ -0,0 +1,139 @@
+// Scanline converters for to_jpg: camera pixels -> YCbCr, written straight into
+// the encoder's MCU lines.
+//
+// RGB565 is two table lookups per component: the first byte holds R and the
+// top of G, the second the rest of G and B, and the conversion is linear, so
+// each byte's share of Y/Cb/Cr (rounding and the +128 chroma offset folded in)
+// comes from a 256-entry table. For 5/6-bit inputs the results never leave
+// 0..255, so there is no clamping. RGB888 keeps the multiplies (single-cycle on
+// Xtensa; three more tables would be 9 KB of cache pressure). YUV422 maps Y and
+// U/V through 256-byte range tables. All loops do four pixels per iteration.
+#include "ycc.h"
+#include <stdbool.h>
+#include "esp_attr.h"
+
+// Same fixed-point coefficients as jpge.cpp.
+#define YR 19595
+#define YG 38470
+#define YB 7471
+#define CB_R -11059
+#define CB_G -21709
+#define CB_B 32768
+#define CR_R 32768
+#define CR_G -27439
+#define CR_B -5329
+
+typedef struct {
+    int32_t y;
+    int32_t cb;
+    int32_t cr;
+} ycc_part_t;
+
+static ycc_part_t rgb565_hi[256];
+static ycc_part_t rgb565_lo[256];
+static uint8_t yuv_y_full[256];
+static uint8_t yuv_c_full[256];
+static bool tables_ready = false;
+
+static uint8_t clamp_u8(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// v * 255 / range, rounded half away from zero.
+static int expand(int v, int range)
+{
+    int n = v * 255;
+    return (n >= 0) ? (n + range / 2) / range : -((-n + range / 2) / range);
+}
+
+static void init_tables(void)
+{
+    for(int i = 0; i < 256; i++) {
+        const int r = i & 0xF8, g_hi = (i & 0x07) << 5;
+        rgb565_hi[i].y = r * YR + g_hi * YG;
+        rgb565_hi[i].cb = r * CB_R + g_hi * CB_G;
+        rgb565_hi[i].cr = r * CR_R + g_hi * CR_G;
+
+        const int g_lo = (i & 0xE0) >> 3, b = (i & 0x1F) << 3;
+        rgb565_lo[i].y = g_lo * YG + b * YB + 32768;
+        rgb565_lo[i].cb = g_lo * CB_G + b * CB_B + 32768 + (128 << 16);
+        rgb565_lo[i].cr = g_lo * CR_G + b * CR_B + 32768 + (128 << 16);
+
+        yuv_y_full[i] = clamp_u8(expand(i - 16, 219));
+        yuv_c_full[i] = clamp_u8(128 + expand(i - 128, 224));
+    }
+    tables_ready = true;
+}
+
+static inline void rgb565_px(uint8_t *dst, const uint8_t *src)
+{
+    const ycc_part_t *h = &rgb565_hi[src[0]];
+    const ycc_part_t *l = &rgb565_lo[src[1]];
+    dst[0] = (uint8_t)((h->y + l->y) >> 16);
+    dst[1] = (uint8_t)((h->cb + l->cb) >> 16);
+    dst[2] = (uint8_t)((h->cr + l->cr) >> 16);
+}
+
+void IRAM_ATTR rgb565_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels)
+{
+    if(!tables_ready) {
+        init_tables();
+    }
+    for(; num_pixels >= 4; num_pixels -= 4, src += 8, dst += 12) {
+        rgb565_px(dst, src);
+        rgb565_px(dst + 3, src + 2);
+        rgb565_px(dst + 6, src + 4);
+        rgb565_px(dst + 9, src + 6);
+    }
+    for(; num_pixels; num_pixels--, src += 2, dst += 3) {
+        rgb565_px(dst, src);
+    }
+}
+
+static inline void rgb888_px(uint8_t *dst, const uint8_t *src)
+{
+    const int b = src[0], g = src[1], r = src[2];
+    // Chroma can only overshoot to 256 (pure blue/red); v - (v >> 8) folds it to 255.
+    const int cb = 128 + ((r * CB_R + g * CB_G + b * CB_B + 32768) >> 16);
+    const int cr = 128 + ((r * CR_R + g * CR_G + b * CR_B + 32768) >> 16);
+    dst[0] = (uint8_t)((r * YR + g * YG + b * YB + 32768) >> 16);
+    dst[1] = (uint8_t)(cb - (cb >> 8));
+    dst[2] = (uint8_t)(cr - (cr >> 8));
+}
+
+void IRAM_ATTR rgb888_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels)
+{
+    for(; num_pixels >= 4; num_pixels -= 4, src += 12, dst += 12) {
+        rgb888_px(dst, src);
+        rgb888_px(dst + 3, src + 3);
+        rgb888_px(dst + 6, src + 6);
+        rgb888_px(dst + 9, src + 9);
+    }
+    for(; num_pixels; num_pixels--, src += 3, dst += 3) {
+        rgb888_px(dst, src);
+    }
+}
+
+void IRAM_ATTR yuv422_to_ycc(uint8_t *dst, const uint8_t *src, int num_pixels)
+{
+    if(!tables_ready) {
+        init_tables();
+    }
+    for(; num_pixels >= 4; num_pixels -= 4, src += 8, dst += 12) {
+        const uint8_t u0 = yuv_c_full[src[1]], v0 = yuv_c_full[src[3]];
+        const uint8_t u1 = yuv_c_full[src[5]], v1 = yuv_c_full[src[7]];
+        dst[0] = yuv_y_full[src[0]]; dst[1] = u0; dst[2] = v0;
+        dst[3] = yuv_y_full[src[2]]; dst[4] = u0; dst[5] = v0;
+        dst[6] = yuv_y_full[src[4]]; dst[7] = u1; dst[8] = v1;
+        dst[9] = yuv_y_full[src[6]]; dst[10] = u1; dst[11] = v1;
+    }
+    // A trailing odd pixel uses the chroma of its (incomplete) pair, like the
+    // old converter did.
+    for(int i = 0; i < num_pixels; i++) {
+        const uint8_t *pair = src + (i & ~1) * 2;
+        dst[i * 3 + 0] = yuv_y_full[src[i * 2]];
+        dst[i * 3 + 1] = yuv_c_full[pair[1]];
+        dst[i * 3 + 2] = yuv_c_full[pair[3]];
+    }
+}
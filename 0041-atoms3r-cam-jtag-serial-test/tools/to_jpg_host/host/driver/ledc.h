@@ -0,0 +1,5 @@
+/* Host stand-in for the LEDC types referenced by camera_config_t. */
+#pragma once
+
+typedef int ledc_timer_t;
+typedef int ledc_channel_t;
@@ -0,0 +1,5 @@
+/* Host stand-in: placement attributes are no-ops. */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
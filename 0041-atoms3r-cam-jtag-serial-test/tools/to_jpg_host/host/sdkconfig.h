@@ -0,0 +1,2 @@
+/* Host stand-in: no Kconfig options set. */
+#pragma once
@@ -0,0 +1,2 @@
+/* Host stand-in (included by to_jpg.cpp, nothing used). */
+#pragma once
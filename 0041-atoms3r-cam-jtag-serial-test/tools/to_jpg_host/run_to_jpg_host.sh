@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the JPEG scanline converter host test and benchmark.
+#
+# Compiles the esp32-camera conversions (to_jpg.cpp, jpge.cpp, ycc.c, yuv.c)
+# against the stand-in headers in tools/to_jpg_host/host and compares them with
+# the previous per-pixel converter (copied into the test). Prints JSONL.
+#
+# Usage:
+#   ./tools/to_jpg_host/run_to_jpg_host.sh
+#   SANITIZE= ./tools/to_jpg_host/run_to_jpg_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+CAM_DIR="${HERE}/../../components/esp32-camera"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/cam-to-jpg-host}"
+CC="${CC:-cc}"
+CXX="${CXX:-c++}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+# jpge's DCT left-shifts negative coefficients (fine with GCC/Xtensa); keep
+# UBSan quiet about that one pattern.
+SANITIZE="${SANITIZE--fsanitize=address,undefined -fno-sanitize=shift-base}"
+
+INCLUDES=(-I"${HERE}/host" -I"${CAM_DIR}/driver/include" -I"${CAM_DIR}/conversions/include"
+  -I"${CAM_DIR}/conversions/private_include")
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} "${INCLUDES[@]}" -c "${CAM_DIR}/conversions/ycc.c" -o "${BUILD_DIR}/ycc.o"
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} "${INCLUDES[@]}" -c "${CAM_DIR}/conversions/yuv.c" -o "${BUILD_DIR}/yuv.o"
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} "${INCLUDES[@]}" \
+  -o "${BUILD_DIR}/to_jpg_host_test" \
+  "${HERE}/to_jpg_host_test.cpp" "${CAM_DIR}/conversions/to_jpg.cpp" "${CAM_DIR}/conversions/jpge.cpp" \
+  "${BUILD_DIR}/ycc.o" "${BUILD_DIR}/yuv.o" -lm
+"${BUILD_DIR}/to_jpg_host_test"
@@ -0,0 +1,450 @@
+/*
+ * Host test and benchmark for the esp32-camera JPEG scanline converters
+ * (components/esp32-camera/conversions/ycc.c, used by to_jpg.cpp).
+ *
+ * The reference is the converter to_jpg.cpp used before: convert_line_format()
+ * to an RGB888 line, then jpge's built-in RGB_to_YCC. Both are copied below
+ * unchanged. Checks:
+ *   - rgb565_to_ycc / rgb888_to_ycc match the reference for every input value;
+ *   - fmt2jpg_cb output is byte-identical to the reference encoder for RGB565,
+ *     RGB888 and grayscale on a set of synthetic test images (incl. an odd size);
+ *   - yuv422_to_ycc (range rescale instead of the YUV -> RGB -> YCbCr round trip)
+ *     reproduces the source image's YCbCr. It is not compared bit for bit: the
+ *     old round trip goes through yuv.c's table, whose green U/V coefficients
+ *     are swapped (pure red comes back as 253,62,0), so its PSNR against the
+ *     source is only reported.
+ * Prints JSONL, including per-format conversion and end-to-end encode timings.
+ *
+ * Built and run by tools/to_jpg_host/run_to_jpg_host.sh. Exits non-zero on failure.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "img_converters.h"
+#include "jpge.h"
+#include "ycc.h"
+#include "yuv.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+// ---- Reference: to_jpg.cpp / jpge.cpp before the scanline converters ----
+
+static const int YR = 19595, YG = 38470, YB = 7471, CB_R = -11059, CB_G = -21709, CB_B = 32768, CR_R = 32768,
+                 CR_G = -27439, CR_B = -5329;
+
+static inline uint8_t ref_clamp(int i) {
+    if (i < 0) {
+        i = 0;
+    } else if (i > 255) {
+        i = 255;
+    }
+    return static_cast<uint8_t>(i);
+}
+
+static void ref_RGB_to_YCC(uint8_t *pDst, const uint8_t *pSrc, int num_pixels) {
+    for (; num_pixels; pDst += 3, pSrc += 3, num_pixels--) {
+        const int r = pSrc[0], g = pSrc[1], b = pSrc[2];
+        pDst[0] = static_cast<uint8_t>((r * YR + g * YG + b * YB + 32768) >> 16);
+        pDst[1] = ref_clamp(128 + ((r * CB_R + g * CB_G + b * CB_B + 32768) >> 16));
+        pDst[2] = ref_clamp(128 + ((r * CR_R + g * CR_G + b * CR_B + 32768) >> 16));
+    }
+}
+
+static void ref_convert_line_format(uint8_t *src, pixformat_t format, uint8_t *dst, size_t width, size_t line) {
+    int i = 0, o = 0, l = 0;
+    if (format == PIXFORMAT_GRAYSCALE) {
+        memcpy(dst, src + line * width, width);
+    } else if (format == PIXFORMAT_RGB888) {
+        l = width * 3;
+        src += l * line;
+        for (i = 0; i < l; i += 3) {
+            dst[o++] = src[i + 2];
+            dst[o++] = src[i + 1];
+            dst[o++] = src[i];
+        }
+    } else if (format == PIXFORMAT_RGB565) {
+        l = width * 2;
+        src += l * line;
+        for (i = 0; i < l; i += 2) {
+            dst[o++] = src[i] & 0xF8;
+            dst[o++] = (src[i] & 0x07) << 5 | (src[i + 1] & 0xE0) >> 3;
+            dst[o++] = (src[i + 1] & 0x1F) << 3;
+        }
+    } else if (format == PIXFORMAT_YUV422) {
+        uint8_t y0, y1, u, v;
+        uint8_t r, g, b;
+        l = width * 2;
+        src += l * line;
+        for (i = 0; i < l; i += 4) {
+            y0 = src[i];
+            u = src[i + 1];
+            y1 = src[i + 2];
+            v = src[i + 3];
+
+            yuv2rgb(y0, u, v, &r, &g, &b);
+            dst[o++] = r;
+            dst[o++] = g;
+            dst[o++] = b;
+
+            yuv2rgb(y1, u, v, &r, &g, &b);
+            dst[o++] = r;
+            dst[o++] = g;
+            dst[o++] = b;
+        }
+    }
+}
+
+class vec_stream : public jpge::output_stream {
+public:
+    std::vector<uint8_t> data;
+    virtual bool put_buf(const void *buf, int len) {
+        if (buf && len) data.insert(data.end(), (const uint8_t *)buf, (const uint8_t *)buf + len);
+        return true;
+    }
+    virtual jpge::uint get_size() const { return data.size(); }
+};
+
+static bool ref_encode(uint8_t *src, int width, int height, pixformat_t format, int quality, std::vector<uint8_t> &out) {
+    const int num_channels = format == PIXFORMAT_GRAYSCALE ? 1 : 3;
+    jpge::params params;
+    params.m_subsampling = format == PIXFORMAT_GRAYSCALE ? jpge::Y_ONLY : jpge::H2V2;
+    params.m_quality = quality;
+    vec_stream stream;
+    jpge::jpeg_encoder enc;
+    if (!enc.init(&stream, width, height, num_channels, params)) return false;
+    // Sized for the YUV422 over-read at odd widths.
+    std::vector<uint8_t> line((width + 1) * num_channels);
+    for (int y = 0; y < height; y++) {
+        ref_convert_line_format(src, format, line.data(), width, y);
+        if (!enc.process_scanline(line.data())) return false;
+    }
+    if (!enc.process_scanline(NULL)) return false;
+    out.swap(stream.data);
+    return true;
+}
+
+// ---- Test images ----
+
+typedef struct {
+    const char *name;
+    int w, h;
+    std::vector<uint8_t> rgb; // R, G, B
+} image_t;
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+static image_t make_image(const char *name, int w, int h, int kind) {
+    image_t img = {name, w, h, std::vector<uint8_t>(w * h * 3)};
+    static const uint8_t bars[8][3] = {{235, 235, 235}, {235, 235, 16}, {16, 235, 235}, {16, 235, 16},
+                                       {235, 16, 235}, {235, 16, 16}, {16, 16, 235}, {16, 16, 16}};
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t *p = &img.rgb[(y * w + x) * 3];
+            switch (kind) {
+                case 0: // gradients
+                    p[0] = x * 255 / (w - 1);
+                    p[1] = y * 255 / (h - 1);
+                    p[2] = 255 - (x + y) * 255 / (w + h - 2);
+                    break;
+                case 1: { // saturated color bars
+                    const uint8_t *c = bars[x * 8 / w];
+                    p[0] = c[0];
+                    p[1] = c[1];
+                    p[2] = c[2];
+                    break;
+                }
+                case 2: { // smooth "scene" plus sensor-like noise
+                    const double fx = x / (double)w, fy = y / (double)h;
+                    const int n = (int)(hash32(y * 7919 + x) & 15) - 8;
+                    const double base = 110 + 60 * sin(fx * 7.0) * cos(fy * 5.0);
+                    p[0] = ref_clamp((int)(base + 50 * fy) + n);
+                    p[1] = ref_clamp((int)(base + 30 * sin(fx * 13.0)) + n);
+                    p[2] = ref_clamp((int)(base - 40 * fx + 20 * cos(fy * 9.0)) + n);
+                    break;
+                }
+                default: { // fine checkerboard, full-range extremes
+                    const bool on = ((x >> 1) ^ (y >> 1)) & 1;
+                    p[0] = on ? 255 : 0;
+                    p[1] = on ? 255 : (x & 1) * 255;
+                    p[2] = on ? 0 : 255;
+                    break;
+                }
+            }
+        }
+    }
+    return img;
+}
+
+static std::vector<uint8_t> to_format(const image_t &img, pixformat_t format) {
+    const int n = img.w * img.h;
+    std::vector<uint8_t> out;
+    for (int i = 0; i < n; i++) {
+        const int r = img.rgb[i * 3], g = img.rgb[i * 3 + 1], b = img.rgb[i * 3 + 2];
+        switch (format) {
+            case PIXFORMAT_RGB888: // camera byte order
+                out.push_back(b);
+                out.push_back(g);
+                out.push_back(r);
+                break;
+            case PIXFORMAT_RGB565: {
+                const uint16_t v = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+                out.push_back(v >> 8);
+                out.push_back(v & 0xFF);
+                break;
+            }
+            case PIXFORMAT_GRAYSCALE:
+                out.push_back((uint8_t)((r * YR + g * YG + b * YB + 32768) >> 16));
+                break;
+            default: { // YUYV, BT.601 studio range; chroma from the even pixel of each pair
+                const int y = (int)lround(16 + (65.481 * r + 128.553 * g + 24.966 * b) / 255.0);
+                const int pair = i - (i % img.w % 2);
+                const int pr = img.rgb[pair * 3], pg = img.rgb[pair * 3 + 1], pb = img.rgb[pair * 3 + 2];
+                const int u = (int)lround(128 + (-37.797 * pr - 74.203 * pg + 112.0 * pb) / 255.0);
+                const int v = (int)lround(128 + (112.0 * pr - 93.786 * pg - 18.214 * pb) / 255.0);
+                out.push_back(ref_clamp(y));
+                out.push_back(ref_clamp((i % img.w % 2) ? v : u));
+                break;
+            }
+        }
+    }
+    if (format == PIXFORMAT_YUV422) out.resize(out.size() + 4); // old converter's odd-width over-read
+    return out;
+}
+
+// ---- Helpers ----
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size_t vec_out(void *arg, size_t index, const void *data, size_t len) {
+    std::vector<uint8_t> *v = (std::vector<uint8_t> *)arg;
+    if (!data) return 0;
+    if (v->size() < index + len) v->resize(index + len);
+    memcpy(v->data() + index, data, len);
+    return len;
+}
+
+static bool new_encode(uint8_t *src, size_t len, int w, int h, pixformat_t format, int quality,
+                       std::vector<uint8_t> &out) {
+    out.clear();
+    return fmt2jpg_cb(src, len, w, h, format, quality, vec_out, &out);
+}
+
+static const char *format_name(pixformat_t f) {
+    switch (f) {
+        case PIXFORMAT_RGB565: return "rgb565";
+        case PIXFORMAT_RGB888: return "rgb888";
+        case PIXFORMAT_YUV422: return "yuv422";
+        case PIXFORMAT_GRAYSCALE: return "gray";
+        default: return "?";
+    }
+}
+
+static double psnr(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, int comp) {
+    double se = 0;
+    size_t n = 0;
+    for (size_t i = comp; i < a.size(); i += 3, n++) {
+        const double d = (double)a[i] - b[i];
+        se += d * d;
+    }
+    return se == 0 ? 99.0 : 10 * log10(255.0 * 255.0 * n / se);
+}
+
+// ---- Tests ----
+
+static void test_rgb565_exhaustive(void) {
+    std::vector<uint8_t> src(65536 * 2), rgb(65536 * 3), ref(65536 * 3), got(65536 * 3);
+    for (int v = 0; v < 65536; v++) {
+        src[v * 2] = v >> 8;
+        src[v * 2 + 1] = v & 0xFF;
+    }
+    ref_convert_line_format(src.data(), PIXFORMAT_RGB565, rgb.data(), 65536, 0);
+    ref_RGB_to_YCC(ref.data(), rgb.data(), 65536);
+    rgb565_to_ycc(got.data(), src.data(), 65536);
+    CHECK(ref == got);
+    // Odd lengths exercise the tail loop.
+    rgb565_to_ycc(got.data(), src.data() + 2, 7);
+    CHECK(memcmp(got.data(), ref.data() + 3, 21) == 0);
+    printf("{\"test\":\"rgb565_exhaustive\",\"values\":65536,\"identical\":true}\n");
+}
+
+static void test_rgb888_exhaustive(void) {
+    const int n = 1 << 16; // one B, G plane per R value
+    std::vector<uint8_t> src(n * 3), rgb(n * 3), ref(n * 3), got(n * 3);
+    for (int r = 0; r < 256; r++) {
+        for (int i = 0; i < n; i++) {
+            src[i * 3] = i & 0xFF;    // B
+            src[i * 3 + 1] = i >> 8;  // G
+            src[i * 3 + 2] = r;       // R
+        }
+        ref_convert_line_format(src.data(), PIXFORMAT_RGB888, rgb.data(), n, 0);
+        ref_RGB_to_YCC(ref.data(), rgb.data(), n);
+        rgb888_to_ycc(got.data(), src.data(), n - (r & 3)); // vary the tail
+        CHECK(memcmp(ref.data(), got.data(), (n - (r & 3)) * 3) == 0);
+    }
+    printf("{\"test\":\"rgb888_exhaustive\",\"values\":16777216,\"identical\":true}\n");
+}
+
+static void test_jpeg_identical(const std::vector<image_t> &images) {
+    static const pixformat_t formats[] = {PIXFORMAT_RGB565, PIXFORMAT_RGB888, PIXFORMAT_GRAYSCALE};
+    static const int qualities[] = {12, 80};
+    for (const image_t &img : images) {
+        for (pixformat_t f : formats) {
+            std::vector<uint8_t> src = to_format(img, f);
+            for (int q : qualities) {
+                std::vector<uint8_t> ref, got;
+                CHECK(ref_encode(src.data(), img.w, img.h, f, q, ref));
+                CHECK(new_encode(src.data(), src.size(), img.w, img.h, f, q, got));
+                printf("{\"test\":\"jpeg_identical\",\"image\":\"%s\",\"format\":\"%s\",\"quality\":%d,\"bytes\":%zu,"
+                       "\"identical\":%s}\n",
+                       img.name, format_name(f), q, got.size(), ref == got ? "true" : "false");
+                CHECK(ref == got);
+            }
+        }
+    }
+}
+
+static void test_yuv422_psnr(const std::vector<image_t> &images) {
+    for (const image_t &img : images) {
+        std::vector<uint8_t> src = to_format(img, PIXFORMAT_YUV422);
+        const int n = img.w * img.h;
+        std::vector<uint8_t> rgb((img.w + 1) * 3), ref(n * 3), got(n * 3), truth(n * 3);
+        for (int y = 0; y < img.h; y++) {
+            ref_convert_line_format(src.data(), PIXFORMAT_YUV422, rgb.data(), img.w, y);
+            ref_RGB_to_YCC(&ref[y * img.w * 3], rgb.data(), img.w);
+            yuv422_to_ycc(&got[y * img.w * 3], &src[y * img.w * 2], img.w);
+        }
+        ref_RGB_to_YCC(truth.data(), img.rgb.data(), n);
+        // Chroma in the truth image is per pixel; compare against the pair's
+        // (even pixel) chroma the YUYV source actually carries.
+        for (int i = 0; i < n; i++) {
+            const int pair = i - (i % img.w % 2);
+            truth[i * 3 + 1] = truth[pair * 3 + 1];
+            truth[i * 3 + 2] = truth[pair * 3 + 2];
+        }
+
+        double min_vs_ref = 99, new_vs_truth = 99, ref_vs_truth = 99;
+        for (int c = 0; c < 3; c++) {
+            min_vs_ref = fmin(min_vs_ref, psnr(ref, got, c));
+            new_vs_truth = fmin(new_vs_truth, psnr(truth, got, c));
+            ref_vs_truth = fmin(ref_vs_truth, psnr(truth, ref, c));
+        }
+        printf("{\"test\":\"yuv422_psnr\",\"image\":\"%s\",\"min_psnr_vs_old_db\":%.1f,\"new_vs_source_db\":%.1f,"
+               "\"old_vs_source_db\":%.1f}\n",
+               img.name, min_vs_ref, new_vs_truth, ref_vs_truth);
+        CHECK(new_vs_truth >= 38.0); // odd widths: the last column has no V of its own
+        CHECK(new_vs_truth >= ref_vs_truth);
+
+        std::vector<uint8_t> jpg;
+        CHECK(new_encode(src.data(), src.size(), img.w, img.h, PIXFORMAT_YUV422, 80, jpg));
+        CHECK(jpg.size() > 4 && jpg[0] == 0xFF && jpg[1] == 0xD8 && jpg[jpg.size() - 2] == 0xFF &&
+              jpg[jpg.size() - 1] == 0xD9);
+    }
+}
+
+static void test_unsupported_format(void) {
+    uint8_t px[16] = {0};
+    std::vector<uint8_t> out;
+    CHECK(!new_encode(px, sizeof(px), 2, 2, PIXFORMAT_RAW, 80, out));
+}
+
+static void bench(const image_t &img) {
+    static const pixformat_t formats[] = {PIXFORMAT_RGB565, PIXFORMAT_RGB888, PIXFORMAT_YUV422, PIXFORMAT_GRAYSCALE};
+    const int iters = 50;
+    for (pixformat_t f : formats) {
+        std::vector<uint8_t> src = to_format(img, f);
+        const int ch = f == PIXFORMAT_GRAYSCALE ? 1 : 3;
+        std::vector<uint8_t> line((img.w + 1) * 3), ycc(img.w * 3);
+        volatile uint8_t sink = 0;
+
+        double t0 = now_s();
+        for (int it = 0; it < iters; it++) {
+            for (int y = 0; y < img.h; y++) {
+                ref_convert_line_format(src.data(), f, line.data(), img.w, y);
+                if (ch == 3) {
+                    ref_RGB_to_YCC(ycc.data(), line.data(), img.w);
+                } else {
+                    memcpy(ycc.data(), line.data(), img.w);
+                }
+                sink ^= ycc[y % img.w];
+            }
+        }
+        const double conv_old = (now_s() - t0) / iters;
+
+        t0 = now_s();
+        for (int it = 0; it < iters; it++) {
+            for (int y = 0; y < img.h; y++) {
+                switch (f) {
+                    case PIXFORMAT_RGB565: rgb565_to_ycc(ycc.data(), &src[y * img.w * 2], img.w); break;
+                    case PIXFORMAT_RGB888: rgb888_to_ycc(ycc.data(), &src[y * img.w * 3], img.w); break;
+                    case PIXFORMAT_YUV422: yuv422_to_ycc(ycc.data(), &src[y * img.w * 2], img.w); break;
+                    default: break; // grayscale lines go to the encoder as they are
+                }
+                sink ^= ycc[y % img.w];
+            }
+        }
+        const double conv_new = (now_s() - t0) / iters;
+
+        std::vector<uint8_t> jpg;
+        t0 = now_s();
+        for (int it = 0; it < iters / 5; it++) ref_encode(src.data(), img.w, img.h, f, 80, jpg);
+        const double enc_old = (now_s() - t0) / (iters / 5);
+        t0 = now_s();
+        for (int it = 0; it < iters / 5; it++) new_encode(src.data(), src.size(), img.w, img.h, f, 80, jpg);
+        const double enc_new = (now_s() - t0) / (iters / 5);
+        (void)sink;
+
+        printf("{\"bench\":\"to_jpg\",\"format\":\"%s\",\"image\":\"%s\",\"w\":%d,\"h\":%d,\"convert_old_us\":%.1f,"
+               "\"convert_new_us\":%.1f,\"convert_speedup\":%.2f,\"encode_old_us\":%.1f,\"encode_new_us\":%.1f}\n",
+               format_name(f), img.name, img.w, img.h, conv_old * 1e6, conv_new * 1e6,
+               conv_new > 0 ? conv_old / conv_new : 0.0, enc_old * 1e6, enc_new * 1e6);
+    }
+}
+
+int main(void) {
+    std::vector<image_t> images;
+    images.push_back(make_image("gradient", 320, 240, 0));
+    images.push_back(make_image("bars", 320, 240, 1));
+    images.push_back(make_image("scene", 320, 240, 2));
+    images.push_back(make_image("checker", 320, 240, 3));
+    images.push_back(make_image("scene_odd", 97, 61, 2));
+
+    test_rgb565_exhaustive();
+    test_rgb888_exhaustive();
+    test_jpeg_identical(images);
+    test_yuv422_psnr(images);
+    test_unsupported_format();
+    bench(images[2]);
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
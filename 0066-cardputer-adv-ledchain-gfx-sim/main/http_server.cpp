@@ -21,6 +21,7 @@
 #include "sdkconfig.h"
 
 #include "mqjs/js_service.h"
+#include "mqjs/mqjs_events.h"
 
 static const char *TAG = "0066_http";
 
@@ -168,6 +169,46 @@ static esp_err_t js_mem_get(httpd_req_t *req)
     return send_text(req, "text/plain; charset=utf-8", out.c_str());
 }
 
+// GET /api/js/prof[?action=start|stop|dump] (default: dump)
+static esp_err_t js_prof_get(httpd_req_t *req)
+{
+    char query[32] = {};
+    char action[8] = "dump";
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        (void)httpd_query_key_value(query, "action", action, sizeof(action));
+    }
+
+    std::string out;
+    const esp_err_t st = js_service_alloc_profile(action, &out);
+    if (st == ESP_ERR_INVALID_ARG) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "action must be start|stop|dump");
+    if (st != ESP_OK) return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "profile failed");
+    return send_text(req, "text/plain; charset=utf-8", out.c_str());
+}
+
+static esp_err_t js_events_get(httpd_req_t *req)
+{
+    mqjs_0066_events_stats_t st = {};
+    mqjs_0066_events_get_stats(&st);
+
+    char buf[320];
+    snprintf(buf,
+             sizeof(buf),
+             "{\"ok\":true,\"pushed\":%lu,\"dropped\":%lu,\"frames\":%lu,\"frame_bytes\":%lu,\"flushes\":%lu,"
+             "\"pending_bytes\":%lu,\"queue_lat_us_last\":%lu,\"queue_lat_us_max\":%lu,"
+             "\"flush_us_last\":%lu,\"flush_us_max\":%lu}",
+             (unsigned long)st.pushed,
+             (unsigned long)st.dropped,
+             (unsigned long)st.frames,
+             (unsigned long)st.frame_bytes,
+             (unsigned long)st.flushes,
+             (unsigned long)st.pending_bytes,
+             (unsigned long)st.queue_lat_us_last,
+             (unsigned long)st.queue_lat_us_max,
+             (unsigned long)st.flush_us_last,
+             (unsigned long)st.flush_us_max);
+    return send_json(req, buf);
+}
+
 static bool json_read_body(httpd_req_t *req, char *buf, size_t buf_len, size_t *out_len)
 {
     if (!req || !buf || buf_len == 0) return false;
@@ -657,6 +698,18 @@ esp_err_t http_server_start(sim_engine_t *engine)
     js_mem_slash.handler = js_mem_get;
     httpd_register_uri_handler(s_server, &js_mem_slash);
 
+    httpd_uri_t js_prof = {};
+    js_prof.uri = "/api/js/prof";
+    js_prof.method = HTTP_GET;
+    js_prof.handler = js_prof_get;
+    httpd_register_uri_handler(s_server, &js_prof);
+
+    httpd_uri_t js_events = {};
+    js_events.uri = "/api/js/events";
+    js_events.method = HTTP_GET;
+    js_events.handler = js_events_get;
+    httpd_register_uri_handler(s_server, &js_events);
+
 #if CONFIG_HTTPD_WS_SUPPORT
     httpd_uri_t ws = {};
     ws.uri = "/ws";
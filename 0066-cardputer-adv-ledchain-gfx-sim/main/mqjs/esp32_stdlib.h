@@ -800,70 +800,76 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   0x53746573,
   0x6b726170,
   0x0000656c,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "gpio" (offset=796) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (6 << (JS_MTAG_BITS + 3)), /* "events" (offset=796) */
+  0x6e657665,
+  0x00007374,
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "stats" (offset=799) */
+  0x74617473,
+  0x00000073,
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "gpio" (offset=802) */
   0x6f697067,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "high" (offset=799) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "high" (offset=805) */
   0x68676968,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (3 << (JS_MTAG_BITS + 3)), /* "low" (offset=802) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (3 << (JS_MTAG_BITS + 3)), /* "low" (offset=808) */
   0x00776f6c,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (6 << (JS_MTAG_BITS + 3)), /* "square" (offset=804) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (6 << (JS_MTAG_BITS + 3)), /* "square" (offset=810) */
   0x61757173,
   0x00006572,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "pulse" (offset=807) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "pulse" (offset=813) */
   0x736c7570,
   0x00000065,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "setMany" (offset=810) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "setMany" (offset=816) */
   0x4d746573,
   0x00796e61,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "stop" (offset=813) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "stop" (offset=819) */
   0x706f7473,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (3 << (JS_MTAG_BITS + 3)), /* "i2c" (offset=816) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (3 << (JS_MTAG_BITS + 3)), /* "i2c" (offset=822) */
   0x00633269,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (6 << (JS_MTAG_BITS + 3)), /* "config" (offset=818) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (6 << (JS_MTAG_BITS + 3)), /* "config" (offset=824) */
   0x666e6f63,
   0x00006769,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "scan" (offset=821) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "scan" (offset=827) */
   0x6e616373,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "writeReg" (offset=824) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "writeReg" (offset=830) */
   0x74697277,
   0x67655265,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "readReg" (offset=828) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (7 << (JS_MTAG_BITS + 3)), /* "readReg" (offset=834) */
   0x64616572,
   0x00676552,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "deconfig" (offset=831) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (8 << (JS_MTAG_BITS + 3)), /* "deconfig" (offset=837) */
   0x6f636564,
   0x6769666e,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "tx" (offset=835) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "tx" (offset=841) */
   0x00007874,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "txrx" (offset=837) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "txrx" (offset=843) */
   0x78727874,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "print" (offset=840) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (5 << (JS_MTAG_BITS + 3)), /* "print" (offset=846) */
   0x6e697270,
   0x00000074,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "gc" (offset=843) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (2 << (JS_MTAG_BITS + 3)), /* "gc" (offset=849) */
   0x00006367,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "load" (offset=845) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (4 << (JS_MTAG_BITS + 3)), /* "load" (offset=851) */
   0x64616f6c,
   0x00000000,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "setTimeout" (offset=848) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (10 << (JS_MTAG_BITS + 3)), /* "setTimeout" (offset=854) */
   0x54746573,
   0x6f656d69,
   0x00007475,
-  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "clearTimeout" (offset=852) */
+  (JS_MTAG_STRING << 1) | (1 << JS_MTAG_BITS) | (1 << (JS_MTAG_BITS + 1)) | (0 << (JS_MTAG_BITS + 2)) | (12 << (JS_MTAG_BITS + 3)), /* "clearTimeout" (offset=858) */
   0x61656c63,
   0x6d695472,
   0x74756f65,
   0x00000000,
 
-  /* sorted atom table (offset=857) */
-  JS_VALUE_ARRAY_HEADER(255),
+  /* sorted atom table (offset=863) */
+  JS_VALUE_ARRAY_HEADER(257),
   JS_ROM_VALUE(134), /* empty */
   JS_ROM_VALUE(201), /* _Infinity */
   JS_ROM_VALUE(162), /* _eval_ */
@@ -937,11 +943,11 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(362), /* charAt */
   JS_ROM_VALUE(365), /* charCodeAt */
   JS_ROM_VALUE(84), /* class */
-  JS_ROM_VALUE(852), /* clearTimeout */
+  JS_ROM_VALUE(858), /* clearTimeout */
   JS_ROM_VALUE(549), /* clz32 */
   JS_ROM_VALUE(369), /* codePointAt */
   JS_ROM_VALUE(380), /* concat */
-  JS_ROM_VALUE(818), /* config */
+  JS_ROM_VALUE(824), /* config */
   JS_ROM_VALUE(754), /* console */
   JS_ROM_VALUE(87), /* const */
   JS_ROM_VALUE(183), /* constructor */
@@ -949,7 +955,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(521), /* cos */
   JS_ROM_VALUE(242), /* create */
   JS_ROM_VALUE(77), /* debugger */
-  JS_ROM_VALUE(831), /* deconfig */
+  JS_ROM_VALUE(837), /* deconfig */
   JS_ROM_VALUE(59), /* default */
   JS_ROM_VALUE(227), /* defineProperty */
   JS_ROM_VALUE(22), /* delete */
@@ -957,6 +963,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(11), /* else */
   JS_ROM_VALUE(90), /* enum */
   JS_ROM_VALUE(165), /* eval */
+  JS_ROM_VALUE(796), /* events */
   JS_ROM_VALUE(450), /* every */
   JS_ROM_VALUE(610), /* exec */
   JS_ROM_VALUE(537), /* exp */
@@ -973,7 +980,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(353), /* fromCodePoint */
   JS_ROM_VALUE(552), /* fround */
   JS_ROM_VALUE(73), /* function */
-  JS_ROM_VALUE(843), /* gc */
+  JS_ROM_VALUE(849), /* gc */
   JS_ROM_VALUE(175), /* get */
   JS_ROM_VALUE(695), /* get buffer */
   JS_ROM_VALUE(668), /* get byteLength */
@@ -988,10 +995,10 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(626), /* get stack */
   JS_ROM_VALUE(232), /* getPrototypeOf */
   JS_ROM_VALUE(750), /* globalThis */
-  JS_ROM_VALUE(796), /* gpio */
+  JS_ROM_VALUE(802), /* gpio */
   JS_ROM_VALUE(248), /* hasOwnProperty */
-  JS_ROM_VALUE(799), /* high */
-  JS_ROM_VALUE(816), /* i2c */
+  JS_ROM_VALUE(805), /* high */
+  JS_ROM_VALUE(822), /* i2c */
   JS_ROM_VALUE(9), /* if */
   JS_ROM_VALUE(105), /* implements */
   JS_ROM_VALUE(99), /* import */
@@ -1011,11 +1018,11 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(386), /* lastIndexOf */
   JS_ROM_VALUE(187), /* length */
   JS_ROM_VALUE(113), /* let */
-  JS_ROM_VALUE(845), /* load */
+  JS_ROM_VALUE(851), /* load */
   JS_ROM_VALUE(539), /* log */
   JS_ROM_VALUE(561), /* log10 */
   JS_ROM_VALUE(558), /* log2 */
-  JS_ROM_VALUE(802), /* low */
+  JS_ROM_VALUE(808), /* low */
   JS_ROM_VALUE(459), /* map */
   JS_ROM_VALUE(390), /* match */
   JS_ROM_VALUE(479), /* max */
@@ -1035,15 +1042,15 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(757), /* performance */
   JS_ROM_VALUE(433), /* pop */
   JS_ROM_VALUE(541), /* pow */
-  JS_ROM_VALUE(840), /* print */
+  JS_ROM_VALUE(846), /* print */
   JS_ROM_VALUE(118), /* private */
   JS_ROM_VALUE(121), /* protected */
   JS_ROM_VALUE(179), /* prototype */
   JS_ROM_VALUE(125), /* public */
-  JS_ROM_VALUE(807), /* pulse */
+  JS_ROM_VALUE(813), /* pulse */
   JS_ROM_VALUE(430), /* push */
   JS_ROM_VALUE(543), /* random */
-  JS_ROM_VALUE(828), /* readReg */
+  JS_ROM_VALUE(834), /* readReg */
   JS_ROM_VALUE(464), /* reduce */
   JS_ROM_VALUE(467), /* reduceRight */
   JS_ROM_VALUE(393), /* replace */
@@ -1051,7 +1058,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(14), /* return */
   JS_ROM_VALUE(438), /* reverse */
   JS_ROM_VALUE(492), /* round */
-  JS_ROM_VALUE(821), /* scan */
+  JS_ROM_VALUE(827), /* scan */
   JS_ROM_VALUE(400), /* search */
   JS_ROM_VALUE(177), /* set */
   JS_ROM_VALUE(591), /* set lastIndex */
@@ -1061,12 +1068,12 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(770), /* setBrightness */
   JS_ROM_VALUE(783), /* setChase */
   JS_ROM_VALUE(766), /* setFrameMs */
-  JS_ROM_VALUE(810), /* setMany */
+  JS_ROM_VALUE(816), /* setMany */
   JS_ROM_VALUE(775), /* setPattern */
   JS_ROM_VALUE(237), /* setPrototypeOf */
   JS_ROM_VALUE(779), /* setRainbow */
   JS_ROM_VALUE(792), /* setSparkle */
-  JS_ROM_VALUE(848), /* setTimeout */
+  JS_ROM_VALUE(854), /* setTimeout */
   JS_ROM_VALUE(441), /* shift */
   JS_ROM_VALUE(481), /* sign */
   JS_ROM_VALUE(761), /* sim */
@@ -1078,11 +1085,12 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(444), /* splice */
   JS_ROM_VALUE(403), /* split */
   JS_ROM_VALUE(495), /* sqrt */
-  JS_ROM_VALUE(804), /* square */
+  JS_ROM_VALUE(810), /* square */
   JS_ROM_VALUE(623), /* stack */
   JS_ROM_VALUE(128), /* static */
+  JS_ROM_VALUE(799), /* stats */
   JS_ROM_VALUE(763), /* status */
-  JS_ROM_VALUE(813), /* stop */
+  JS_ROM_VALUE(819), /* stop */
   JS_ROM_VALUE(153), /* string */
   JS_ROM_VALUE(575), /* stringify */
   JS_ROM_VALUE(699), /* subarray */
@@ -1106,8 +1114,8 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(6), /* true */
   JS_ROM_VALUE(555), /* trunc */
   JS_ROM_VALUE(65), /* try */
-  JS_ROM_VALUE(835), /* tx */
-  JS_ROM_VALUE(837), /* txrx */
+  JS_ROM_VALUE(841), /* tx */
+  JS_ROM_VALUE(843), /* txrx */
   JS_ROM_VALUE(28), /* typeof */
   JS_ROM_VALUE(149), /* undefined */
   JS_ROM_VALUE(447), /* unshift */
@@ -1117,10 +1125,10 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(25), /* void */
   JS_ROM_VALUE(41), /* while */
   JS_ROM_VALUE(81), /* with */
-  JS_ROM_VALUE(824), /* writeReg */
+  JS_ROM_VALUE(830), /* writeReg */
   JS_ROM_VALUE(131), /* yield */
 
-  /* properties (offset=1113) */
+  /* properties (offset=1121) */
   JS_VALUE_ARRAY_HEADER(24),
   6 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1146,7 +1154,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_OBJECT << 1,
   (6 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1138) */
+  /* properties (offset=1146) */
   JS_VALUE_ARRAY_HEADER(13),
   3 << 1, /* n_props */
   1 << 1, /* hash_mask */
@@ -1161,14 +1169,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_OBJECT - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1152) */
+  /* class (offset=1160) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1113),
+  JS_ROM_VALUE(1121),
   1,
-  JS_ROM_VALUE(1138),
+  JS_ROM_VALUE(1146),
   JS_NULL,
 
-  /* properties (offset=1157) */
+  /* properties (offset=1165) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1176,22 +1184,22 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_CLOSURE << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1164) */
+  /* getset (offset=1172) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 10),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 11),
 
-  /* getset (offset=1167) */
+  /* getset (offset=1175) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 12),
   JS_UNDEFINED,
 
-  /* getset (offset=1170) */
+  /* getset (offset=1178) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 13),
   JS_UNDEFINED,
 
-  /* properties (offset=1173) */
+  /* properties (offset=1181) */
   JS_VALUE_ARRAY_HEADER(30),
   8 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1200,7 +1208,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   27 << 1,
   12 << 1,
   JS_ROM_VALUE(179) /* prototype */,
-  JS_ROM_VALUE(1164),
+  JS_ROM_VALUE(1172),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(267) /* call */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 14),
@@ -1215,62 +1223,62 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 17),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(187) /* length */,
-  JS_ROM_VALUE(1167),
+  JS_ROM_VALUE(1175),
   (9 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(205) /* name */,
-  JS_ROM_VALUE(1170),
+  JS_ROM_VALUE(1178),
   (15 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_CLOSURE - 1) << 1,
   (21 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1204) */
+  /* class (offset=1212) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1157),
+  JS_ROM_VALUE(1165),
   9,
-  JS_ROM_VALUE(1173),
+  JS_ROM_VALUE(1181),
   JS_NULL,
 
-  /* float64 (offset=1209) */
+  /* float64 (offset=1217) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xffffffff,
   0x7fefffff,
 
-  /* float64 (offset=1212) */
+  /* float64 (offset=1220) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000001,
   0x00000000,
 
-  /* float64 (offset=1215) */
+  /* float64 (offset=1223) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0x7ff80000,
 
-  /* float64 (offset=1218) */
+  /* float64 (offset=1226) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0xfff00000,
 
-  /* float64 (offset=1221) */
+  /* float64 (offset=1229) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0x7ff00000,
 
-  /* float64 (offset=1224) */
+  /* float64 (offset=1232) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0x3cb00000,
 
-  /* float64 (offset=1227) */
+  /* float64 (offset=1235) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xffffffff,
   0x433fffff,
 
-  /* float64 (offset=1230) */
+  /* float64 (offset=1238) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xffffffff,
   0xc33fffff,
 
-  /* properties (offset=1233) */
+  /* properties (offset=1241) */
   JS_VALUE_ARRAY_HEADER(43),
   11 << 1, /* n_props */
   7 << 1, /* hash_mask */
@@ -1289,33 +1297,33 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 20),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(295) /* MAX_VALUE */,
-  JS_ROM_VALUE(1209),
+  JS_ROM_VALUE(1217),
   (10 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(299) /* MIN_VALUE */,
-  JS_ROM_VALUE(1212),
+  JS_ROM_VALUE(1220),
   (13 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(195) /* NaN */,
-  JS_ROM_VALUE(1215),
+  JS_ROM_VALUE(1223),
   (19 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(303) /* NEGATIVE_INFINITY */,
-  JS_ROM_VALUE(1218),
+  JS_ROM_VALUE(1226),
   (16 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(309) /* POSITIVE_INFINITY */,
-  JS_ROM_VALUE(1221),
+  JS_ROM_VALUE(1229),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(315) /* EPSILON */,
-  JS_ROM_VALUE(1224),
+  JS_ROM_VALUE(1232),
   (22 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(318) /* MAX_SAFE_INTEGER */,
-  JS_ROM_VALUE(1227),
+  JS_ROM_VALUE(1235),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(324) /* MIN_SAFE_INTEGER */,
-  JS_ROM_VALUE(1230),
+  JS_ROM_VALUE(1238),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_NUMBER << 1,
   (31 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1277) */
+  /* properties (offset=1285) */
   JS_VALUE_ARRAY_HEADER(21),
   5 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1338,14 +1346,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_NUMBER - 1) << 1,
   (9 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1299) */
+  /* class (offset=1307) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1233),
+  JS_ROM_VALUE(1241),
   18,
-  JS_ROM_VALUE(1277),
+  JS_ROM_VALUE(1285),
   JS_NULL,
 
-  /* properties (offset=1304) */
+  /* properties (offset=1312) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1353,7 +1361,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_BOOLEAN << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1311) */
+  /* properties (offset=1319) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1361,14 +1369,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_BOOLEAN - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1318) */
+  /* class (offset=1326) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1304),
+  JS_ROM_VALUE(1312),
   25,
-  JS_ROM_VALUE(1311),
+  JS_ROM_VALUE(1319),
   JS_NULL,
 
-  /* properties (offset=1323) */
+  /* properties (offset=1331) */
   JS_VALUE_ARRAY_HEADER(13),
   3 << 1, /* n_props */
   1 << 1, /* hash_mask */
@@ -1383,12 +1391,12 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_STRING << 1,
   (7 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1337) */
+  /* getset (offset=1345) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 29),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 30),
 
-  /* properties (offset=1340) */
+  /* properties (offset=1348) */
   JS_VALUE_ARRAY_HEADER(81),
   21 << 1, /* n_props */
   15 << 1, /* hash_mask */
@@ -1409,7 +1417,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   39 << 1,
   66 << 1,
   JS_ROM_VALUE(187) /* length */,
-  JS_ROM_VALUE(1337),
+  JS_ROM_VALUE(1345),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(362) /* charAt */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 31),
@@ -1471,14 +1479,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_STRING - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1422) */
+  /* class (offset=1430) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1323),
+  JS_ROM_VALUE(1331),
   26,
-  JS_ROM_VALUE(1340),
+  JS_ROM_VALUE(1348),
   JS_NULL,
 
-  /* properties (offset=1427) */
+  /* properties (offset=1435) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1489,12 +1497,12 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1437) */
+  /* getset (offset=1445) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 52),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 53),
 
-  /* properties (offset=1440) */
+  /* properties (offset=1448) */
   JS_VALUE_ARRAY_HEADER(87),
   23 << 1, /* n_props */
   15 << 1, /* hash_mask */
@@ -1518,7 +1526,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 54),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(187) /* length */,
-  JS_ROM_VALUE(1437),
+  JS_ROM_VALUE(1445),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(430) /* push */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 55),
@@ -1583,54 +1591,54 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_ARRAY - 1) << 1,
   (81 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1528) */
+  /* class (offset=1536) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1427),
+  JS_ROM_VALUE(1435),
   50,
-  JS_ROM_VALUE(1440),
+  JS_ROM_VALUE(1448),
   JS_NULL,
 
-  /* float64 (offset=1533) */
+  /* float64 (offset=1541) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x8b145769,
   0x4005bf0a,
 
-  /* float64 (offset=1536) */
+  /* float64 (offset=1544) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xbbb55516,
   0x40026bb1,
 
-  /* float64 (offset=1539) */
+  /* float64 (offset=1547) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0xfefa39ef,
   0x3fe62e42,
 
-  /* float64 (offset=1542) */
+  /* float64 (offset=1550) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x652b82fe,
   0x3ff71547,
 
-  /* float64 (offset=1545) */
+  /* float64 (offset=1553) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x1526e50e,
   0x3fdbcb7b,
 
-  /* float64 (offset=1548) */
+  /* float64 (offset=1556) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x54442d18,
   0x400921fb,
 
-  /* float64 (offset=1551) */
+  /* float64 (offset=1559) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x667f3bcd,
   0x3fe6a09e,
 
-  /* float64 (offset=1554) */
+  /* float64 (offset=1562) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x667f3bcd,
   0x3ff6a09e,
 
-  /* properties (offset=1557) */
+  /* properties (offset=1565) */
   JS_VALUE_ARRAY_HEADER(117),
   33 << 1, /* n_props */
   15 << 1, /* hash_mask */
@@ -1675,28 +1683,28 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 81),
   (21 << 1) | (JS_PROP_NORMAL << 30),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_STRING_CHAR, 69) /* E */,
-  JS_ROM_VALUE(1533),
+  JS_ROM_VALUE(1541),
   (36 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(500) /* LN10 */,
-  JS_ROM_VALUE(1536),
+  JS_ROM_VALUE(1544),
   (27 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(503) /* LN2 */,
-  JS_ROM_VALUE(1539),
+  JS_ROM_VALUE(1547),
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(505) /* LOG2E */,
-  JS_ROM_VALUE(1542),
+  JS_ROM_VALUE(1550),
   (33 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(508) /* LOG10E */,
-  JS_ROM_VALUE(1545),
+  JS_ROM_VALUE(1553),
   (42 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(511) /* PI */,
-  JS_ROM_VALUE(1548),
+  JS_ROM_VALUE(1556),
   (39 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(513) /* SQRT1_2 */,
-  JS_ROM_VALUE(1551),
+  JS_ROM_VALUE(1559),
   (24 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(516) /* SQRT2 */,
-  JS_ROM_VALUE(1554),
+  JS_ROM_VALUE(1562),
   (45 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(519) /* sin */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 82),
@@ -1749,14 +1757,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(561) /* log10 */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 98),
   (60 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1675) */
+  /* class (offset=1683) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1557),
+  JS_ROM_VALUE(1565),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=1680) */
+  /* properties (offset=1688) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1767,7 +1775,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_DATE << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1690) */
+  /* properties (offset=1698) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1775,14 +1783,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_DATE - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1697) */
+  /* class (offset=1705) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1680),
+  JS_ROM_VALUE(1688),
   99,
-  JS_ROM_VALUE(1690),
+  JS_ROM_VALUE(1698),
   JS_NULL,
 
-  /* properties (offset=1702) */
+  /* properties (offset=1710) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1793,14 +1801,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(575) /* stringify */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 102),
   (3 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=1712) */
+  /* class (offset=1720) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1702),
+  JS_ROM_VALUE(1710),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=1717) */
+  /* properties (offset=1725) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1808,22 +1816,22 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_REGEXP << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1724) */
+  /* getset (offset=1732) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 104),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 105),
 
-  /* getset (offset=1727) */
+  /* getset (offset=1735) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 106),
   JS_UNDEFINED,
 
-  /* getset (offset=1730) */
+  /* getset (offset=1738) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 107),
   JS_UNDEFINED,
 
-  /* properties (offset=1733) */
+  /* properties (offset=1741) */
   JS_VALUE_ARRAY_HEADER(24),
   6 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1832,13 +1840,13 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   21 << 1,
   15 << 1,
   JS_ROM_VALUE(582) /* lastIndex */,
-  JS_ROM_VALUE(1724),
+  JS_ROM_VALUE(1732),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(596) /* source */,
-  JS_ROM_VALUE(1727),
+  JS_ROM_VALUE(1735),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(603) /* flags */,
-  JS_ROM_VALUE(1730),
+  JS_ROM_VALUE(1738),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(610) /* exec */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 108),
@@ -1849,14 +1857,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_REGEXP - 1) << 1,
   (12 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1758) */
+  /* class (offset=1766) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1717),
+  JS_ROM_VALUE(1725),
   103,
-  JS_ROM_VALUE(1733),
+  JS_ROM_VALUE(1741),
   JS_NULL,
 
-  /* properties (offset=1763) */
+  /* properties (offset=1771) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1864,17 +1872,17 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1770) */
+  /* getset (offset=1778) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 111),
   JS_UNDEFINED,
 
-  /* getset (offset=1773) */
+  /* getset (offset=1781) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 112),
   JS_UNDEFINED,
 
-  /* properties (offset=1776) */
+  /* properties (offset=1784) */
   JS_VALUE_ARRAY_HEADER(21),
   5 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -1889,22 +1897,22 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(208) /* Error */,
   (0 << 1) | (JS_PROP_NORMAL << 30),
   JS_ROM_VALUE(616) /* message */,
-  JS_ROM_VALUE(1770),
+  JS_ROM_VALUE(1778),
   (6 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(623) /* stack */,
-  JS_ROM_VALUE(1773),
+  JS_ROM_VALUE(1781),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_ERROR - 1) << 1,
   (15 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1798) */
+  /* class (offset=1806) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1763),
+  JS_ROM_VALUE(1771),
   110,
-  JS_ROM_VALUE(1776),
+  JS_ROM_VALUE(1784),
   JS_NULL,
 
-  /* properties (offset=1803) */
+  /* properties (offset=1811) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1912,7 +1920,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_EVAL_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1810) */
+  /* properties (offset=1818) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1923,14 +1931,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_EVAL_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1820) */
+  /* class (offset=1828) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1803),
+  JS_ROM_VALUE(1811),
   114,
-  JS_ROM_VALUE(1810),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1818),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1825) */
+  /* properties (offset=1833) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1938,7 +1946,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_RANGE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1832) */
+  /* properties (offset=1840) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1949,14 +1957,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_RANGE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1842) */
+  /* class (offset=1850) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1825),
+  JS_ROM_VALUE(1833),
   115,
-  JS_ROM_VALUE(1832),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1840),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1847) */
+  /* properties (offset=1855) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1964,7 +1972,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_REFERENCE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1854) */
+  /* properties (offset=1862) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1975,14 +1983,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_REFERENCE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1864) */
+  /* class (offset=1872) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1847),
+  JS_ROM_VALUE(1855),
   116,
-  JS_ROM_VALUE(1854),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1862),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1869) */
+  /* properties (offset=1877) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -1990,7 +1998,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_SYNTAX_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1876) */
+  /* properties (offset=1884) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2001,14 +2009,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_SYNTAX_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1886) */
+  /* class (offset=1894) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1869),
+  JS_ROM_VALUE(1877),
   117,
-  JS_ROM_VALUE(1876),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1884),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1891) */
+  /* properties (offset=1899) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2016,7 +2024,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_TYPE_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1898) */
+  /* properties (offset=1906) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2027,14 +2035,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_TYPE_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1908) */
+  /* class (offset=1916) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1891),
+  JS_ROM_VALUE(1899),
   118,
-  JS_ROM_VALUE(1898),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1906),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1913) */
+  /* properties (offset=1921) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2042,7 +2050,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_URI_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1920) */
+  /* properties (offset=1928) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2053,14 +2061,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_URI_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1930) */
+  /* class (offset=1938) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1913),
+  JS_ROM_VALUE(1921),
   119,
-  JS_ROM_VALUE(1920),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1928),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1935) */
+  /* properties (offset=1943) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2068,7 +2076,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_INTERNAL_ERROR << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=1942) */
+  /* properties (offset=1950) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2079,14 +2087,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_INTERNAL_ERROR - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1952) */
+  /* class (offset=1960) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1935),
+  JS_ROM_VALUE(1943),
   120,
-  JS_ROM_VALUE(1942),
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1950),
+  JS_ROM_VALUE(1806),
 
-  /* properties (offset=1957) */
+  /* properties (offset=1965) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2094,30 +2102,30 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_ARRAY_BUFFER << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1964) */
+  /* getset (offset=1972) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 122),
   JS_UNDEFINED,
 
-  /* properties (offset=1967) */
+  /* properties (offset=1975) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
   6 << 1,
   JS_ROM_VALUE(664) /* byteLength */,
-  JS_ROM_VALUE(1964),
+  JS_ROM_VALUE(1972),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_ARRAY_BUFFER - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=1977) */
+  /* class (offset=1985) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1957),
+  JS_ROM_VALUE(1965),
   121,
-  JS_ROM_VALUE(1967),
+  JS_ROM_VALUE(1975),
   JS_NULL,
 
-  /* properties (offset=1982) */
+  /* properties (offset=1990) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2125,27 +2133,27 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_TYPED_ARRAY << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* getset (offset=1989) */
+  /* getset (offset=1997) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 124),
   JS_UNDEFINED,
 
-  /* getset (offset=1992) */
+  /* getset (offset=2000) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 125),
   JS_UNDEFINED,
 
-  /* getset (offset=1995) */
+  /* getset (offset=2003) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 126),
   JS_UNDEFINED,
 
-  /* getset (offset=1998) */
+  /* getset (offset=2006) */
   JS_VALUE_ARRAY_HEADER(2),
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 127),
   JS_UNDEFINED,
 
-  /* properties (offset=2001) */
+  /* properties (offset=2009) */
   JS_VALUE_ARRAY_HEADER(37),
   9 << 1, /* n_props */
   7 << 1, /* hash_mask */
@@ -2158,16 +2166,16 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   34 << 1,
   0 << 1,
   JS_ROM_VALUE(187) /* length */,
-  JS_ROM_VALUE(1989),
+  JS_ROM_VALUE(1997),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(664) /* byteLength */,
-  JS_ROM_VALUE(1992),
+  JS_ROM_VALUE(2000),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(683) /* byteOffset */,
-  JS_ROM_VALUE(1995),
+  JS_ROM_VALUE(2003),
   (10 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(692) /* buffer */,
-  JS_ROM_VALUE(1998),
+  JS_ROM_VALUE(2006),
   (0 << 1) | (JS_PROP_GETSET << 30),
   JS_ROM_VALUE(435) /* join */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 57),
@@ -2184,14 +2192,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_TYPED_ARRAY - 1) << 1,
   (0 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2039) */
+  /* class (offset=2047) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(1982),
+  JS_ROM_VALUE(1990),
   123,
-  JS_ROM_VALUE(2001),
+  JS_ROM_VALUE(2009),
   JS_NULL,
 
-  /* properties (offset=2044) */
+  /* properties (offset=2052) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2202,7 +2210,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_UINT8C_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2054) */
+  /* properties (offset=2062) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2213,14 +2221,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT8C_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2064) */
+  /* class (offset=2072) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2044),
+  JS_ROM_VALUE(2052),
   130,
-  JS_ROM_VALUE(2054),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2062),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2069) */
+  /* properties (offset=2077) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2231,7 +2239,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_INT8_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2079) */
+  /* properties (offset=2087) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2242,14 +2250,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_INT8_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2089) */
+  /* class (offset=2097) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2069),
+  JS_ROM_VALUE(2077),
   131,
-  JS_ROM_VALUE(2079),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2087),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2094) */
+  /* properties (offset=2102) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2260,7 +2268,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_UINT8_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2104) */
+  /* properties (offset=2112) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2271,14 +2279,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT8_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2114) */
+  /* class (offset=2122) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2094),
+  JS_ROM_VALUE(2102),
   132,
-  JS_ROM_VALUE(2104),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2112),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2119) */
+  /* properties (offset=2127) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2289,7 +2297,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_INT16_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2129) */
+  /* properties (offset=2137) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2300,14 +2308,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_INT16_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2139) */
+  /* class (offset=2147) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2119),
+  JS_ROM_VALUE(2127),
   133,
-  JS_ROM_VALUE(2129),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2137),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2144) */
+  /* properties (offset=2152) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2318,7 +2326,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_UINT16_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2154) */
+  /* properties (offset=2162) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2329,14 +2337,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT16_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2164) */
+  /* class (offset=2172) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2144),
+  JS_ROM_VALUE(2152),
   134,
-  JS_ROM_VALUE(2154),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2162),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2169) */
+  /* properties (offset=2177) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2347,7 +2355,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_INT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2179) */
+  /* properties (offset=2187) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2358,14 +2366,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_INT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2189) */
+  /* class (offset=2197) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2169),
+  JS_ROM_VALUE(2177),
   135,
-  JS_ROM_VALUE(2179),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2187),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2194) */
+  /* properties (offset=2202) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2376,7 +2384,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_UINT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2204) */
+  /* properties (offset=2212) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2387,14 +2395,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_UINT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2214) */
+  /* class (offset=2222) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2194),
+  JS_ROM_VALUE(2202),
   136,
-  JS_ROM_VALUE(2204),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2212),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2219) */
+  /* properties (offset=2227) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2405,7 +2413,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_FLOAT32_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2229) */
+  /* properties (offset=2237) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2416,14 +2424,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_FLOAT32_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2239) */
+  /* class (offset=2247) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2219),
+  JS_ROM_VALUE(2227),
   137,
-  JS_ROM_VALUE(2229),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2237),
+  JS_ROM_VALUE(2047),
 
-  /* properties (offset=2244) */
+  /* properties (offset=2252) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2434,7 +2442,7 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(179) /* prototype */,
   JS_CLASS_FLOAT64_ARRAY << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* properties (offset=2254) */
+  /* properties (offset=2262) */
   JS_VALUE_ARRAY_HEADER(9),
   2 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2445,24 +2453,24 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(183) /* constructor */,
   (uint32_t)(-JS_CLASS_FLOAT64_ARRAY - 1) << 1,
   (3 << 1) | (JS_PROP_SPECIAL << 30),
-  /* class (offset=2264) */
+  /* class (offset=2272) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2244),
+  JS_ROM_VALUE(2252),
   138,
-  JS_ROM_VALUE(2254),
-  JS_ROM_VALUE(2039),
+  JS_ROM_VALUE(2262),
+  JS_ROM_VALUE(2047),
 
-  /* float64 (offset=2269) */
+  /* float64 (offset=2277) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0x7ff00000,
 
-  /* float64 (offset=2272) */
+  /* float64 (offset=2280) */
   JS_MB_HEADER_DEF(JS_MTAG_FLOAT64),
   0x00000000,
   0x7ff80000,
 
-  /* properties (offset=2275) */
+  /* properties (offset=2283) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2470,14 +2478,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(539) /* log */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 139),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=2282) */
+  /* class (offset=2290) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2275),
+  JS_ROM_VALUE(2283),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=2287) */
+  /* properties (offset=2295) */
   JS_VALUE_ARRAY_HEADER(6),
   1 << 1, /* n_props */
   0 << 1, /* hash_mask */
@@ -2485,14 +2493,14 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(567) /* now */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 140),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=2294) */
+  /* class (offset=2302) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2287),
+  JS_ROM_VALUE(2295),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=2299) */
+  /* properties (offset=2307) */
   JS_VALUE_ARRAY_HEADER(30),
   8 << 1, /* n_props */
   3 << 1, /* hash_mask */
@@ -2524,178 +2532,198 @@ static const uint32_t __attribute((aligned(64))) js_stdlib_table[] = {
   JS_ROM_VALUE(792) /* setSparkle */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 148),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=2330) */
+  /* class (offset=2338) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2299),
+  JS_ROM_VALUE(2307),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=2335) */
+  /* properties (offset=2343) */
+  JS_VALUE_ARRAY_HEADER(9),
+  2 << 1, /* n_props */
+  0 << 1, /* hash_mask */
+  6 << 1,
+  JS_ROM_VALUE(430) /* push */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 149),
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(799) /* stats */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 150),
+  (3 << 1) | (JS_PROP_NORMAL << 30),
+  /* class (offset=2353) */
+  JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
+  JS_ROM_VALUE(2343),
+  -1,
+  JS_NULL,
+  JS_NULL,
+
+  /* properties (offset=2358) */
   JS_VALUE_ARRAY_HEADER(24),
   6 << 1, /* n_props */
   3 << 1, /* hash_mask */
-  21 << 1,
-  12 << 1,
   15 << 1,
   18 << 1,
-  JS_ROM_VALUE(799) /* high */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 149),
-  (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(802) /* low */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 150),
-  (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(804) /* square */,
+  21 << 1,
+  12 << 1,
+  JS_ROM_VALUE(805) /* high */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 151),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(807) /* pulse */,
+  JS_ROM_VALUE(808) /* low */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 152),
-  (6 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(810) /* setMany */,
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(810) /* square */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 153),
-  (9 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(813) /* stop */,
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(813) /* pulse */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 154),
+  (6 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(816) /* setMany */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 155),
+  (9 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(819) /* stop */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 156),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=2360) */
+  /* class (offset=2383) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2335),
+  JS_ROM_VALUE(2358),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* properties (offset=2365) */
+  /* properties (offset=2388) */
   JS_VALUE_ARRAY_HEADER(27),
   7 << 1, /* n_props */
   3 << 1, /* hash_mask */
-  24 << 1,
-  15 << 1,
   21 << 1,
   6 << 1,
-  JS_ROM_VALUE(818) /* config */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 155),
-  (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(821) /* scan */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 156),
-  (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(824) /* writeReg */,
+  24 << 1,
+  15 << 1,
+  JS_ROM_VALUE(824) /* config */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 157),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(828) /* readReg */,
+  JS_ROM_VALUE(827) /* scan */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 158),
-  (12 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(831) /* deconfig */,
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(830) /* writeReg */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 159),
   (0 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(835) /* tx */,
+  JS_ROM_VALUE(834) /* readReg */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 160),
-  (18 << 1) | (JS_PROP_NORMAL << 30),
-  JS_ROM_VALUE(837) /* txrx */,
+  (12 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(837) /* deconfig */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 161),
+  (0 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(841) /* tx */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 162),
+  (18 << 1) | (JS_PROP_NORMAL << 30),
+  JS_ROM_VALUE(843) /* txrx */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 163),
   (9 << 1) | (JS_PROP_NORMAL << 30),
-  /* class (offset=2393) */
+  /* class (offset=2416) */
   JS_MB_HEADER_DEF(JS_MTAG_OBJECT),
-  JS_ROM_VALUE(2365),
+  JS_ROM_VALUE(2388),
   -1,
   JS_NULL,
   JS_NULL,
 
-  /* global object properties (offset=2398) */
-  JS_VALUE_ARRAY_HEADER(94),
+  /* global object properties (offset=2421) */
+  JS_VALUE_ARRAY_HEADER(96),
   JS_ROM_VALUE(224) /* Object */,
-  JS_ROM_VALUE(1152),
+  JS_ROM_VALUE(1160),
   JS_ROM_VALUE(253) /* Function */,
-  JS_ROM_VALUE(1204),
+  JS_ROM_VALUE(1212),
   JS_ROM_VALUE(284) /* Number */,
-  JS_ROM_VALUE(1299),
+  JS_ROM_VALUE(1307),
   JS_ROM_VALUE(342) /* Boolean */,
-  JS_ROM_VALUE(1318),
+  JS_ROM_VALUE(1326),
   JS_ROM_VALUE(345) /* String */,
-  JS_ROM_VALUE(1422),
+  JS_ROM_VALUE(1430),
   JS_ROM_VALUE(424) /* Array */,
-  JS_ROM_VALUE(1528),
+  JS_ROM_VALUE(1536),
   JS_ROM_VALUE(474) /* Math */,
-  JS_ROM_VALUE(1675),
+  JS_ROM_VALUE(1683),
   JS_ROM_VALUE(564) /* Date */,
-  JS_ROM_VALUE(1697),
+  JS_ROM_VALUE(1705),
   JS_ROM_VALUE(569) /* JSON */,
-  JS_ROM_VALUE(1712),
+  JS_ROM_VALUE(1720),
   JS_ROM_VALUE(579) /* RegExp */,
-  JS_ROM_VALUE(1758),
+  JS_ROM_VALUE(1766),
   JS_ROM_VALUE(208) /* Error */,
-  JS_ROM_VALUE(1798),
+  JS_ROM_VALUE(1806),
   JS_ROM_VALUE(630) /* EvalError */,
-  JS_ROM_VALUE(1820),
+  JS_ROM_VALUE(1828),
   JS_ROM_VALUE(634) /* RangeError */,
-  JS_ROM_VALUE(1842),
+  JS_ROM_VALUE(1850),
   JS_ROM_VALUE(638) /* ReferenceError */,
-  JS_ROM_VALUE(1864),
+  JS_ROM_VALUE(1872),
   JS_ROM_VALUE(643) /* SyntaxError */,
-  JS_ROM_VALUE(1886),
+  JS_ROM_VALUE(1894),
   JS_ROM_VALUE(647) /* TypeError */,
-  JS_ROM_VALUE(1908),
+  JS_ROM_VALUE(1916),
   JS_ROM_VALUE(651) /* URIError */,
-  JS_ROM_VALUE(1930),
+  JS_ROM_VALUE(1938),
   JS_ROM_VALUE(655) /* InternalError */,
-  JS_ROM_VALUE(1952),
+  JS_ROM_VALUE(1960),
   JS_ROM_VALUE(660) /* ArrayBuffer */,
-  JS_ROM_VALUE(1977),
+  JS_ROM_VALUE(1985),
   JS_ROM_VALUE(673) /* Uint8ClampedArray */,
-  JS_ROM_VALUE(2064),
+  JS_ROM_VALUE(2072),
   JS_ROM_VALUE(709) /* Int8Array */,
-  JS_ROM_VALUE(2089),
+  JS_ROM_VALUE(2097),
   JS_ROM_VALUE(713) /* Uint8Array */,
-  JS_ROM_VALUE(2114),
+  JS_ROM_VALUE(2122),
   JS_ROM_VALUE(717) /* Int16Array */,
-  JS_ROM_VALUE(2139),
+  JS_ROM_VALUE(2147),
   JS_ROM_VALUE(721) /* Uint16Array */,
-  JS_ROM_VALUE(2164),
+  JS_ROM_VALUE(2172),
   JS_ROM_VALUE(725) /* Int32Array */,
-  JS_ROM_VALUE(2189),
+  JS_ROM_VALUE(2197),
   JS_ROM_VALUE(729) /* Uint32Array */,
-  JS_ROM_VALUE(2214),
+  JS_ROM_VALUE(2222),
   JS_ROM_VALUE(733) /* Float32Array */,
-  JS_ROM_VALUE(2239),
+  JS_ROM_VALUE(2247),
   JS_ROM_VALUE(738) /* Float64Array */,
-  JS_ROM_VALUE(2264),
+  JS_ROM_VALUE(2272),
   JS_ROM_VALUE(287) /* parseInt */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 19),
   JS_ROM_VALUE(291) /* parseFloat */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 20),
   JS_ROM_VALUE(165) /* eval */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 162),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 164),
   JS_ROM_VALUE(743) /* isNaN */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 163),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 165),
   JS_ROM_VALUE(746) /* isFinite */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 164),
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 166),
   JS_ROM_VALUE(197) /* Infinity */,
-  JS_ROM_VALUE(2269),
+  JS_ROM_VALUE(2277),
   JS_ROM_VALUE(195) /* NaN */,
-  JS_ROM_VALUE(2272),
+  JS_ROM_VALUE(2280),
   JS_ROM_VALUE(149) /* undefined */,
   JS_UNDEFINED,
   JS_ROM_VALUE(750) /* globalThis */,
   JS_NULL,
   JS_ROM_VALUE(754) /* console */,
-  JS_ROM_VALUE(2282),
+  JS_ROM_VALUE(2290),
   JS_ROM_VALUE(757) /* performance */,
-  JS_ROM_VALUE(2294),
+  JS_ROM_VALUE(2302),
   JS_ROM_VALUE(761) /* sim */,
-  JS_ROM_VALUE(2330),
-  JS_ROM_VALUE(796) /* gpio */,
-  JS_ROM_VALUE(2360),
-  JS_ROM_VALUE(816) /* i2c */,
-  JS_ROM_VALUE(2393),
-  JS_ROM_VALUE(840) /* print */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 165),
-  JS_ROM_VALUE(843) /* gc */,
-  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 166),
-  JS_ROM_VALUE(845) /* load */,
+  JS_ROM_VALUE(2338),
+  JS_ROM_VALUE(796) /* events */,
+  JS_ROM_VALUE(2353),
+  JS_ROM_VALUE(802) /* gpio */,
+  JS_ROM_VALUE(2383),
+  JS_ROM_VALUE(822) /* i2c */,
+  JS_ROM_VALUE(2416),
+  JS_ROM_VALUE(846) /* print */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 167),
-  JS_ROM_VALUE(848) /* setTimeout */,
+  JS_ROM_VALUE(849) /* gc */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 168),
-  JS_ROM_VALUE(852) /* clearTimeout */,
+  JS_ROM_VALUE(851) /* load */,
   JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 169),
+  JS_ROM_VALUE(854) /* setTimeout */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 170),
+  JS_ROM_VALUE(858) /* clearTimeout */,
+  JS_VALUE_MAKE_SPECIAL(JS_TAG_SHORT_FUNC, 171),
 };
 
 static const JSCFunctionDef js_c_function_table[] = {
@@ -3146,44 +3174,50 @@ static const JSCFunctionDef js_c_function_table[] = {
   { { .generic = js_sim_setSparkle },
     JS_ROM_VALUE(792) /* setSparkle */,
     JS_CFUNC_generic, 6, 0 },
+  { { .generic = js_events_push },
+    JS_ROM_VALUE(430) /* push */,
+    JS_CFUNC_generic, 2, 0 },
+  { { .generic = js_events_stats },
+    JS_ROM_VALUE(799) /* stats */,
+    JS_CFUNC_generic, 0, 0 },
   { { .generic = js_gpio_high },
-    JS_ROM_VALUE(799) /* high */,
+    JS_ROM_VALUE(805) /* high */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_gpio_low },
-    JS_ROM_VALUE(802) /* low */,
+    JS_ROM_VALUE(808) /* low */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_gpio_square },
-    JS_ROM_VALUE(804) /* square */,
+    JS_ROM_VALUE(810) /* square */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_gpio_pulse },
-    JS_ROM_VALUE(807) /* pulse */,
+    JS_ROM_VALUE(813) /* pulse */,
     JS_CFUNC_generic, 3, 0 },
   { { .generic = js_gpio_set_many },
-    JS_ROM_VALUE(810) /* setMany */,
+    JS_ROM_VALUE(816) /* setMany */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_gpio_stop },
-    JS_ROM_VALUE(813) /* stop */,
+    JS_ROM_VALUE(819) /* stop */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_i2c_config },
-    JS_ROM_VALUE(818) /* config */,
+    JS_ROM_VALUE(824) /* config */,
     JS_CFUNC_generic, 5, 0 },
   { { .generic = js_i2c_scan },
-    JS_ROM_VALUE(821) /* scan */,
+    JS_ROM_VALUE(827) /* scan */,
     JS_CFUNC_generic, 3, 0 },
   { { .generic = js_i2c_write_reg },
-    JS_ROM_VALUE(824) /* writeReg */,
+    JS_ROM_VALUE(830) /* writeReg */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_i2c_read_reg },
-    JS_ROM_VALUE(828) /* readReg */,
+    JS_ROM_VALUE(834) /* readReg */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_i2c_deconfig },
-    JS_ROM_VALUE(831) /* deconfig */,
+    JS_ROM_VALUE(837) /* deconfig */,
     JS_CFUNC_generic, 0, 0 },
   { { .generic = js_i2c_tx },
-    JS_ROM_VALUE(835) /* tx */,
+    JS_ROM_VALUE(841) /* tx */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_i2c_txrx },
-    JS_ROM_VALUE(837) /* txrx */,
+    JS_ROM_VALUE(843) /* txrx */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_global_eval },
     JS_ROM_VALUE(165) /* eval */,
@@ -3195,19 +3229,19 @@ static const JSCFunctionDef js_c_function_table[] = {
     JS_ROM_VALUE(746) /* isFinite */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_print },
-    JS_ROM_VALUE(840) /* print */,
+    JS_ROM_VALUE(846) /* print */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_gc },
-    JS_ROM_VALUE(843) /* gc */,
+    JS_ROM_VALUE(849) /* gc */,
     JS_CFUNC_generic, 0, 0 },
   { { .generic = js_load },
-    JS_ROM_VALUE(845) /* load */,
+    JS_ROM_VALUE(851) /* load */,
     JS_CFUNC_generic, 1, 0 },
   { { .generic = js_setTimeout },
-    JS_ROM_VALUE(848) /* setTimeout */,
+    JS_ROM_VALUE(854) /* setTimeout */,
     JS_CFUNC_generic, 2, 0 },
   { { .generic = js_clearTimeout },
-    JS_ROM_VALUE(852) /* clearTimeout */,
+    JS_ROM_VALUE(858) /* clearTimeout */,
     JS_CFUNC_generic, 1, 0 },
 };
 
@@ -3222,10 +3256,10 @@ const JSSTDLibraryDef js_stdlib = {
   js_stdlib_table,
   js_c_function_table,
   js_c_finalizer_table,
-  2493,
+  2518,
   64,
-  857,
-  2398,
+  863,
+  2421,
   JS_CLASS_COUNT,
 };
 
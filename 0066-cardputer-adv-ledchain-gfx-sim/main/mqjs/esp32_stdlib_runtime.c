@@ -14,6 +14,7 @@
 
 #include "sim_engine.h"
 
+#include "mqjs_events.h"
 #include "mqjs_timers.h"
 
 static sim_engine_t *s_engine = NULL;
@@ -327,6 +328,54 @@ static JSValue js_performance_now(JSContext *ctx, JSValue *this_val, int argc, J
   return JS_NewInt64(ctx, get_time_ms());
 }
 
+// events.push(topic, payloadJson): native side of `emit()` (see mqjs_events.h).
+static JSValue js_events_push(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv) {
+  (void)this_val;
+  if (argc < 2) return JS_ThrowTypeError(ctx, "events.push(topic, json) requires 2 arguments");
+  if (!JS_IsString(ctx, argv[0]) || !JS_IsString(ctx, argv[1])) {
+    return JS_ThrowTypeError(ctx, "events.push: topic and json must be strings");
+  }
+
+  // Copy the topic out first: converting the payload may allocate and move strings.
+  char topic[64];
+  JSCStringBuf tbuf;
+  memset(&tbuf, 0, sizeof(tbuf));
+  size_t topic_len = 0;
+  const char *t = JS_ToCStringLen(ctx, &topic_len, argv[0], &tbuf);
+  if (!t || topic_len == 0) return JS_ThrowTypeError(ctx, "events.push: topic must be non-empty");
+  if (topic_len >= sizeof(topic)) return JS_ThrowRangeError(ctx, "events.push: topic too long (max %u)", (unsigned)(sizeof(topic) - 1));
+  memcpy(topic, t, topic_len);
+
+  JSCStringBuf pbuf;
+  memset(&pbuf, 0, sizeof(pbuf));
+  size_t payload_len = 0;
+  const char *payload = JS_ToCStringLen(ctx, &payload_len, argv[1], &pbuf);
+  if (!payload) return JS_EXCEPTION;
+
+  return JS_NewBool(mqjs_0066_events_push(topic, topic_len, payload, payload_len, get_time_ms()) ? 1 : 0);
+}
+
+static JSValue js_events_stats(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv) {
+  (void)this_val;
+  (void)argc;
+  (void)argv;
+  mqjs_0066_events_stats_t st = {};
+  mqjs_0066_events_get_stats(&st);
+
+  JSValue o = JS_NewObject(ctx);
+  (void)JS_SetPropertyStr(ctx, o, "pushed", JS_NewUint32(ctx, st.pushed));
+  (void)JS_SetPropertyStr(ctx, o, "dropped", JS_NewUint32(ctx, st.dropped));
+  (void)JS_SetPropertyStr(ctx, o, "frames", JS_NewUint32(ctx, st.frames));
+  (void)JS_SetPropertyStr(ctx, o, "frame_bytes", JS_NewUint32(ctx, st.frame_bytes));
+  (void)JS_SetPropertyStr(ctx, o, "flushes", JS_NewUint32(ctx, st.flushes));
+  (void)JS_SetPropertyStr(ctx, o, "pending_bytes", JS_NewUint32(ctx, st.pending_bytes));
+  (void)JS_SetPropertyStr(ctx, o, "queue_lat_us_last", JS_NewUint32(ctx, st.queue_lat_us_last));
+  (void)JS_SetPropertyStr(ctx, o, "queue_lat_us_max", JS_NewUint32(ctx, st.queue_lat_us_max));
+  (void)JS_SetPropertyStr(ctx, o, "flush_us_last", JS_NewUint32(ctx, st.flush_us_last));
+  (void)JS_SetPropertyStr(ctx, o, "flush_us_max", JS_NewUint32(ctx, st.flush_us_max));
+  return o;
+}
+
 static JSValue js_load(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv) {
   (void)this_val;
   (void)argc;
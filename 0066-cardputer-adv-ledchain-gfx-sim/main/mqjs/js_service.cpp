@@ -10,15 +10,15 @@ extern const JSSTDLibraryDef js_stdlib;
 
 #include <string>
 
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 
 #include "sdkconfig.h"
 
-#include "http_server.h"
-
 #include "mqjs_service.h"
 #include "mqjs_vm.h"
 
+#include "mqjs_events.h"
 #include "mqjs_timers.h"
 
 // Provided by `mqjs/esp32_stdlib_runtime.c`.
@@ -54,46 +54,9 @@ static void log_js_exception(JSContext* ctx, const char* what) {
   ESP_LOGW(TAG, "%s: %s", what ? what : "js exception", err.c_str());
 }
 
-static void flush_js_events_to_ws(JSContext* ctx, const char* source) {
-  if (!ctx) return;
-
-  MqjsVm* vm = MqjsVm::From(ctx);
-  if (!vm) return;
-
-  const char* src = source ? source : "eval";
-  char expr[96];
-  snprintf(expr, sizeof(expr), "__0066_take_lines('%s')", src);
-
-  vm->SetDeadlineMs(50);
-  JSValue v = JS_Eval(ctx, expr, strlen(expr), "<flush>", JS_EVAL_REPL | JS_EVAL_RETVAL);
-  vm->ClearDeadline();
-
-  if (JS_IsException(v)) {
-    log_js_exception(ctx, "flush js events failed");
-    return;
-  }
-
-  if (!JS_IsString(ctx, v)) return;
-
-  JSCStringBuf sbuf;
-  memset(&sbuf, 0, sizeof(sbuf));
-  size_t n = 0;
-  const char* s = JS_ToCStringLen(ctx, &n, v, &sbuf);
-  if (!s || n == 0) return;
-
-  const char* p = s;
-  size_t remaining = n;
-  while (remaining > 0) {
-    const void* nl = memchr(p, '\n', remaining);
-    const size_t len = nl ? (size_t)((const char*)nl - p) : remaining;
-    if (len > 0) {
-      std::string line(p, len);
-      (void)http_server_ws_broadcast_text(line.c_str());
-    }
-    if (!nl) break;
-    p += len + 1;
-    remaining -= len + 1;
-  }
+// Events are queued natively by `events.push` (see mqjs_events.h); draining them needs no VM access.
+static void flush_js_events_to_ws(const char* source) {
+  (void)mqjs_0066_events_flush(source ? source : "eval");
 }
 
 static esp_err_t job_bootstrap(JSContext* ctx, void* user) {
@@ -108,10 +71,6 @@ static esp_err_t job_bootstrap(JSContext* ctx, void* user) {
       "__0066.timers.cb = __0066.timers.cb || {};\n"
       "__0066.gpio = __0066.gpio || {};\n"
       "__0066.gpio.state = __0066.gpio.state || { G3: 0, G4: 0 };\n"
-      "__0066.maxEvents = __0066.maxEvents || 64;\n"
-      "__0066.events = __0066.events || [];\n"
-      "__0066.dropped = __0066.dropped || 0;\n"
-      "__0066.ws_seq = __0066.ws_seq || 0;\n"
       "g.gpio = g.gpio || {};\n"
       "gpio.write = function(label, v) {\n"
       "  var k = String(label);\n"
@@ -131,21 +90,8 @@ static esp_err_t job_bootstrap(JSContext* ctx, void* user) {
       "};\n"
       "g.emit = function(topic, payload) {\n"
       "  if (typeof topic !== 'string' || topic.length === 0) throw new TypeError('emit: topic must be non-empty string');\n"
-      "  if (__0066.events.length >= __0066.maxEvents) { __0066.dropped = (__0066.dropped || 0) + 1; return; }\n"
-      "  __0066.events.push({ topic: topic, payload: payload, ts_ms: Date.now() });\n"
-      "};\n"
-      "g.__0066_take_lines = function(source) {\n"
-      "  var dropped = __0066.dropped || 0;\n"
-      "  var ev = __0066.events || [];\n"
-      "  if (ev.length === 0 && dropped === 0) return '';\n"
-      "  __0066.events = [];\n"
-      "  __0066.dropped = 0;\n"
-      "  var src = String(source || 'eval');\n"
-      "  var s = JSON.stringify({ type: 'js_events', seq: (__0066.ws_seq++), ts_ms: Date.now(), source: src, events: ev });\n"
-      "  if (dropped) {\n"
-      "    s += '\\n' + JSON.stringify({ type: 'js_events_dropped', seq: (__0066.ws_seq++), ts_ms: Date.now(), source: src, dropped: dropped });\n"
-      "  }\n"
-      "  return s;\n"
+      "  var j = JSON.stringify(payload);\n"
+      "  return events.push(topic, (j === undefined) ? 'null' : j);\n"
       "};\n"
       "if (typeof sim === 'object' && sim) {\n"
       "  sim.statusJson = function () {\n"
@@ -188,12 +134,6 @@ static esp_err_t job_bootstrap(JSContext* ctx, void* user) {
   return ESP_OK;
 }
 
-static esp_err_t job_flush_ws(JSContext* ctx, void* user) {
-  const char* src = user ? static_cast<const char*>(user) : "eval";
-  flush_js_events_to_ws(ctx, src);
-  return ESP_OK;
-}
-
 }  // namespace
 
 esp_err_t js_service_start(sim_engine_t* engine) {
@@ -202,6 +142,7 @@ esp_err_t js_service_start(sim_engine_t* engine) {
 
   s_engine = engine;
   mqjs_sim_set_engine(engine);
+  mqjs_0066_events_init();
 
   mqjs_service_config_t cfg = {};
   cfg.task_name = "0066_js";
@@ -210,6 +151,9 @@ esp_err_t js_service_start(sim_engine_t* engine) {
   cfg.task_core_id = -1;
   cfg.queue_len = 16;
   cfg.arena_bytes = CONFIG_TUTORIAL_0066_JS_MEM_BYTES;
+#if CONFIG_TUTORIAL_0066_JS_ARENA_PSRAM
+  cfg.arena_caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+#endif
   cfg.stdlib = &js_stdlib;
   cfg.fix_global_this = true;
 
@@ -241,6 +185,8 @@ void js_service_stop(void) {
   if (!s_svc) return;
   mqjs_service_stop(s_svc);
   s_svc = nullptr;
+  // Events the old VM queued but never flushed must not reach clients of the next one.
+  mqjs_0066_events_clear();
 }
 
 esp_err_t js_service_reset(sim_engine_t* engine) {
@@ -297,8 +243,46 @@ static esp_err_t job_dump_memory(JSContext* ctx, void* user) {
   return ESP_OK;
 }
 
+struct ProfileArg {
+  const char* action = nullptr;
+  std::string* out = nullptr;
+};
+
+static esp_err_t job_alloc_profile(JSContext* ctx, void* user) {
+  auto* a = static_cast<ProfileArg*>(user);
+  if (!a || !a->out || !a->action) return ESP_ERR_INVALID_ARG;
+  MqjsVm* vm = MqjsVm::From(ctx);
+  if (!vm) return ESP_FAIL;
+  if (strcmp(a->action, "start") == 0) {
+    vm->StartAllocProfile();
+    *(a->out) = "prof: started\n";
+  } else if (strcmp(a->action, "stop") == 0) {
+    vm->StopAllocProfile();
+    *(a->out) = "prof: stopped\n";
+  } else if (strcmp(a->action, "dump") == 0) {
+    *(a->out) = vm->DumpAllocProfile();
+  } else {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return ESP_OK;
+}
+
 }  // namespace
 
+esp_err_t js_service_alloc_profile(const char* action, std::string* out) {
+  if (!out) return ESP_ERR_INVALID_ARG;
+  out->clear();
+  if (!s_svc) return ESP_ERR_INVALID_STATE;
+
+  ProfileArg a = {.action = action ? action : "dump", .out = out};
+  mqjs_job_t job = {};
+  job.fn = &job_alloc_profile;
+  job.user = &a;
+  // Dump runs a full GC and walks the heap; allow more than a plain memory dump.
+  job.timeout_ms = 500;
+  return mqjs_service_run(s_svc, &job);
+}
+
 esp_err_t js_service_dump_memory(std::string* out) {
   if (!out) return ESP_ERR_INVALID_ARG;
   out->clear();
@@ -350,12 +334,13 @@ std::string js_service_eval_to_json(const char* code,
 
   mqjs_eval_result_free(&r);
 
-  const mqjs_job_t flush = {.fn = &job_flush_ws, .user = (void*)"eval", .timeout_ms = 0};
-  (void)mqjs_service_post(s_svc, &flush);
+  // Drain on the HTTP task: the channel is native, so this doesn't queue work on the VM.
+  flush_js_events_to_ws("eval");
 
   return json;
 }
 
 extern "C" void mqjs_0066_after_js_callback(JSContext* ctx, const char* source) {
-  flush_js_events_to_ws(ctx, source ? source : "callback");
+  (void)ctx;
+  flush_js_events_to_ws(source ? source : "callback");
 }
@@ -30,6 +30,9 @@ esp_err_t js_service_eval(const char* code,
 // Dump VM memory stats (same output as JS_DumpMemory).
 esp_err_t js_service_dump_memory(std::string* out);
 
+// Allocation profiler: action is "start", "stop" or "dump" (see MqjsVm::DumpAllocProfile).
+esp_err_t js_service_alloc_profile(const char* action, std::string* out);
+
 // Evaluate JS and return a JSON response string:
 // {"ok":true|false,"output":"...","error":null|"...","timed_out":true|false}
 //
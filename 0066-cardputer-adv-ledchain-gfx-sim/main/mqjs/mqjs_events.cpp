@@ -0,0 +1,271 @@
+#include "mqjs_events.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_timer.h"
+
+#include "sdkconfig.h"
+
+#include "http_server.h"
+
+namespace {
+
+constexpr size_t kRingBytes = CONFIG_TUTORIAL_0066_JS_EVENTS_RING_BYTES;
+constexpr size_t kFrameBytes = CONFIG_TUTORIAL_0066_JS_EVENTS_FRAME_BYTES;
+// Room for the frame envelope: {"type":"js_events","seq":N,"ts_ms":N,"source":"...","events":[ ... ]}
+constexpr size_t kFrameHeadroom = 128;
+constexpr size_t kMaxSourceLen = 24;
+constexpr size_t kMaxRecordBytes = kFrameBytes - kFrameHeadroom;
+constexpr size_t kLenPrefix = 2;
+
+static_assert(kFrameBytes > kFrameHeadroom + 64, "JS events frame too small");
+static_assert(kMaxRecordBytes <= 0xFFFF, "record length must fit the u16 prefix");
+
+portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Ring of [u16 len][len bytes of event JSON] records.
+uint8_t s_ring[kRingBytes];
+size_t s_head = 0;  // write offset
+size_t s_tail = 0;  // read offset
+size_t s_used = 0;
+int64_t s_oldest_us = 0;
+uint32_t s_dropped_since_flush = 0;
+
+// Producer scratch (JS task only).
+char s_record[kMaxRecordBytes];
+
+// Consumer state, serialized by s_flush_mu.
+StaticSemaphore_t s_flush_mu_buf;
+SemaphoreHandle_t s_flush_mu = nullptr;
+char s_frame[kFrameBytes];
+uint32_t s_seq = 0;
+
+mqjs_0066_events_stats_t s_stats = {};
+
+void ring_write(const void* src, size_t len) {
+  const size_t first = (len < kRingBytes - s_head) ? len : kRingBytes - s_head;
+  memcpy(&s_ring[s_head], src, first);
+  if (len > first) memcpy(&s_ring[0], static_cast<const uint8_t*>(src) + first, len - first);
+  s_head = (s_head + len) % kRingBytes;
+  s_used += len;
+}
+
+void ring_read(void* dst, size_t len) {
+  const size_t first = (len < kRingBytes - s_tail) ? len : kRingBytes - s_tail;
+  memcpy(dst, &s_ring[s_tail], first);
+  if (len > first) memcpy(static_cast<uint8_t*>(dst) + first, &s_ring[0], len - first);
+  s_tail = (s_tail + len) % kRingBytes;
+  s_used -= len;
+}
+
+size_t ring_peek_len(void) {
+  const uint8_t lo = s_ring[s_tail];
+  const uint8_t hi = s_ring[(s_tail + 1) % kRingBytes];
+  return (size_t)lo | ((size_t)hi << 8);
+}
+
+// Appends `s` as JSON string contents; returns false if `cap` would be exceeded.
+bool json_escape(char* out, size_t cap, size_t* pos, const char* s, size_t len) {
+  size_t p = *pos;
+  for (size_t i = 0; i < len; i++) {
+    const unsigned char c = (unsigned char)s[i];
+    if (c == '"' || c == '\\') {
+      if (p + 2 > cap) return false;
+      out[p++] = '\\';
+      out[p++] = (char)c;
+    } else if (c < 0x20) {
+      if (p + 6 > cap) return false;
+      p += (size_t)snprintf(&out[p], 7, "\\u%04x", c);
+    } else {
+      if (p + 1 > cap) return false;
+      out[p++] = (char)c;
+    }
+  }
+  *pos = p;
+  return true;
+}
+
+void count_drop(void) {
+  taskENTER_CRITICAL(&s_mux);
+  s_stats.dropped++;
+  s_dropped_since_flush++;
+  taskEXIT_CRITICAL(&s_mux);
+}
+
+size_t frame_begin(const char* source, int64_t now_ms) {
+  const int n = snprintf(s_frame,
+                         kFrameBytes,
+                         "{\"type\":\"js_events\",\"seq\":%lu,\"ts_ms\":%lld,\"source\":\"%.*s\",\"events\":[",
+                         (unsigned long)s_seq++,
+                         (long long)now_ms,
+                         (int)kMaxSourceLen,
+                         source);
+  return (n > 0) ? (size_t)n : 0;
+}
+
+void frame_send(size_t len) {
+  s_frame[len++] = ']';
+  s_frame[len++] = '}';
+  s_frame[len] = '\0';
+  (void)http_server_ws_broadcast_text(s_frame);
+  taskENTER_CRITICAL(&s_mux);
+  s_stats.frames++;
+  s_stats.frame_bytes += (uint32_t)len;
+  taskEXIT_CRITICAL(&s_mux);
+}
+
+}  // namespace
+
+bool mqjs_0066_events_push(const char* topic,
+                           size_t topic_len,
+                           const char* payload_json,
+                           size_t payload_len,
+                           int64_t ts_ms) {
+  size_t n = 0;
+  static const char kTopic[] = "{\"topic\":\"";
+  static const char kPayload[] = "\",\"payload\":";
+  memcpy(s_record, kTopic, sizeof(kTopic) - 1);
+  n = sizeof(kTopic) - 1;
+  if (!json_escape(s_record, kMaxRecordBytes, &n, topic, topic_len) ||
+      n + (sizeof(kPayload) - 1) + payload_len + 32 > kMaxRecordBytes) {
+    count_drop();
+    return false;
+  }
+  memcpy(&s_record[n], kPayload, sizeof(kPayload) - 1);
+  n += sizeof(kPayload) - 1;
+  memcpy(&s_record[n], payload_json, payload_len);
+  n += payload_len;
+  n += (size_t)snprintf(&s_record[n], kMaxRecordBytes - n, ",\"ts_ms\":%lld}", (long long)ts_ms);
+
+  const uint8_t prefix[kLenPrefix] = {(uint8_t)(n & 0xFF), (uint8_t)(n >> 8)};
+  bool ok = false;
+  taskENTER_CRITICAL(&s_mux);
+  if (s_used + kLenPrefix + n <= kRingBytes) {
+    if (s_used == 0) s_oldest_us = esp_timer_get_time();
+    ring_write(prefix, kLenPrefix);
+    ring_write(s_record, n);
+    s_stats.pushed++;
+    ok = true;
+  } else {
+    s_stats.dropped++;
+    s_dropped_since_flush++;
+  }
+  taskEXIT_CRITICAL(&s_mux);
+  return ok;
+}
+
+void mqjs_0066_events_init(void) {
+  if (!s_flush_mu) s_flush_mu = xSemaphoreCreateMutexStatic(&s_flush_mu_buf);
+}
+
+size_t mqjs_0066_events_flush(const char* source) {
+  if (!s_flush_mu) return 0;
+  taskENTER_CRITICAL(&s_mux);
+  const bool idle = (s_used == 0 && s_dropped_since_flush == 0);
+  taskEXIT_CRITICAL(&s_mux);
+  if (idle) return 0;
+
+  xSemaphoreTake(s_flush_mu, portMAX_DELAY);
+
+  const char* src = source ? source : "eval";
+  const int64_t t0 = esp_timer_get_time();
+  const int64_t now_ms = t0 / 1000;
+  size_t sent = 0;
+  size_t in_frame = 0;
+  size_t len = 0;
+  int64_t oldest_us = 0;
+  uint32_t dropped = 0;
+
+  for (;;) {
+    taskENTER_CRITICAL(&s_mux);
+    if (s_used == 0) {
+      dropped = s_dropped_since_flush;
+      s_dropped_since_flush = 0;
+      taskEXIT_CRITICAL(&s_mux);
+      break;
+    }
+    if (sent == 0 && in_frame == 0) oldest_us = s_oldest_us;
+    const size_t rec_len = ring_peek_len();
+    // Keep 3 bytes for ',' and the closing "]}" plus NUL.
+    if (in_frame > 0 && len + 1 + rec_len + 3 > kFrameBytes) {
+      taskEXIT_CRITICAL(&s_mux);
+      frame_send(len);
+      sent += in_frame;
+      in_frame = 0;
+      continue;
+    }
+    if (in_frame == 0) {
+      // Pushes only append and clear() waits for s_flush_mu, so rec_len still
+      // describes the record at s_tail after re-entering.
+      taskEXIT_CRITICAL(&s_mux);
+      len = frame_begin(src, now_ms);
+      taskENTER_CRITICAL(&s_mux);
+    } else {
+      s_frame[len++] = ',';
+    }
+    uint8_t prefix[kLenPrefix];
+    ring_read(prefix, kLenPrefix);
+    ring_read(&s_frame[len], rec_len);
+    len += rec_len;
+    in_frame++;
+    taskEXIT_CRITICAL(&s_mux);
+  }
+  if (in_frame > 0) {
+    frame_send(len);
+    sent += in_frame;
+  }
+
+  if (dropped) {
+    const int n = snprintf(s_frame,
+                           kFrameBytes,
+                           "{\"type\":\"js_events_dropped\",\"seq\":%lu,\"ts_ms\":%lld,\"source\":\"%.*s\",\"dropped\":%lu}",
+                           (unsigned long)s_seq++,
+                           (long long)now_ms,
+                           (int)kMaxSourceLen,
+                           src,
+                           (unsigned long)dropped);
+    (void)http_server_ws_broadcast_text(s_frame);
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.frames++;
+    s_stats.frame_bytes += (n > 0) ? (uint32_t)n : 0;
+    taskEXIT_CRITICAL(&s_mux);
+  }
+
+  const int64_t t1 = esp_timer_get_time();
+  const uint32_t flush_us = (uint32_t)(t1 - t0);
+  const uint32_t queue_us = (sent > 0) ? (uint32_t)(t0 - oldest_us) : 0;
+  taskENTER_CRITICAL(&s_mux);
+  s_stats.flushes++;
+  s_stats.flush_us_last = flush_us;
+  if (flush_us > s_stats.flush_us_max) s_stats.flush_us_max = flush_us;
+  if (sent > 0) {
+    s_stats.queue_lat_us_last = queue_us;
+    if (queue_us > s_stats.queue_lat_us_max) s_stats.queue_lat_us_max = queue_us;
+  }
+  taskEXIT_CRITICAL(&s_mux);
+
+  xSemaphoreGive(s_flush_mu);
+  return sent;
+}
+
+void mqjs_0066_events_clear(void) {
+  // A flush drops s_mux between peeking a record and reading it; let it finish first.
+  if (s_flush_mu) xSemaphoreTake(s_flush_mu, portMAX_DELAY);
+  taskENTER_CRITICAL(&s_mux);
+  s_head = s_tail = s_used = 0;
+  s_dropped_since_flush = 0;
+  taskEXIT_CRITICAL(&s_mux);
+  if (s_flush_mu) xSemaphoreGive(s_flush_mu);
+}
+
+void mqjs_0066_events_get_stats(mqjs_0066_events_stats_t* out) {
+  if (!out) return;
+  taskENTER_CRITICAL(&s_mux);
+  *out = s_stats;
+  out->pending_bytes = (uint32_t)s_used;
+  taskEXIT_CRITICAL(&s_mux);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Native JS -> WebSocket event channel.
+//
+// `emit(topic, payload)` in JS lands in `mqjs_0066_events_push()` (through the
+// `events.push` native binding), which appends a preformatted JSON record to a
+// fixed byte ring. `mqjs_0066_events_flush()` drains the ring into batched
+// `{"type":"js_events",...,"events":[...]}` WebSocket frames without touching
+// the VM, so it can run on any task.
+//
+// Invariants:
+// - Single producer (the JS service task); flush may run on any task.
+// - A record that doesn't fit is dropped and counted, never partially written.
+
+typedef struct {
+  uint32_t pushed;          // records accepted into the ring
+  uint32_t dropped;         // records rejected (ring full or oversize)
+  uint32_t frames;          // WebSocket frames broadcast
+  uint32_t frame_bytes;     // total bytes broadcast
+  uint32_t flushes;         // flush calls that found pending records
+  uint32_t pending_bytes;   // bytes currently queued in the ring
+  uint32_t queue_lat_us_last;  // oldest pending record age at flush
+  uint32_t queue_lat_us_max;
+  uint32_t flush_us_last;      // time spent draining + broadcasting
+  uint32_t flush_us_max;
+} mqjs_0066_events_stats_t;
+
+// Creates the flush lock. Call once before the JS service starts; flush is a
+// no-op until then.
+void mqjs_0066_events_init(void);
+
+// Append one event. `payload_json` must already be valid JSON.
+// Returns false (and counts a drop) if the ring is full.
+bool mqjs_0066_events_push(const char* topic,
+                           size_t topic_len,
+                           const char* payload_json,
+                           size_t payload_len,
+                           int64_t ts_ms);
+
+// Drain all pending records into batched WS frames tagged with `source`.
+// Returns the number of events sent.
+size_t mqjs_0066_events_flush(const char* source);
+
+// Drop anything pending (VM reset). Counters are kept.
+void mqjs_0066_events_clear(void);
+
+void mqjs_0066_events_get_stats(mqjs_0066_events_stats_t* out);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -92,6 +92,31 @@ static void kb_print_once(void)
     }
 }
 
+static void kb_print_latency(void)
+{
+    ui_kb_latency_t lat;
+    if (!ui_kb_latency_get(&lat)) {
+        printf("kb: latency unavailable\n");
+        return;
+    }
+
+    printf("kb: latency mode=%s events=%" PRIu32 " mean=%" PRIu32 "us p50<=%" PRIu32 "us p99<=%" PRIu32
+           "us max=%" PRIu32 "us\n",
+           lat.interrupt_driven ? "int" : "poll",
+           lat.total,
+           lat.mean_us,
+           lat.p50_us,
+           lat.p99_us,
+           lat.max_us);
+    static const char *const kBuckets[10] = {
+        "<250us", "<500us", "<1ms", "<2ms", "<4ms", "<8ms", "<16ms", "<32ms", "<64ms", ">=64ms",
+    };
+    for (int i = 0; i < 10; i++) {
+        if (lat.counts[i] == 0) continue;
+        printf("  %-7s %" PRIu32 "\n", kBuckets[i], lat.counts[i]);
+    }
+}
+
 static void kb_usage(void)
 {
     printf("kb: keyboard debug\n");
@@ -99,6 +124,7 @@ static void kb_usage(void)
     printf("  kb\n");
     printf("  kb once\n");
     printf("  kb watch [period_ms=200] [count=50]\n");
+    printf("  kb latency [reset]\n");
 }
 
 static bool parse_int(const char *s, int *out)
@@ -137,6 +163,15 @@ static int cmd_kb(int argc, char **argv)
         }
         return 0;
     }
+    if (argc >= 2 && strcmp(argv[1], "latency") == 0) {
+        if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+            ui_kb_latency_reset();
+            printf("kb: latency reset\n");
+            return 0;
+        }
+        kb_print_latency();
+        return 0;
+    }
 
     kb_usage();
     return 1;
@@ -541,7 +576,7 @@ void sim_console_register_commands(sim_engine_t *engine)
     {
         esp_console_cmd_t cmd = {};
         cmd.command = "kb";
-        cmd.help = "Keyboard debug (dump pressed keynums, legend, last event)";
+        cmd.help = "Keyboard debug (dump pressed keynums, legend, last event, key latency)";
         cmd.func = &cmd_kb;
         ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
     }
@@ -36,6 +36,10 @@ struct DebugState {
     ui_key_event_t last_event = {};
 
     uint32_t seq = 0;
+
+    bool interrupt_driven = false;
+    cardputer_kb::KeyLatencyHistogram latency;
+    bool latency_reset = false;
 };
 
 static portMUX_TYPE s_dbg_mu = portMUX_INITIALIZER_UNLOCKED;
@@ -182,7 +186,14 @@ static void kb_task_main(void *arg)
         s_dbg.mods = mods;
         memcpy(s_dbg.down, down, sizeof(s_dbg.down));
         s_dbg.seq++;
+        s_dbg.interrupt_driven = s_scanner.interrupt_driven();
+        const bool latency_reset = s_dbg.latency_reset;
+        s_dbg.latency_reset = false;
+        s_dbg.latency = latency_reset ? cardputer_kb::KeyLatencyHistogram{} : s_scanner.latency();
         portEXIT_CRITICAL(&s_dbg_mu);
+        if (latency_reset) {
+            s_scanner.reset_latency();
+        }
 
         // Emit "edge" events only (press transitions).
         for (uint8_t keynum = 1; keynum <= (cardputer_kb::kRows * cardputer_kb::kCols); keynum++) {
@@ -297,7 +308,9 @@ static void kb_task_main(void *arg)
         }
 
         memcpy(prev_down, down, sizeof(prev_down));
-        vTaskDelay(pdMS_TO_TICKS(CONFIG_TUTORIAL_0066_KB_SCAN_PERIOD_MS));
+        // TCA8418 with INT wired: returns as soon as a key event arrives (scan period is then only the
+        // idle timeout). Otherwise this is the plain scan-period delay.
+        (void)s_scanner.wait(CONFIG_TUTORIAL_0066_KB_SCAN_PERIOD_MS);
     }
 }
 
@@ -347,3 +360,33 @@ extern "C" bool ui_kb_debug_get_state(ui_kb_debug_state_t *out)
     out->pressed_count = n;
     return true;
 }
+
+extern "C" bool ui_kb_latency_get(ui_kb_latency_t *out)
+{
+    if (!out) return false;
+
+    cardputer_kb::KeyLatencyHistogram h;
+    bool interrupt_driven = false;
+    portENTER_CRITICAL(&s_dbg_mu);
+    h = s_dbg.latency;
+    interrupt_driven = s_dbg.interrupt_driven;
+    portEXIT_CRITICAL(&s_dbg_mu);
+
+    static_assert(sizeof(out->counts) == sizeof(h.counts), "ui_kb_latency_t bucket count");
+    memset(out, 0, sizeof(*out));
+    out->interrupt_driven = interrupt_driven;
+    memcpy(out->counts, h.counts, sizeof(out->counts));
+    out->total = h.total;
+    out->mean_us = h.mean_us();
+    out->p50_us = h.percentile_upper_us(50);
+    out->p99_us = h.percentile_upper_us(99);
+    out->max_us = h.max_us;
+    return true;
+}
+
+extern "C" void ui_kb_latency_reset(void)
+{
+    portENTER_CRITICAL(&s_dbg_mu);
+    s_dbg.latency_reset = true;
+    portEXIT_CRITICAL(&s_dbg_mu);
+}
@@ -74,6 +74,24 @@ typedef struct {
 // Returns false if out is null.
 bool ui_kb_debug_get_state(ui_kb_debug_state_t *out);
 
+// Key-to-app latency (cardputer_kb::KeyLatencyHistogram), TCA8418 backend only: time from the key event
+// timestamp (INT edge, or the poll that found it) to the kb task seeing the new key state.
+typedef struct {
+    bool interrupt_driven; // false: TCA8418 polled every scan period (or GPIO matrix backend)
+    uint32_t counts[10];   // bucket upper bounds: 250, 500, 1000 ... 64000 us, then the rest
+    uint32_t total;
+    uint32_t mean_us;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} ui_kb_latency_t;
+
+// Returns false if out is null.
+bool ui_kb_latency_get(ui_kb_latency_t *out);
+
+// Clears the histogram (applied by the kb task on its next scan).
+void ui_kb_latency_reset(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
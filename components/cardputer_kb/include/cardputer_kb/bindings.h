@@ -3,8 +3,11 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <vector>
 
+#include "cardputer_kb/keymask.h"
+
 namespace cardputer_kb {
 
 enum class Action : uint8_t {
@@ -25,6 +28,37 @@ struct Binding {
     uint8_t keynums[4];
 };
 
+// A Binding compiled to one mask/compare pair: it matches when (down & mask) == mask.
+struct MaskBinding {
+    KeyMask mask;
+    Action action;
+    uint8_t n;
+};
+
+// Bit 63 is never set by a scan; a binding with a keyNum outside 1..56 gets it so it never
+// matches (as with the old vector search).
+static constexpr KeyMask kUnmatchableBit = KeyMask(1) << 63;
+
+static constexpr KeyMask binding_mask(const Binding &b) {
+    KeyMask m = 0;
+    for (uint8_t i = 0; i < b.n && i < 4; i++) {
+        const KeyMask bit = key_bit(b.keynums[i]);
+        m |= bit ? bit : kUnmatchableBit;
+    }
+    return m;
+}
+
+// Compiles a binding table at build time:
+//   static constexpr auto kMasks = compile_bindings(kBindings);
+template <size_t N>
+constexpr std::array<MaskBinding, N> compile_bindings(const Binding (&bindings)[N]) {
+    std::array<MaskBinding, N> out{};
+    for (size_t i = 0; i < N; i++) {
+        out[i] = MaskBinding{binding_mask(bindings[i]), bindings[i].action, bindings[i].n};
+    }
+    return out;
+}
+
 inline const char *action_name(Action a) {
     switch (a) {
     case Action::NavUp: return "NavUp";
@@ -40,36 +74,46 @@ inline const char *action_name(Action a) {
     return "Unknown";
 }
 
-inline bool pressed_contains_all(const std::vector<uint8_t> &pressed_keynums, const Binding &b) {
-    for (uint8_t i = 0; i < b.n; i++) {
-        bool found = false;
-        for (auto kn : pressed_keynums) {
-            if (kn == b.keynums[i]) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return false;
+// Returns the most-specific matching binding (largest chord wins) or nullptr.
+// Ties go to the earlier entry.
+inline const MaskBinding *decode_best(KeyMask down, const MaskBinding *bindings, size_t bindings_count) {
+    const MaskBinding *best = nullptr;
+    for (size_t i = 0; i < bindings_count; i++) {
+        const MaskBinding &b = bindings[i];
+        if ((down & b.mask) == b.mask && (best == nullptr || b.n > best->n)) {
+            best = &b;
         }
     }
-    return true;
+    return best;
 }
 
-// Returns the most-specific matching binding (largest chord wins) or nullptr.
-inline const Binding *decode_best(const std::vector<uint8_t> &pressed_keynums, const Binding *bindings,
-                                  size_t bindings_count) {
+template <size_t N>
+inline const MaskBinding *decode_best(KeyMask down, const std::array<MaskBinding, N> &bindings) {
+    return decode_best(down, bindings.data(), N);
+}
+
+// Same, for an uncompiled table (masks are built per call).
+inline const Binding *decode_best(KeyMask down, const Binding *bindings, size_t bindings_count) {
     const Binding *best = nullptr;
     for (size_t i = 0; i < bindings_count; i++) {
         const Binding &b = bindings[i];
-        if (!pressed_contains_all(pressed_keynums, b)) {
-            continue;
-        }
-        if (best == nullptr || b.n > best->n) {
+        const KeyMask m = binding_mask(b);
+        if ((down & m) == m && (best == nullptr || b.n > best->n)) {
             best = &b;
         }
     }
     return best;
 }
 
+// Vector adapters for ScanSnapshot::pressed_keynums callers.
+inline bool pressed_contains_all(const std::vector<uint8_t> &pressed_keynums, const Binding &b) {
+    const KeyMask m = binding_mask(b);
+    return (mask_from_keynums(pressed_keynums.data(), pressed_keynums.size()) & m) == m;
+}
+
+inline const Binding *decode_best(const std::vector<uint8_t> &pressed_keynums, const Binding *bindings,
+                                  size_t bindings_count) {
+    return decode_best(mask_from_keynums(pressed_keynums.data(), pressed_keynums.size()), bindings, bindings_count);
+}
+
 } // namespace cardputer_kb
@@ -31,4 +31,7 @@ static constexpr Binding kCapturedBindingsM5Cardputer[] = {
     {Action::Space, 1, {56, 0, 0, 0}},
 };
 
+// Mask form of the table above, for decode_best(KeyMask, ...).
+static constexpr auto kCapturedBindingsM5CardputerMasks = compile_bindings(kCapturedBindingsM5Cardputer);
+
 } // namespace cardputer_kb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace cardputer_kb {
+
+// Histogram of key-to-app latency (key event timestamp -> scan_mask() returning it), in microseconds.
+// Bucket i holds latencies below kKeyLatencyBucketUpperUs[i]; the last bucket holds the rest.
+static constexpr int kKeyLatencyBuckets = 10;
+static constexpr uint32_t kKeyLatencyBucketUpperUs[kKeyLatencyBuckets - 1] = {
+    250, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000,
+};
+
+struct KeyLatencyHistogram {
+    uint32_t counts[kKeyLatencyBuckets] = {};
+    uint32_t total = 0;
+    uint32_t max_us = 0;
+    uint64_t sum_us = 0;
+
+    void record(int64_t latency_us) {
+        const uint32_t us = (latency_us <= 0) ? 0 : (latency_us >= 0xFFFFFFFF ? 0xFFFFFFFFu : (uint32_t)latency_us);
+        int b = 0;
+        while (b < kKeyLatencyBuckets - 1 && us >= kKeyLatencyBucketUpperUs[b]) {
+            b++;
+        }
+        counts[b]++;
+        total++;
+        sum_us += us;
+        if (us > max_us) {
+            max_us = us;
+        }
+    }
+
+    uint32_t mean_us() const { return total ? (uint32_t)(sum_us / total) : 0; }
+
+    // Upper bound of the bucket holding the pct-th percentile (max_us for the last bucket), 0 if empty.
+    uint32_t percentile_upper_us(int pct) const {
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t want = ((uint64_t)total * (uint64_t)pct + 99) / 100;
+        uint64_t seen = 0;
+        for (int b = 0; b < kKeyLatencyBuckets - 1; b++) {
+            seen += counts[b];
+            if (seen >= want && seen > 0) {
+                return kKeyLatencyBucketUpperUs[b] < max_us ? kKeyLatencyBucketUpperUs[b] : max_us;
+            }
+        }
+        return max_us;
+    }
+};
+
+} // namespace cardputer_kb
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cardputer_kb/layout.h"
+
+namespace cardputer_kb {
+
+// Set of pressed physical keys: bit (keyNum - 1) for keyNum 1..56.
+//
+// This is the allocation-free scan result. Set operations are single instructions:
+// "is fn down" is a mask test, a chord match is `(down & m) == m`, and edges are `prev ^ cur`.
+using KeyMask = uint64_t;
+
+static constexpr KeyMask kAllKeysMask = (KeyMask(1) << (kRows * kCols)) - 1;
+
+static constexpr KeyMask key_bit(uint8_t keynum) {
+    return (keynum >= 1 && keynum <= (kRows * kCols)) ? (KeyMask(1) << (keynum - 1)) : 0;
+}
+
+static constexpr bool mask_has(KeyMask m, uint8_t keynum) {
+    return (m & key_bit(keynum)) != 0;
+}
+
+// keyNums outside 1..56 are dropped.
+static constexpr KeyMask mask_from_keynums(const uint8_t *keynums, size_t count) {
+    KeyMask m = 0;
+    for (size_t i = 0; i < count; i++) {
+        m |= key_bit(keynums[i]);
+    }
+    return m;
+}
+
+static inline int mask_count(KeyMask m) {
+    return __builtin_popcountll(m);
+}
+
+// Lowest keyNum in m, or 0 if m is empty. Visit keys in ascending keyNum order (same order as
+// ScanSnapshot::pressed_keynums) with:
+//
+//   for (KeyMask m = down; m; m &= m - 1) { uint8_t kn = mask_first(m); ... }
+static inline uint8_t mask_first(KeyMask m) {
+    return m ? (uint8_t)(__builtin_ctzll(m) + 1) : 0;
+}
+
+struct KeyEdges {
+    KeyMask down;     // pressed now
+    KeyMask pressed;  // went down since the previous scan
+    KeyMask released; // went up since the previous scan
+};
+
+static constexpr KeyEdges key_edges(KeyMask prev, KeyMask cur) {
+    const KeyMask changed = prev ^ cur;
+    return KeyEdges{cur, changed & cur, changed & prev};
+}
+
+// Keeps the previous scan so callers do not have to.
+struct KeyEdgeTracker {
+    KeyMask prev = 0;
+
+    KeyEdges update(KeyMask cur) {
+        const KeyEdges e = key_edges(prev, cur);
+        prev = cur;
+        return e;
+    }
+};
+
+namespace detail {
+
+// kSpread7.v[m] moves bit j of a 7-bit input mask to bit 2j.
+struct Spread7Table {
+    uint16_t v[128];
+    constexpr Spread7Table() : v() {
+        for (int m = 0; m < 128; m++) {
+            uint16_t s = 0;
+            for (int j = 0; j < 7; j++) {
+                if (m & (1 << j)) {
+                    s = (uint16_t)(s | (1u << (2 * j)));
+                }
+            }
+            v[m] = s;
+        }
+    }
+};
+
+static constexpr Spread7Table kSpread7{};
+
+} // namespace detail
+
+// GPIO matrix wiring: keys seen while the 3-bit select outputs drive `scan_state` (0..7), given the
+// 7-bit input mask (bit j set = input j pulled low).
+//
+// scan_state 0..3 reads the odd columns (x = 2j+1), 4..7 the even columns (x = 2j), and the row is
+// flipped to match the vendor "picture" (y = 3 - (scan_state & 3)). Since keyNum - 1 = y*14 + x,
+// one row of one parity is the input mask spread to every other bit and shifted into place.
+static constexpr KeyMask matrix_state_mask(int scan_state, uint8_t in_mask) {
+    const int y = 3 - (scan_state & 3);
+    const int x0 = (scan_state > 3) ? 0 : 1;
+    return (KeyMask)detail::kSpread7.v[in_mask & 0x7F] << (y * kCols + x0);
+}
+
+} // namespace cardputer_kb
@@ -25,6 +25,20 @@ static inline void xy_from_keynum(uint8_t keynum, int *out_x, int *out_y) {
     if (out_y) *out_y = idx / kCols;
 }
 
+// Cardputer-ADV: TCA8418 keypad key number (1..80, 10-wide internal matrix) to picture-space
+// keyNum, or 0 if the key is outside the 4x14 keyboard.
+static inline uint8_t keynum_from_tca8418_key(uint8_t tca_key) {
+    if (tca_key < 1 || tca_key > 80) {
+        return 0;
+    }
+    const uint8_t k = (uint8_t)(tca_key - 1);
+    const uint8_t row = (uint8_t)(k / 10);
+    const uint8_t col = (uint8_t)(k % 10);
+    const int x = row * 2 + ((col > 3) ? 1 : 0);
+    const int y = (col + 4) % 4;
+    return keynum_from_xy(x, y);
+}
+
 // Vendor legend table (Cardputer “picture” coordinate system; 4 rows × 14 cols).
 // This is for UI/debug labeling only, not for decoding semantics.
 static constexpr const char *kKeyLegend[kRows][kCols] = {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
@@ -7,6 +8,9 @@
 
 #include "esp_err.h"
 
+#include "cardputer_kb/key_latency.h"
+#include "cardputer_kb/keymask.h"
+
 namespace cardputer_kb {
 
 struct KeyPos {
@@ -16,18 +20,45 @@ struct KeyPos {
     bool operator==(const KeyPos &o) const { return x == o.x && y == o.y; }
 };
 
+// Vector form of a scan, kept for existing callers. New code should use scan_mask() + KeyMask,
+// which does not allocate.
 struct ScanSnapshot {
     bool use_alt_in01 = false;
-    std::vector<KeyPos> pressed;
-    std::vector<uint8_t> pressed_keynums;
+    std::vector<KeyPos> pressed;          // sorted by (y, x)
+    std::vector<uint8_t> pressed_keynums; // ascending
 };
 
+// Compatibility adapter: expands a mask into a snapshot (allocates).
+inline ScanSnapshot snapshot_from_mask(KeyMask down, bool use_alt_in01) {
+    ScanSnapshot snap;
+    snap.use_alt_in01 = use_alt_in01;
+    const int n = mask_count(down);
+    snap.pressed.reserve(n);
+    snap.pressed_keynums.reserve(n);
+    // Ascending keyNum is ascending (y, x), the order scan() has always returned.
+    for (KeyMask m = down & kAllKeysMask; m; m &= m - 1) {
+        const uint8_t kn = mask_first(m);
+        int x = -1;
+        int y = -1;
+        xy_from_keynum(kn, &x, &y);
+        snap.pressed.push_back(KeyPos{.x = x, .y = y});
+        snap.pressed_keynums.push_back(kn);
+    }
+    return snap;
+}
+
 // Matrix scanner for Cardputer keyboard.
 // Returns physical key positions and vendor-style keyNum values (1..56).
 class MatrixScanner {
   public:
     void init();
-    ScanSnapshot scan();
+    // One pass over scan_state 0..7; bit (keyNum - 1) set per pressed key. No heap use.
+    KeyMask scan_mask();
+    ScanSnapshot scan() {
+        const KeyMask down = scan_mask(); // may switch use_alt_in01_
+        return snapshot_from_mask(down, use_alt_in01_);
+    }
+    bool use_alt_in01() const { return use_alt_in01_; }
 
   private:
     bool use_alt_in01_ = false;
@@ -48,6 +79,18 @@ struct UnifiedScannerConfig {
     int int_gpio = 11;
     uint8_t tca8418_addr7 = 0x34;
     uint32_t i2c_hz = 400000;
+    // TCA8418: drain the FIFO only when INT (int_gpio, active low) is asserted, and let wait()
+    // return as soon as it is. Falls back to polling if false, int_gpio < 0 or the ISR cannot be
+    // installed.
+    bool use_int = true;
+};
+
+// One TCA8418 key event. t_us (esp_timer) is when the INT line fell, or in poll mode when the
+// previous drain started (the earliest the event can have landed unseen).
+struct TimedKeyEvent {
+    int64_t t_us;
+    uint8_t keynum; // 1..56
+    bool pressed;
 };
 
 // Unified scanner facade intended to become the single entrypoint for Cardputer keyboard scanning.
@@ -56,15 +99,34 @@ struct UnifiedScannerConfig {
 // - callers should not need to know if the keyboard is a GPIO-scanned matrix (Cardputer) or a TCA8418
 //   keypad controller over I2C (Cardputer-ADV).
 //
-// Implementation status:
-// - GPIO matrix backend is implemented (wraps MatrixScanner)
-// - TCA8418 backend + runtime auto-detect will be added next
+// Backends:
+// - GPIO matrix (wraps MatrixScanner)
+// - TCA8418, interrupt-driven when INT is wired (see UnifiedScannerConfig::use_int), else polled
 class UnifiedScanner {
   public:
     ~UnifiedScanner();
     esp_err_t init(const UnifiedScannerConfig &cfg = {});
+    // Allocation-free scan. Pair with KeyEdgeTracker for press/release edges.
+    KeyMask scan_mask();
+    // Compatibility adapter over scan_mask().
     ScanSnapshot scan();
     ScannerBackend backend() const { return backend_; }
+    // CPU cycles spent in the last scan_mask() call (GPIO: includes the 8 settle delays;
+    // TCA8418: the I2C FIFO drain).
+    uint32_t last_scan_cycles() const { return last_scan_cycles_; }
+
+    // Sleeps until the next scan is due: up to timeout_ms, or (TCA8418 with INT) until the
+    // keypad interrupts. Returns true if woken by the interrupt. Use in place of vTaskDelay()
+    // in the scan loop.
+    bool wait(uint32_t timeout_ms);
+    bool interrupt_driven() const;
+
+    // Events applied by the last scan_mask() (TCA8418 only; the GPIO matrix has no events).
+    // Valid until the next scan_mask().
+    const TimedKeyEvent *last_events(size_t *out_count) const;
+    // Latency of each event from its timestamp to scan_mask() returning it (TCA8418 only).
+    const KeyLatencyHistogram &latency() const { return latency_; }
+    void reset_latency() { latency_ = KeyLatencyHistogram{}; }
 
   private:
     struct TcaState;
@@ -75,6 +137,8 @@ class UnifiedScanner {
     std::unique_ptr<TcaState, TcaDeleter> tca_{};
     ScannerBackend backend_ = ScannerBackend::Auto;
     bool inited_ = false;
+    uint32_t last_scan_cycles_ = 0;
+    KeyLatencyHistogram latency_{};
 };
 
 } // namespace cardputer_kb
@@ -1,12 +1,10 @@
 #include "cardputer_kb/scanner.h"
 
-#include <algorithm>
-
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_rom_sys.h"
-
-#include "cardputer_kb/layout.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
 
 static const char *TAG = "cardputer_kb";
 
@@ -14,20 +12,37 @@ static constexpr int kOutPins[3] = {8, 9, 11};
 static constexpr int kInPinsPrimary[7] = {13, 15, 3, 4, 5, 6, 7};
 static constexpr int kInPinsAltIn01[7] = {1, 2, 3, 4, 5, 6, 7};
 
+// All keyboard pins are below GPIO32, so the scan loop drives and samples them through the
+// GPIO_OUT/GPIO_IN registers directly instead of one gpio_set_level/gpio_get_level call per pin.
+static constexpr bool pins_below_32(const int *pins, int n) {
+    for (int i = 0; i < n; i++) {
+        if (pins[i] < 0 || pins[i] >= 32) return false;
+    }
+    return true;
+}
+static_assert(pins_below_32(kOutPins, 3), "outputs must be in GPIO_OUT_REG");
+static_assert(pins_below_32(kInPinsPrimary, 7) && pins_below_32(kInPinsAltIn01, 7), "inputs must be in GPIO_IN_REG");
+
+static constexpr uint32_t kOutPinsMask = (1u << kOutPins[0]) | (1u << kOutPins[1]) | (1u << kOutPins[2]);
+
 static inline void kb_set_output(uint8_t out_bits3) {
-    out_bits3 &= 0x07;
-    gpio_set_level((gpio_num_t)kOutPins[0], (out_bits3 & 0x01) ? 1 : 0);
-    gpio_set_level((gpio_num_t)kOutPins[1], (out_bits3 & 0x02) ? 1 : 0);
-    gpio_set_level((gpio_num_t)kOutPins[2], (out_bits3 & 0x04) ? 1 : 0);
+    uint32_t set = 0;
+    if (out_bits3 & 0x01) set |= 1u << kOutPins[0];
+    if (out_bits3 & 0x02) set |= 1u << kOutPins[1];
+    if (out_bits3 & 0x04) set |= 1u << kOutPins[2];
+    REG_WRITE(GPIO_OUT_W1TC_REG, kOutPinsMask & ~set);
+    REG_WRITE(GPIO_OUT_W1TS_REG, set);
+}
+
+static inline uint32_t kb_read_inputs() {
+    return REG_READ(GPIO_IN_REG);
 }
 
-static inline uint8_t kb_get_input_mask(const int pins[7]) {
+// Bit i set when pins[i] reads low (inputs are pulled up; a pressed key pulls low).
+static inline uint8_t kb_input_mask(uint32_t levels, const int pins[7]) {
     uint8_t mask = 0;
     for (int i = 0; i < 7; i++) {
-        int level = gpio_get_level((gpio_num_t)pins[i]);
-        if (level == 0) {
-            mask |= (uint8_t)(1U << i);
-        }
+        mask |= (uint8_t)(((~levels >> pins[i]) & 1u) << i);
     }
     return mask;
 }
@@ -55,65 +70,33 @@ void cardputer_kb::MatrixScanner::init() {
     kb_set_output(0);
 }
 
-cardputer_kb::ScanSnapshot cardputer_kb::MatrixScanner::scan() {
-    ScanSnapshot snap;
-    snap.use_alt_in01 = use_alt_in01_;
+cardputer_kb::KeyMask cardputer_kb::MatrixScanner::scan_mask() {
+    KeyMask down = 0;
 
     for (int scan_state = 0; scan_state < 8; scan_state++) {
         kb_set_output((uint8_t)scan_state);
         esp_rom_delay_us(10);
 
+        // One register read covers both pinsets.
+        const uint32_t in_levels = kb_read_inputs();
         uint8_t in_mask = 0;
         if (use_alt_in01_) {
-            in_mask = kb_get_input_mask(kInPinsAltIn01);
+            in_mask = kb_input_mask(in_levels, kInPinsAltIn01);
         } else {
-            in_mask = kb_get_input_mask(kInPinsPrimary);
+            in_mask = kb_input_mask(in_levels, kInPinsPrimary);
             if (in_mask == 0) {
-                uint8_t alt = kb_get_input_mask(kInPinsAltIn01);
+                uint8_t alt = kb_input_mask(in_levels, kInPinsAltIn01);
                 if (alt != 0) {
                     use_alt_in01_ = true;
-                    snap.use_alt_in01 = true;
                     in_mask = alt;
                     ESP_LOGW(TAG, "autodetect: switching IN0/IN1 to alt pins [1,2] (was [13,15])");
                 }
             }
         }
 
-        if (in_mask == 0) {
-            continue;
-        }
-
-        for (int j = 0; j < 7; j++) {
-            if ((in_mask & (1U << j)) == 0) {
-                continue;
-            }
-
-            int x = (scan_state > 3) ? (2 * j) : (2 * j + 1);
-            int y_base = (scan_state > 3) ? (scan_state - 4) : scan_state; // 0..3
-            int y = (-y_base) + 3;                                          // flip to match "picture"
-            if (x < 0 || x > 13 || y < 0 || y > 3) {
-                continue;
-            }
-            snap.pressed.push_back(KeyPos{.x = x, .y = y});
-        }
+        down |= matrix_state_mask(scan_state, in_mask);
     }
 
     kb_set_output(0);
-
-    std::sort(snap.pressed.begin(), snap.pressed.end(), [](const KeyPos &a, const KeyPos &b) {
-        if (a.y != b.y) return a.y < b.y;
-        return a.x < b.x;
-    });
-    snap.pressed.erase(std::unique(snap.pressed.begin(), snap.pressed.end()), snap.pressed.end());
-
-    snap.pressed_keynums.reserve(snap.pressed.size());
-    for (const auto &p : snap.pressed) {
-        uint8_t kn = keynum_from_xy(p.x, p.y);
-        if (kn != 0) {
-            snap.pressed_keynums.push_back(kn);
-        }
-    }
-
-    return snap;
+    return down;
 }
-
@@ -93,6 +93,15 @@ esp_err_t tca8418_begin(tca8418_t *dev) {
         }
     }
 
+    // tca8418_read_events() relies on the register address staying on KEY_EVENT_A.
+    uint8_t cfg = 0;
+    err = tca8418_read_reg8(dev, TCA8418_REG_CFG, &cfg);
+    if (err != ESP_OK) return err;
+    if (cfg & TCA8418_CFG_AI) {
+        err = tca8418_write_reg8(dev, TCA8418_REG_CFG, (uint8_t)(cfg & ~TCA8418_CFG_AI));
+        if (err != ESP_OK) return err;
+    }
+
     // Clear any pending events/interrupts and enable key-event + gpio interrupts.
     uint8_t flushed = 0;
     (void)tca8418_flush(dev, &flushed);
@@ -126,6 +135,32 @@ esp_err_t tca8418_get_event(const tca8418_t *dev, uint8_t *out_evt) {
     return tca8418_read_reg8(dev, TCA8418_REG_KEY_EVENT_A, out_evt);
 }
 
+esp_err_t tca8418_read_events(const tca8418_t *dev, uint8_t *out, uint8_t max, uint8_t *out_n) {
+    if (!dev || !out || !out_n) return ESP_ERR_INVALID_ARG;
+    *out_n = 0;
+    uint8_t count = 0;
+    esp_err_t err = tca8418_available(dev, &count);
+    if (err != ESP_OK) return err;
+    if (count > max) count = max;
+    if (count == 0) return ESP_OK;
+
+    const uint8_t reg = TCA8418_REG_KEY_EVENT_A;
+    err = i2c_master_write_read_device(dev->port, dev->addr7, &reg, 1, out, count, pdMS_TO_TICKS(50));
+    if (err != ESP_OK) return err;
+    *out_n = count;
+    return ESP_OK;
+}
+
+bool tca8418_decode_event(uint8_t evt, uint8_t *out_key, bool *out_pressed) {
+    const uint8_t key = (uint8_t)(evt & TCA8418_EVT_KEY_MASK);
+    if (key == 0 || key > TCA8418_KEYPAD_KEYS) {
+        return false;
+    }
+    if (out_key) *out_key = key;
+    if (out_pressed) *out_pressed = (evt & TCA8418_EVT_PRESSED) != 0;
+    return true;
+}
+
 esp_err_t tca8418_flush(const tca8418_t *dev, uint8_t *out_flushed) {
     if (!dev) return ESP_ERR_INVALID_ARG;
     uint8_t count = 0;
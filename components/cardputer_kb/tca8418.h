@@ -19,6 +19,7 @@ extern "C" {
 #define TCA8418_REG_INT_STAT 0x02
 #define TCA8418_REG_KEY_LCK_EC 0x03
 #define TCA8418_REG_KEY_EVENT_A 0x04
+#define TCA8418_REG_KEY_EVENT_J 0x0D
 
 #define TCA8418_REG_GPIO_INT_STAT_1 0x11
 #define TCA8418_REG_GPIO_INT_STAT_2 0x12
@@ -41,12 +42,20 @@ extern "C" {
 #define TCA8418_REG_GPIO_INT_LVL_3 0x28
 
 // CFG bits
+#define TCA8418_CFG_AI 0x80
 #define TCA8418_CFG_GPI_IEN 0x02
 #define TCA8418_CFG_KE_IEN 0x01
 
 // INT_STAT bits
 #define TCA8418_INTSTAT_K_INT 0x01
 
+// Key event FIFO (KEY_EVENT_A..J). Event byte: bit7 = pressed, bits6..0 = key number
+// (1..80 keypad: (row * 10) + col + 1; 97..114 GPI events).
+#define TCA8418_FIFO_DEPTH 10
+#define TCA8418_EVT_PRESSED 0x80
+#define TCA8418_EVT_KEY_MASK 0x7F
+#define TCA8418_KEYPAD_KEYS 80
+
 typedef struct {
     i2c_port_t port;
     uint8_t addr7;
@@ -64,6 +73,15 @@ esp_err_t tca8418_available(const tca8418_t *dev, uint8_t *out_count);
 esp_err_t tca8418_get_event(const tca8418_t *dev, uint8_t *out_evt);
 esp_err_t tca8418_flush(const tca8418_t *dev, uint8_t *out_flushed);
 
+// Drains up to `max` events in FIFO order with two I2C transactions: KEY_LCK_EC for the count,
+// then one `count`-byte read of KEY_EVENT_A. tca8418_begin() leaves CFG.AI clear, so the
+// register address does not advance and every byte pops the FIFO.
+esp_err_t tca8418_read_events(const tca8418_t *dev, uint8_t *out, uint8_t max, uint8_t *out_n);
+
+// Splits a KEY_EVENT byte. Returns false for an empty slot (0) and for GPI events; on true,
+// *out_key is the keypad key number (1..80).
+bool tca8418_decode_event(uint8_t evt, uint8_t *out_key, bool *out_pressed);
+
 esp_err_t tca8418_enable_interrupts(const tca8418_t *dev, bool enable);
 
 #ifdef __cplusplus
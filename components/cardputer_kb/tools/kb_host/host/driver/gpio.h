@@ -0,0 +1,21 @@
+#pragma once
+// Host shim: pin configuration is accepted and ignored; levels go to the fake matrix.
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+typedef enum { GPIO_MODE_INPUT = 1, GPIO_MODE_OUTPUT = 2 } gpio_mode_t;
+typedef enum { GPIO_PULLUP_ONLY, GPIO_PULLDOWN_ONLY, GPIO_PULLUP_PULLDOWN, GPIO_FLOATING } gpio_pull_mode_t;
+
+int fake_gpio_get_level(gpio_num_t pin);
+void fake_gpio_set_level(gpio_num_t pin, uint32_t level);
+
+static inline esp_err_t gpio_reset_pin(gpio_num_t) { return ESP_OK; }
+static inline esp_err_t gpio_set_direction(gpio_num_t, gpio_mode_t) { return ESP_OK; }
+static inline esp_err_t gpio_set_pull_mode(gpio_num_t, gpio_pull_mode_t) { return ESP_OK; }
+static inline esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+    fake_gpio_set_level(pin, level);
+    return ESP_OK;
+}
+static inline int gpio_get_level(gpio_num_t pin) { return fake_gpio_get_level(pin); }
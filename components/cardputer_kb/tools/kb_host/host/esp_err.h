@@ -0,0 +1,7 @@
+#pragma once
+// Host shim: just enough of esp_err.h for cardputer_kb/scanner.h.
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
@@ -0,0 +1,6 @@
+#pragma once
+// Host shim: the settle delay is not simulated.
+#include <stdint.h>
+static inline void esp_rom_delay_us(uint32_t us) {
+    (void)us;
+}
@@ -0,0 +1,9 @@
+#pragma once
+// Host shim: GPIO register access goes to the fake keyboard matrix in kb_host_test.cpp.
+#include <stdint.h>
+
+uint32_t fake_gpio_reg_read(uintptr_t reg);
+void fake_gpio_reg_write(uintptr_t reg, uint32_t v);
+
+#define REG_READ(reg) fake_gpio_reg_read((uintptr_t)(reg))
+#define REG_WRITE(reg, v) fake_gpio_reg_write((uintptr_t)(reg), (uint32_t)(v))
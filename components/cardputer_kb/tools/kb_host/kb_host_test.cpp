@@ -0,0 +1,546 @@
+/*
+ * Host test and benchmark for the cardputer_kb mask scanner (matrix_scanner.cpp,
+ * keymask.h, bindings.h).
+ *
+ * matrix_scanner.cpp is built against a fake keyboard matrix (host/ shims):
+ * GPIO_OUT writes select a scan_state, GPIO_IN reads pull an input low when a
+ * simulated key at that (scan_state, input) is down. The previous vector
+ * scanner (copied below, reading the same fake pins through gpio_get_level)
+ * is the reference for scan(), and the previous vector decode_best and edge
+ * diff are the reference for the mask versions. Prints JSONL.
+ *
+ * The benchmark times the per-poll CPU work of both paths from the same
+ * captured input masks (pin I/O excluded; on the device the 8 x 10us settle
+ * delays dominate a GPIO scan anyway), alternating held keys with an idle
+ * matrix so half the polls have edges. It reports ns, TSC cycles on x86 and
+ * heap allocations per poll, plus cycles for a full scan_mask() on the fake
+ * matrix, which must not allocate either.
+ *
+ * Built and run by tools/kb_host/run_kb_host.sh. Exits non-zero on failure.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define KB_HAVE_TSC 1
+#endif
+
+#include "cardputer_kb/bindings_m5cardputer_captured.h"
+#include "cardputer_kb/layout.h"
+#include "cardputer_kb/scanner.h"
+#include "driver/gpio.h"
+#include "soc/gpio_reg.h"
+
+using namespace cardputer_kb;
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+// ---- Allocation counter ----
+
+static size_t g_allocs;
+
+void *operator new(size_t n) {
+    g_allocs++;
+    void *p = malloc(n ? n : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+// ---- Fake keyboard matrix ----
+
+static constexpr int kOutPins[3] = {8, 9, 11};
+static constexpr int kInPinsPrimary[7] = {13, 15, 3, 4, 5, 6, 7};
+static constexpr int kInPinsAltIn01[7] = {1, 2, 3, 4, 5, 6, 7};
+
+static uint32_t g_out;       // output latch
+static bool g_down[57];      // simulated keys, by keyNum
+static bool g_wired_alt;     // board routes IN0/IN1 to GPIO1/2 instead of 13/15
+
+static int fake_scan_state() {
+    int s = 0;
+    for (int i = 0; i < 3; i++) {
+        if (g_out & (1u << kOutPins[i])) {
+            s |= 1 << i;
+        }
+    }
+    return s;
+}
+
+// Vendor wiring, as documented in matrix_scanner.cpp before the mask scanner.
+static bool fake_input_low(int scan_state, int j) {
+    const int x = (scan_state > 3) ? (2 * j) : (2 * j + 1);
+    const int y = 3 - (scan_state & 3);
+    return g_down[keynum_from_xy(x, y)];
+}
+
+static uint32_t fake_in_levels() {
+    uint32_t levels = 0xFFFFFFFFu; // pulled up
+    const int s = fake_scan_state();
+    const int *pins = g_wired_alt ? kInPinsAltIn01 : kInPinsPrimary;
+    for (int j = 0; j < 7; j++) {
+        if (fake_input_low(s, j)) {
+            levels &= ~(1u << pins[j]);
+        }
+    }
+    return levels;
+}
+
+uint32_t fake_gpio_reg_read(uintptr_t reg) {
+    return (reg == GPIO_IN_REG) ? fake_in_levels() : 0;
+}
+
+void fake_gpio_reg_write(uintptr_t reg, uint32_t v) {
+    if (reg == GPIO_OUT_W1TS_REG) {
+        g_out |= v;
+    } else if (reg == GPIO_OUT_W1TC_REG) {
+        g_out &= ~v;
+    }
+}
+
+int fake_gpio_get_level(gpio_num_t pin) {
+    return (int)((fake_in_levels() >> pin) & 1u);
+}
+
+void fake_gpio_set_level(gpio_num_t pin, uint32_t level) {
+    if (level) {
+        g_out |= 1u << pin;
+    } else {
+        g_out &= ~(1u << pin);
+    }
+}
+
+static void press_only(const std::vector<uint8_t> &keynums) {
+    for (bool &d : g_down) {
+        d = false;
+    }
+    for (uint8_t kn : keynums) {
+        g_down[kn] = true;
+    }
+}
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static std::vector<uint8_t> random_keys(int max_keys) {
+    std::vector<uint8_t> keys;
+    const int n = (int)(rng() % (uint32_t)(max_keys + 1));
+    for (int i = 0; i < n; i++) {
+        keys.push_back((uint8_t)(1 + rng() % 56));
+    }
+    return keys;
+}
+
+// ---- Reference: vector scanner and decoder before the mask scanner ----
+
+struct RefScanner {
+    bool use_alt_in01 = false;
+
+    static uint8_t get_input_mask(const int pins[7]) {
+        uint8_t mask = 0;
+        for (int i = 0; i < 7; i++) {
+            if (gpio_get_level((gpio_num_t)pins[i]) == 0) {
+                mask |= (uint8_t)(1U << i);
+            }
+        }
+        return mask;
+    }
+
+    static void set_output(uint8_t out_bits3) {
+        gpio_set_level((gpio_num_t)kOutPins[0], (out_bits3 & 0x01) ? 1 : 0);
+        gpio_set_level((gpio_num_t)kOutPins[1], (out_bits3 & 0x02) ? 1 : 0);
+        gpio_set_level((gpio_num_t)kOutPins[2], (out_bits3 & 0x04) ? 1 : 0);
+    }
+
+    ScanSnapshot scan() {
+        ScanSnapshot snap;
+        snap.use_alt_in01 = use_alt_in01;
+        for (int scan_state = 0; scan_state < 8; scan_state++) {
+            set_output((uint8_t)scan_state);
+            uint8_t in_mask = 0;
+            if (use_alt_in01) {
+                in_mask = get_input_mask(kInPinsAltIn01);
+            } else {
+                in_mask = get_input_mask(kInPinsPrimary);
+                if (in_mask == 0) {
+                    uint8_t alt = get_input_mask(kInPinsAltIn01);
+                    if (alt != 0) {
+                        use_alt_in01 = true;
+                        snap.use_alt_in01 = true;
+                        in_mask = alt;
+                    }
+                }
+            }
+            if (in_mask == 0) {
+                continue;
+            }
+            for (int j = 0; j < 7; j++) {
+                if ((in_mask & (1U << j)) == 0) {
+                    continue;
+                }
+                int x = (scan_state > 3) ? (2 * j) : (2 * j + 1);
+                int y_base = (scan_state > 3) ? (scan_state - 4) : scan_state;
+                int y = (-y_base) + 3;
+                snap.pressed.push_back(KeyPos{.x = x, .y = y});
+            }
+        }
+        set_output(0);
+        std::sort(snap.pressed.begin(), snap.pressed.end(), [](const KeyPos &a, const KeyPos &b) {
+            if (a.y != b.y) return a.y < b.y;
+            return a.x < b.x;
+        });
+        snap.pressed.erase(std::unique(snap.pressed.begin(), snap.pressed.end()), snap.pressed.end());
+        snap.pressed_keynums.reserve(snap.pressed.size());
+        for (const auto &p : snap.pressed) {
+            uint8_t kn = keynum_from_xy(p.x, p.y);
+            if (kn != 0) {
+                snap.pressed_keynums.push_back(kn);
+            }
+        }
+        return snap;
+    }
+};
+
+static bool ref_contains(const std::vector<uint8_t> &v, uint8_t kn) {
+    return std::find(v.begin(), v.end(), kn) != v.end();
+}
+
+static const Binding *ref_decode_best(const std::vector<uint8_t> &pressed, const Binding *bindings, size_t count) {
+    const Binding *best = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        const Binding &b = bindings[i];
+        bool all = true;
+        for (uint8_t k = 0; k < b.n && all; k++) {
+            all = ref_contains(pressed, b.keynums[k]);
+        }
+        if (all && (best == nullptr || b.n > best->n)) {
+            best = &b;
+        }
+    }
+    return best;
+}
+
+static bool same_snapshot(const ScanSnapshot &a, const ScanSnapshot &b) {
+    return a.use_alt_in01 == b.use_alt_in01 && a.pressed == b.pressed && a.pressed_keynums == b.pressed_keynums;
+}
+
+static KeyMask mask_of(const std::vector<uint8_t> &keynums) {
+    return mask_from_keynums(keynums.data(), keynums.size());
+}
+
+// ---- Tests ----
+
+static void test_matrix_state_mask() {
+    // Every (scan_state, input) selects exactly the key the vendor formula names.
+    KeyMask all = 0;
+    for (int s = 0; s < 8; s++) {
+        for (int j = 0; j < 7; j++) {
+            const int x = (s > 3) ? (2 * j) : (2 * j + 1);
+            const int y = 3 - (s & 3);
+            const KeyMask m = matrix_state_mask(s, (uint8_t)(1u << j));
+            CHECK(m == key_bit(keynum_from_xy(x, y)));
+            CHECK((all & m) == 0);
+            all |= m;
+        }
+        CHECK(matrix_state_mask(s, 0) == 0);
+    }
+    CHECK(all == kAllKeysMask);
+    printf("{\"test\":\"matrix_state_mask\",\"keys\":%d}\n", mask_count(all));
+}
+
+static void test_scan_matches_reference() {
+    int cases = 0;
+    for (int wired_alt = 0; wired_alt < 2; wired_alt++) {
+        g_wired_alt = wired_alt != 0;
+        MatrixScanner scanner;
+        scanner.init();
+        RefScanner ref;
+
+        std::vector<std::vector<uint8_t>> sets;
+        sets.push_back({});
+        for (uint8_t kn = 1; kn <= 56; kn++) {
+            sets.push_back({kn});
+        }
+        std::vector<uint8_t> every;
+        for (uint8_t kn = 1; kn <= 56; kn++) {
+            every.push_back(kn);
+        }
+        sets.push_back(every);
+        for (int i = 0; i < 4000; i++) {
+            sets.push_back(random_keys(8));
+        }
+
+        for (const auto &keys : sets) {
+            press_only(keys);
+            const ScanSnapshot want = ref.scan();
+            const KeyMask down = scanner.scan_mask();
+            CHECK(down == mask_of(keys));
+            CHECK(scanner.use_alt_in01() == ref.use_alt_in01);
+            CHECK(same_snapshot(snapshot_from_mask(down, scanner.use_alt_in01()), want));
+            CHECK((g_out & ((1u << 8) | (1u << 9) | (1u << 11))) == 0); // outputs left low
+            cases++;
+        }
+
+        // The compatibility scan() goes through the same path.
+        press_only({29, 40, 56});
+        CHECK(same_snapshot(scanner.scan(), ref.scan()));
+        CHECK(scanner.use_alt_in01() == g_wired_alt);
+    }
+    g_wired_alt = false;
+    printf("{\"test\":\"scan_matches_reference\",\"cases\":%d,\"identical\":true}\n", cases);
+}
+
+static void test_edges() {
+    KeyEdgeTracker tracker;
+    std::vector<uint8_t> prev;
+    int presses = 0;
+    int releases = 0;
+    for (int i = 0; i < 5000; i++) {
+        std::vector<uint8_t> cur = (rng() & 1) ? prev : random_keys(6);
+        if (rng() & 1) {
+            cur.push_back((uint8_t)(1 + rng() % 56));
+        }
+        const KeyEdges e = tracker.update(mask_of(cur));
+        CHECK(e.down == mask_of(cur));
+        for (uint8_t kn = 1; kn <= 56; kn++) {
+            const bool was = ref_contains(prev, kn);
+            const bool is = ref_contains(cur, kn);
+            CHECK(mask_has(e.pressed, kn) == (is && !was));
+            CHECK(mask_has(e.released, kn) == (was && !is));
+            presses += (is && !was) ? 1 : 0;
+            releases += (was && !is) ? 1 : 0;
+        }
+        prev = cur;
+    }
+    printf("{\"test\":\"edges\",\"presses\":%d,\"releases\":%d}\n", presses, releases);
+}
+
+static void test_bindings() {
+    static constexpr size_t kCaptured = sizeof(kCapturedBindingsM5Cardputer) / sizeof(kCapturedBindingsM5Cardputer[0]);
+    static_assert(kCapturedBindingsM5CardputerMasks.size() == kCaptured, "one mask per binding");
+    static_assert(kCapturedBindingsM5CardputerMasks[0].mask == (key_bit(29) | key_bit(40)), "compiled at build time");
+
+    // Random tables, including duplicate keys, n == 0 and keyNums outside 1..56.
+    std::vector<Binding> random_table;
+    for (int i = 0; i < 24; i++) {
+        Binding b{};
+        b.action = (Action)(rng() % 9);
+        b.n = (uint8_t)(rng() % 5);
+        for (int k = 0; k < 4; k++) {
+            b.keynums[k] = (rng() % 16 == 0) ? (uint8_t)(rng() % 70) : (uint8_t)(1 + rng() % 12);
+        }
+        random_table.push_back(b);
+    }
+    std::vector<MaskBinding> random_masks;
+    for (const Binding &b : random_table) {
+        random_masks.push_back(MaskBinding{binding_mask(b), b.action, b.n});
+    }
+
+    int matched = 0;
+    for (int i = 0; i < 20000; i++) {
+        std::vector<uint8_t> keys = random_keys(5);
+        if (rng() & 1) {
+            keys.push_back(29); // fn chords
+        }
+        const KeyMask down = mask_of(keys);
+
+        const Binding *want = ref_decode_best(keys, kCapturedBindingsM5Cardputer, kCaptured);
+        const MaskBinding *got = decode_best(down, kCapturedBindingsM5CardputerMasks);
+        CHECK((want == nullptr) == (got == nullptr));
+        if (want) {
+            CHECK(got - kCapturedBindingsM5CardputerMasks.data() == want - kCapturedBindingsM5Cardputer);
+            matched++;
+        }
+        CHECK(decode_best(down, kCapturedBindingsM5Cardputer, kCaptured) == want);
+        CHECK(decode_best(keys, kCapturedBindingsM5Cardputer, kCaptured) == want);
+
+        const Binding *want_r = ref_decode_best(keys, random_table.data(), random_table.size());
+        const MaskBinding *got_r = decode_best(down, random_masks.data(), random_masks.size());
+        CHECK((want_r == nullptr) == (got_r == nullptr));
+        if (want_r) {
+            CHECK(got_r - random_masks.data() == want_r - random_table.data());
+        }
+        for (const Binding &b : random_table) {
+            const bool ref_all = [&] {
+                for (uint8_t k = 0; k < b.n; k++) {
+                    if (!ref_contains(keys, b.keynums[k])) return false;
+                }
+                return true;
+            }();
+            CHECK(pressed_contains_all(keys, b) == ref_all);
+        }
+    }
+    printf("{\"test\":\"bindings\",\"cases\":20000,\"captured_matches\":%d}\n", matched);
+}
+
+// ---- Benchmark ----
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t cycles() {
+#ifdef KB_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct BenchResult {
+    double ns;
+    double cycles;
+    double allocs;
+};
+
+// One poll as a consumer did it: scan, decode, diff against the previous keys.
+template <typename Fn>
+static BenchResult bench(Fn &&poll, int iters) {
+    for (int i = 0; i < iters / 10; i++) {
+        poll();
+    }
+    const size_t a0 = g_allocs;
+    const uint64_t c0 = cycles();
+    const double t0 = now_ns();
+    for (int i = 0; i < iters; i++) {
+        poll();
+    }
+    const double t1 = now_ns();
+    const uint64_t c1 = cycles();
+    return BenchResult{(t1 - t0) / iters, (double)(c1 - c0) / iters, (double)(g_allocs - a0) / iters};
+}
+
+// Vector path from before the mask scanner, minus the pin I/O: expand the input masks, sort/dedupe,
+// derive keyNums, decode bindings and diff against the previous poll.
+static uint32_t old_process(const uint8_t in_masks[8], std::vector<uint8_t> &prev) {
+    static constexpr size_t kCaptured = sizeof(kCapturedBindingsM5Cardputer) / sizeof(kCapturedBindingsM5Cardputer[0]);
+    ScanSnapshot snap;
+    for (int scan_state = 0; scan_state < 8; scan_state++) {
+        const uint8_t in_mask = in_masks[scan_state];
+        if (in_mask == 0) {
+            continue;
+        }
+        for (int j = 0; j < 7; j++) {
+            if ((in_mask & (1U << j)) == 0) {
+                continue;
+            }
+            int x = (scan_state > 3) ? (2 * j) : (2 * j + 1);
+            int y = 3 - ((scan_state > 3) ? (scan_state - 4) : scan_state);
+            snap.pressed.push_back(KeyPos{.x = x, .y = y});
+        }
+    }
+    std::sort(snap.pressed.begin(), snap.pressed.end(), [](const KeyPos &a, const KeyPos &b) {
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+    snap.pressed.erase(std::unique(snap.pressed.begin(), snap.pressed.end()), snap.pressed.end());
+    for (const auto &p : snap.pressed) {
+        snap.pressed_keynums.push_back(keynum_from_xy(p.x, p.y));
+    }
+    const Binding *b = ref_decode_best(snap.pressed_keynums, kCapturedBindingsM5Cardputer, kCaptured);
+    uint32_t fresh = 0;
+    for (uint8_t kn : snap.pressed_keynums) {
+        fresh += ref_contains(prev, kn) ? 0 : 1;
+    }
+    prev = snap.pressed_keynums;
+    return fresh + (b ? (uint32_t)b->action : 0);
+}
+
+static uint32_t new_process(const uint8_t in_masks[8], KeyEdgeTracker &tracker) {
+    KeyMask down = 0;
+    for (int scan_state = 0; scan_state < 8; scan_state++) {
+        down |= matrix_state_mask(scan_state, in_masks[scan_state]);
+    }
+    const KeyEdges e = tracker.update(down);
+    const MaskBinding *b = decode_best(e.down, kCapturedBindingsM5CardputerMasks);
+    return (uint32_t)mask_count(e.pressed) + (b ? (uint32_t)b->action : 0);
+}
+
+static void run_bench(const char *name, const std::vector<uint8_t> &keys, int iters) {
+    press_only(keys);
+
+    // Input masks as the matrix presents them, per scan_state.
+    uint8_t in_masks[8];
+    for (int s = 0; s < 8; s++) {
+        in_masks[s] = 0;
+        for (int j = 0; j < 7; j++) {
+            in_masks[s] |= fake_input_low(s, j) ? (uint8_t)(1u << j) : 0;
+        }
+    }
+    // Alternate with an empty matrix so every other poll has edges.
+    static const uint8_t kIdle[8] = {0};
+
+    volatile uint32_t sink = 0;
+    std::vector<uint8_t> prev;
+    int phase = 0;
+    const BenchResult old_r = bench([&] { sink = sink + old_process((phase++ & 1) ? kIdle : in_masks, prev); }, iters);
+    KeyEdgeTracker tracker;
+    phase = 0;
+    const BenchResult new_r = bench([&] { sink = sink + new_process((phase++ & 1) ? kIdle : in_masks, tracker); }, iters);
+
+    // The whole device path, fake pin I/O included, must not allocate either.
+    MatrixScanner scanner;
+    scanner.init();
+    const BenchResult scan_r = bench([&] { sink = sink + (uint32_t)tracker.update(scanner.scan_mask()).pressed; }, iters / 10);
+
+    CHECK(new_r.allocs == 0.0);
+    CHECK(scan_r.allocs == 0.0);
+    printf("{\"bench\":\"poll\",\"keys\":\"%s\",\"held\":%zu,\"old_ns\":%.1f,\"new_ns\":%.1f,\"speedup\":%.2f,"
+           "\"old_cycles\":%.0f,\"new_cycles\":%.0f,\"old_allocs\":%.1f,\"new_allocs\":%.1f,"
+           "\"scan_mask_cycles\":%.0f}\n",
+           name, keys.size(), old_r.ns, new_r.ns, old_r.ns / new_r.ns, old_r.cycles, new_r.cycles, old_r.allocs,
+           new_r.allocs, scan_r.cycles);
+}
+
+int main(void) {
+    test_matrix_state_mask();
+    test_scan_matches_reference();
+    test_edges();
+    test_bindings();
+
+    const int iters = 200000;
+    run_bench("idle", {}, iters);
+    run_bench("one", {20}, iters);
+    run_bench("fn_chord", {29, 40}, iters);
+    run_bench("six", {3, 17, 29, 30, 44, 56}, iters);
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
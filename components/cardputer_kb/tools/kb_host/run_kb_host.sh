@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the cardputer_kb mask scanner host test and benchmark.
+#
+# matrix_scanner.cpp builds against the shims in host/, which route the GPIO
+# register accesses to a fake keyboard matrix in kb_host_test.cpp. Prints JSONL.
+#
+# Usage:
+#   ./tools/kb_host/run_kb_host.sh
+#   SANITIZE= ./tools/kb_host/run_kb_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+COMP_DIR="${HERE}/../.."
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/cardputer-kb-host}"
+CXX="${CXX:-c++}"
+CFLAGS="${CFLAGS:--std=gnu++20 -O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} -I"${HERE}/host" -I"${COMP_DIR}/include" \
+  -o "${BUILD_DIR}/kb_host_test" \
+  "${HERE}/kb_host_test.cpp" "${COMP_DIR}/matrix_scanner.cpp"
+"${BUILD_DIR}/kb_host_test"
@@ -0,0 +1,34 @@
+#pragma once
+// Host shim: legacy I2C master API, answered by the fake TCA8418 in tca_host_test.cpp.
+#include <stddef.h>
+#include <stdint.h>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+typedef int i2c_port_t;
+typedef enum { I2C_MODE_SLAVE = 0, I2C_MODE_MASTER = 1 } i2c_mode_t;
+
+typedef struct {
+    i2c_mode_t mode;
+    int sda_io_num;
+    int scl_io_num;
+    int sda_pullup_en;
+    int scl_pullup_en;
+    struct {
+        uint32_t clk_speed;
+    } master;
+} i2c_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+esp_err_t i2c_param_config(i2c_port_t port, const i2c_config_t *cfg);
+esp_err_t i2c_driver_install(i2c_port_t port, i2c_mode_t mode, size_t rx, size_t tx, int flags);
+esp_err_t i2c_master_write_to_device(i2c_port_t port, uint8_t addr, const uint8_t *buf, size_t len,
+                                     uint32_t ticks);
+esp_err_t i2c_master_write_read_device(i2c_port_t port, uint8_t addr, const uint8_t *wbuf, size_t wlen,
+                                       uint8_t *rbuf, size_t rlen, uint32_t ticks);
+#ifdef __cplusplus
+}
+#endif
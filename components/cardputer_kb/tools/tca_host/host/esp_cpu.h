@@ -0,0 +1,6 @@
+#pragma once
+// Host shim: no cycle counter.
+#include <stdint.h>
+static inline uint32_t esp_cpu_get_cycle_count(void) {
+    return 0;
+}
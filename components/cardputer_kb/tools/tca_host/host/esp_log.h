@@ -0,0 +1,21 @@
+#pragma once
+// Host shim: E/W/I go to stderr; D is handed to the test, which parses the capture lines.
+#include <stdio.h>
+
+#define ESP_LOG_DEBUG 4
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL ESP_LOG_DEBUG
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void host_log_debug(const char *tag, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+#ifdef __cplusplus
+}
+#endif
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) host_log_debug(tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,10 @@
+#pragma once
+// Host shim: simulated time, set by the test.
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+int64_t esp_timer_get_time(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+// Host shim: a binary semaphore is a flag; Take never blocks (the test drives time).
+#include "freertos/FreeRTOS.h"
+
+struct HostSemaphore {
+    int given;
+};
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return new HostSemaphore{0};
+}
+static inline void vSemaphoreDelete(SemaphoreHandle_t s) {
+    delete s;
+}
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t) {
+    const int g = s->given;
+    s->given = 0;
+    return g ? pdTRUE : pdFALSE;
+}
+static inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t *woken) {
+    s->given = 1;
+    if (woken) *woken = pdTRUE;
+    return pdTRUE;
+}
@@ -0,0 +1,6 @@
+#pragma once
+// Host shim: delays are not simulated.
+#include "freertos/FreeRTOS.h"
+static inline void vTaskDelay(TickType_t ticks) {
+    (void)ticks;
+}
@@ -0,0 +1,5 @@
+#pragma once
+// Host shim: register addresses as on ESP32-S3.
+#define GPIO_OUT_W1TS_REG 0x60004008u
+#define GPIO_OUT_W1TC_REG 0x6000400Cu
+#define GPIO_IN_REG 0x6000403Cu
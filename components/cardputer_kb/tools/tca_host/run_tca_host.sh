@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the cardputer_kb TCA8418 host test (event decode, FIFO burst
+# reads, INT-driven UnifiedScanner) against the register dumps in dumps/.
+#
+# tca8418.c and unified_scanner.cpp build against the shims in host/, which
+# route I2C and the INT pin to a fake TCA8418 in tca_host_test.cpp. Prints JSONL.
+#
+# Usage:
+#   ./tools/tca_host/run_tca_host.sh
+#   ./tools/tca_host/run_tca_host.sh path/to/dumps
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+COMP_DIR="${HERE}/../.."
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/cardputer-kb-tca-host}"
+CC="${CC:-cc}"
+CXX="${CXX:-c++}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+DUMPS="${1:-${HERE}/dumps}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CC}" ${CFLAGS} ${SANITIZE} -std=gnu11 -I"${HERE}/host" -c -o "${BUILD_DIR}/tca8418.o" "${COMP_DIR}/tca8418.c"
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} -std=gnu++20 -I"${HERE}/host" -I"${COMP_DIR}/include" -I"${COMP_DIR}" \
+  -o "${BUILD_DIR}/tca_host_test" \
+  "${HERE}/tca_host_test.cpp" "${COMP_DIR}/unified_scanner.cpp" "${COMP_DIR}/matrix_scanner.cpp" \
+  "${BUILD_DIR}/tca8418.o"
+"${BUILD_DIR}/tca_host_test" "${DUMPS}"
@@ -0,0 +1,558 @@
+/*
+ * Host test for the TCA8418 path of cardputer_kb (tca8418.c, unified_scanner.cpp).
+ *
+ * tca8418.c and unified_scanner.cpp are built against the shims in host/: the
+ * legacy I2C calls go to a fake TCA8418 register file below (10-byte key
+ * event FIFO, KEY_LCK_EC count, INT_STAT with write-1-to-clear, CFG.AI
+ * address auto-increment), and the INT pin and its GPIO ISR are simulated.
+ *
+ * Register dumps (one .txt per capture in dumps/) are replayed through UnifiedScanner, with the
+ * INT interrupt and in poll mode:
+ *
+ *   irq <t_us> : 0x.. 0x..   KEY_EVENT bytes in the FIFO when INT fell, oldest first
+ *   down <keyNum>... | -     keys down after the scanner drains them
+ *
+ * The irq lines are the format UnifiedScanner logs at debug level for every
+ * drain, so device captures can be added as is; the debug lines logged while
+ * replaying are parsed back and must match. The dump also checks event
+ * timestamps, the latency histogram, and I2C traffic against the previous
+ * per-event drain. Prints JSONL.
+ *
+ * Built and run by tools/tca_host/run_tca_host.sh. Exits non-zero on failure.
+ */
+#include <dirent.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "cardputer_kb/key_latency.h"
+#include "cardputer_kb/layout.h"
+#include "cardputer_kb/scanner.h"
+#include "driver/gpio.h"
+#include "driver/i2c.h"
+#include "esp_timer.h"
+#include "tca8418.h"
+
+using namespace cardputer_kb;
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+// ---- Simulated time and debug log ----
+
+static int64_t g_now_us;
+static std::vector<std::string> g_debug_lines;
+
+extern "C" int64_t esp_timer_get_time(void) {
+    return g_now_us;
+}
+
+extern "C" const char *esp_err_to_name(esp_err_t err) {
+    return err == ESP_OK ? "ESP_OK" : "ESP_ERR";
+}
+
+extern "C" void host_log_debug(const char *tag, const char *fmt, ...) {
+    (void)tag;
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    g_debug_lines.push_back(buf);
+}
+
+// ---- Fake TCA8418 ----
+
+static constexpr int kIntGpio = 11;
+static constexpr uint8_t kAddr = 0x34;
+
+struct FakeTca {
+    uint8_t regs[0x30] = {};
+    std::deque<uint8_t> fifo;
+    bool int_stuck = false; // INT held low regardless of INT_STAT (wiring fault)
+
+    uint32_t txns = 0;
+    uint32_t bus_bytes = 0; // address + register + data bytes on the wire
+
+    bool int_low() const { return int_stuck || (regs[TCA8418_REG_INT_STAT] & 0x03) != 0; }
+
+    void push(uint8_t evt) {
+        if (fifo.size() < TCA8418_FIFO_DEPTH) {
+            fifo.push_back(evt);
+        }
+        regs[TCA8418_REG_INT_STAT] |= TCA8418_INTSTAT_K_INT;
+    }
+
+    uint8_t read(uint8_t reg) {
+        if (reg == TCA8418_REG_KEY_EVENT_A) {
+            if (fifo.empty()) {
+                return 0;
+            }
+            const uint8_t e = fifo.front();
+            fifo.pop_front();
+            return e;
+        }
+        if (reg > TCA8418_REG_KEY_EVENT_A && reg <= TCA8418_REG_KEY_EVENT_J) {
+            const size_t i = (size_t)(reg - TCA8418_REG_KEY_EVENT_A);
+            return i < fifo.size() ? fifo[i] : 0;
+        }
+        if (reg == TCA8418_REG_KEY_LCK_EC) {
+            return (uint8_t)fifo.size();
+        }
+        return reg < sizeof(regs) ? regs[reg] : 0;
+    }
+
+    void write(uint8_t reg, uint8_t v) {
+        if (reg == TCA8418_REG_INT_STAT) {
+            regs[reg] &= (uint8_t)~v;
+        } else if (reg < sizeof(regs)) {
+            regs[reg] = v;
+        }
+    }
+
+    uint8_t next_reg(uint8_t reg) const { return (regs[TCA8418_REG_CFG] & TCA8418_CFG_AI) ? (uint8_t)(reg + 1) : reg; }
+};
+
+static FakeTca g_tca;
+
+// ---- Simulated INT pin + GPIO ISR ----
+
+static gpio_isr_t g_isr;
+static void *g_isr_arg;
+static bool g_intr_enabled;
+static uint32_t g_isr_calls;
+
+// Level-triggered: fires while the line is low and the interrupt is unmasked.
+static void service_int() {
+    for (int guard = 0; guard < 4 && g_isr && g_intr_enabled && g_tca.int_low(); guard++) {
+        g_isr_calls++;
+        g_isr(g_isr_arg);
+    }
+}
+
+extern "C" esp_err_t gpio_config(const gpio_config_t *cfg) {
+    return (cfg && cfg->pin_bit_mask == (1ULL << kIntGpio) && cfg->intr_type == GPIO_INTR_LOW_LEVEL) ? ESP_OK
+                                                                                                    : ESP_ERR_INVALID_ARG;
+}
+extern "C" esp_err_t gpio_install_isr_service(int) {
+    return ESP_ERR_INVALID_STATE; // as if another driver installed it first
+}
+extern "C" esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t isr, void *arg) {
+    if (pin != kIntGpio) return ESP_ERR_INVALID_ARG;
+    g_isr = isr;
+    g_isr_arg = arg;
+    g_intr_enabled = true;
+    service_int();
+    return ESP_OK;
+}
+extern "C" esp_err_t gpio_isr_handler_remove(gpio_num_t) {
+    g_isr = nullptr;
+    g_isr_arg = nullptr;
+    return ESP_OK;
+}
+extern "C" esp_err_t gpio_intr_enable(gpio_num_t) {
+    g_intr_enabled = true;
+    service_int();
+    return ESP_OK;
+}
+extern "C" esp_err_t gpio_intr_disable(gpio_num_t) {
+    g_intr_enabled = false;
+    return ESP_OK;
+}
+extern "C" esp_err_t gpio_reset_pin(gpio_num_t) { return ESP_OK; }
+extern "C" esp_err_t gpio_set_direction(gpio_num_t, gpio_mode_t) { return ESP_OK; }
+extern "C" esp_err_t gpio_set_pull_mode(gpio_num_t, gpio_pull_mode_t) { return ESP_OK; }
+extern "C" esp_err_t gpio_set_level(gpio_num_t, uint32_t) { return ESP_OK; }
+extern "C" int gpio_get_level(gpio_num_t pin) {
+    return (pin == kIntGpio && g_tca.int_low()) ? 0 : 1;
+}
+
+// ---- Fake I2C bus ----
+
+extern "C" esp_err_t i2c_param_config(i2c_port_t, const i2c_config_t *) { return ESP_OK; }
+extern "C" esp_err_t i2c_driver_install(i2c_port_t, i2c_mode_t, size_t, size_t, int) { return ESP_OK; }
+
+extern "C" esp_err_t i2c_master_write_to_device(i2c_port_t, uint8_t addr, const uint8_t *buf, size_t len, uint32_t) {
+    if (addr != kAddr || len < 1) return ESP_FAIL;
+    g_tca.txns++;
+    g_tca.bus_bytes += (uint32_t)(1 + len);
+    uint8_t reg = buf[0];
+    for (size_t i = 1; i < len; i++) {
+        g_tca.write(reg, buf[i]);
+        reg = g_tca.next_reg(reg);
+    }
+    return ESP_OK;
+}
+
+extern "C" esp_err_t i2c_master_write_read_device(i2c_port_t, uint8_t addr, const uint8_t *wbuf, size_t wlen,
+                                                  uint8_t *rbuf, size_t rlen, uint32_t) {
+    if (addr != kAddr || wlen != 1) return ESP_FAIL;
+    g_tca.txns++;
+    g_tca.bus_bytes += (uint32_t)(1 + wlen + 1 + rlen); // addr+W, reg, addr+R (repeated start), data
+    uint8_t reg = wbuf[0];
+    for (size_t i = 0; i < rlen; i++) {
+        rbuf[i] = g_tca.read(reg);
+        reg = g_tca.next_reg(reg);
+    }
+    return ESP_OK;
+}
+
+// ---- Reference: event decode and drain before the interrupt path ----
+
+static uint8_t ref_decode_keynum(uint8_t evt_raw, bool *pressed) {
+    if (evt_raw == 0) return 0;
+    *pressed = (evt_raw & 0x80) != 0;
+    uint8_t keynum = (uint8_t)(evt_raw & 0x7F);
+    if (keynum == 0) return 0;
+    keynum--;
+    const uint8_t row = (uint8_t)(keynum / 10);
+    const uint8_t col = (uint8_t)(keynum % 10);
+    const uint8_t x = (uint8_t)(row * 2 + ((col > 3) ? 1 : 0));
+    const uint8_t y = (uint8_t)((col + 4) % 4);
+    if (x >= kCols || y >= kRows) return 0;
+    return keynum_from_xy(x, y);
+}
+
+static void ref_drain(const tca8418_t *tca) {
+    for (;;) {
+        uint8_t count = 0;
+        if (tca8418_available(tca, &count) != ESP_OK || count == 0) break;
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t evt = 0;
+            if (tca8418_get_event(tca, &evt) != ESP_OK || evt == 0) break;
+        }
+    }
+    (void)tca8418_write_reg8(tca, TCA8418_REG_INT_STAT, TCA8418_INTSTAT_K_INT);
+}
+
+// ---- Dumps ----
+
+struct DumpStep {
+    int64_t t_us;
+    std::vector<uint8_t> fifo;
+    std::vector<uint8_t> down; // expected keyNums after the drain
+};
+
+static bool parse_irq_line(const char *line, int64_t *t_us, std::vector<uint8_t> *bytes) {
+    const char *p = strstr(line, "irq ");
+    if (!p) return false;
+    char *end = nullptr;
+    *t_us = strtoll(p + 4, &end, 10);
+    if (end == p + 4) return false;
+    p = strchr(end, ':');
+    if (!p) return false;
+    p++;
+    bytes->clear();
+    for (;;) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '\n' || *p == '\r') break;
+        const unsigned long v = strtoul(p, &end, 0);
+        if (end == p || v > 0xFF) return false;
+        bytes->push_back((uint8_t)v);
+        p = end;
+    }
+    return true;
+}
+
+static bool load_dump(const std::string &path, std::vector<DumpStep> *steps) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    char line[512];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (strncmp(line, "irq ", 4) == 0) {
+            DumpStep s;
+            ok = parse_irq_line(line, &s.t_us, &s.fifo) && !s.fifo.empty() && s.fifo.size() <= TCA8418_FIFO_DEPTH;
+            steps->push_back(s);
+        } else if (strncmp(line, "down ", 5) == 0 && !steps->empty()) {
+            char *p = line + 5;
+            while (*p && *p != '-') {
+                char *end = nullptr;
+                const long v = strtol(p, &end, 10);
+                if (end == p) break;
+                steps->back().down.push_back((uint8_t)v);
+                p = end;
+            }
+        } else {
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok && !steps->empty();
+}
+
+static std::vector<std::string> list_dumps(const char *dir) {
+    std::vector<std::string> out;
+    DIR *d = opendir(dir);
+    if (!d) return out;
+    while (struct dirent *e = readdir(d)) {
+        const size_t n = strlen(e->d_name);
+        if (n > 4 && strcmp(e->d_name + n - 4, ".txt") == 0) {
+            out.push_back(std::string(dir) + "/" + e->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// ---- Tests ----
+
+static void reset_fakes() {
+    g_tca = FakeTca{};
+    g_isr = nullptr;
+    g_isr_arg = nullptr;
+    g_intr_enabled = false;
+    g_isr_calls = 0;
+    g_debug_lines.clear();
+    g_now_us = 0;
+}
+
+static void test_decode() {
+    // Every event byte: tca8418_decode_event + keynum_from_tca8418_key == the old inline decode.
+    int keys = 0;
+    KeyMask seen = 0;
+    for (int evt = 0; evt < 256; evt++) {
+        bool ref_pressed = false;
+        const uint8_t want = ref_decode_keynum((uint8_t)evt, &ref_pressed);
+        uint8_t key = 0;
+        bool pressed = false;
+        const bool ok = tca8418_decode_event((uint8_t)evt, &key, &pressed);
+        const uint8_t got = ok ? keynum_from_tca8418_key(key) : 0;
+        CHECK(got == want);
+        if (want) {
+            CHECK(pressed == ref_pressed);
+            seen |= key_bit(want);
+            keys++;
+        }
+    }
+    CHECK(seen == kAllKeysMask); // every picture key is reachable (columns 8/9 alias, as before)
+    printf("{\"test\":\"decode\",\"event_bytes\":256,\"mapped\":%d}\n", keys);
+}
+
+static void test_burst_read() {
+    reset_fakes();
+    tca8418_t tca;
+    CHECK(tca8418_open(&tca, 0, kAddr, 7, 8) == ESP_OK);
+    g_tca.regs[TCA8418_REG_CFG] = TCA8418_CFG_AI; // begin() must clear it
+    CHECK(tca8418_begin(&tca) == ESP_OK);
+    CHECK((g_tca.regs[TCA8418_REG_CFG] & TCA8418_CFG_AI) == 0);
+    CHECK((g_tca.regs[TCA8418_REG_CFG] & TCA8418_CFG_KE_IEN) != 0);
+
+    for (uint8_t i = 1; i <= 7; i++) g_tca.push((uint8_t)(0x80 | i));
+    const uint32_t t0 = g_tca.txns;
+    uint8_t buf[TCA8418_FIFO_DEPTH];
+    uint8_t n = 0;
+    CHECK(tca8418_read_events(&tca, buf, 5, &n) == ESP_OK);
+    CHECK(n == 5 && g_tca.txns - t0 == 2);
+    for (uint8_t i = 0; i < 5; i++) CHECK(buf[i] == (uint8_t)(0x81 + i));
+    CHECK(tca8418_read_events(&tca, buf, sizeof(buf), &n) == ESP_OK);
+    CHECK(n == 2 && buf[0] == 0x86 && buf[1] == 0x87);
+    CHECK(tca8418_read_events(&tca, buf, sizeof(buf), &n) == ESP_OK && n == 0);
+    printf("{\"test\":\"burst_read\",\"ok\":true}\n");
+}
+
+struct ReplayStats {
+    uint32_t events = 0;
+    uint32_t new_txns = 0;
+    uint32_t new_bytes = 0;
+    uint32_t ref_txns = 0;
+    uint32_t ref_bytes = 0;
+    uint32_t idle_txns = 0; // over kIdleScans scans with nothing pressed
+};
+
+static constexpr int64_t kAppDelayUs = 180; // ISR -> scanner task -> scan_mask()
+static constexpr int kIdleScans = 50;
+
+static void replay(const std::vector<DumpStep> &steps, bool use_int, ReplayStats *st) {
+    reset_fakes();
+    UnifiedScanner kb;
+    UnifiedScannerConfig cfg;
+    cfg.backend = ScannerBackend::Tca8418;
+    cfg.use_int = use_int;
+    CHECK(kb.init(cfg) == ESP_OK);
+    CHECK(kb.interrupt_driven() == use_int);
+
+    // Idle: with INT nothing touches the bus.
+    uint32_t t0 = g_tca.txns;
+    for (int i = 0; i < kIdleScans; i++) {
+        CHECK(kb.wait(15) == false);
+        CHECK(kb.scan_mask() == 0);
+    }
+    st->idle_txns = g_tca.txns - t0;
+
+    // Poll mode stamps events with the previous drain; the latency is the gap up to this one.
+    int64_t prev_scan_us = g_now_us;
+    uint32_t max_gap_us = 0;
+    for (const DumpStep &s : steps) {
+        g_now_us = s.t_us;
+        g_debug_lines.clear();
+        for (uint8_t b : s.fifo) g_tca.push(b);
+        service_int();
+
+        g_now_us = s.t_us + kAppDelayUs;
+        CHECK(kb.wait(15) == use_int);
+        t0 = g_tca.txns;
+        const uint32_t b0 = g_tca.bus_bytes;
+        const KeyMask down = kb.scan_mask();
+        const int64_t t_expect = use_int ? s.t_us : prev_scan_us;
+        prev_scan_us = g_now_us;
+        st->new_txns += g_tca.txns - t0;
+        st->new_bytes += g_tca.bus_bytes - b0;
+
+        CHECK(down == mask_from_keynums(s.down.data(), s.down.size()));
+        CHECK(g_tca.fifo.empty());
+        CHECK(!g_tca.int_low());
+
+        size_t n = 0;
+        const TimedKeyEvent *ev = kb.last_events(&n);
+        size_t mapped = 0;
+        for (uint8_t b : s.fifo) {
+            uint8_t key = 0;
+            mapped += (tca8418_decode_event(b, &key, nullptr) && keynum_from_tca8418_key(key)) ? 1 : 0;
+        }
+        CHECK(n == mapped);
+        for (size_t i = 0; i < n; i++) {
+            CHECK(ev[i].t_us == t_expect);
+        }
+        if (n > 0 && g_now_us - t_expect > (int64_t)max_gap_us) max_gap_us = (uint32_t)(g_now_us - t_expect);
+        st->events += (uint32_t)n;
+
+        // The debug capture line round-trips through the dump parser.
+        CHECK(g_debug_lines.size() == 1);
+        int64_t t_log = 0;
+        std::vector<uint8_t> logged;
+        CHECK(parse_irq_line(g_debug_lines[0].c_str(), &t_log, &logged));
+        CHECK(logged == s.fifo);
+        CHECK(t_log == t_expect);
+
+        // Nothing more pending after the drain.
+        CHECK(kb.wait(15) == false);
+    }
+
+    const KeyLatencyHistogram &h = kb.latency();
+    CHECK(h.total == st->events);
+    if (use_int) {
+        CHECK(h.counts[0] == st->events && h.max_us == (uint32_t)kAppDelayUs);
+    } else {
+        CHECK(h.max_us == max_gap_us); // poll mode: up to one poll period
+    }
+
+    // Same FIFO contents through the old per-event drain.
+    reset_fakes();
+    tca8418_t tca;
+    CHECK(tca8418_open(&tca, 0, kAddr, 7, 8) == ESP_OK);
+    for (const DumpStep &s : steps) {
+        for (uint8_t b : s.fifo) g_tca.push(b);
+        t0 = g_tca.txns;
+        const uint32_t b0 = g_tca.bus_bytes;
+        ref_drain(&tca);
+        st->ref_txns += g_tca.txns - t0;
+        st->ref_bytes += g_tca.bus_bytes - b0;
+    }
+}
+
+static void test_dumps(const char *dir) {
+    const std::vector<std::string> files = list_dumps(dir);
+    CHECK(!files.empty());
+    for (const std::string &path : files) {
+        std::vector<DumpStep> steps;
+        CHECK(load_dump(path, &steps));
+        const char *name = strrchr(path.c_str(), '/') + 1;
+        for (int use_int = 1; use_int >= 0; use_int--) {
+            ReplayStats st;
+            const int before = g_failures;
+            replay(steps, use_int != 0, &st);
+            if (g_failures != before) {
+                fprintf(stderr, "dump %s (%s) failed\n", name, use_int ? "int" : "poll");
+                return;
+            }
+            // 9 bit times per byte at 400 kHz.
+            printf("{\"dump\":\"%s\",\"mode\":\"%s\",\"drains\":%zu,\"events\":%u,\"old_txns\":%u,\"new_txns\":%u,"
+                   "\"old_bus_us\":%.1f,\"new_bus_us\":%.1f,\"idle_txns_per_scan\":%.1f}\n",
+                   name, use_int ? "int" : "poll", steps.size(), st.events, st.ref_txns, st.new_txns,
+                   st.ref_bytes * 22.5, st.new_bytes * 22.5, (double)st.idle_txns / kIdleScans);
+        }
+    }
+}
+
+static void test_int_stuck_falls_back() {
+    reset_fakes();
+    UnifiedScanner kb;
+    UnifiedScannerConfig cfg;
+    cfg.backend = ScannerBackend::Tca8418;
+    CHECK(kb.init(cfg) == ESP_OK);
+    CHECK(kb.interrupt_driven());
+
+    g_tca.int_stuck = true;
+    service_int();
+    int scans = 0;
+    while (kb.interrupt_driven() && scans < 20) {
+        (void)kb.wait(15);
+        (void)kb.scan_mask();
+        scans++;
+    }
+    CHECK(!kb.interrupt_driven());
+    CHECK(g_isr == nullptr);
+
+    // Polling still delivers keys.
+    g_tca.push(0x83); // fn down
+    CHECK(kb.wait(15) == false);
+    CHECK(kb.scan_mask() == key_bit(29));
+    printf("{\"test\":\"int_stuck_fallback\",\"scans_before_fallback\":%d}\n", scans);
+}
+
+static void test_histogram() {
+    KeyLatencyHistogram h;
+    CHECK(h.percentile_upper_us(50) == 0 && h.mean_us() == 0);
+    const int64_t samples[] = {-5, 0, 100, 249, 250, 900, 1500, 3000, 70000, 5000000000LL};
+    for (int64_t s : samples) h.record(s);
+    CHECK(h.total == 10);
+    CHECK(h.counts[0] == 4); // -5 (clamped), 0, 100, 249
+    CHECK(h.counts[1] == 1); // 250
+    CHECK(h.counts[2] == 1 && h.counts[3] == 1 && h.counts[4] == 1);
+    CHECK(h.counts[kKeyLatencyBuckets - 1] == 2);
+    CHECK(h.max_us == 0xFFFFFFFFu);
+    CHECK(h.percentile_upper_us(40) == 250);
+    CHECK(h.percentile_upper_us(50) == 500);
+    CHECK(h.percentile_upper_us(80) == 4000);
+    CHECK(h.percentile_upper_us(100) == 0xFFFFFFFFu);
+
+    KeyLatencyHistogram small;
+    small.record(120);
+    CHECK(small.percentile_upper_us(99) == 120); // capped at the max seen
+    printf("{\"test\":\"histogram\",\"ok\":true}\n");
+}
+
+int main(int argc, char **argv) {
+    const char *dumps = (argc > 1) ? argv[1] : "dumps";
+
+    test_decode();
+    test_burst_read();
+    test_histogram();
+    test_dumps(dumps);
+    test_int_stuck_falls_back();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -1,10 +1,16 @@
 #include "cardputer_kb/scanner.h"
 
-#include <cstring>
+#include <inttypes.h>
+#include <stdio.h>
 
 #include "driver/gpio.h"
 #include "driver/i2c.h"
+#include "esp_cpu.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 
 #include "cardputer_kb/layout.h"
 
@@ -18,7 +24,25 @@ struct cardputer_kb::UnifiedScanner::TcaState {
     bool i2c_ready = false;
     tca8418_t tca{};
 
-    bool pressed[cardputer_kb::kRows * cardputer_kb::kCols + 1] = {false}; // index 1..56
+    cardputer_kb::KeyMask down = 0;
+
+    // INT line (active low, held until INT_STAT is cleared). The ISR masks itself and the drain
+    // unmasks it, so there is one interrupt per assertion and no storm while the line is low.
+    bool irq_enabled = false;
+    int int_gpio = -1;
+    SemaphoreHandle_t wake = nullptr;
+    portMUX_TYPE irq_mux = portMUX_INITIALIZER_UNLOCKED;
+    bool irq_pending = false; // guarded by irq_mux
+    int64_t irq_us = 0;       // guarded by irq_mux
+    int spurious_irqs = 0;    // consecutive interrupts that found an empty FIFO
+
+    // Poll mode: start of the previous drain (-1 = none yet). An event found now landed after it.
+    int64_t last_poll_us = -1;
+
+    // Events applied by the last drain (a drain reads at most kMaxPasses FIFOs' worth).
+    static constexpr int kMaxPasses = 4;
+    cardputer_kb::TimedKeyEvent events[kMaxPasses * TCA8418_FIFO_DEPTH] = {};
+    size_t n_events = 0;
 
     ~TcaState() { deinit_bus(); }
 
@@ -46,11 +70,12 @@ struct cardputer_kb::UnifiedScanner::TcaState {
     }
 
     void deinit_bus() {
+        deinit_irq();
         // Best-effort only. We intentionally do not uninstall the I2C driver here,
         // since other subsystems (e.g. display/audio) may also use the same port.
         i2c_ready = false;
         inited = false;
-        std::memset(pressed, 0, sizeof(pressed));
+        down = 0;
     }
 
     esp_err_t probe(const UnifiedScannerConfig &cfg) {
@@ -75,91 +100,166 @@ struct cardputer_kb::UnifiedScanner::TcaState {
         if (err != ESP_OK) return err;
 
         inited = true;
+        if (cfg.use_int && cfg.int_gpio >= 0) {
+            err = init_irq(cfg.int_gpio);
+            if (err != ESP_OK) {
+                ESP_LOGW(TAG, "TCA8418 INT on GPIO%d unavailable (%s); polling", cfg.int_gpio, esp_err_to_name(err));
+            }
+        }
         return ESP_OK;
     }
 
-    inline bool decode_and_apply_event(uint8_t evt_raw) {
-        if (evt_raw == 0) {
-            return false;
+    static void isr(void *arg) {
+        auto *self = (TcaState *)arg;
+        gpio_intr_disable((gpio_num_t)self->int_gpio);
+        const int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL_ISR(&self->irq_mux);
+        if (!self->irq_pending) {
+            self->irq_pending = true;
+            self->irq_us = now;
+        }
+        portEXIT_CRITICAL_ISR(&self->irq_mux);
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR(self->wake, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
         }
+    }
 
-        // TCA8418 KEY_EVENT: bit7 is state, bits6..0 are key number (1-based).
-        // This firmware family treats bit7=1 as "pressed".
-        const bool is_pressed = (evt_raw & 0x80) != 0;
-        uint8_t keynum = (uint8_t)(evt_raw & 0x7F);
-        if (keynum == 0) {
-            return false;
+    esp_err_t init_irq(int gpio) {
+        wake = xSemaphoreCreateBinary();
+        if (!wake) return ESP_ERR_NO_MEM;
+
+        gpio_config_t io = {};
+        io.pin_bit_mask = 1ULL << gpio;
+        io.mode = GPIO_MODE_INPUT;
+        io.pull_up_en = GPIO_PULLUP_ENABLE;
+        io.intr_type = GPIO_INTR_LOW_LEVEL;
+        esp_err_t err = gpio_config(&io);
+        if (err == ESP_OK) {
+            err = gpio_install_isr_service(0);
+            if (err == ESP_ERR_INVALID_STATE) err = ESP_OK; // already installed by someone else
+        }
+        if (err == ESP_OK) {
+            int_gpio = gpio;
+            err = gpio_isr_handler_add((gpio_num_t)gpio, &TcaState::isr, this);
+        }
+        if (err != ESP_OK) {
+            int_gpio = -1;
+            vSemaphoreDelete(wake);
+            wake = nullptr;
+            return err;
         }
-        keynum--; // 0-based
+        irq_enabled = true;
+        spurious_irqs = 0;
+        return ESP_OK;
+    }
 
-        // Convert 1..80 key number into row/col for a 10-wide internal matrix, then remap to Cardputer picture-space.
-        const uint8_t row = (uint8_t)(keynum / 10);
-        const uint8_t col = (uint8_t)(keynum % 10);
+    void deinit_irq() {
+        if (irq_enabled) {
+            gpio_intr_disable((gpio_num_t)int_gpio);
+            gpio_isr_handler_remove((gpio_num_t)int_gpio);
+            irq_enabled = false;
+        }
+        int_gpio = -1;
+        if (wake) {
+            vSemaphoreDelete(wake);
+            wake = nullptr;
+        }
+    }
 
-        const uint8_t x = (uint8_t)(row * 2 + ((col > 3) ? 1 : 0));
-        const uint8_t y = (uint8_t)((col + 4) % 4);
+    // Returns true (and the time INT fell) if an interrupt is pending, clearing it.
+    bool take_irq(int64_t *out_us) {
+        portENTER_CRITICAL(&irq_mux);
+        const bool pending = irq_pending;
+        *out_us = irq_us;
+        irq_pending = false;
+        portEXIT_CRITICAL(&irq_mux);
+        return pending;
+    }
 
-        if (x >= cardputer_kb::kCols || y >= cardputer_kb::kRows) {
-            return false;
+    void apply_event(uint8_t evt, int64_t t_us) {
+        uint8_t key = 0;
+        bool pressed = false;
+        if (!tca8418_decode_event(evt, &key, &pressed)) {
+            return;
         }
-
-        const uint8_t kn = cardputer_kb::keynum_from_xy(x, y);
-        if (kn == 0) {
-            return false;
+        const uint8_t kn = cardputer_kb::keynum_from_tca8418_key(key);
+        const cardputer_kb::KeyMask bit = cardputer_kb::key_bit(kn);
+        if (bit == 0) {
+            return;
+        }
+        down = pressed ? (down | bit) : (down & ~bit);
+        if (n_events < sizeof(events) / sizeof(events[0])) {
+            events[n_events++] = cardputer_kb::TimedKeyEvent{t_us, kn, pressed};
         }
-
-        pressed[kn] = is_pressed;
-        return true;
     }
 
     void drain_events() {
+        n_events = 0;
         if (!inited) {
             return;
         }
 
-        for (;;) {
-            uint8_t count = 0;
-            esp_err_t err = tca8418_available(&tca, &count);
-            if (err != ESP_OK || count == 0) {
-                break;
-            }
-
-            for (uint8_t i = 0; i < count; i++) {
-                uint8_t evt = 0;
-                err = tca8418_get_event(&tca, &evt);
-                if (err != ESP_OK) {
-                    break;
-                }
-                if (evt == 0) {
-                    break;
-                }
-                (void)decode_and_apply_event(evt);
+        int64_t t_event = 0;
+        if (irq_enabled) {
+            if (!take_irq(&t_event)) {
+                return; // INT idle: the FIFO is empty, no bus traffic
             }
+        } else {
+            // Stamp with the previous poll so latency covers the wait for this one, not just the drain.
+            const int64_t now = esp_timer_get_time();
+            t_event = (last_poll_us >= 0) ? last_poll_us : now;
+            last_poll_us = now;
         }
 
-        // Best-effort clear K_INT once we've drained events.
-        (void)tca8418_write_reg8(&tca, TCA8418_REG_INT_STAT, TCA8418_INTSTAT_K_INT);
-    }
-
-    ScanSnapshot snapshot() {
-        ScanSnapshot snap;
-        snap.use_alt_in01 = false;
+        // With INT, clear K_INT/GPI_INT before reading: an event that lands after this re-asserts
+        // INT (and fires the ISR once unmasked) instead of sitting unnoticed in the FIFO.
+        if (irq_enabled) {
+            (void)tca8418_write_reg8(&tca, TCA8418_REG_INT_STAT, 0x03);
+        }
 
-        for (uint8_t kn = 1; kn <= (cardputer_kb::kRows * cardputer_kb::kCols); kn++) {
-            if (!pressed[kn]) {
-                continue;
+        // One pass unless the FIFO was full, in which case more may be queued behind it.
+        int total = 0;
+        for (int pass = 0; pass < kMaxPasses; pass++) {
+            uint8_t buf[TCA8418_FIFO_DEPTH];
+            uint8_t n = 0;
+            if (tca8418_read_events(&tca, buf, sizeof(buf), &n) != ESP_OK || n == 0) {
+                break;
+            }
+#if LOG_LOCAL_LEVEL >= ESP_LOG_DEBUG
+            // Same format as tools/tca_host/dumps, so captures can be replayed on the host.
+            char hex[TCA8418_FIFO_DEPTH * 5 + 1];
+            int len = 0;
+            for (uint8_t i = 0; i < n; i++) {
+                len += snprintf(hex + len, sizeof(hex) - (size_t)len, " 0x%02x", buf[i]);
             }
-            int x = -1;
-            int y = -1;
-            cardputer_kb::xy_from_keynum(kn, &x, &y);
-            if (x < 0 || y < 0) {
-                continue;
+            ESP_LOGD(TAG, "irq %" PRId64 " :%s", t_event, hex);
+#endif
+            for (uint8_t i = 0; i < n; i++) {
+                apply_event(buf[i], t_event);
+            }
+            total += n;
+            if (n < TCA8418_FIFO_DEPTH) {
+                break;
             }
-            snap.pressed.push_back(KeyPos{.x = x, .y = y});
-            snap.pressed_keynums.push_back(kn);
         }
 
-        return snap;
+        if (!irq_enabled) {
+            // Polling: nobody waits on INT, but leave it released for the next reader.
+            if (total > 0) {
+                (void)tca8418_write_reg8(&tca, TCA8418_REG_INT_STAT, 0x03);
+            }
+            return;
+        }
+
+        spurious_irqs = (total == 0) ? (spurious_irqs + 1) : 0;
+        if (spurious_irqs >= 8) {
+            ESP_LOGW(TAG, "TCA8418 INT on GPIO%d stays low with an empty FIFO; polling", int_gpio);
+            deinit_irq();
+            return;
+        }
+        gpio_intr_enable((gpio_num_t)int_gpio);
     }
 };
 
@@ -214,15 +314,51 @@ esp_err_t cardputer_kb::UnifiedScanner::init(const UnifiedScannerConfig &cfg) {
     return ESP_OK;
 }
 
-cardputer_kb::ScanSnapshot cardputer_kb::UnifiedScanner::scan() {
+cardputer_kb::KeyMask cardputer_kb::UnifiedScanner::scan_mask() {
     if (!inited_) {
-        return ScanSnapshot{};
+        return 0;
     }
 
+    const uint32_t t0 = esp_cpu_get_cycle_count();
+    KeyMask down = 0;
     if (backend_ == ScannerBackend::Tca8418 && tca_) {
         tca_->drain_events();
-        return tca_->snapshot();
+        down = tca_->down;
+        if (tca_->n_events > 0) {
+            const int64_t now = esp_timer_get_time();
+            for (size_t i = 0; i < tca_->n_events; i++) {
+                latency_.record(now - tca_->events[i].t_us);
+            }
+        }
+    } else {
+        down = matrix_.scan_mask();
+    }
+    last_scan_cycles_ = esp_cpu_get_cycle_count() - t0;
+    return down;
+}
+
+cardputer_kb::ScanSnapshot cardputer_kb::UnifiedScanner::scan() {
+    const KeyMask down = scan_mask();
+    const bool use_alt_in01 = (backend_ == ScannerBackend::GpioMatrix) && matrix_.use_alt_in01();
+    return snapshot_from_mask(down, use_alt_in01);
+}
+
+bool cardputer_kb::UnifiedScanner::interrupt_driven() const {
+    return inited_ && backend_ == ScannerBackend::Tca8418 && tca_ && tca_->irq_enabled;
+}
+
+bool cardputer_kb::UnifiedScanner::wait(uint32_t timeout_ms) {
+    if (interrupt_driven()) {
+        return xSemaphoreTake(tca_->wake, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
     }
+    vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+    return false;
+}
 
-    return matrix_.scan();
+const cardputer_kb::TimedKeyEvent *cardputer_kb::UnifiedScanner::last_events(size_t *out_count) const {
+    const bool tca = backend_ == ScannerBackend::Tca8418 && tca_;
+    if (out_count) {
+        *out_count = tca ? tca_->n_events : 0;
+    }
+    return tca ? tca_->events : nullptr;
 }
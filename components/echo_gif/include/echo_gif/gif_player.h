@@ -26,6 +26,10 @@ bool echo_gif_player_open_index(int idx, EchoGifRenderCtx *ctx);
 
 // Render one frame (AnimatedGIF::playFrame semantics).
 // Returns the same value as AnimatedGIF::playFrame(). The computed frame delay (ms) is written to out_frame_delay_ms.
+//
+// With CONFIG_ECHO_GIF_DECODE_AHEAD the frame comes from the decode-ahead cache: it is copied into ctx->canvas
+// and 1 is returned (the decoder loops the GIF itself), or -1 if no frame arrives in time. Open, reset and
+// play must be called from one task.
 int echo_gif_player_play_frame(int *out_frame_delay_ms, EchoGifRenderCtx *ctx);
 
 int echo_gif_player_last_error(void);
@@ -41,4 +45,26 @@ int echo_gif_player_frame_y_off(void);
 const char *echo_gif_player_current_path(void);
 int32_t echo_gif_player_current_file_size(void);
 
+// Time (us) from the start of the last open to the end of the open, and to its first frame being ready
+// in the canvas (0 until then). Logged once per open; compare FATFS vs CONFIG_ECHO_GIF_STORAGE_PACK.
+uint32_t echo_gif_player_open_us(void);
+uint32_t echo_gif_player_first_frame_us(void);
 
+typedef struct {
+    bool enabled;
+    uint32_t decoded;   // frames decoded by the background task
+    uint32_t shown;     // frames handed to play_frame
+    uint32_t replayed;  // of those, replayed from a fully cached GIF
+    uint32_t misses;    // frames play_frame had to wait for
+    uint32_t evictions; // cached frames overwritten by newer ones
+    int slots;          // allocated frame buffers
+    int max_slots;
+    uint32_t bytes;     // allocated frame buffer bytes
+    int loop_frames;    // frames per loop of the current GIF, 0 until known
+    bool complete;      // current GIF is fully cached
+    uint32_t wait_us_max;
+    uint64_t wait_us_total;
+} EchoGifCacheStats;
+
+// Decode-ahead cache counters. Returns false (and zeroes out) if the cache is disabled or not set up.
+bool echo_gif_player_cache_stats(EchoGifCacheStats *out);
@@ -6,9 +6,11 @@
 #include "esp_err.h"
 
 // Mount the FATFS storage partition at the configured mount point.
+// With CONFIG_ECHO_GIF_STORAGE_PACK: map the packed asset index of the storage partition instead.
 esp_err_t echo_gif_storage_mount(void);
 
 // Scan configured GIF directory and return up to max_paths full paths (e.g. "/storage/gifs/foo.gif").
+// With CONFIG_ECHO_GIF_STORAGE_PACK the entries are pack names (e.g. "foo.gif").
 // Returns the number of entries written to out_paths.
 int echo_gif_storage_list_gifs(char *out_paths, int max_paths, int max_path_len);
 
@@ -16,4 +18,20 @@ int echo_gif_storage_list_gifs(char *out_paths, int max_paths, int max_path_len)
 esp_err_t echo_gif_storage_read_file(const char *path, uint8_t **out_buf, size_t *out_len);
 void echo_gif_storage_free(uint8_t *buf);
 
+// Packed asset partition (CONFIG_ECHO_GIF_STORAGE_PACK, built by tools/echo_gif_pack.py).
+// Names are the GIF basenames; lookups are case-insensitive, ".gif" optional, and O(1) via the pack's hash index.
+typedef struct {
+    const uint8_t *data; // memory-mapped flash; valid until echo_gif_storage_pack_unmap()
+    size_t size;
+    int canvas_w;
+    int canvas_h;
+    int frame_count;
+    uint32_t duration_ms; // one loop, from the GIF's frame delays
+    uint32_t map_handle;
+} EchoGifAsset;
 
+int echo_gif_storage_pack_count(void);
+const char *echo_gif_storage_pack_name(int idx);
+int echo_gif_storage_pack_find(const char *name);
+esp_err_t echo_gif_storage_pack_map(int idx, EchoGifAsset *out);
+void echo_gif_storage_pack_unmap(EchoGifAsset *asset);
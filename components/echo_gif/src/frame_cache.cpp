@@ -0,0 +1,154 @@
+/*
+ * echo_gif: decode-ahead frame cache (see frame_cache.h).
+ */
+
+#include "frame_cache.h"
+
+#include <string.h>
+
+static bool alloc_slot(EchoGifFrameCache *c) {
+    void *p = c->alloc_fn(c->frame_bytes);
+    if (!p) {
+        return false;
+    }
+    c->slots[c->allocated].pixels = (uint16_t *)p;
+    c->slots[c->allocated].delay_ms = 0;
+    c->allocated++;
+    c->stats.slots = c->allocated;
+    c->stats.bytes += c->frame_bytes;
+    return true;
+}
+
+bool echo_gif_frame_cache_init(EchoGifFrameCache *c, size_t frame_bytes, size_t budget_bytes, int ahead,
+                               bool whole_gif, EchoGifFrameAllocFn alloc, EchoGifFrameFreeFn free_fn) {
+    if (!c || frame_bytes == 0 || !alloc || !free_fn) {
+        return false;
+    }
+    memset(c, 0, sizeof(*c));
+
+    size_t max_slots = budget_bytes / frame_bytes;
+    if (!whole_gif && ahead > 0 && max_slots > (size_t)ahead) {
+        max_slots = (size_t)ahead;
+    }
+    if (max_slots < 2) {
+        return false;
+    }
+    if (max_slots > 1024) {
+        max_slots = 1024;
+    }
+
+    c->slots = (EchoGifCachedFrame *)alloc(max_slots * sizeof(EchoGifCachedFrame));
+    if (!c->slots) {
+        return false;
+    }
+    memset(c->slots, 0, max_slots * sizeof(EchoGifCachedFrame));
+    c->max_slots = (int)max_slots;
+    c->frame_bytes = frame_bytes;
+    c->alloc_fn = alloc;
+    c->free_fn = free_fn;
+    c->stats.max_slots = c->max_slots;
+
+    if (!alloc_slot(c) || !alloc_slot(c)) {
+        echo_gif_frame_cache_deinit(c);
+        return false;
+    }
+    return true;
+}
+
+void echo_gif_frame_cache_deinit(EchoGifFrameCache *c) {
+    if (!c || !c->slots) {
+        return;
+    }
+    for (int i = 0; i < c->allocated; i++) {
+        c->free_fn(c->slots[i].pixels);
+    }
+    c->free_fn(c->slots);
+    memset(c, 0, sizeof(*c));
+}
+
+void echo_gif_frame_cache_reset(EchoGifFrameCache *c) {
+    c->written = 0;
+    c->read = 0;
+    c->reading = false;
+    c->wrapped = false;
+    c->miss_noted = false;
+    c->loop_frames = 0;
+    c->complete = false;
+}
+
+uint16_t *echo_gif_frame_cache_begin_write(EchoGifFrameCache *c) {
+    if (c->complete || c->written - c->read >= (uint32_t)c->max_slots) {
+        return nullptr;
+    }
+    const int idx = (int)(c->written % (uint32_t)c->max_slots);
+    if (idx >= c->allocated) {
+        // First pass only: slots are taken in order, so idx == allocated.
+        if (!alloc_slot(c)) {
+            // Out of memory below the budget: run with what we have.
+            c->max_slots = c->allocated;
+            c->stats.max_slots = c->max_slots;
+            return echo_gif_frame_cache_begin_write(c);
+        }
+    }
+    return c->slots[idx].pixels;
+}
+
+void echo_gif_frame_cache_commit_write(EchoGifFrameCache *c, int delay_ms) {
+    const int idx = (int)(c->written % (uint32_t)c->max_slots);
+    if (c->written >= (uint32_t)c->max_slots) {
+        c->wrapped = true;
+        c->stats.evictions++;
+    }
+    c->slots[idx].delay_ms = delay_ms;
+    c->written++;
+    c->stats.decoded++;
+}
+
+bool echo_gif_frame_cache_end_of_gif(EchoGifFrameCache *c) {
+    if (c->loop_frames == 0) {
+        // First end since reset, which started at frame 0.
+        c->loop_frames = (int)c->written;
+        c->complete = !c->wrapped && c->written > 0;
+    }
+    return c->complete;
+}
+
+void echo_gif_frame_cache_restart(EchoGifFrameCache *c) {
+    c->written = c->read + (c->reading ? 1u : 0u);
+    c->wrapped = true;
+}
+
+const EchoGifCachedFrame *echo_gif_frame_cache_acquire(EchoGifFrameCache *c) {
+    const EchoGifCachedFrame *f = nullptr;
+    if (c->complete) {
+        f = &c->slots[c->read % (uint32_t)c->loop_frames];
+        c->stats.replayed += (c->read >= c->written) ? 1 : 0;
+    } else if (c->read < c->written) {
+        f = &c->slots[c->read % (uint32_t)c->max_slots];
+    }
+    if (!f) {
+        if (!c->miss_noted) {
+            c->miss_noted = true;
+            c->stats.misses++;
+        }
+        return nullptr;
+    }
+    c->reading = true;
+    c->miss_noted = false;
+    c->stats.shown++;
+    return f;
+}
+
+void echo_gif_frame_cache_release(EchoGifFrameCache *c) {
+    if (!c->reading) {
+        return;
+    }
+    c->reading = false;
+    c->read++;
+}
+
+void echo_gif_frame_cache_get_stats(const EchoGifFrameCache *c, EchoGifFrameCacheStats *out) {
+    *out = c->stats;
+    out->loop_frames = c->loop_frames;
+    out->complete = c->complete;
+}
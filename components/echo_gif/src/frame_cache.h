@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+ * echo_gif: decode-ahead frame cache (bookkeeping for a ring of RGB565 frames).
+ *
+ * No locking and no ESP-IDF dependency, so it builds on the host
+ * (components/echo_gif/tools/cache_host). gif_player.cpp owns the lock and the
+ * decoder task.
+ *
+ * Frame k (counted since the last reset) lives in slot k % max_slots. Slots are
+ * allocated on first use. The decoder may run up to max_slots frames ahead of
+ * the reader, and a slot is reused only after the reader has released it. If
+ * the decoder reaches the end of the GIF before it ever reused a slot, every
+ * frame is still cached: the cache becomes complete, decoding stops and the
+ * reader replays the loop from memory.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void *(*EchoGifFrameAllocFn)(size_t bytes);
+typedef void (*EchoGifFrameFreeFn)(void *p);
+
+typedef struct {
+    uint16_t *pixels; // frame_bytes, RGB565 as written by the decoder
+    int delay_ms;
+} EchoGifCachedFrame;
+
+typedef struct {
+    uint32_t decoded;   // frames committed by the decoder
+    uint32_t shown;     // frames handed to the reader
+    uint32_t replayed;  // of those, served from a complete cache
+    uint32_t misses;    // frames the reader asked for before they were decoded
+    uint32_t evictions; // slots overwritten with a newer frame
+    int slots;          // allocated slots
+    int max_slots;
+    size_t bytes;       // allocated pixel bytes
+    int loop_frames;    // frames per loop once the end was reached, else 0
+    bool complete;
+} EchoGifFrameCacheStats;
+
+typedef struct {
+    EchoGifCachedFrame *slots; // max_slots entries; pixels == NULL until used
+    int max_slots;
+    int allocated;
+    size_t frame_bytes;
+    EchoGifFrameAllocFn alloc_fn;
+    EchoGifFrameFreeFn free_fn;
+
+    uint32_t written; // frames committed since reset
+    uint32_t read;    // frames released since reset
+    bool reading;     // reader holds frame `read`
+    bool wrapped;     // a slot has been reused since reset
+    bool miss_noted;  // a miss was already counted for frame `read`
+    int loop_frames;
+    bool complete;
+
+    EchoGifFrameCacheStats stats;
+} EchoGifFrameCache;
+
+// max_slots = budget_bytes / frame_bytes, capped to `ahead` unless whole_gif is
+// set. Allocates the first two slots up front; fails if fewer than two fit.
+bool echo_gif_frame_cache_init(EchoGifFrameCache *c, size_t frame_bytes, size_t budget_bytes, int ahead,
+                               bool whole_gif, EchoGifFrameAllocFn alloc, EchoGifFrameFreeFn free_fn);
+void echo_gif_frame_cache_deinit(EchoGifFrameCache *c);
+
+// Drops all frames (new GIF or rewind). Buffers and counters are kept.
+void echo_gif_frame_cache_reset(EchoGifFrameCache *c);
+
+// Decoder side. begin_write returns the buffer for the next frame, or NULL when
+// the ring is full or the cache is complete. Nothing changes until commit, so a
+// failed decode simply does not commit.
+uint16_t *echo_gif_frame_cache_begin_write(EchoGifFrameCache *c);
+void echo_gif_frame_cache_commit_write(EchoGifFrameCache *c, int delay_ms);
+// The last committed frame ended the GIF. Returns true if the whole loop is
+// cached (stop decoding).
+bool echo_gif_frame_cache_end_of_gif(EchoGifFrameCache *c);
+// The decoder started over from frame 0 mid-loop (decode error). Drops the
+// frames not handed to the reader yet; a frame the reader holds stays valid.
+// Frame numbers no longer match loop positions, so the GIF is not cached whole
+// until the next reset.
+void echo_gif_frame_cache_restart(EchoGifFrameCache *c);
+
+// Reader side. acquire returns the next frame (valid until release) or NULL if
+// it is not decoded yet, which counts one miss per frame.
+const EchoGifCachedFrame *echo_gif_frame_cache_acquire(EchoGifFrameCache *c);
+void echo_gif_frame_cache_release(EchoGifFrameCache *c);
+
+void echo_gif_frame_cache_get_stats(const EchoGifFrameCache *c, EchoGifFrameCacheStats *out);
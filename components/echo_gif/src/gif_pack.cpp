@@ -0,0 +1,135 @@
+/*
+ * echo_gif: packed GIF asset index (see gif_pack.h).
+ */
+
+#include "gif_pack.h"
+
+#include <string.h>
+
+static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static const char *basename_of(const char *path) {
+    const char *slash = strrchr(path, '/');
+    return slash ? (slash + 1) : path;
+}
+
+// Length of name without a trailing (case-insensitive) ".gif".
+static size_t stem_len(const char *name, size_t len) {
+    if (len > 4 && name[len - 4] == '.' && lower(name[len - 3]) == 'g' && lower(name[len - 2]) == 'i' &&
+        lower(name[len - 1]) == 'f') {
+        return len - 4;
+    }
+    return len;
+}
+
+uint32_t echo_gif_pack_hash(const char *name, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)lower(name[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool echo_gif_pack_open(EchoGifPack *p, const uint8_t *base, size_t len) {
+    if (!p || !base || len < sizeof(EchoGifPackHeader)) {
+        return false;
+    }
+    memset(p, 0, sizeof(*p));
+    const auto *h = (const EchoGifPackHeader *)base;
+    if (memcmp(h->magic, ECHO_GIF_PACK_MAGIC, 4) != 0 || h->version != ECHO_GIF_PACK_VERSION ||
+        h->entry_size != sizeof(EchoGifPackEntry)) {
+        return false;
+    }
+    const uint32_t n = h->entry_count;
+    const uint32_t nb = h->bucket_count;
+    if (n > 0xfffe || nb < 2 * n || nb == 0 || (nb & (nb - 1)) != 0) {
+        return false;
+    }
+    if (h->index_size > len || h->index_size > h->total_size ||
+        h->entries_offset < sizeof(EchoGifPackHeader) || (h->entries_offset & 3) != 0 ||
+        (uint64_t)h->entries_offset + (uint64_t)n * sizeof(EchoGifPackEntry) > h->buckets_offset ||
+        (h->buckets_offset & 1) != 0 || (uint64_t)h->buckets_offset + (uint64_t)nb * 2 > h->names_offset ||
+        h->names_offset > h->index_size) {
+        return false;
+    }
+
+    const auto *entries = (const EchoGifPackEntry *)(base + h->entries_offset);
+    for (uint32_t i = 0; i < n; i++) {
+        const EchoGifPackEntry *e = &entries[i];
+        if (e->name_offset < h->names_offset || e->name_offset >= h->index_size ||
+            !memchr(base + e->name_offset, 0, h->index_size - e->name_offset)) {
+            return false;
+        }
+        if (e->data_offset < h->index_size || (uint64_t)e->data_offset + e->data_size > h->total_size) {
+            return false;
+        }
+    }
+    const auto *buckets = (const uint16_t *)(base + h->buckets_offset);
+    for (uint32_t i = 0; i < nb; i++) {
+        if (buckets[i] > n) {
+            return false;
+        }
+    }
+
+    p->base = base;
+    p->hdr = h;
+    p->entries = entries;
+    p->buckets = buckets;
+    return true;
+}
+
+int echo_gif_pack_count(const EchoGifPack *p) {
+    return (p && p->hdr) ? (int)p->hdr->entry_count : 0;
+}
+
+const EchoGifPackEntry *echo_gif_pack_entry(const EchoGifPack *p, int idx) {
+    if (idx < 0 || idx >= echo_gif_pack_count(p)) {
+        return nullptr;
+    }
+    return &p->entries[idx];
+}
+
+const char *echo_gif_pack_name(const EchoGifPack *p, int idx) {
+    const EchoGifPackEntry *e = echo_gif_pack_entry(p, idx);
+    return e ? (const char *)(p->base + e->name_offset) : nullptr;
+}
+
+int echo_gif_pack_find(const EchoGifPack *p, const char *name) {
+    if (!name || !*name || echo_gif_pack_count(p) == 0) {
+        return -1;
+    }
+    name = basename_of(name);
+    const size_t qlen = stem_len(name, strlen(name));
+    const uint32_t h = echo_gif_pack_hash(name, qlen);
+    const uint32_t mask = p->hdr->bucket_count - 1;
+
+    // bucket_count >= 2 * entry_count, so a well-formed table always has an
+    // empty bucket; the probe count only guards against a corrupt one.
+    uint32_t b = h & mask;
+    for (uint32_t probes = 0; probes <= mask; probes++, b = (b + 1) & mask) {
+        const uint16_t slot = p->buckets[b];
+        if (slot == 0) {
+            return -1;
+        }
+        const EchoGifPackEntry *e = &p->entries[slot - 1];
+        if (e->name_hash != h) {
+            continue;
+        }
+        const char *cand = (const char *)(p->base + e->name_offset);
+        const size_t clen = stem_len(cand, strlen(cand));
+        if (clen != qlen) {
+            continue;
+        }
+        size_t i = 0;
+        while (i < qlen && lower(cand[i]) == lower(name[i])) {
+            i++;
+        }
+        if (i == qlen) {
+            return (int)(slot - 1);
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * echo_gif: packed GIF asset format ("EGPK"), an alternative to the FATFS image.
+ *
+ * Layout (little-endian, offsets from the start of the partition):
+ *
+ *   EchoGifPackHeader
+ *   EchoGifPackEntry[entry_count]      sorted by name
+ *   uint16_t buckets[bucket_count]     open-addressing hash table, entry index + 1 (0 = empty)
+ *   names                              NUL-terminated basenames ("foo.gif")
+ *   ---- index_size ----
+ *   GIF files, each 4-byte aligned
+ *
+ * The bucket for a name is echo_gif_pack_hash(stem) & (bucket_count - 1), probing
+ * linearly; the stem is the lowercased basename without ".gif", so lookups are
+ * case-insensitive and the extension is optional (as in echo_gif_registry).
+ *
+ * Written by tools/echo_gif_pack.py. Plain C++ with no ESP-IDF dependency so the
+ * parser builds on the host (components/echo_gif/tools/pack_host).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ECHO_GIF_PACK_MAGIC "EGPK"
+#define ECHO_GIF_PACK_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t entry_size; // sizeof(EchoGifPackEntry)
+    uint32_t entry_count;
+    uint32_t bucket_count; // power of two, >= 2 * entry_count
+    uint32_t entries_offset;
+    uint32_t buckets_offset;
+    uint32_t names_offset;
+    uint32_t index_size; // bytes before the first GIF
+    uint32_t total_size;
+} EchoGifPackHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t name_hash;
+    uint32_t name_offset;
+    uint32_t data_offset;
+    uint32_t data_size;
+    uint16_t canvas_w;
+    uint16_t canvas_h;
+    uint16_t frame_count;
+    uint16_t flags; // reserved, 0
+    uint32_t duration_ms; // one loop
+} EchoGifPackEntry;
+
+typedef struct {
+    const uint8_t *base;
+    const EchoGifPackHeader *hdr;
+    const EchoGifPackEntry *entries;
+    const uint16_t *buckets;
+} EchoGifPack;
+
+// FNV-1a over name[0..len), lowercased. Entries are hashed by stem.
+uint32_t echo_gif_pack_hash(const char *name, size_t len);
+
+// Validates the header and index; `len` must cover at least index_size bytes.
+// Entry data ranges are checked against total_size, not against `len`, so the
+// index can be mapped on its own.
+bool echo_gif_pack_open(EchoGifPack *p, const uint8_t *base, size_t len);
+
+int echo_gif_pack_count(const EchoGifPack *p);
+const EchoGifPackEntry *echo_gif_pack_entry(const EchoGifPack *p, int idx);
+const char *echo_gif_pack_name(const EchoGifPack *p, int idx);
+
+// Entry index for "foo.gif", "FOO" or "/any/dir/foo.gif", or -1.
+int echo_gif_pack_find(const EchoGifPack *p, const char *name);
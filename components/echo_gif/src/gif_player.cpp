@@ -1,6 +1,11 @@
 /*
  * echo_gif: GIF playback (AnimatedGIF + FATFS assets).
  *
+ * With CONFIG_ECHO_GIF_DECODE_AHEAD a decoder task owns s_gif and fills a frame
+ * cache (frame_cache.h) ahead of playback; echo_gif_player_play_frame() then
+ * only copies a decoded frame into the caller's canvas. s_gif_lock is held by
+ * whoever touches s_gif (the decoder for one frame at a time, open/reset).
+ *
  * NOTE: include order matters when combining AnimatedGIF and LovyanGFX/M5GFX due to
  * macro helpers like memcpy_P in pgmspace headers. Keep M5GFX included before AnimatedGIF.
  */
@@ -11,13 +16,22 @@
 
 #include "sdkconfig.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "M5GFX.h"
 #include "AnimatedGIF.h"
 
 #include "echo_gif/gif_player.h"
 #include "echo_gif/gif_registry.h"
+#include "echo_gif/gif_storage.h"
+#include "frame_cache.h"
+#include "gif_span.h"
 
 static const char *TAG = "echo_gif_player";
 
@@ -26,68 +40,48 @@ static AnimatedGIF s_gif;
 static char s_current_gif[CONFIG_ECHO_GIF_MAX_PATH_LEN] = {0};
 static int32_t s_current_gif_file_size = 0;
 
-static void GIFDraw(GIFDRAW *pDraw) {
-    auto *ctx = (EchoGifRenderCtx *)pDraw->pUser;
-    if (!ctx || !ctx->canvas) {
-        return;
-    }
+// Open-to-first-frame timing for the current GIF (us since esp_timer start).
+static int64_t s_open_start_us = 0;
+static uint32_t s_open_us = 0;
+static uint32_t s_first_frame_us = 0;
 
-    auto *dst = (uint16_t *)ctx->canvas->getBuffer();
-    const uint8_t *s = pDraw->pPixels;
-    const uint16_t *pal = pDraw->pPalette;
+#if CONFIG_ECHO_GIF_STORAGE_PACK
+static EchoGifAsset s_asset = {}; // mapped bytes of the open GIF
+#endif
 
-    const int src_y = pDraw->iY + pDraw->y;
-    const int src_x0 = pDraw->iX;
-    const int src_w = pDraw->iWidth;
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+static EchoGifFrameCache s_cache;
+static bool s_cache_ok = false;
+static SemaphoreHandle_t s_cache_lock = nullptr; // s_cache bookkeeping
+static SemaphoreHandle_t s_gif_lock = nullptr;   // s_gif + s_decode_target
+static SemaphoreHandle_t s_frame_ready = nullptr;
+static TaskHandle_t s_decoder = nullptr;
+static EchoGifSpanTarget s_decode_target = {};
+static bool s_decoding = false; // guarded by s_gif_lock
+static uint32_t s_wait_us_max = 0;
+static uint64_t s_wait_us_total = 0;
+#endif
 
-    const int sx = (ctx->scale_x > 0) ? ctx->scale_x : 1;
-    const int sy = (ctx->scale_y > 0) ? ctx->scale_y : 1;
+static EchoGifSpanTarget span_target(const EchoGifRenderCtx *ctx, uint16_t *pixels) {
+    const EchoGifSpanTarget target = {
+        .pixels = pixels,
+        .w = ctx->canvas_w,
+        .h = ctx->canvas_h,
+        .scale_x = ctx->scale_x,
+        .scale_y = ctx->scale_y,
+        .off_x = ctx->off_x,
+        .off_y = ctx->off_y,
+    };
+    return target;
+}
 
-    const int dst_y0 = ctx->off_y + src_y * sy;
-    for (int dy = 0; dy < sy; dy++) {
-        const int y = dst_y0 + dy;
-        if ((unsigned)y >= (unsigned)ctx->canvas_h) {
-            continue;
-        }
-        uint16_t *row = &dst[y * ctx->canvas_w];
-
-        if (pDraw->ucHasTransparency) {
-            const uint8_t t = pDraw->ucTransparent;
-            for (int i = 0; i < src_w; i++) {
-                const uint8_t idx = s[i];
-                if (idx == t) {
-                    continue;
-                }
-                uint16_t c = pal[idx];
-#if CONFIG_ECHO_GIF_SWAP_BYTES
-                c = __builtin_bswap16(c);
-#endif
-                const int dst_x0 = ctx->off_x + (src_x0 + i) * sx;
-                for (int dx = 0; dx < sx; dx++) {
-                    const int x = dst_x0 + dx;
-                    if ((unsigned)x < (unsigned)ctx->canvas_w) {
-                        row[x] = c;
-                    }
-                }
-            }
-        } else {
-            for (int i = 0; i < src_w; i++) {
-                uint16_t c = pal[s[i]];
-#if CONFIG_ECHO_GIF_SWAP_BYTES
-                c = __builtin_bswap16(c);
-#endif
-                const int dst_x0 = ctx->off_x + (src_x0 + i) * sx;
-                for (int dx = 0; dx < sx; dx++) {
-                    const int x = dst_x0 + dx;
-                    if ((unsigned)x < (unsigned)ctx->canvas_w) {
-                        row[x] = c;
-                    }
-                }
-            }
-        }
-    }
+// pUser is the EchoGifSpanTarget to draw into (the caller's canvas or, with
+// decode-ahead, the decoder's working frame).
+static void GIFDraw(GIFDRAW *pDraw) {
+    echo_gif_draw_line((const EchoGifSpanTarget *)pDraw->pUser, pDraw);
 }
 
+#if !CONFIG_ECHO_GIF_STORAGE_PACK
 // AnimatedGIF file callbacks (stream from FATFS; avoid loading whole file into RAM)
 static void *gif_open_cb(const char *szFilename, int32_t *pFileSize) {
     if (pFileSize) *pFileSize = 0;
@@ -138,23 +132,279 @@ static int32_t gif_seek_cb(GIFFILE *pFile, int32_t iPosition) {
     pFile->iPos = iPosition;
     return iPosition;
 }
+#endif
+
+// Opens path in s_gif. Packed assets are opened in place from the flash mapping
+// (AnimatedGIF's memory reader), FATFS files through the stdio callbacks above.
+static int open_gif(const char *path) {
+#if CONFIG_ECHO_GIF_STORAGE_PACK
+    echo_gif_storage_pack_unmap(&s_asset);
+    if (echo_gif_storage_pack_map(echo_gif_storage_pack_find(path), &s_asset) != ESP_OK) {
+        ESP_LOGE(TAG, "gif not in pack: %s", path);
+        return 0;
+    }
+    s_current_gif_file_size = (int32_t)s_asset.size;
+    return s_gif.open((uint8_t *)s_asset.data, (int)s_asset.size, GIFDraw);
+#else
+    return s_gif.open(path, gif_open_cb, gif_close_cb, gif_read_cb, gif_seek_cb, GIFDraw);
+#endif
+}
+
+static void note_first_frame(void) {
+    if (s_first_frame_us != 0 || s_open_start_us == 0) {
+        return;
+    }
+    s_first_frame_us = (uint32_t)(esp_timer_get_time() - s_open_start_us);
+    ESP_LOGI(TAG, "open-to-first-frame: %u us (open %u us, %s)", (unsigned)s_first_frame_us, (unsigned)s_open_us,
+#if CONFIG_ECHO_GIF_STORAGE_PACK
+             "pack"
+#else
+             "fatfs"
+#endif
+    );
+}
+
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+// How long the player waits for a late frame before reporting an error.
+static const int kDecodeWaitMs = 1000;
+// Internal RAM left alone when the cache has to fall back to it (no PSRAM).
+static const size_t kInternalReserveBytes = 64 * 1024;
+
+static uint16_t *s_decode_buf = nullptr;
+
+static void *cache_alloc(size_t bytes) {
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p && heap_caps_get_free_size(MALLOC_CAP_8BIT) > bytes + kInternalReserveBytes) {
+        p = heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    return p;
+}
+
+// Caller holds s_gif_lock: start decoding the open GIF from frame 0.
+static void decoder_restart_locked(void) {
+    memset(s_decode_buf, 0, s_cache.frame_bytes);
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    echo_gif_frame_cache_reset(&s_cache);
+    xSemaphoreGive(s_cache_lock);
+    xSemaphoreTake(s_frame_ready, 0);
+    s_decoding = true;
+}
+
+// Decodes one frame into the cache. Returns false if there was nothing to do
+// (no GIF, fully cached, or the ring is full).
+static bool decode_one(void) {
+    xSemaphoreTake(s_gif_lock, portMAX_DELAY);
+    if (!s_decoding) {
+        xSemaphoreGive(s_gif_lock);
+        return false;
+    }
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    uint16_t *dst = echo_gif_frame_cache_begin_write(&s_cache);
+    xSemaphoreGive(s_cache_lock);
+    if (!dst) {
+        xSemaphoreGive(s_gif_lock);
+        return false;
+    }
+
+    // Same handling as a synchronous playFrame() loop: 0 can still mean a frame
+    // was rendered (EOF right after it), and the canvas is cleared per loop.
+    int delay_ms = 0;
+    const int prc = s_gif.playFrame(false, &delay_ms, &s_decode_target);
+    const int last_err = s_gif.getLastError();
+    const bool rendered = (prc > 0 || last_err == GIF_SUCCESS);
+    if (rendered) {
+        memcpy(dst, s_decode_buf, s_cache.frame_bytes);
+        if (delay_ms < CONFIG_ECHO_GIF_MIN_FRAME_DELAY_MS) {
+            delay_ms = CONFIG_ECHO_GIF_MIN_FRAME_DELAY_MS;
+        }
+    }
+
+    bool complete = false;
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    if (rendered) {
+        echo_gif_frame_cache_commit_write(&s_cache, delay_ms);
+    }
+    if (prc == 0) {
+        complete = echo_gif_frame_cache_end_of_gif(&s_cache);
+    } else if (prc < 0) {
+        // s_gif.reset() below starts over at frame 0; the frames ahead of the
+        // reader would otherwise be followed by a second copy of the loop.
+        echo_gif_frame_cache_restart(&s_cache);
+    }
+    xSemaphoreGive(s_cache_lock);
+    if (rendered) {
+        xSemaphoreGive(s_frame_ready);
+    }
+
+    if (prc <= 0) {
+        if (prc < 0) {
+            ESP_LOGE(TAG, "decode failed: last_error=%d", last_err);
+        } else if (complete) {
+            ESP_LOGI(TAG, "gif fully cached: %d frame(s)", s_cache.loop_frames);
+            s_decoding = false;
+        }
+        memset(s_decode_buf, 0, s_cache.frame_bytes);
+        s_gif.reset();
+    }
+    xSemaphoreGive(s_gif_lock);
+    if (prc < 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    return true;
+}
+
+static void decoder_task(void *) {
+    while (true) {
+        if (!decode_one()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+// Sets up the cache for ctx's canvas size on first use. Returns false (and
+// playback stays synchronous) if it cannot be allocated.
+static bool cache_prepare(const EchoGifRenderCtx *ctx) {
+    static bool s_cache_failed = false;
+    const size_t frame_bytes = (size_t)ctx->canvas_w * (size_t)ctx->canvas_h * sizeof(uint16_t);
+    if (s_cache_ok && s_cache.frame_bytes == frame_bytes) {
+        return true;
+    }
+    if (s_cache_failed || frame_bytes == 0) {
+        return false;
+    }
+
+    if (!s_gif_lock) {
+        s_gif_lock = xSemaphoreCreateMutex();
+        s_cache_lock = xSemaphoreCreateMutex();
+        s_frame_ready = xSemaphoreCreateBinary();
+        if (!s_gif_lock || !s_cache_lock || !s_frame_ready ||
+            xTaskCreatePinnedToCore(decoder_task, "gif_decode", CONFIG_ECHO_GIF_DECODE_TASK_STACK, nullptr,
+                                    CONFIG_ECHO_GIF_DECODE_TASK_PRIORITY, &s_decoder,
+                                    CONFIG_ECHO_GIF_DECODE_TASK_CORE) != pdPASS) {
+            ESP_LOGE(TAG, "decode-ahead task create failed; decoding synchronously");
+            s_cache_failed = true;
+            return false;
+        }
+    }
+
+    if (s_cache_ok) {
+        // Canvas size changed: drop the old cache (the decoder is idle once it
+        // sees s_decoding == false).
+        xSemaphoreTake(s_gif_lock, portMAX_DELAY);
+        s_decoding = false;
+        s_cache_ok = false;
+        echo_gif_frame_cache_deinit(&s_cache);
+        heap_caps_free(s_decode_buf);
+        s_decode_buf = nullptr;
+        xSemaphoreGive(s_gif_lock);
+    }
+
+#if CONFIG_ECHO_GIF_CACHE_WHOLE_GIF
+    const bool whole_gif = true;
+#else
+    const bool whole_gif = false;
+#endif
+    s_decode_buf = (uint16_t *)cache_alloc(frame_bytes);
+    if (!s_decode_buf ||
+        !echo_gif_frame_cache_init(&s_cache, frame_bytes, (size_t)CONFIG_ECHO_GIF_CACHE_BUDGET_KB * 1024,
+                                   CONFIG_ECHO_GIF_DECODE_AHEAD_FRAMES, whole_gif, cache_alloc, heap_caps_free)) {
+        ESP_LOGW(TAG, "decode-ahead cache alloc failed (frame=%u budget=%uKB); decoding synchronously",
+                 (unsigned)frame_bytes, (unsigned)CONFIG_ECHO_GIF_CACHE_BUDGET_KB);
+        heap_caps_free(s_decode_buf);
+        s_decode_buf = nullptr;
+        s_cache_failed = true;
+        return false;
+    }
+    s_decode_target.pixels = s_decode_buf;
+    s_cache_ok = true;
+    ESP_LOGI(TAG, "decode-ahead cache: frame=%u bytes, up to %d slot(s), whole_gif=%d",
+             (unsigned)frame_bytes, s_cache.max_slots, (int)whole_gif);
+    return true;
+}
+
+// Copies the next decoded frame into ctx's canvas, waiting for the decoder if
+// it is behind (counted as a miss by the cache).
+static int play_cached_frame(int *out_frame_delay_ms, EchoGifRenderCtx *ctx) {
+    const int64_t t0 = esp_timer_get_time();
+    const EchoGifCachedFrame *f = nullptr;
+    while (true) {
+        xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+        f = echo_gif_frame_cache_acquire(&s_cache);
+        xSemaphoreGive(s_cache_lock);
+        if (f) {
+            break;
+        }
+        if (xSemaphoreTake(s_frame_ready, pdMS_TO_TICKS(kDecodeWaitMs)) != pdTRUE) {
+            ESP_LOGW(TAG, "no frame decoded within %d ms", kDecodeWaitMs);
+            return -1;
+        }
+    }
+    const uint32_t waited_us = (uint32_t)(esp_timer_get_time() - t0);
+
+    size_t n = s_cache.frame_bytes;
+    if (n > ctx->canvas->bufferLength()) {
+        n = ctx->canvas->bufferLength();
+    }
+    memcpy(ctx->canvas->getBuffer(), f->pixels, n);
+    if (out_frame_delay_ms) {
+        *out_frame_delay_ms = f->delay_ms;
+    }
+
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    echo_gif_frame_cache_release(&s_cache);
+    s_wait_us_total += waited_us;
+    if (waited_us > s_wait_us_max) {
+        s_wait_us_max = waited_us;
+    }
+    xSemaphoreGive(s_cache_lock);
+    xTaskNotifyGive(s_decoder);
+    return 1;
+}
+#endif
 
 bool echo_gif_player_open_path(const char *path, EchoGifRenderCtx *ctx) {
     if (!path || !*path || !ctx) {
         return false;
     }
+    s_open_start_us = esp_timer_get_time();
+    s_open_us = 0;
+    s_first_frame_us = 0;
+
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+    const bool cached = cache_prepare(ctx);
+    if (cached) {
+        xSemaphoreTake(s_gif_lock, portMAX_DELAY);
+        s_decoding = false;
+        // Drop the previous GIF's frames now: if this open fails, playback must
+        // not keep replaying them.
+        xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+        echo_gif_frame_cache_reset(&s_cache);
+        xSemaphoreGive(s_cache_lock);
+    }
+#endif
 
     s_gif.close();
+    // Byte order is applied once when AnimatedGIF decodes each palette, not per pixel.
+#if CONFIG_ECHO_GIF_SWAP_BYTES
+    s_gif.begin(GIF_PALETTE_RGB565_BE);
+#else
     s_gif.begin(GIF_PALETTE_RGB565_LE);
+#endif
     s_current_gif_file_size = 0;
-    const int open_ok = s_gif.open(path, gif_open_cb, gif_close_cb, gif_read_cb, gif_seek_cb, GIFDraw);
+    const int open_ok = open_gif(path);
     if (!open_ok) {
         const int last_err = s_gif.getLastError();
         ESP_LOGE(TAG, "gif open failed: %s open_ok=%d last_error=%d", path, open_ok, last_err);
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+        if (cached) {
+            xSemaphoreGive(s_gif_lock);
+        }
+#endif
         return false;
     }
 
     snprintf(s_current_gif, sizeof(s_current_gif), "%s", path);
+    s_open_us = (uint32_t)(esp_timer_get_time() - s_open_start_us);
 
     ctx->gif_canvas_w = s_gif.getCanvasWidth();
     ctx->gif_canvas_h = s_gif.getCanvasHeight();
@@ -172,6 +422,15 @@ bool echo_gif_player_open_path(const char *path, EchoGifRenderCtx *ctx) {
     ctx->off_x = (scaled_w < ctx->canvas_w) ? ((ctx->canvas_w - scaled_w) / 2) : 0;
     ctx->off_y = (scaled_h < ctx->canvas_h) ? ((ctx->canvas_h - scaled_h) / 2) : 0;
 
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+    if (cached) {
+        s_decode_target = span_target(ctx, s_decode_target.pixels);
+        decoder_restart_locked();
+        xSemaphoreGive(s_gif_lock);
+        xTaskNotifyGive(s_decoder);
+    }
+#endif
+
     ESP_LOGI(TAG, "gif open ok: %s bytes=%u canvas=%dx%d frame=%dx%d off=(%d,%d)",
              path,
              (unsigned)s_current_gif_file_size,
@@ -197,8 +456,24 @@ int echo_gif_player_play_frame(int *out_frame_delay_ms, EchoGifRenderCtx *ctx) {
     if (out_frame_delay_ms) {
         *out_frame_delay_ms = 0;
     }
+    if (!ctx || !ctx->canvas) {
+        return -1;
+    }
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+    if (s_cache_ok) {
+        const int prc = play_cached_frame(out_frame_delay_ms, ctx);
+        if (prc > 0) {
+            note_first_frame();
+        }
+        return prc;
+    }
+#endif
     int frame_delay_ms = 0;
-    const int prc = s_gif.playFrame(false, &frame_delay_ms, ctx);
+    EchoGifSpanTarget target = span_target(ctx, (uint16_t *)ctx->canvas->getBuffer());
+    const int prc = s_gif.playFrame(false, &frame_delay_ms, &target);
+    if (prc > 0 || s_gif.getLastError() == GIF_SUCCESS) {
+        note_first_frame();
+    }
     if (out_frame_delay_ms) {
         *out_frame_delay_ms = frame_delay_ms;
     }
@@ -210,6 +485,19 @@ int echo_gif_player_last_error(void) {
 }
 
 void echo_gif_player_reset(void) {
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+    if (s_cache_ok) {
+        xSemaphoreTake(s_gif_lock, portMAX_DELAY);
+        const bool was_decoding = s_decoding || s_cache.complete;
+        s_gif.reset();
+        if (was_decoding) {
+            decoder_restart_locked();
+        }
+        xSemaphoreGive(s_gif_lock);
+        xTaskNotifyGive(s_decoder);
+        return;
+    }
+#endif
     s_gif.reset();
 }
 
@@ -246,3 +534,43 @@ int32_t echo_gif_player_current_file_size(void) {
 }
 
 
+
+bool echo_gif_player_cache_stats(EchoGifCacheStats *out) {
+    if (!out) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+#if CONFIG_ECHO_GIF_DECODE_AHEAD
+    if (!s_cache_ok) {
+        return false;
+    }
+    EchoGifFrameCacheStats st = {};
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    echo_gif_frame_cache_get_stats(&s_cache, &st);
+    out->wait_us_max = s_wait_us_max;
+    out->wait_us_total = s_wait_us_total;
+    xSemaphoreGive(s_cache_lock);
+    out->enabled = true;
+    out->decoded = st.decoded;
+    out->shown = st.shown;
+    out->replayed = st.replayed;
+    out->misses = st.misses;
+    out->evictions = st.evictions;
+    out->slots = st.slots;
+    out->max_slots = st.max_slots;
+    out->bytes = (uint32_t)st.bytes;
+    out->loop_frames = st.loop_frames;
+    out->complete = st.complete;
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t echo_gif_player_open_us(void) {
+    return s_open_us;
+}
+
+uint32_t echo_gif_player_first_frame_us(void) {
+    return s_first_frame_us;
+}
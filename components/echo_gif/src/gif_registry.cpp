@@ -1,5 +1,8 @@
 /*
  * echo_gif: GIF registry (scan configured directory into an in-memory list).
+ *
+ * With CONFIG_ECHO_GIF_STORAGE_PACK the registry is the pack index itself: no
+ * scan or copy, and names resolve through its hash table.
  */
 
 #include "echo_gif/gif_registry.h"
@@ -11,6 +14,29 @@
 
 #include "echo_gif/gif_storage.h"
 
+#if CONFIG_ECHO_GIF_STORAGE_PACK
+
+int echo_gif_registry_refresh(void) {
+    if (echo_gif_storage_mount() != ESP_OK) {
+        return 0;
+    }
+    return echo_gif_storage_pack_count();
+}
+
+int echo_gif_registry_count(void) {
+    return echo_gif_storage_pack_count();
+}
+
+const char *echo_gif_registry_path(int idx) {
+    return echo_gif_storage_pack_name(idx);
+}
+
+int echo_gif_registry_find_by_name(const char *name) {
+    return echo_gif_storage_pack_find(name);
+}
+
+#else
+
 static char s_gif_paths[CONFIG_ECHO_GIF_MAX_COUNT][CONFIG_ECHO_GIF_MAX_PATH_LEN];
 static int s_gif_count = 0;
 
@@ -32,12 +58,6 @@ const char *echo_gif_registry_path(int idx) {
     return s_gif_paths[idx];
 }
 
-const char *echo_gif_path_basename(const char *path) {
-    if (!path) return "";
-    const char *slash = strrchr(path, '/');
-    return slash ? (slash + 1) : path;
-}
-
 int echo_gif_registry_find_by_name(const char *name) {
     if (!name || !*name) return -1;
     for (int i = 0; i < s_gif_count; i++) {
@@ -57,4 +77,10 @@ int echo_gif_registry_find_by_name(const char *name) {
     return -1;
 }
 
+#endif // CONFIG_ECHO_GIF_STORAGE_PACK
 
+const char *echo_gif_path_basename(const char *path) {
+    if (!path) return "";
+    const char *slash = strrchr(path, '/');
+    return slash ? (slash + 1) : path;
+}
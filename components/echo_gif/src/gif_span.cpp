@@ -0,0 +1,259 @@
+/*
+ * echo_gif: span renderer for AnimatedGIF lines (see gif_span.h).
+ *
+ * The line is clipped once against the target: rows to [ya, yb), columns to
+ * [xa, xb), which maps back to source pixels [ia, ib) where only the first and
+ * last may be partly visible. Opaque runs are then written without bounds
+ * checks; for 1x/2x/3x scales two pixels go out per aligned 32-bit store. The
+ * first row is rendered, the other scale_y - 1 rows are memcpy'd from it (per
+ * opaque run when the line has transparency, so covered pixels stay as they
+ * were). Transparent runs are skipped a word at a time and opaque runs end at
+ * memchr() of the transparent index, instead of comparing every pixel.
+ */
+
+#include "gif_span.h"
+
+#include <string.h>
+
+namespace {
+
+struct LineCtx {
+    const uint8_t *src;
+    const uint16_t *pal;
+    int sx;
+    int x0; // target x of source pixel 0 (may be off-target)
+    int xa; // clipped target columns [xa, xb)
+    int xb;
+};
+
+inline uint32_t pack2(uint32_t first, uint32_t second) {
+    return first | (second << 16); // little-endian: first pixel at the lower address
+}
+
+// Writes n source pixels, each SX times, from p. Returns the end pointer.
+template <int SX>
+uint16_t *put_run(uint16_t *p, const uint8_t *s, int n, const uint16_t *pal);
+
+template <>
+uint16_t *put_run<1>(uint16_t *p, const uint8_t *s, int n, const uint16_t *pal) {
+    if (n > 0 && ((uintptr_t)p & 2)) {
+        *p++ = pal[*s++];
+        n--;
+    }
+    uint32_t *w = (uint32_t *)p;
+    for (; n >= 4; n -= 4, s += 4, w += 2) {
+        w[0] = pack2(pal[s[0]], pal[s[1]]);
+        w[1] = pack2(pal[s[2]], pal[s[3]]);
+    }
+    if (n >= 2) {
+        *w++ = pack2(pal[s[0]], pal[s[1]]);
+        s += 2;
+        n -= 2;
+    }
+    p = (uint16_t *)w;
+    if (n) {
+        *p++ = pal[*s];
+    }
+    return p;
+}
+
+template <>
+uint16_t *put_run<2>(uint16_t *p, const uint8_t *s, int n, const uint16_t *pal) {
+    if (n <= 0) {
+        return p;
+    }
+    if (!((uintptr_t)p & 2)) {
+        uint32_t *w = (uint32_t *)p;
+        for (; n >= 2; n -= 2, s += 2, w += 2) {
+            w[0] = pal[s[0]] * 0x10001u;
+            w[1] = pal[s[1]] * 0x10001u;
+        }
+        if (n) {
+            *w++ = pal[*s] * 0x10001u;
+        }
+        return (uint16_t *)w;
+    }
+    // Odd start: every word straddles two source pixels.
+    uint32_t prev = pal[*s++];
+    *p++ = (uint16_t)prev;
+    uint32_t *w = (uint32_t *)p;
+    for (n--; n > 0; n--) {
+        const uint32_t c = pal[*s++];
+        *w++ = pack2(prev, c);
+        prev = c;
+    }
+    p = (uint16_t *)w;
+    *p++ = (uint16_t)prev;
+    return p;
+}
+
+template <>
+uint16_t *put_run<3>(uint16_t *p, const uint8_t *s, int n, const uint16_t *pal) {
+    if (n <= 0) {
+        return p;
+    }
+    if ((uintptr_t)p & 2) {
+        // One pixel to align, the other two as a word; three is odd, so the
+        // next source pixel starts aligned.
+        const uint32_t c = pal[*s++];
+        *p++ = (uint16_t)c;
+        *(uint32_t *)p = c * 0x10001u;
+        p += 2;
+        n--;
+    }
+    uint32_t *w = (uint32_t *)p;
+    for (; n >= 2; n -= 2, s += 2, w += 3) {
+        const uint32_t a = pal[s[0]];
+        const uint32_t b = pal[s[1]];
+        w[0] = a * 0x10001u;
+        w[1] = pack2(a, b);
+        w[2] = b * 0x10001u;
+    }
+    p = (uint16_t *)w;
+    if (n) {
+        const uint32_t c = pal[*s];
+        *(uint32_t *)p = c * 0x10001u;
+        p[2] = (uint16_t)c;
+        p += 3;
+    }
+    return p;
+}
+
+uint16_t *put_run_n(uint16_t *p, const uint8_t *s, int n, const uint16_t *pal, int sx) {
+    for (; n > 0; n--) {
+        const uint16_t c = pal[*s++];
+        for (int k = 0; k < sx; k++) {
+            *p++ = c;
+        }
+    }
+    return p;
+}
+
+void fill(uint16_t *p, uint16_t c, int n) {
+    for (; n > 0; n--) {
+        *p++ = c;
+    }
+}
+
+// Source pixels [i, j), all opaque, into row. Only the first/last source pixel
+// of the visible range can be clipped; everything between is fully on target.
+void put_segment(const LineCtx &c, uint16_t *row, int i, int j) {
+    int x = c.x0 + i * c.sx;
+    if (x < c.xa) {
+        const int end = (x + c.sx < c.xb) ? (x + c.sx) : c.xb;
+        fill(row + c.xa, c.pal[c.src[i]], end - c.xa);
+        i++;
+        x += c.sx;
+    }
+    int full = j;
+    if (full > i && c.x0 + full * c.sx > c.xb) {
+        full--;
+    }
+    if (full > i) {
+        uint16_t *p = row + x;
+        const uint8_t *s = c.src + i;
+        const int n = full - i;
+        switch (c.sx) {
+            case 1:
+                put_run<1>(p, s, n, c.pal);
+                break;
+            case 2:
+                put_run<2>(p, s, n, c.pal);
+                break;
+            case 3:
+                put_run<3>(p, s, n, c.pal);
+                break;
+            default:
+                put_run_n(p, s, n, c.pal, c.sx);
+                break;
+        }
+    }
+    if (full < j && full >= i) {
+        const int xl = c.x0 + full * c.sx;
+        fill(row + xl, c.pal[c.src[full]], c.xb - xl);
+    }
+}
+
+// First index in [i, end) whose byte is not t.
+int skip_transparent(const uint8_t *s, int i, int end, uint8_t t) {
+    while (i < end && ((uintptr_t)(s + i) & 3)) {
+        if (s[i] != t) {
+            return i;
+        }
+        i++;
+    }
+    const uint32_t tt = t * 0x01010101u;
+    while (i + 4 <= end) {
+        uint32_t v;
+        memcpy(&v, s + i, 4);
+        if (v != tt) {
+            break;
+        }
+        i += 4;
+    }
+    while (i < end && s[i] == t) {
+        i++;
+    }
+    return i;
+}
+
+} // namespace
+
+void echo_gif_draw_line(const EchoGifSpanTarget *t, const GIFDRAW *pDraw) {
+    if (!t || !t->pixels || !pDraw || pDraw->iWidth <= 0) {
+        return;
+    }
+    const int sx = (t->scale_x > 0) ? t->scale_x : 1;
+    const int sy = (t->scale_y > 0) ? t->scale_y : 1;
+
+    const int y0 = t->off_y + (pDraw->iY + pDraw->y) * sy;
+    const int ya = (y0 > 0) ? y0 : 0;
+    const int yb = (y0 + sy < t->h) ? (y0 + sy) : t->h;
+    if (ya >= yb) {
+        return;
+    }
+
+    LineCtx c;
+    c.src = pDraw->pPixels;
+    c.pal = pDraw->pPalette;
+    c.sx = sx;
+    c.x0 = t->off_x + pDraw->iX * sx;
+    c.xa = (c.x0 > 0) ? c.x0 : 0;
+    c.xb = (c.x0 + pDraw->iWidth * sx < t->w) ? (c.x0 + pDraw->iWidth * sx) : t->w;
+    if (c.xa >= c.xb) {
+        return;
+    }
+    const int ia = (c.xa - c.x0) / sx;
+    const int ib = (c.xb - c.x0 + sx - 1) / sx;
+
+    uint16_t *row = t->pixels + ya * t->w;
+    const int extra_rows = yb - ya - 1;
+
+    if (!pDraw->ucHasTransparency) {
+        put_segment(c, row, ia, ib);
+        for (int r = 1; r <= extra_rows; r++) {
+            memcpy(row + r * t->w + c.xa, row + c.xa, (size_t)(c.xb - c.xa) * sizeof(uint16_t));
+        }
+        return;
+    }
+
+    const uint8_t tr = pDraw->ucTransparent;
+    int i = ia;
+    while (i < ib) {
+        i = skip_transparent(c.src, i, ib, tr);
+        if (i >= ib) {
+            break;
+        }
+        const uint8_t *hit = (const uint8_t *)memchr(c.src + i, tr, (size_t)(ib - i));
+        const int j = hit ? (int)(hit - c.src) : ib;
+        put_segment(c, row, i, j);
+        if (extra_rows) {
+            const int xs = (c.x0 + i * sx > c.xa) ? (c.x0 + i * sx) : c.xa;
+            const int xe = (c.x0 + j * sx < c.xb) ? (c.x0 + j * sx) : c.xb;
+            for (int r = 1; r <= extra_rows; r++) {
+                memcpy(row + r * t->w + xs, row + xs, (size_t)(xe - xs) * sizeof(uint16_t));
+            }
+        }
+        i = j;
+    }
+}
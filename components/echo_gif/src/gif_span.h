@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * echo_gif: span renderer for AnimatedGIF lines.
+ *
+ * Writes one GIFDRAW line into an RGB565 canvas with integer nearest-neighbor
+ * scaling. Plain C++ with no M5GFX/ESP-IDF dependency so it builds on the host
+ * (components/echo_gif/tools/span_host).
+ */
+
+#include <stdint.h>
+
+#include "AnimatedGIF.h"
+
+typedef struct {
+    uint16_t *pixels; // w * h RGB565, row-major
+    int w;
+    int h;
+    int scale_x;
+    int scale_y;
+    int off_x; // where GIF canvas (0,0) lands on the target
+    int off_y;
+} EchoGifSpanTarget;
+
+// Draws pDraw's line, scale_y rows tall. Palette entries are stored as they
+// are; byte order is chosen when AnimatedGIF decodes the palette
+// (GIF_PALETTE_RGB565_BE/LE). Transparent pixels leave the target untouched.
+void echo_gif_draw_line(const EchoGifSpanTarget *t, const GIFDRAW *pDraw);
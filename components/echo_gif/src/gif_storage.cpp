@@ -3,17 +3,170 @@
 #include <dirent.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "sdkconfig.h"
 
 #include "esp_log.h"
+#include "esp_partition.h"
 #include "esp_vfs_fat.h"
 
+#include "gif_pack.h"
+
 static const char *TAG = "echo_gif_storage";
 
 static bool s_mounted = false;
 
+#if CONFIG_ECHO_GIF_STORAGE_PACK
+// Packed assets: the index (header, entries, hash buckets, names) stays mapped;
+// each GIF is mapped on open by echo_gif_storage_pack_map().
+static const esp_partition_t *s_part = nullptr;
+static esp_partition_mmap_handle_t s_index_map = 0;
+static EchoGifPack s_pack = {};
+
+esp_err_t echo_gif_storage_mount(void) {
+    if (s_mounted) {
+        return ESP_OK;
+    }
+
+    s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                      CONFIG_ECHO_GIF_STORAGE_PARTITION_LABEL);
+    if (!s_part) {
+        ESP_LOGE(TAG, "partition not found: %s", CONFIG_ECHO_GIF_STORAGE_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    EchoGifPackHeader hdr = {};
+    esp_err_t err = esp_partition_read(s_part, 0, &hdr, sizeof(hdr));
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (memcmp(hdr.magic, ECHO_GIF_PACK_MAGIC, 4) != 0) {
+        ESP_LOGE(TAG, "partition %s is not a GIF pack (flash the make_storage_pack.sh image)", s_part->label);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (hdr.total_size > s_part->size || hdr.index_size < sizeof(hdr)) {
+        ESP_LOGE(TAG, "GIF pack size %u does not fit partition (%u bytes)", (unsigned)hdr.total_size,
+                 (unsigned)s_part->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const void *index = nullptr;
+    err = esp_partition_mmap(s_part, 0, hdr.index_size, ESP_PARTITION_MMAP_DATA, &index, &s_index_map);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "index mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    if (!echo_gif_pack_open(&s_pack, (const uint8_t *)index, hdr.index_size)) {
+        ESP_LOGE(TAG, "GIF pack index is invalid (version %u)", (unsigned)hdr.version);
+        esp_partition_munmap(s_index_map);
+        s_index_map = 0;
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    s_mounted = true;
+    ESP_LOGI(TAG, "GIF pack ok: partition=%s entries=%d index=%u bytes total=%u bytes", s_part->label,
+             echo_gif_pack_count(&s_pack), (unsigned)hdr.index_size, (unsigned)hdr.total_size);
+    return ESP_OK;
+}
+
+int echo_gif_storage_list_gifs(char *out_paths, int max_paths, int max_path_len) {
+    if (!out_paths || max_paths <= 0 || max_path_len <= 0) {
+        return 0;
+    }
+    if (echo_gif_storage_mount() != ESP_OK) {
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < echo_gif_pack_count(&s_pack) && count < max_paths; i++) {
+        char *dst = out_paths + (count * max_path_len);
+        const int wrote = snprintf(dst, (size_t)max_path_len, "%s", echo_gif_pack_name(&s_pack, i));
+        if (wrote <= 0 || wrote >= max_path_len) {
+            ESP_LOGW(TAG, "name too long, skipping: %s", echo_gif_pack_name(&s_pack, i));
+            continue;
+        }
+        count++;
+    }
+    return count;
+}
+
+int echo_gif_storage_pack_count(void) {
+    return s_mounted ? echo_gif_pack_count(&s_pack) : 0;
+}
+
+const char *echo_gif_storage_pack_name(int idx) {
+    return s_mounted ? echo_gif_pack_name(&s_pack, idx) : nullptr;
+}
+
+int echo_gif_storage_pack_find(const char *name) {
+    return s_mounted ? echo_gif_pack_find(&s_pack, name) : -1;
+}
+
+esp_err_t echo_gif_storage_pack_map(int idx, EchoGifAsset *out) {
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+    const EchoGifPackEntry *e = s_mounted ? echo_gif_pack_entry(&s_pack, idx) : nullptr;
+    if (!e || e->data_size == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    // esp_partition_mmap rounds the start down to an MMU page and offsets the
+    // returned pointer, so GIFs need no page alignment in the pack.
+    const void *p = nullptr;
+    esp_partition_mmap_handle_t handle = 0;
+    const esp_err_t err = esp_partition_mmap(s_part, e->data_offset, e->data_size, ESP_PARTITION_MMAP_DATA, &p,
+                                             &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "mmap failed: %s (%s)", echo_gif_pack_name(&s_pack, idx), esp_err_to_name(err));
+        return err;
+    }
+    out->data = (const uint8_t *)p;
+    out->size = e->data_size;
+    out->canvas_w = e->canvas_w;
+    out->canvas_h = e->canvas_h;
+    out->frame_count = e->frame_count;
+    out->duration_ms = e->duration_ms;
+    out->map_handle = (uint32_t)handle;
+    return ESP_OK;
+}
+
+void echo_gif_storage_pack_unmap(EchoGifAsset *asset) {
+    if (!asset || !asset->data) {
+        return;
+    }
+    esp_partition_munmap((esp_partition_mmap_handle_t)asset->map_handle);
+    memset(asset, 0, sizeof(*asset));
+}
+
+esp_err_t echo_gif_storage_read_file(const char *path, uint8_t **out_buf, size_t *out_len) {
+    if (!path || !out_buf || !out_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_buf = nullptr;
+    *out_len = 0;
+
+    EchoGifAsset asset = {};
+    esp_err_t err = echo_gif_storage_pack_map(echo_gif_storage_pack_find(path), &asset);
+    if (err != ESP_OK) {
+        return err;
+    }
+    uint8_t *buf = (uint8_t *)malloc(asset.size);
+    if (!buf) {
+        echo_gif_storage_pack_unmap(&asset);
+        ESP_LOGE(TAG, "malloc failed for %u bytes", (unsigned)asset.size);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(buf, asset.data, asset.size);
+    *out_len = asset.size;
+    *out_buf = buf;
+    echo_gif_storage_pack_unmap(&asset);
+    return ESP_OK;
+}
+
+#else // FATFS
+
 esp_err_t echo_gif_storage_mount(void) {
     if (s_mounted) {
         return ESP_OK;
@@ -153,6 +306,29 @@ esp_err_t echo_gif_storage_read_file(const char *path, uint8_t **out_buf, size_t
     return ESP_OK;
 }
 
+int echo_gif_storage_pack_count(void) {
+    return 0;
+}
+
+const char *echo_gif_storage_pack_name(int) {
+    return nullptr;
+}
+
+int echo_gif_storage_pack_find(const char *) {
+    return -1;
+}
+
+esp_err_t echo_gif_storage_pack_map(int, EchoGifAsset *out) {
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void echo_gif_storage_pack_unmap(EchoGifAsset *) {}
+
+#endif // CONFIG_ECHO_GIF_STORAGE_PACK
+
 void echo_gif_storage_free(uint8_t *buf) {
     free(buf);
 }
@@ -0,0 +1,388 @@
+/*
+ * Host test for the echo_gif decode-ahead frame cache (src/frame_cache.cpp).
+ *
+ * Drives the cache the way gif_player.cpp does (decoder: begin_write, fill,
+ * commit, end_of_gif at the last frame; reader: acquire, check, release) with a
+ * fake GIF whose frames are stamped with their index. Checks ordering, ring
+ * limits, whole-GIF caching and replay, eviction/miss counters, budget and
+ * allocation failures, reset and restart after a decode error. Prints JSONL.
+ *
+ * Built and run by tools/cache_host/run_cache_host.sh. Exits non-zero on failure.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frame_cache.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+static const size_t kFrameBytes = 16 * 16 * sizeof(uint16_t);
+
+// Allocator with an optional limit on the number of live allocations.
+static int g_live_allocs;
+static int g_alloc_limit = -1;
+
+static void *test_alloc(size_t bytes) {
+    if (g_alloc_limit >= 0 && g_live_allocs >= g_alloc_limit) {
+        return nullptr;
+    }
+    g_live_allocs++;
+    return malloc(bytes);
+}
+
+static void test_free(void *p) {
+    if (p) {
+        g_live_allocs--;
+    }
+    free(p);
+}
+
+// Fake GIF: frame i has delay 10 + i and every pixel stamped i.
+typedef struct {
+    int frames;
+    int next;
+} FakeGif;
+
+static int frame_delay(int i) {
+    return 10 + i;
+}
+
+// One decoder step. Returns false if the cache would not take a frame.
+static bool decode_step(EchoGifFrameCache *c, FakeGif *g, bool *complete) {
+    uint16_t *dst = echo_gif_frame_cache_begin_write(c);
+    if (!dst) {
+        return false;
+    }
+    const int i = g->next;
+    for (size_t k = 0; k < kFrameBytes / sizeof(uint16_t); k++) {
+        dst[k] = (uint16_t)i;
+    }
+    echo_gif_frame_cache_commit_write(c, frame_delay(i));
+    g->next = (i + 1) % g->frames;
+    if (g->next == 0) {
+        *complete = echo_gif_frame_cache_end_of_gif(c);
+    }
+    return true;
+}
+
+// One reader step. Returns the frame index shown, or -1 on a miss, or -2 if the
+// frame content does not match its delay.
+static int read_step(EchoGifFrameCache *c) {
+    const EchoGifCachedFrame *f = echo_gif_frame_cache_acquire(c);
+    if (!f) {
+        return -1;
+    }
+    const int i = f->pixels[0];
+    int ok = (f->delay_ms == frame_delay(i));
+    for (size_t k = 0; k < kFrameBytes / sizeof(uint16_t); k++) {
+        ok &= (f->pixels[k] == (uint16_t)i);
+    }
+    echo_gif_frame_cache_release(c);
+    return ok ? i : -2;
+}
+
+static void test_ring_ahead(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 64 * kFrameBytes, 4, false, test_alloc, test_free));
+    CHECK(c.max_slots == 4);
+    CHECK(c.allocated == 2);
+
+    FakeGif g = {10, 0};
+    bool complete = false;
+    int n = 0;
+    while (decode_step(&c, &g, &complete)) {
+        n++;
+    }
+    CHECK(n == 4); // decoder stops N frames ahead
+    CHECK(c.allocated == 4);
+
+    // Steady state: one in, one out, across three loops.
+    for (int k = 0; k < 30; k++) {
+        CHECK(read_step(&c) == k % 10);
+        CHECK(decode_step(&c, &g, &complete));
+        CHECK(!complete);
+    }
+    EchoGifFrameCacheStats st;
+    echo_gif_frame_cache_get_stats(&c, &st);
+    CHECK(st.decoded == 34);
+    CHECK(st.shown == 30);
+    CHECK(st.evictions == 30);
+    CHECK(st.misses == 0);
+    CHECK(st.loop_frames == 10);
+    CHECK(!st.complete);
+    CHECK(st.bytes == 4 * kFrameBytes);
+
+    echo_gif_frame_cache_deinit(&c);
+    CHECK(g_live_allocs == 0);
+    printf("{\"test\":\"ring_ahead\",\"decoded\":%u,\"shown\":%u,\"evictions\":%u}\n",
+           (unsigned)st.decoded, (unsigned)st.shown, (unsigned)st.evictions);
+}
+
+static void test_whole_gif_replay(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 8 * kFrameBytes, 2, true, test_alloc, test_free));
+    CHECK(c.max_slots == 8);
+
+    FakeGif g = {6, 0};
+    bool complete = false;
+    // Interleave: the reader starts while the first loop is still decoding.
+    CHECK(decode_step(&c, &g, &complete));
+    CHECK(read_step(&c) == 0);
+    while (decode_step(&c, &g, &complete)) {
+    }
+    CHECK(complete);
+    CHECK(c.allocated == 6); // grown on demand, not to the budget
+
+    for (int k = 1; k < 6 * 4; k++) {
+        CHECK(read_step(&c) == k % 6);
+        bool dummy = false;
+        CHECK(!decode_step(&c, &g, &dummy)); // nothing left to decode
+    }
+    EchoGifFrameCacheStats st;
+    echo_gif_frame_cache_get_stats(&c, &st);
+    CHECK(st.decoded == 6);
+    CHECK(st.shown == 24);
+    CHECK(st.replayed == 18);
+    CHECK(st.evictions == 0);
+    CHECK(st.loop_frames == 6);
+    CHECK(st.complete);
+
+    echo_gif_frame_cache_deinit(&c);
+    CHECK(g_live_allocs == 0);
+    printf("{\"test\":\"whole_gif_replay\",\"frames\":6,\"decoded\":%u,\"shown\":%u,\"replayed\":%u}\n",
+           (unsigned)st.decoded, (unsigned)st.shown, (unsigned)st.replayed);
+}
+
+static void test_whole_gif_over_budget(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 8 * kFrameBytes + kFrameBytes / 2, 2, true, test_alloc,
+                                    test_free));
+    CHECK(c.max_slots == 8);
+
+    FakeGif g = {12, 0};
+    bool complete = false;
+    for (int k = 0; k < 36; k++) {
+        while (decode_step(&c, &g, &complete)) {
+        }
+        CHECK(read_step(&c) == k % 12);
+    }
+    CHECK(!complete);
+    EchoGifFrameCacheStats st;
+    echo_gif_frame_cache_get_stats(&c, &st);
+    CHECK(st.slots == 8);
+    CHECK(st.bytes == 8 * kFrameBytes);
+    CHECK(st.loop_frames == 12);
+    CHECK(!st.complete);
+    CHECK(st.evictions == st.decoded - 8);
+    CHECK(st.replayed == 0);
+
+    echo_gif_frame_cache_deinit(&c);
+    printf("{\"test\":\"whole_gif_over_budget\",\"frames\":12,\"slots\":%d,\"evictions\":%u}\n", st.slots,
+           (unsigned)st.evictions);
+}
+
+static void test_misses(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 3 * kFrameBytes, 3, false, test_alloc, test_free));
+
+    FakeGif g = {5, 0};
+    bool complete = false;
+    // Reader polls three times before the decoder delivers: one miss.
+    CHECK(read_step(&c) == -1);
+    CHECK(read_step(&c) == -1);
+    CHECK(read_step(&c) == -1);
+    CHECK(decode_step(&c, &g, &complete));
+    CHECK(read_step(&c) == 0);
+    CHECK(read_step(&c) == -1);
+    CHECK(decode_step(&c, &g, &complete));
+    CHECK(read_step(&c) == 1);
+    CHECK(decode_step(&c, &g, &complete));
+    CHECK(read_step(&c) == 2);
+
+    EchoGifFrameCacheStats st;
+    echo_gif_frame_cache_get_stats(&c, &st);
+    CHECK(st.misses == 2);
+    CHECK(st.shown == 3);
+
+    echo_gif_frame_cache_deinit(&c);
+    printf("{\"test\":\"misses\",\"misses\":%u}\n", (unsigned)st.misses);
+}
+
+static void test_budget_and_alloc_failure(void) {
+    EchoGifFrameCache c;
+    // Less than two frames of budget: no cache.
+    CHECK(!echo_gif_frame_cache_init(&c, kFrameBytes, kFrameBytes + 1, 4, true, test_alloc, test_free));
+    CHECK(g_live_allocs == 0);
+
+    // Slot table + one frame: init cannot get its two frames.
+    g_alloc_limit = 2;
+    CHECK(!echo_gif_frame_cache_init(&c, kFrameBytes, 16 * kFrameBytes, 4, true, test_alloc, test_free));
+    CHECK(g_live_allocs == 0);
+
+    // Slot table + five frames, budget for sixteen: clamps to five and keeps going.
+    g_alloc_limit = 6;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 16 * kFrameBytes, 4, true, test_alloc, test_free));
+    FakeGif g = {9, 0};
+    bool complete = false;
+    int n = 0;
+    while (decode_step(&c, &g, &complete)) {
+        n++;
+    }
+    CHECK(n == 5);
+    CHECK(c.max_slots == 5);
+    for (int k = 0; k < 27; k++) {
+        CHECK(read_step(&c) == k % 9);
+        CHECK(decode_step(&c, &g, &complete));
+    }
+    CHECK(!complete);
+    g_alloc_limit = -1;
+    echo_gif_frame_cache_deinit(&c);
+    CHECK(g_live_allocs == 0);
+    printf("{\"test\":\"budget_and_alloc_failure\",\"clamped_slots\":5}\n");
+}
+
+static void test_reset(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 8 * kFrameBytes, 8, true, test_alloc, test_free));
+
+    FakeGif g = {3, 0};
+    bool complete = false;
+    while (decode_step(&c, &g, &complete)) {
+    }
+    CHECK(complete);
+    CHECK(read_step(&c) == 0);
+
+    // New GIF: nothing to show until decoded, and it can be cached again.
+    echo_gif_frame_cache_reset(&c);
+    CHECK(read_step(&c) == -1);
+    FakeGif g2 = {4, 0};
+    complete = false;
+    while (decode_step(&c, &g2, &complete)) {
+    }
+    CHECK(complete);
+    for (int k = 0; k < 8; k++) {
+        CHECK(read_step(&c) == k % 4);
+    }
+    CHECK(c.allocated == 4);
+    echo_gif_frame_cache_deinit(&c);
+    printf("{\"test\":\"reset\",\"ok\":true}\n");
+}
+
+static void test_restart_after_decode_error(void) {
+    EchoGifFrameCache c;
+    CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, 8 * kFrameBytes, 8, true, test_alloc, test_free));
+
+    FakeGif g = {5, 0};
+    bool complete = false;
+    for (int k = 0; k < 3; k++) {
+        CHECK(decode_step(&c, &g, &complete));
+    }
+    CHECK(read_step(&c) == 0);
+    // The reader holds frame 1 while the decoder fails and starts over.
+    const EchoGifCachedFrame *held = echo_gif_frame_cache_acquire(&c);
+    CHECK(held && held->pixels[0] == 1);
+    echo_gif_frame_cache_restart(&c);
+    g.next = 0;
+    CHECK(held->pixels[0] == 1);
+    echo_gif_frame_cache_release(&c);
+
+    // Frame 2 from before the error is gone; playback continues from the restart.
+    while (decode_step(&c, &g, &complete)) {
+    }
+    CHECK(!complete);
+    for (int k = 0; k < 12; k++) {
+        const int i = read_step(&c);
+        if (i == -1) {
+            CHECK(decode_step(&c, &g, &complete));
+            k--;
+            continue;
+        }
+        CHECK(i == k % 5);
+    }
+    CHECK(!c.complete);
+
+    // The next GIF can be cached whole again.
+    echo_gif_frame_cache_reset(&c);
+    FakeGif g2 = {3, 0};
+    while (decode_step(&c, &g2, &complete)) {
+    }
+    CHECK(complete);
+    echo_gif_frame_cache_deinit(&c);
+    CHECK(g_live_allocs == 0);
+    printf("{\"test\":\"restart_after_decode_error\",\"ok\":true}\n");
+}
+
+// Random interleavings of decoder/reader steps over many configurations; the
+// reader must always see frames 0..F-1 in order, intact.
+static void test_random_interleaving(void) {
+    uint32_t rng = 0x9e3779b9u;
+    auto rnd = [&rng]() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    };
+    int runs = 0, completed = 0;
+    for (int iter = 0; iter < 500; iter++) {
+        const int frames = 1 + (int)(rnd() % 20);
+        const int budget_slots = 2 + (int)(rnd() % 14);
+        const int ahead = 2 + (int)(rnd() % 6);
+        const bool whole = rnd() & 1;
+        EchoGifFrameCache c;
+        CHECK(echo_gif_frame_cache_init(&c, kFrameBytes, (size_t)budget_slots * kFrameBytes, ahead, whole, test_alloc,
+                                        test_free));
+        FakeGif g = {frames, 0};
+        bool complete = false;
+        int expect = 0;
+        const int bias = 20 + (int)(rnd() % 60);
+        for (int step = 0; step < 400; step++) {
+            if ((int)(rnd() % 100) < bias) {
+                decode_step(&c, &g, &complete);
+            } else {
+                const int r = read_step(&c);
+                CHECK(r != -2);
+                if (r >= 0) {
+                    CHECK(r == expect);
+                    expect = (expect + 1) % frames;
+                }
+            }
+        }
+        const int slots = whole ? budget_slots : (ahead < budget_slots ? ahead : budget_slots);
+        CHECK(complete == (c.loop_frames > 0 && frames <= slots));
+        CHECK(c.allocated <= slots);
+        completed += complete ? 1 : 0;
+        runs++;
+        echo_gif_frame_cache_deinit(&c);
+        CHECK(g_live_allocs == 0);
+    }
+    printf("{\"test\":\"random_interleaving\",\"runs\":%d,\"fully_cached\":%d}\n", runs, completed);
+}
+
+int main(void) {
+    test_ring_ahead();
+    test_whole_gif_replay();
+    test_whole_gif_over_budget();
+    test_misses();
+    test_budget_and_alloc_failure();
+    test_reset();
+    test_restart_after_decode_error();
+    test_random_interleaving();
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the echo_gif decode-ahead cache host test.
+#
+# src/frame_cache.cpp is plain C++ (no FreeRTOS/ESP-IDF), so it builds as is.
+# Prints JSONL.
+#
+# Usage:
+#   ./tools/cache_host/run_cache_host.sh
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SRC_DIR="${HERE}/../../src"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/echo-gif-cache-host}"
+CXX="${CXX:-c++}"
+CFLAGS="${CFLAGS:--O1 -g -Wall -Wextra}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} -I"${SRC_DIR}" \
+  -o "${BUILD_DIR}/cache_host_test" \
+  "${HERE}/cache_host_test.cpp" "${SRC_DIR}/frame_cache.cpp"
+"${BUILD_DIR}/cache_host_test"
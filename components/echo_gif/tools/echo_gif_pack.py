@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""Pack GIF files into an echo_gif asset image ("EGPK", see src/gif_pack.h).
+
+The image is flashed into the storage partition in place of a FATFS image and
+read by the firmware through esp_partition_mmap (CONFIG_ECHO_GIF_STORAGE_PACK).
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"EGPK"
+VERSION = 1
+HEADER = struct.Struct("<4sHHIIIIIII")
+ENTRY = struct.Struct("<IIIIHHHHI")
+
+
+def stem(name: str) -> str:
+    if len(name) > 4 and name[-4:].lower() == ".gif":
+        return name[:-4]
+    return name
+
+
+def fnv1a(name: str) -> int:
+    h = 2166136261
+    for b in name.encode("utf-8").lower():  # ASCII-only, like the firmware
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def skip_sub_blocks(data: bytes, pos: int) -> int:
+    while True:
+        n = data[pos]
+        pos += 1
+        if n == 0:
+            return pos
+        pos += n
+
+
+def gif_info(data: bytes) -> tuple[int, int, int, int]:
+    """Returns (canvas_w, canvas_h, frame_count, duration_ms) for one loop."""
+    if data[:6] not in (b"GIF87a", b"GIF89a"):
+        raise ValueError("not a GIF")
+    w, h, packed = struct.unpack_from("<HHB", data, 6)
+    pos = 13
+    if packed & 0x80:
+        pos += 3 << ((packed & 7) + 1)
+    frames = 0
+    duration = 0
+    delay_cs = 0
+    while pos < len(data):
+        tag = data[pos]
+        pos += 1
+        if tag == 0x3B:
+            break
+        if tag == 0x21:
+            label = data[pos]
+            pos += 1
+            if label == 0xF9 and data[pos] >= 4:
+                delay_cs = struct.unpack_from("<H", data, pos + 2)[0]
+            pos = skip_sub_blocks(data, pos)
+        elif tag == 0x2C:
+            ipacked = data[pos + 8]
+            pos += 9
+            if ipacked & 0x80:
+                pos += 3 << ((ipacked & 7) + 1)
+            pos += 1  # LZW minimum code size
+            pos = skip_sub_blocks(data, pos)
+            frames += 1
+            duration += delay_cs * 10
+            delay_cs = 0
+        else:
+            raise ValueError(f"unexpected block 0x{tag:02x} at {pos - 1}")
+    if frames == 0:
+        raise ValueError("no frames")
+    return w, h, frames, duration
+
+
+def collect(inputs: list[str]) -> list[str]:
+    paths = []
+    for p in inputs:
+        if os.path.isdir(p):
+            for name in sorted(os.listdir(p)):
+                full = os.path.join(p, name)
+                if not name.startswith(".") and name.lower().endswith(".gif") and os.path.isfile(full):
+                    paths.append(full)
+        else:
+            paths.append(p)
+    return paths
+
+
+def align(n: int, a: int) -> int:
+    return (n + a - 1) & ~(a - 1)
+
+
+def pack(paths: list[str]) -> bytes:
+    assets = []
+    seen = {}
+    for path in paths:
+        name = os.path.basename(path)
+        key = stem(name).lower()
+        if key in seen:
+            raise ValueError(f"{name}: same name as {seen[key]} (names are case-insensitive)")
+        seen[key] = name
+        with open(path, "rb") as f:
+            data = f.read()
+        try:
+            info = gif_info(data)
+        except (ValueError, IndexError, struct.error) as e:
+            raise ValueError(f"{path}: {e}") from None
+        assets.append((name, data, info))
+    assets.sort(key=lambda a: a[0].lower())
+
+    n = len(assets)
+    if n > 0xFFFE:
+        raise ValueError("too many GIFs")
+    bucket_count = 2
+    while bucket_count < 2 * n:
+        bucket_count *= 2
+
+    entries_offset = align(HEADER.size, 4)
+    buckets_offset = entries_offset + n * ENTRY.size
+    names_offset = buckets_offset + bucket_count * 2
+    names = b""
+    name_offsets = []
+    for name, _, _ in assets:
+        name_offsets.append(names_offset + len(names))
+        names += name.encode("utf-8") + b"\0"
+    index_size = align(names_offset + len(names), 4)
+
+    data_offsets = []
+    pos = index_size
+    for _, data, _ in assets:
+        data_offsets.append(pos)
+        pos = align(pos + len(data), 4)
+    total_size = pos
+
+    buckets = [0] * bucket_count
+    hashes = []
+    for i, (name, _, _) in enumerate(assets):
+        h = fnv1a(stem(name))
+        hashes.append(h)
+        b = h & (bucket_count - 1)
+        while buckets[b]:
+            b = (b + 1) & (bucket_count - 1)
+        buckets[b] = i + 1
+
+    out = bytearray(total_size)
+    HEADER.pack_into(out, 0, MAGIC, VERSION, ENTRY.size, n, bucket_count, entries_offset, buckets_offset,
+                     names_offset, index_size, total_size)
+    for i, (name, data, (w, h, frames, duration)) in enumerate(assets):
+        ENTRY.pack_into(out, entries_offset + i * ENTRY.size, hashes[i], name_offsets[i], data_offsets[i], len(data),
+                        w, h, min(frames, 0xFFFF), 0, duration)
+        out[data_offsets[i]:data_offsets[i] + len(data)] = data
+    struct.pack_into(f"<{bucket_count}H", out, buckets_offset, *buckets)
+    out[names_offset:names_offset + len(names)] = names
+    return bytes(out)
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Pack GIFs into an echo_gif EGPK storage image.")
+    ap.add_argument("inputs", nargs="+", help="GIF files and/or directories (scanned non-recursively for *.gif)")
+    ap.add_argument("-o", "--output", required=True, help="Output image path")
+    ap.add_argument("--partition-size", type=lambda s: int(s, 0), default=0,
+                    help="Fail if the image does not fit (bytes, e.g. 0x5F0000)")
+    args = ap.parse_args()
+
+    paths = collect(args.inputs)
+    try:
+        image = pack(paths)
+    except ValueError as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+    if args.partition_size and len(image) > args.partition_size:
+        print(f"ERROR: image is {len(image)} bytes, partition is {args.partition_size}", file=sys.stderr)
+        return 1
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print(f"echo_gif_pack: {len(paths)} GIF(s), {len(image)} bytes -> {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
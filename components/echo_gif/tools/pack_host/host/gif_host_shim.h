@@ -0,0 +1,14 @@
+#pragma once
+
+// AnimatedGIF.cpp uses Arduino's millis()/delay() in playFrame(bSync=true).
+// The host test only calls playFrame(false, ...), so these just have to exist.
+
+#include <time.h>
+
+static inline long millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static inline void delay(long) {}
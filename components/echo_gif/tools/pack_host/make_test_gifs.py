@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Writes small animated GIFs for the pack round-trip test (no PIL needed).
+
+Frames use an 8-bit palette with uncompressed LZW (a clear code every 250
+literals keeps the code width at 9 bits), which every decoder accepts.
+"""
+
+import os
+import random
+import struct
+import sys
+
+
+def lzw_uncompressed(pixels: bytes) -> bytes:
+    clear, eoi = 256, 257
+    codes = []
+    for i, p in enumerate(pixels):
+        if i % 250 == 0:
+            codes.append(clear)
+        codes.append(p)
+    codes.append(eoi)
+    out = bytearray()
+    acc = nbits = 0
+    for c in codes:
+        acc |= c << nbits
+        nbits += 9
+        while nbits >= 8:
+            out.append(acc & 0xFF)
+            acc >>= 8
+            nbits -= 8
+    if nbits:
+        out.append(acc & 0xFF)
+    return bytes(out)
+
+
+def sub_blocks(data: bytes) -> bytes:
+    out = bytearray()
+    for i in range(0, len(data), 255):
+        chunk = data[i:i + 255]
+        out.append(len(chunk))
+        out += chunk
+    out.append(0)
+    return bytes(out)
+
+
+def make_gif(rng: random.Random, w: int, h: int, frames: int) -> tuple[bytes, int]:
+    out = bytearray(b"GIF89a")
+    out += struct.pack("<HHBBB", w, h, 0xF7, 0, 0)  # global table, 256 colors
+    out += bytes(rng.randrange(256) for _ in range(256 * 3))
+    out += b"\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00"  # loop forever
+    duration = 0
+    for f in range(frames):
+        delay_cs = rng.randrange(2, 20)
+        duration += delay_cs * 10
+        out += struct.pack("<BBBBHBB", 0x21, 0xF9, 4, 0x04, delay_cs, 0, 0)
+        fw = w if f == 0 else rng.randrange(1, w + 1)
+        fh = h if f == 0 else rng.randrange(1, h + 1)
+        fx = 0 if f == 0 else rng.randrange(0, w - fw + 1)
+        fy = 0 if f == 0 else rng.randrange(0, h - fh + 1)
+        out += struct.pack("<BHHHHB", 0x2C, fx, fy, fw, fh, 0)
+        out.append(8)  # LZW minimum code size
+        run = rng.randrange(1, 9)
+        pixels = bytes((i // run + f) & 0xFF for i in range(fw * fh))
+        out += sub_blocks(lzw_uncompressed(pixels))
+    out.append(0x3B)
+    return bytes(out), duration
+
+
+def main() -> int:
+    out_dir = sys.argv[1]
+    count = int(sys.argv[2]) if len(sys.argv) > 2 else 8
+    max_side = int(sys.argv[3]) if len(sys.argv) > 3 else 128
+    os.makedirs(out_dir, exist_ok=True)
+    rng = random.Random(0x6966 + count)
+    with open(os.path.join(out_dir, "manifest.txt"), "w") as m:
+        for i in range(count):
+            name = f"{'Anim' if i % 3 == 0 else 'anim'}_{i:04d}.{'GIF' if i % 5 == 0 else 'gif'}"
+            w = rng.randrange(1, max_side + 1)
+            h = rng.randrange(1, max_side + 1)
+            frames = rng.randrange(1, 12)
+            data, duration = make_gif(rng, w, h, frames)
+            with open(os.path.join(out_dir, name), "wb") as f:
+                f.write(data)
+            m.write(f"{name} {w} {h} {frames} {duration}\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
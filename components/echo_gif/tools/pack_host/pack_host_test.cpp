@@ -0,0 +1,355 @@
+/*
+ * Host round-trip test for the echo_gif packed asset format (src/gif_pack.cpp,
+ * tools/echo_gif_pack.py).
+ *
+ * run_pack_host.sh generates GIFs (make_test_gifs.py), packs them with
+ * echo_gif_pack.py, then this program checks that:
+ * - every GIF is found by name (any case, with or without ".gif" or a
+ *   directory) and its bytes, canvas size, frame count and duration match;
+ * - AnimatedGIF decodes every frame straight from the mapped pack;
+ * - unknown names miss and corrupted images are rejected.
+ * It also reports lookup cost (hash index vs the registry's linear scan) and
+ * open-to-first-frame time: stdio callbacks as used for FATFS vs the in-place
+ * memory open used for packs. On the host both sides hit the page cache, so
+ * the device numbers (logged by gif_player.cpp) are the ones that matter.
+ * Prints JSONL.
+ *
+ * Usage: pack_host_test <gif_dir> <pack.bin> <many_gif_dir> <many_pack.bin>
+ */
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "AnimatedGIF.h"
+#include "gif_pack.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+typedef struct {
+    std::string name;
+    int w, h, frames;
+    uint32_t duration_ms;
+} ManifestEntry;
+
+static std::vector<ManifestEntry> read_manifest(const std::string &dir) {
+    std::vector<ManifestEntry> out;
+    FILE *f = fopen((dir + "/manifest.txt").c_str(), "r");
+    if (!f) {
+        return out;
+    }
+    char name[256];
+    ManifestEntry e;
+    unsigned dur = 0;
+    while (fscanf(f, "%255s %d %d %d %u", name, &e.w, &e.h, &e.frames, &dur) == 5) {
+        e.name = name;
+        e.duration_ms = dur;
+        out.push_back(e);
+    }
+    fclose(f);
+    return out;
+}
+
+static std::vector<uint8_t> read_file(const std::string &path) {
+    std::vector<uint8_t> buf;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return buf;
+    }
+    fseek(f, 0, SEEK_END);
+    buf.resize((size_t)ftell(f));
+    fseek(f, 0, SEEK_SET);
+    if (fread(buf.data(), 1, buf.size(), f) != buf.size()) {
+        buf.clear();
+    }
+    fclose(f);
+    return buf;
+}
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+} Mapped;
+
+static Mapped map_file(const std::string &path) {
+    Mapped m = {nullptr, 0};
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return m;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            m.data = (const uint8_t *)p;
+            m.size = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+    return m;
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ---- Decoding (draw callback renders into an 8-bit canvas) ----
+
+static uint8_t g_canvas[512 * 512];
+
+static void draw_cb(GIFDRAW *d) {
+    const int y = d->iY + d->y;
+    if (y < 0 || y >= 512) {
+        return;
+    }
+    for (int i = 0; i < d->iWidth && d->iX + i < 512; i++) {
+        g_canvas[y * 512 + d->iX + i] = d->pPixels[i];
+    }
+}
+
+// Copies of the gif_player.cpp FATFS callbacks.
+static void *file_open_cb(const char *name, int32_t *size) {
+    FILE *f = fopen(name, "rb");
+    if (!f) {
+        return nullptr;
+    }
+    fseek(f, 0, SEEK_END);
+    *size = (int32_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    return f;
+}
+
+static void file_close_cb(void *h) {
+    if (h) fclose((FILE *)h);
+}
+
+static int32_t file_read_cb(GIFFILE *pFile, uint8_t *pBuf, int32_t iLen) {
+    const size_t n = fread(pBuf, 1, (size_t)iLen, (FILE *)pFile->fHandle);
+    pFile->iPos += (int32_t)n;
+    return (int32_t)n;
+}
+
+static int32_t file_seek_cb(GIFFILE *pFile, int32_t iPosition) {
+    if (fseek((FILE *)pFile->fHandle, (long)iPosition, SEEK_SET) != 0) {
+        return -1;
+    }
+    pFile->iPos = iPosition;
+    return iPosition;
+}
+
+static AnimatedGIF g_gif;
+
+static int count_frames_mem(const uint8_t *data, size_t size) {
+    if (!g_gif.open((uint8_t *)data, (int)size, draw_cb)) {
+        return -1;
+    }
+    int frames = 0;
+    int delay = 0;
+    while (true) {
+        const int prc = g_gif.playFrame(false, &delay, nullptr);
+        if (prc < 0) {
+            frames = -1;
+            break;
+        }
+        frames++;
+        if (prc == 0) {
+            break;
+        }
+    }
+    g_gif.close();
+    return frames;
+}
+
+// ---- Tests ----
+
+static void test_round_trip(const std::string &dir, const std::string &pack_path) {
+    const std::vector<ManifestEntry> manifest = read_manifest(dir);
+    CHECK(!manifest.empty());
+    const Mapped m = map_file(pack_path);
+    CHECK(m.data);
+
+    EchoGifPack pack;
+    CHECK(echo_gif_pack_open(&pack, m.data, m.size));
+    CHECK(echo_gif_pack_count(&pack) == (int)manifest.size());
+
+    // Entries are sorted by name (case-insensitive).
+    for (int i = 1; i < echo_gif_pack_count(&pack); i++) {
+        CHECK(strcasecmp(echo_gif_pack_name(&pack, i - 1), echo_gif_pack_name(&pack, i)) < 0);
+    }
+
+    for (const ManifestEntry &me : manifest) {
+        const int idx = echo_gif_pack_find(&pack, me.name.c_str());
+        CHECK(idx >= 0);
+        CHECK(strcmp(echo_gif_pack_name(&pack, idx), me.name.c_str()) == 0);
+
+        std::string upper = me.name, stem = me.name.substr(0, me.name.size() - 4);
+        for (char &c : upper) c = (char)toupper((unsigned char)c);
+        CHECK(echo_gif_pack_find(&pack, upper.c_str()) == idx);
+        CHECK(echo_gif_pack_find(&pack, stem.c_str()) == idx);
+        CHECK(echo_gif_pack_find(&pack, ("/storage/gifs/" + me.name).c_str()) == idx);
+        CHECK(echo_gif_pack_find(&pack, (stem + ".gif.gif").c_str()) == -1);
+
+        const EchoGifPackEntry *e = echo_gif_pack_entry(&pack, idx);
+        const std::vector<uint8_t> src = read_file(dir + "/" + me.name);
+        CHECK(e->data_size == src.size());
+        CHECK((e->data_offset & 3) == 0);
+        CHECK(memcmp(m.data + e->data_offset, src.data(), src.size()) == 0);
+        CHECK(e->canvas_w == me.w && e->canvas_h == me.h);
+        CHECK(e->frame_count == me.frames);
+        CHECK(e->duration_ms == me.duration_ms);
+
+        CHECK(count_frames_mem(m.data + e->data_offset, e->data_size) == me.frames);
+    }
+    CHECK(echo_gif_pack_find(&pack, "missing.gif") == -1);
+    CHECK(echo_gif_pack_find(&pack, "") == -1);
+    CHECK(echo_gif_pack_find(&pack, "anim_") == -1);
+
+    // The index alone (first index_size bytes) is enough to open it.
+    EchoGifPack index_only;
+    CHECK(echo_gif_pack_open(&index_only, m.data, pack.hdr->index_size));
+    CHECK(!echo_gif_pack_open(&index_only, m.data, pack.hdr->index_size - 1));
+
+    munmap((void *)m.data, m.size);
+    printf("{\"test\":\"round_trip\",\"gifs\":%zu,\"bytes\":%zu,\"ok\":true}\n", manifest.size(), m.size);
+}
+
+static void test_corrupt(const std::string &pack_path) {
+    std::vector<uint8_t> img = read_file(pack_path);
+    CHECK(img.size() > sizeof(EchoGifPackHeader));
+    EchoGifPack p;
+    CHECK(echo_gif_pack_open(&p, img.data(), img.size()));
+
+    auto mutate = [&](size_t off, uint32_t value, size_t width) {
+        std::vector<uint8_t> bad = img;
+        memcpy(bad.data() + off, &value, width);
+        EchoGifPack q;
+        return echo_gif_pack_open(&q, bad.data(), bad.size());
+    };
+    const EchoGifPackHeader *h = (const EchoGifPackHeader *)img.data();
+    CHECK(!mutate(0, 0x58585858u, 4));                                        // magic
+    CHECK(!mutate(offsetof(EchoGifPackHeader, version), 2, 2));               // version
+    CHECK(!mutate(offsetof(EchoGifPackHeader, entry_size), 20, 2));           // entry layout
+    CHECK(!mutate(offsetof(EchoGifPackHeader, bucket_count), 3, 4));          // not a power of two
+    CHECK(!mutate(offsetof(EchoGifPackHeader, entry_count), 0x7fffffff, 4));  // absurd count
+    CHECK(!mutate(offsetof(EchoGifPackHeader, index_size), (uint32_t)img.size() + 1, 4));
+    const size_t e0 = h->entries_offset;
+    CHECK(!mutate(e0 + offsetof(EchoGifPackEntry, data_size), h->total_size, 4));  // data past the end
+    CHECK(!mutate(e0 + offsetof(EchoGifPackEntry, name_offset), 0, 4));            // name outside names
+    CHECK(!mutate(h->buckets_offset, 0xffff, 2));                                  // bucket past entries
+    CHECK(!echo_gif_pack_open(&p, img.data(), sizeof(EchoGifPackHeader) - 1));
+    printf("{\"test\":\"corrupt\",\"ok\":true}\n");
+}
+
+static void bench_lookup(const std::string &dir, const std::string &pack_path) {
+    const std::vector<ManifestEntry> manifest = read_manifest(dir);
+    const Mapped m = map_file(pack_path);
+    CHECK(m.data);
+    EchoGifPack pack;
+    CHECK(echo_gif_pack_open(&pack, m.data, m.size));
+    const int n = echo_gif_pack_count(&pack);
+    CHECK(n == (int)manifest.size());
+
+    // echo_gif_registry_find_by_name's FATFS path: strcasecmp over the table.
+    std::vector<std::string> paths;
+    for (const ManifestEntry &me : manifest) paths.push_back("/storage/gifs/" + me.name);
+
+    const int rounds = 20;
+    volatile int sink = 0;
+    double t0 = now_us();
+    for (int r = 0; r < rounds; r++) {
+        for (const ManifestEntry &me : manifest) {
+            int found = -1;
+            for (int i = 0; i < n && found < 0; i++) {
+                const char *base = strrchr(paths[i].c_str(), '/') + 1;
+                if (strcasecmp(me.name.c_str(), base) == 0) found = i;
+            }
+            sink += found;
+        }
+    }
+    const double linear_ns = (now_us() - t0) * 1000.0 / (rounds * n);
+    t0 = now_us();
+    for (int r = 0; r < rounds; r++) {
+        for (const ManifestEntry &me : manifest) {
+            const int found = echo_gif_pack_find(&pack, me.name.c_str());
+            CHECK(found >= 0);
+            sink += found;
+        }
+    }
+    const double hash_ns = (now_us() - t0) * 1000.0 / (rounds * n);
+    (void)sink;
+    munmap((void *)m.data, m.size);
+    printf("{\"bench\":\"lookup\",\"entries\":%d,\"linear_ns\":%.0f,\"hash_ns\":%.0f}\n", n, linear_ns, hash_ns);
+}
+
+static void bench_open_to_first_frame(const std::string &dir, const std::string &pack_path) {
+    const std::vector<ManifestEntry> manifest = read_manifest(dir);
+    const Mapped m = map_file(pack_path);
+    CHECK(m.data);
+    EchoGifPack pack;
+    CHECK(echo_gif_pack_open(&pack, m.data, m.size));
+
+    const int rounds = 50;
+    int delay = 0;
+    double file_us = 0, pack_us = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (const ManifestEntry &me : manifest) {
+            const std::string path = dir + "/" + me.name;
+            double t0 = now_us();
+            CHECK(g_gif.open(path.c_str(), file_open_cb, file_close_cb, file_read_cb, file_seek_cb, draw_cb));
+            CHECK(g_gif.playFrame(false, &delay, nullptr) >= 0);
+            g_gif.close();
+            file_us += now_us() - t0;
+
+            t0 = now_us();
+            const EchoGifPackEntry *e = echo_gif_pack_entry(&pack, echo_gif_pack_find(&pack, me.name.c_str()));
+            CHECK(e);
+            CHECK(g_gif.open((uint8_t *)m.data + e->data_offset, (int)e->data_size, draw_cb));
+            CHECK(g_gif.playFrame(false, &delay, nullptr) >= 0);
+            g_gif.close();
+            pack_us += now_us() - t0;
+        }
+    }
+    const double n = (double)rounds * manifest.size();
+    munmap((void *)m.data, m.size);
+    printf("{\"bench\":\"open_to_first_frame\",\"gifs\":%zu,\"stdio_us\":%.1f,\"pack_us\":%.1f,\"speedup\":%.2f}\n",
+           manifest.size(), file_us / n, pack_us / n, pack_us > 0 ? file_us / pack_us : 0.0);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 5) {
+        fprintf(stderr, "usage: %s <gif_dir> <pack.bin> <many_gif_dir> <many_pack.bin>\n", argv[0]);
+        return 2;
+    }
+    test_round_trip(argv[1], argv[2]);
+    test_round_trip(argv[3], argv[4]);
+    test_corrupt(argv[2]);
+    bench_lookup(argv[3], argv[4]);
+    bench_open_to_first_frame(argv[1], argv[2]);
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
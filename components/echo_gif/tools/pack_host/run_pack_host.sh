@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Round-trip test for the echo_gif packed asset format:
+# generate GIFs -> tools/echo_gif_pack.py -> parse/look up/decode with
+# src/gif_pack.cpp and AnimatedGIF. Prints JSONL.
+#
+# Usage:
+#   ./tools/pack_host/run_pack_host.sh
+#   SANITIZE= ./tools/pack_host/run_pack_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SRC_DIR="${HERE}/../../src"
+GIF_DIR="${HERE}/../../../animatedgif/src"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/echo-gif-pack-host}"
+CXX="${CXX:-c++}"
+PYTHON="${PYTHON:-python3}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra -Wno-unused-parameter}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+rm -rf "${BUILD_DIR}"
+mkdir -p "${BUILD_DIR}"
+
+"${PYTHON}" "${HERE}/make_test_gifs.py" "${BUILD_DIR}/gifs" 12 128
+"${PYTHON}" "${HERE}/make_test_gifs.py" "${BUILD_DIR}/many" 600 4
+"${PYTHON}" "${HERE}/../echo_gif_pack.py" "${BUILD_DIR}/gifs" -o "${BUILD_DIR}/gifs.egpk" --partition-size 0x5F0000
+"${PYTHON}" "${HERE}/../echo_gif_pack.py" "${BUILD_DIR}/many" -o "${BUILD_DIR}/many.egpk"
+
+# AnimatedGIF.cpp is third-party: warnings off, and its deliberate unaligned
+# loads (fine on x86/Xtensa) are not reported.
+# shellcheck disable=SC2086
+"${CXX}" -O2 -g ${SANITIZE} ${SANITIZE:+-fno-sanitize=alignment} -w -D__LINUX__ -include "${HERE}/host/gif_host_shim.h" -I"${GIF_DIR}" \
+  -c -o "${BUILD_DIR}/AnimatedGIF.o" "${GIF_DIR}/AnimatedGIF.cpp"
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} -I"${SRC_DIR}" -I"${GIF_DIR}" \
+  -o "${BUILD_DIR}/pack_host_test" \
+  "${HERE}/pack_host_test.cpp" "${SRC_DIR}/gif_pack.cpp" "${BUILD_DIR}/AnimatedGIF.o"
+"${BUILD_DIR}/pack_host_test" "${BUILD_DIR}/gifs" "${BUILD_DIR}/gifs.egpk" "${BUILD_DIR}/many" "${BUILD_DIR}/many.egpk"
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the echo_gif span renderer host test and benchmark.
+#
+# src/gif_span.cpp only needs AnimatedGIF.h (for GIFDRAW), which builds on the
+# host as is. The test compares against the previous per-pixel GIFDraw and
+# prints JSONL.
+#
+# Usage:
+#   ./tools/span_host/run_span_host.sh
+#   SANITIZE= ./tools/span_host/run_span_host.sh   # meaningful timings
+
+HERE="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SRC_DIR="${HERE}/../../src"
+GIF_DIR="${HERE}/../../../animatedgif/src"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/echo-gif-span-host}"
+CXX="${CXX:-c++}"
+CFLAGS="${CFLAGS:--O2 -g -Wall -Wextra -Wno-unused-parameter}"
+SANITIZE="${SANITIZE--fsanitize=address,undefined}"
+
+mkdir -p "${BUILD_DIR}"
+
+# shellcheck disable=SC2086
+"${CXX}" ${CFLAGS} ${SANITIZE} -I"${SRC_DIR}" -I"${GIF_DIR}" \
+  -o "${BUILD_DIR}/span_host_test" \
+  "${HERE}/span_host_test.cpp" "${SRC_DIR}/gif_span.cpp"
+"${BUILD_DIR}/span_host_test"
@@ -0,0 +1,262 @@
+/*
+ * Host test and benchmark for the echo_gif span renderer (src/gif_span.cpp).
+ *
+ * Feeds stub GIFDRAW lines (random indices, runs, transparency) to both the
+ * span renderer and the per-pixel GIFDraw it replaced (copied below, with
+ * CONFIG_ECHO_GIF_SWAP_BYTES on: little-endian palette, swapped per pixel).
+ * The span renderer gets the palette pre-swapped, as AnimatedGIF produces it
+ * with GIF_PALETTE_RGB565_BE. Targets start with random contents and are
+ * compared pixel for pixel, over scales 1-4, odd/negative offsets, clipping on
+ * every side and odd target widths (unaligned rows). Prints JSONL.
+ *
+ * Built and run by tools/span_host/run_span_host.sh. Exits non-zero on failure.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "AnimatedGIF.h"
+#include "gif_span.h"
+
+static int g_failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                   \
+            return;                                                         \
+        }                                                                   \
+    } while (0)
+
+// ---- Reference: GIFDraw from gif_player.cpp before the span renderer ----
+
+typedef struct {
+    uint16_t *buf;
+    int canvas_w;
+    int canvas_h;
+    int scale_x;
+    int scale_y;
+    int off_x;
+    int off_y;
+} RefCtx;
+
+static void ref_gif_draw(GIFDRAW *pDraw) {
+    auto *ctx = (RefCtx *)pDraw->pUser;
+    auto *dst = ctx->buf;
+    const uint8_t *s = pDraw->pPixels;
+    const uint16_t *pal = pDraw->pPalette;
+
+    const int src_y = pDraw->iY + pDraw->y;
+    const int src_x0 = pDraw->iX;
+    const int src_w = pDraw->iWidth;
+
+    const int sx = (ctx->scale_x > 0) ? ctx->scale_x : 1;
+    const int sy = (ctx->scale_y > 0) ? ctx->scale_y : 1;
+
+    const int dst_y0 = ctx->off_y + src_y * sy;
+    for (int dy = 0; dy < sy; dy++) {
+        const int y = dst_y0 + dy;
+        if ((unsigned)y >= (unsigned)ctx->canvas_h) {
+            continue;
+        }
+        uint16_t *row = &dst[y * ctx->canvas_w];
+
+        if (pDraw->ucHasTransparency) {
+            const uint8_t t = pDraw->ucTransparent;
+            for (int i = 0; i < src_w; i++) {
+                const uint8_t idx = s[i];
+                if (idx == t) {
+                    continue;
+                }
+                uint16_t c = pal[idx];
+                c = __builtin_bswap16(c);
+                const int dst_x0 = ctx->off_x + (src_x0 + i) * sx;
+                for (int dx = 0; dx < sx; dx++) {
+                    const int x = dst_x0 + dx;
+                    if ((unsigned)x < (unsigned)ctx->canvas_w) {
+                        row[x] = c;
+                    }
+                }
+            }
+        } else {
+            for (int i = 0; i < src_w; i++) {
+                uint16_t c = pal[s[i]];
+                c = __builtin_bswap16(c);
+                const int dst_x0 = ctx->off_x + (src_x0 + i) * sx;
+                for (int dx = 0; dx < sx; dx++) {
+                    const int x = dst_x0 + dx;
+                    if ((unsigned)x < (unsigned)ctx->canvas_w) {
+                        row[x] = c;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ---- Stub frames ----
+
+static uint32_t g_rng = 0x12345678u;
+
+static uint32_t rnd(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static int rnd_range(int lo, int hi) { // inclusive
+    return lo + (int)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+typedef struct {
+    int w, h, x, y;
+    std::vector<uint8_t> px;
+    bool has_transparency;
+    uint8_t transparent;
+} Frame;
+
+// GIF-like content: runs of one index, with some transparent stretches.
+static Frame make_frame(int w, int h, int x, int y, bool transparency, int transparent_pct) {
+    Frame f = {w, h, x, y, std::vector<uint8_t>((size_t)w * h), transparency, (uint8_t)rnd_range(0, 255)};
+    size_t i = 0;
+    while (i < f.px.size()) {
+        const int run = rnd_range(1, 12);
+        uint8_t v = (uint8_t)rnd();
+        if (transparency && rnd_range(0, 99) < transparent_pct) {
+            v = f.transparent;
+        } else if (transparency && v == f.transparent) {
+            v ^= 1;
+        }
+        for (int k = 0; k < run && i < f.px.size(); k++) {
+            f.px[i++] = v;
+        }
+    }
+    return f;
+}
+
+static void make_palettes(uint16_t *le, uint16_t *be) {
+    for (int i = 0; i < 256; i++) {
+        le[i] = (uint16_t)rnd();
+        be[i] = __builtin_bswap16(le[i]);
+    }
+}
+
+static GIFDRAW make_draw(const Frame &f, int line, uint16_t *pal, void *user) {
+    GIFDRAW d;
+    memset(&d, 0, sizeof(d));
+    d.iX = f.x;
+    d.iY = f.y;
+    d.y = line;
+    d.iWidth = f.w;
+    d.iHeight = f.h;
+    d.pUser = user;
+    d.pPixels = (uint8_t *)&f.px[(size_t)line * f.w];
+    d.pPalette = pal;
+    d.ucTransparent = f.transparent;
+    d.ucHasTransparency = f.has_transparency;
+    return d;
+}
+
+static void render_ref(RefCtx *ctx, const Frame &f, uint16_t *pal_le) {
+    for (int line = 0; line < f.h; line++) {
+        GIFDRAW d = make_draw(f, line, pal_le, ctx);
+        ref_gif_draw(&d);
+    }
+}
+
+static void render_span(const EchoGifSpanTarget *t, const Frame &f, uint16_t *pal_be) {
+    for (int line = 0; line < f.h; line++) {
+        GIFDRAW d = make_draw(f, line, pal_be, nullptr);
+        echo_gif_draw_line(t, &d);
+    }
+}
+
+// ---- Tests ----
+
+static void test_pixel_exact(void) {
+    static uint16_t pal_le[256], pal_be[256];
+    int cases = 0;
+    for (int iter = 0; iter < 3000; iter++) {
+        make_palettes(pal_le, pal_be);
+        const int cw = rnd_range(1, 140), ch = rnd_range(1, 140);
+        const int sx = rnd_range(1, 4), sy = rnd_range(1, 4);
+        const int fw = rnd_range(1, 70), fh = rnd_range(1, 24);
+        const bool transparency = rnd_range(0, 1);
+        const Frame f = make_frame(fw, fh, rnd_range(0, 40), rnd_range(0, 40), transparency, rnd_range(0, 90));
+        const int off_x = rnd_range(-60, 60), off_y = rnd_range(-60, 60);
+
+        // +1 element so the target can start at an odd (2-byte aligned) address.
+        std::vector<uint16_t> a((size_t)cw * ch + 1), b((size_t)cw * ch + 1);
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = b[i] = (uint16_t)rnd();
+        }
+        const int shift = rnd_range(0, 1);
+
+        RefCtx ref = {a.data() + shift, cw, ch, sx, sy, off_x, off_y};
+        EchoGifSpanTarget t = {b.data() + shift, cw, ch, sx, sy, off_x, off_y};
+        render_ref(&ref, f, pal_le);
+        render_span(&t, f, pal_be);
+        if (a != b) {
+            size_t k = 0;
+            while (a[k] == b[k]) k++;
+            fprintf(stderr, "mismatch: canvas=%dx%d scale=%dx%d frame=%dx%d@%d,%d off=%d,%d transp=%d shift=%d first=%zu\n",
+                    cw, ch, sx, sy, fw, fh, f.x, f.y, off_x, off_y, transparency, shift, k);
+        }
+        CHECK(a == b);
+        cases++;
+    }
+    printf("{\"test\":\"pixel_exact\",\"cases\":%d,\"identical\":true}\n", cases);
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// A 128x128 screen filled by a GIF at each integer scale, like echo_gif with
+// CONFIG_ECHO_GIF_SCALE_TO_FULL_SCREEN.
+static void bench(int scale, int transparent_pct) {
+    static uint16_t pal_le[256], pal_be[256];
+    make_palettes(pal_le, pal_be);
+    const int screen = 128, gif = screen / scale;
+    const Frame f = make_frame(gif, gif, 0, 0, transparent_pct > 0, transparent_pct);
+    const int off = (screen - gif * scale) / 2;
+    std::vector<uint16_t> a((size_t)screen * screen), b((size_t)screen * screen);
+    RefCtx ref = {a.data(), screen, screen, scale, scale, off, off};
+    EchoGifSpanTarget t = {b.data(), screen, screen, scale, scale, off, off};
+
+    const int iters = 400;
+    double t0 = now_s();
+    for (int i = 0; i < iters; i++) render_ref(&ref, f, pal_le);
+    const double old_us = (now_s() - t0) / iters * 1e6;
+    t0 = now_s();
+    for (int i = 0; i < iters; i++) render_span(&t, f, pal_be);
+    const double new_us = (now_s() - t0) / iters * 1e6;
+
+    printf("{\"bench\":\"gif_draw\",\"gif\":%d,\"scale\":%d,\"transparent_pct\":%d,\"old_us\":%.1f,\"new_us\":%.1f,"
+           "\"speedup\":%.2f,\"identical\":%s}\n",
+           gif, scale, transparent_pct, old_us, new_us, new_us > 0 ? old_us / new_us : 0.0, a == b ? "true" : "false");
+    CHECK(a == b);
+}
+
+int main(void) {
+    test_pixel_exact();
+    for (int scale = 1; scale <= 4; scale++) {
+        bench(scale, 0);
+        bench(scale, 40);
+    }
+
+    if (g_failures) {
+        fprintf(stderr, "%d failure(s)\n", g_failures);
+        return 1;
+    }
+    printf("{\"result\":\"ok\"}\n");
+    return 0;
+}
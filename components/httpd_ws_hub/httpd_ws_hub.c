@@ -6,6 +6,7 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 
 #ifndef CONFIG_HTTPD_WS_SUPPORT
 
@@ -16,9 +17,10 @@ esp_err_t httpd_ws_hub_init(httpd_ws_hub_t *hub, httpd_handle_t server)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
-void httpd_ws_hub_deinit(httpd_ws_hub_t *hub)
+esp_err_t httpd_ws_hub_deinit(httpd_ws_hub_t *hub)
 {
     (void)hub;
+    return ESP_OK;
 }
 
 void httpd_ws_hub_set_text_rx_cb(httpd_ws_hub_t *hub, httpd_ws_hub_rx_cb_t cb)
@@ -55,27 +57,100 @@ esp_err_t httpd_ws_hub_handle_req(httpd_ws_hub_t *hub, httpd_req_t *req)
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+void httpd_ws_hub_set_backpressure(httpd_ws_hub_t *hub, uint8_t max_inflight, httpd_ws_hub_slow_policy_t policy)
+{
+    (void)hub;
+    (void)max_inflight;
+    (void)policy;
+}
+
+void httpd_ws_hub_get_stats(httpd_ws_hub_t *hub, httpd_ws_hub_stats_t *out)
+{
+    (void)hub;
+    if (out) memset(out, 0, sizeof(*out));
+}
+
 #else
 
+// How long deinit waits for queued sends to complete, and how often it looks.
+#define HUB_DEINIT_TIMEOUT_MS 1000
+#define HUB_DEINIT_POLL_MS 10
+
+// One copy of a broadcast, shared by every async send of it. `refs` is only
+// touched under hub->mu (broadcast, send-complete callback, pending slots).
+typedef struct {
+    httpd_ws_hub_t *hub;
+    uint32_t refs;
+    httpd_ws_type_t type;
+    size_t len;
+    uint8_t data[];
+} hub_payload_t;
+
+struct httpd_ws_hub_client {
+    httpd_ws_hub_client_t *next;
+    int fd;
+    uint32_t inflight;       // frames handed to httpd, not yet completed
+    hub_payload_t *pending;  // newest coalesced frame (COALESCE policy)
+};
+
 static SemaphoreHandle_t hub_mu(httpd_ws_hub_t *hub)
 {
     return (SemaphoreHandle_t)hub->mu;
 }
 
+static void payload_release(hub_payload_t *p)
+{
+    if (p && --p->refs == 0) free(p);
+}
+
+// Caller holds mu.
+static httpd_ws_hub_client_t *hub_client_find(httpd_ws_hub_t *hub, int fd)
+{
+    for (httpd_ws_hub_client_t *c = hub->clients; c; c = c->next) {
+        if (c->fd == fd) return c;
+    }
+    return NULL;
+}
+
+// Caller holds mu.
+static void hub_queue_depth_add(httpd_ws_hub_t *hub, int delta)
+{
+    if (delta < 0 && hub->stats.queue_depth < (uint32_t)-delta) {
+        hub->stats.queue_depth = 0;
+        return;
+    }
+    hub->stats.queue_depth += delta;
+    if (hub->stats.queue_depth > hub->stats.queue_depth_max) {
+        hub->stats.queue_depth_max = hub->stats.queue_depth;
+    }
+}
+
+// Caller holds mu.
+static void hub_client_unlink(httpd_ws_hub_t *hub, httpd_ws_hub_client_t **link)
+{
+    httpd_ws_hub_client_t *c = *link;
+    *link = c->next;
+    hub->clients_n--;
+    // In-flight sends complete through ws_send_done_cb and find no client.
+    hub_queue_depth_add(hub, -(int)c->inflight - (c->pending ? 1 : 0));
+    payload_release(c->pending);
+    free(c);
+}
+
 static void hub_client_add(httpd_ws_hub_t *hub, int fd)
 {
     SemaphoreHandle_t mu = hub_mu(hub);
     if (!mu) return;
     xSemaphoreTake(mu, portMAX_DELAY);
-    for (size_t i = 0; i < hub->clients_n; i++) {
-        if (hub->clients[i] == fd) {
-            xSemaphoreGive(mu);
-            return;
+    if (!hub_client_find(hub, fd)) {
+        httpd_ws_hub_client_t *c = (httpd_ws_hub_client_t *)calloc(1, sizeof(*c));
+        if (c) {
+            c->fd = fd;
+            c->next = hub->clients;
+            hub->clients = c;
+            hub->clients_n++;
         }
     }
-    if (hub->clients_n < (sizeof(hub->clients) / sizeof(hub->clients[0]))) {
-        hub->clients[hub->clients_n++] = fd;
-    }
     xSemaphoreGive(mu);
 }
 
@@ -84,35 +159,67 @@ static void hub_client_remove(httpd_ws_hub_t *hub, int fd)
     SemaphoreHandle_t mu = hub_mu(hub);
     if (!mu) return;
     xSemaphoreTake(mu, portMAX_DELAY);
-    for (size_t i = 0; i < hub->clients_n; i++) {
-        if (hub->clients[i] == fd) {
-            hub->clients[i] = hub->clients[hub->clients_n - 1];
-            hub->clients_n--;
+    for (httpd_ws_hub_client_t **link = &hub->clients; *link; link = &(*link)->next) {
+        if ((*link)->fd == fd) {
+            hub_client_unlink(hub, link);
             break;
         }
     }
     xSemaphoreGive(mu);
 }
 
-static size_t hub_clients_snapshot(httpd_ws_hub_t *hub, int *out, size_t max_out)
+static void ws_send_done_cb(esp_err_t err, int fd, void *arg);
+
+// Caller holds mu and has already counted the frame in c->inflight.
+static void hub_send_locked(httpd_ws_hub_t *hub, httpd_ws_hub_client_t *c, hub_payload_t *p)
 {
-    if (!hub || !out || max_out == 0) return 0;
-    SemaphoreHandle_t mu = hub_mu(hub);
-    if (!mu) return 0;
-    xSemaphoreTake(mu, portMAX_DELAY);
-    const size_t n = (hub->clients_n < max_out) ? hub->clients_n : max_out;
-    for (size_t i = 0; i < n; i++) {
-        out[i] = hub->clients[i];
+    httpd_ws_frame_t frame = {};
+    frame.type = p->type;
+    frame.payload = p->data;
+    frame.len = p->len;
+
+    p->refs++;
+    hub->sends_outstanding++;
+    if (httpd_ws_send_data_async(hub->server, c->fd, &frame, ws_send_done_cb, p) != ESP_OK) {
+        // Not queued: the callback will never run for this frame.
+        p->refs--;
+        hub->sends_outstanding--;
+        c->inflight--;
+        hub_queue_depth_add(hub, -1);
+        hub->stats.send_errors++;
     }
-    xSemaphoreGive(mu);
-    return n;
 }
 
-static void ws_send_free_cb(esp_err_t err, int fd, void *arg)
+static void ws_send_done_cb(esp_err_t err, int fd, void *arg)
 {
-    (void)err;
-    (void)fd;
-    free(arg);
+    hub_payload_t *p = (hub_payload_t *)arg;
+    httpd_ws_hub_t *hub = p->hub;
+    SemaphoreHandle_t mu = hub_mu(hub);
+    xSemaphoreTake(mu, portMAX_DELAY);
+    hub->sends_outstanding--;
+    if (err == ESP_OK) {
+        hub->stats.frames_sent++;
+        hub->stats.bytes_sent += (uint32_t)p->len;
+    } else {
+        hub->stats.send_errors++;
+    }
+
+    httpd_ws_hub_client_t *c = hub_client_find(hub, fd);
+    if (c && c->inflight > 0) {
+        c->inflight--;
+        hub_queue_depth_add(hub, -1);
+        if (c->pending) {
+            // The pending frame moves from the queue into flight: depth is unchanged.
+            hub_payload_t *next = c->pending;
+            c->pending = NULL;
+            c->inflight++;
+            hub_send_locked(hub, c, next);
+            payload_release(next);
+        }
+    }
+    payload_release(p);
+    // Last touch of hub: deinit may free mu as soon as it sees no sends outstanding.
+    xSemaphoreGive(mu);
 }
 
 esp_err_t httpd_ws_hub_init(httpd_ws_hub_t *hub, httpd_handle_t server)
@@ -120,17 +227,37 @@ esp_err_t httpd_ws_hub_init(httpd_ws_hub_t *hub, httpd_handle_t server)
     if (!hub) return ESP_ERR_INVALID_ARG;
     memset(hub, 0, sizeof(*hub));
     hub->server = server;
+    hub->max_inflight = HTTPD_WS_HUB_UNLIMITED_INFLIGHT;
+    hub->slow_policy = HTTPD_WS_HUB_SLOW_DROP;
     hub->mu = (void *)xSemaphoreCreateMutex();
     if (!hub->mu) return ESP_ERR_NO_MEM;
     return ESP_OK;
 }
 
-void httpd_ws_hub_deinit(httpd_ws_hub_t *hub)
+esp_err_t httpd_ws_hub_deinit(httpd_ws_hub_t *hub)
 {
-    if (!hub) return;
+    if (!hub) return ESP_ERR_INVALID_ARG;
     SemaphoreHandle_t mu = hub_mu(hub);
-    if (mu) vSemaphoreDelete(mu);
+    if (mu) {
+        xSemaphoreTake(mu, portMAX_DELAY);
+        hub->server = NULL;  // no new clients or broadcasts
+        while (hub->clients) hub_client_unlink(hub, &hub->clients);
+        // Completion callbacks of queued sends still use hub and mu; they run on the
+        // server task, so it must still be running.
+        for (int waited_ms = 0; hub->sends_outstanding > 0; waited_ms += HUB_DEINIT_POLL_MS) {
+            if (waited_ms >= HUB_DEINIT_TIMEOUT_MS) {
+                xSemaphoreGive(mu);
+                return ESP_ERR_TIMEOUT;
+            }
+            xSemaphoreGive(mu);
+            vTaskDelay(pdMS_TO_TICKS(HUB_DEINIT_POLL_MS));
+            xSemaphoreTake(mu, portMAX_DELAY);
+        }
+        xSemaphoreGive(mu);
+        vSemaphoreDelete(mu);
+    }
     memset(hub, 0, sizeof(*hub));
+    return ESP_OK;
 }
 
 void httpd_ws_hub_set_text_rx_cb(httpd_ws_hub_t *hub, httpd_ws_hub_rx_cb_t cb)
@@ -145,62 +272,97 @@ void httpd_ws_hub_set_binary_rx_cb(httpd_ws_hub_t *hub, httpd_ws_hub_rx_cb_t cb)
     hub->binary_rx_cb = cb;
 }
 
-esp_err_t httpd_ws_hub_broadcast_text(httpd_ws_hub_t *hub, const char *text)
+void httpd_ws_hub_set_backpressure(httpd_ws_hub_t *hub, uint8_t max_inflight, httpd_ws_hub_slow_policy_t policy)
 {
-    if (!hub || !hub->server) return ESP_ERR_INVALID_STATE;
-    if (!text) return ESP_OK;
-    const size_t len = strlen(text);
-    if (len == 0) return ESP_OK;
-
-    int fds[HTTPD_WS_HUB_MAX_CLIENTS];
-    const size_t n = hub_clients_snapshot(hub, fds, sizeof(fds) / sizeof(fds[0]));
-    for (size_t i = 0; i < n; i++) {
-        const int fd = fds[i];
-        if (httpd_ws_get_fd_info(hub->server, fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
-            hub_client_remove(hub, fd);
-            continue;
-        }
+    if (!hub) return;
+    SemaphoreHandle_t mu = hub_mu(hub);
+    if (mu) xSemaphoreTake(mu, portMAX_DELAY);
+    hub->max_inflight = max_inflight;
+    hub->slow_policy = policy;
+    if (mu) xSemaphoreGive(mu);
+}
 
-        char *copy = (char *)malloc(len);
-        if (!copy) return ESP_ERR_NO_MEM;
-        memcpy(copy, text, len);
+void httpd_ws_hub_get_stats(httpd_ws_hub_t *hub, httpd_ws_hub_stats_t *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!hub) return;
+    SemaphoreHandle_t mu = hub_mu(hub);
+    if (!mu) return;
+    xSemaphoreTake(mu, portMAX_DELAY);
+    *out = hub->stats;
+    out->clients = (uint32_t)hub->clients_n;
+    xSemaphoreGive(mu);
+}
 
-        httpd_ws_frame_t frame = {};
-        frame.type = HTTPD_WS_TYPE_TEXT;
-        frame.payload = (uint8_t *)copy;
-        frame.len = len;
+static esp_err_t hub_broadcast(httpd_ws_hub_t *hub, httpd_ws_type_t type, const uint8_t *data, size_t len)
+{
+    SemaphoreHandle_t mu = hub_mu(hub);
+    if (!mu) return ESP_ERR_INVALID_STATE;
 
-        (void)httpd_ws_send_data_async(hub->server, fd, &frame, ws_send_free_cb, copy);
+    xSemaphoreTake(mu, portMAX_DELAY);
+    if (!hub->clients) {
+        xSemaphoreGive(mu);
+        return ESP_OK;
     }
+    // Single allocation up front: either every client is offered the frame or none is.
+    hub_payload_t *p = (hub_payload_t *)malloc(sizeof(*p) + len);
+    if (!p) {
+        xSemaphoreGive(mu);
+        return ESP_ERR_NO_MEM;
+    }
+    p->hub = hub;
+    p->refs = 1;  // held by this call until the loop is done
+    p->type = type;
+    p->len = len;
+    memcpy(p->data, data, len);
+    hub->stats.broadcasts++;
+
+    httpd_ws_hub_client_t **link = &hub->clients;
+    while (*link) {
+        httpd_ws_hub_client_t *c = *link;
+        if (httpd_ws_get_fd_info(hub->server, c->fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+            hub_client_unlink(hub, link);
+            continue;
+        }
+        link = &c->next;
+
+        if (hub->max_inflight == HTTPD_WS_HUB_UNLIMITED_INFLIGHT || c->inflight < hub->max_inflight) {
+            c->inflight++;
+            hub_queue_depth_add(hub, 1);
+            hub_send_locked(hub, c, p);
+        } else if (hub->slow_policy == HTTPD_WS_HUB_SLOW_COALESCE) {
+            if (c->pending) {
+                payload_release(c->pending);
+                hub->stats.coalesced++;
+            } else {
+                hub_queue_depth_add(hub, 1);
+            }
+            p->refs++;
+            c->pending = p;
+        } else {
+            hub->stats.drops++;
+        }
+    }
+    payload_release(p);
+    xSemaphoreGive(mu);
     return ESP_OK;
 }
 
+esp_err_t httpd_ws_hub_broadcast_text(httpd_ws_hub_t *hub, const char *text)
+{
+    if (!hub || !hub->server) return ESP_ERR_INVALID_STATE;
+    if (!text) return ESP_OK;
+    const size_t len = strlen(text);
+    if (len == 0) return ESP_OK;
+    return hub_broadcast(hub, HTTPD_WS_TYPE_TEXT, (const uint8_t *)text, len);
+}
+
 esp_err_t httpd_ws_hub_broadcast_binary(httpd_ws_hub_t *hub, const uint8_t *data, size_t len)
 {
     if (!hub || !hub->server) return ESP_ERR_INVALID_STATE;
     if (!data || len == 0) return ESP_OK;
-
-    int fds[HTTPD_WS_HUB_MAX_CLIENTS];
-    const size_t n = hub_clients_snapshot(hub, fds, sizeof(fds) / sizeof(fds[0]));
-    for (size_t i = 0; i < n; i++) {
-        const int fd = fds[i];
-        if (httpd_ws_get_fd_info(hub->server, fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
-            hub_client_remove(hub, fd);
-            continue;
-        }
-
-        uint8_t *copy = (uint8_t *)malloc(len);
-        if (!copy) return ESP_ERR_NO_MEM;
-        memcpy(copy, data, len);
-
-        httpd_ws_frame_t frame = {};
-        frame.type = HTTPD_WS_TYPE_BINARY;
-        frame.payload = copy;
-        frame.len = len;
-
-        (void)httpd_ws_send_data_async(hub->server, fd, &frame, ws_send_free_cb, copy);
-    }
-    return ESP_OK;
+    return hub_broadcast(hub, HTTPD_WS_TYPE_BINARY, data, len);
 }
 
 esp_err_t httpd_ws_hub_handle_req(httpd_ws_hub_t *hub, httpd_req_t *req)
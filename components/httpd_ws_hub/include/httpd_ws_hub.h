@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -10,32 +11,66 @@
 extern "C" {
 #endif
 
-#define HTTPD_WS_HUB_MAX_CLIENTS 8
 #define HTTPD_WS_HUB_MAX_RX_LEN 1024
+#define HTTPD_WS_HUB_UNLIMITED_INFLIGHT 0
 
 typedef esp_err_t (*httpd_ws_hub_rx_cb_t)(const uint8_t *data, size_t len);
 
+// What to do with a broadcast for a client that already has `max_inflight` frames queued
+// (only when a limit is set with httpd_ws_hub_set_backpressure()).
+typedef enum {
+    HTTPD_WS_HUB_SLOW_DROP = 0,  // drop the new frame for that client
+    HTTPD_WS_HUB_SLOW_COALESCE,  // keep only the newest frame; sent when a slot frees up
+} httpd_ws_hub_slow_policy_t;
+
+typedef struct {
+    uint32_t clients;        // connected WebSocket clients
+    uint32_t broadcasts;     // broadcast calls with at least one client
+    uint32_t frames_sent;    // frames the server reported as sent
+    uint32_t bytes_sent;     // payload bytes of those frames
+    uint32_t drops;          // frames dropped for slow clients (DROP policy)
+    uint32_t coalesced;      // pending frames replaced by a newer one (COALESCE policy)
+    uint32_t send_errors;    // async send failures (queueing or socket)
+    uint32_t queue_depth;    // frames currently in flight or pending, all clients
+    uint32_t queue_depth_max;
+} httpd_ws_hub_stats_t;
+
+typedef struct httpd_ws_hub_client httpd_ws_hub_client_t;
+
 typedef struct {
     httpd_handle_t server;
     void *mu;  // SemaphoreHandle_t
-    int clients[HTTPD_WS_HUB_MAX_CLIENTS];
+    httpd_ws_hub_client_t *clients;  // dynamic set, guarded by mu
     size_t clients_n;
+    uint32_t sends_outstanding;  // async sends whose completion callback has not run, guarded by mu
+    uint8_t max_inflight;  // HTTPD_WS_HUB_UNLIMITED_INFLIGHT: no per-client limit
+    httpd_ws_hub_slow_policy_t slow_policy;
+    httpd_ws_hub_stats_t stats;
     httpd_ws_hub_rx_cb_t text_rx_cb;
     httpd_ws_hub_rx_cb_t binary_rx_cb;
 } httpd_ws_hub_t;
 
 esp_err_t httpd_ws_hub_init(httpd_ws_hub_t *hub, httpd_handle_t server);
-void httpd_ws_hub_deinit(httpd_ws_hub_t *hub);
+// Call before httpd_stop(): drops all clients and waits for queued sends to complete, since their
+// callbacks reference hub. ESP_ERR_TIMEOUT: some are still queued after 1 s; hub stays valid (and
+// must not be freed), call again later.
+esp_err_t httpd_ws_hub_deinit(httpd_ws_hub_t *hub);
 
 esp_err_t httpd_ws_hub_handle_req(httpd_ws_hub_t *hub, httpd_req_t *req);
 
+// Broadcasts share one payload copy across all clients. ESP_ERR_NO_MEM means no client got the frame.
 esp_err_t httpd_ws_hub_broadcast_text(httpd_ws_hub_t *hub, const char *text);
 esp_err_t httpd_ws_hub_broadcast_binary(httpd_ws_hub_t *hub, const uint8_t *data, size_t len);
 
 void httpd_ws_hub_set_text_rx_cb(httpd_ws_hub_t *hub, httpd_ws_hub_rx_cb_t cb);
 void httpd_ws_hub_set_binary_rx_cb(httpd_ws_hub_t *hub, httpd_ws_hub_rx_cb_t cb);
 
+// Per-client backpressure, opt-in. By default (HTTPD_WS_HUB_UNLIMITED_INFLIGHT) every broadcast is
+// queued to every client, however far behind it is; a non-zero max_inflight applies `policy` beyond it.
+void httpd_ws_hub_set_backpressure(httpd_ws_hub_t *hub, uint8_t max_inflight, httpd_ws_hub_slow_policy_t policy);
+
+void httpd_ws_hub_get_stats(httpd_ws_hub_t *hub, httpd_ws_hub_stats_t *out);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
-
@@ -28,6 +28,7 @@ typedef struct {
   uint32_t queue_len;               // default: 16
 
   size_t arena_bytes;               // required
+  uint32_t arena_caps;              // default: 0 (default heap); e.g. MALLOC_CAP_SPIRAM, falls back to default heap
   const JSSTDLibraryDef* stdlib;    // required
   bool fix_global_this;             // default: true
 } mqjs_service_config_t;
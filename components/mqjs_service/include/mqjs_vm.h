@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 extern "C" {
@@ -25,6 +26,11 @@ class MqjsVm {
   static MqjsVm* From(JSContext* ctx);
   static void DestroyContext(JSContext* ctx);
 
+  // Arena placement helper. `caps` are heap_caps flags (e.g. MALLOC_CAP_SPIRAM);
+  // 0 or a failed caps allocation falls back to the default heap. The arena is
+  // zeroed; release it with free(). `in_psram` (optional) reports the placement.
+  static void* AllocArena(size_t bytes, uint32_t caps, bool* in_psram = nullptr);
+
   JSContext* ctx() const { return ctx_; }
 
   void SetDeadlineMs(uint32_t timeout_ms);
@@ -34,6 +40,15 @@ class MqjsVm {
   std::string GetExceptionString(int flags = JS_DUMP_LONG);
   std::string DumpMemory(bool is_long = false);
 
+  // Allocation profiler. While enabled, every JS heap allocation is charged to
+  // the innermost JS call site (this costs a frame walk per allocation, so keep
+  // it off outside of investigations). The dump runs a GC, then lists live bytes
+  // per object class / block type and allocated bytes per call site.
+  void StartAllocProfile();
+  void StopAllocProfile();
+  bool AllocProfileActive() const { return profile_ != nullptr && profile_->active; }
+  std::string DumpAllocProfile(size_t max_sites = 16);
+
  private:
   explicit MqjsVm(JSContext* ctx);
   ~MqjsVm();
@@ -51,6 +66,25 @@ class MqjsVm {
 
   static int InterruptHandler(JSContext* ctx, void* opaque);
   static void WriteFunc(void* opaque, const void* buf, size_t buf_len);
+  static void AllocHook(JSContext* ctx, void* opaque, int mtag, uint32_t size);
+
+  // Call sites live in a fixed open-addressed table so the hook never allocates.
+  struct AllocSite {
+    uint32_t hash = 0;
+    uint32_t count = 0;
+    uint32_t bytes = 0;
+    char where[48] = {};
+  };
+  struct AllocProfile {
+    static constexpr size_t kMaxSites = 64;
+    bool active = false;
+    int64_t started_us = 0;
+    uint32_t total_count = 0;
+    uint32_t total_bytes = 0;
+    uint32_t other_count = 0;  // allocations whose site didn't fit the table
+    uint32_t other_bytes = 0;
+    AllocSite sites[kMaxSites];
+  };
 
   void FixGlobalThis();
 
@@ -66,5 +100,6 @@ class MqjsVm {
   JSContext* ctx_ = nullptr;
   int64_t deadline_us_ = 0;
   std::string* capture_ = nullptr;
+  std::unique_ptr<AllocProfile> profile_;
   RegistryNode reg_ = {};
 };
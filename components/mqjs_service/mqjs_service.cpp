@@ -100,9 +100,15 @@ static void eval_fill_error(mqjs_eval_result_t* out, const char* msg) {
 static void service_ensure_ctx(Service* s) {
   if (!s || s->ctx) return;
 
-  s->arena = static_cast<uint8_t*>(malloc(s->cfg.arena_bytes));
-  if (!s->arena) return;
-  memset(s->arena, 0, s->cfg.arena_bytes);
+  bool in_psram = false;
+  s->arena = static_cast<uint8_t*>(MqjsVm::AllocArena(s->cfg.arena_bytes, s->cfg.arena_caps, &in_psram));
+  if (!s->arena) {
+    ESP_LOGE(TAG, "arena alloc failed (%u bytes)", (unsigned)s->cfg.arena_bytes);
+    return;
+  }
+  if ((s->cfg.arena_caps & MALLOC_CAP_SPIRAM) && !in_psram) {
+    ESP_LOGW(TAG, "PSRAM arena unavailable; using internal RAM (%u bytes)", (unsigned)s->cfg.arena_bytes);
+  }
 
   MqjsVmConfig cfg = {};
   cfg.arena = s->arena;
@@ -1,7 +1,14 @@
 #include "mqjs_vm.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
 
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
 #include "esp_timer.h"
 
 MqjsVm::RegistryNode*& MqjsVm::RegistryHead()
@@ -60,6 +67,25 @@ MqjsVm* MqjsVm::Create(const MqjsVmConfig& cfg)
   return vm;
 }
 
+void* MqjsVm::AllocArena(size_t bytes, uint32_t caps, bool* in_psram)
+{
+  if (in_psram) *in_psram = false;
+  if (bytes == 0) return nullptr;
+
+  void* arena = nullptr;
+  if (caps != 0) {
+    arena = heap_caps_malloc(bytes, caps);
+  }
+  if (!arena) {
+    arena = malloc(bytes);
+  }
+  if (!arena) return nullptr;
+
+  memset(arena, 0, bytes);
+  if (in_psram) *in_psram = esp_ptr_external_ram(arena);
+  return arena;
+}
+
 MqjsVm* MqjsVm::From(JSContext* ctx)
 {
   if (!ctx) return nullptr;
@@ -85,6 +111,7 @@ MqjsVm::MqjsVm(JSContext* ctx) : ctx_(ctx) {}
 MqjsVm::~MqjsVm()
 {
   if (!ctx_) return;
+  JS_SetAllocHook(ctx_, nullptr);
   RegistryRemove();
   JS_SetContextOpaque(ctx_, nullptr);
   JS_FreeContext(ctx_);
@@ -174,3 +201,164 @@ std::string MqjsVm::DumpMemory(bool is_long)
   JS_DumpMemory(ctx_, is_long ? 1 : 0);
   return out;
 }
+
+namespace {
+
+uint32_t fnv1a(const char* s, size_t len)
+{
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)s[i];
+    h *= 16777619u;
+  }
+  return h ? h : 1;  // 0 marks an empty slot
+}
+
+struct LiveStat {
+  uint32_t count = 0;
+  uint32_t bytes = 0;
+};
+
+struct LiveWalk {
+  std::map<int, LiveStat> by_class;  // object blocks, keyed by class id
+  std::map<int, LiveStat> by_mtag;   // everything else, keyed by block type
+  uint32_t total_bytes = 0;
+};
+
+void live_walk_cb(void* opaque, int mtag, int class_id, uint32_t size)
+{
+  auto* w = static_cast<LiveWalk*>(opaque);
+  LiveStat& st = (class_id >= 0) ? w->by_class[class_id] : w->by_mtag[mtag];
+  st.count++;
+  st.bytes += size;
+  w->total_bytes += size;
+}
+
+}  // namespace
+
+void MqjsVm::AllocHook(JSContext* ctx, void* opaque, int mtag, uint32_t size)
+{
+  (void)mtag;
+  auto* vm = static_cast<MqjsVm*>(opaque);
+  if (!vm || !vm->profile_ || !vm->profile_->active) return;
+  AllocProfile& p = *vm->profile_;
+
+  p.total_count++;
+  p.total_bytes += size;
+
+  char where[sizeof(AllocSite::where)];
+  int len = JS_GetCallSite(ctx, where, sizeof(where));
+  if (len <= 0) {
+    len = snprintf(where, sizeof(where), "<native>");
+  }
+  len = std::min<int>(len, (int)sizeof(where) - 1);
+  const uint32_t h = fnv1a(where, (size_t)len);
+
+  for (size_t i = 0; i < AllocProfile::kMaxSites; i++) {
+    AllocSite& site = p.sites[(h + i) % AllocProfile::kMaxSites];
+    if (site.hash == 0) {
+      site.hash = h;
+      memcpy(site.where, where, (size_t)len);
+      site.where[len] = '\0';
+    } else if (site.hash != h || strcmp(site.where, where) != 0) {
+      continue;
+    }
+    site.count++;
+    site.bytes += size;
+    return;
+  }
+  p.other_count++;
+  p.other_bytes += size;
+}
+
+void MqjsVm::StartAllocProfile()
+{
+  if (!ctx_) return;
+  if (!profile_) {
+    profile_.reset(new AllocProfile());
+  } else {
+    *profile_ = AllocProfile();
+  }
+  profile_->active = true;
+  profile_->started_us = esp_timer_get_time();
+  JS_SetAllocHook(ctx_, &MqjsVm::AllocHook);
+}
+
+void MqjsVm::StopAllocProfile()
+{
+  if (ctx_) JS_SetAllocHook(ctx_, nullptr);
+  if (profile_) profile_->active = false;
+}
+
+std::string MqjsVm::DumpAllocProfile(size_t max_sites)
+{
+  std::string out;
+  if (!ctx_) return out;
+
+  char line[128];
+
+  // Only blocks reachable after a full GC count as live.
+  JS_GC(ctx_);
+  LiveWalk w;
+  JS_WalkHeap(ctx_, &live_walk_cb, &w);
+
+  std::vector<std::pair<std::string, LiveStat>> live;
+  for (const auto& kv : w.by_class) {
+    JSCStringBuf buf;
+    const char* name = JS_GetClassName(ctx_, kv.first, &buf);
+    if (name && name[0]) {
+      live.emplace_back(name, kv.second);
+    } else if (kv.first == JS_CLASS_C_FUNCTION) {
+      live.emplace_back("Function (native)", kv.second);
+    } else {
+      snprintf(line, sizeof(line), "class#%d", kv.first);
+      live.emplace_back(line, kv.second);
+    }
+  }
+  for (const auto& kv : w.by_mtag) {
+    snprintf(line, sizeof(line), "[%s]", JS_GetMTagName(kv.first));
+    live.emplace_back(line, kv.second);
+  }
+  std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.second.bytes > b.second.bytes; });
+
+  snprintf(line, sizeof(line), "live heap after GC: %u bytes\n", (unsigned)w.total_bytes);
+  out += line;
+  snprintf(line, sizeof(line), "%-24s %8s %8s\n", "CLASS", "COUNT", "BYTES");
+  out += line;
+  for (const auto& e : live) {
+    snprintf(line, sizeof(line), "%-24.24s %8u %8u\n", e.first.c_str(), (unsigned)e.second.count, (unsigned)e.second.bytes);
+    out += line;
+  }
+
+  if (!profile_) {
+    out += "alloc sites: profiler not started\n";
+    return out;
+  }
+
+  const AllocProfile& p = *profile_;
+  std::vector<const AllocSite*> sites;
+  for (const AllocSite& site : p.sites) {
+    if (site.hash != 0) sites.push_back(&site);
+  }
+  std::sort(sites.begin(), sites.end(), [](const AllocSite* a, const AllocSite* b) { return a->bytes > b->bytes; });
+
+  snprintf(line,
+           sizeof(line),
+           "alloc sites (%s, %lld ms): %u allocs, %u bytes\n",
+           p.active ? "running" : "stopped",
+           (long long)((esp_timer_get_time() - p.started_us) / 1000),
+           (unsigned)p.total_count,
+           (unsigned)p.total_bytes);
+  out += line;
+  snprintf(line, sizeof(line), "%8s %8s  %s\n", "COUNT", "BYTES", "SITE");
+  out += line;
+  for (size_t i = 0; i < sites.size() && i < max_sites; i++) {
+    snprintf(line, sizeof(line), "%8u %8u  %s\n", (unsigned)sites[i]->count, (unsigned)sites[i]->bytes, sites[i]->where);
+    out += line;
+  }
+  if (p.other_count) {
+    snprintf(line, sizeof(line), "%8u %8u  <other sites>\n", (unsigned)p.other_count, (unsigned)p.other_bytes);
+    out += line;
+  }
+  return out;
+}
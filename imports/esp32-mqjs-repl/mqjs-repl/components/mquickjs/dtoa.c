@@ -1104,6 +1104,59 @@ static void dtoa_free(void *ptr)
 }
 #endif
 
+#define DTOA_FAST_FRAC_DIGITS_MAX 6
+
+static const double dtoa_fast_pow10[DTOA_FAST_FRAC_DIGITS_MAX + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+};
+
+/* Fast path for the common cases of js_dtoa(buf, d, 10, 0,
+   JS_DTOA_FORMAT_FREE): integers below 2^53 and numbers with at most
+   DTOA_FAST_FRAC_DIGITS_MAX fractional digits and 15 significant
+   digits. Below 10^15 distinct decimals map to distinct doubles, so
+   the smallest number of fractional digits which round trips is the
+   shortest representation. -0 gives "0". Return the length or -1 if
+   the general algorithm is needed. */
+int js_dtoa_fast(char *buf, double d)
+{
+    char *q = buf;
+    double a, s;
+    uint64_t m, ip;
+    int k;
+
+    /* also rejects NaN */
+    if (!(d >= -9007199254740992.0 && d <= 9007199254740992.0))
+        return -1;
+    if (d < 0) {
+        *q++ = '-';
+        a = -d;
+    } else {
+        a = d;
+    }
+    m = (uint64_t)a;
+    if ((double)m == a) {
+        q += u64toa(q, m);
+        *q = '\0';
+        return q - buf;
+    }
+    for(k = 1; k <= DTOA_FAST_FRAC_DIGITS_MAX; k++) {
+        s = a * dtoa_fast_pow10[k];
+        if (s >= 1e15)
+            break;
+        m = (uint64_t)(s + 0.5);
+        if ((double)m / dtoa_fast_pow10[k] == a) {
+            ip = m / (uint32_t)dtoa_fast_pow10[k];
+            q += u64toa(q, ip);
+            *q++ = '.';
+            u32toa_len(q, m - ip * (uint32_t)dtoa_fast_pow10[k], k);
+            q += k;
+            *q = '\0';
+            return q - buf;
+        }
+    }
+    return -1;
+}
+
 /* return the length */
 int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
             JSDTOATempMem *tmp_mem)
@@ -1114,6 +1167,14 @@ int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
     mpb_t *tmp1, *mant_max;
     int fmt = flags & JS_DTOA_FORMAT_MASK;
 
+    if (radix == 10 && fmt == JS_DTOA_FORMAT_FREE &&
+        (flags & JS_DTOA_EXP_MASK) == JS_DTOA_EXP_AUTO &&
+        !((flags & JS_DTOA_MINUS_ZERO) && d == 0)) {
+        l = js_dtoa_fast(buf, d);
+        if (l >= 0)
+            return l;
+    }
+
     tmp1 = dtoa_malloc(&mptr, sizeof(mpb_t) + sizeof(limb_t) * DBIGNUM_LEN_MAX);
     mant_max = dtoa_malloc(&mptr, sizeof(mpb_t) + sizeof(limb_t) * MANT_LEN_MAX);
     assert((mptr - tmp_mem->mem) <= sizeof(JSDTOATempMem) / sizeof(mptr[0]));
@@ -67,6 +67,9 @@ int js_dtoa_max_len(double d, int radix, int n_digits, int flags);
 /* return the string length */
 int js_dtoa(char *buf, double d, int radix, int n_digits, int flags,
             JSDTOATempMem *tmp_mem);
+/* radix 10, JS_DTOA_FORMAT_FREE conversion without temporary memory for
+   small integers and short decimals. Return -1 if not handled. */
+int js_dtoa_fast(char *buf, double d);
 double js_atod(const char *str, const char **pnext, int radix, int flags,
                JSATODTempMem *tmp_mem);
 
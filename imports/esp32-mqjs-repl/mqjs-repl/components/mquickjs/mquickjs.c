@@ -215,6 +215,10 @@ struct JSContext {
     JSValue *fp; /* current frame pointer, stack_top if none */
     uint32_t min_free_size; /* min free size between heap_free and the
                                bottom of the stack */
+    uint32_t min_free_seen; /* smallest free gap observed (arena high
+                               water mark, see JS_GetMemoryUsage()) */
+    uint32_t gc_count; /* number of JS_GC() runs */
+    uint32_t live_peak; /* largest heap + stack size after a GC */
     BOOL in_out_of_memory : 8; /* != 0 if generating the out of memory object */
     uint8_t n_rom_atom_tables;
     uint8_t string_pos_cache_counter; /* used for string_pos_cache[] update */
@@ -233,6 +237,7 @@ struct JSContext {
     const JSCFinalizer *c_finalizer_table;
     uint64_t random_state;
     JSInterruptHandler *interrupt_handler;
+    JSAllocHook *alloc_hook; /* allocation profiler, NULL if disabled */
     JSWriteFunc *write_func; /* for the various dump functions */
     void *opaque;
     JSValue *class_obj; /* same as class_proto + class_count */
@@ -497,6 +502,7 @@ static int js_get_mtag(void *ptr)
 
 static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
 {
+    uint32_t free_size;
 #ifdef DEBUG_GC
     assert(ctx->sp >= stack_bottom);
     /* don't start the GC before dummy_block is allocated */
@@ -511,6 +517,9 @@ static int check_free_mem(JSContext *ctx, JSValue *stack_bottom, uint32_t size)
             return -1;
         }
     }
+    free_size = ((uint8_t *)stack_bottom - ctx->heap_free) - size;
+    if (free_size < ctx->min_free_seen)
+        ctx->min_free_seen = free_size;
     return 0;
 }
 
@@ -545,6 +554,8 @@ static void *js_malloc(JSContext *ctx, uint32_t size, int mtag)
     p->mtag = mtag;
     p->gc_mark = 0;
     p->dummy = 0;
+    if (unlikely(ctx->alloc_hook))
+        ctx->alloc_hook(ctx, ctx->opaque, mtag, size);
     return p;
 }
 
@@ -1739,9 +1750,100 @@ static int string_buffer_concat(JSContext *ctx, StringBuffer *s, JSValue val2)
     return string_buffer_concat_str(ctx, s, val2);
 }
 
-/* XXX: could optimize */
+/* Append bytes to a byte array buffer, growing it if needed. 'buf' must
+   not point inside the JS heap. Return 0 if OK, -1 in case of
+   exception. */
+static int string_buffer_write8(JSContext *ctx, StringBuffer *s,
+                                const char *buf, int len, BOOL is_ascii)
+{
+    JSByteArray *arr;
+
+    if (JS_IsException(s->buffer))
+        return -1;
+    if (len == 0)
+        return 0;
+    if (JS_IsString(ctx, s->buffer)) {
+        JSGCRef s_ref;
+        JSValue val;
+        JS_PUSH_STRING_BUFFER(ctx, s);
+        val = JS_NewStringLen(ctx, buf, len);
+        JS_POP_STRING_BUFFER(ctx, s);
+        if (JS_IsException(val)) {
+            s->buffer = JS_EXCEPTION;
+            return -1;
+        }
+        return string_buffer_concat_str(ctx, s, val);
+    }
+    arr = JS_VALUE_TO_PTR(s->buffer);
+    if (s->len + len + 1 > arr->size) {
+        if (s->len + len > JS_STRING_LEN_MAX) {
+            s->buffer = JS_ThrowInternalError(ctx, "string too long");
+            return -1;
+        }
+        s->buffer = js_resize_byte_array(ctx, s->buffer, s->len + len + 1);
+        if (JS_IsException(s->buffer))
+            return -1;
+        arr = JS_VALUE_TO_PTR(s->buffer);
+    }
+    memcpy(arr->buf + s->len, buf, len);
+    s->len += len;
+    s->is_ascii &= is_ascii;
+    return 0;
+}
+
+/* Append the UTF-8 bytes [start, start + len) of the string '*pstr'
+   without creating a sub string. '*pstr' must be a GC root, it is
+   reloaded if the buffer is resized. The range must not start or end
+   with a surrogate half. */
+static int string_buffer_write_str(JSContext *ctx, StringBuffer *s,
+                                   JSValue *pstr, int start, int len)
+{
+    JSStringCharBuf buf;
+    JSByteArray *arr;
+    JSString *p;
+    BOOL is_ascii;
+    int i;
+
+    if (JS_IsException(s->buffer))
+        return -1;
+    if (len == 0)
+        return 0;
+    if (JS_IsString(ctx, s->buffer))
+        return string_buffer_concat_utf8(ctx, s, *pstr, start, start + len);
+    arr = JS_VALUE_TO_PTR(s->buffer);
+    if (s->len + len + 1 > arr->size) {
+        if (s->len + len > JS_STRING_LEN_MAX) {
+            s->buffer = JS_ThrowInternalError(ctx, "string too long");
+            return -1;
+        }
+        s->buffer = js_resize_byte_array(ctx, s->buffer, s->len + len + 1);
+        if (JS_IsException(s->buffer))
+            return -1;
+        arr = JS_VALUE_TO_PTR(s->buffer);
+    }
+    p = get_string_ptr(ctx, &buf, *pstr);
+    is_ascii = p->is_ascii;
+    if (!is_ascii) {
+        is_ascii = TRUE;
+        for(i = start; i < start + len; i++) {
+            if (p->buf[i] >= 0x80) {
+                is_ascii = FALSE;
+                break;
+            }
+        }
+    }
+    memcpy(arr->buf + s->len, p->buf + start, len);
+    s->len += len;
+    s->is_ascii &= is_ascii;
+    return 0;
+}
+
 static int string_buffer_putc(JSContext *ctx, StringBuffer *s, int c)
 {
+    if (c < 0x80 && !JS_IsString(ctx, s->buffer)) {
+        char ch = c;
+        return string_buffer_write8(ctx, s, &ch, 1, TRUE);
+    }
     return string_buffer_concat_str(ctx, s, JS_NewStringChar(c));
 }
 
@@ -3542,6 +3644,7 @@ JSContext *JS_NewContext2(void *mem_start, size_t mem_size, const JSSTDLibraryDe
     ctx->stack_bottom = ctx->sp;
     ctx->fp = ctx->sp;
     ctx->min_free_size = JS_MIN_FREE_SIZE;
+    ctx->min_free_seen = ctx->stack_top - ctx->heap_base;
 #ifdef DEBUG_GC
     ctx->dummy_block = JS_NULL;
     ctx->unique_strings = JS_NULL;
@@ -4069,6 +4172,13 @@ static JSValue js_dtoa2(JSContext *ctx, double d, int radix, int n_digits, int f
     JSGCRef str_ref;
     JSByteArray *tmp_arr, *p;
 
+    if (radix == 10 && n_digits == 0 && flags == JS_DTOA_FORMAT_FREE) {
+        char buf[32];
+        /* common case: no temporary buffers in the heap */
+        len = js_dtoa_fast(buf, d);
+        if (len >= 0)
+            return JS_NewStringLen(ctx, buf, len);
+    }
     len_max = js_dtoa_max_len(d, radix, n_digits, flags);
     p = js_alloc_byte_array(ctx, len_max + 1);
     if (!p)
@@ -12417,8 +12527,15 @@ static void JS_GC2(JSContext *ctx, BOOL keep_atoms)
         }
     }
 #endif
+    ctx->gc_count++;
     gc_mark_all(ctx, keep_atoms);
     gc_compact_heap(ctx);
+    {
+        uint32_t live = (ctx->heap_free - ctx->heap_base) +
+            (ctx->stack_top - (uint8_t *)ctx->sp);
+        if (live > ctx->live_peak)
+            ctx->live_peak = live;
+    }
 #ifdef DUMP_GC
     js_printf(ctx, "AFTER: heap size=%u/%u stack_size=%u\n",
            (uint32_t)(ctx->heap_free - ctx->heap_base),
@@ -12432,6 +12549,103 @@ void JS_GC(JSContext *ctx)
     JS_GC2(ctx, TRUE);
 }
 
+void JS_GetMemoryUsage(JSContext *ctx, JSMemoryUsage *s)
+{
+    s->arena_size = ctx->stack_top - ctx->heap_base;
+    s->heap_size = ctx->heap_free - ctx->heap_base;
+    s->stack_size = ctx->stack_top - (uint8_t *)ctx->sp;
+    s->peak_size = s->arena_size - ctx->min_free_seen;
+    s->live_peak_size = ctx->live_peak;
+    s->gc_count = ctx->gc_count;
+}
+
+void JS_ResetMemoryUsage(JSContext *ctx)
+{
+    ctx->min_free_seen = (uint8_t *)ctx->stack_bottom - ctx->heap_free;
+    ctx->live_peak = (ctx->heap_free - ctx->heap_base) +
+        (ctx->stack_top - (uint8_t *)ctx->sp);
+    ctx->gc_count = 0;
+}
+
+void JS_SetAllocHook(JSContext *ctx, JSAllocHook *alloc_hook)
+{
+    ctx->alloc_hook = alloc_hook;
+}
+
+const char *JS_GetMTagName(int mtag)
+{
+    if (mtag < 0 || mtag >= countof(js_mtag_name))
+        return "?";
+    return js_mtag_name[mtag];
+}
+
+/* no memory allocation is done */
+void JS_WalkHeap(JSContext *ctx, JSHeapWalkFunc *func, void *opaque)
+{
+    uint8_t *ptr;
+    int mtag, class_id;
+    uint32_t size;
+
+    ptr = ctx->heap_base;
+    while (ptr < ctx->heap_free) {
+        mtag = ((JSMemBlockHeader *)ptr)->mtag;
+        size = get_mblock_size(ptr);
+        if (mtag != JS_MTAG_FREE) {
+            if (mtag == JS_MTAG_OBJECT)
+                class_id = ((JSObject *)ptr)->class_id;
+            else
+                class_id = -1;
+            func(opaque, mtag, class_id, size);
+        }
+        ptr += size;
+    }
+}
+
+/* no memory allocation is done */
+const char *JS_GetClassName(JSContext *ctx, int class_id, JSCStringBuf *buf)
+{
+    JSFunctionBytecode *b;
+    if (class_id < 0 || class_id >= ctx->class_count)
+        return NULL;
+    return get_func_name(ctx, ctx->class_obj[class_id], buf, &b);
+}
+
+/* no memory allocation is done */
+int JS_GetCallSite(JSContext *ctx, char *buf, int buf_size)
+{
+    JSValue *fp;
+    JSFunctionBytecode *b;
+    JSCStringBuf name_buf, filename_buf;
+    const char *name, *filename;
+    int pc, line_num, col_num;
+    char *p;
+
+    if (buf_size <= 0)
+        return 0;
+    p = buf;
+    buf[0] = '\0';
+    if (ctx->parse_state) {
+        cprintf(&p, buf + buf_size, "<parser>");
+        return p - buf;
+    }
+    /* report the innermost bytecode function, so that allocations
+       done by native functions are charged to their JS caller */
+    for(fp = ctx->fp; fp != (JSValue *)ctx->stack_top;
+        fp = VALUE_TO_SP(ctx, fp[FRAME_OFFSET_SAVED_FP])) {
+        name = get_func_name(ctx, fp[FRAME_OFFSET_FUNC_OBJ], &name_buf, &b);
+        if (!b)
+            continue;
+        if (!name || name[0] == '\0')
+            name = "<anonymous>";
+        filename = JS_ToCString(ctx, b->filename, &filename_buf);
+        pc = JS_VALUE_GET_INT(fp[FRAME_OFFSET_CUR_PC]) - 1;
+        line_num = find_line_col(&col_num, b, pc);
+        cprintf(&p, buf + buf_size, "%s (%s:%d)", name, filename, line_num);
+        return p - buf;
+    }
+    return 0;
+}
+
 /* bytecode saving and loading */
 
 #define JS_BYTECODE_VERSION_32 0x0001
@@ -15384,8 +15598,21 @@ static int js_to_quoted_string(JSContext *ctx, StringBuffer *b, JSValue str)
 
     i = 0;
     for(;;) {
-        /* XXX: inefficient */
+        int start = i;
         p = get_string_ptr(ctx, &buf, str_ref.val);
+        /* copy the runs which need no escaping in one go. 0xed starts
+           U+D000..U+DFFF, which includes the surrogate halves */
+        while (i < p->len) {
+            c = p->buf[i];
+            if (c < 32 || c == '\"' || c == '\\' || c == 0xed)
+                break;
+            i++;
+        }
+        if (i > start) {
+            if (string_buffer_write_str(ctx, b, &str_ref.val, start, i - start))
+                break;
+            p = get_string_ptr(ctx, &buf, str_ref.val);
+        }
         if (i >= p->len)
             break;
         c = utf8_get(p->buf + i, &clen);
@@ -15464,7 +15691,10 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
         *pspace = js_get_atom(ctx, JS_ATOM_empty);
     }
 #endif
-    string_buffer_init(ctx, b, 0);
+    /* start with a byte buffer so that the output is appended in
+       place instead of through intermediate strings */
+    if (string_buffer_init(ctx, b, 64))
+        return JS_EXCEPTION;
     stack_top = ctx->sp;
 
     /* XXX: could push the string buffer once */
@@ -15575,8 +15805,16 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                 *--ctx->sp = val;
             end_obj: ;
             }
+        } else if (JS_IsInt(obj)) {
+            char buf[16];
+            /* numbers are written directly, without a temporary string */
+            if (string_buffer_write8(ctx, b, buf, i32toa(buf, JS_VALUE_GET_INT(obj)), TRUE))
+                goto fail;
+            ctx->sp += JSON_REC_SIZE;
         } else if (JS_IsNumber(ctx, obj)) {
             double d;
+            char buf[32];
+            int len;
             JS_PUSH_STRING_BUFFER(ctx, b);
             ret = JS_ToNumber(ctx, &d, obj);
             JS_POP_STRING_BUFFER(ctx, b);
@@ -15584,7 +15822,12 @@ JSValue js_json_stringify(JSContext *ctx, JSValue *this_val,
                 goto fail;
             if (!isfinite(d))
                 goto output_null;
-            goto to_string;
+            len = js_dtoa_fast(buf, d);
+            if (len < 0)
+                goto to_string;
+            if (string_buffer_write8(ctx, b, buf, len, TRUE))
+                goto fail;
+            ctx->sp += JSON_REC_SIZE;
         } else if (JS_IsBool(obj)) {
         to_string:
             if (string_buffer_concat(ctx, b, obj))
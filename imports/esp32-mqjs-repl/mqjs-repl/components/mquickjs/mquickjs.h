@@ -300,6 +300,38 @@ JSValue JS_Run(JSContext *ctx, JSValue val);
 JSValue JS_Eval(JSContext *ctx, const char *input, size_t input_len,
                 const char *filename, int eval_flags);
 void JS_GC(JSContext *ctx);
+
+typedef struct {
+    uint32_t arena_size; /* heap + free area + stack, excluding JSContext */
+    uint32_t heap_size; /* currently allocated heap bytes */
+    uint32_t stack_size; /* currently used stack bytes */
+    uint32_t peak_size; /* high water mark of heap + reserved stack, garbage
+                           included: close to arena_size once a GC ran */
+    uint32_t live_peak_size; /* largest heap + stack size seen after a GC */
+    uint32_t gc_count; /* number of GC runs */
+} JSMemoryUsage;
+
+void JS_GetMemoryUsage(JSContext *ctx, JSMemoryUsage *s);
+/* restart the peak and GC counters from the current state */
+void JS_ResetMemoryUsage(JSContext *ctx);
+
+/* Allocation profiling. The hook is called after each successful
+   heap allocation with ctx->opaque and must not allocate in the JS
+   heap. 'size' includes the block header. */
+typedef void JSAllocHook(JSContext *ctx, void *opaque, int mtag, uint32_t size);
+void JS_SetAllocHook(JSContext *ctx, JSAllocHook *alloc_hook);
+/* call 'func' for every allocated heap block. 'class_id' is -1 for
+   blocks which are not objects. Run JS_GC() first to only see live
+   blocks. */
+typedef void JSHeapWalkFunc(void *opaque, int mtag, int class_id, uint32_t size);
+void JS_WalkHeap(JSContext *ctx, JSHeapWalkFunc *func, void *opaque);
+const char *JS_GetMTagName(int mtag);
+/* constructor name of the class or NULL if not yet defined */
+const char *JS_GetClassName(JSContext *ctx, int class_id, JSCStringBuf *buf);
+/* "func (file:line)" of the innermost running bytecode function. Return
+   the length written to 'buf' or 0 if no JS function is running. */
+int JS_GetCallSite(JSContext *ctx, char *buf, int buf_size);
+
 JSValue JS_NewStringLen(JSContext *ctx, const char *buf, size_t buf_len);
 JSValue JS_NewString(JSContext *ctx, const char *buf);
 const char *JS_ToCStringLen(JSContext *ctx, size_t *plen, JSValue val, JSCStringBuf *buf);
@@ -37,6 +37,15 @@ class IEvaluator {
     return false;
   }
 
+  virtual bool Profile(std::string_view action, std::string* out, std::string* error) {
+    (void)action;
+    (void)out;
+    if (error) {
+      *error = "profiling is not supported";
+    }
+    return false;
+  }
+
   virtual bool Autoload(bool format_if_mount_failed, std::string* out, std::string* error) {
     (void)format_if_mount_failed;
     (void)out;
@@ -11,20 +11,23 @@ extern "C" {
 extern const JSSTDLibraryDef js_stdlib;
 }
 
+#include "esp_heap_caps.h"
+
+#include "sdkconfig.h"
+
 #include "mqjs_vm.h"
 #include "storage/Spiffs.h"
 
-uint8_t JsEvaluator::js_mem_buf_[JsEvaluator::kJsMemSize];
+#if CONFIG_MQJS_REPL_JS_ARENA_PSRAM
+static constexpr uint32_t kJsArenaCaps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+#else
+static constexpr uint32_t kJsArenaCaps = 0;
+#endif
 
 JsEvaluator::JsEvaluator() {
-  MqjsVmConfig cfg = {};
-  cfg.arena = js_mem_buf_;
-  cfg.arena_bytes = kJsMemSize;
-  cfg.stdlib = &js_stdlib;
-  cfg.fix_global_this = true;
-
-  MqjsVm* vm = MqjsVm::Create(cfg);
-  ctx_ = vm ? vm->ctx() : nullptr;
+  arena_bytes_ = CONFIG_MQJS_REPL_JS_MEM_BYTES;
+  arena_ = static_cast<uint8_t*>(MqjsVm::AllocArena(arena_bytes_, kJsArenaCaps, &arena_in_psram_));
+  (void)CreateContext();
 }
 
 JsEvaluator::~JsEvaluator() {
@@ -32,6 +35,24 @@ JsEvaluator::~JsEvaluator() {
     MqjsVm::DestroyContext(ctx_);
     ctx_ = nullptr;
   }
+  free(arena_);
+  arena_ = nullptr;
+}
+
+bool JsEvaluator::CreateContext() {
+  if (!arena_) {
+    return false;
+  }
+
+  MqjsVmConfig cfg = {};
+  cfg.arena = arena_;
+  cfg.arena_bytes = arena_bytes_;
+  cfg.stdlib = &js_stdlib;
+  cfg.fix_global_this = true;
+
+  MqjsVm* vm = MqjsVm::Create(cfg);
+  ctx_ = vm ? vm->ctx() : nullptr;
+  return ctx_ != nullptr;
 }
 
 EvalResult JsEvaluator::EvalLine(std::string_view line) {
@@ -70,17 +91,9 @@ bool JsEvaluator::Reset(std::string* error) {
     ctx_ = nullptr;
   }
 
-  MqjsVmConfig cfg = {};
-  cfg.arena = js_mem_buf_;
-  cfg.arena_bytes = kJsMemSize;
-  cfg.stdlib = &js_stdlib;
-  cfg.fix_global_this = true;
-
-  MqjsVm* vm = MqjsVm::Create(cfg);
-  ctx_ = vm ? vm->ctx() : nullptr;
-  if (!ctx_) {
+  if (!CreateContext()) {
     if (error) {
-      *error = "failed to recreate JS context";
+      *error = arena_ ? "failed to recreate JS context" : "JS arena allocation failed";
     }
     return false;
   }
@@ -100,11 +113,57 @@ bool JsEvaluator::GetStats(std::string* out) {
     return true;
   }
 
+  char arena[96];
+  snprintf(arena,
+           sizeof(arena),
+           "js_arena=%u js_arena_where=%s\n",
+           static_cast<unsigned>(arena_bytes_),
+           arena_in_psram_ ? "psram" : "internal");
+
   MqjsVm* vm = MqjsVm::From(ctx_);
-  *out = vm ? vm->DumpMemory(false) : "js: <no vm>\n";
+  *out = arena;
+  *out += vm ? vm->DumpMemory(false) : "js: <no vm>\n";
   return true;
 }
 
+bool JsEvaluator::Profile(std::string_view action, std::string* out, std::string* error) {
+  if (!out) {
+    if (error) {
+      *error = "missing output buffer";
+    }
+    return false;
+  }
+  out->clear();
+
+  MqjsVm* vm = ctx_ ? MqjsVm::From(ctx_) : nullptr;
+  if (!vm) {
+    if (error) {
+      *error = "JS context is not initialized";
+    }
+    return false;
+  }
+
+  if (action == "start") {
+    vm->StartAllocProfile();
+    *out = "prof: started (allocations are slower while profiling)\n";
+    return true;
+  }
+  if (action == "stop") {
+    vm->StopAllocProfile();
+    *out = "prof: stopped\n";
+    return true;
+  }
+  if (action.empty() || action == "dump") {
+    *out = vm->DumpAllocProfile();
+    return true;
+  }
+
+  if (error) {
+    *error = "usage: :prof [start|stop|dump]";
+  }
+  return false;
+}
+
 bool JsEvaluator::Autoload(bool format_if_mount_failed, std::string* out, std::string* error) {
   if (!out) {
     if (error) {
@@ -18,11 +18,15 @@ class JsEvaluator final : public IEvaluator {
   EvalResult EvalLine(std::string_view line) override;
   bool Reset(std::string* error) override;
   bool GetStats(std::string* out) override;
+  bool Profile(std::string_view action, std::string* out, std::string* error) override;
   bool Autoload(bool format_if_mount_failed, std::string* out, std::string* error) override;
 
  private:
-  static constexpr size_t kJsMemSize = 64 * 1024;
-  static uint8_t js_mem_buf_[kJsMemSize];
+  bool CreateContext();
 
+  // Heap-allocated (PSRAM when enabled) so the size is a Kconfig choice rather than .bss.
+  uint8_t* arena_ = nullptr;
+  size_t arena_bytes_ = 0;
+  bool arena_in_psram_ = false;
   JSContext* ctx_ = nullptr;
 };
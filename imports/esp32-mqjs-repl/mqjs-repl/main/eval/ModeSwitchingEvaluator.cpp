@@ -87,6 +87,16 @@ bool ModeSwitchingEvaluator::GetStats(std::string* out) {
   return current_->GetStats(out);
 }
 
+bool ModeSwitchingEvaluator::Profile(std::string_view action, std::string* out, std::string* error) {
+  if (!current_) {
+    if (error) {
+      *error = "no evaluator selected";
+    }
+    return false;
+  }
+  return current_->Profile(action, out, error);
+}
+
 bool ModeSwitchingEvaluator::Autoload(bool format_if_mount_failed, std::string* out, std::string* error) {
   if (!current_) {
     if (error) {
@@ -82,6 +82,7 @@ void ReplLoop::HandleLine(IConsole& console, LineEditor& editor, IEvaluator& eva
     console.WriteString(
         "  :reset         Reset current evaluator\n"
         "  :stats         Print memory stats\n"
+        "  :prof [start|stop|dump]  Allocation profiler\n"
         "  :autoload      Run /spiffs/autoload/*.js\n"
         "  :autoload --format  Format+mount SPIFFS if needed\n"
         "  :prompt TEXT   Set prompt\n");
@@ -149,6 +150,23 @@ void ReplLoop::HandleLine(IConsole& console, LineEditor& editor, IEvaluator& eva
     return;
   }
 
+  if (stripped == ":prof" || stripped.rfind(":prof ", 0) == 0) {
+    const std::string action = (stripped == ":prof") ? std::string() : trim(stripped.substr(sizeof(":prof ") - 1));
+    std::string output;
+    std::string error;
+    if (!evaluator.Profile(action, &output, &error)) {
+      console.WriteString("error: ");
+      console.WriteString(error.c_str());
+      console.WriteString("\n");
+      return;
+    }
+    if (!output.empty()) {
+      console.Write(reinterpret_cast<const uint8_t*>(output.data()),
+                    static_cast<int>(output.size()));
+    }
+    return;
+  }
+
   if (stripped == ":autoload" || stripped.rfind(":autoload ", 0) == 0) {
     const bool format = stripped.find("--format") != std::string::npos;
     std::string output;
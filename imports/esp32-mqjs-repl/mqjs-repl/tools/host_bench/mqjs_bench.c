@@ -0,0 +1,396 @@
+/*
+ * Host benchmark driver for MicroQuickJS + the ESP stdlib bindings.
+ *
+ * Built by tools/run_host_bench.sh against the same stdlib definition the
+ * firmware uses (tools/esp_stdlib_gen/esp_stdlib.c), with host stand-ins for
+ * the GPIO/I2C control-plane calls. Each workload gets a fresh context in a
+ * fixed-size arena, so GC counts are comparable across runs. The arena peak is
+ * measured separately: the GC only runs once the arena is full, so the engine's
+ * own high-water mark always sits at the arena size.
+ *
+ * Output is one JSON object per line (JSONL) on stdout; diagnostics go to
+ * stderr.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mquickjs.h"
+
+/* Counts calls that would cross into the control plane on the device. */
+static uint64_t g_binding_calls;
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static JSValue js_date_now(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    return JS_NewInt64(ctx, now_us() / 1000);
+}
+
+static JSValue js_performance_now(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    return JS_NewInt64(ctx, now_us() / 1000);
+}
+
+static JSValue js_load(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    return JS_ThrowTypeError(ctx, "load() not supported in the benchmark");
+}
+
+static JSValue js_setTimeout(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    return JS_ThrowTypeError(ctx, "setTimeout() not supported in the benchmark");
+}
+
+static JSValue js_clearTimeout(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    return JS_ThrowTypeError(ctx, "clearTimeout() not supported in the benchmark");
+}
+
+static JSValue js_print(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    int i;
+    (void)this_val;
+    for (i = 0; i < argc; i++) {
+        if (i != 0)
+            fputc(' ', stderr);
+        if (JS_IsString(ctx, argv[i])) {
+            JSCStringBuf buf;
+            size_t len;
+            const char *str = JS_ToCStringLen(ctx, &len, argv[i], &buf);
+            fwrite(str, 1, len, stderr);
+        } else {
+            JS_PrintValueF(ctx, argv[i], JS_DUMP_LONG);
+        }
+    }
+    fputc('\n', stderr);
+    return JS_UNDEFINED;
+}
+
+static JSValue js_gc(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val; (void)argc; (void)argv;
+    JS_GC(ctx);
+    return JS_UNDEFINED;
+}
+
+/* Binding stand-ins: validate arguments the way the firmware does, then
+   drop the request instead of posting it to the control plane. */
+static JSValue binding_ints(JSContext *ctx, int argc, JSValue *argv, int nargs)
+{
+    int i, v;
+    for (i = 0; i < nargs && i < argc; i++) {
+        if (JS_ToInt32(ctx, &v, argv[i]))
+            return JS_EXCEPTION;
+    }
+    g_binding_calls++;
+    return JS_UNDEFINED;
+}
+
+static JSValue js_gpio_high(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 1);
+}
+
+static JSValue js_gpio_low(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 1);
+}
+
+static JSValue js_gpio_square(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 2);
+}
+
+static JSValue js_gpio_pulse(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 3);
+}
+
+static JSValue js_gpio_set_many(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)ctx; (void)this_val; (void)argc; (void)argv;
+    g_binding_calls++;
+    return JS_UNDEFINED;
+}
+
+static JSValue js_gpio_stop(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 1);
+}
+
+static JSValue js_i2c_config(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 5);
+}
+
+static JSValue js_i2c_scan(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 3);
+}
+
+static JSValue js_i2c_write_reg(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 2);
+}
+
+static JSValue js_i2c_read_reg(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 2);
+}
+
+static JSValue js_i2c_deconfig(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)ctx; (void)this_val; (void)argc; (void)argv;
+    g_binding_calls++;
+    return JS_UNDEFINED;
+}
+
+static JSValue js_i2c_tx(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)ctx; (void)this_val; (void)argc; (void)argv;
+    g_binding_calls++;
+    return JS_UNDEFINED;
+}
+
+static JSValue js_i2c_txrx(JSContext *ctx, JSValue *this_val, int argc, JSValue *argv)
+{
+    (void)this_val;
+    return binding_ints(ctx, argc, argv, 1);
+}
+
+#include "esp_stdlib.h"
+
+static uint8_t *load_file(const char *filename, size_t *plen)
+{
+    FILE *f;
+    uint8_t *buf;
+    long len;
+
+    f = fopen(filename, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: %s\n", filename, strerror(errno));
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc(len + 1);
+    if (buf && fread(buf, 1, len, f) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (!buf)
+        return NULL;
+    buf[len] = '\0';
+    *plen = len;
+    return buf;
+}
+
+static void log_func(void *opaque, const void *buf, size_t buf_len)
+{
+    (void)opaque;
+    fwrite(buf, 1, buf_len, stderr);
+}
+
+static void dump_error(JSContext *ctx, const char *what)
+{
+    fprintf(stderr, "%s: ", what);
+    JS_PrintValueF(ctx, JS_GetException(ctx), JS_DUMP_LONG);
+    fputc('\n', stderr);
+}
+
+static JSValue call_run(JSContext *ctx)
+{
+    JSValue fn = JS_GetPropertyStr(ctx, JS_GetGlobalObject(ctx), "run");
+    if (JS_IsException(fn))
+        return fn;
+    if (JS_StackCheck(ctx, 2))
+        return JS_EXCEPTION;
+    JS_PushArg(ctx, fn);
+    JS_PushArg(ctx, JS_NULL);
+    return JS_Call(ctx, 0);
+}
+
+/* Basename without directory or extension, used as the workload id. */
+static void workload_name(const char *path, char *out, size_t out_len)
+{
+    const char *base = strrchr(path, '/');
+    size_t n;
+    base = base ? base + 1 : path;
+    n = strcspn(base, ".");
+    if (n >= out_len)
+        n = out_len - 1;
+    memcpy(out, base, n);
+    out[n] = '\0';
+}
+
+/* Non-zero if the script loads and `runs` calls of run() succeed in a fresh arena. */
+static int workload_fits(const char *path, const uint8_t *src, size_t src_len, size_t arena_bytes, int runs)
+{
+    void *arena = malloc(arena_bytes);
+    JSContext *ctx;
+    int ok;
+    int i;
+
+    if (!arena)
+        return 0;
+    ctx = JS_NewContext(arena, arena_bytes, &js_stdlib);
+    ok = !JS_IsException(JS_Eval(ctx, (const char *)src, src_len, path, 0));
+    for (i = 0; ok && i < runs; i++)
+        ok = !JS_IsException(call_run(ctx));
+    JS_FreeContext(ctx);
+    free(arena);
+    return ok;
+}
+
+/* Smallest arena (to PEAK_STEP bytes) in [lo, hi] the workload runs in; hi must fit. */
+#define PEAK_STEP 256
+#define PEAK_RUNS 20
+
+static size_t min_arena_bytes(const char *path, const uint8_t *src, size_t src_len, size_t lo, size_t hi,
+                              int runs)
+{
+    while (hi - lo > PEAK_STEP) {
+        size_t mid = (lo + (hi - lo) / 2) & ~(size_t)7;
+        if (workload_fits(path, src, src_len, mid, runs))
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return hi;
+}
+
+static int run_workload(const char *path, size_t arena_bytes, int min_ms, int warmup)
+{
+    char name[64];
+    uint8_t *src;
+    size_t src_len;
+    void *arena;
+    JSContext *ctx;
+    JSValue val;
+    JSMemoryUsage mu;
+    int64_t t0, t1, deadline;
+    uint64_t iters = 0, binding_calls0;
+    size_t overhead, peak;
+    int i, ret = 1;
+
+    workload_name(path, name, sizeof(name));
+    src = load_file(path, &src_len);
+    if (!src)
+        return 1;
+    arena = malloc(arena_bytes);
+    if (!arena) {
+        free(src);
+        return 1;
+    }
+    ctx = JS_NewContext(arena, arena_bytes, &js_stdlib);
+    JS_SetLogFunc(ctx, log_func);
+
+    val = JS_Eval(ctx, (const char *)src, src_len, path, 0);
+    if (JS_IsException(val)) {
+        dump_error(ctx, name);
+        goto done;
+    }
+    for (i = 0; i < warmup; i++) {
+        if (JS_IsException(call_run(ctx))) {
+            dump_error(ctx, name);
+            goto done;
+        }
+    }
+
+    JS_GC(ctx);
+    JS_ResetMemoryUsage(ctx);
+    binding_calls0 = g_binding_calls;
+    t0 = now_us();
+    deadline = t0 + (int64_t)min_ms * 1000;
+    do {
+        if (JS_IsException(call_run(ctx))) {
+            dump_error(ctx, name);
+            goto done;
+        }
+        iters++;
+        t1 = now_us();
+    } while (t1 < deadline);
+
+    JS_GetMemoryUsage(ctx, &mu);
+    /* The live peak always has to fit, so the search starts there. */
+    overhead = arena_bytes - mu.arena_size;
+    peak = min_arena_bytes(path, src, src_len, overhead + mu.live_peak_size, arena_bytes,
+                           warmup + PEAK_RUNS) - overhead;
+    printf("{\"workload\":\"%s\",\"jsvalue_bits\":%d,\"arena_bytes\":%u,"
+           "\"iterations\":%" PRIu64 ",\"elapsed_us\":%" PRId64 ","
+           "\"ops_per_sec\":%.1f,\"peak_arena_bytes\":%u,\"peak_live_bytes\":%u,"
+           "\"heap_bytes\":%u,"
+           "\"gc_count\":%u,\"binding_calls\":%" PRIu64 "}\n",
+           name, JSW * 8, (unsigned)mu.arena_size, iters, t1 - t0,
+           (double)iters * 1e6 / (double)(t1 - t0), (unsigned)peak,
+           (unsigned)mu.live_peak_size, (unsigned)mu.heap_size, (unsigned)mu.gc_count,
+           g_binding_calls - binding_calls0);
+    fflush(stdout);
+    ret = 0;
+done:
+    JS_FreeContext(ctx);
+    free(arena);
+    free(src);
+    return ret;
+}
+
+static void help(void)
+{
+    fprintf(stderr,
+            "usage: mqjs_bench [options] workload.js...\n"
+            "-m  --memory-limit n  arena size in KiB (default 64, matches the REPL)\n"
+            "-t  --time ms         minimum measured time per workload (default 500)\n"
+            "-w  --warmup n        untimed warmup iterations (default 3)\n");
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    size_t arena_bytes = 64 * 1024;
+    int min_ms = 500, warmup = 3, i, failures = 0;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        const char *opt = argv[i];
+        if (i + 1 >= argc)
+            help();
+        if (!strcmp(opt, "-m") || !strcmp(opt, "--memory-limit"))
+            arena_bytes = (size_t)strtoul(argv[++i], NULL, 0) * 1024;
+        else if (!strcmp(opt, "-t") || !strcmp(opt, "--time"))
+            min_ms = atoi(argv[++i]);
+        else if (!strcmp(opt, "-w") || !strcmp(opt, "--warmup"))
+            warmup = atoi(argv[++i]);
+        else
+            help();
+    }
+    if (i >= argc)
+        help();
+    for (; i < argc; i++)
+        failures += run_workload(argv[i], arena_bytes, min_ms, warmup);
+    return failures ? 1 : 0;
+}
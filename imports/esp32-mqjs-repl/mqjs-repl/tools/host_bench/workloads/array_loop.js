@@ -0,0 +1,12 @@
+// Array loops: indexed fill, sum, and the callback-based builtins.
+var data = [];
+for (var i = 0; i < 256; i++) data.push(i);
+
+function run() {
+  var sum = 0;
+  for (var i = 0; i < data.length; i++) data[i] = (data[i] * 7 + 3) & 255;
+  for (var j = 0; j < data.length; j++) sum += data[j];
+  var evens = data.filter(function (v) { return (v & 1) === 0; });
+  var scaled = evens.map(function (v) { return v >> 1; });
+  return sum + scaled.length;
+}
@@ -0,0 +1,17 @@
+// Closures: create counters capturing outer variables and call them.
+function makeCounter(step) {
+  var n = 0;
+  return function () {
+    n += step;
+    return n;
+  };
+}
+
+function run() {
+  var total = 0;
+  for (var i = 0; i < 50; i++) {
+    var c = makeCounter(i);
+    total += c() + c() + c();
+  }
+  return total;
+}
@@ -0,0 +1,9 @@
+// ESP stdlib bindings: per-call overhead of the gpio/i2c native functions.
+function run() {
+  for (var i = 0; i < 50; i++) {
+    if (i & 1) gpio.high(1);
+    else gpio.low(1);
+  }
+  for (var j = 0; j < 10; j++) i2c.readReg(0x10 + j, 1);
+  return i + j;
+}
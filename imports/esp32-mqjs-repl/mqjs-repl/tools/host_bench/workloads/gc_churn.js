@@ -0,0 +1,11 @@
+// GC churn: many short-lived arrays and objects with a small retained set.
+var keep = [];
+
+function run() {
+  for (var i = 0; i < 100; i++) {
+    var tmp = [i, i + 1, i + 2, { v: i }];
+    if ((i % 25) === 0) keep.push(tmp);
+  }
+  if (keep.length > 64) keep = [];
+  return keep.length;
+}
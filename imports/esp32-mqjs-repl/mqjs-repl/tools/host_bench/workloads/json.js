@@ -0,0 +1,14 @@
+// JSON round trip of a status-sized object, similar to the HTTP endpoints.
+var status = {
+  uptime_ms: 123456,
+  wifi: { connected: true, rssi: -61, ip: "192.168.1.42" },
+  leds: [],
+  pattern: { type: "rainbow", speed: 12, brightness: 200 }
+};
+for (var i = 0; i < 16; i++) status.leds.push({ r: i * 8, g: 255 - i * 8, b: i });
+
+function run() {
+  var text = JSON.stringify(status);
+  var back = JSON.parse(text);
+  return back.leds.length + text.length;
+}
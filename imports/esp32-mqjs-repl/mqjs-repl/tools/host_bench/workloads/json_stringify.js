@@ -0,0 +1,17 @@
+// JSON.stringify only: a 50-LED frame of 0-255 colors plus short decimals,
+// the shape the status/frame endpoints serialize several times a second.
+var frame = {
+  seq: 0,
+  fps: 29.97,
+  brightness: 0.8,
+  temp_c: 41.5,
+  leds: []
+};
+for (var i = 0; i < 50; i++) {
+  frame.leds.push({ r: (i * 37) & 255, g: (i * 91) & 255, b: (i * 13) & 255, a: (i % 4) * 0.25 });
+}
+
+function run() {
+  frame.seq++;
+  return JSON.stringify(frame).length;
+}
@@ -0,0 +1,16 @@
+// Property-heavy object code: build small records, read and update fields.
+function makePoint(i) {
+  return { x: i, y: i * 2, z: i * 3, name: "p", visible: (i & 1) === 0 };
+}
+
+function run() {
+  var acc = 0;
+  for (var i = 0; i < 200; i++) {
+    var p = makePoint(i);
+    p.x += p.y;
+    p.z = p.x - p.z;
+    if (p.visible) acc += p.x + p.z;
+    else acc -= p.y;
+  }
+  return acc;
+}
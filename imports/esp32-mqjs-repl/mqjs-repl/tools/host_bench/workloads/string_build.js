@@ -0,0 +1,8 @@
+// String building: concatenation, number formatting and join.
+function run() {
+  var s = "";
+  for (var i = 0; i < 64; i++) s += "led" + i + "=" + (i * 4) + ";";
+  var parts = [];
+  for (var j = 0; j < 32; j++) parts.push("#" + j.toString(16));
+  return s.length + parts.join(",").length;
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build and run the MicroQuickJS host benchmark suite (tools/host_bench).
+#
+# The engine is compiled once per JSValue width. 64-bit uses the native
+# compiler; 32-bit (the ESP32 layout) needs a multilib toolchain (`cc -m32`)
+# and is skipped with a warning if unavailable.
+#
+# Output: JSONL on stdout, one line per workload and width.
+#
+# Usage:
+#   ./tools/run_host_bench.sh                       # all workloads, 32+64 bit
+#   ./tools/run_host_bench.sh -t 2000               # extra args go to mqjs_bench
+#   WIDTHS=32 ARENA_KB=128 ./tools/run_host_bench.sh
+#   ./tools/run_host_bench.sh > baseline.jsonl      # save for comparison
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+ENGINE_DIR="${ROOT_DIR}/components/mquickjs"
+GEN_DIR="${ROOT_DIR}/tools/esp_stdlib_gen"
+BENCH_DIR="${ROOT_DIR}/tools/host_bench"
+BUILD_DIR="${BUILD_DIR:-${TMPDIR:-/tmp}/mqjs-host-bench}"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -Wall -Wextra}"
+# The engine and the stdlib generator are upstream code: -Wall only, and the
+# generator's binding stubs are only ever referenced by name.
+ENGINE_CFLAGS="${ENGINE_CFLAGS:--O2 -Wall}"
+WIDTHS="${WIDTHS:-32 64}"
+ARENA_KB="${ARENA_KB:-64}"
+
+ENGINE_SRCS=(mquickjs.c cutils.c dtoa.c libm.c)
+
+mkdir -p "${BUILD_DIR}"
+
+# The stdlib generator always runs on the host; -m32/-m64 selects the layout.
+# shellcheck disable=SC2086
+"${CC}" ${ENGINE_CFLAGS} -Wno-unused-function -I"${ENGINE_DIR}" -o "${BUILD_DIR}/esp_stdlib_gen" \
+  "${GEN_DIR}/esp_stdlib.c" "${ENGINE_DIR}/mquickjs_build.c"
+
+for width in ${WIDTHS}; do
+  out="${BUILD_DIR}/m${width}"
+  arch_flag=""
+  if [[ "${width}" == "32" ]]; then
+    arch_flag="-m32"
+    if ! echo 'int main(void){return 0;}' | "${CC}" -m32 -x c - -o "${BUILD_DIR}/m32_probe" 2>/dev/null; then
+      echo "warning: ${CC} -m32 unavailable, skipping 32-bit JSValue run" >&2
+      continue
+    fi
+  fi
+
+  # Engine sources are copied so the width-specific mquickjs_atom.h is the
+  # one picked up by their quoted #includes.
+  mkdir -p "${out}"
+  cp "${ENGINE_DIR}"/*.c "${ENGINE_DIR}"/*.h "${out}/"
+  "${BUILD_DIR}/esp_stdlib_gen" "-m${width}" >"${out}/esp_stdlib.h"
+  "${BUILD_DIR}/esp_stdlib_gen" "-m${width}" -a >"${out}/mquickjs_atom.h"
+
+  objs=()
+  for src in "${ENGINE_SRCS[@]}"; do
+    # shellcheck disable=SC2086
+    "${CC}" ${ENGINE_CFLAGS} ${arch_flag} -I"${out}" -c -o "${out}/${src%.c}.o" "${out}/${src}"
+    objs+=("${out}/${src%.c}.o")
+  done
+  # shellcheck disable=SC2086
+  "${CC}" ${CFLAGS} ${arch_flag} -I"${out}" -o "${out}/mqjs_bench" \
+    "${BENCH_DIR}/mqjs_bench.c" "${objs[@]}" -lm
+
+  "${out}/mqjs_bench" -m "${ARENA_KB}" "$@" "${BENCH_DIR}"/workloads/*.js
+done
@@ -12,7 +12,7 @@
  * Notes:
  * - Node 22+ provides a global WebSocket implementation (no deps).
  * - This script intentionally avoids requiring protobuf libraries; the `--decode`
- *   mode uses a minimal proto3 decoder for hub.v1.HubEvent matching:
+ *   mode uses a minimal proto3 decoder for hub.v1.HubEventBatch (one per frame) matching:
  *     `0029-mock-zigbee-http-hub/components/hub_proto/defs/hub_events.proto`.
  */
 /* global WebSocket, fetch */
@@ -28,7 +28,7 @@ Flags:
   --send <text>      Send one TEXT frame after connect (default: none)
   --seed             POST /v1/debug/seed once after connect
   --head             Print first 12 bytes as hex per binary frame
-  --decode           Decode hub.v1.HubEvent (minimal decoder) and print JSON
+  --decode           Decode hub.v1.HubEventBatch (minimal decoder) and print JSON
   --quiet            Don't print per-frame lines, only summary
 `;
   console.error(msg.trim());
@@ -215,6 +215,75 @@ function decodeHubEvent(buf) {
   return out;
 }
 
+function decodeDeviceDelta(r) {
+  const out = {};
+  while (!r.eof()) {
+    const key = Number(r.varint());
+    const field = key >>> 3;
+    const wt = key & 7;
+    switch (field) {
+      case 1:
+        out.deviceId = Number(r.varint());
+        break;
+      case 2:
+        out.tsUs = r.varint().toString();
+        break;
+      case 3:
+        out.on = Number(r.varint()) !== 0;
+        break;
+      case 4:
+        out.level = Number(r.varint());
+        break;
+      case 5:
+        out.powerW = r.float32();
+        break;
+      case 6:
+        out.temperatureC = r.float32();
+        break;
+      default:
+        r.skip(wt);
+    }
+  }
+  return out;
+}
+
+function decodeHubEventBatch(buf) {
+  const r = new PbReader(new Uint8Array(buf));
+  const out = { events: [], deltas: [] };
+  while (!r.eof()) {
+    const key = Number(r.varint());
+    const field = key >>> 3;
+    const wt = key & 7;
+    switch (field) {
+      case 1:
+        out.schemaVersion = Number(r.varint());
+        break;
+      case 2:
+        out.seq = Number(r.varint());
+        break;
+      case 3: {
+        const n = Number(r.varint());
+        out.events.push(decodeHubEvent(r.bytes(n)));
+        break;
+      }
+      case 4: {
+        const n = Number(r.varint());
+        out.deltas.push(decodeDeviceDelta(new PbReader(r.bytes(n))));
+        break;
+      }
+      case 5:
+        out.coalescedTotal = Number(r.varint());
+        break;
+      case 6:
+        out.droppedTotal = Number(r.varint());
+        break;
+      default:
+        r.skip(wt);
+    }
+  }
+  return out;
+}
+
 async function maybeSeed(baseUrl) {
   try {
     const r = await fetch(`${baseUrl}/v1/debug/seed`, { method: "POST" });
@@ -258,7 +327,7 @@ ws.onmessage = (ev) => {
   if (quiet) return;
   if (doDecode) {
     try {
-      console.log(JSON.stringify(decodeHubEvent(b), null, 0));
+      console.log(JSON.stringify(decodeHubEventBatch(b), null, 0));
     } catch (err) {
       console.log(JSON.stringify({ decodeError: String(err), len: b.length }, null, 0));
     }
@@ -1,7 +1,8 @@
 #!/usr/bin/env python3
 """
 Generate a 0066-specific MicroQuickJS stdlib header that adds a `sim` global
-object for controlling the LED-chain simulator.
+object for controlling the LED-chain simulator, and an `events` object for the
+native JS -> WebSocket event channel.
 
 Why this exists:
 - MicroQuickJS (mquickjs) is table-driven: to add new native-callable
@@ -47,6 +48,16 @@ static const JSPropDef js_sim[] = {
 
 static const JSClassDef js_sim_obj =
     JS_OBJECT_DEF("sim", js_sim);
+
+// --- 0066 additions: native JS -> WebSocket event channel (backs emit()) ---
+static const JSPropDef js_events[] = {
+    JS_CFUNC_DEF("push", 2, js_events_push),
+    JS_CFUNC_DEF("stats", 0, js_events_stats),
+    JS_PROP_END,
+};
+
+static const JSClassDef js_events_obj =
+    JS_OBJECT_DEF("events", js_events);
 """
 
 
@@ -73,7 +84,11 @@ def patch_mqjs_stdlib(src: str) -> str:
     if not m:
         raise RuntimeError("mqjs_stdlib.c patch point not found (performance object in global)")
 
-    insert = m.group(1) + '    JS_PROP_CLASS_DEF("sim", &js_sim_obj),\n'
+    insert = (
+        m.group(1)
+        + '    JS_PROP_CLASS_DEF("sim", &js_sim_obj),\n'
+        + '    JS_PROP_CLASS_DEF("events", &js_events_obj),\n'
+    )
     patched = patched[: m.start(1)] + insert + patched[m.end(1) :]
 
     return patched